@@ -0,0 +1,231 @@
+/**
+ * \file bench-aggr.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host airtime simulation of the LoRaMesh uplink aggregation
+ *
+ * Runs LoRaAggr.c of the LoRaStack with the mesh layer stubbed: LoRaAggr_Put
+ * appends a record to the LORAMESH_CONFIG_AGGR_QUEUE_SIZE bytes queue or
+ * drops it, and LoRaAggr_Flush sends as many whole records as fit into
+ * MaxPayloadByDatarate of the data rate in one frame per uplink slot, a lone
+ * own record unpacked. Every container sent is unpacked again by
+ * LoRaAggr_OnPacketRx of a coordinator, which counts the delivered records.
+ *
+ * A router has a number of children, in every uplink slot each child sends
+ * one record in a frame of its own and the router adds its own record. The
+ * airtime the router spends forwarding is compared with one frame per record
+ * (LORAMESH_CONFIG_AGGR_ENABLED 0), the frames of the children are the same
+ * in both cases. Every frame carries 13 bytes of MAC overhead (MHDR, FHDR,
+ * FPort, MIC), the time on air is the one of TimeOnAirLoRa at 125 kHz, 4/5,
+ * 8 symbols preamble.
+ *
+ * The saving is the airtime per delivered record. The flush sends one frame
+ * per slot, records are dropped once the queue fills up faster than one
+ * frame per slot empties it.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "board.h"
+#include "time-on-air.h"
+#include "LoRaMesh.h"
+#include "LoRaAggr.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_SLOTS                                    1000
+#define RECORD_SIZE                                 10
+#define RECORD_PORT                                 1
+
+/*! MHDR, FHDR without options, FPort and MIC */
+#define FRAME_OVERHEAD                              13
+
+#define ROUTER_ADDR                                 0x26011000
+#define CHILD_ADDR( i )                             (0x26012000 + (i))
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef struct {
+    uint32_t Records;
+    uint32_t Delivered;
+    uint32_t Dropped;
+    uint32_t Queued;                //! Still queued at the end
+    uint32_t Frames;
+    uint64_t Airtime;               //! [us]
+} Result_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static LoRaDevice_t Device;
+static Result_t *pResult;
+
+/*! Set while the queue is drained at the end of a run */
+static bool Draining;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Time on air of an uplink [us] */
+static uint32_t FrameAirtime( uint8_t datarate, uint8_t payloadSize );
+
+/*******************************************************************************
+ * STUBS OF THE MESH LAYER
+ ******************************************************************************/
+LoRaDevice_t* pLoRaDevice = &Device;
+const uint8_t MaxPayloadByDatarate[8] = { 51, 51, 51, 115, 242, 242, 242, 242 };
+
+uint8_t LoRaMesh_RegisterApplication( PortHandlerFunction_t fHandler, uint8_t fPort )
+{
+    return ERR_OK;
+}
+
+bool LoRaMesh_IsNetworkJoined( void )
+{
+    return true;
+}
+
+/*! Record delivered to the application of the coordinator */
+uint8_t LoRaMesh_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr, uint8_t fPort )
+{
+    if ( fPort == RECORD_PORT && payloadSize == RECORD_SIZE && buf[0] == (uint8_t) devAddr ) {
+        if ( Draining ) {
+            pResult->Queued++;
+        } else {
+            pResult->Delivered++;
+        }
+    }
+    return ERR_OK;
+}
+
+/*! Uplink of the router, unpacked by the coordinator */
+uint8_t LoRaMesh_SendFrame( uint8_t *appPayload, size_t appPayloadSize, uint8_t fPort,
+        bool isUpLink, bool isConfirmed )
+{
+    uint8_t buf[LORAMESH_BUFFER_SIZE];
+
+    if ( !Draining ) {
+        pResult->Frames++;
+        pResult->Airtime += FrameAirtime(Device.currDataRateIndex, appPayloadSize);
+    }
+    if ( fPort != LORAMESH_CONFIG_AGGR_PORT ) {
+        return LoRaMesh_OnPacketRx(appPayload, appPayloadSize, Device.devAddr, fPort);
+    }
+    memcpy(LORAMESH_BUF_PAYLOAD_START(buf), appPayload, appPayloadSize);
+    Device.devRole = COORDINATOR;
+    (void) LoRaAggr_OnPacketRx(buf, appPayloadSize, Device.devAddr, fPort);
+    Device.devRole = ROUTER;
+    return ERR_OK;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint32_t FrameAirtime( uint8_t datarate, uint8_t payloadSize )
+{
+    TimeOnAirLoRa_t p;
+
+    p.Datarate = 12 - datarate;
+    p.Bandwidth = 0;
+    p.Coderate = 1;
+    p.PreambleLen = 8;
+    p.FixLen = false;
+    p.CrcOn = true;
+    p.LowDatarateOptimize = (p.Datarate >= 11);
+    return TimeOnAirLoRa(&p, FRAME_OVERHEAD + payloadSize);
+}
+
+static void Put( uint32_t srcAddr, Result_t *result )
+{
+    uint8_t data[RECORD_SIZE];
+
+    memset(data, (uint8_t) srcAddr, sizeof(data));
+    result->Records++;
+    if ( LoRaAggr_Put(srcAddr, RECORD_PORT, data, sizeof(data), false) != ERR_OK ) {
+        result->Dropped++;
+    }
+}
+
+static void RunAggregated( uint8_t datarate, uint8_t children, Result_t *result )
+{
+    uint32_t slot;
+    uint8_t i;
+
+    memset(result, 0, sizeof(Result_t));
+    pResult = result;
+    Device.devAddr = ROUTER_ADDR;
+    Device.devRole = ROUTER;
+    Device.currDataRateIndex = datarate;
+    LoRaAggr_Init();
+    for ( slot = 0; slot < NB_SLOTS; slot++ ) {
+        /* The child records arrive during the slot, the own one at the slot */
+        for ( i = 0; i < children; i++ ) {
+            Put(CHILD_ADDR(i), result);
+        }
+        Put(ROUTER_ADDR, result);
+        (void) LoRaAggr_Flush();
+    }
+
+    /* Records still queued at the end are neither delivered nor dropped */
+    Draining = true;
+    while ( LoRaAggr_GetPending() > 0 ) {
+        (void) LoRaAggr_Flush();
+    }
+    Draining = false;
+}
+
+static void RunSeparate( uint8_t datarate, uint8_t children, Result_t *result )
+{
+    memset(result, 0, sizeof(Result_t));
+    result->Records = NB_SLOTS * (children + 1);
+    result->Delivered = result->Records;
+    result->Frames = result->Records;
+    /* A forwarded record carries the address of its source */
+    result->Airtime = (uint64_t) NB_SLOTS
+            * (children * FrameAirtime(datarate, LORAAGGR_FORWARD_HDR_SIZE + RECORD_SIZE)
+                    + FrameAirtime(datarate, RECORD_SIZE));
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t datarates[] = { 0, 3, 5 };
+    static const uint8_t children[] = { 1, 2, 4, 8, 16 };
+    Result_t separate, aggregated;
+    double sepPerRecord, aggrPerRecord;
+    uint8_t d, c;
+    int status = 0;
+
+    printf("uplink aggregation, router airtime per slot, %u byte records, %u slots\n",
+            RECORD_SIZE, NB_SLOTS);
+    printf("  %2s %8s | %6s %9s | %6s %9s %9s %6s %7s\n", "DR", "children", "frames", "separate",
+            "frames", "aggr", "aggr/rec", "saved", "dropped");
+    for ( d = 0; d < sizeof(datarates) / sizeof(datarates[0]); d++ ) {
+        for ( c = 0; c < sizeof(children) / sizeof(children[0]); c++ ) {
+            RunSeparate(datarates[d], children[c], &separate);
+            RunAggregated(datarates[d], children[c], &aggregated);
+
+            if ( aggregated.Delivered + aggregated.Dropped + aggregated.Queued
+                    != aggregated.Records ) {
+                status = 1;
+            }
+            aggregated.Records -= aggregated.Queued;
+            sepPerRecord = (double) separate.Airtime / separate.Delivered;
+            aggrPerRecord = (double) aggregated.Airtime / aggregated.Delivered;
+            printf("  %2u %8u | %6.2f %6.1f ms | %6.2f %6.1f ms %6.1f ms %5.1f%% %6.1f%%\n",
+                    datarates[d], children[c], (double) separate.Frames / NB_SLOTS,
+                    separate.Airtime / 1e3 / NB_SLOTS, (double) aggregated.Frames / NB_SLOTS,
+                    aggregated.Airtime / 1e3 / NB_SLOTS, aggrPerRecord / 1e3,
+                    100.0 * (1.0 - aggrPerRecord / sepPerRecord),
+                    100.0 * aggregated.Dropped / aggregated.Records);
+        }
+    }
+    return status;
+}
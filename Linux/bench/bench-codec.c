@@ -0,0 +1,164 @@
+/**
+ * \file bench-codec.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host benchmark of the sensor payload codec
+ *
+ * Encodes and decodes the samples of a walking node: binary GPS position,
+ * altitude, temperature and battery level, sampled once per uplink. Prints the
+ * encoded size against the raw size of the sample and the host cycles per
+ * encoded and decoded sample for several keyframe intervals.
+ *
+ * The cycles are the ones of the host CPU, the codec has not been measured on
+ * the Cortex-M0+ target (FRDM-KL26Z) yet. No application uses the codec so
+ * far, the LoRaMesh_App data frame still sends the raw sample.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "board.h"
+#include "codec.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RUNS                                     31
+#define NB_SAMPLES                                  1000
+#define NB_FIELDS                                   5
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static const CodecField_t Fields[NB_FIELDS] = {
+    { 24, CODEC_FIELD_SIGNED },             // LatitudeBinary
+    { 24, CODEC_FIELD_SIGNED },             // LongitudeBinary
+    { 16, 0 },                              // Altitude [m]
+    { 16, CODEC_FIELD_SIGNED },             // Temperature [0.1 degC]
+    { 8, CODEC_FIELD_DICT },                // Battery level
+};
+
+/*! Battery levels of a full and of an externally powered node */
+static const int32_t Dict[] = { 254, 0 };
+
+static int32_t Samples[NB_SAMPLES][NB_FIELDS];
+static uint8_t Encoded[NB_SAMPLES][CODEC_MAX_SIZE(NB_FIELDS)];
+static uint8_t EncodedSize[NB_SAMPLES];
+
+static volatile int32_t Sink;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+/*! A node walking at about 1 m/s, a sample every 60 s */
+static void MakeSamples( void )
+{
+    int32_t lat = 3921542, lon = 391011, alt = 436, temp = 215, bat = 254;
+    uint16_t n;
+
+    srand(24);
+    for ( n = 0; n < NB_SAMPLES; n++ ) {
+        lat += (rand() % 401) - 200;
+        lon += (rand() % 401) - 200;
+        alt += (rand() % 5) - 2;
+        if ( (rand() % 4) == 0 ) {
+            temp += (rand() % 5) - 2;
+        }
+        if ( (rand() % 50) == 0 && bat > 1 ) {
+            bat--;
+        }
+        Samples[n][0] = lat;
+        Samples[n][1] = lon;
+        Samples[n][2] = alt;
+        Samples[n][3] = temp;
+        Samples[n][4] = bat;
+    }
+}
+
+static uint64_t Encode( const CodecConfig_t *config, CodecStats_t *stats )
+{
+    CodecEncoder_t enc;
+    uint64_t start;
+    uint16_t n;
+
+    CodecEncoderInit(&enc, config);
+    start = Cycles();
+    for ( n = 0; n < NB_SAMPLES; n++ ) {
+        EncodedSize[n] = CodecEncode(&enc, Samples[n], Encoded[n], sizeof(Encoded[n]));
+    }
+    start = Cycles() - start;
+    *stats = enc.Stats;
+    return start;
+}
+
+static uint64_t Decode( const CodecConfig_t *config )
+{
+    CodecDecoder_t dec;
+    int32_t values[CODEC_MAX_FIELDS];
+    unsigned errors = 0;
+    uint64_t start;
+    uint16_t n;
+
+    CodecDecoderInit(&dec, config);
+    start = Cycles();
+    for ( n = 0; n < NB_SAMPLES; n++ ) {
+        errors += (CodecDecode(&dec, Encoded[n], EncodedSize[n], values) != ERR_OK);
+        Sink += values[0];
+    }
+    start = Cycles() - start;
+
+    if ( errors != 0 ) {
+        printf("decode errors %u\n", errors);
+        exit(1);
+    }
+    return start;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t intervals[] = { 0, 8, 16, 32, 127 };
+    CodecConfig_t config = { Fields, NB_FIELDS, Dict, 2, 0, false };
+    uint64_t t, bestEncode, bestDecode;
+    CodecStats_t stats;
+    uint8_t i;
+    int run;
+
+    MakeSamples();
+
+    printf("sensor payload codec, %u samples of %u fields, cycles per sample\n", NB_SAMPLES,
+            NB_FIELDS);
+    printf("  %8s %8s %8s %8s %8s\n", "interval", "raw", "encoded", "encode", "decode");
+    for ( i = 0; i < sizeof(intervals); i++ ) {
+        config.KeyframeInterval = intervals[i];
+        bestEncode = UINT64_MAX;
+        bestDecode = UINT64_MAX;
+        for ( run = 0; run < NB_RUNS; run++ ) {
+            t = Encode(&config, &stats);
+            bestEncode = (t < bestEncode) ? t : bestEncode;
+            t = Decode(&config);
+            bestDecode = (t < bestDecode) ? t : bestDecode;
+        }
+        printf("  %8u %8.2f %8.2f %8.0f %8.0f\n", intervals[i],
+                (double) stats.RawBytes / stats.Samples, (double) stats.Bytes / stats.Samples,
+                (double) bestEncode / NB_SAMPLES, (double) bestDecode / NB_SAMPLES);
+    }
+    return 0;
+}
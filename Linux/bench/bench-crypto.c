@@ -0,0 +1,217 @@
+/**
+ * \file bench-crypto.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host benchmark of the AES backends and of the LoRaMAC crypto functions
+ *
+ * Built once per AES_BACKEND. Reports host cycles (time stamp counter) per
+ * byte for the MIC and the CTR payload encryption with a cached key
+ * schedule, for the MIC with a key expansion per frame (cache miss), and
+ * the cycles of one key expansion. The best of several runs is reported.
+ *
+ * A received data frame costs a MIC with the NwkSKey and a payload decryption
+ * with the AppSKey. The cycles per frame are reported with the key schedule
+ * cache and without it (cache flushed before each call, i.e. one key
+ * expansion per call as before the cache), the difference is the saving per
+ * frame.
+ *
+ * The numbers compare the backends with each other, the absolute cost on a
+ * Cortex-M has to be measured on the target (DWT->CYCCNT on the K22F,
+ * TimerHwGetCycles on the KL26Z).
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "aes.h"
+#include "LoRaMacCrypto.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RUNS                                     7
+#define NB_ITERATIONS                               2000
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static const uint8_t Key[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7,
+        0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+static const uint8_t AppSKey[16] = { 0x3C, 0x4F, 0xCF, 0x09, 0x88, 0x15, 0xF7, 0xAB, 0xA6, 0xD2,
+        0xAE, 0x28, 0x16, 0x15, 0x7E, 0x2B };
+
+static uint8_t Frame[255];
+static uint8_t Out[255];
+static volatile uint32_t Sink;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+static double BenchMic( uint8_t size, bool coldKey )
+{
+    uint64_t start, end, best = UINT64_MAX;
+    uint32_t mic;
+    int run, i;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        start = Cycles();
+        for ( i = 0; i < NB_ITERATIONS; i++ ) {
+            if ( coldKey ) {
+                LoRaMacCryptoFlushKeyCache();
+            }
+            LoRaMacComputeMic(Frame, size, Key, 0x01020304, 0, (uint32_t) i, &mic);
+            Sink += mic;
+        }
+        end = Cycles();
+        if ( end - start < best ) {
+            best = end - start;
+        }
+    }
+    return (double) best / NB_ITERATIONS;
+}
+
+static double BenchCtr( uint8_t size )
+{
+    uint64_t start, end, best = UINT64_MAX;
+    int run, i;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        start = Cycles();
+        for ( i = 0; i < NB_ITERATIONS; i++ ) {
+            LoRaMacPayloadEncrypt(Frame, size, Key, 0x01020304, 0, (uint32_t) i, Out);
+            Sink += Out[0];
+        }
+        end = Cycles();
+        if ( end - start < best ) {
+            best = end - start;
+        }
+    }
+    return (double) best / NB_ITERATIONS;
+}
+
+/*! MIC over the frame and decryption of the payload, as LoRaMac_OnPacketRx */
+static double BenchFrame( uint8_t size, bool cached )
+{
+    uint64_t start, end, best = UINT64_MAX;
+    uint32_t mic;
+    int run, i;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        start = Cycles();
+        for ( i = 0; i < NB_ITERATIONS; i++ ) {
+            if ( !cached ) {
+                LoRaMacCryptoFlushKeyCache();
+            }
+            LoRaMacComputeMic(Frame, size, Key, 0x01020304, 0, (uint32_t) i, &mic);
+            if ( !cached ) {
+                LoRaMacCryptoFlushKeyCache();
+            }
+            LoRaMacPayloadDecrypt(Frame + 9, size - 13, AppSKey, 0x01020304, 0, (uint32_t) i, Out);
+            Sink += mic + Out[0];
+        }
+        end = Cycles();
+        if ( end - start < best ) {
+            best = end - start;
+        }
+    }
+    return (double) best / NB_ITERATIONS;
+}
+
+static double BenchFlush( void )
+{
+    uint64_t start, end, best = UINT64_MAX;
+    int run, i;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        start = Cycles();
+        for ( i = 0; i < NB_ITERATIONS; i++ ) {
+            LoRaMacCryptoFlushKeyCache();
+        }
+        end = Cycles();
+        if ( end - start < best ) {
+            best = end - start;
+        }
+    }
+    return (double) best / NB_ITERATIONS;
+}
+
+static double BenchKeyExpansion( void )
+{
+    static aes_context aes;
+    uint64_t start, end, best = UINT64_MAX;
+    int run, i;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        start = Cycles();
+        for ( i = 0; i < NB_ITERATIONS; i++ ) {
+            aes_set_key(Key, 16, &aes);
+            Sink += aes.ksch[i % 176];
+        }
+        end = Cycles();
+        if ( end - start < best ) {
+            best = end - start;
+        }
+    }
+    return (double) best / NB_ITERATIONS;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t sizes[] = { 16, 51, 115, 242 };
+    static const char *names[] = { "byte", "ttable", "const-time" };
+    double mic, cold, ctr, uncached, cached, flush;
+    uint8_t i;
+
+    for ( i = 0; i < sizeof(Frame); i++ ) {
+        Frame[i] = i;
+    }
+
+    printf("AES backend %s, %s per byte\n", names[AES_BACKEND],
+#if defined( __x86_64__ ) || defined( __i386__ )
+            "host TSC cycles"
+#else
+            "ns"
+#endif
+    );
+    printf("  key expansion: %.0f per key\n", BenchKeyExpansion());
+    printf("  %5s %12s %12s %12s\n", "size", "MIC", "MIC+keyexp", "CTR");
+    for ( i = 0; i < sizeof(sizes); i++ ) {
+        mic = BenchMic(sizes[i], false);
+        cold = BenchMic(sizes[i], true);
+        ctr = BenchCtr(sizes[i]);
+        printf("  %5u %12.1f %12.1f %12.1f\n", sizes[i], mic / sizes[i], cold / sizes[i],
+                ctr / sizes[i]);
+    }
+
+    /* The flushes themselves are not part of the frame */
+    flush = BenchFlush();
+    printf("  %5s %12s %12s %12s %7s\n", "frame", "no cache", "cache", "saved", "saved");
+    for ( i = 0; i < sizeof(sizes); i++ ) {
+        uncached = BenchFrame(sizes[i], false) - 2 * flush;
+        cached = BenchFrame(sizes[i], true);
+        printf("  %5u %12.0f %12.0f %12.0f %6.1f%%\n", sizes[i], uncached, cached,
+                uncached - cached, 100.0 * (uncached - cached) / uncached);
+    }
+    return 0;
+}
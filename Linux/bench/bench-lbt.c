@@ -0,0 +1,266 @@
+/**
+ * \file bench-lbt.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host collision and throughput simulation of the LoRaPhy listen before talk
+ *
+ * Runs the channel access of LoRaLbt.c with the LORAMESH_CONFIG_LBT_* settings
+ * of LoRaMesh-config.h on the LinuxSim radio medium, driven the way CheckTx
+ * and the PHY_CAD state of LoRaPhy drive it:
+ *
+ * - aloha: the frame is sent as soon as it is queued (LBT disabled).
+ * - lbt: a channel activity detection precedes the transmission, a busy
+ *   channel defers the frame by the backoff of LoRaLbt_OnBusy. After
+ *   LORAMESH_CONFIG_LBT_MAX_ATTEMPTS busy assessments the frame is sent
+ *   regardless.
+ *
+ * The children of one parent send Poisson distributed uplinks on one channel
+ * (SF7, 125 kHz, 24 bytes), the parent listens continuously. The duty cycle
+ * time off is left out, the offered load G is the sum of the airtime
+ * requested by all the children per second. The throughput S is the airtime
+ * of the frames the parent received per second. With a 2 km radius every
+ * child detects every other one, with 6 km some children are hidden from
+ * each other but still reach the parent.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "board.h"
+#include "LoRaLbt.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_CHILDREN                                 50
+#define DURATION                                    (3600ull * 1000000ull)
+#define FRAME_SIZE                                  24
+#define TX_POWER                                    14
+#define SEED                                        1
+
+/*! Frames a child queues while the previous one is not sent yet */
+#define QUEUE_SIZE                                  16
+
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef enum {
+    CHILD_IDLE = 0, CHILD_WAIT, CHILD_CAD, CHILD_TX,
+} ChildState_t;
+
+typedef struct {
+    int16_t Node;
+    ChildState_t State;
+    uint64_t NextArrival;
+    uint64_t NextTx;                //! End of the backoff
+    uint64_t Queue[QUEUE_SIZE];     //! Arrival times of the queued frames
+    uint8_t QueueHead;
+    uint8_t QueueCount;
+    LoRaLbt_t Lbt;
+} Child_t;
+
+typedef struct {
+    uint32_t Offered;
+    uint32_t Sent;
+    uint32_t Received;
+    uint32_t Collided;
+    uint32_t Dropped;
+    uint32_t Busy;
+    uint64_t Delay;                 //! Sum of the queuing and backoff delays [us]
+} Result_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static Child_t Children[NB_CHILDREN];
+static SimMediumModulation_t Modulation;
+static Result_t Result;
+static bool LbtOn;
+static uint64_t MeanPeriod;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t NextArrival( uint64_t now )
+{
+    double u = (SimMediumRandom() + 1.0) / 4294967297.0;
+
+    return now + (uint64_t) (-log(u) * MeanPeriod) + 1;
+}
+
+static void Send( Child_t *child )
+{
+    uint8_t payload[FRAME_SIZE];
+
+    memset(payload, (int) (child - Children), sizeof(payload));
+    Result.Delay += SimMediumGetTime() - child->Queue[child->QueueHead];
+    child->State = CHILD_TX;
+    LoRaLbt_Reset(&child->Lbt);
+    Result.Sent++;
+    (void) SimMediumSend(child->Node, &Modulation, TX_POWER, payload, sizeof(payload));
+}
+
+/*! CheckTx: assesses the channel first unless the attempts are used up */
+static void CheckTx( Child_t *child )
+{
+    if ( LbtOn && LoRaLbt_Assess(&child->Lbt) ) {
+        child->State = CHILD_CAD;
+        SimMediumStartCad(child->Node, &Modulation);
+        return;
+    }
+    Send(child);
+}
+
+static void OnTxDone( void *context )
+{
+    Child_t *child = (Child_t *) context;
+
+    child->QueueHead = (child->QueueHead + 1) % QUEUE_SIZE;
+    child->QueueCount--;
+    child->State = CHILD_IDLE;
+    if ( child->QueueCount > 0 ) {
+        CheckTx(child);
+    }
+}
+
+static void OnCadDone( void *context, bool channelActivityDetected )
+{
+    Child_t *child = (Child_t *) context;
+    uint32_t backoff;
+
+    if ( channelActivityDetected ) {
+        Result.Busy++;
+        if ( LoRaLbt_OnBusy(&child->Lbt, &backoff) ) {
+            child->State = CHILD_WAIT;
+            child->NextTx = SimMediumGetTime() + backoff * 1000ull;
+            return;
+        }
+    }
+    Send(child);
+}
+
+static void OnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    Result.Received++;
+}
+
+static void OnRxError( void *context )
+{
+    Result.Collided++;
+}
+
+static void Run( double load, uint32_t radius, bool lbt )
+{
+    static const SimMediumEvents_t childEvents = { OnTxDone, NULL, NULL, NULL, OnCadDone };
+    static const SimMediumEvents_t parentEvents = { NULL, OnRxDone, OnRxError, NULL, NULL };
+    Child_t *child;
+    uint64_t now, next;
+    double angle, distance;
+    uint16_t i;
+
+    SimMediumInit(SEED);
+    srand1(SEED);
+    memset(Children, 0, sizeof(Children));
+    memset(&Result, 0, sizeof(Result));
+    LbtOn = lbt;
+    MeanPeriod = (uint64_t) (NB_CHILDREN * SimMediumTimeOnAir(&Modulation, FRAME_SIZE) / load);
+
+    SimMediumRx(SimMediumAttach(&parentEvents, NULL, 0, 0), &Modulation, 0, true);
+    for ( i = 0; i < NB_CHILDREN; i++ ) {
+        child = &Children[i];
+        angle = 2.0 * M_PI * (SimMediumRandom() / 4294967296.0);
+        distance = radius * sqrt(SimMediumRandom() / 4294967296.0);
+        child->Node = SimMediumAttach(&childEvents, child, (int32_t) (distance * cos(angle)),
+                (int32_t) (distance * sin(angle)));
+        child->NextArrival = NextArrival(0);
+        child->NextTx = SIM_MEDIUM_TIME_NEVER;
+    }
+
+    for ( ;; ) {
+        next = SimMediumGetNextEventTime();
+        for ( i = 0; i < NB_CHILDREN; i++ ) {
+            next = MIN(next, Children[i].NextArrival);
+            next = MIN(next, Children[i].NextTx);
+        }
+        if ( next > DURATION ) {
+            break;
+        }
+        SimMediumProcess(next);
+        now = SimMediumGetTime();
+
+        for ( i = 0; i < NB_CHILDREN; i++ ) {
+            child = &Children[i];
+            if ( child->NextArrival <= now ) {
+                child->NextArrival = NextArrival(now);
+                Result.Offered++;
+                if ( child->QueueCount == QUEUE_SIZE ) {
+                    Result.Dropped++;
+                } else {
+                    child->Queue[(child->QueueHead + child->QueueCount) % QUEUE_SIZE] = now;
+                    if ( child->QueueCount++ == 0 ) {
+                        CheckTx(child);
+                    }
+                }
+            }
+            if ( child->NextTx <= now ) {
+                child->NextTx = SIM_MEDIUM_TIME_NEVER;
+                CheckTx(child);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const double loads[] = { 0.1, 0.25, 0.5, 0.75, 1.0, 1.5 };
+    static const uint32_t radii[] = { 2000, 6000 };
+    Result_t aloha;
+    double toa, sAloha, sLbt;
+    uint8_t r, l;
+    int status = 0;
+
+    memset(&Modulation, 0, sizeof(Modulation));
+    Modulation.Modem = MODEM_LORA;
+    Modulation.Frequency = 868100000;
+    Modulation.Bandwidth = 125000;
+    Modulation.Datarate = 7;
+    Modulation.Coderate = 1;
+    Modulation.PreambleLen = 8;
+    Modulation.CrcOn = true;
+    toa = SimMediumTimeOnAir(&Modulation, FRAME_SIZE) / 1e6;
+
+    printf("listen before talk, %u children, SF7 %u bytes (%.1f ms), %u s per point\n",
+            NB_CHILDREN, FRAME_SIZE, toa * 1e3, (unsigned) (DURATION / 1000000));
+    printf("backoff slot %u ms, exponent %u..%u, %u attempts\n",
+            LORAMESH_CONFIG_LBT_BACKOFF_SLOT_MS, LORAMESH_CONFIG_LBT_MIN_BACKOFF_EXP,
+            LORAMESH_CONFIG_LBT_MAX_BACKOFF_EXP, LORAMESH_CONFIG_LBT_MAX_ATTEMPTS);
+
+    for ( r = 0; r < sizeof(radii) / sizeof(radii[0]); r++ ) {
+        printf("radius %u m\n", radii[r]);
+        printf("  %5s | %7s %7s %6s | %7s %7s %6s %6s %8s\n", "G", "aloha S", "PDR", "coll",
+                "lbt S", "PDR", "coll", "busy", "delay ms");
+        for ( l = 0; l < sizeof(loads) / sizeof(loads[0]); l++ ) {
+            Run(loads[l], radii[r], false);
+            aloha = Result;
+            Run(loads[l], radii[r], true);
+
+            if ( (aloha.Received > aloha.Sent) || (Result.Received > Result.Sent) ) {
+                status = 1;
+            }
+            sAloha = aloha.Received * toa / (DURATION / 1e6);
+            sLbt = Result.Received * toa / (DURATION / 1e6);
+            printf("  %5.2f | %7.3f %7.3f %6u | %7.3f %7.3f %6u %6u %8.1f\n", loads[l], sAloha,
+                    (double) aloha.Received / aloha.Offered, aloha.Collided, sLbt,
+                    (double) Result.Received / Result.Offered, Result.Collided, Result.Busy,
+                    (Result.Sent != 0) ? Result.Delay / 1e3 / Result.Sent : 0.0);
+        }
+    }
+    return status;
+}
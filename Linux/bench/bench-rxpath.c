@@ -0,0 +1,264 @@
+/**
+ * \file bench-rxpath.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host benchmark of the LoRaMesh uplink receive path
+ *
+ * Runs LoRaMac_OnPacketRx and LoRaFrm_OnPacketRx of the LoRaStack with the
+ * session table (LoRaSession.c), the statistics and LoRaMacCrypto. Built once
+ * per LORAMESH_CONFIG_RX_SINGLE_PASS (see Makefile):
+ *
+ * - 0: LoRaMac_OnPacketRx checks the MIC, LoRaFrm_OnPacketRx decrypts the
+ *   FRMPayload in place in a second pass.
+ * - 1: the MIC is checked while the FRMPayload is decrypted in place, one
+ *   pass over the frame.
+ *
+ * The node is a router receiving the unconfirmed uplinks of its children,
+ * the layers above and below the MAC and the frame layer are stubbed. Frames
+ * of one child and of eight children in turn are received, the key schedule
+ * cache holds LORAMAC_CRYPTO_KEY_CACHE_SIZE keys, i.e. the NwkSKey and the
+ * AppSKey of two children.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "LoRaMacCrypto.h"
+#include "LoRaMesh.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RUNS                                     31
+#define NB_ITERATIONS                               500
+
+#define NB_CHILDREN_MAX                             8
+
+/*! FPort of the benchmark frames */
+#define FRM_PORT                                    2
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static LoRaDevice_t Device;
+static ChildNodeInfo_t Children[NB_CHILDREN_MAX];
+
+/*! Received frames, as delivered by the radio */
+static uint8_t Frames[NB_CHILDREN_MAX][LORAPHY_BUFFER_SIZE];
+static uint8_t PhyBuffer[LORAPHY_BUFFER_SIZE];
+
+/*! Frames delivered to the application with the expected payload */
+static unsigned Delivered;
+
+/*******************************************************************************
+ * STUBS OF THE LAYERS AROUND LoRaMac AND LoRaFrm
+ ******************************************************************************/
+LoRaDevice_t* pLoRaDevice = &Device;
+const uint8_t MaxPayloadByDatarate[8] = { 51, 51, 51, 115, 242, 242, 242, 242 };
+const struct Radio_s Radio;
+
+uint8_t LoRaMesh_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr, uint8_t fPort )
+{
+    /* BuildFrame counts the payload bytes up */
+    if ( fPort == FRM_PORT && buf[0] == 0 && buf[payloadSize - 1] == payloadSize - 1 ) {
+        Delivered++;
+    }
+    return ERR_OK;
+}
+
+void LoRaMesh_StoreFrameCounters( LoRaMeshSession_t *session )
+{
+}
+
+void LoRaMesh_StoreSession( void )
+{
+}
+
+void LoRaMesh_SetDevAddr( uint32_t devAddr )
+{
+}
+
+uint8_t LoRaMesh_ProcessAdvertising( uint8_t *aPayload, uint8_t aPayloadSize )
+{
+    return ERR_FAILED;
+}
+
+uint8_t LoRaMesh_ProcessJoinMeshReq( uint8_t *payload, uint8_t payloadSize )
+{
+    return ERR_FAILED;
+}
+
+uint8_t LoRaMesh_ProcessRebindMeshReq( uint8_t *payload, uint8_t payloadSize )
+{
+    return ERR_FAILED;
+}
+
+bool LoRaPhy_IsPoolBuffer( uint8_t *buf )
+{
+    return false;
+}
+
+uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t channel,
+        uint8_t flags )
+{
+    return ERR_FAILED;
+}
+
+void LoRaPhy_SetChannel( uint8_t id, LoRaPhy_ChannelParams_t params )
+{
+}
+
+void LoRaPhy_SetReceiveDelay1( uint32_t delay )
+{
+}
+
+void LoRaPhy_SetReceiveDelay2( uint32_t delay )
+{
+}
+
+void LoRaPhy_SetMaxDutyCycle( uint8_t maxDCycle )
+{
+}
+
+void LoRaPhy_SetDownLinkSettings( uint8_t rx1DrOffset, uint8_t rx2Dr )
+{
+}
+
+void LoRaPhy_SetRxParameters( uint8_t rx1DrOffset, uint8_t rx2Dr, uint32_t rx2Freq )
+{
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+/*! Unconfirmed uplink of a child without FOpts */
+static void BuildFrame( uint8_t *phy, ConnectionInfo_t *child, uint8_t payloadSize )
+{
+    uint8_t *frame = &phy[LORAMAC_BUF_IDX_HDR];
+    uint8_t portIdx = LORAFRM_BUF_IDX_PORT(0) - LORAMAC_BUF_IDX_HDR;
+    uint8_t size = portIdx + LORAFRM_PORT_SIZE + payloadSize;
+    uint32_t mic;
+    uint8_t i;
+
+    frame[0] = MSG_TYPE_DATA_UNCONFIRMED_UP << 5;
+    frame[1] = child->Address & 0xFF;
+    frame[2] = (child->Address >> 8) & 0xFF;
+    frame[3] = (child->Address >> 16) & 0xFF;
+    frame[4] = (child->Address >> 24) & 0xFF;
+    frame[5] = 0x00;
+    frame[6] = child->UpLinkCounter & 0xFF;
+    frame[7] = (child->UpLinkCounter >> 8) & 0xFF;
+    frame[portIdx] = FRM_PORT;
+    for ( i = 0; i < payloadSize; i++ ) {
+        frame[portIdx + LORAFRM_PORT_SIZE + i] = i;
+    }
+    LoRaMacPayloadEncrypt(&frame[portIdx + LORAFRM_PORT_SIZE], payloadSize, child->AppSKey,
+            child->Address, UP_LINK, child->UpLinkCounter, &frame[portIdx + LORAFRM_PORT_SIZE]);
+    LoRaMacComputeMic(frame, size, child->NwkSKey, child->Address, UP_LINK,
+            child->UpLinkCounter, &mic);
+    frame[size] = mic & 0xFF;
+    frame[size + 1] = (mic >> 8) & 0xFF;
+    frame[size + 2] = (mic >> 16) & 0xFF;
+    frame[size + 3] = (mic >> 24) & 0xFF;
+    LORAPHY_BUF_SIZE(phy) = size + LORAMAC_MIC_SIZE;
+}
+
+/*! Cycles of NB_ITERATIONS frames, copied in as the radio does */
+static uint64_t Run( uint8_t nbChildren, uint32_t upLinkCounter )
+{
+    LoRaPhy_PacketDesc packet;
+    uint64_t start;
+    uint8_t c;
+    int i;
+
+    LoRaMacCryptoFlushKeyCache();
+    Delivered = 0;
+    start = Cycles();
+    for ( i = 0; i < NB_ITERATIONS; i++ ) {
+        c = i % nbChildren;
+        memcpy(PhyBuffer, Frames[c], LORAPHY_BUF_SIZE(Frames[c]) + LORAPHY_BUF_IDX_PAYLOAD);
+        packet.flags = LORAPHY_PACKET_FLAGS_FRM_REGULAR;
+        packet.phyData = PhyBuffer;
+        packet.phySize = sizeof(PhyBuffer);
+        packet.rssi = -80;
+        packet.snr = 5;
+        /* Same frame again, not a replay */
+        Children[c].Connection.UpLinkCounter = upLinkCounter;
+        (void) LoRaMac_OnPacketRx(&packet);
+    }
+    start = Cycles() - start;
+
+    if ( Delivered != NB_ITERATIONS ) {
+        printf("delivered %u of %u frames\n", Delivered, NB_ITERATIONS);
+        exit(1);
+    }
+    return start;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t sizes[] = { 16, 51, 115, 222 };
+    static const uint8_t children[] = { 1, NB_CHILDREN_MAX };
+    const uint32_t upLinkCounter = 100;
+    uint64_t t, best;
+    uint8_t c, s, i, k;
+    int run;
+
+    Device.devAddr = 0x26011000;
+    Device.coordinatorAddr = Device.devAddr;
+    Device.ctrlFlags.Bits.nwkJoined = 1;
+    LoRaSession_Init();
+    for ( c = 0; c < NB_CHILDREN_MAX; c++ ) {
+        Children[c].Connection.Address = 0x26010000 + c * 0x1111;
+        for ( k = 0; k < 16; k++ ) {
+            Children[c].Connection.NwkSKey[k] = (uint8_t) (c * 16 + k);
+            Children[c].Connection.AppSKey[k] = (uint8_t) (0x80 + c * 16 + k);
+        }
+        Children[c].Connection.UpLinkCounter = upLinkCounter;
+        (void) LoRaSession_Add(Children[c].Connection.Address, SESSION_TYPE_CHILD_NODE,
+                &Children[c].Connection, &Children[c]);
+    }
+
+    printf("uplink receive path, LORAMESH_CONFIG_RX_SINGLE_PASS %d, %s per frame\n",
+            LORAMESH_CONFIG_RX_SINGLE_PASS,
+#if defined( __x86_64__ ) || defined( __i386__ )
+            "host TSC cycles");
+#else
+            "ns");
+#endif
+    printf("  %8s %5s %10s\n", "children", "size", "cycles");
+    for ( i = 0; i < sizeof(children); i++ ) {
+        for ( s = 0; s < sizeof(sizes); s++ ) {
+            for ( c = 0; c < NB_CHILDREN_MAX; c++ ) {
+                BuildFrame(Frames[c], &Children[c].Connection, sizes[s]);
+            }
+            best = UINT64_MAX;
+            for ( run = 0; run < NB_RUNS; run++ ) {
+                t = Run(children[i], upLinkCounter);
+                best = (t < best) ? t : best;
+            }
+            printf("  %8u %5u %10.0f\n", children[i], sizes[s], (double) best / NB_ITERATIONS);
+        }
+    }
+    return 0;
+}
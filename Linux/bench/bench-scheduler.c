@@ -0,0 +1,307 @@
+/**
+ * \file bench-scheduler.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host benchmark of the LoRaMesh event scheduler slot search
+ *
+ * Compares two slot searches of ScheduleEvent on the slots of the advertising
+ * interval:
+ *
+ * - bitmap: LoRaSlots.c of the LoRaStack, the slots are reserved in the
+ *   bitmap.
+ * - list: first fit by walking the sorted scheduler list for every occurrence
+ *   of a candidate, an occupied candidate skips to the end of the event in
+ *   the way. This is the search the bitmap replaced, without the ten retry
+ *   limit of the former FindFreeSlots which gave up on a fragmented list.
+ *
+ * A router registers a reception window for the uplink of every child, one
+ * occurrence per advertising interval (30 s), or three per interval (10 s).
+ * The table is filled with the children, then children leave and join again
+ * at random. The cycles of a schedule (search, reservation and sorted
+ * insertion) are the ones of the host CPU. The event pool is sized for the
+ * children, as LORAMESH_CONFIG_MAX_NOF_SCHEDULER_EVENTS is on the device.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "LoRaSlots.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_CHURN                                    2000
+
+#define ADVERTISING_INTERVAL_US                     LORASLOTS_ADVERTISING_INTERVAL_US
+#define TIME_PER_SLOT                               LORASLOTS_TIME_PER_SLOT
+#define NOF_AVAILABLE_SLOTS                         LORASLOTS_NOF_SLOTS
+
+#define MAX_NOF_CHILDREN                            256
+#define MAX_NOF_OCCURRENCES                         4
+#define MAX_NOF_EVENTS                              (MAX_NOF_CHILDREN * MAX_NOF_OCCURRENCES)
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef struct Event_s {
+    uint16_t startSlot;
+    uint16_t endSlot;
+    uint16_t child;
+    struct Event_s *next;
+} Event_t;
+
+typedef struct {
+    uint64_t Cycles;
+    uint32_t Schedules;
+    uint32_t Failed;
+} Result_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static Event_t Events[MAX_NOF_EVENTS];
+static Event_t *pEventScheduler;
+static Event_t *pFreeEvent;
+static bool UseBitmap;
+
+/*! Start slot of every child, 0xFFFF if not scheduled */
+static uint16_t ChildSlot[MAX_NOF_CHILDREN];
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+/*! Walks the sorted list, returns the event in the way or NULL if free */
+static const Event_t *ListBlocking( uint16_t startSlot, uint16_t endSlot )
+{
+    const Event_t *evt;
+
+    if ( endSlot >= NOF_AVAILABLE_SLOTS ) return &Events[0];
+
+    for ( evt = pEventScheduler; evt != NULL && evt->startSlot <= endSlot; evt = evt->next ) {
+        if ( evt->endSlot >= startSlot ) return evt;
+    }
+    return NULL;
+}
+
+/*! LoRaSlots_Find on the list, without rx windows */
+static bool CheckSlotPattern( uint16_t slot, uint16_t intervalInSlots, uint16_t durationInSlots,
+        uint16_t *nofOccurrences )
+{
+    uint16_t n;
+
+    if ( durationInSlots >= intervalInSlots
+            && ((uint32_t) slot + intervalInSlots + durationInSlots) < NOF_AVAILABLE_SLOTS ) return false;
+
+    for ( n = 0; ((uint32_t) slot + durationInSlots) < NOF_AVAILABLE_SLOTS; n++ ) {
+        if ( ListBlocking(slot, slot + durationInSlots) != NULL ) return false;
+        slot += intervalInSlots;
+    }
+
+    *nofOccurrences = n;
+    return (n > 0);
+}
+
+static bool FindFreeSlots( uint16_t intervalInSlots, uint16_t durationInSlots, uint16_t *startSlot,
+        uint16_t *nofOccurrences )
+{
+    LoRaSlotPattern_t pattern = { intervalInSlots, durationInSlots, false, 0, 0 };
+    const Event_t *blocking;
+    uint16_t slot;
+
+    if ( UseBitmap ) {
+        return LoRaSlots_Find(LORASLOTS_ANY_SLOT, &pattern, startSlot, nofOccurrences) == ERR_OK;
+    }
+
+    slot = 0;
+    while ( slot < NOF_AVAILABLE_SLOTS ) {
+        if ( (blocking = ListBlocking(slot, slot)) != NULL ) {
+            /* Skip the event in the way */
+            slot = blocking->endSlot + 1;
+            continue;
+        }
+        if ( CheckSlotPattern(slot, intervalInSlots, durationInSlots, nofOccurrences) ) {
+            *startSlot = slot;
+            return true;
+        }
+        slot++;
+    }
+    return false;
+}
+
+/*! Sorted by start slot, as the scheduler list of LoRaMesh.c */
+static void InsertEvent( Event_t *evt )
+{
+    Event_t *iterEvt;
+
+    if ( pEventScheduler == NULL || evt->startSlot < pEventScheduler->startSlot ) {
+        evt->next = pEventScheduler;
+        pEventScheduler = evt;
+        return;
+    }
+
+    iterEvt = pEventScheduler;
+    while ( iterEvt->next != NULL && iterEvt->next->startSlot < evt->startSlot ) {
+        iterEvt = iterEvt->next;
+    }
+    evt->next = iterEvt->next;
+    iterEvt->next = evt;
+}
+
+static bool Schedule( uint16_t child, uint16_t intervalInSlots, uint16_t durationInSlots )
+{
+    uint16_t startSlot, nofOccurrences, i;
+    Event_t *evt;
+
+    if ( !FindFreeSlots(intervalInSlots, durationInSlots, &startSlot, &nofOccurrences) ) {
+        return false;
+    }
+    for ( i = 0; i < nofOccurrences; i++ ) {
+        evt = pFreeEvent;
+        pFreeEvent = evt->next;
+        evt->startSlot = startSlot + (intervalInSlots * i);
+        evt->endSlot = evt->startSlot + durationInSlots;
+        evt->child = child;
+        if ( UseBitmap ) {
+            LoRaSlots_Reserve(evt->startSlot, evt->endSlot);
+        }
+        InsertEvent(evt);
+    }
+    ChildSlot[child] = startSlot;
+    return true;
+}
+
+/*! Removes all occurrences in a single pass over the list, as RemoveEvent of LoRaMesh.c */
+static void Remove( uint16_t child )
+{
+    Event_t *iterEvt, *prevEvt = NULL, *nextEvt;
+
+    for ( iterEvt = pEventScheduler; iterEvt != NULL; iterEvt = nextEvt ) {
+        nextEvt = iterEvt->next;
+        if ( iterEvt->child == child ) {
+            if ( prevEvt == NULL ) {
+                pEventScheduler = nextEvt;
+            } else {
+                prevEvt->next = nextEvt;
+            }
+            if ( UseBitmap ) {
+                LoRaSlots_Release(iterEvt->startSlot, iterEvt->endSlot);
+            }
+            iterEvt->next = pFreeEvent;
+            pFreeEvent = iterEvt;
+        } else {
+            prevEvt = iterEvt;
+        }
+    }
+    ChildSlot[child] = 0xFFFF;
+}
+
+static void Reset( bool useBitmap )
+{
+    uint16_t i;
+
+    UseBitmap = useBitmap;
+    LoRaSlots_Init();
+    pEventScheduler = NULL;
+    for ( i = 0; i < MAX_NOF_EVENTS - 1; i++ ) {
+        Events[i].next = &Events[i + 1];
+    }
+    Events[MAX_NOF_EVENTS - 1].next = NULL;
+    pFreeEvent = Events;
+    memset(ChildSlot, 0xFF, sizeof(ChildSlot));
+}
+
+/*! Fills the table and churns it, the slots chosen are recorded in slots */
+static void Run( bool useBitmap, uint16_t children, uint16_t intervalInSlots,
+        uint16_t durationInSlots, uint16_t *slots, Result_t *result )
+{
+    uint64_t start;
+    uint16_t i, child;
+    bool ok;
+
+    Reset(useBitmap);
+    memset(result, 0, sizeof(Result_t));
+    srand(8);
+
+    for ( i = 0; i < children; i++ ) {
+        start = Cycles();
+        ok = Schedule(i, intervalInSlots, durationInSlots);
+        result->Cycles += Cycles() - start;
+        result->Schedules++;
+        result->Failed += !ok;
+        *(slots++) = ChildSlot[i];
+    }
+    for ( i = 0; i < NB_CHURN; i++ ) {
+        child = rand() % children;
+        Remove(child);
+        start = Cycles();
+        ok = Schedule(child, intervalInSlots, durationInSlots);
+        result->Cycles += Cycles() - start;
+        result->Schedules++;
+        result->Failed += !ok;
+        *(slots++) = ChildSlot[child];
+    }
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint16_t children[] = { 16, 64, 128, 192, 250 };
+    static const struct {
+        uint16_t Interval;          //! [slots]
+        uint16_t Duration;          //! [slots]
+        uint16_t MaxChildren;
+    } patterns[] = {
+        { ADVERTISING_INTERVAL_US / TIME_PER_SLOT, 1, 256 },
+        { 10000000 / TIME_PER_SLOT, 1, 100 },
+    };
+    static uint16_t bitmapSlots[MAX_NOF_CHILDREN + NB_CHURN], listSlots[MAX_NOF_CHILDREN + NB_CHURN];
+    Result_t bitmap, list;
+    uint8_t p, c;
+    int status = 0;
+
+    printf("scheduler slot search, %u slots, %u joins after the fill, host cycles per schedule\n",
+            NOF_AVAILABLE_SLOTS, NB_CHURN);
+    for ( p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++ ) {
+        printf("reception window every %u ms, %u slot(s)\n", patterns[p].Interval * TIME_PER_SLOT / 1000,
+                patterns[p].Duration);
+        printf("  %8s %7s | %8s %8s %7s\n", "children", "failed", "list", "bitmap", "speedup");
+        for ( c = 0; c < sizeof(children) / sizeof(children[0]); c++ ) {
+            if ( children[c] > patterns[p].MaxChildren ) {
+                continue;
+            }
+            Run(false, children[c], patterns[p].Interval, patterns[p].Duration, listSlots, &list);
+            Run(true, children[c], patterns[p].Interval, patterns[p].Duration, bitmapSlots,
+                    &bitmap);
+
+            /* Both are first fit, they have to pick the same slots */
+            if ( memcmp(listSlots, bitmapSlots, (children[c] + NB_CHURN) * sizeof(uint16_t)) != 0
+                    || list.Failed != bitmap.Failed ) {
+                status = 1;
+            }
+            printf("  %8u %7u | %8.0f %8.0f %6.1fx\n", children[c], bitmap.Failed,
+                    (double) list.Cycles / list.Schedules,
+                    (double) bitmap.Cycles / bitmap.Schedules,
+                    (double) list.Cycles / bitmap.Cycles);
+        }
+    }
+    return status;
+}
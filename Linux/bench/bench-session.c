@@ -0,0 +1,160 @@
+/**
+ * \file bench-session.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host benchmark of the LoRaMesh session table
+ *
+ * Runs LoRaSession.c of the LoRaStack, built for a router with
+ * LORAMESH_CONFIG_MAX_NOF_CHILD_NODES children (see Makefile), i.e. with the
+ * derived table size of LoRaMesh-config.h. The table is filled with device
+ * addresses of one network (same NwkID, random NwkAddr) step by step up to a
+ * load factor of 15/16. At every step the host cycles of a lookup of a
+ * present address (hit) and of an absent one (miss) are measured, as well as
+ * of a removal followed by the insertion of a new child (churn, the removal
+ * shifts the probe sequence back).
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "board.h"
+#include "LoRaSession.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RUNS                                     31
+#define TABLE_SIZE                                  LORAMESH_CONFIG_SESSION_TABLE_SIZE
+#define NB_ADDRESSES                                (TABLE_SIZE * 2)
+
+/*! NwkID of the simulated network, upper 7 bits of the device address */
+#define NWK_ID                                      (0x13UL << 25)
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! First TABLE_SIZE addresses are inserted, the others are looked up as misses */
+static uint32_t Addresses[NB_ADDRESSES];
+
+static volatile uintptr_t Sink;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+static void MakeAddresses( void )
+{
+    uint32_t addr;
+    uint16_t i, j;
+
+    srand(9);
+    for ( i = 0; i < NB_ADDRESSES; i++ ) {
+        do {
+            addr = NWK_ID | ((((uint32_t) rand() << 8) ^ (uint32_t) rand()) & 0x01FFFFFF);
+            for ( j = 0; j < i && Addresses[j] != addr; j++ ) {
+            }
+        } while ( j < i );
+        Addresses[i] = addr;
+    }
+}
+
+/*! Best of NB_RUNS, cycles per lookup of count addresses starting at first */
+static double Lookup( uint16_t first, uint16_t count, bool present )
+{
+    uint64_t t, best = UINT64_MAX;
+    LoRaMeshSession_t *session;
+    unsigned errors = 0;
+    uint16_t i;
+    int run;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        t = Cycles();
+        for ( i = 0; i < count; i++ ) {
+            session = LoRaSession_Find(Addresses[first + i]);
+            errors += ((session != NULL) != present);
+            Sink += (uintptr_t) session;
+        }
+        t = Cycles() - t;
+        best = (t < best) ? t : best;
+    }
+
+    if ( errors != 0 ) {
+        printf("lookup errors %u\n", errors);
+        exit(1);
+    }
+    return (double) best / count;
+}
+
+/*! Cycles per removal and insertion of a child, the table keeps its fill */
+static double Churn( uint16_t fill )
+{
+    uint64_t t, best = UINT64_MAX;
+    uint16_t i;
+    int run;
+
+    for ( run = 0; run < NB_RUNS; run++ ) {
+        t = Cycles();
+        /* Replace every child by a new one, then restore the former children */
+        for ( i = 0; i < fill; i++ ) {
+            LoRaSession_Remove(Addresses[i]);
+            (void) LoRaSession_Add(Addresses[TABLE_SIZE + i], SESSION_TYPE_CHILD_NODE, NULL, NULL);
+        }
+        for ( i = 0; i < fill; i++ ) {
+            LoRaSession_Remove(Addresses[TABLE_SIZE + i]);
+            (void) LoRaSession_Add(Addresses[i], SESSION_TYPE_CHILD_NODE, NULL, NULL);
+        }
+        t = Cycles() - t;
+        best = (t < best) ? t : best;
+    }
+    return (double) best / (2 * fill);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t loads[] = { 1, 2, 4, 6, 8, 10, 12, 14, 15 }; /* in 1/16 */
+    uint16_t i, fill, filled = 0;
+    double hit, miss, churn;
+
+    MakeAddresses();
+    LoRaSession_Init();
+
+    printf("session table, %u entries for %u children and %u groups, cycles per operation\n",
+            TABLE_SIZE, LORAMESH_CONFIG_MAX_NOF_CHILD_NODES,
+            LORAMESH_CONFIG_MAX_NOF_MULTICAST_GROUPS);
+    printf("  %8s %8s %8s %8s %8s\n", "sessions", "load", "hit", "miss", "churn");
+    for ( i = 0; i < sizeof(loads); i++ ) {
+        fill = (uint16_t)((TABLE_SIZE * loads[i]) / 16);
+        for ( ; filled < fill; filled++ ) {
+            if ( LoRaSession_Add(Addresses[filled], SESSION_TYPE_CHILD_NODE, NULL, NULL) == NULL ) {
+                printf("insert failed at %u sessions\n", filled);
+                return 1;
+            }
+        }
+        hit = Lookup(0, fill, true);
+        miss = Lookup(TABLE_SIZE, fill, false);
+        churn = Churn(fill);
+        /* The churn leaves the table as it found it, the lookups check it */
+        (void) Lookup(0, fill, true);
+        (void) Lookup(TABLE_SIZE, fill, false);
+        printf("  %8u %8.3f %8.1f %8.1f %8.1f%s\n", fill, (double) fill / TABLE_SIZE, hit, miss,
+                churn, (fill > LORAMESH_CONFIG_NOF_SESSIONS) ? "  above configured sessions" : "");
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * \file radio-node.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1276 or SX1272 driver on the fake radio of the register shadow test
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "gpio.h"
+#include "spi.h"
+#if defined(RADIO_SX1272)
+#include "sx1272/sx1272.h"
+#include "sx1272-board.h"
+#else
+#include "sx1276/sx1276.h"
+#include "sx1276-board.h"
+#endif
+#include "fake-sx127x.h"
+#include "radio-node.h"
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static RadioEvents_t Events;
+static DioIrqHandler **DioIrqHandlers;
+
+/*******************************************************************************
+ * STUBS OF THE BOARD AND THE TIMERS
+ ******************************************************************************/
+#if defined(RADIO_SX1272)
+/*! Declared in sx1272.c only, SX1272Init resets the radio */
+void SX1272Reset( void );
+
+const struct Radio_s Radio = { SX1272Init, SX1272Reset, SX1272GetStatus, SX1272SetModem,
+        SX1272SetChannel, SX1272IsChannelFree, SX1272Random, SX1272SetRxConfig,
+        SX1272SetTxConfig, SX1272CheckRfFrequency, SX1272GetTimeOnAir, SX1272Send,
+        SX1272SetSleep, SX1272SetStby, SX1272SetRx, SX1272StartCad, SX1272ReadRssi,
+        SX1272Write, SX1272Read, SX1272WriteBuffer, SX1272ReadBuffer,
+        SX1272SetMaxPayloadLength };
+
+void SX1272IoIrqInit( DioIrqHandler **irqHandlers )
+{
+    DioIrqHandlers = irqHandlers;
+}
+
+uint8_t SX1272GetPaSelect( uint32_t channel )
+{
+    return RF_PACONFIG_PASELECT_RFO;
+}
+
+void SX1272SetAntSwLowPower( bool status )
+{
+}
+
+void SX1272SetAntSw( uint8_t rxTx )
+{
+}
+
+bool SX1272CheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+#else
+const struct Radio_s Radio = { SX1276Init, SX1276Reset, SX1276GetStatus, SX1276SetModem,
+        SX1276SetChannel, SX1276IsChannelFree, SX1276Random, SX1276SetRxConfig,
+        SX1276SetTxConfig, SX1276CheckRfFrequency, SX1276GetTimeOnAir, SX1276Send,
+        SX1276SetSleep, SX1276SetStby, SX1276SetRx, SX1276StartCad, SX1276ReadRssi,
+        SX1276Write, SX1276Read, SX1276WriteBuffer, SX1276ReadBuffer,
+        SX1276SetMaxPayloadLength };
+
+void SX1276IoIrqInit( DioIrqHandler **irqHandlers )
+{
+    DioIrqHandlers = irqHandlers;
+}
+
+uint8_t SX1276GetPaSelect( uint32_t channel )
+{
+    return RF_PACONFIG_PASELECT_PABOOST;
+}
+
+void SX1276SetAntSwLowPower( bool status )
+{
+}
+
+void SX1276SetAntSw( uint8_t rxTx )
+{
+}
+
+bool SX1276CheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+#endif
+
+void TimerInit( TimerEvent_t *obj, void (*callback)( void ) )
+{
+}
+
+void TimerStart( TimerEvent_t *obj )
+{
+}
+
+void TimerStop( TimerEvent_t *obj )
+{
+}
+
+void TimerSetValue( TimerEvent_t *obj, uint32_t value )
+{
+}
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return 0;
+}
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void RadioNodeInit( void )
+{
+    FakeSx127xReset();
+#if defined(RADIO_SX1272)
+    SX1272.Spi.Spi = &SX1272;
+    SX1272.Spi.Nss.pin = (PinNames) FakeSx127xGetNssPin();
+    Radio.Init(&Events);
+#else
+    SX1276.Spi.Spi = &SX1276;
+    SX1276.Spi.Nss.pin = (PinNames) FakeSx127xGetNssPin();
+    Radio.Init(&Events);
+    Radio.Reset();
+#endif
+}
+
+void RadioNodeIrq( uint8_t dio, uint8_t flags )
+{
+    FakeSx127xRegs[REG_LR_IRQFLAGS] = flags;
+    DioIrqHandlers[dio]();
+}
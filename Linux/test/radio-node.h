@@ -0,0 +1,36 @@
+/**
+ * \file radio-node.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1276 or SX1272 driver on the fake radio of the register shadow test
+ *
+ * The node is built as shared object together with one radio driver and
+ * test/radio/fake-sx127x.c, once with the register shadow of the driver and
+ * once without it. The test loads both, drives them through their Radio
+ * structure and compares the register files of their fakes.
+ */
+#ifndef __RADIO_NODE_H__
+#define __RADIO_NODE_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Resets the fake radio and initializes the driver.
+ */
+void RadioNodeInit( void );
+
+/*!
+ * \brief Raises a DIO interrupt of the LoRa modem.
+ *
+ * \param dio DIO line, 0 to 5.
+ * \param flags LoRa IRQ flags set before the interrupt.
+ */
+void RadioNodeIrq( uint8_t dio, uint8_t flags );
+
+#endif /* __RADIO_NODE_H__ */
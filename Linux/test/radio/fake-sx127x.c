@@ -0,0 +1,175 @@
+/**
+ * \file fake-sx127x.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1272/SX1276 register file behind the SPI of the host radio tests
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "gpio.h"
+#include "spi.h"
+#if defined(RADIO_SX1272)
+/* The SX1276 register definitions of board.h are left out for the SX1272, the
+ * addresses the fake decodes are the same on both radios */
+#include "sx1272/sx1272Regs-Fsk.h"
+#include "sx1272/sx1272Regs-LoRa.h"
+#endif
+#include "fake-sx127x.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define REG_VERSION_VALUE                           0x12
+#define REG_OPMODE_RESET_VALUE                      0x09
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+uint8_t FakeSx127xRegs[FAKE_SX127X_NB_REGS];
+uint8_t FakeSx127xFskRegs[FAKE_SX127X_NB_REGS];
+uint8_t FakeSx127xFifo[FAKE_SX127X_FIFO_SIZE];
+FakeSx127xStats_t FakeSx127xStats;
+FakeGpioPort_t FakeSx127xDebugPort;
+
+/*! State of the current frame */
+static bool Selected;
+static uint16_t FrameIndex;
+static uint8_t FrameAddr;
+static bool FrameWrite;
+
+/*! FIFO pointer of the FSK modem, the LoRa modem uses REG_LR_FIFOADDRPTR */
+static uint8_t FskFifoPtr;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Exchanges one byte of the current frame */
+static uint8_t InOut( uint8_t out );
+
+/*******************************************************************************
+ * STUBS OF THE BOARD SPI AND GPIO
+ ******************************************************************************/
+void GpioInit( Gpio_t *obj, PinNames pin, PinModes mode, PinConfigs config, PinTypes type,
+        uint32_t value )
+{
+    obj->pin = pin;
+}
+
+void GpioWrite( Gpio_t *obj, uint32_t value )
+{
+    if ( obj->pin == (PinNames) FakeSx127xGetNssPin() ) {
+        Selected = (value == 0);
+        FrameIndex = 0;
+        FakeSx127xStats.Frames += Selected;
+    }
+}
+
+uint32_t GpioRead( Gpio_t *obj )
+{
+    return 0;
+}
+
+uint16_t SpiInOut( Spi_t *obj, uint16_t outData )
+{
+    FakeSx127xStats.Transactions++;
+    return InOut((uint8_t) outData);
+}
+
+uint8_t SpiMcuTransfer( struct Spi_s *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( struct Spi_s *obj ) )
+{
+    uint16_t i;
+    uint8_t data;
+
+    FakeSx127xStats.Transactions++;
+    for ( i = 0; i < size; i++ ) {
+        data = InOut((tx != NULL) ? tx[i] : 0x00);
+        if ( rx != NULL ) {
+            rx[i] = data;
+        }
+    }
+    if ( callback != NULL ) {
+        callback(obj);
+    }
+    return 0;
+}
+
+void DelayMs( uint32_t ms )
+{
+}
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void FakeSx127xReset( void )
+{
+    memset1(FakeSx127xRegs, 0, sizeof(FakeSx127xRegs));
+    memset1(FakeSx127xFskRegs, 0, sizeof(FakeSx127xFskRegs));
+    memset1(FakeSx127xFifo, 0, sizeof(FakeSx127xFifo));
+    memset1((uint8_t*) &FakeSx127xStats, 0, sizeof(FakeSx127xStats));
+    FakeSx127xRegs[REG_OPMODE] = REG_OPMODE_RESET_VALUE;
+    FakeSx127xRegs[REG_VERSION] = REG_VERSION_VALUE;
+    Selected = false;
+    FskFifoPtr = 0;
+}
+
+uint32_t FakeSx127xGetNssPin( void )
+{
+    return PIN_NSS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint8_t InOut( uint8_t out )
+{
+    bool lora = (FakeSx127xRegs[REG_OPMODE] & RFLR_OPMODE_LONGRANGEMODE_ON) != 0;
+    uint8_t *fifoPtr = lora ? &FakeSx127xRegs[REG_LR_FIFOADDRPTR] : &FskFifoPtr;
+    uint8_t *reg, in = 0;
+
+    FakeSx127xStats.Bytes++;
+    if ( Selected == false ) {
+        return 0;
+    }
+    if ( FrameIndex++ == 0 ) {
+        FrameAddr = out & 0x7F;
+        FrameWrite = (out & 0x80) != 0;
+        return 0;
+    }
+
+    if ( FrameAddr == REG_FIFO ) {
+        if ( FrameWrite == true ) {
+            FakeSx127xFifo[(*fifoPtr)++] = out;
+        } else {
+            in = FakeSx127xFifo[(*fifoPtr)++];
+        }
+        return in;
+    }
+
+    if ( (lora == false) && (FrameAddr >= FAKE_SX127X_PAGE_FIRST)
+            && (FrameAddr <= FAKE_SX127X_PAGE_LAST) ) {
+        reg = &FakeSx127xFskRegs[FrameAddr];
+    } else {
+        reg = &FakeSx127xRegs[FrameAddr];
+    }
+
+    if ( FrameWrite == true ) {
+        FakeSx127xStats.RegWrites++;
+        if ( lora && (FrameAddr == REG_LR_IRQFLAGS) ) {
+            // The IRQ flags are cleared by writing 1
+            FakeSx127xStats.RedundantWrites += ((*reg & out) == 0);
+            *reg &= ~out;
+        } else {
+            FakeSx127xStats.RedundantWrites += (*reg == out);
+            *reg = out;
+        }
+    } else {
+        FakeSx127xStats.RegReads++;
+        in = *reg;
+    }
+    FrameAddr = (FrameAddr + 1) & 0x7F;
+    return in;
+}
@@ -0,0 +1,89 @@
+/**
+ * \file fake-sx127x.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1272/SX1276 register file behind the SPI of the host radio tests
+ *
+ * The fake decodes the SPI frames of the radio drivers: the chip select
+ * starts a frame, the first byte is the address with the write flag, the
+ * following bytes access consecutive registers or, for address 0, the FIFO.
+ * The modem specific registers have a page per modem, selected by the
+ * LongRangeMode bit of REG_OPMODE. The SPI and GPIO functions of the board
+ * are provided here, every call of SpiInOut or SpiMcuTransfer counts as one
+ * bus transaction.
+ */
+#ifndef __FAKE_SX127X_H__
+#define __FAKE_SX127X_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define FAKE_SX127X_NB_REGS                         0x80
+#define FAKE_SX127X_FIFO_SIZE                       256
+
+/*! Modem specific registers, the other ones are common to both modems */
+#define FAKE_SX127X_PAGE_FIRST                      0x0D
+#define FAKE_SX127X_PAGE_LAST                       0x3F
+
+/*! Port B of the Kinetis boards, the radio drivers toggle debug pins on it */
+#define PTB_BASE_PTR                                (&FakeSx127xDebugPort)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Bus statistics */
+typedef struct FakeSx127xStats_s {
+    uint32_t Transactions;      //! SpiInOut and SpiMcuTransfer calls
+    uint32_t Bytes;             //! Bytes exchanged
+    uint32_t Frames;            //! Chip select periods
+    uint32_t RegWrites;         //! Register bytes written, FIFO excluded
+    uint32_t RegReads;          //! Register bytes read, FIFO excluded
+    uint32_t RedundantWrites;   //! Register writes which did not change the content
+} FakeSx127xStats_t;
+
+/*! Set and clear registers of a port */
+typedef struct FakeGpioPort_s {
+    uint32_t PSOR;
+    uint32_t PCOR;
+} FakeGpioPort_t;
+
+/*******************************************************************************
+ * VARIABLES (PUBLIC)
+ ******************************************************************************/
+/*! Register file, common registers and the LoRa page */
+extern uint8_t FakeSx127xRegs[FAKE_SX127X_NB_REGS];
+
+/*! FSK page, [FAKE_SX127X_PAGE_FIRST .. FAKE_SX127X_PAGE_LAST] */
+extern uint8_t FakeSx127xFskRegs[FAKE_SX127X_NB_REGS];
+
+/*! FIFO data buffer */
+extern uint8_t FakeSx127xFifo[FAKE_SX127X_FIFO_SIZE];
+
+/*! Bus statistics since the last reset */
+extern FakeSx127xStats_t FakeSx127xStats;
+
+/*! Debug pins */
+extern FakeGpioPort_t FakeSx127xDebugPort;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Sets the registers to their reset values and clears the statistics.
+ */
+void FakeSx127xReset( void );
+
+/*!
+ * \brief Gets the chip select pin of the fake.
+ *
+ * \retval uint32_t Pin the driver has to assign to its SPI Nss.
+ */
+uint32_t FakeSx127xGetNssPin( void );
+
+#endif /* __FAKE_SX127X_H__ */
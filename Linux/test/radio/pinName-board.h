@@ -0,0 +1,13 @@
+/**
+ * \file pinName-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Pin names of the host radio driver tests
+ */
+#ifndef __PIN_NAME_MCU_H__
+#define __PIN_NAME_MCU_H__
+
+#define MCU_PINS \
+    PIN_RESET = 0, PIN_NSS, PIN_OUT_OF_RANGE
+
+#endif // __PIN_NAME_MCU_H__
@@ -0,0 +1,13 @@
+/**
+ * \file pinName-ioe.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief IO expander pin names of the host radio driver tests, there is none
+ */
+#ifndef __PIN_NAME_IOE_H__
+#define __PIN_NAME_IOE_H__
+
+#define IOE_PINS \
+    IOE_0
+
+#endif // __PIN_NAME_IOE_H__
@@ -0,0 +1,29 @@
+/**
+ * \file spi-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SPI of the host radio driver tests
+ *
+ * SPI_BURST selects the path of SpiTransfer: 1 defines SPI_MCU_TRANSFER like
+ * the tinyK20, STM32L1 and FRDM-K22F boards, 0 leaves the SpiInOut loop of
+ * the FRDM-KL26Z.
+ */
+#ifndef __SPI_MCU_H__
+#define __SPI_MCU_H__
+
+#if defined(SPI_BURST) && (SPI_BURST == 1)
+#define SPI_MCU_TRANSFER
+#endif
+
+struct Spi_s {
+    void *Spi;
+    Gpio_t Mosi;
+    Gpio_t Miso;
+    Gpio_t Sclk;
+    Gpio_t Nss;
+};
+
+uint8_t SpiMcuTransfer( struct Spi_s *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( struct Spi_s *obj ) );
+
+#endif  // __SPI_MCU_H__
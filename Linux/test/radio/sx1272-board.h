@@ -0,0 +1,19 @@
+/**
+ * \file sx1272-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1272 board definitions of the host radio driver tests
+ *
+ * The register initialization and the prototypes are the ones of the
+ * LoRaMote, the board functions are stubbed by the tests.
+ */
+#ifndef __SX1272_HOST_H__
+#define __SX1272_HOST_H__
+
+#define RADIO_RESET                                 PIN_RESET
+
+#include "fake-sx127x.h"
+
+#include "../../../src/boards/LoRaMote/sx1272-board.h"
+
+#endif // __SX1272_HOST_H__
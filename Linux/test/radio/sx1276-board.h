@@ -0,0 +1,20 @@
+/**
+ * \file sx1276-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief SX1276 board definitions of the host radio driver tests
+ *
+ * The register initialization and the prototypes are the ones of the
+ * tinyK20, the board functions are stubbed by the tests. The port B debug
+ * pins the driver toggles are the ones of fake-sx127x.h.
+ */
+#ifndef __SX1276_HOST_H__
+#define __SX1276_HOST_H__
+
+#define RADIO_RESET                                 PIN_RESET
+
+#include "fake-sx127x.h"
+
+#include "../../../src/boards/tinyK20/sx1276-board.h"
+
+#endif // __SX1276_HOST_H__
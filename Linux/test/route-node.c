@@ -0,0 +1,287 @@
+/**
+ * \file route-node.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMesh routing node of the host multi-hop test
+ *
+ * LoRaMac.c, LoRaFrm.c, LoRaSession.c, LoRaStats.c and LoRaRoute.c of the
+ * LoRaStack with LORAMESH_CONFIG_ROUTING_ENABLED, the mesh layer above and
+ * the PHY below are stubbed. Frames are received into a single buffer which
+ * stands in for the PHY buffer pool, so the MAC forwards them in place.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMesh.h"
+#include "route-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_CHILDREN_MAX                             8
+#define NB_TX_MAX                                   8
+#define NB_RX_MAX                                   8
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static LoRaDevice_t Device;
+static ChildNodeInfo_t Children[NB_CHILDREN_MAX];
+static uint8_t NbChildren;
+
+/*! Receive buffer, the only "pool" buffer of the node */
+static uint8_t RxBuffer[LORAPHY_BUFFER_SIZE];
+
+static RouteNodeTx_t TxQueue[NB_TX_MAX];
+static uint8_t TxHead, TxCount;
+static RouteNodeRx_t RxQueue[NB_RX_MAX];
+static uint8_t RxHead, RxCount;
+
+static uint64_t Time;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Session keys of a node, known to its parent and the coordinator */
+static void DeriveKeys( uint32_t devAddr, ConnectionInfo_t *connection );
+
+/*******************************************************************************
+ * STUBS OF THE LAYERS AROUND LoRaMac AND LoRaFrm
+ ******************************************************************************/
+LoRaDevice_t* pLoRaDevice = &Device;
+const uint8_t Datarates[] = { 12, 11, 10, 9, 8, 7, 7, 50 };
+const uint8_t MaxPayloadByDatarate[] = { 51, 51, 51, 115, 242, 242, 242, 242 };
+const struct Radio_s Radio;
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return Time;
+}
+
+uint8_t LoRaMesh_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr, uint8_t fPort )
+{
+    RouteNodeRx_t *rx;
+
+    if ( RxCount == NB_RX_MAX ) return ERR_QFULL;
+    rx = &RxQueue[(RxHead + RxCount++) % NB_RX_MAX];
+    rx->DevAddr = devAddr;
+    rx->FPort = fPort;
+    rx->Size = payloadSize;
+    memcpy1(rx->Payload, buf, payloadSize);
+    return ERR_OK;
+}
+
+void LoRaMesh_StoreFrameCounters( LoRaMeshSession_t *session )
+{
+}
+
+void LoRaMesh_StoreSession( void )
+{
+}
+
+void LoRaMesh_SetDevAddr( uint32_t devAddr )
+{
+}
+
+uint8_t LoRaMesh_ProcessAdvertising( uint8_t *aPayload, uint8_t aPayloadSize )
+{
+    return ERR_OK;
+}
+
+uint8_t LoRaMesh_ProcessJoinMeshReq( uint8_t *payload, uint8_t payloadSize )
+{
+    return ERR_FAILED;
+}
+
+uint8_t LoRaMesh_ProcessRebindMeshReq( uint8_t *payload, uint8_t payloadSize )
+{
+    return ERR_FAILED;
+}
+
+bool LoRaPhy_IsPoolBuffer( uint8_t *buf )
+{
+    return buf == RxBuffer;
+}
+
+uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t channel,
+        uint8_t flags )
+{
+    RouteNodeTx_t *tx;
+
+    if ( channel >= LORA_MAX_NB_CHANNELS ) return ERR_RANGE;
+    if ( payloadSize > LORAPHY_PAYLOAD_SIZE ) return ERR_OVERFLOW;
+    if ( TxCount == NB_TX_MAX ) return ERR_QFULL;
+
+    tx = &TxQueue[(TxHead + TxCount++) % NB_TX_MAX];
+    LORAPHY_BUF_FLAGS(tx->Phy) = flags;
+    LORAPHY_BUF_SIZE(tx->Phy) = (uint8_t) payloadSize;
+    memcpy1(LORAPHY_BUF_PAYLOAD_START(tx->Phy), LORAPHY_BUF_PAYLOAD_START(buf), payloadSize);
+    tx->ChannelIndex = channel;
+    tx->Advertising = ((flags & LORAPHY_PACKET_FLAGS_FRM_MASK)
+            == LORAPHY_PACKET_FLAGS_FRM_ADVERTISING);
+    return ERR_OK;
+}
+
+void LoRaPhy_SetChannel( uint8_t id, LoRaPhy_ChannelParams_t params )
+{
+}
+
+void LoRaPhy_SetReceiveDelay1( uint32_t delay )
+{
+}
+
+void LoRaPhy_SetReceiveDelay2( uint32_t delay )
+{
+}
+
+void LoRaPhy_SetMaxDutyCycle( uint8_t maxDCycle )
+{
+}
+
+void LoRaPhy_SetDownLinkSettings( uint8_t rx1DrOffset, uint8_t rx2Dr )
+{
+}
+
+void LoRaPhy_SetRxParameters( uint8_t rx1DrOffset, uint8_t rx2Dr, uint32_t rx2Freq )
+{
+}
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void RouteNodeInit( const RouteNodeConfig_t *config )
+{
+    memset1((uint8_t*) &Device, 0, sizeof(Device));
+    Device.devAddr = config->DevAddr;
+    Device.coordinatorAddr = config->CoordinatorAddr;
+    Device.devRole = (config->DevAddr == config->CoordinatorAddr) ? COORDINATOR : ROUTER;
+    Device.ctrlFlags.Bits.nwkJoined = 1;
+    Device.currDataRateIndex = DR_5;
+    Device.currChannelIndex = config->CurrChannelIndex;
+    Device.nbRep = 1;
+
+    LoRaSession_Init();
+    LoRaRoute_Init();
+    if ( Device.devRole != COORDINATOR ) {
+        DeriveKeys(config->DevAddr, &Device.upLinkSlot);
+        Device.upLinkSlot.ChannelIndex = config->ChannelIndex;
+        Device.upLinkSlot.DataRateIndex = DR_5;
+        (void) LoRaSession_Add(config->DevAddr, SESSION_TYPE_UPLINK, &Device.upLinkSlot, NULL);
+    }
+}
+
+void RouteNodeAddChild( uint32_t devAddr, uint8_t channelIndex )
+{
+    ChildNodeInfo_t *child;
+
+    if ( NbChildren == NB_CHILDREN_MAX ) return;
+    child = &Children[NbChildren++];
+    memset1((uint8_t*) child, 0, sizeof(ChildNodeInfo_t));
+    DeriveKeys(devAddr, &child->Connection);
+    child->Connection.ChannelIndex = channelIndex;
+    child->Connection.DataRateIndex = DR_5;
+    (void) LoRaSession_Add(devAddr, SESSION_TYPE_CHILD_NODE, &child->Connection, child);
+}
+
+void RouteNodeSetTime( uint64_t time )
+{
+    Time = time;
+}
+
+void RouteNodeAdvertise( void )
+{
+    uint8_t buf[LORAPHY_BUFFER_SIZE], *payload = LORAPHY_BUF_PAYLOAD_START(buf);
+    uint8_t i = 0;
+
+    memset1(buf, 0, sizeof(buf));
+    /* Layout of LoRaMesh_SendAdvertising */
+    payload[i++] = Device.devAddr & 0xFF;
+    payload[i++] = (Device.devAddr >> 8) & 0xFF;
+    payload[i++] = (Device.devAddr >> 16) & 0xFF;
+    payload[i++] = (Device.devAddr >> 24) & 0xFF;
+    payload[i++] = (Device.devRole & 0xF) << 4;
+    i += 8; /* Location */
+    payload[i++] = Device.coordinatorAddr & 0xFF;
+    payload[i++] = (Device.coordinatorAddr >> 8) & 0xFF;
+    payload[i++] = (Device.coordinatorAddr >> 16) & 0xFF;
+    payload[i++] = (Device.coordinatorAddr >> 24) & 0xFF;
+    i += 6; /* Advertising slot */
+    payload[i++] = (Device.coordinatorAddr == Device.devAddr) ?
+            0 : LoRaRoute_GetAdvertisedMetric();
+
+    (void) LoRaPhy_PutPayload(buf, sizeof(buf), i, Device.currChannelIndex,
+            LORAPHY_PACKET_FLAGS_FRM_ADVERTISING);
+}
+
+uint8_t RouteNodeSendUp( uint8_t fPort, const uint8_t *payload, uint8_t size )
+{
+    uint8_t buf[LORAMESH_BUFFER_SIZE];
+
+    memcpy1(LORAMESH_BUF_PAYLOAD_START(buf), payload, size);
+    return LoRaFrm_PutPayload(buf, sizeof(buf), size, Device.devAddr, fPort, false);
+}
+
+bool RouteNodeGetTx( RouteNodeTx_t *tx )
+{
+    if ( TxCount == 0 ) return false;
+    *tx = TxQueue[TxHead];
+    TxHead = (TxHead + 1) % NB_TX_MAX;
+    TxCount--;
+    return true;
+}
+
+uint8_t RouteNodeOnRx( const uint8_t *phy, int8_t snr )
+{
+    LoRaPhy_PacketDesc packet;
+
+    memcpy1(RxBuffer, phy, LORAPHY_BUF_SIZE(phy) + LORAPHY_HEADER_SIZE);
+    packet.flags = LORAPHY_BUF_FLAGS(phy) & LORAPHY_PACKET_FLAGS_FRM_MASK;
+    packet.phyData = RxBuffer;
+    packet.phySize = sizeof(RxBuffer);
+    packet.rxtx = LORAPHY_BUF_PAYLOAD_START(RxBuffer);
+    packet.rssi = -100;
+    packet.snr = snr;
+    return LoRaMac_OnPacketRx(&packet);
+}
+
+bool RouteNodeGetRx( RouteNodeRx_t *rx )
+{
+    if ( RxCount == 0 ) return false;
+    *rx = RxQueue[RxHead];
+    RxHead = (RxHead + 1) % NB_RX_MAX;
+    RxCount--;
+    return true;
+}
+
+bool RouteNodeGetRoute( uint32_t dest, uint32_t *nextHop, uint16_t *metric )
+{
+    const LoRaRoute_Entry_t *route = LoRaRoute_Lookup(dest);
+
+    if ( route == NULL ) return false;
+    *nextHop = route->NextHop;
+    *metric = route->Metric;
+    return true;
+}
+
+uint8_t RouteNodeGetCurrChannelIndex( void )
+{
+    return Device.currChannelIndex;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void DeriveKeys( uint32_t devAddr, ConnectionInfo_t *connection )
+{
+    uint8_t k;
+
+    connection->Address = devAddr;
+    for ( k = 0; k < 16; k++ ) {
+        connection->NwkSKey[k] = (uint8_t) (devAddr * 7 + k);
+        connection->AppSKey[k] = (uint8_t) (devAddr * 13 + 0x80 + k);
+    }
+    connection->UpLinkCounter = 1;
+    connection->DownLinkCounter = 0;
+}
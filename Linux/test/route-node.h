@@ -0,0 +1,120 @@
+/**
+ * \file route-node.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMesh routing node of the host multi-hop test
+ *
+ * The node is built as shared object together with the MAC, the frame layer,
+ * the session table and the route table of the LoRaStack, routing enabled.
+ * The test loads one copy of the shared object per node, so that every node
+ * has its own stack globals. Frames queued by the MAC are kept in an outbox
+ * the test hands over to the neighbors of the node.
+ */
+#ifndef __ROUTE_NODE_H__
+#define __ROUTE_NODE_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Size of the PHY buffers exchanged with the test, <flags><size><phy payload> */
+#define ROUTE_NODE_FRAME_SIZE                       (2 + 255)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node configuration */
+typedef struct RouteNodeConfig_s {
+    uint32_t DevAddr;           //! Device address
+    uint32_t CoordinatorAddr;   //! Coordinator address, DevAddr for the coordinator
+    uint8_t ChannelIndex;       //! Channel of the uplink session
+    uint8_t CurrChannelIndex;   //! Initial pLoRaDevice->currChannelIndex
+} RouteNodeConfig_t;
+
+/*! Frame queued by the MAC */
+typedef struct RouteNodeTx_s {
+    uint8_t Phy[ROUTE_NODE_FRAME_SIZE]; //! <flags><size><phy payload>
+    uint8_t ChannelIndex;       //! Channel passed to LoRaPhy_PutPayload
+    bool Advertising;           //! Advertising beacon
+} RouteNodeTx_t;
+
+/*! Frame delivered to the application */
+typedef struct RouteNodeRx_s {
+    uint32_t DevAddr;           //! Origin of the frame
+    uint8_t FPort;              //! Port
+    uint8_t Size;               //! Payload size
+    uint8_t Payload[ROUTE_NODE_FRAME_SIZE]; //! Decrypted payload
+} RouteNodeRx_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes the node as joined with an uplink session, the
+ *        coordinator has none.
+ */
+void RouteNodeInit( const RouteNodeConfig_t *config );
+
+/*!
+ * \brief Adds the child node session of a node, the session keys are derived
+ *        from the address on both sides.
+ */
+void RouteNodeAddChild( uint32_t devAddr, uint8_t channelIndex );
+
+/*!
+ * \brief Sets the time of the node [us].
+ */
+void RouteNodeSetTime( uint64_t time );
+
+/*!
+ * \brief Queues an advertising beacon with the path metric to the coordinator.
+ */
+void RouteNodeAdvertise( void );
+
+/*!
+ * \brief Queues an unconfirmed uplink to the parent.
+ *
+ * \retval uint8_t Status of LoRaFrm_PutPayload.
+ */
+uint8_t RouteNodeSendUp( uint8_t fPort, const uint8_t *payload, uint8_t size );
+
+/*!
+ * \brief Takes the oldest frame out of the outbox.
+ *
+ * \retval bool False if the outbox is empty.
+ */
+bool RouteNodeGetTx( RouteNodeTx_t *tx );
+
+/*!
+ * \brief Hands a received frame to LoRaMac_OnPacketRx.
+ *
+ * \param phy <flags><size><phy payload> as queued by the sender.
+ * \param snr SNR of the frame [dB].
+ */
+uint8_t RouteNodeOnRx( const uint8_t *phy, int8_t snr );
+
+/*!
+ * \brief Takes the oldest frame delivered to the application.
+ *
+ * \retval bool False if none is left.
+ */
+bool RouteNodeGetRx( RouteNodeRx_t *rx );
+
+/*!
+ * \brief Looks up the route to a destination.
+ *
+ * \retval bool False if there is no valid route.
+ */
+bool RouteNodeGetRoute( uint32_t dest, uint32_t *nextHop, uint16_t *metric );
+
+/*!
+ * \brief Returns pLoRaDevice->currChannelIndex.
+ */
+uint8_t RouteNodeGetCurrChannelIndex( void );
+
+#endif /* __ROUTE_NODE_H__ */
@@ -0,0 +1,50 @@
+/**
+ * \file FreeRTOS.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief FreeRTOS port of the host timer tests
+ *
+ * The types and port macros src/system/timer.c uses with USE_FREE_RTOS, the
+ * kernel behind them is the one of fake-rtos.c. The tick rate is the one of
+ * the tinyK20 FreeRTOSConfig.h (1 kHz).
+ */
+#ifndef __FREERTOS_HOST_H__
+#define __FREERTOS_HOST_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define pdFALSE                                     ( ( BaseType_t ) 0 )
+#define pdTRUE                                      ( ( BaseType_t ) 1 )
+#define pdPASS                                      ( pdTRUE )
+#define pdFAIL                                      ( pdFALSE )
+
+#define configTICK_RATE_HZ                          ( ( TickType_t ) 1000 )
+#define portTICK_PERIOD_MS                          ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+
+/*! The interrupts are not nested on the host, masking is a no-op */
+#define portSET_INTERRUPT_MASK_FROM_ISR()           ( ( UBaseType_t ) 0 )
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )      ( ( void ) ( x ) )
+#define portEND_SWITCHING_ISR( x )                  ( ( void ) ( x ) )
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+TickType_t xTaskGetTickCount( void );
+TickType_t xTaskGetTickCountFromISR( void );
+
+#endif /* __FREERTOS_HOST_H__ */
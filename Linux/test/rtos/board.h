@@ -0,0 +1,26 @@
+/**
+ * \file board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Board definitions of the host FreeRTOS timer tests
+ */
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "timer.h"
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief CMSIS interrupt program status, non zero in the simulated interrupts
+ */
+uint32_t __get_IPSR( void );
+
+#endif /* __BOARD_H__ */
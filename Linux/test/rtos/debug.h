@@ -0,0 +1,15 @@
+/**
+ * \file debug.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Log macros of the host FreeRTOS timer tests, errors are printed
+ */
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+#include <stdio.h>
+
+#define LOG_TRACE( fmt, ... )                       do { } while ( 0 )
+#define LOG_ERROR( fmt, ... )                       printf("ERROR: " fmt "\n", ##__VA_ARGS__)
+
+#endif /* __DEBUG_H__ */
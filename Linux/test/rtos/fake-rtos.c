@@ -0,0 +1,404 @@
+/**
+ * \file fake-rtos.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Simulated FreeRTOS kernel of the host timer tests
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdlib.h>
+#include "board.h"
+#include "timer-board.h"
+#include "fake-rtos.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define FAKE_RTOS_NB_TIMERS                         16
+#define FAKE_RTOS_TICK_PERIOD                       (portTICK_PERIOD_MS * 1000)
+#define FAKE_RTOS_TIME_NEVER                        UINT64_MAX
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Timer task commands */
+typedef enum {
+    CMD_START, CMD_STOP, CMD_CHANGE_PERIOD, CMD_PEND
+} Command_t;
+
+/*! Software timer */
+typedef struct FakeTimer_s {
+    const char *Name;
+    TickType_t Period;
+    TickType_t Expiry;
+    bool AutoReload;
+    bool IsActive;
+    void *Id;
+    TimerCallbackFunction_t Callback;
+} FakeTimer_t;
+
+/*! Entry of the timer command queue */
+typedef struct Message_s {
+    Command_t Command;
+    FakeTimer_t *Timer;
+    TickType_t Value;           //! Tick count of the send or new period
+    PendedFunction_t Function;
+    void *Parameter1;
+    uint32_t Parameter2;
+} Message_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+FakeRtosStats_t FakeRtosStats;
+
+static const FakeRtosLoad_t *Load;
+
+static uint64_t Now;
+static TickType_t Tick;
+static bool InIsr;
+static bool InTimerTask;
+static uint64_t SuspendedUntil;
+
+/*! Alarm of the precise hardware timer */
+static uint64_t AlarmTime = FAKE_RTOS_TIME_NEVER;
+
+static FakeTimer_t Timers[FAKE_RTOS_NB_TIMERS];
+static uint8_t NbTimers;
+
+static Message_t Queue[configTIMER_QUEUE_LENGTH];
+static uint8_t QueueBegin;
+static uint8_t QueueCount;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Random delay of the load model */
+static uint32_t Random( uint32_t percent, uint32_t max );
+
+/*! \brief Sends a command to the timer task */
+static BaseType_t Send( Command_t command, FakeTimer_t *timer, TickType_t value );
+
+/*! \brief Runs an interrupt handler after the interrupt latency */
+static void Interrupt( void (*handler)( void ) );
+
+/*! \brief Tick interrupt handler */
+static void TickHandler( void );
+
+/*! \brief Returns the first expired timer, NULL if none */
+static FakeTimer_t* NextExpired( void );
+
+/*! \brief Runs the timer task until it has no more work */
+static void RunTimerTask( void );
+
+/*******************************************************************************
+ * STUBS OF THE KERNEL AND THE PRECISE HARDWARE TIMER
+ ******************************************************************************/
+uint32_t __get_IPSR( void )
+{
+    return (InIsr == true) ? 1 : 0;
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+    return Tick;
+}
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+    return Tick;
+}
+
+TimerHandle_t xTimerCreate( const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+        const UBaseType_t uxAutoReload, void * const pvTimerID,
+        TimerCallbackFunction_t pxCallbackFunction )
+{
+    FakeTimer_t *timer;
+
+    if ( NbTimers == FAKE_RTOS_NB_TIMERS ) {
+        return NULL;
+    }
+    timer = &Timers[NbTimers++];
+    timer->Name = pcTimerName;
+    timer->Period = xTimerPeriodInTicks;
+    timer->Expiry = 0;
+    timer->AutoReload = (uxAutoReload != 0);
+    timer->IsActive = false;
+    timer->Id = pvTimerID;
+    timer->Callback = pxCallbackFunction;
+    return timer;
+}
+
+void *pvTimerGetTimerID( TimerHandle_t xTimer )
+{
+    return ((FakeTimer_t*) xTimer)->Id;
+}
+
+const char *pcTimerGetTimerName( TimerHandle_t xTimer )
+{
+    return ((FakeTimer_t*) xTimer)->Name;
+}
+
+BaseType_t xTimerStart( TimerHandle_t xTimer, TickType_t xTicksToWait )
+{
+    return Send(CMD_START, xTimer, Tick);
+}
+
+BaseType_t xTimerStop( TimerHandle_t xTimer, TickType_t xTicksToWait )
+{
+    return Send(CMD_STOP, xTimer, 0);
+}
+
+BaseType_t xTimerReset( TimerHandle_t xTimer, TickType_t xTicksToWait )
+{
+    return Send(CMD_START, xTimer, Tick);
+}
+
+BaseType_t xTimerChangePeriod( TimerHandle_t xTimer, TickType_t xNewPeriod,
+        TickType_t xTicksToWait )
+{
+    return Send(CMD_CHANGE_PERIOD, xTimer, xNewPeriod);
+}
+
+BaseType_t xTimerStartFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    return (*pxHigherPriorityTaskWoken = Send(CMD_START, xTimer, Tick));
+}
+
+BaseType_t xTimerStopFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    return (*pxHigherPriorityTaskWoken = Send(CMD_STOP, xTimer, 0));
+}
+
+BaseType_t xTimerResetFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    return (*pxHigherPriorityTaskWoken = Send(CMD_START, xTimer, Tick));
+}
+
+BaseType_t xTimerChangePeriodFromISR( TimerHandle_t xTimer, TickType_t xNewPeriod,
+        BaseType_t *pxHigherPriorityTaskWoken )
+{
+    return (*pxHigherPriorityTaskWoken = Send(CMD_CHANGE_PERIOD, xTimer, xNewPeriod));
+}
+
+BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend, void *pvParameter1,
+        uint32_t ulParameter2, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    Message_t *msg;
+
+    if ( QueueCount == configTIMER_QUEUE_LENGTH ) {
+        FakeRtosStats.QueueFull++;
+        return pdFAIL;
+    }
+    msg = &Queue[(QueueBegin + QueueCount++) % configTIMER_QUEUE_LENGTH];
+    msg->Command = CMD_PEND;
+    msg->Function = xFunctionToPend;
+    msg->Parameter1 = pvParameter1;
+    msg->Parameter2 = ulParameter2;
+    FakeRtosStats.PendedCalls++;
+    FakeRtosStats.LastPendTime = Now;
+    *pxHigherPriorityTaskWoken = pdTRUE;
+    return pdPASS;
+}
+
+uint32_t TimerHwGetMinimumTimeout( void )
+{
+    return HWTIMER_MIN_TIMEOUT;
+}
+
+void TimerHwStart( uint32_t timeout )
+{
+    AlarmTime = Now + timeout;
+}
+
+void TimerHwStop( void )
+{
+    AlarmTime = FAKE_RTOS_TIME_NEVER;
+}
+
+TimerTime_t TimerHwGetTime( void )
+{
+    return Now;
+}
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void FakeRtosReset( const FakeRtosLoad_t *load, uint64_t now )
+{
+    Load = load;
+    Now = now;
+    Tick = (TickType_t) (now / FAKE_RTOS_TICK_PERIOD);
+    InIsr = false;
+    InTimerTask = false;
+    SuspendedUntil = 0;
+    AlarmTime = FAKE_RTOS_TIME_NEVER;
+    NbTimers = 0;
+    QueueBegin = 0;
+    QueueCount = 0;
+    memset(&FakeRtosStats, 0, sizeof(FakeRtosStats));
+}
+
+uint64_t FakeRtosGetTime( void )
+{
+    return Now;
+}
+
+void FakeRtosRunUntil( uint64_t time )
+{
+    uint64_t tick, next;
+
+    for ( ;; ) {
+        tick = (uint64_t) (Tick + 1) * FAKE_RTOS_TICK_PERIOD;
+        next = (AlarmTime <= tick) ? AlarmTime : tick;
+        if ( (SuspendedUntil > Now) && (SuspendedUntil < next) ) {
+            next = SuspendedUntil;
+        }
+        if ( next > time ) {
+            break;
+        }
+        if ( Now < next ) {
+            Now = next;
+        }
+
+        if ( next == AlarmTime ) {
+            AlarmTime = FAKE_RTOS_TIME_NEVER;
+            FakeRtosStats.Interrupts++;
+            Interrupt(TimerIrqHandler);
+        } else if ( next == tick ) {
+            Interrupt(TickHandler);
+        } else {
+            // End of the suspension
+            RunTimerTask();
+        }
+    }
+    if ( Now < time ) {
+        Now = time;
+    }
+}
+
+void FakeRtosSuspendTimerTask( uint64_t until )
+{
+    SuspendedUntil = until;
+}
+
+void FakeRtosSetIsr( bool isr )
+{
+    InIsr = isr;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint32_t Random( uint32_t percent, uint32_t max )
+{
+    if ( (max == 0) || ((uint32_t) (rand() % 100) >= percent) ) {
+        return 0;
+    }
+    return (uint32_t) rand() % (max + 1);
+}
+
+static BaseType_t Send( Command_t command, FakeTimer_t *timer, TickType_t value )
+{
+    Message_t *msg;
+
+    if ( QueueCount == configTIMER_QUEUE_LENGTH ) {
+        FakeRtosStats.QueueFull++;
+        return pdFAIL;
+    }
+    msg = &Queue[(QueueBegin + QueueCount++) % configTIMER_QUEUE_LENGTH];
+    msg->Command = command;
+    msg->Timer = timer;
+    msg->Value = value;
+
+    // The timer task preempts the sending task, the interrupts which became
+    // pending meanwhile run before the sending task resumes
+    if ( (InIsr == false) && (InTimerTask == false) ) {
+        RunTimerTask();
+        FakeRtosRunUntil(Now);
+    }
+    return pdPASS;
+}
+
+static void Interrupt( void (*handler)( void ) )
+{
+    Now += Load->IsrLatency + Random(Load->IsrMaskedPercent, Load->IsrMaskedMax);
+    InIsr = true;
+    handler();
+    InIsr = false;
+    RunTimerTask();
+}
+
+static void TickHandler( void )
+{
+    Tick++;
+}
+
+static FakeTimer_t* NextExpired( void )
+{
+    FakeTimer_t *first = NULL;
+    uint8_t i;
+
+    for ( i = 0; i < NbTimers; i++ ) {
+        if ( (Timers[i].IsActive == true) && (Timers[i].Expiry <= Tick)
+                && ((first == NULL) || (Timers[i].Expiry < first->Expiry)) ) {
+            first = &Timers[i];
+        }
+    }
+    return first;
+}
+
+static void RunTimerTask( void )
+{
+    FakeTimer_t *timer;
+    Message_t msg;
+
+    if ( (InTimerTask == true) || (Now < SuspendedUntil)
+            || ((QueueCount == 0) && (NextExpired() == NULL)) ) {
+        return;
+    }
+    InTimerTask = true;
+    Now += Load->TaskSwitch + Random(Load->TaskBusyPercent, Load->TaskBusyMax);
+
+    for ( ;; ) {
+        timer = NextExpired();
+        if ( timer != NULL ) {
+            Now += Load->TaskCommand;
+            if ( timer->AutoReload == true ) {
+                timer->Expiry += timer->Period;
+            } else {
+                timer->IsActive = false;
+            }
+            timer->Callback(timer);
+            continue;
+        }
+        if ( QueueCount == 0 ) {
+            break;
+        }
+
+        Now += Load->TaskCommand;
+        msg = Queue[QueueBegin];
+        QueueBegin = (QueueBegin + 1) % configTIMER_QUEUE_LENGTH;
+        QueueCount--;
+        switch ( msg.Command ) {
+            case CMD_START:
+                msg.Timer->Expiry = msg.Value + msg.Timer->Period;
+                msg.Timer->IsActive = true;
+                break;
+            case CMD_STOP:
+                msg.Timer->IsActive = false;
+                break;
+            case CMD_CHANGE_PERIOD:
+                msg.Timer->Period = msg.Value;
+                msg.Timer->Expiry = Tick + msg.Value;
+                msg.Timer->IsActive = true;
+                break;
+            default:
+                msg.Function(msg.Parameter1, msg.Parameter2);
+                break;
+        }
+    }
+    InTimerTask = false;
+}
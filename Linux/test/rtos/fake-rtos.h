@@ -0,0 +1,92 @@
+/**
+ * \file fake-rtos.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Simulated FreeRTOS kernel of the host timer tests
+ *
+ * The simulated time advances in us. The tick interrupt runs every ms, the
+ * PIT alarm of timer-board.h calls TimerIrqHandler. The timer task has the
+ * highest priority (tinyK20 FreeRTOSConfig.h): it runs after each interrupt
+ * which gave it work and right after a command sent from task context. It
+ * processes the commands of the queue, the expired timers at tick boundaries
+ * and the pended function calls.
+ *
+ * What the target spends in between is a load model, see FakeRtosLoad_t. The
+ * default one of the tests is an estimate for the tinyK20 at 72 MHz with the
+ * radio and the shell running, not a measurement on the target.
+ */
+#ifndef __FAKE_RTOS_H__
+#define __FAKE_RTOS_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Load model of the target, random parts are uniform */
+typedef struct FakeRtosLoad_s {
+    uint32_t IsrLatency;        //! Interrupt entry [us]
+    uint32_t IsrMaskedPercent;  //! Probability of a masked section at an interrupt [%]
+    uint32_t IsrMaskedMax;      //! Longest masked section [us]
+    uint32_t TaskSwitch;        //! Switch to the timer task [us]
+    uint32_t TaskCommand;       //! Timer task per command or expired timer [us]
+    uint32_t TaskBusyPercent;   //! Probability of a critical section of a lower priority task [%]
+    uint32_t TaskBusyMax;       //! Longest such critical section [us]
+} FakeRtosLoad_t;
+
+/*! Kernel statistics */
+typedef struct FakeRtosStats_s {
+    uint32_t Interrupts;        //! Alarm interrupts
+    uint32_t PendedCalls;       //! Accepted xTimerPendFunctionCallFromISR calls
+    uint32_t QueueFull;         //! Commands rejected by the full queue
+    uint64_t LastPendTime;      //! Time of the last accepted pended call [us]
+} FakeRtosStats_t;
+
+/*******************************************************************************
+ * VARIABLES (PUBLIC)
+ ******************************************************************************/
+/*! Kernel statistics since the last reset */
+extern FakeRtosStats_t FakeRtosStats;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Deletes the timers, empties the queue and sets the time.
+ *
+ * \param load Load model, kept by reference.
+ * \param now Simulated time [us].
+ */
+void FakeRtosReset( const FakeRtosLoad_t *load, uint64_t now );
+
+/*!
+ * \brief Returns the simulated time.
+ *
+ * \retval uint64_t Time [us].
+ */
+uint64_t FakeRtosGetTime( void );
+
+/*!
+ * \brief Runs the interrupts and the timer task up to a time.
+ *
+ * \param time End of the run [us].
+ */
+void FakeRtosRunUntil( uint64_t time );
+
+/*!
+ * \brief Holds the timer task off, the commands stay in the queue.
+ *
+ * \param until End of the hold [us].
+ */
+void FakeRtosSuspendTimerTask( uint64_t until );
+
+/*!
+ * \brief Enters or leaves the simulated interrupt context of the caller.
+ */
+void FakeRtosSetIsr( bool isr );
+
+#endif /* __FAKE_RTOS_H__ */
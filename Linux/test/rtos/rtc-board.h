@@ -0,0 +1,10 @@
+/**
+ * \file rtc-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief RTC of the host FreeRTOS timer tests, not used by the RTOS timers
+ */
+#ifndef __RTC_BOARD_H__
+#define __RTC_BOARD_H__
+
+#endif /* __RTC_BOARD_H__ */
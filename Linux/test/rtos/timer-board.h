@@ -0,0 +1,44 @@
+/**
+ * \file timer-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Precise hardware timer of the host FreeRTOS timer tests
+ *
+ * The PIT time base and alarm of the tinyK20, simulated by fake-rtos.c.
+ */
+#ifndef __TIMER_BOARD_H__
+#define __TIMER_BOARD_H__
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Precise timers are driven by the hardware timer */
+#define TIMER_HW_PRECISE                            1
+
+/*! Minimum timeout of the alarm [us], the one of the tinyK20 */
+#define HWTIMER_MIN_TIMEOUT                         5
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Returns the minimum timeout of the alarm in us
+ */
+uint32_t TimerHwGetMinimumTimeout( void );
+
+/*!
+ * \brief Arms the alarm, TimerIrqHandler is called after timeout us
+ */
+void TimerHwStart( uint32_t timeout );
+
+/*!
+ * \brief Disarms the alarm
+ */
+void TimerHwStop( void );
+
+/*!
+ * \brief Returns the time of the time base in us
+ */
+TimerTime_t TimerHwGetTime( void );
+
+#endif /* __TIMER_BOARD_H__ */
@@ -0,0 +1,56 @@
+/**
+ * \file timers.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief FreeRTOS software timers of the host timer tests
+ *
+ * The timer API src/system/timer.c uses, implemented by the timer task of
+ * fake-rtos.c. The commands go through a queue of configTIMER_QUEUE_LENGTH
+ * entries like on the target.
+ */
+#ifndef __TIMERS_HOST_H__
+#define __TIMERS_HOST_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Timer command queue length of the tinyK20 FreeRTOSConfig.h */
+#define configTIMER_QUEUE_LENGTH                    8
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+typedef void * TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)( TimerHandle_t xTimer );
+typedef void (*PendedFunction_t)( void *, uint32_t );
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+TimerHandle_t xTimerCreate( const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+        const UBaseType_t uxAutoReload, void * const pvTimerID,
+        TimerCallbackFunction_t pxCallbackFunction );
+void *pvTimerGetTimerID( TimerHandle_t xTimer );
+const char *pcTimerGetTimerName( TimerHandle_t xTimer );
+
+BaseType_t xTimerStart( TimerHandle_t xTimer, TickType_t xTicksToWait );
+BaseType_t xTimerStop( TimerHandle_t xTimer, TickType_t xTicksToWait );
+BaseType_t xTimerReset( TimerHandle_t xTimer, TickType_t xTicksToWait );
+BaseType_t xTimerChangePeriod( TimerHandle_t xTimer, TickType_t xNewPeriod,
+        TickType_t xTicksToWait );
+
+BaseType_t xTimerStartFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xTimerStopFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xTimerResetFromISR( TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xTimerChangePeriodFromISR( TimerHandle_t xTimer, TickType_t xNewPeriod,
+        BaseType_t *pxHigherPriorityTaskWoken );
+
+BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend, void *pvParameter1,
+        uint32_t ulParameter2, BaseType_t *pxHigherPriorityTaskWoken );
+
+#endif /* __TIMERS_HOST_H__ */
@@ -0,0 +1,248 @@
+/**
+ * \file test-codec.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the sensor payload codec
+ *
+ * Encodes random walks of several stream configurations and decodes them
+ * again: every decoded sample has to equal the encoded one truncated to the
+ * field widths. Frames and acknowledgements are lost at random, a delta whose
+ * reference the decoder does not keep anymore must be refused, never decoded
+ * wrong. The keyframe interval is limited to 127 samples by the 7 bit
+ * sequence number.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "board.h"
+#include "codec.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_SAMPLES                                  20000
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static const CodecField_t PosFields[] = {
+    { 24, CODEC_FIELD_SIGNED },
+    { 24, CODEC_FIELD_SIGNED },
+    { 16, 0 },
+};
+
+static const CodecField_t MixedFields[] = {
+    { 32, CODEC_FIELD_SIGNED },
+    { 1, 0 },
+    { 7, CODEC_FIELD_SIGNED },
+    { 12, CODEC_FIELD_DICT },
+    { 16, CODEC_FIELD_SIGNED | CODEC_FIELD_DICT },
+    { 32, 0 },
+    { 3, 0 },
+    { 8, 0 },
+    { 20, CODEC_FIELD_SIGNED },
+};
+
+static const int32_t Dict[] = { 0, 100, 250, 1000, -5 };
+
+static const CodecConfig_t Configs[] = {
+    { PosFields, 3, NULL, 0, 16, false },
+    { PosFields, 3, NULL, 0, 200, true },
+    { MixedFields, 9, Dict, 5, 32, false },
+    { MixedFields, 9, Dict, 5, 0, true },
+};
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! Value as the decoder returns it */
+static int32_t Truncate( const CodecField_t *field, int32_t value )
+{
+    uint32_t v = (uint32_t) value;
+
+    if ( field->Bits >= 32 ) {
+        return value;
+    }
+    v &= (1UL << field->Bits) - 1;
+    if ( (field->Flags & CODEC_FIELD_SIGNED) != 0 && (v & (1UL << (field->Bits - 1))) != 0 ) {
+        v |= ~((1UL << field->Bits) - 1);
+    }
+    return (int32_t) v;
+}
+
+/*! Next sample of a random walk, now and then a jump or a dictionary value */
+static void NextSample( const CodecConfig_t *config, int32_t *values )
+{
+    uint8_t i;
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        switch ( rand() % 8 ) {
+            case 0:
+                values[i] = (int32_t) (((uint32_t) rand() << 16) ^ (uint32_t) rand());
+                break;
+            case 1:
+                if ( config->DictSize > 0 ) {
+                    values[i] = config->Dict[rand() % config->DictSize];
+                }
+                break;
+            case 2:
+            case 3:
+                break;
+            default:
+                values[i] += (rand() % 64) - 32;
+                break;
+        }
+        values[i] = Truncate(&config->Fields[i], values[i]);
+    }
+}
+
+static void TestStream( const CodecConfig_t *config, uint8_t lossPercent )
+{
+    CodecEncoder_t enc;
+    CodecDecoder_t dec;
+    int32_t values[CODEC_MAX_FIELDS] = { 0 }, decoded[CODEC_MAX_FIELDS];
+    uint8_t buf[CODEC_MAX_SIZE(CODEC_MAX_FIELDS)], size, result;
+    uint32_t decodedOk = 0, refused = 0, sinceKeyframe = 0, maxSinceKeyframe = 0;
+    uint8_t history[CODEC_HISTORY_SIZE], next = 0, i;
+    bool known;
+    uint16_t n;
+
+    memset(history, 0xFF, sizeof(history));
+
+    CodecEncoderInit(&enc, config);
+    CodecDecoderInit(&dec, config);
+
+    for ( n = 0; n < NB_SAMPLES; n++ ) {
+        NextSample(config, values);
+        size = CodecEncode(&enc, values, buf, sizeof(buf));
+        CHECK(size > 0 && size <= CODEC_MAX_SIZE(config->NbFields));
+
+        sinceKeyframe = ((buf[0] & 0x80) != 0) ? 0 : sinceKeyframe + 1;
+        maxSinceKeyframe = (sinceKeyframe > maxSinceKeyframe) ? sinceKeyframe : maxSinceKeyframe;
+
+        if ( (uint8_t) (rand() % 100) < lossPercent ) {
+            continue;
+        }
+        result = CodecDecode(&dec, buf, size, decoded);
+        CHECK(result == ERR_OK || result == ERR_NOTAVAIL);
+        if ( result == ERR_OK ) {
+            CHECK(memcmp(decoded, values, config->NbFields * sizeof(int32_t)) == 0);
+            decodedOk++;
+            history[next] = buf[0] & 0x7F;
+            next = (next + 1) % CODEC_HISTORY_SIZE;
+            /* The acknowledgement travels back and may be lost as well */
+            if ( (uint8_t) (rand() % 100) >= lossPercent ) {
+                CodecAck(&enc, buf[0] & 0x7F);
+            }
+        } else {
+            /* Only a delta to a reference the decoder does not keep is refused */
+            known = false;
+            for ( i = 0; i < CODEC_HISTORY_SIZE; i++ ) {
+                known |= (history[i] == buf[1]);
+            }
+            CHECK(!known && (buf[0] & 0x80) == 0);
+            refused++;
+        }
+    }
+    CHECK(decodedOk > 0);
+    CHECK(maxSinceKeyframe < 127);
+    if ( config->KeyframeInterval == 0 ) {
+        CHECK(enc.Stats.Keyframes == NB_SAMPLES);
+    }
+    CHECK(enc.Stats.Samples == NB_SAMPLES);
+    printf("%u fields, interval %3u, ack %u, loss %2u%%: %5u decoded, %4u refused, "
+            "%3.0f%% of raw size\n", config->NbFields, config->KeyframeInterval,
+            config->AckRequired, lossPercent, decodedOk, refused,
+            100.0 * enc.Stats.Bytes / enc.Stats.RawBytes);
+}
+
+/*! Slowly changing samples, the deltas stay small and only the interval and
+ *  the reference age force keyframes */
+static void TestSequenceWrap( const CodecConfig_t *config, bool ackFirstOnly )
+{
+    CodecEncoder_t enc;
+    CodecDecoder_t dec;
+    int32_t values[CODEC_MAX_FIELDS] = { 0 }, decoded[CODEC_MAX_FIELDS];
+    uint8_t buf[CODEC_MAX_SIZE(CODEC_MAX_FIELDS)], size, result;
+    uint32_t sinceKeyframe = 0, maxSinceKeyframe = 0;
+    uint16_t n;
+
+    CodecEncoderInit(&enc, config);
+    CodecDecoderInit(&dec, config);
+
+    for ( n = 0; n < 1000; n++ ) {
+        values[0] = n & 0x3F;
+        size = CodecEncode(&enc, values, buf, sizeof(buf));
+        sinceKeyframe = ((buf[0] & 0x80) != 0) ? 0 : sinceKeyframe + 1;
+        maxSinceKeyframe = (sinceKeyframe > maxSinceKeyframe) ? sinceKeyframe : maxSinceKeyframe;
+
+        /* A reference older than the decoder history is refused, never aliased */
+        result = CodecDecode(&dec, buf, size, decoded);
+        CHECK((result == ERR_OK && decoded[0] == values[0])
+                || (result == ERR_NOTAVAIL && ackFirstOnly));
+        if ( !ackFirstOnly || n == 0 ) {
+            CodecAck(&enc, buf[0] & 0x7F);
+        }
+    }
+    CHECK(maxSinceKeyframe < 127);
+}
+
+static void TestMalformed( void )
+{
+    CodecEncoder_t enc;
+    CodecDecoder_t dec;
+    int32_t values[CODEC_MAX_FIELDS] = { 1, 2, 3 }, decoded[CODEC_MAX_FIELDS];
+    uint8_t buf[CODEC_MAX_SIZE(CODEC_MAX_FIELDS)], size, cut;
+
+    CodecEncoderInit(&enc, &Configs[0]);
+    CodecDecoderInit(&dec, &Configs[0]);
+
+    /* Truncated keyframes and deltas are refused */
+    size = CodecEncode(&enc, values, buf, sizeof(buf));
+    for ( cut = 0; cut < size; cut++ ) {
+        CHECK(CodecDecode(&dec, buf, cut, decoded) == ERR_FAILED);
+    }
+    CHECK(CodecDecode(&dec, buf, size, decoded) == ERR_OK);
+    values[0] += 1000;
+    size = CodecEncode(&enc, values, buf, sizeof(buf));
+    CHECK((buf[0] & 0x80) == 0);
+    for ( cut = 0; cut < size; cut++ ) {
+        CHECK(CodecDecode(&dec, buf, cut, decoded) != ERR_OK);
+    }
+    CHECK(CodecDecode(&dec, buf, size, decoded) == ERR_OK);
+
+    /* Too small a buffer */
+    CHECK(CodecEncode(&enc, values, buf, 2) == 0);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint8_t losses[] = { 0, 5, 30 };
+    uint8_t c, l;
+
+    srand(24);
+    for ( c = 0; c < sizeof(Configs) / sizeof(Configs[0]); c++ ) {
+        for ( l = 0; l < sizeof(losses); l++ ) {
+            TestStream(&Configs[c], losses[l]);
+        }
+    }
+    /* Interval beyond the sequence numbers, reference older than them */
+    TestSequenceWrap(&Configs[1], false);
+    TestSequenceWrap(&Configs[1], true);
+    TestMalformed();
+
+    printf("test-codec: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/**
+ * \file test-crypto.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the AES backends and of the LoRaMAC crypto functions
+ *
+ * Built once per AES_BACKEND. Checks the FIPS-197 and RFC 4493 vectors, a
+ * LoRaWAN MIC and FRMPayload vector computed with OpenSSL, and compares the
+ * MIC and the payload encryption of LoRaMacCrypto with the reference CMAC
+ * (cmac.c) and a plain CTR over random frames. Feeds the streaming functions in
+ * uneven chunks through interleaved contexts, including the single pass MIC
+ * and decryption, and compares them with the one-shot functions.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "aes.h"
+#include "cmac.h"
+#include "LoRaMacCrypto.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RANDOM_FRAMES                            20000
+#define NB_CHUNKED_FRAMES                           5000
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static const uint8_t Key[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7,
+        0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+/*! RFC 4493 example messages */
+static const uint8_t CmacMsg[64] = { 0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d,
+        0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e,
+        0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+        0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b,
+        0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 };
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint32_t ReferenceMic( const uint8_t *buffer, uint16_t size, const uint8_t *key,
+        uint32_t address, uint8_t dir, uint32_t sequenceCounter )
+{
+    AES_CMAC_CTX ctx;
+    uint8_t b0[16] = { 0x49 };
+    uint8_t digest[16];
+
+    b0[5] = dir;
+    b0[6] = address & 0xFF;
+    b0[7] = (address >> 8) & 0xFF;
+    b0[8] = (address >> 16) & 0xFF;
+    b0[9] = (address >> 24) & 0xFF;
+    b0[10] = sequenceCounter & 0xFF;
+    b0[11] = (sequenceCounter >> 8) & 0xFF;
+    b0[12] = (sequenceCounter >> 16) & 0xFF;
+    b0[13] = (sequenceCounter >> 24) & 0xFF;
+    b0[15] = size & 0xFF;
+
+    AES_CMAC_Init(&ctx);
+    AES_CMAC_SetKey(&ctx, key);
+    AES_CMAC_Update(&ctx, b0, 16);
+    AES_CMAC_Update(&ctx, buffer, size);
+    AES_CMAC_Final(digest, &ctx);
+
+    return (uint32_t) digest[3] << 24 | (uint32_t) digest[2] << 16 | (uint32_t) digest[1] << 8
+            | digest[0];
+}
+
+static void ReferenceCtr( const uint8_t *buffer, uint16_t size, const uint8_t *key,
+        uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint8_t *out )
+{
+    aes_context aes;
+    uint8_t a[16] = { 0x01 }, s[16];
+    uint16_t i;
+
+    aes_set_key(key, 16, &aes);
+    a[5] = dir;
+    a[6] = address & 0xFF;
+    a[7] = (address >> 8) & 0xFF;
+    a[8] = (address >> 16) & 0xFF;
+    a[9] = (address >> 24) & 0xFF;
+    a[10] = sequenceCounter & 0xFF;
+    a[11] = (sequenceCounter >> 8) & 0xFF;
+    a[12] = (sequenceCounter >> 16) & 0xFF;
+    a[13] = (sequenceCounter >> 24) & 0xFF;
+
+    for ( i = 0; i < size; i++ ) {
+        if ( (i & 0x0F) == 0 ) {
+            a[15] = (uint8_t) ((i >> 4) + 1);
+            aes_encrypt(a, s, &aes);
+        }
+        out[i] = buffer[i] ^ s[i & 0x0F];
+    }
+}
+
+static void TestAesVectors( void )
+{
+    static const uint8_t key[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+            0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    static const uint8_t pt[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99,
+            0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    static const uint8_t ct[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd,
+            0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+    aes_context aes;
+    uint8_t out[16];
+
+    /* FIPS-197 appendix C.1 */
+    memset(&aes, 0, sizeof(aes));
+    CHECK(aes_set_key(key, 16, &aes) == 0);
+    aes_encrypt(pt, out, &aes);
+    CHECK(memcmp(out, ct, 16) == 0);
+    aes_decrypt(ct, out, &aes);
+    CHECK(memcmp(out, pt, 16) == 0);
+}
+
+static void TestCmacVectors( void )
+{
+    uint32_t mic;
+
+    /* RFC 4493 examples 1 to 4, the join MIC is a plain CMAC */
+    LoRaMacJoinComputeMic(CmacMsg, 0, Key, &mic);
+    CHECK(mic == 0x29691dbb);
+    LoRaMacJoinComputeMic(CmacMsg, 16, Key, &mic);
+    CHECK(mic == 0xb4160a07);
+    LoRaMacJoinComputeMic(CmacMsg, 40, Key, &mic);
+    CHECK(mic == 0x4767a6df);
+    LoRaMacJoinComputeMic(CmacMsg, 64, Key, &mic);
+    CHECK(mic == 0xbfbef051);
+}
+
+static void TestFrameVectors( void )
+{
+    /* Unconfirmed uplink of 0x01020304, FCnt 5, FPort 2, "Hello" */
+    static const uint8_t frame[14] = { 0x40, 0x04, 0x03, 0x02, 0x01, 0x00, 0x05, 0x00, 0x02, 0x48,
+            0x65, 0x6c, 0x6c, 0x6f };
+    static const uint8_t encrypted[20] = { 0x2B, 0x1C, 0xBE, 0x6C, 0xA7, 0x4B, 0x98, 0x11, 0xE9,
+            0x64, 0x5B, 0x4C, 0xB2, 0x4D, 0x92, 0xBD, 0x6F, 0xFB, 0xAD, 0x1C };
+    uint8_t plain[20], out[20];
+    uint32_t mic;
+    uint8_t i;
+
+    LoRaMacCryptoFlushKeyCache();
+
+    /* openssl mac -cipher AES-128-CBC CMAC over B0 | frame */
+    LoRaMacComputeMic(frame, sizeof(frame), Key, 0x01020304, 0, 5, &mic);
+    CHECK(mic == 0x43F11530);
+
+    /* openssl enc -aes-128-ecb of A1 and A2 */
+    for ( i = 0; i < sizeof(plain); i++ ) {
+        plain[i] = i;
+    }
+    LoRaMacPayloadEncrypt(plain, sizeof(plain), Key, 0x01020304, 0, 5, out);
+    CHECK(memcmp(out, encrypted, sizeof(out)) == 0);
+    LoRaMacPayloadDecrypt(encrypted, sizeof(encrypted), Key, 0x01020304, 0, 5, out);
+    CHECK(memcmp(out, plain, sizeof(out)) == 0);
+}
+
+static void TestRandomFrames( void )
+{
+    uint8_t keys[6][16], frame[255], out[255], ref[255];
+    uint32_t address, counter, mic;
+    uint16_t size;
+    uint8_t dir, k;
+    unsigned n, i, mismatches = 0;
+
+    srand(1);
+    for ( k = 0; k < 6; k++ ) {
+        for ( i = 0; i < 16; i++ ) {
+            keys[k][i] = (uint8_t) rand();
+        }
+    }
+
+    /* More keys than cache entries, hits and misses are both exercised */
+    for ( n = 0; n < NB_RANDOM_FRAMES; n++ ) {
+        k = (uint8_t) (rand() % 6);
+        size = (uint16_t) (rand() % 256);
+        address = (k == 5) ? (uint32_t) rand() : 0x01000000 + k;
+        counter = (uint32_t) rand();
+        dir = (uint8_t) (rand() & 1);
+        for ( i = 0; i < size; i++ ) {
+            frame[i] = (uint8_t) rand();
+        }
+
+        LoRaMacComputeMic(frame, size, keys[k], address, dir, counter, &mic);
+        if ( mic != ReferenceMic(frame, size, keys[k], address, dir, counter) ) {
+            mismatches++;
+        }
+
+        LoRaMacPayloadEncrypt(frame, size, keys[k], address, dir, counter, out);
+        ReferenceCtr(frame, size, keys[k], address, dir, counter, ref);
+        if ( memcmp(out, ref, size) != 0 ) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+/*! Size of the next chunk, crosses the 16 byte block boundaries unevenly */
+static uint16_t ChunkSize( uint16_t left )
+{
+    static const uint8_t sizes[] = { 0, 1, 3, 15, 16, 17, 31, 33 };
+    uint16_t size = sizes[rand() % sizeof(sizes)];
+
+    return (size > left) ? left : size;
+}
+
+static void TestChunkedUpdates( void )
+{
+    uint8_t keys[2][16], frame[255], out[255], ref[255];
+    LoRaMacCryptoCtx_t micCtx, ctrCtx;
+    uint32_t address, counter, mic, refMic;
+    uint16_t size, micDone, ctrDone, chunk;
+    uint8_t dir;
+    unsigned n, i, mismatches = 0;
+
+    srand(2);
+    for ( i = 0; i < 16; i++ ) {
+        keys[0][i] = (uint8_t) rand();
+        keys[1][i] = (uint8_t) rand();
+    }
+
+    for ( n = 0; n < NB_CHUNKED_FRAMES; n++ ) {
+        size = (uint16_t) (rand() % 256);
+        address = (uint32_t) rand();
+        counter = (uint32_t) rand();
+        dir = (uint8_t) (rand() & 1);
+        for ( i = 0; i < size; i++ ) {
+            frame[i] = (uint8_t) rand();
+        }
+
+        /* MIC and decryption of the same frame with different keys, interleaved */
+        if ( (n & 3) == 0 ) {
+            LoRaMacCryptoJoinMicInit(&micCtx, keys[0]);
+        } else {
+            LoRaMacCryptoMicInit(&micCtx, keys[0], address, dir, counter, size);
+        }
+        LoRaMacCryptoCtrInit(&ctrCtx, keys[1], address, dir, counter);
+        micDone = 0;
+        ctrDone = 0;
+        while ( micDone < size || ctrDone < size ) {
+            chunk = ChunkSize(size - micDone);
+            LoRaMacCryptoMicUpdate(&micCtx, &frame[micDone], chunk);
+            micDone += chunk;
+            chunk = ChunkSize(size - ctrDone);
+            LoRaMacCryptoCtrUpdate(&ctrCtx, &frame[ctrDone], chunk, &out[ctrDone]);
+            ctrDone += chunk;
+        }
+        LoRaMacCryptoMicFinal(&micCtx, &mic);
+        LoRaMacCryptoCtxClear(&ctrCtx);
+
+        if ( (n & 3) == 0 ) {
+            LoRaMacJoinComputeMic(frame, size, keys[0], &refMic);
+        } else {
+            LoRaMacComputeMic(frame, size, keys[0], address, dir, counter, &refMic);
+        }
+        LoRaMacPayloadEncrypt(frame, size, keys[1], address, dir, counter, ref);
+        if ( mic != refMic || memcmp(out, ref, size) != 0 ) {
+            mismatches++;
+        }
+
+        /* Single pass MIC and decryption in place, as the receive path does */
+        memcpy(out, frame, size);
+        if ( (n & 3) == 0 ) {
+            LoRaMacCryptoJoinMicInit(&micCtx, keys[0]);
+        } else {
+            LoRaMacCryptoMicInit(&micCtx, keys[0], address, dir, counter, size);
+        }
+        LoRaMacCryptoCtrInit(&ctrCtx, keys[1], address, dir, counter);
+        for ( ctrDone = 0; ctrDone < size; ctrDone += chunk ) {
+            chunk = ChunkSize(size - ctrDone);
+            LoRaMacCryptoMicDecryptUpdate(&micCtx, &ctrCtx, &out[ctrDone], chunk);
+        }
+        LoRaMacCryptoMicFinal(&micCtx, &mic);
+        LoRaMacCryptoCtxClear(&ctrCtx);
+        if ( mic != refMic || memcmp(out, ref, size) != 0 ) {
+            mismatches++;
+        }
+
+        /* In place, as the stack decrypts inside the PHY buffer */
+        LoRaMacCryptoCtrInit(&ctrCtx, keys[1], address, dir, counter);
+        for ( ctrDone = 0; ctrDone < size; ctrDone += chunk ) {
+            chunk = ChunkSize(size - ctrDone);
+            LoRaMacCryptoCtrUpdate(&ctrCtx, &out[ctrDone], chunk, &out[ctrDone]);
+        }
+        LoRaMacCryptoCtxClear(&ctrCtx);
+        if ( memcmp(out, frame, size) != 0 ) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    TestAesVectors();
+    TestCmacVectors();
+    TestFrameVectors();
+    TestRandomFrames();
+    TestChunkedUpdates();
+
+    printf("test-crypto (AES_BACKEND %d): %s\n", AES_BACKEND, (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * \file test-fifo.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the single producer / single consumer FIFO
+ *
+ * Single and bulk pushes and pops of random sizes are checked against a
+ * reference sequence for several FIFO sizes, the free running indices are
+ * started close to their 16 bit wrap around. Overflowing pushes have to be
+ * dropped and counted. Finally a producer and a consumer thread run the bulk
+ * functions concurrently, the consumer has to see the byte sequence of the
+ * producer unchanged.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "board.h"
+#include "fifo.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_OPERATIONS                               100000
+#define NB_THREAD_BYTES                             (1024 * 1024)
+#define THREAD_FIFO_SIZE                            64
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static Fifo_t ThreadFifo;
+static uint8_t ThreadBuffer[THREAD_FIFO_SIZE];
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! Byte n of the reference sequence */
+static uint8_t Sequence( uint32_t n )
+{
+    return (uint8_t) (n * 7 + (n >> 8));
+}
+
+static void TestInit( void )
+{
+    Fifo_t fifo;
+    uint8_t buffer[100];
+
+    FifoInit(&fifo, buffer, sizeof(buffer));
+    CHECK(fifo.Size == 64);
+    CHECK(IsFifoEmpty(&fifo) == true);
+    CHECK(IsFifoFull(&fifo) == false);
+    CHECK(FifoGetCount(&fifo) == 0);
+}
+
+static void TestRandom( uint16_t size, uint16_t start )
+{
+    Fifo_t fifo;
+    uint8_t buffer[256], chunk[300], *span;
+    uint32_t written = 0, read = 0, overflows = 0;
+    uint16_t len, n, i, count;
+    unsigned op;
+
+    FifoInit(&fifo, buffer, size);
+    // Close to the wrap around of the free running indices
+    fifo.Begin = start;
+    fifo.End = start;
+
+    for ( op = 0; op < NB_OPERATIONS; op++ ) {
+        count = written - read;
+        CHECK(FifoGetCount(&fifo) == count);
+        CHECK(IsFifoEmpty(&fifo) == (count == 0));
+        CHECK(IsFifoFull(&fifo) == (count == size));
+
+        switch ( rand() % 6 ) {
+            case 0:
+                if ( IsFifoFull(&fifo) == true ) {
+                    FifoPush(&fifo, 0xA5);
+                    overflows++;
+                } else {
+                    FifoPush(&fifo, Sequence(written++));
+                }
+                break;
+            case 1:
+                if ( IsFifoEmpty(&fifo) == false ) {
+                    CHECK(FifoPop(&fifo) == Sequence(read++));
+                }
+                break;
+            case 2:
+                len = rand() % (size + 8);
+                for ( i = 0; i < len; i++ ) {
+                    chunk[i] = Sequence(written + i);
+                }
+                n = FifoPushBuffer(&fifo, chunk, len);
+                CHECK(n == ((len < size - count) ? len : size - count));
+                written += n;
+                break;
+            case 3:
+                len = rand() % (size + 8);
+                n = FifoPopBuffer(&fifo, chunk, len);
+                CHECK(n == ((len < count) ? len : count));
+                for ( i = 0; i < n; i++ ) {
+                    CHECK(chunk[i] == Sequence(read + i));
+                }
+                read += n;
+                break;
+            case 4:
+                // Zero copy write, at most up to the end of the buffer
+                len = FifoWritePeek(&fifo, &span);
+                CHECK(len <= size - count);
+                CHECK(span + len <= buffer + size);
+                CHECK((len > 0) || (count == size));
+                n = (len > 0) ? rand() % (len + 1) : 0;
+                for ( i = 0; i < n; i++ ) {
+                    span[i] = Sequence(written + i);
+                }
+                FifoWriteCommit(&fifo, n);
+                written += n;
+                break;
+            default:
+                // Zero copy read, at most up to the end of the buffer
+                len = FifoReadPeek(&fifo, &span);
+                CHECK(len <= count);
+                CHECK(span + len <= buffer + size);
+                CHECK((len > 0) || (count == 0));
+                n = (len > 0) ? rand() % (len + 1) : 0;
+                for ( i = 0; i < n; i++ ) {
+                    CHECK(span[i] == Sequence(read + i));
+                }
+                FifoReadCommit(&fifo, n);
+                read += n;
+                break;
+        }
+    }
+    CHECK(fifo.Overflows == overflows);
+
+    FifoFlush(&fifo);
+    CHECK(IsFifoEmpty(&fifo) == true);
+}
+
+static void* Producer( void *arg )
+{
+    uint8_t chunk[THREAD_FIFO_SIZE + 16];
+    uint32_t written = 0;
+    uint16_t len, i;
+
+    while ( written < NB_THREAD_BYTES ) {
+        len = 1 + rand() % sizeof(chunk);
+        if ( len > NB_THREAD_BYTES - written ) {
+            len = NB_THREAD_BYTES - written;
+        }
+        for ( i = 0; i < len; i++ ) {
+            chunk[i] = Sequence(written + i);
+        }
+        written += FifoPushBuffer(&ThreadFifo, chunk, len);
+        if ( IsFifoFull(&ThreadFifo) == true ) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void TestThreads( void )
+{
+    pthread_t producer;
+    uint8_t chunk[THREAD_FIFO_SIZE / 2];
+    uint32_t read = 0, errors = 0;
+    uint16_t n, i;
+
+    FifoInit(&ThreadFifo, ThreadBuffer, sizeof(ThreadBuffer));
+    ThreadFifo.Begin = 0xFF00;
+    ThreadFifo.End = 0xFF00;
+    CHECK(pthread_create(&producer, NULL, Producer, NULL) == 0);
+
+    while ( read < NB_THREAD_BYTES ) {
+        n = FifoPopBuffer(&ThreadFifo, chunk, 1 + read % sizeof(chunk));
+        for ( i = 0; i < n; i++ ) {
+            errors += (chunk[i] != Sequence(read + i));
+        }
+        read += n;
+        if ( n == 0 ) {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    CHECK(errors == 0);
+    CHECK(IsFifoEmpty(&ThreadFifo) == true);
+    CHECK(ThreadFifo.Overflows == 0);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const uint16_t sizes[] = { 1, 2, 16, 64, 256 };
+    unsigned i;
+
+    srand(1);
+    TestInit();
+    for ( i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++ ) {
+        TestRandom(sizes[i], 0);
+        TestRandom(sizes[i], 0xFFFF - sizes[i] / 2);
+    }
+    TestThreads();
+
+    printf("test-fifo: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
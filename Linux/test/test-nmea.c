@@ -0,0 +1,327 @@
+/**
+ * \file test-nmea.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the streaming NMEA parser over a receiver log
+ *
+ * The log (test/data/neo6m-1hz.nmea) has the output of a u-blox NEO-6M at
+ * 1 Hz: 30 epochs of RMC, VTG, GGA, GSA, 3 GSV and GLL, the first three
+ * without a fix. It starts in the middle of a sentence, one GGA has a bit
+ * error and one RMC is cut by an UART overrun.
+ *
+ * Every line is decoded a second time with strtod into the expected values,
+ * the sentences published by the parser have to match them in order. The
+ * log is fed byte by byte and in random blocks as delivered by the UART.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nmea.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define DEFAULT_LOG                                 "test/data/neo6m-1hz.nmea"
+
+#define LOG_MAX_SIZE                                65536
+#define MAX_SENTENCES                               256
+#define MAX_FIELDS                                  24
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef struct {
+    NmeaSentence_t Type;
+    union {
+        NmeaGga_t Gga;
+        NmeaRmc_t Rmc;
+        NmeaGsa_t Gsa;
+    } Data;
+} Expected_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static uint8_t Log[LOG_MAX_SIZE];
+static size_t LogSize;
+
+static Expected_t Expected[MAX_SENTENCES];
+static unsigned NbExpected;
+static unsigned NbPublished;
+static unsigned Mismatches;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! Splits a sentence body in place, empty fields are kept */
+static int SplitFields( char *body, char *fields[] )
+{
+    int n = 0;
+
+    fields[n++] = body;
+    while ( (*body != '\0') && (n < MAX_FIELDS) ) {
+        if ( *body == ',' ) {
+            *body = '\0';
+            fields[n++] = body + 1;
+        }
+        body++;
+    }
+    return n;
+}
+
+/*! Fixed point value truncated to the given decimals, as sent by the receiver */
+static int32_t Fixed( const char *field, int decimals )
+{
+    return (int32_t) floor(strtod(field, NULL) * pow(10, decimals) + 1e-6);
+}
+
+static int32_t Coordinate( const char *field, const char *hemisphere )
+{
+    double value, degrees;
+
+    if ( *field == '\0' ) {
+        return 0;
+    }
+    value = strtod(field, NULL);
+    degrees = floor(value / 100);
+    value = (degrees + (value - degrees * 100) / 60) * 1e7;
+    return (int32_t) lround(((*hemisphere == 'S') || (*hemisphere == 'W')) ? -value : value);
+}
+
+static void Time( const char *field, NmeaTime_t *time )
+{
+    double value = strtod(field, NULL);
+    uint32_t seconds = (uint32_t) value;
+
+    time->Hour = seconds / 10000;
+    time->Minute = (seconds / 100) % 100;
+    time->Second = seconds % 100;
+    time->Millisecond = (uint16_t) lround((value - seconds) * 1000);
+}
+
+/*! Decodes one line with a valid checksum into the expected values */
+static void ReferenceDecode( char *line )
+{
+    char *fields[MAX_FIELDS];
+    Expected_t *exp = &Expected[NbExpected];
+    const char *address = line + 1;
+    int n, i;
+
+    memset(exp, 0, sizeof(Expected_t));
+    *strchr(line, '*') = '\0';
+    n = SplitFields(line + 1, fields);
+
+    if ( strcmp(address + 2, "GGA") == 0 ) {
+        exp->Type = NMEA_SENTENCE_GGA;
+        Time(fields[1], &exp->Data.Gga.Time);
+        exp->Data.Gga.Latitude = Coordinate(fields[2], fields[3]);
+        exp->Data.Gga.Longitude = Coordinate(fields[4], fields[5]);
+        exp->Data.Gga.FixQuality = (uint8_t) atoi(fields[6]);
+        exp->Data.Gga.Satellites = (uint8_t) atoi(fields[7]);
+        exp->Data.Gga.Hdop = (uint16_t) Fixed(fields[8], 2);
+        exp->Data.Gga.Altitude = Fixed(fields[9], 2);
+        exp->Data.Gga.GeoidSeparation = Fixed(fields[11], 2);
+    } else if ( strcmp(address + 2, "RMC") == 0 ) {
+        exp->Type = NMEA_SENTENCE_RMC;
+        Time(fields[1], &exp->Data.Rmc.Time);
+        exp->Data.Rmc.Valid = (fields[2][0] == 'A');
+        exp->Data.Rmc.Latitude = Coordinate(fields[3], fields[4]);
+        exp->Data.Rmc.Longitude = Coordinate(fields[5], fields[6]);
+        exp->Data.Rmc.Speed = (uint32_t) Fixed(fields[7], 2);
+        exp->Data.Rmc.Course = (uint16_t) Fixed(fields[8], 2);
+        exp->Data.Rmc.Day = (uint8_t) (atoi(fields[9]) / 10000);
+        exp->Data.Rmc.Month = (uint8_t) ((atoi(fields[9]) / 100) % 100);
+        exp->Data.Rmc.Year = (uint8_t) (atoi(fields[9]) % 100);
+    } else if ( strcmp(address + 2, "GSA") == 0 ) {
+        exp->Type = NMEA_SENTENCE_GSA;
+        exp->Data.Gsa.Mode = fields[1][0];
+        exp->Data.Gsa.FixType = (uint8_t) atoi(fields[2]);
+        for ( i = 3; (i < 3 + NMEA_GSA_MAX_SATELLITES) && (i < n); i++ ) {
+            if ( fields[i][0] != '\0' ) {
+                exp->Data.Gsa.Satellites[exp->Data.Gsa.SatelliteCount++] = (uint8_t) atoi(
+                        fields[i]);
+            }
+        }
+        exp->Data.Gsa.Pdop = (uint16_t) Fixed(fields[15], 2);
+        exp->Data.Gsa.Hdop = (uint16_t) Fixed(fields[16], 2);
+        exp->Data.Gsa.Vdop = (uint16_t) Fixed(fields[17], 2);
+    } else {
+        return;
+    }
+    NbExpected++;
+}
+
+/*! Builds the expected sentences from the complete lines with a valid checksum */
+static void ReferenceScan( void )
+{
+    char line[256];
+    size_t start = 0, end, len;
+    unsigned checksum, received;
+    char *p, *star;
+
+    NbExpected = 0;
+    while ( start < LogSize ) {
+        for ( end = start; (end < LogSize) && (Log[end] != '\n'); end++ ) {
+        }
+        len = end - start;
+        if ( len >= sizeof(line) ) {
+            len = sizeof(line) - 1;
+        }
+        memcpy(line, &Log[start], len);
+        line[len] = '\0';
+        start = end + 1;
+
+        star = strchr(line, '*');
+        if ( (line[0] != '$') || (star == NULL) || (sscanf(star + 1, "%2x", &received) != 1) ) {
+            continue;
+        }
+        for ( checksum = 0, p = line + 1; p < star; p++ ) {
+            checksum ^= (uint8_t) *p;
+        }
+        if ( checksum == received ) {
+            ReferenceDecode(line);
+        }
+    }
+}
+
+static void OnSentence( NmeaParser_t *parser, NmeaSentence_t sentence )
+{
+    const Expected_t *exp = &Expected[NbPublished];
+    bool match;
+
+    if ( NbPublished++ >= NbExpected ) {
+        Mismatches++;
+        return;
+    }
+    switch ( sentence ) {
+        case NMEA_SENTENCE_GGA:
+            match = (exp->Type == sentence)
+                    && (memcmp(&parser->Gga.Time, &exp->Data.Gga.Time, sizeof(NmeaTime_t)) == 0)
+                    && (abs(parser->Gga.Latitude - exp->Data.Gga.Latitude) <= 1)
+                    && (abs(parser->Gga.Longitude - exp->Data.Gga.Longitude) <= 1)
+                    && (parser->Gga.FixQuality == exp->Data.Gga.FixQuality)
+                    && (parser->Gga.Satellites == exp->Data.Gga.Satellites)
+                    && (parser->Gga.Hdop == exp->Data.Gga.Hdop)
+                    && (parser->Gga.Altitude == exp->Data.Gga.Altitude)
+                    && (parser->Gga.GeoidSeparation == exp->Data.Gga.GeoidSeparation);
+            break;
+        case NMEA_SENTENCE_RMC:
+            match = (exp->Type == sentence)
+                    && (memcmp(&parser->Rmc.Time, &exp->Data.Rmc.Time, sizeof(NmeaTime_t)) == 0)
+                    && (parser->Rmc.Valid == exp->Data.Rmc.Valid)
+                    && (abs(parser->Rmc.Latitude - exp->Data.Rmc.Latitude) <= 1)
+                    && (abs(parser->Rmc.Longitude - exp->Data.Rmc.Longitude) <= 1)
+                    && (parser->Rmc.Speed == exp->Data.Rmc.Speed)
+                    && (parser->Rmc.Course == exp->Data.Rmc.Course)
+                    && (parser->Rmc.Day == exp->Data.Rmc.Day)
+                    && (parser->Rmc.Month == exp->Data.Rmc.Month)
+                    && (parser->Rmc.Year == exp->Data.Rmc.Year);
+            break;
+        case NMEA_SENTENCE_GSA:
+            match = (exp->Type == sentence) && (parser->Gsa.Mode == exp->Data.Gsa.Mode)
+                    && (parser->Gsa.FixType == exp->Data.Gsa.FixType)
+                    && (parser->Gsa.SatelliteCount == exp->Data.Gsa.SatelliteCount)
+                    && (memcmp(parser->Gsa.Satellites, exp->Data.Gsa.Satellites,
+                            parser->Gsa.SatelliteCount) == 0)
+                    && (parser->Gsa.Pdop == exp->Data.Gsa.Pdop)
+                    && (parser->Gsa.Hdop == exp->Data.Gsa.Hdop)
+                    && (parser->Gsa.Vdop == exp->Data.Gsa.Vdop);
+            break;
+        default:
+            match = false;
+            break;
+    }
+    if ( !match ) {
+        if ( Mismatches < 10 ) {
+            printf("sentence %u (type %d) does not match the reference\n", NbPublished - 1,
+                    sentence);
+        }
+        Mismatches++;
+    }
+}
+
+/*! Feeds the log in blocks of 1 .. maxBlock bytes */
+static void ParseLog( NmeaParser_t *parser, size_t maxBlock )
+{
+    size_t offset = 0, block;
+
+    NmeaParserInit(parser);
+    NbPublished = 0;
+    Mismatches = 0;
+    srand(1);
+    while ( offset < LogSize ) {
+        block = (maxBlock == 1) ? 1 : 1 + (size_t) rand() % maxBlock;
+        if ( block > LogSize - offset ) {
+            block = LogSize - offset;
+        }
+        (void) NmeaParseBuffer(parser, &Log[offset], block, OnSentence);
+        offset += block;
+    }
+}
+
+static void TestLog( size_t maxBlock )
+{
+    NmeaParser_t parser;
+
+    ParseLog(&parser, maxBlock);
+
+    CHECK(Mismatches == 0);
+    CHECK(NbPublished == NbExpected);
+    CHECK(parser.Stats.Bytes == LogSize);
+    CHECK(parser.Stats.Sentences == NbExpected);
+    /* 30 x (VTG, 3 GSV, GLL) and the TXT banner */
+    CHECK(parser.Stats.Ignored == 151);
+    /* The GGA with a bit error, the cut RMC */
+    CHECK(parser.Stats.ChecksumErrors == 1);
+    CHECK(parser.Stats.FormatErrors == 1);
+
+    /* Last epoch */
+    CHECK(parser.Rmc.Valid == true);
+    CHECK((parser.Rmc.Day == 18) && (parser.Rmc.Month == 10) && (parser.Rmc.Year == 26));
+    CHECK((parser.Gga.Time.Hour == 12) && (parser.Gga.Time.Minute == 35)
+            && (parser.Gga.Time.Second == 48));
+    CHECK((parser.Gga.FixQuality == 1) && (parser.Gga.Satellites == 8));
+    CHECK((parser.Gsa.FixType == 3) && (parser.Gsa.SatelliteCount == 8));
+
+    printf("blocks of 1..%u bytes: %u sentences, %u ignored, %u checksum errors, "
+            "%u format errors\n", (unsigned) maxBlock, (unsigned) parser.Stats.Sentences,
+            (unsigned) parser.Stats.Ignored, (unsigned) parser.Stats.ChecksumErrors,
+            (unsigned) parser.Stats.FormatErrors);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( int argc, char *argv[] )
+{
+    const char *path = (argc > 1) ? argv[1] : DEFAULT_LOG;
+    FILE *file = fopen(path, "rb");
+
+    if ( file == NULL ) {
+        printf("cannot open %s\n", path);
+        return 1;
+    }
+    LogSize = fread(Log, 1, sizeof(Log), file);
+    fclose(file);
+
+    ReferenceScan();
+    /* 30 epochs of GGA, RMC and GSA without the two broken sentences */
+    CHECK(NbExpected == 88);
+
+    TestLog(1);
+    TestLog(64);
+
+    printf("test-nmea: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
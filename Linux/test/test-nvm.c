@@ -0,0 +1,281 @@
+/**
+ * \file test-nvm.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the NVM store on the LinuxSim flash emulator
+ *
+ * Checks the store functions, the wear leveling over a long series of
+ * updates, the frame counter restore across resets, and the power failure
+ * safety: a write sequence is cut at every single flash operation in turn,
+ * after the remount every key has to read its last completed value or the
+ * value being written when the power failed.
+ *
+ * nvm.c is included to reset its state for a remount, as a reset does.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "nvm.c"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_KEYS                                     12
+#define NB_WEAR_WRITES                              100000
+#define NB_POWER_FAIL_WRITES                        150
+#define NB_COUNTER_RESETS                           200
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Expected value of a key, size 0 if not stored */
+typedef struct {
+    uint8_t Size;
+    uint8_t Data[NVM_MAX_VALUE_SIZE];
+} Value_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static Value_t Expected[NB_KEYS];
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! Mounts the store again, as after a reset */
+static bool Remount( void )
+{
+    Mounted = false;
+    return NvmInit();
+}
+
+/*! Value number n of a key, every 16th write deletes the key */
+static void MakeValue( uint8_t key, uint32_t n, Value_t *value )
+{
+    value->Size = ((n % 16) == 15) ? 0 : (uint8_t)(4 + (key * 7 + n) % 29);
+    for ( uint8_t i = 0; i < value->Size; i++ ) {
+        value->Data[i] = (uint8_t)(key + n * 3 + i);
+    }
+}
+
+static bool ReadsAs( uint8_t key, const Value_t *value )
+{
+    uint8_t data[NVM_MAX_VALUE_SIZE];
+
+    return NvmRead(key, data, sizeof(data)) == value->Size
+            && memcmp(data, value->Data, value->Size) == 0;
+}
+
+static bool ReadsExpected( void )
+{
+    for ( uint8_t key = 0; key < NB_KEYS; key++ ) {
+        if ( !ReadsAs(key, &Expected[key]) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void TestStore( void )
+{
+    uint8_t data[NVM_MAX_VALUE_SIZE];
+    NvmStats_t stats;
+
+    NvmMcuSimFormat();
+    CHECK(Remount());
+
+    /* Pending values are read before they are written */
+    CHECK(NvmWrite(3, "abc", 3));
+    CHECK(NvmRead(3, data, sizeof(data)) == 3 && memcmp(data, "abc", 3) == 0);
+    CHECK(NvmProcess());
+    CHECK(NvmRead(3, data, sizeof(data)) == 3 && memcmp(data, "abc", 3) == 0);
+
+    /* Unchanged values are not written again */
+    CHECK(NvmWrite(3, "abc", 3));
+    CHECK(NvmProcess());
+    NvmGetStats(&stats);
+    CHECK(stats.Writes == 1 && stats.Skipped == 1);
+
+    /* The largest key and value */
+    memset(data, 0x5A, sizeof(data));
+    CHECK(NvmWrite(NVM_MAX_KEYS - 1, data, NVM_MAX_VALUE_SIZE));
+    CHECK(!NvmWrite(NVM_MAX_KEYS, data, 1));
+    CHECK(!NvmWrite(0, data, NVM_MAX_VALUE_SIZE + 1));
+    CHECK(NvmProcess());
+
+    /* Values survive a reset, deleted ones do not */
+    CHECK(NvmDelete(3));
+    CHECK(NvmProcess());
+    CHECK(Remount());
+    CHECK(NvmRead(3, data, sizeof(data)) == 0);
+    CHECK(NvmRead(NVM_MAX_KEYS - 1, data, sizeof(data)) == NVM_MAX_VALUE_SIZE && data[0] == 0x5A);
+
+    /* Writes are refused, not lost, when all pending slots are used */
+    for ( uint8_t key = 0; key < NVM_PENDING_SLOTS; key++ ) {
+        CHECK(NvmWrite(key, &key, 1));
+    }
+    CHECK(!NvmWrite(NVM_PENDING_SLOTS, data, 1));
+    NvmGetStats(&stats);
+    CHECK(stats.Dropped == 1);
+    CHECK(NvmProcess());
+    CHECK(NvmWrite(NVM_PENDING_SLOTS, data, 1));
+    CHECK(NvmProcess());
+}
+
+static void TestWear( void )
+{
+    uint32_t minErase = UINT32_MAX, maxErase = 0, count;
+    NvmStats_t stats;
+    uint8_t key;
+
+    NvmMcuSimFormat();
+    CHECK(Remount());
+    memset(Expected, 0, sizeof(Expected));
+
+    for ( uint32_t n = 0; n < NB_WEAR_WRITES; n++ ) {
+        key = (uint8_t)(n % NB_KEYS);
+        MakeValue(key, n / NB_KEYS, &Expected[key]);
+        CHECK(NvmWrite(key, Expected[key].Data, Expected[key].Size));
+        CHECK(NvmProcess());
+    }
+    CHECK(ReadsExpected());
+    NvmGetStats(&stats);
+    CHECK(Remount());
+    CHECK(ReadsExpected());
+
+    for ( uint8_t sector = 0; sector < NVM_MCU_NB_SECTORS; sector++ ) {
+        count = NvmMcuSimGetEraseCount(sector);
+        minErase = MIN(minErase, count);
+        maxErase = (count > maxErase) ? count : maxErase;
+    }
+    /* The sectors are used in turn */
+    CHECK(stats.Errors == 0);
+    CHECK(stats.Compactions > 0);
+    CHECK((maxErase - minErase) <= 1);
+    printf("wear: %u writes, %u compactions, erase cycles %u..%u per sector\n", stats.Writes,
+            stats.Compactions, minErase, maxErase);
+}
+
+static void TestCounters( void )
+{
+    uint32_t next = 0, restored, previous = 0;
+
+    NvmMcuSimFormat();
+    CHECK(Remount());
+    CHECK(NvmCounterSet(0, 0));
+    CHECK(NvmProcess());
+
+    srand(2);
+    for ( uint32_t reset = 0; reset < NB_COUNTER_RESETS; reset++ ) {
+        /* Frames sent, the NVM task runs between them */
+        for ( int frames = rand() % 200; frames > 0; frames-- ) {
+            next++;
+            CHECK(NvmCounterUpdate(0, next));
+            if ( (rand() % 4) != 0 ) {
+                CHECK(NvmProcess());
+            }
+        }
+        /* The pending write is lost by the reset */
+        CHECK(Remount());
+        CHECK(NvmCounterRestore(0, &restored));
+        CHECK(restored >= next);
+        CHECK(restored > previous || reset == 0);
+        CHECK(NvmProcess());
+        previous = restored;
+        next = restored;
+    }
+
+    /* Resets without any frame in between never return a used value again */
+    CHECK(Remount());
+    CHECK(NvmCounterRestore(0, &restored));
+    CHECK(restored > previous);
+}
+
+/*! Runs the write sequence, cut at the given flash operation. Returns true if
+ *  the sequence completed before the power failed. */
+static bool RunPowerFail( uint32_t cut )
+{
+    Value_t value;
+    int8_t inFlight = -1;
+    uint8_t key;
+    bool ok;
+
+    NvmMcuSimFormat();
+    CHECK(Remount());
+    memset(Expected, 0, sizeof(Expected));
+    NvmMcuSimPowerFail(cut);
+
+    for ( uint32_t n = 0; n < NB_POWER_FAIL_WRITES; n++ ) {
+        key = (uint8_t)((n * 7) % NB_KEYS);
+        MakeValue(key, n, &value);
+        CHECK(NvmWrite(key, value.Data, value.Size));
+        ok = NvmProcess();
+        if ( NvmMcuSimIsPoweredOff() ) {
+            inFlight = (int8_t) key;
+            break;
+        }
+        CHECK(ok);
+        Expected[key] = value;
+    }
+    if ( inFlight < 0 ) {
+        return true;
+    }
+
+    NvmMcuSimPowerOn();
+    CHECK(Remount());
+    for ( key = 0; key < NB_KEYS; key++ ) {
+        if ( ReadsAs(key, &Expected[key]) ) {
+            continue;
+        }
+        if ( key == inFlight && ReadsAs(key, &value) ) {
+            Expected[key] = value;
+            continue;
+        }
+        printf("power failure at operation %u: key %u lost\n", cut, key);
+        Failures++;
+    }
+
+    /* The store keeps working */
+    for ( key = 0; key < NB_KEYS; key++ ) {
+        MakeValue(key, 1000 + cut, &Expected[key]);
+        CHECK(NvmWrite(key, Expected[key].Data, Expected[key].Size));
+        CHECK(NvmProcess());
+    }
+    CHECK(Remount());
+    CHECK(ReadsExpected());
+    return false;
+}
+
+static void TestPowerFail( void )
+{
+    uint32_t cut = 1;
+
+    while ( !RunPowerFail(cut) ) {
+        cut++;
+    }
+    printf("power failure: %u cut points\n", cut - 1);
+    CHECK(cut > 1000);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    TestStore();
+    TestWear();
+    TestCounters();
+    TestPowerFail();
+
+    printf("test-nvm: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
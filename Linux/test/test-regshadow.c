@@ -0,0 +1,300 @@
+/**
+ * \file test-regshadow.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the register shadow of the SX1276 and SX1272 drivers
+ *
+ * Each driver is built into two radio nodes (radio-node.c) on the fake radio
+ * of test/radio, with the register shadow and with SX127x_REG_SHADOW 0, which
+ * sends every register access over SPI as the drivers did before. Both nodes
+ * run the radio calls of LoRaMac.c for uplinks followed by the RX1 and RX2
+ * windows, with datarate changes, a switch to the FSK modem and back, and
+ * the Sleep and Standby operating modes in between.
+ *
+ * After every step the register files of both modems and the FIFO have to be
+ * the same on both nodes. The SPI bytes of both are reported together with
+ * the number of registers whose content changed in the step: a precomputed
+ * register image per datarate would have to write at least those. Once the
+ * shadow is valid the shadowed driver may only write REG_OPMODE unchanged.
+ *
+ * Usage: test-regshadow [sx1276-plain.so sx1276-shadow.so sx1272-plain.so sx1272-shadow.so]
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "board.h"
+#include "fake-sx127x.h"
+#include "radio-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_RADIOS                                   2
+#define NB_NODES                                    2
+
+/*! Uplink payload length, 13 byte header and MIC with 16 byte application data */
+#define UPLINK_SIZE                                 29
+
+/*! EU868 channels of the steps */
+#define UPLINK_CHANNEL_1                            868100000
+#define UPLINK_CHANNEL_2                            868300000
+#define FSK_CHANNEL                                 868800000
+#define RX2_CHANNEL                                 869525000
+#define RX2_SF                                      12
+
+/*! Name of the node shared objects next to the test executable */
+#define NODE_LIBRARIES                              { "libradio-node-sx1276-0.so", \
+                                                      "libradio-node-sx1276-1.so", \
+                                                      "libradio-node-sx1272-0.so", \
+                                                      "libradio-node-sx1272-1.so" }
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node instance, the entry points and the fake radio of its shared object */
+typedef struct {
+    void *Handle;
+    const struct Radio_s *Radio;
+    void (*Init)( void );
+    void (*Irq)( uint8_t dio, uint8_t flags );
+    uint8_t *Regs;
+    uint8_t *FskRegs;
+    uint8_t *Fifo;
+    FakeSx127xStats_t *Stats;
+} Node_t;
+
+/*! Step of the sequence */
+typedef struct {
+    const char *Name;
+    void (*Run)( Node_t *node );
+    bool Steady;                //! The shadow is valid from the previous steps
+} Step_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static uint8_t Payload[UPLINK_SIZE];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool LoadNode( Node_t *node, const char *library );
+static void DefaultLibraryPath( char *path, size_t size, const char *name );
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! LoRa uplink as sent by LoRaMac.c, completed by the TxDone interrupt */
+static void Uplink( Node_t *node, uint32_t channel, uint32_t sf )
+{
+    node->Radio->SetChannel(channel);
+    node->Radio->SetMaxPayloadLength(MODEM_LORA, UPLINK_SIZE);
+    node->Radio->SetTxConfig(MODEM_LORA, 14, 0, 0, sf, 1, 8, false, true, 0, 0, false, 3000000);
+    node->Radio->Send(Payload, UPLINK_SIZE);
+    node->Irq(0, RFLR_IRQFLAGS_TXDONE);
+}
+
+/*! LoRa receive window as opened by LoRaMac.c, closed by the RxTimeout interrupt */
+static void RxWindow( Node_t *node, uint32_t channel, uint32_t sf )
+{
+    node->Radio->Standby();
+    node->Radio->SetChannel(channel);
+    node->Radio->SetRxConfig(MODEM_LORA, 0, sf, 1, 0, 8, 5, false, 0, false, 0, 0, true, false);
+    node->Radio->SetMaxPayloadLength(MODEM_LORA, 242);
+    node->Radio->Rx(3000000);
+    node->Irq(1, RFLR_IRQFLAGS_RXTIMEOUT);
+    node->Radio->Sleep();
+}
+
+static void UplinkSf7( Node_t *node )
+{
+    Uplink(node, UPLINK_CHANNEL_1, 7);
+}
+
+static void UplinkSf12( Node_t *node )
+{
+    Uplink(node, UPLINK_CHANNEL_2, 12);
+}
+
+static void Rx1Sf7( Node_t *node )
+{
+    RxWindow(node, UPLINK_CHANNEL_1, 7);
+}
+
+static void Rx1Sf12( Node_t *node )
+{
+    RxWindow(node, UPLINK_CHANNEL_2, 12);
+}
+
+static void Rx2( Node_t *node )
+{
+    RxWindow(node, RX2_CHANNEL, RX2_SF);
+}
+
+/*! FSK uplink of DR7, the drivers have no FSK interrupt in the fake */
+static void UplinkFsk( Node_t *node )
+{
+    node->Radio->SetChannel(FSK_CHANNEL);
+    node->Radio->SetMaxPayloadLength(MODEM_LORA, UPLINK_SIZE);
+    node->Radio->SetTxConfig(MODEM_FSK, 14, 25000, 0, 50000, 0, 5, false, true, 0, 0, false, 3000000);
+    node->Radio->Send(Payload, UPLINK_SIZE);
+    node->Radio->Sleep();
+}
+
+/*! Registers of both modems whose content differs */
+static uint32_t CountChanged( const uint8_t *a, const uint8_t *fskA, const uint8_t *b,
+        const uint8_t *fskB )
+{
+    uint32_t i, count = 0;
+
+    for ( i = 1; i < FAKE_SX127X_NB_REGS; i++ ) {
+        count += (a[i] != b[i]);
+        if ( (i >= FAKE_SX127X_PAGE_FIRST) && (i <= FAKE_SX127X_PAGE_LAST) ) {
+            count += (fskA[i] != fskB[i]);
+        }
+    }
+    return count;
+}
+
+static void TestRadio( const char *name, Node_t *nodes )
+{
+    // The modem switches invalidate the shadow
+    static const Step_t steps[] = {
+        { "uplink SF7", UplinkSf7, false }, { "RX1 SF7", Rx1Sf7, false },
+        { "RX2 SF12", Rx2, false },
+        { "uplink SF7", UplinkSf7, true }, { "RX1 SF7", Rx1Sf7, true }, { "RX2 SF12", Rx2, true },
+        { "uplink SF12", UplinkSf12, true }, { "RX1 SF12", Rx1Sf12, true },
+        { "RX2 SF12", Rx2, true },
+        { "uplink FSK", UplinkFsk, false },
+        { "uplink SF7", UplinkSf7, false }, { "RX1 SF7", Rx1Sf7, false },
+        { "RX2 SF12", Rx2, true } };
+    uint8_t regs[FAKE_SX127X_NB_REGS], fskRegs[FAKE_SX127X_NB_REGS];
+    FakeSx127xStats_t before[NB_NODES], delta[NB_NODES];
+    uint32_t s, n, changed, total[NB_NODES] = { 0 };
+
+    for ( n = 0; n < NB_NODES; n++ ) {
+        nodes[n].Init();
+    }
+    CHECK(memcmp(nodes[0].Regs, nodes[1].Regs, FAKE_SX127X_NB_REGS) == 0);
+    CHECK(memcmp(nodes[0].FskRegs, nodes[1].FskRegs, FAKE_SX127X_NB_REGS) == 0);
+
+    printf("test-regshadow (%s): SPI bytes and register writes per step\n", name);
+    printf("  %-14s %14s %24s %8s\n", "", "plain", "shadow", "changed");
+    printf("  %-14s %6s %7s %6s %7s %10s\n", "step", "bytes", "writes", "bytes", "writes",
+            "redundant");
+    for ( s = 0; s < sizeof(steps) / sizeof(steps[0]); s++ ) {
+        memcpy(regs, nodes[0].Regs, sizeof(regs));
+        memcpy(fskRegs, nodes[0].FskRegs, sizeof(fskRegs));
+        for ( n = 0; n < NB_NODES; n++ ) {
+            before[n] = *nodes[n].Stats;
+            steps[s].Run(&nodes[n]);
+            delta[n].Bytes = nodes[n].Stats->Bytes - before[n].Bytes;
+            delta[n].RegWrites = nodes[n].Stats->RegWrites - before[n].RegWrites;
+            delta[n].RedundantWrites = nodes[n].Stats->RedundantWrites
+                    - before[n].RedundantWrites;
+            total[n] += delta[n].Bytes;
+        }
+        changed = CountChanged(regs, fskRegs, nodes[0].Regs, nodes[0].FskRegs);
+
+        // The radio ends up in the same state with and without the shadow
+        CHECK(memcmp(nodes[0].Regs, nodes[1].Regs, FAKE_SX127X_NB_REGS) == 0);
+        CHECK(memcmp(nodes[0].FskRegs, nodes[1].FskRegs, FAKE_SX127X_NB_REGS) == 0);
+        CHECK(memcmp(nodes[0].Fifo, nodes[1].Fifo, FAKE_SX127X_FIFO_SIZE) == 0);
+        CHECK(delta[1].Bytes <= delta[0].Bytes);
+        if ( steps[s].Steady == true ) {
+            CHECK(delta[1].RedundantWrites <= 1);
+        }
+
+        printf("  %-14s %6u %7u %6u %7u %10u %8u\n", steps[s].Name, delta[0].Bytes,
+                delta[0].RegWrites, delta[1].Bytes, delta[1].RegWrites,
+                delta[1].RedundantWrites, changed);
+    }
+    printf("  %-14s %6u %7s %6u\n", "total", total[0], "", total[1]);
+}
+
+static bool LoadNode( Node_t *node, const char *library )
+{
+    node->Handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+    if ( node->Handle == NULL ) {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    node->Radio = (const struct Radio_s *) dlsym(node->Handle, "Radio");
+    node->Init = (void (*)( void )) dlsym(node->Handle, "RadioNodeInit");
+    node->Irq = (void (*)( uint8_t, uint8_t )) dlsym(node->Handle, "RadioNodeIrq");
+    node->Regs = (uint8_t *) dlsym(node->Handle, "FakeSx127xRegs");
+    node->FskRegs = (uint8_t *) dlsym(node->Handle, "FakeSx127xFskRegs");
+    node->Fifo = (uint8_t *) dlsym(node->Handle, "FakeSx127xFifo");
+    node->Stats = (FakeSx127xStats_t *) dlsym(node->Handle, "FakeSx127xStats");
+
+    if ( (node->Radio == NULL) || (node->Init == NULL) || (node->Irq == NULL)
+            || (node->Regs == NULL) || (node->FskRegs == NULL) || (node->Fifo == NULL)
+            || (node->Stats == NULL) ) {
+        fprintf(stderr, "%s: not a radio node\n", library);
+        return false;
+    }
+    return true;
+}
+
+static void DefaultLibraryPath( char *path, size_t size, const char *name )
+{
+    ssize_t len = readlink("/proc/self/exe", path, size - 1);
+    char *slash;
+
+    if ( len > 0 ) {
+        path[len] = '\0';
+        slash = strrchr(path, '/');
+        if ( (slash != NULL) && ((size_t) (slash - path) + strlen(name) + 2 < size) ) {
+            strcpy(slash + 1, name);
+            return;
+        }
+    }
+    snprintf(path, size, "./%s", name);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( int argc, char **argv )
+{
+    static const char *names[NB_RADIOS] = { "SX1276", "SX1272" };
+    static const char *defaults[NB_RADIOS * NB_NODES] = NODE_LIBRARIES;
+    char libraries[NB_RADIOS * NB_NODES][256];
+    Node_t nodes[NB_RADIOS][NB_NODES];
+    uint32_t r, n, i;
+
+    for ( i = 0; i < NB_RADIOS * NB_NODES; i++ ) {
+        if ( argc == 1 + NB_RADIOS * NB_NODES ) {
+            snprintf(libraries[i], sizeof(libraries[i]), "%s", argv[1 + i]);
+        } else {
+            DefaultLibraryPath(libraries[i], sizeof(libraries[i]), defaults[i]);
+        }
+    }
+    for ( i = 0; i < UPLINK_SIZE; i++ ) {
+        Payload[i] = (uint8_t) (i * 11 + 5);
+    }
+
+    for ( r = 0; r < NB_RADIOS; r++ ) {
+        for ( n = 0; n < NB_NODES; n++ ) {
+            if ( !LoadNode(&nodes[r][n], libraries[r * NB_NODES + n]) ) {
+                return 1;
+            }
+        }
+        TestRadio(names[r], nodes[r]);
+    }
+
+    printf("test-regshadow: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
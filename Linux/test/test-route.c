@@ -0,0 +1,319 @@
+/**
+ * \file test-route.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the LoRaMesh multi-hop routing
+ *
+ * Chains of 3 to 5 hops: node 0 is the coordinator, the parent of node i is
+ * node i - 1 and a node only hears its parent and its child. Every node runs
+ * its own copy of the routing node (route-node.c), the coordinator holds the
+ * sessions of all nodes, a router the one of its child.
+ *
+ * - The beacons are sent from the coordinator outwards: every node has to
+ *   route to the coordinator over its parent, the path metric growing with
+ *   every hop.
+ * - Every node sends uplinks over its parent, the routers forward them: the
+ *   coordinator has to receive every frame once and intact, the routers have
+ *   to learn the route back to the origins beyond their child.
+ * - Every frame has to be queued on the channel of the session it is sent
+ *   with, pLoRaDevice->currChannelIndex is left to the PHY.
+ *
+ * Usage: test-route [route-node.so]
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "route-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define HOPS_MIN                                    3
+#define HOPS_MAX                                    5
+#define NB_NODES_MAX                                (HOPS_MAX + 1)
+
+#define NB_ROUNDS                                   3
+#define NB_UPLINKS                                  4
+#define PAYLOAD_SIZE                                20
+#define FRM_PORT                                    2
+
+/*! Time between two frames on the chain [us] */
+#define FRAME_INTERVAL                              1000000
+
+/*! SNR of every link [dB] */
+#define LINK_SNR                                    5
+
+/*! Device address of the coordinator, node i has DEV_ADDR_BASE + i */
+#define DEV_ADDR_BASE                               0x26020000
+
+/*! Channel left in pLoRaDevice->currChannelIndex, no session uses it */
+#define CURR_CHANNEL_INDEX                          7
+
+/*! Name of the node shared object next to the test executable */
+#define ROUTE_NODE_LIBRARY                          "libroute-node.so"
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node instance, the entry points of its shared object copy */
+typedef struct {
+    void *Handle;
+    void (*Init)( const RouteNodeConfig_t *config );
+    void (*AddChild)( uint32_t devAddr, uint8_t channelIndex );
+    void (*SetTime)( uint64_t time );
+    void (*Advertise)( void );
+    uint8_t (*SendUp)( uint8_t fPort, const uint8_t *payload, uint8_t size );
+    bool (*GetTx)( RouteNodeTx_t *tx );
+    uint8_t (*OnRx)( const uint8_t *phy, int8_t snr );
+    bool (*GetRx)( RouteNodeRx_t *rx );
+    bool (*GetRoute)( uint32_t dest, uint32_t *nextHop, uint16_t *metric );
+    uint8_t (*GetCurrChannelIndex)( void );
+    uint8_t ChannelIndex;
+} Node_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static Node_t Nodes[NB_NODES_MAX];
+static uint8_t NbNodes;
+static uint64_t Time;
+static unsigned NbFrames;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool LoadNode( Node_t *node, const char *library );
+static void DefaultLibraryPath( char *path, size_t size );
+static void Run( void );
+static void TestChain( const char *library, uint8_t hops );
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( int argc, char **argv )
+{
+    char library[4096];
+    uint8_t hops;
+
+    if ( argc > 1 ) {
+        snprintf(library, sizeof(library), "%s", argv[1]);
+    } else {
+        DefaultLibraryPath(library, sizeof(library));
+    }
+
+    for ( hops = HOPS_MIN; hops <= HOPS_MAX; hops++ ) {
+        TestChain(library, hops);
+    }
+
+    printf("test-route: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void TestChain( const char *library, uint8_t hops )
+{
+    RouteNodeConfig_t config;
+    RouteNodeRx_t rx;
+    uint8_t payload[PAYLOAD_SIZE], received[NB_NODES_MAX];
+    uint16_t metric, lastMetric;
+    uint32_t nextHop;
+    uint8_t i, j, n, round;
+
+    NbNodes = hops + 1;
+    NbFrames = 0;
+    Time = 0;
+    for ( i = 0; i < NbNodes; i++ ) {
+        if ( !LoadNode(&Nodes[i], library) ) {
+            Failures++;
+            return;
+        }
+        /* Neighbors use different channels */
+        Nodes[i].ChannelIndex = i % 3;
+        config.DevAddr = DEV_ADDR_BASE + i;
+        config.CoordinatorAddr = DEV_ADDR_BASE;
+        config.ChannelIndex = Nodes[i].ChannelIndex;
+        config.CurrChannelIndex = CURR_CHANNEL_INDEX;
+        Nodes[i].Init(&config);
+    }
+    for ( i = 1; i < NbNodes; i++ ) {
+        Nodes[0].AddChild(DEV_ADDR_BASE + i, Nodes[i].ChannelIndex);
+        if ( i > 1 ) {
+            Nodes[i - 1].AddChild(DEV_ADDR_BASE + i, Nodes[i].ChannelIndex);
+        }
+    }
+
+    /* Beacons from the coordinator outwards */
+    for ( round = 0; round < NB_ROUNDS; round++ ) {
+        for ( i = 0; i < NbNodes; i++ ) {
+            Nodes[i].Advertise();
+            Run();
+        }
+    }
+    lastMetric = 0;
+    for ( i = 1; i < NbNodes; i++ ) {
+        CHECK(Nodes[i].GetRoute(DEV_ADDR_BASE, &nextHop, &metric));
+        CHECK(nextHop == DEV_ADDR_BASE + i - 1);
+        CHECK(metric > lastMetric);
+        lastMetric = metric;
+    }
+
+    /* Uplinks of every node, forwarded to the coordinator */
+    memset(received, 0, sizeof(received));
+    for ( n = 0; n < NB_UPLINKS; n++ ) {
+        for ( i = 1; i < NbNodes; i++ ) {
+            for ( j = 0; j < PAYLOAD_SIZE; j++ ) {
+                payload[j] = (uint8_t) (i * 16 + n + j);
+            }
+            CHECK(Nodes[i].SendUp(FRM_PORT, payload, PAYLOAD_SIZE) == 0);
+            Run();
+
+            CHECK(Nodes[0].GetRx(&rx));
+            CHECK(rx.DevAddr == DEV_ADDR_BASE + i && rx.FPort == FRM_PORT);
+            CHECK(rx.Size == PAYLOAD_SIZE && memcmp(rx.Payload, payload, PAYLOAD_SIZE) == 0);
+            received[i]++;
+            /* Nothing for the routers */
+            for ( j = 0; j < NbNodes; j++ ) {
+                CHECK(!Nodes[j].GetRx(&rx));
+            }
+        }
+    }
+    for ( i = 1; i < NbNodes; i++ ) {
+        CHECK(received[i] == NB_UPLINKS);
+    }
+
+    /* Routes back to the origins beyond the child */
+    for ( j = 0; j < NbNodes; j++ ) {
+        for ( i = j + 2; i < NbNodes; i++ ) {
+            CHECK(Nodes[j].GetRoute(DEV_ADDR_BASE + i, &nextHop, &metric));
+            CHECK(nextHop == DEV_ADDR_BASE + j + 1);
+        }
+    }
+    for ( i = 0; i < NbNodes; i++ ) {
+        CHECK(Nodes[i].GetCurrChannelIndex() == CURR_CHANNEL_INDEX);
+        dlclose(Nodes[i].Handle);
+    }
+
+    printf("  %u hops: %u frames on air\n", hops, NbFrames);
+}
+
+/*! Hands the queued frames over to the neighbors until no node has one left */
+static void Run( void )
+{
+    RouteNodeTx_t tx;
+    bool sent;
+    uint8_t i;
+
+    do {
+        sent = false;
+        for ( i = 0; i < NbNodes; i++ ) {
+            while ( Nodes[i].GetTx(&tx) ) {
+                Time += FRAME_INTERVAL;
+                NbFrames++;
+                sent = true;
+                /* Beacons on the current channel, frames on the one of the uplink session */
+                if ( tx.Advertising ) {
+                    CHECK(tx.ChannelIndex == CURR_CHANNEL_INDEX);
+                } else {
+                    CHECK(tx.ChannelIndex == Nodes[i].ChannelIndex);
+                }
+                if ( i > 0 ) {
+                    Nodes[i - 1].SetTime(Time);
+                    (void) Nodes[i - 1].OnRx(tx.Phy, LINK_SNR);
+                }
+                if ( i + 1 < NbNodes ) {
+                    Nodes[i + 1].SetTime(Time);
+                    (void) Nodes[i + 1].OnRx(tx.Phy, LINK_SNR);
+                }
+            }
+        }
+    } while ( sent );
+}
+
+static bool LoadNode( Node_t *node, const char *library )
+{
+    char path[] = "/tmp/route-node-XXXXXX";
+    char buffer[4096];
+    FILE *src;
+    size_t n;
+    int fd;
+
+    /* A library is loaded once per path, every node needs its own copy */
+    src = fopen(library, "rb");
+    if ( src == NULL ) {
+        perror(library);
+        return false;
+    }
+    fd = mkstemp(path);
+    if ( fd < 0 ) {
+        perror(path);
+        fclose(src);
+        return false;
+    }
+    while ( (n = fread(buffer, 1, sizeof(buffer), src)) > 0 ) {
+        if ( write(fd, buffer, n) != (ssize_t) n ) {
+            perror(path);
+            break;
+        }
+    }
+    fclose(src);
+    close(fd);
+
+    node->Handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    unlink(path);
+    if ( node->Handle == NULL ) {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    node->Init = (void (*)( const RouteNodeConfig_t * )) dlsym(node->Handle, "RouteNodeInit");
+    node->AddChild = (void (*)( uint32_t, uint8_t )) dlsym(node->Handle, "RouteNodeAddChild");
+    node->SetTime = (void (*)( uint64_t )) dlsym(node->Handle, "RouteNodeSetTime");
+    node->Advertise = (void (*)( void )) dlsym(node->Handle, "RouteNodeAdvertise");
+    node->SendUp = (uint8_t (*)( uint8_t, const uint8_t *, uint8_t )) dlsym(node->Handle,
+            "RouteNodeSendUp");
+    node->GetTx = (bool (*)( RouteNodeTx_t * )) dlsym(node->Handle, "RouteNodeGetTx");
+    node->OnRx = (uint8_t (*)( const uint8_t *, int8_t )) dlsym(node->Handle, "RouteNodeOnRx");
+    node->GetRx = (bool (*)( RouteNodeRx_t * )) dlsym(node->Handle, "RouteNodeGetRx");
+    node->GetRoute = (bool (*)( uint32_t, uint32_t *, uint16_t * )) dlsym(node->Handle,
+            "RouteNodeGetRoute");
+    node->GetCurrChannelIndex = (uint8_t (*)( void )) dlsym(node->Handle,
+            "RouteNodeGetCurrChannelIndex");
+
+    if ( node->Init == NULL || node->AddChild == NULL || node->SetTime == NULL
+            || node->Advertise == NULL || node->SendUp == NULL || node->GetTx == NULL
+            || node->OnRx == NULL || node->GetRx == NULL || node->GetRoute == NULL
+            || node->GetCurrChannelIndex == NULL ) {
+        fprintf(stderr, "%s: not a routing node\n", library);
+        return false;
+    }
+    return true;
+}
+
+static void DefaultLibraryPath( char *path, size_t size )
+{
+    ssize_t len = readlink("/proc/self/exe", path, size - 1);
+    char *slash;
+
+    if ( len > 0 ) {
+        path[len] = '\0';
+        slash = strrchr(path, '/');
+        if ( (slash != NULL) && ((size_t) (slash - path) + sizeof(ROUTE_NODE_LIBRARY) + 1 < size) ) {
+            strcpy(slash + 1, ROUTE_NODE_LIBRARY);
+            return;
+        }
+    }
+    snprintf(path, size, "./%s", ROUTE_NODE_LIBRARY);
+}
@@ -0,0 +1,233 @@
+/**
+ * \file test-rxwindow.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the RX window timing of the FreeRTOS timers
+ *
+ * src/system/timer.c runs with USE_FREE_RTOS on the simulated kernel of
+ * test/rtos/fake-rtos.c. As in OnRadioTxDone of LoRaPhy.c the RX1 and RX2
+ * window timers are started at a random phase to the tick, once as regular
+ * timers and once as precise timers. The error of the window opening, the
+ * callback in the timer task, is reported against the requested time. For
+ * the precise timers the error of the PIT interrupt is reported as well, the
+ * difference is what the deferral to the timer task costs.
+ *
+ * The callbacks stay deferred: opening a window accesses the radio over SPI,
+ * which is not allowed in the PIT interrupt. The stop of a timer between its
+ * interrupt and the deferred callback and the full timer command queue are
+ * checked as well.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "board.h"
+#include "fake-rtos.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_SAMPLES                                  10000
+#define NB_WINDOWS                                  2
+
+/*! Window delays of LoRaPhy.c [us] */
+#define RX_WINDOW_1_DELAY                           (1000000 - 1000)
+#define RX_WINDOW_2_DELAY                           (2000000 - 1000)
+
+/*! Timeout of the functional checks [us] */
+#define SHORT_TIMEOUT                               1000
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+/*! Load model: 2 us interrupt entry, 10% of the interrupts hit a masked
+ * section of up to 50 us, 5 us to switch to the timer task and 10 us per
+ * command, 20% of the switches wait for a critical section of up to 500 us */
+static const FakeRtosLoad_t Load = { 2, 10, 50, 5, 10, 20, 500 };
+
+static const char *Names[NB_WINDOWS] = { "RxWindow1", "RxWindow2" };
+static const uint32_t Delays[NB_WINDOWS] = { RX_WINDOW_1_DELAY, RX_WINDOW_2_DELAY };
+
+static TimerEvent_t RxWindowTimers[NB_WINDOWS];
+
+/*! Window openings of the current sample */
+static unsigned Opened[NB_WINDOWS];
+static uint64_t OpenTime[NB_WINDOWS];
+static uint64_t IsrTime[NB_WINDOWS];
+
+/*! Opening errors [us] */
+static int32_t RegularErrors[NB_WINDOWS][NB_SAMPLES];
+static int32_t PreciseErrors[NB_WINDOWS][NB_SAMPLES];
+static int32_t IsrErrors[NB_WINDOWS][NB_SAMPLES];
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void OnRxWindowTimerEvent( TimerHandle_t xTimer )
+{
+    uint32_t window = (uint32_t) (uintptr_t) pvTimerGetTimerID(xTimer);
+
+    OpenTime[window] = FakeRtosGetTime();
+    IsrTime[window] = FakeRtosStats.LastPendTime;
+    Opened[window]++;
+}
+
+static void OnPendedNothing( void *pvParameter1, uint32_t ulParameter2 )
+{
+}
+
+static void InitWindow( uint32_t window, bool precise, uint32_t delay )
+{
+    if ( precise == true ) {
+        TimerInitPrecise(&RxWindowTimers[window], Names[window], (void*) (uintptr_t) window,
+                OnRxWindowTimerEvent, false);
+    } else {
+        TimerInit(&RxWindowTimers[window], Names[window], (void*) (uintptr_t) window,
+                OnRxWindowTimerEvent, false);
+    }
+    TimerSetValue(&RxWindowTimers[window], delay);
+    Opened[window] = 0;
+}
+
+static int CompareErrors( const void *a, const void *b )
+{
+    int32_t x = *(const int32_t*) a, y = *(const int32_t*) b;
+
+    return (x > y) - (x < y);
+}
+
+static void Report( const char *name, int32_t *errors )
+{
+    qsort(errors, NB_SAMPLES, sizeof(errors[0]), CompareErrors);
+    printf("  %-20s %7d %7d %7d %7d %7d\n", name, errors[0], errors[NB_SAMPLES / 2],
+            errors[NB_SAMPLES * 9 / 10], errors[NB_SAMPLES * 99 / 100], errors[NB_SAMPLES - 1]);
+}
+
+static void Measure( bool precise, int32_t errors[NB_WINDOWS][NB_SAMPLES] )
+{
+    uint64_t start, requested[NB_WINDOWS];
+    uint32_t n, w;
+
+    for ( n = 0; n < NB_SAMPLES; n++ ) {
+        // Random phase to the tick
+        start = 1000000 + rand() % 1000000;
+        FakeRtosReset(&Load, start);
+        for ( w = 0; w < NB_WINDOWS; w++ ) {
+            InitWindow(w, precise, Delays[w]);
+        }
+        for ( w = 0; w < NB_WINDOWS; w++ ) {
+            requested[w] = FakeRtosGetTime() + Delays[w];
+            TimerStart(&RxWindowTimers[w]);
+        }
+        FakeRtosRunUntil(start + RX_WINDOW_2_DELAY + 10000);
+
+        for ( w = 0; w < NB_WINDOWS; w++ ) {
+            CHECK(Opened[w] == 1);
+            errors[w][n] = (int32_t) (OpenTime[w] - requested[w]);
+            if ( precise == true ) {
+                IsrErrors[w][n] = (int32_t) (IsrTime[w] - requested[w]);
+            }
+        }
+    }
+}
+
+static void TestStaleCallback( void )
+{
+    uint64_t expiry;
+
+    FakeRtosReset(&Load, 1000000);
+    InitWindow(0, true, SHORT_TIMEOUT);
+
+    // Stop between the interrupt and the deferred callback
+    expiry = FakeRtosGetTime() + SHORT_TIMEOUT;
+    TimerStart(&RxWindowTimers[0]);
+    FakeRtosSuspendTimerTask(expiry + 500);
+    FakeRtosRunUntil(expiry + 100);
+    CHECK(FakeRtosStats.PendedCalls == 1);
+    CHECK(Opened[0] == 0);
+    TimerStop(&RxWindowTimers[0]);
+    FakeRtosRunUntil(expiry + 5000);
+    CHECK(Opened[0] == 0);
+
+    // Restart in between, only the new expiry opens the window
+    expiry = FakeRtosGetTime() + SHORT_TIMEOUT;
+    TimerStart(&RxWindowTimers[0]);
+    FakeRtosSuspendTimerTask(expiry + 500);
+    FakeRtosRunUntil(expiry + 100);
+    TimerStop(&RxWindowTimers[0]);
+    expiry = FakeRtosGetTime() + SHORT_TIMEOUT;
+    TimerStart(&RxWindowTimers[0]);
+    FakeRtosRunUntil(expiry + 5000);
+    CHECK(Opened[0] == 1);
+    CHECK(OpenTime[0] >= expiry);
+}
+
+static void TestQueueFull( void )
+{
+    BaseType_t woken;
+    uint64_t expiry;
+    uint32_t i;
+
+    FakeRtosReset(&Load, 1000000);
+    InitWindow(0, true, SHORT_TIMEOUT);
+    expiry = FakeRtosGetTime() + SHORT_TIMEOUT;
+    TimerStart(&RxWindowTimers[0]);
+
+    // The queue is full when the timer expires, the expiry is retried
+    FakeRtosSuspendTimerTask(expiry + 300);
+    FakeRtosSetIsr(true);
+    for ( i = 0; i < configTIMER_QUEUE_LENGTH; i++ ) {
+        xTimerPendFunctionCallFromISR(OnPendedNothing, NULL, 0, &woken);
+    }
+    FakeRtosSetIsr(false);
+    FakeRtosRunUntil(expiry + 5000);
+
+    CHECK(FakeRtosStats.QueueFull > 0);
+    CHECK(FakeRtosStats.Interrupts > 1);
+    CHECK(FakeRtosStats.PendedCalls == configTIMER_QUEUE_LENGTH + 1);
+    CHECK(Opened[0] == 1);
+    CHECK(OpenTime[0] >= expiry + 300);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    uint32_t w;
+    char name[32];
+
+    srand(1);
+    Measure(false, RegularErrors);
+    Measure(true, PreciseErrors);
+    TestStaleCallback();
+    TestQueueFull();
+
+    printf("test-rxwindow: RX window opening error [us], %u samples\n", NB_SAMPLES);
+    printf("  %-20s %7s %7s %7s %7s %7s\n", "", "min", "p50", "p90", "p99", "max");
+    for ( w = 0; w < NB_WINDOWS; w++ ) {
+        snprintf(name, sizeof(name), "RX%u regular", w + 1);
+        Report(name, RegularErrors[w]);
+        snprintf(name, sizeof(name), "RX%u precise, PIT ISR", w + 1);
+        Report(name, IsrErrors[w]);
+        snprintf(name, sizeof(name), "RX%u precise", w + 1);
+        Report(name, PreciseErrors[w]);
+
+        // The tick truncation opens the regular windows up to a tick early
+        CHECK(RegularErrors[w][0] > -1000);
+        // The precise windows are never early and late by less than a tick
+        CHECK(PreciseErrors[w][0] >= 0);
+        CHECK(PreciseErrors[w][NB_SAMPLES - 1] < 1000);
+    }
+
+    printf("test-rxwindow: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/**
+ * \file test-spi.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the SPI cost of the SX1276 driver per packet
+ *
+ * sx1276.c runs against the register file of test/radio/fake-sx127x.c. A
+ * 255 byte LoRa packet is sent and one is received through the DIO0
+ * interrupt, the SPI transactions of both are counted. Built with
+ * SPI_BURST=1 SpiTransfer is a SpiMcuTransfer burst as on the tinyK20 (eDMA),
+ * the STM32L1 boards (DMA) and the FRDM-K22F (polled DSPI). With SPI_BURST=0
+ * it is the SpiInOut loop of the FRDM-KL26Z, which costs what the driver did
+ * before the burst transfers: one transaction per byte. The sent FIFO content
+ * and the received payload are checked on both paths.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include "board.h"
+#include "gpio.h"
+#include "spi.h"
+#include "sx1276/sx1276.h"
+#include "sx1276-board.h"
+#include "fake-sx127x.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define PACKET_SIZE                                 255
+#define RF_FREQUENCY                                868100000
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static RadioEvents_t Events;
+static DioIrqHandler **DioIrqHandlers;
+
+static unsigned TxDone;
+static uint8_t RxPayload[PACKET_SIZE];
+static uint16_t RxSize;
+
+/*******************************************************************************
+ * STUBS OF THE BOARD AND THE TIMERS
+ ******************************************************************************/
+void SX1276IoIrqInit( DioIrqHandler **irqHandlers )
+{
+    DioIrqHandlers = irqHandlers;
+}
+
+uint8_t SX1276GetPaSelect( uint32_t channel )
+{
+    return RF_PACONFIG_PASELECT_PABOOST;
+}
+
+void SX1276SetAntSwLowPower( bool status )
+{
+}
+
+void SX1276SetAntSw( uint8_t rxTx )
+{
+}
+
+bool SX1276CheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+void TimerInit( TimerEvent_t *obj, void (*callback)( void ) )
+{
+}
+
+void TimerStart( TimerEvent_t *obj )
+{
+}
+
+void TimerStop( TimerEvent_t *obj )
+{
+}
+
+void TimerSetValue( TimerEvent_t *obj, uint32_t value )
+{
+}
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return 0;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void OnTxDone( void )
+{
+    TxDone++;
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    memcpy1(RxPayload, payload, size);
+    RxSize = size;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    uint8_t payload[PACKET_SIZE];
+    uint32_t transactions, bytes, i;
+    FakeSx127xStats_t tx, rx;
+
+    for ( i = 0; i < PACKET_SIZE; i++ ) {
+        payload[i] = (uint8_t) (i * 13 + 1);
+    }
+
+    FakeSx127xReset();
+    SX1276.Spi.Spi = &SX1276;
+    SX1276.Spi.Nss.pin = (PinNames) FakeSx127xGetNssPin();
+    Events.TxDone = OnTxDone;
+    Events.RxDone = OnRxDone;
+    SX1276Init(&Events);
+    SX1276Reset();
+    CHECK(DioIrqHandlers != NULL);
+    SX1276SetModem(MODEM_LORA);
+    SX1276SetChannel(RF_FREQUENCY);
+    SX1276SetTxConfig(MODEM_LORA, 14, 0, 0, 7, 1, 8, false, true, false, 0, false, 3000);
+    SX1276SetRxConfig(MODEM_LORA, 0, 7, 1, 0, 8, 5, false, 0, true, false, 0, true, false);
+
+    // Send: configuration, FIFO and Tx mode
+    transactions = FakeSx127xStats.Transactions;
+    bytes = FakeSx127xStats.Bytes;
+    SX1276Send(payload, PACKET_SIZE);
+    tx.Transactions = FakeSx127xStats.Transactions - transactions;
+    tx.Bytes = FakeSx127xStats.Bytes - bytes;
+    CHECK(memcmp(FakeSx127xFifo, payload, PACKET_SIZE) == 0);
+    CHECK(FakeSx127xRegs[REG_LR_PAYLOADLENGTH] == PACKET_SIZE);
+    CHECK((FakeSx127xRegs[REG_OPMODE] & ~RF_OPMODE_MASK) == RF_OPMODE_TRANSMITTER);
+
+    FakeSx127xRegs[REG_LR_IRQFLAGS] = RFLR_IRQFLAGS_TXDONE;
+    DioIrqHandlers[0]();
+    CHECK(TxDone == 1);
+
+    // Receive: Rx mode, then RxDone with a full FIFO
+    SX1276SetRx(0);
+    CHECK((FakeSx127xRegs[REG_OPMODE] & ~RF_OPMODE_MASK) == RFLR_OPMODE_RECEIVER_SINGLE);
+    for ( i = 0; i < PACKET_SIZE; i++ ) {
+        FakeSx127xFifo[i] = (uint8_t) (i * 7 + 3);
+    }
+    FakeSx127xRegs[REG_LR_IRQFLAGS] = RFLR_IRQFLAGS_RXDONE;
+    FakeSx127xRegs[REG_LR_RXNBBYTES] = PACKET_SIZE;
+    FakeSx127xRegs[REG_LR_FIFORXCURRENTADDR] = 0;
+    FakeSx127xRegs[REG_LR_PKTSNRVALUE] = 20;
+    FakeSx127xRegs[REG_LR_PKTRSSIVALUE] = 60;
+
+    transactions = FakeSx127xStats.Transactions;
+    bytes = FakeSx127xStats.Bytes;
+    DioIrqHandlers[0]();
+    rx.Transactions = FakeSx127xStats.Transactions - transactions;
+    rx.Bytes = FakeSx127xStats.Bytes - bytes;
+    CHECK(RxSize == PACKET_SIZE);
+    CHECK(memcmp(RxPayload, FakeSx127xFifo, PACKET_SIZE) == 0);
+    CHECK(FakeSx127xRegs[REG_LR_IRQFLAGS] == 0);
+
+#if defined(SPI_MCU_TRANSFER)
+    // The FIFO is one burst, the remaining accesses are short
+    CHECK(tx.Transactions < 32);
+    CHECK(rx.Transactions < 32);
+#else
+    // One transaction per byte
+    CHECK(tx.Transactions == tx.Bytes);
+    CHECK(rx.Transactions == rx.Bytes);
+#endif
+
+    printf("test-spi (SPI_BURST %d): %u byte packet, SPI transactions (bytes)\n", SPI_BURST,
+            PACKET_SIZE);
+    printf("  send     %5u (%u)\n", tx.Transactions, tx.Bytes);
+    printf("  receive  %5u (%u)\n", rx.Transactions, rx.Bytes);
+    printf("test-spi (SPI_BURST %d): %s\n", SPI_BURST, (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
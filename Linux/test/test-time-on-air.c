@@ -0,0 +1,178 @@
+/**
+ * \file test-time-on-air.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the integer time on air calculator
+ *
+ * Compares TimeOnAirLoRa and TimeOnAirFsk with the floating point formulas
+ * the SX1276/SX1272 drivers used before. The LoRa check is exhaustive:
+ * SF6..12 x 3 bandwidths x 4 coding rates x header x CRC x LDRO x 6 preamble
+ * lengths x payload sizes 0..255, i.e. 1032192 cases. The inverse queries
+ * are checked against the forward functions.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include "time-on-air.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_LORA_CASES                               1032192
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static const uint16_t PreambleLengths[] = { 6, 8, 12, 16, 100, 65535 };
+
+static const uint32_t FskDatarates[] = { 1200, 2400, 4800, 9600, 19200, 38400, 50000, 76800,
+        100000, 150000, 300000 };
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*! SX1276GetTimeOnAir LoRa branch before the integer rewrite */
+static uint32_t ReferenceLoRa( const TimeOnAirLoRa_t *p, uint8_t pktLen )
+{
+    static const double bandwidths[] = { 125e3, 250e3, 500e3 };
+    double rs = bandwidths[p->Bandwidth] / (1 << p->Datarate);
+    double ts = 1 / rs;
+    double tPreamble = (p->PreambleLen + 4.25) * ts;
+    double tmp = ceil(
+            (8 * pktLen - 4 * p->Datarate + 28 + 16 * p->CrcOn - (p->FixLen ? 20 : 0))
+                    / (double) (4 * p->Datarate - ((p->LowDatarateOptimize > 0) ? 8 : 0)))
+            * (p->Coderate + 4);
+    double nPayload = 8 + ((tmp > 0) ? tmp : 0);
+    double tPayload = nPayload * ts;
+
+    return floor((tPreamble + tPayload) * 1e6 + 0.999);
+}
+
+/*! SX1276GetTimeOnAir FSK branch before the integer rewrite */
+static uint32_t ReferenceFsk( const TimeOnAirFsk_t *p, uint8_t pktLen )
+{
+    return round(
+            (8 * (p->PreambleLen + p->SyncWordSize + ((p->FixLen == true) ? 0.0 : 1.0)
+                    + ((p->AddrFilterOn == true) ? 1.0 : 0) + pktLen
+                    + ((p->CrcOn == true) ? 2.0 : 0)) / p->Datarate) * 1e6);
+}
+
+static void TestLoRa( void )
+{
+    TimeOnAirLoRa_t p;
+    unsigned cases = 0, mismatches = 0, inverse = 0;
+    uint8_t options, pre;
+    uint16_t len;
+    uint32_t toa;
+    int16_t max;
+
+    for ( p.Datarate = TIME_ON_AIR_LORA_SF_MIN; p.Datarate <= TIME_ON_AIR_LORA_SF_MAX;
+            p.Datarate++ ) {
+        for ( p.Bandwidth = 0; p.Bandwidth < TIME_ON_AIR_LORA_BW_COUNT; p.Bandwidth++ ) {
+            for ( p.Coderate = 1; p.Coderate <= 4; p.Coderate++ ) {
+                for ( options = 0; options < 8; options++ ) {
+                    p.FixLen = (options & 0x01) != 0;
+                    p.CrcOn = (options & 0x02) != 0;
+                    p.LowDatarateOptimize = (options & 0x04) != 0;
+                    for ( pre = 0; pre < sizeof(PreambleLengths) / sizeof(PreambleLengths[0]);
+                            pre++ ) {
+                        p.PreambleLen = PreambleLengths[pre];
+                        for ( len = 0; len <= TIME_ON_AIR_MAX_PAYLOAD; len++ ) {
+                            toa = TimeOnAirLoRa(&p, (uint8_t) len);
+                            if ( toa != ReferenceLoRa(&p, (uint8_t) len) ) {
+                                if ( mismatches++ < 10 ) {
+                                    printf("LoRa SF%u BW%u CR%u opt %u pre %u len %u: %u != %u\n",
+                                            p.Datarate, p.Bandwidth, p.Coderate, options,
+                                            p.PreambleLen, len, toa,
+                                            ReferenceLoRa(&p, (uint8_t) len));
+                                }
+                            }
+                            /* The largest payload fitting in the exact time on air */
+                            max = TimeOnAirLoRaMaxPayload(&p, toa);
+                            if ( (max < (int16_t) len)
+                                    || ((max < TIME_ON_AIR_MAX_PAYLOAD)
+                                            && (TimeOnAirLoRa(&p, (uint8_t) (max + 1)) <= toa)) ) {
+                                inverse++;
+                            }
+                            cases++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CHECK(cases == NB_LORA_CASES);
+    CHECK(mismatches == 0);
+    CHECK(inverse == 0);
+    printf("LoRa: %u cases, %u mismatches, %u inverse errors\n", cases, mismatches, inverse);
+}
+
+static void TestFsk( void )
+{
+    TimeOnAirFsk_t p;
+    unsigned cases = 0, mismatches = 0, inverse = 0;
+    uint8_t rate, options;
+    uint16_t len;
+    uint32_t toa;
+    int16_t max;
+
+    p.PreambleLen = 5;
+    for ( rate = 0; rate < sizeof(FskDatarates) / sizeof(FskDatarates[0]); rate++ ) {
+        p.Datarate = FskDatarates[rate];
+        for ( p.SyncWordSize = 1; p.SyncWordSize <= 8; p.SyncWordSize++ ) {
+            for ( options = 0; options < 8; options++ ) {
+                p.FixLen = (options & 0x01) != 0;
+                p.AddrFilterOn = (options & 0x02) != 0;
+                p.CrcOn = (options & 0x04) != 0;
+                for ( len = 0; len <= TIME_ON_AIR_MAX_PAYLOAD; len++ ) {
+                    toa = TimeOnAirFsk(&p, (uint8_t) len);
+                    if ( toa != ReferenceFsk(&p, (uint8_t) len) ) {
+                        mismatches++;
+                    }
+                    max = TimeOnAirFskMaxPayload(&p, toa);
+                    if ( (max < (int16_t) len)
+                            || ((max < TIME_ON_AIR_MAX_PAYLOAD)
+                                    && (TimeOnAirFsk(&p, (uint8_t) (max + 1)) <= toa)) ) {
+                        inverse++;
+                    }
+                    cases++;
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(inverse == 0);
+    printf("FSK: %u cases, %u mismatches, %u inverse errors\n", cases, mismatches, inverse);
+}
+
+static void TestNoPayload( void )
+{
+    TimeOnAirLoRa_t lora = { 12, 0, 1, 8, false, true, true };
+    TimeOnAirFsk_t fsk = { 50000, 5, 3, false, false, true };
+
+    CHECK(TimeOnAirLoRaMaxPayload(&lora, TimeOnAirLoRa(&lora, 0) - 1) == TIME_ON_AIR_NO_PAYLOAD);
+    CHECK(TimeOnAirFskMaxPayload(&fsk, TimeOnAirFsk(&fsk, 0) - 1) == TIME_ON_AIR_NO_PAYLOAD);
+    CHECK(TimeOnAirLoRaMaxPayload(&lora, UINT32_MAX) == TIME_ON_AIR_MAX_PAYLOAD);
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    TestLoRa();
+    TestFsk();
+    TestNoPayload();
+
+    printf("test-time-on-air: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,422 @@
+/**
+ * \file test-timer.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the timer heap of src/system/timer.c
+ *
+ * timer.c runs on a simulated RTC which fires the armed timeout exactly when
+ * it is due. Random TimerSetValue/TimerStart/TimerStop/TimerReset operations
+ * on more timers than the former heap array held are checked against a
+ * reference model: every timer has to fire once per start, not before its
+ * expiry and at most the minimum RTC timeout after it, and a stopped timer
+ * must not fire. A heap consistency walk after every operation checks the
+ * links and the heap order.
+ *
+ * The second part compares the time spent in TimerStart/TimerStop, the part
+ * run with the interrupts disabled, against the delta list timer.c used
+ * before, for the worst case of both: a start at the head of the heap and
+ * the removal of the heap root against a start at the end of the list and
+ * the removal of the list tail.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "board.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NB_TIMERS                                   96
+#define NB_OPERATIONS                               200000
+#define MAX_TIMEOUT                                 5000
+#define MAX_STEP                                    60
+#define RTC_MIN_TIMEOUT                             3
+
+/* Worst case IRQ-off comparison */
+#define NB_PROBE_RUNS                               200
+#define MAX_PROBE_TIMERS                            1024
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Reference model of a timer */
+typedef struct {
+    bool Running;
+    TimerTime_t Expiry;
+} Model_t;
+
+/*! Timer of the delta list timer.c used before the heap */
+typedef struct ListTimer_s {
+    uint32_t Timestamp;
+    uint32_t ReloadValue;
+    struct ListTimer_s *Next;
+} ListTimer_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+/* Simulated RTC */
+static TimerTime_t Now;
+static TimerTime_t ArmedAt;
+static uint32_t ArmedTimeout;
+static bool Armed;
+
+static TimerEvent_t Timers[MAX_PROBE_TIMERS];
+static Model_t Models[NB_TIMERS];
+static unsigned Fired;
+
+static ListTimer_t ListTimers[MAX_PROBE_TIMERS];
+static ListTimer_t *ListHead;
+
+/*******************************************************************************
+ * STUBS OF THE RTC AND THE HARDWARE TIMER
+ ******************************************************************************/
+uint32_t RtcGetMinimumTimeout( void )
+{
+    return RTC_MIN_TIMEOUT;
+}
+
+void RtcSetTimeout( uint32_t timeout )
+{
+    ArmedAt = Now;
+    ArmedTimeout = timeout;
+    Armed = true;
+}
+
+TimerTime_t RtcGetTimerValue( void )
+{
+    return Now;
+}
+
+uint32_t RtcGetTimerElapsedTime( void )
+{
+    return (uint32_t) (Now - ArmedAt);
+}
+
+void RtcEnterLowPowerStopMode( void )
+{
+}
+
+uint32_t TimerHwGetMinimumTimeout( void )
+{
+    return RTC_MIN_TIMEOUT;
+}
+
+void TimerHwStart( uint32_t timeout )
+{
+    RtcSetTimeout(timeout);
+}
+
+TimerTime_t TimerHwGetTime( void )
+{
+    return Now;
+}
+
+TimerTime_t TimerHwGetElapsedTime( void )
+{
+    return RtcGetTimerElapsedTime();
+}
+
+void TimerHwEnterLowPowerStopMode( void )
+{
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint64_t Cycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+static void OnTimer( void )
+{
+    Fired++;
+}
+
+/*! Checks the links and the order of the heap below obj, returns its size */
+static unsigned CheckHeap( const TimerEvent_t *obj, const TimerEvent_t *parent )
+{
+    unsigned size = 1;
+
+    if ( obj == NULL ) {
+        return 0;
+    }
+    CHECK(obj->IsRunning == true);
+    CHECK(obj->Parent == parent);
+    if ( parent != NULL ) {
+        CHECK(parent->Expiry <= obj->Expiry);
+    }
+    CHECK((obj->Left != NULL) || (obj->Right == NULL));
+    size += CheckHeap(obj->Left, obj);
+    size += CheckHeap(obj->Right, obj);
+    return size;
+}
+
+/*! Checks the timers against the model and the heap structure */
+static void CheckTimers( void )
+{
+    const TimerEvent_t *root = NULL;
+    unsigned running = 0, i;
+
+    for ( i = 0; i < NB_TIMERS; i++ ) {
+        CHECK(Timers[i].IsRunning == Models[i].Running);
+        if ( Models[i].Running == true ) {
+            running++;
+            if ( Timers[i].Parent == NULL ) {
+                CHECK(root == NULL);
+                root = &Timers[i];
+            }
+        }
+    }
+    CHECK(CheckHeap(root, NULL) == running);
+    CHECK((running == 0) || (Armed == true));
+}
+
+/*! Advances the simulated time, firing the RTC timeout when it is due */
+static void Advance( TimerTime_t step )
+{
+    TimerTime_t end = Now + step;
+    unsigned expected, i;
+
+    while ( (Armed == true) && (ArmedAt + ArmedTimeout <= end) ) {
+        Now = ArmedAt + ArmedTimeout;
+        Armed = false;
+
+        expected = 0;
+        for ( i = 0; i < NB_TIMERS; i++ ) {
+            if ( (Models[i].Running == true) && (Models[i].Expiry <= Now) ) {
+                CHECK(Now - Models[i].Expiry <= RTC_MIN_TIMEOUT);
+                Models[i].Running = false;
+                expected++;
+            }
+        }
+        Fired = 0;
+        TimerIrqHandler();
+        CHECK(Fired == expected);
+        CheckTimers();
+    }
+    Now = end;
+
+    for ( i = 0; i < NB_TIMERS; i++ ) {
+        CHECK((Models[i].Running == false) || (Models[i].Expiry + RTC_MIN_TIMEOUT >= Now));
+    }
+}
+
+static void SetValue( unsigned i, uint32_t value )
+{
+    TimerSetValue(&Timers[i], value);
+    CHECK(Timers[i].ReloadValue == ((value < RTC_MIN_TIMEOUT) ? RTC_MIN_TIMEOUT : value));
+    Models[i].Running = false;
+}
+
+static void Start( unsigned i )
+{
+    TimerStart(&Timers[i]);
+    if ( Models[i].Running == false ) {
+        Models[i].Running = true;
+        Models[i].Expiry = Now + Timers[i].ReloadValue;
+    }
+}
+
+static void Stop( unsigned i )
+{
+    TimerStop(&Timers[i]);
+    Models[i].Running = false;
+}
+
+static unsigned TestRandomOperations( void )
+{
+    unsigned i, n, maxRunning = 0, running;
+
+    for ( i = 0; i < NB_TIMERS; i++ ) {
+        TimerInit(&Timers[i], OnTimer);
+        SetValue(i, 1 + rand() % MAX_TIMEOUT);
+    }
+
+    for ( n = 0; n < NB_OPERATIONS; n++ ) {
+        Advance(rand() % MAX_STEP);
+
+        i = rand() % NB_TIMERS;
+        switch ( rand() % 4 ) {
+            case 0:
+                SetValue(i, rand() % MAX_TIMEOUT);
+                break;
+            case 1:
+            case 2:
+                Start(i);
+                break;
+            default:
+                if ( rand() % 2 ) {
+                    Stop(i);
+                } else {
+                    TimerReset(&Timers[i]);
+                    Models[i].Running = false;
+                    Start(i);
+                }
+                break;
+        }
+        CheckTimers();
+
+        running = 0;
+        for ( i = 0; i < NB_TIMERS; i++ ) {
+            running += Models[i].Running;
+        }
+        if ( running > maxRunning ) maxRunning = running;
+    }
+
+    // All timers at once, several with the same expiry, then let them expire
+    for ( i = 0; i < NB_TIMERS; i++ ) {
+        SetValue(i, RTC_MIN_TIMEOUT + (i % 7) * 10);
+        Start(i);
+    }
+    CheckTimers();
+    Advance(MAX_TIMEOUT);
+    for ( i = 0; i < NB_TIMERS; i++ ) {
+        CHECK(Timers[i].IsRunning == false);
+    }
+    CHECK(Armed == false);
+    return maxRunning;
+}
+
+/*! TimerStart of the delta list, TimerExists included */
+static void ListStart( ListTimer_t *obj, uint32_t remainingTime )
+{
+    ListTimer_t *prev, *cur;
+    uint32_t aggregated, aggregatedNext;
+
+    for ( cur = ListHead; cur != NULL; cur = cur->Next ) {
+        if ( cur == obj ) return;
+    }
+    obj->Timestamp = obj->ReloadValue;
+    if ( (ListHead == NULL) || (obj->Timestamp < remainingTime) ) {
+        if ( ListHead != NULL ) ListHead->Timestamp = remainingTime - obj->Timestamp;
+        obj->Next = ListHead;
+        ListHead = obj;
+        return;
+    }
+    prev = ListHead;
+    cur = ListHead->Next;
+    aggregated = remainingTime;
+    aggregatedNext = (cur != NULL) ? remainingTime + cur->Timestamp : 0;
+    while ( (cur != NULL) && (aggregatedNext <= obj->Timestamp) ) {
+        prev = cur;
+        cur = cur->Next;
+        aggregated = aggregatedNext;
+        if ( cur != NULL ) aggregatedNext += cur->Timestamp;
+    }
+    obj->Timestamp -= aggregated;
+    if ( cur != NULL ) cur->Timestamp -= obj->Timestamp;
+    prev->Next = obj;
+    obj->Next = cur;
+}
+
+/*! TimerStop of the delta list */
+static void ListStop( ListTimer_t *obj )
+{
+    ListTimer_t *prev = ListHead, *cur = ListHead;
+
+    if ( ListHead == obj ) {
+        ListHead = obj->Next;
+        if ( ListHead != NULL ) ListHead->Timestamp += obj->Timestamp;
+        return;
+    }
+    while ( cur != NULL ) {
+        if ( cur == obj ) {
+            prev->Next = cur->Next;
+            if ( cur->Next != NULL ) cur->Next->Timestamp += obj->Timestamp;
+            break;
+        }
+        prev = cur;
+        cur = cur->Next;
+    }
+}
+
+/*! Best of NB_PROBE_RUNS start and stop cycles of the worst case probe */
+static void MeasureWorstCase( unsigned nbTimers, uint64_t *heap, uint64_t *list )
+{
+    TimerEvent_t *probe = &Timers[nbTimers];
+    ListTimer_t *listProbe = &ListTimers[nbTimers];
+    uint64_t start, cycles;
+    unsigned i, run;
+
+    for ( i = 0; i < nbTimers; i++ ) {
+        TimerInit(&Timers[i], OnTimer);
+        TimerSetValue(&Timers[i], 1000 + rand() % MAX_TIMEOUT);
+        TimerStart(&Timers[i]);
+        ListTimers[i].ReloadValue = 1000 + rand() % MAX_TIMEOUT;
+        ListStart(&ListTimers[i], (ListHead != NULL) ? ListHead->Timestamp : 0);
+    }
+
+    // Heap: start at the root, stop of the root
+    TimerInit(probe, OnTimer);
+    TimerSetValue(probe, RTC_MIN_TIMEOUT);
+    *heap = UINT64_MAX;
+    for ( run = 0; run < NB_PROBE_RUNS; run++ ) {
+        start = Cycles();
+        TimerStart(probe);
+        TimerStop(probe);
+        cycles = Cycles() - start;
+        if ( cycles < *heap ) *heap = cycles;
+    }
+
+    // List: start at the tail, stop of the tail
+    listProbe->ReloadValue = 1000 + MAX_TIMEOUT;
+    *list = UINT64_MAX;
+    for ( run = 0; run < NB_PROBE_RUNS; run++ ) {
+        start = Cycles();
+        ListStart(listProbe, ListHead->Timestamp);
+        ListStop(listProbe);
+        cycles = Cycles() - start;
+        if ( cycles < *list ) *list = cycles;
+    }
+
+    for ( i = 0; i < nbTimers; i++ ) {
+        TimerStop(&Timers[i]);
+    }
+    ListHead = NULL;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( void )
+{
+    static const unsigned nbTimers[] = { 8, 32, 128, MAX_PROBE_TIMERS - 1 };
+    uint64_t heap, list;
+    unsigned maxRunning, i;
+
+    srand(1);
+    maxRunning = TestRandomOperations();
+    printf("test-timer: %u random operations on %u timers, up to %u running\n", NB_OPERATIONS,
+            NB_TIMERS, maxRunning);
+    CHECK(maxRunning > 32);
+
+    printf("test-timer: worst case TimerStart + TimerStop, cycles with IRQs off\n");
+    printf("  %8s %10s %10s\n", "running", "heap", "list");
+    for ( i = 0; i < sizeof(nbTimers) / sizeof(nbTimers[0]); i++ ) {
+        MeasureWorstCase(nbTimers[i], &heap, &list);
+        printf("  %8u %10llu %10llu\n", nbTimers[i], (unsigned long long) heap,
+                (unsigned long long) list);
+    }
+
+    printf("test-timer: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+/**
+ * \file test-uplink.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host test of the LoRaMac uplink completion latency
+ *
+ * The latency from LoRaMacSendFrame / LoRaMacSendConfirmedFrame to the
+ * MacEvent notification is measured on the simulated medium for the MAC with
+ * the event driven state evaluation and for the MAC polling its state every
+ * MAC_STATE_CHECK_POLL_PERIOD (1 s) as it did before. Both MACs are the same
+ * LoRaMac.c, built into two copies of the node (uplink-node.c).
+ *
+ * - Unconfirmed uplinks sent once and with NbRep 3.
+ * - Confirmed uplinks with 4 transmissions at most, acknowledged in RX1 of
+ *   the first or the third transmission or not at all.
+ *
+ * Both MACs have to send the same number of transmissions with the same
+ * outcome, the event driven one has to notify earlier.
+ *
+ * Usage: test-uplink [event-node.so poll-node.so]
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sim-medium.h"
+#include "LoRaMac.h"
+#include "LoRaMacCrypto.h"
+#include "uplink-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Uplinks per case and MAC */
+#define NB_RUNS                                     10
+
+/*! Idle time between two uplinks [us] */
+#define RUN_GAP                                     5000000
+
+/*! Time after which an uplink is considered lost [us] */
+#define RUN_TIMEOUT                                 60000000
+
+#define DEV_ADDR                                    0x01000000
+#define DATARATE                                    5
+
+/*! Gateway channels and spreading factors, see main.c of the simulation */
+#define GW_NB_CHANNELS                              3
+#define GW_CHANNELS                                 { 868100000, 868300000, 868500000 }
+#define GW_SF_MIN                                   7
+#define GW_SF_MAX                                   12
+#define GW_NB_RECEIVERS                             (GW_NB_CHANNELS * (GW_SF_MAX - GW_SF_MIN + 1))
+#define GW_TX_POWER                                 14
+
+/*! MHDR of the frames */
+#define MTYPE_UNCONFIRMED_UP                        2
+#define MTYPE_CONFIRMED_UP                          4
+#define MHDR_UNCONFIRMED_DOWN                       0x60
+#define FCTRL_ACK                                   0x20
+
+/*! Downlink acknowledging an uplink: MHDR, DevAddr, FCtrl, FCnt, MIC */
+#define DOWNLINK_SIZE                               (1 + 4 + 1 + 2 + 4)
+
+/*! Name of the node shared objects next to the test executable */
+#define EVENT_NODE_LIBRARY                          "libuplink-node-event.so"
+#define POLL_NODE_LIBRARY                           "libuplink-node-poll.so"
+
+#define CHECK( cond )                               do { if ( !(cond) ) { \
+                                                        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                                        Failures++; } } while ( 0 )
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node instance, the entry points of its shared object */
+typedef struct {
+    void *Handle;
+    void (*Init)( const UplinkNodeConfig_t *config );
+    uint8_t (*Send)( uint8_t nbRep, uint8_t retries );
+    bool (*GetResult)( UplinkNodeResult_t *result );
+    uint64_t (*GetNextEventTime)( void );
+    void (*Process)( void );
+} Node_t;
+
+/*! Uplink case */
+typedef struct {
+    const char *Name;
+    uint8_t NbRep;              //! Transmissions of an unconfirmed uplink
+    uint8_t Retries;            //! Transmissions of a confirmed uplink, 0: unconfirmed
+    uint8_t AckAttempt;         //! Transmission acknowledged by the gateway, 0: none
+    uint8_t NbUplinks;          //! Expected transmissions
+} Case_t;
+
+/*! Latency of the uplinks of a case [us] */
+typedef struct {
+    uint64_t Sum;
+    uint64_t Max;
+    unsigned Count;
+} Latency_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static unsigned Failures = 0;
+
+static const Case_t Cases[] = {
+    { "unconfirmed, NbRep 1", 1, 0, 0, 1 },
+    { "unconfirmed, NbRep 3", 3, 0, 0, 3 },
+    { "confirmed, ack 1st", 1, 4, 1, 1 },
+    { "confirmed, ack 3rd", 1, 4, 3, 3 },
+    { "confirmed, no ack", 1, 4, 0, 4 },
+};
+#define NB_CASES                                    (sizeof(Cases) / sizeof(Cases[0]))
+
+static SimMediumModulation_t GwModulations[GW_NB_RECEIVERS];
+static int16_t GwTxNode;
+
+/*! Uplinks received by the gateway during the current run */
+static uint8_t GwUplinks;
+static uint8_t GwAckAttempt;
+
+/*! Pending acknowledge */
+static uint8_t GwDownlink[DOWNLINK_SIZE];
+static SimMediumModulation_t GwDownlinkModulation;
+static uint64_t GwDownlinkTime = SIM_MEDIUM_TIME_NEVER;
+static uint16_t GwDownlinkCounter = 0;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool LoadNode( Node_t *node, const char *library );
+static void DefaultLibraryPath( char *path, size_t size, const char *name );
+static void GwOnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+static void GwInit( void );
+static void Advance( Node_t *node, uint64_t until );
+static bool RunUplink( Node_t *node, const Case_t *c, uint64_t *latency );
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( int argc, char **argv )
+{
+    char libraries[2][4096];
+    Node_t nodes[2];
+    Latency_t latency[NB_CASES][2];
+    UplinkNodeConfig_t config;
+    uint64_t t;
+    unsigned c, m, run;
+
+    if ( argc > 2 ) {
+        snprintf(libraries[0], sizeof(libraries[0]), "%s", argv[1]);
+        snprintf(libraries[1], sizeof(libraries[1]), "%s", argv[2]);
+    } else {
+        DefaultLibraryPath(libraries[0], sizeof(libraries[0]), EVENT_NODE_LIBRARY);
+        DefaultLibraryPath(libraries[1], sizeof(libraries[1]), POLL_NODE_LIBRARY);
+    }
+
+    SimMediumInit(1);
+    GwInit();
+
+    memset(&config, 0, sizeof(config));
+    config.DevAddr = DEV_ADDR;
+    config.X = 100;
+    config.Datarate = DATARATE;
+    config.Seed = 1;
+    for ( m = 0; m < 2; m++ ) {
+        if ( !LoadNode(&nodes[m], libraries[m]) ) {
+            return 1;
+        }
+        nodes[m].Init(&config);
+    }
+
+    memset(latency, 0, sizeof(latency));
+    for ( c = 0; c < NB_CASES; c++ ) {
+        for ( m = 0; m < 2; m++ ) {
+            for ( run = 0; run < NB_RUNS; run++ ) {
+                if ( RunUplink(&nodes[m], &Cases[c], &t) ) {
+                    latency[c][m].Sum += t;
+                    latency[c][m].Max = (t > latency[c][m].Max) ? t : latency[c][m].Max;
+                    latency[c][m].Count++;
+                }
+            }
+            CHECK(latency[c][m].Count == NB_RUNS);
+        }
+        CHECK(latency[c][0].Sum < latency[c][1].Sum);
+    }
+
+    printf("test-uplink: completion latency [ms], mean / max of %u uplinks\n", NB_RUNS);
+    printf("  %-22s %8s %17s %17s\n", "uplink", "tx", "event driven", "1 s poll");
+    for ( c = 0; c < NB_CASES; c++ ) {
+        printf("  %-22s %8u", Cases[c].Name, Cases[c].NbUplinks);
+        for ( m = 0; m < 2; m++ ) {
+            t = (latency[c][m].Count > 0) ? latency[c][m].Sum / latency[c][m].Count : 0;
+            printf("     %5llu / %5llu", (unsigned long long) (t / 1000),
+                    (unsigned long long) (latency[c][m].Max / 1000));
+        }
+        printf("\n");
+    }
+    printf("test-uplink: %s\n", (Failures == 0) ? "OK" : "FAILED");
+    return (Failures == 0) ? 0 : 1;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static bool RunUplink( Node_t *node, const Case_t *c, uint64_t *latency )
+{
+    UplinkNodeResult_t result;
+    uint64_t start = SimMediumGetTime();
+
+    GwUplinks = 0;
+    GwAckAttempt = c->AckAttempt;
+    GwDownlinkTime = SIM_MEDIUM_TIME_NEVER;
+
+    CHECK(node->Send(c->NbRep, c->Retries) == 0);
+    while ( !node->GetResult(&result) ) {
+        if ( SimMediumGetTime() > start + RUN_TIMEOUT ) {
+            CHECK(false);
+            return false;
+        }
+        Advance(node, start + RUN_TIMEOUT + 1);
+    }
+    *latency = result.Time - start;
+
+    CHECK(GwUplinks == c->NbUplinks);
+    CHECK(result.TxAckReceived == (c->AckAttempt != 0));
+    if ( c->Retries > 0 ) {
+        CHECK(result.TxNbRetries == c->NbUplinks);
+    }
+
+    // Let the node settle before the next uplink
+    while ( SimMediumGetTime() < result.Time + RUN_GAP ) {
+        Advance(node, result.Time + RUN_GAP);
+    }
+    return true;
+}
+
+/*! Processes the next event of the medium, the gateway or the node, at most until the given time */
+static void Advance( Node_t *node, uint64_t until )
+{
+    uint64_t next = SimMediumGetNextEventTime(), t;
+
+    t = node->GetNextEventTime();
+    next = (t < next) ? t : next;
+    next = (GwDownlinkTime < next) ? GwDownlinkTime : next;
+    next = (until < next) ? until : next;
+
+    SimMediumProcess(next);
+    if ( GwDownlinkTime <= next ) {
+        GwDownlinkTime = SIM_MEDIUM_TIME_NEVER;
+        SimMediumSend(GwTxNode, &GwDownlinkModulation, GW_TX_POWER, GwDownlink, DOWNLINK_SIZE);
+    }
+    node->Process();
+}
+
+static void GwOnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    static const uint8_t nwkSKey[] = UPLINK_NODE_NWKSKEY;
+    SimMediumModulation_t *modulation = (SimMediumModulation_t *) context;
+    uint8_t mType = payload[0] >> 5;
+    uint32_t mic;
+
+    if ( (mType != MTYPE_UNCONFIRMED_UP) && (mType != MTYPE_CONFIRMED_UP) ) {
+        return;
+    }
+    GwUplinks++;
+    if ( (mType != MTYPE_CONFIRMED_UP) || (GwUplinks != GwAckAttempt) ) {
+        return;
+    }
+
+    // Acknowledge in RX1: same channel and datarate, inverted IQ
+    GwDownlink[0] = MHDR_UNCONFIRMED_DOWN;
+    GwDownlink[1] = (uint8_t) DEV_ADDR;
+    GwDownlink[2] = (uint8_t) (DEV_ADDR >> 8);
+    GwDownlink[3] = (uint8_t) (DEV_ADDR >> 16);
+    GwDownlink[4] = (uint8_t) (DEV_ADDR >> 24);
+    GwDownlink[5] = FCTRL_ACK;
+    GwDownlink[6] = (uint8_t) GwDownlinkCounter;
+    GwDownlink[7] = (uint8_t) (GwDownlinkCounter >> 8);
+    LoRaMacComputeMic(GwDownlink, DOWNLINK_SIZE - 4, nwkSKey, DEV_ADDR, DOWN_LINK,
+            GwDownlinkCounter, &mic);
+    GwDownlink[8] = (uint8_t) mic;
+    GwDownlink[9] = (uint8_t) (mic >> 8);
+    GwDownlink[10] = (uint8_t) (mic >> 16);
+    GwDownlink[11] = (uint8_t) (mic >> 24);
+    GwDownlinkCounter++;
+
+    GwDownlinkModulation = *modulation;
+    GwDownlinkModulation.IqInverted = true;
+    GwDownlinkModulation.CrcOn = false;
+    GwDownlinkTime = SimMediumGetTime() + RECEIVE_DELAY1;
+}
+
+static void GwInit( void )
+{
+    static const SimMediumEvents_t events = { NULL, GwOnRxDone, NULL, NULL, NULL };
+    static const SimMediumEvents_t txEvents = { NULL, NULL, NULL, NULL, NULL };
+    const uint32_t channels[GW_NB_CHANNELS] = GW_CHANNELS;
+    SimMediumModulation_t *modulation;
+    uint8_t ch, sf;
+    uint16_t i = 0;
+
+    for ( ch = 0; ch < GW_NB_CHANNELS; ch++ ) {
+        for ( sf = GW_SF_MIN; sf <= GW_SF_MAX; sf++ ) {
+            modulation = &GwModulations[i++];
+            memset(modulation, 0, sizeof(SimMediumModulation_t));
+            modulation->Modem = MODEM_LORA;
+            modulation->Frequency = channels[ch];
+            modulation->Bandwidth = 125000;
+            modulation->Datarate = sf;
+            modulation->Coderate = 1;
+            modulation->PreambleLen = 8;
+            modulation->CrcOn = true;
+            modulation->LowDatarateOptimize = (sf >= 11);
+            SimMediumRx(SimMediumAttach(&events, modulation, 0, 0), modulation, 0, true);
+        }
+    }
+    GwTxNode = SimMediumAttach(&txEvents, NULL, 0, 0);
+}
+
+static bool LoadNode( Node_t *node, const char *library )
+{
+    node->Handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+    if ( node->Handle == NULL ) {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    node->Init = (void (*)( const UplinkNodeConfig_t * )) dlsym(node->Handle, "UplinkNodeInit");
+    node->Send = (uint8_t (*)( uint8_t, uint8_t )) dlsym(node->Handle, "UplinkNodeSend");
+    node->GetResult = (bool (*)( UplinkNodeResult_t * )) dlsym(node->Handle, "UplinkNodeGetResult");
+    node->GetNextEventTime = (uint64_t (*)( void )) dlsym(node->Handle,
+            "UplinkNodeGetNextEventTime");
+    node->Process = (void (*)( void )) dlsym(node->Handle, "UplinkNodeProcess");
+
+    if ( (node->Init == NULL) || (node->Send == NULL) || (node->GetResult == NULL)
+            || (node->GetNextEventTime == NULL) || (node->Process == NULL) ) {
+        fprintf(stderr, "%s: not an uplink node\n", library);
+        return false;
+    }
+    return true;
+}
+
+static void DefaultLibraryPath( char *path, size_t size, const char *name )
+{
+    ssize_t len = readlink("/proc/self/exe", path, size - 1);
+    char *slash;
+
+    if ( len > 0 ) {
+        path[len] = '\0';
+        slash = strrchr(path, '/');
+        if ( (slash != NULL) && ((size_t) (slash - path) + strlen(name) + 2 < size) ) {
+            strcpy(slash + 1, name);
+            return;
+        }
+    }
+    snprintf(path, size, "./%s", name);
+}
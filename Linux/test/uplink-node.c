@@ -0,0 +1,108 @@
+/**
+ * \file uplink-node.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMac classA node of the host uplink latency test
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMac.h"
+#include "uplink-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define UPLINK_NODE_APP_PORT                        2
+#define UPLINK_NODE_APP_DATA_SIZE                   16
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static uint8_t NwkSKey[] = UPLINK_NODE_NWKSKEY;
+static uint8_t AppSKey[] = UPLINK_NODE_APPSKEY;
+
+static uint8_t AppData[UPLINK_NODE_APP_DATA_SIZE];
+
+static LoRaMacCallbacks_t LoRaMacCallbacks;
+
+/*! Completion of the last uplink */
+static UplinkNodeResult_t Result;
+static bool ResultValid = false;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static void OnMacEvent( LoRaMacEventFlags_t *flags, LoRaMacEventInfo_t *info );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void UplinkNodeInit( const UplinkNodeConfig_t *config )
+{
+    uint8_t id[8] = { 0 };
+
+    id[4] = (uint8_t) (config->DevAddr >> 24);
+    id[5] = (uint8_t) (config->DevAddr >> 16);
+    id[6] = (uint8_t) (config->DevAddr >> 8);
+    id[7] = (uint8_t) config->DevAddr;
+    BoardSetUniqueId(id);
+    BoardInitMcu();
+    BoardInitPeriph();
+    SimRadioSetPosition(config->X, config->Y);
+
+    LoRaMacCallbacks.MacEvent = OnMacEvent;
+    LoRaMacCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    LoRaMacInit(&LoRaMacCallbacks);
+
+    srand1(config->Seed);
+    LoRaMacInitNwkIds(0, config->DevAddr, NwkSKey, AppSKey);
+
+    LoRaMacSetAdrOn(false);
+    LoRaMacSetChannelsDatarate(config->Datarate);
+    LoRaMacTestSetDutyCycleOn(false);
+    LoRaMacSetPublicNetwork(true);
+}
+
+uint8_t UplinkNodeSend( uint8_t nbRep, uint8_t retries )
+{
+    ResultValid = false;
+    LoRaMacSetChannelsNbRep(nbRep);
+    if ( retries > 0 ) {
+        return LoRaMacSendConfirmedFrame(UPLINK_NODE_APP_PORT, AppData, sizeof(AppData), retries);
+    }
+    return LoRaMacSendFrame(UPLINK_NODE_APP_PORT, AppData, sizeof(AppData));
+}
+
+bool UplinkNodeGetResult( UplinkNodeResult_t *result )
+{
+    *result = Result;
+    return ResultValid;
+}
+
+uint64_t UplinkNodeGetNextEventTime( void )
+{
+    return TimerHwGetAlarmTime();
+}
+
+void UplinkNodeProcess( void )
+{
+    TimerHwProcess(SimMediumGetTime());
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void OnMacEvent( LoRaMacEventFlags_t *flags, LoRaMacEventInfo_t *info )
+{
+    if ( flags->Bits.Tx == 0 ) {
+        return;
+    }
+    Result.Time = SimMediumGetTime();
+    Result.Status = (uint8_t) info->Status;
+    Result.TxAckReceived = info->TxAckReceived;
+    Result.TxNbRetries = info->TxNbRetries;
+    ResultValid = true;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file uplink-node.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMac classA node of the host uplink latency test
+ *
+ * The node is built as shared object together with the MAC, the LinuxSim
+ * board and the simulated radio, once with the event driven MAC state
+ * evaluation and once with the MAC_STATE_CHECK_POLL_PERIOD poll. The test
+ * loads both and runs the same uplinks on the medium of the test.
+ */
+#ifndef __UPLINK_NODE_H__
+#define __UPLINK_NODE_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Network session key of the node, the test computes the downlink MIC */
+#define UPLINK_NODE_NWKSKEY                         { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/*! Application session key of the node */
+#define UPLINK_NODE_APPSKEY                         { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node configuration */
+typedef struct UplinkNodeConfig_s {
+    uint32_t DevAddr;           //! Device address (ABP)
+    int32_t X;                  //! Position [m]
+    int32_t Y;                  //! Position [m]
+    int8_t Datarate;            //! Uplink datarate
+    uint32_t Seed;              //! Seed of the node pseudo random generator
+} UplinkNodeConfig_t;
+
+/*! Completion of an uplink as notified by the MAC */
+typedef struct UplinkNodeResult_s {
+    uint64_t Time;              //! Time of the MacEvent notification [us]
+    uint8_t Status;             //! LoRaMacEventInfo_t.Status
+    bool TxAckReceived;         //! LoRaMacEventInfo_t.TxAckReceived
+    uint8_t TxNbRetries;        //! LoRaMacEventInfo_t.TxNbRetries
+} UplinkNodeResult_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes the board and the MAC and attaches the node to the
+ *        medium. ADR and the duty cycle limitation are off.
+ */
+void UplinkNodeInit( const UplinkNodeConfig_t *config );
+
+/*!
+ * \brief Starts an uplink.
+ *
+ * \param nbRep Transmissions of an unconfirmed uplink.
+ * \param retries Transmissions of a confirmed uplink, 0 for an unconfirmed one.
+ * \retval uint8_t Status of LoRaMacSendFrame or LoRaMacSendConfirmedFrame.
+ */
+uint8_t UplinkNodeSend( uint8_t nbRep, uint8_t retries );
+
+/*!
+ * \brief Returns the completion of the last uplink.
+ *
+ * \retval bool False while the MAC has not notified the completion yet.
+ */
+bool UplinkNodeGetResult( UplinkNodeResult_t *result );
+
+/*!
+ * \brief Returns the time of the next node alarm.
+ *
+ * \retval uint64_t Alarm time [us], SIM_MEDIUM_TIME_NEVER if none is armed.
+ */
+uint64_t UplinkNodeGetNextEventTime( void );
+
+/*!
+ * \brief Raises the due alarms.
+ */
+void UplinkNodeProcess( void );
+
+#endif /* __UPLINK_NODE_H__ */
@@ -0,0 +1,349 @@
+/**
+ * \file main.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMac classA multi-node host simulation driver
+ *
+ * The driver owns the radio medium and the virtual clock. Every node is a
+ * private copy of the node shared object (sim-node.h) loaded with
+ * RTLD_LOCAL, thus every node runs the full MAC with its own globals. The
+ * node shared object resolves the SimMedium functions against the driver,
+ * all the nodes share one medium.
+ *
+ * The gateway is a set of continuous receivers attached directly to the
+ * medium, one per default channel and spreading factor. At the end the
+ * driver prints the uplinks sent by the nodes, the frames received by the
+ * gateway and the frames lost in collisions.
+ *
+ * Usage: loramac-sim [-n nodes] [-t seconds] [-p period s] [-d datarate]
+ *                    [-r radius m] [-s seed] [-l node.so] [-c] [-v]
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "sim-medium.h"
+#include "sim-node.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Maximum number of simulated nodes */
+#define SIM_MAX_NODES                               (SIM_MEDIUM_MAX_NODES - SIM_GW_NB_RECEIVERS)
+
+/*! Gateway channels, the EU868 default channels */
+#define SIM_GW_NB_CHANNELS                          3
+#define SIM_GW_CHANNELS                             { 868100000, 868300000, 868500000 }
+
+/*! Gateway spreading factors */
+#define SIM_GW_SF_MIN                               7
+#define SIM_GW_SF_MAX                               12
+#define SIM_GW_NB_RECEIVERS                         (SIM_GW_NB_CHANNELS * (SIM_GW_SF_MAX - SIM_GW_SF_MIN + 1))
+
+/*! Device address of the first node */
+#define SIM_DEV_ADDR_BASE                           0x01000000
+
+/*! Name of the node shared object next to the driver executable */
+#define SIM_NODE_LIBRARY                            "libloramac-node.so"
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node instance, the entry points of its shared object copy */
+typedef struct {
+    void *Handle;
+    void (*Init)( const SimNodeConfig_t *config );
+    uint64_t (*GetNextEventTime)( void );
+    void (*Process)( void );
+    void (*GetStats)( SimNodeStats_t *stats );
+    uint32_t Received;          //! Frames received by the gateway
+} SimNode_t;
+
+/*! Gateway receiver */
+typedef struct {
+    int16_t Node;
+    uint32_t Received;
+    uint32_t Lost;
+} SimGwReceiver_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static SimNode_t Nodes[SIM_MAX_NODES];
+static uint16_t NbNodes = 0;
+
+static SimGwReceiver_t Receivers[SIM_GW_NB_RECEIVERS];
+
+/*! Verbose output, one line per node */
+static bool Verbose = false;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool LoadNode( SimNode_t *node, const char *library );
+static void GwOnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+static void GwOnRxError( void *context );
+static void GwInit( void );
+static void DefaultLibraryPath( char *path, size_t size );
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+int main( int argc, char **argv )
+{
+    SimNodeConfig_t config;
+    SimNodeStats_t stats, total;
+    char library[PATH_MAX];
+    uint32_t nbNodes = 50, duration = 3600, period = 60, radius = 2000, seed = 1;
+    uint32_t received = 0, lost = 0;
+    int datarate = 5;
+    bool dutyCycleOn = true;
+    uint64_t end, next, t;
+    double angle, distance;
+    uint16_t i;
+    int opt;
+
+    DefaultLibraryPath(library, sizeof(library));
+
+    while ( (opt = getopt(argc, argv, "n:t:p:d:r:s:l:cv")) != -1 ) {
+        switch ( opt ) {
+            case 'n':
+                nbNodes = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                duration = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                period = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                datarate = atoi(optarg);
+                break;
+            case 'r':
+                radius = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                snprintf(library, sizeof(library), "%s", optarg);
+                break;
+            case 'c':
+                dutyCycleOn = false;
+                break;
+            case 'v':
+                Verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n nodes] [-t seconds] [-p period s] [-d datarate] "
+                        "[-r radius m] [-s seed] [-l node.so] [-c] [-v]\n", argv[0]);
+                return 2;
+        }
+    }
+    if ( (nbNodes == 0) || (nbNodes > SIM_MAX_NODES) || (period == 0) || (datarate < 0)
+            || (datarate > 5) ) {
+        fprintf(stderr, "invalid arguments, 1..%d nodes, datarate 0..5\n", SIM_MAX_NODES);
+        return 2;
+    }
+
+    SimMediumInit(seed);
+    srand(seed);
+    GwInit();
+
+    for ( i = 0; i < nbNodes; i++ ) {
+        if ( !LoadNode(&Nodes[i], library) ) {
+            return 1;
+        }
+        NbNodes++;
+
+        /* Uniformly distributed over the disc around the gateway */
+        angle = 2.0 * M_PI * ((double) rand() / RAND_MAX);
+        distance = radius * sqrt((double) rand() / RAND_MAX);
+
+        memset(&config, 0, sizeof(config));
+        config.DevAddr = SIM_DEV_ADDR_BASE + i;
+        config.X = (int32_t) (distance * cos(angle));
+        config.Y = (int32_t) (distance * sin(angle));
+        config.TxPeriod = period * 1000000;
+        config.TxPeriodRnd = config.TxPeriod / 10;
+        config.Datarate = (int8_t) datarate;
+        config.PayloadSize = 16;
+        config.DutyCycleOn = dutyCycleOn;
+        config.Seed = seed * 7919 + i;
+        Nodes[i].Init(&config);
+    }
+
+    end = (uint64_t) duration * 1000000;
+    for ( ;; ) {
+        next = SimMediumGetNextEventTime();
+        for ( i = 0; i < NbNodes; i++ ) {
+            t = Nodes[i].GetNextEventTime();
+            if ( t < next ) {
+                next = t;
+            }
+        }
+        if ( next > end ) {
+            break;
+        }
+        SimMediumProcess(next);
+        for ( i = 0; i < NbNodes; i++ ) {
+            Nodes[i].Process();
+        }
+    }
+
+    memset(&total, 0, sizeof(total));
+    for ( i = 0; i < NbNodes; i++ ) {
+        Nodes[i].GetStats(&stats);
+        total.TxRequested += stats.TxRequested;
+        total.TxDone += stats.TxDone;
+        total.TxDeferred += stats.TxDeferred;
+        total.RxTimeout += stats.RxTimeout;
+        if ( Verbose ) {
+            printf("node %3u: requested %5u sent %5u deferred %5u received %5u\n", i,
+                    stats.TxRequested, stats.TxDone, stats.TxDeferred, Nodes[i].Received);
+        }
+    }
+    for ( i = 0; i < SIM_GW_NB_RECEIVERS; i++ ) {
+        received += Receivers[i].Received;
+        lost += Receivers[i].Lost;
+    }
+
+    printf("nodes %u, %u s, period %u s, DR%d, radius %u m, duty cycle %s\n", NbNodes, duration,
+            period, datarate, radius, dutyCycleOn ? "on" : "off");
+    printf("uplinks requested %u, sent %u, deferred %u\n", total.TxRequested, total.TxDone,
+            total.TxDeferred);
+    printf("gateway received %u, collided %u, delivery ratio %.3f\n", received, lost,
+            (total.TxDone != 0) ? (double) received / total.TxDone : 0.0);
+
+    /* Every received frame must have been sent by a node */
+    return ((received <= total.TxDone) && (total.TxDone > 0)) ? 0 : 1;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static bool LoadNode( SimNode_t *node, const char *library )
+{
+    char path[] = "/tmp/loramac-node-XXXXXX";
+    char buffer[4096];
+    FILE *src;
+    size_t n;
+    int fd;
+
+    /* A library is loaded once per path, every node needs its own copy */
+    src = fopen(library, "rb");
+    if ( src == NULL ) {
+        perror(library);
+        return false;
+    }
+    fd = mkstemp(path);
+    if ( fd < 0 ) {
+        perror(path);
+        fclose(src);
+        return false;
+    }
+    while ( (n = fread(buffer, 1, sizeof(buffer), src)) > 0 ) {
+        if ( write(fd, buffer, n) != (ssize_t) n ) {
+            perror(path);
+            break;
+        }
+    }
+    fclose(src);
+    close(fd);
+
+    node->Handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    unlink(path);
+    if ( node->Handle == NULL ) {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    node->Init = (void (*)( const SimNodeConfig_t * )) dlsym(node->Handle, "SimNodeInit");
+    node->GetNextEventTime = (uint64_t (*)( void )) dlsym(node->Handle, "SimNodeGetNextEventTime");
+    node->Process = (void (*)( void )) dlsym(node->Handle, "SimNodeProcess");
+    node->GetStats = (void (*)( SimNodeStats_t * )) dlsym(node->Handle, "SimNodeGetStats");
+    node->Received = 0;
+
+    if ( (node->Init == NULL) || (node->GetNextEventTime == NULL) || (node->Process == NULL)
+            || (node->GetStats == NULL) ) {
+        fprintf(stderr, "%s: not a simulation node\n", library);
+        return false;
+    }
+    return true;
+}
+
+static void GwOnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    SimGwReceiver_t *receiver = (SimGwReceiver_t *) context;
+    uint32_t devAddr;
+
+    (void) rssi;
+    (void) snr;
+
+    receiver->Received++;
+
+    /* MHDR, then the little endian DevAddr */
+    if ( size >= 5 ) {
+        devAddr = payload[1] | ((uint32_t) payload[2] << 8) | ((uint32_t) payload[3] << 16)
+                | ((uint32_t) payload[4] << 24);
+        if ( (devAddr >= SIM_DEV_ADDR_BASE) && (devAddr < SIM_DEV_ADDR_BASE + NbNodes) ) {
+            Nodes[devAddr - SIM_DEV_ADDR_BASE].Received++;
+        }
+    }
+}
+
+static void GwOnRxError( void *context )
+{
+    ((SimGwReceiver_t *) context)->Lost++;
+}
+
+static void GwInit( void )
+{
+    static const SimMediumEvents_t events = { NULL, GwOnRxDone, GwOnRxError, NULL, NULL };
+    const uint32_t channels[SIM_GW_NB_CHANNELS] = SIM_GW_CHANNELS;
+    SimMediumModulation_t modulation;
+    uint8_t ch, sf;
+    uint16_t i = 0;
+
+    memset(&modulation, 0, sizeof(modulation));
+    modulation.Modem = MODEM_LORA;
+    modulation.Bandwidth = 125000;
+    modulation.Coderate = 1;
+    modulation.PreambleLen = 8;
+    modulation.CrcOn = true;
+
+    for ( ch = 0; ch < SIM_GW_NB_CHANNELS; ch++ ) {
+        for ( sf = SIM_GW_SF_MIN; sf <= SIM_GW_SF_MAX; sf++ ) {
+            modulation.Frequency = channels[ch];
+            modulation.Datarate = sf;
+            modulation.LowDatarateOptimize = (sf >= 11);
+
+            memset(&Receivers[i], 0, sizeof(SimGwReceiver_t));
+            Receivers[i].Node = SimMediumAttach(&events, &Receivers[i], 0, 0);
+            SimMediumRx(Receivers[i].Node, &modulation, 0, true);
+            i++;
+        }
+    }
+}
+
+static void DefaultLibraryPath( char *path, size_t size )
+{
+    ssize_t len = readlink("/proc/self/exe", path, size - 1);
+    char *slash;
+
+    if ( len > 0 ) {
+        path[len] = '\0';
+        slash = strrchr(path, '/');
+        if ( (slash != NULL) && ((size_t) (slash - path) + sizeof(SIM_NODE_LIBRARY) + 1 < size) ) {
+            strcpy(slash + 1, SIM_NODE_LIBRARY);
+            return;
+        }
+    }
+    snprintf(path, size, "./%s", SIM_NODE_LIBRARY);
+}
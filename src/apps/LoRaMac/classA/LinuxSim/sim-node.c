@@ -0,0 +1,189 @@
+/**
+ * \file sim-node.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMac classA node of the host simulation
+ *
+ * Same application flow as the classA main.c of the boards: ABP activation
+ * and periodic unconfirmed uplinks. The main loop is replaced by
+ * SimNodeProcess which is called by the simulation driver.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMac.h"
+#include "sim-node.h"
+
+#define LOG_LEVEL_ERROR
+#include "debug.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Current network ID */
+#define LORAWAN_NETWORK_ID                          ( uint32_t )0
+
+/*! AES encryption/decryption cipher network session key */
+#define LORAWAN_NWKSKEY                             { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/*! AES encryption/decryption cipher application session key */
+#define LORAWAN_APPSKEY                             { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/*! Indicates if the end-device is to be connected to a private or public network */
+#define LORAWAN_PUBLIC_NETWORK                      true
+
+/*! LoRaWAN application port */
+#define LORAWAN_APP_PORT                            2
+
+/*! User application data buffer size */
+#define LORAWAN_APP_DATA_MAX_SIZE                   64
+
+/*! Delay after which a send refused by the MAC is tried again */
+#define APP_TX_RETRY_DELAY                          1000000  // 1 [s] value in us
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static uint8_t NwkSKey[] = LORAWAN_NWKSKEY;
+static uint8_t AppSKey[] = LORAWAN_APPSKEY;
+
+/*! Node configuration */
+static SimNodeConfig_t Config;
+
+/*! Node counters */
+static SimNodeStats_t Stats;
+
+/*! User application data */
+static uint8_t AppData[LORAWAN_APP_DATA_MAX_SIZE];
+
+static TimerEvent_t TxNextPacketTimer;
+static TimerEvent_t TxRetryTimer;
+
+/*! Indicates if a new packet can be sent */
+static bool TxNextPacket = false;
+static bool ScheduleNextTx = false;
+
+static LoRaMacCallbacks_t LoRaMacCallbacks;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static void OnTxNextPacketTimerEvent( void );
+static void OnTxRetryTimerEvent( void );
+static void OnMacEvent( LoRaMacEventFlags_t *flags, LoRaMacEventInfo_t *info );
+static void ScheduleTx( uint32_t delay );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void SimNodeInit( const SimNodeConfig_t *config )
+{
+    uint8_t id[8] = { 0 };
+
+    Config = *config;
+    memset1((uint8_t *) &Stats, 0, sizeof(Stats));
+    if ( Config.PayloadSize > LORAWAN_APP_DATA_MAX_SIZE ) {
+        Config.PayloadSize = LORAWAN_APP_DATA_MAX_SIZE;
+    }
+
+    id[4] = (uint8_t) (Config.DevAddr >> 24);
+    id[5] = (uint8_t) (Config.DevAddr >> 16);
+    id[6] = (uint8_t) (Config.DevAddr >> 8);
+    id[7] = (uint8_t) Config.DevAddr;
+    BoardSetUniqueId(id);
+    BoardInitMcu();
+    BoardInitPeriph();
+    SimRadioSetPosition(Config.X, Config.Y);
+
+    LoRaMacCallbacks.MacEvent = OnMacEvent;
+    LoRaMacCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    LoRaMacInit(&LoRaMacCallbacks);
+
+    srand1(Config.Seed);
+    LoRaMacInitNwkIds(LORAWAN_NETWORK_ID, Config.DevAddr, NwkSKey, AppSKey);
+
+    LoRaMacSetAdrOn(false);
+    LoRaMacSetChannelsDatarate(Config.Datarate);
+    LoRaMacTestSetDutyCycleOn(Config.DutyCycleOn);
+    LoRaMacSetPublicNetwork(LORAWAN_PUBLIC_NETWORK);
+
+    TimerInit(&TxNextPacketTimer, OnTxNextPacketTimerEvent);
+    TimerInit(&TxRetryTimer, OnTxRetryTimerEvent);
+
+    /* Spread the first uplinks of the nodes over one period */
+    ScheduleTx((uint32_t) randr(1, (int32_t) Config.TxPeriod));
+}
+
+uint64_t SimNodeGetNextEventTime( void )
+{
+    return TimerHwGetAlarmTime();
+}
+
+void SimNodeProcess( void )
+{
+    uint8_t status;
+    int32_t rnd;
+
+    TimerHwProcess(SimMediumGetTime());
+
+    if ( ScheduleNextTx == true ) {
+        ScheduleNextTx = false;
+
+        rnd = randr(-(int32_t) Config.TxPeriodRnd, (int32_t) Config.TxPeriodRnd);
+        ScheduleTx((uint32_t) ((int32_t) Config.TxPeriod + rnd));
+    }
+
+    if ( TxNextPacket == true ) {
+        TxNextPacket = false;
+
+        memset1(AppData, (uint8_t) Stats.TxRequested, Config.PayloadSize);
+        status = LoRaMacSendFrame(LORAWAN_APP_PORT, AppData, Config.PayloadSize);
+        if ( status != 0 ) {
+            /* Busy or no free channel, try again later */
+            Stats.TxDeferred++;
+            TimerSetValue(&TxRetryTimer, APP_TX_RETRY_DELAY);
+            TimerStart(&TxRetryTimer);
+        }
+    }
+}
+
+void SimNodeGetStats( SimNodeStats_t *stats )
+{
+    *stats = Stats;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void OnTxNextPacketTimerEvent( void )
+{
+    TimerStop(&TxNextPacketTimer);
+    Stats.TxRequested++;
+    TxNextPacket = true;
+}
+
+static void OnTxRetryTimerEvent( void )
+{
+    TimerStop(&TxRetryTimer);
+    TxNextPacket = true;
+}
+
+static void OnMacEvent( LoRaMacEventFlags_t *flags, LoRaMacEventInfo_t *info )
+{
+    if ( flags->Bits.Tx == 1 ) {
+        Stats.TxDone++;
+    }
+    if ( info->Status == LORAMAC_EVENT_INFO_STATUS_RX2_TIMEOUT ) {
+        Stats.RxTimeout++;
+    }
+    // Schedule a new transmission
+    ScheduleNextTx = true;
+}
+
+static void ScheduleTx( uint32_t delay )
+{
+    TimerSetValue(&TxNextPacketTimer, delay);
+    TimerStart(&TxNextPacketTimer);
+}
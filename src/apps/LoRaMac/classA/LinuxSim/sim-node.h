@@ -0,0 +1,73 @@
+/**
+ * \file sim-node.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief LoRaMac classA node of the host simulation
+ *
+ * The node is built as shared object together with the MAC, the LinuxSim
+ * board and the simulated radio. The simulation driver loads one copy of the
+ * shared object per node, so that every node has its own MAC globals while
+ * the radio medium of the driver is shared by all of them.
+ */
+#ifndef __SIM_NODE_H__
+#define __SIM_NODE_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Node configuration */
+typedef struct SimNodeConfig_s {
+    uint32_t DevAddr;           //! Device address (ABP)
+    int32_t X;                  //! Position [m]
+    int32_t Y;                  //! Position [m]
+    uint32_t TxPeriod;          //! Uplink period [us]
+    uint32_t TxPeriodRnd;       //! Uplink period jitter, +/- [us]
+    int8_t Datarate;            //! Uplink datarate
+    uint8_t PayloadSize;        //! Application payload size
+    bool DutyCycleOn;           //! Duty cycle limitation
+    uint32_t Seed;              //! Seed of the node pseudo random generator
+} SimNodeConfig_t;
+
+/*! Node counters */
+typedef struct SimNodeStats_s {
+    uint32_t TxRequested;       //! Uplinks the application wanted to send
+    uint32_t TxDone;            //! Uplinks which have been transmitted
+    uint32_t TxDeferred;        //! Send attempts refused by the MAC (busy, no channel)
+    uint32_t RxTimeout;         //! Reception windows without downlink
+} SimNodeStats_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes the board and the MAC and attaches the node to the
+ *        medium, the first uplink is sent after a random part of the period.
+ *
+ * \param config Node configuration.
+ */
+void SimNodeInit( const SimNodeConfig_t *config );
+
+/*!
+ * \brief Returns the time of the next node alarm.
+ *
+ * \retval uint64_t Alarm time [us], SIM_MEDIUM_TIME_NEVER if none is armed.
+ */
+uint64_t SimNodeGetNextEventTime( void );
+
+/*!
+ * \brief Raises the due alarms and runs the application once.
+ */
+void SimNodeProcess( void );
+
+/*!
+ * \brief Returns the node counters.
+ */
+void SimNodeGetStats( SimNodeStats_t *stats );
+
+#endif /* __SIM_NODE_H__ */
@@ -441,6 +441,7 @@ int main( void )
                     break;
                 }
             }
+            GpsProcess( );
             TimerLowPowerHandler( );
 #endif
         }
@@ -496,6 +497,7 @@ int main( void )
             trySendingFrameAgain = SendFrame( );
         }
 
+        GpsProcess( );
         TimerLowPowerHandler( );
     }
 }
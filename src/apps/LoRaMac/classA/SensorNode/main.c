@@ -455,6 +455,7 @@ int main( void )
                     break;
                 }
             }
+            GpsProcess( );
             TimerLowPowerHandler( );
 #endif
         }
@@ -523,6 +524,7 @@ int main( void )
             trySendingFrameAgain = SendFrame( );
         }
 
+        GpsProcess( );
         TimerLowPowerHandler( );
     }
 }
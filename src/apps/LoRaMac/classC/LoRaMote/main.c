@@ -442,6 +442,7 @@ int main( void )
                     break;
                 }
             }
+            GpsProcess( );
             TimerLowPowerHandler( );
 #endif
         }
@@ -497,6 +498,7 @@ int main( void )
             trySendingFrameAgain = SendFrame( );
         }
 
+        GpsProcess( );
         TimerLowPowerHandler( );
     }
 }
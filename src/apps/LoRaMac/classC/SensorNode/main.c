@@ -456,6 +456,7 @@ int main( void )
                     break;
                 }
             }
+            GpsProcess( );
             TimerLowPowerHandler( );
 #endif
         }
@@ -524,6 +525,7 @@ int main( void )
             trySendingFrameAgain = SendFrame( );
         }
 
+        GpsProcess( );
         TimerLowPowerHandler( );
     }
 }
@@ -813,6 +813,8 @@ void LoRaMacSetAdrOn( bool enable )
 
 void LoRaMacInitNwkIds( uint32_t netID, uint32_t devAddr, uint8_t *nwkSKey, uint8_t *appSKey )
 {
+    LoRaMacCryptoInvalidateKeys(LoRaMacDevAddr);
+
     LoRaMacNetID = netID;
     LoRaMacDevAddr = devAddr;
     LoRaMacMemCpy(nwkSKey, LoRaMacNwkSKey, 16);
@@ -1382,8 +1384,11 @@ void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
                 LoRaMacEventInfo.RxSnr = snr;
                 LoRaMacEventInfo.RxRssi = rssi;
 
+                // Session keys change, drop the cached key schedules of the former session
+                LoRaMacCryptoInvalidateKeys(LoRaMacDevAddr);
                 LoRaMacJoinComputeSKeys(LoRaMacAppKey, LoRaMacRxPayload + 1, LoRaMacDevNonce,
                         LoRaMacNwkSKey, LoRaMacAppSKey);
+                LoRaMacCryptoInvalidateKeys(LORAMAC_CRYPTO_JOIN_ADDRESS);
 
                 LoRaMacNetID = (uint32_t) LoRaMacRxPayload[4];
                 LoRaMacNetID |= ((uint32_t) LoRaMacRxPayload[5] << 8);
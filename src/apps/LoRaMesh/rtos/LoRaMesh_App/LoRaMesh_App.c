@@ -550,7 +550,7 @@ static void SendDataFrame( void* param )
 
     LOG_TRACE("Sending data frame at %u ms.",
             (uint32_t)(TimerGetCurrentTime() * portTICK_PERIOD_MS));
-    LoRaMesh_SendFrame(AppData, dataSize, AppPort, true, IsTxConfirmed);
+    LoRaMesh_QueueFrame(AppData, dataSize, AppPort, IsTxConfirmed);
 }
 
 static void SendMulticastDataFrame( void* param )
@@ -0,0 +1,233 @@
+/**
+ * \file LoRaAggr.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh uplink aggregation
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMesh.h"
+#include "LoRaAggr.h"
+
+#define LOG_LEVEL_TRACE
+#include "debug.h"
+
+#if(LORAMESH_CONFIG_AGGR_ENABLED == 1)
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define QUEUE_SIZE                          LORAMESH_CONFIG_AGGR_QUEUE_SIZE
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Queued records in container format, appended by LoRaAggr_Put and
+ *  removed from the front by LoRaAggr_Flush only */
+static uint8_t Queue[QUEUE_SIZE];
+static uint16_t QueueLen;
+
+/*! True if a queued record has to be sent confirmed */
+static bool QueueConfirmed;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Returns the size of the record at rec, 0 if malformed */
+static uint16_t RecordSize( uint8_t *rec, uint16_t size );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaAggr_Init( void )
+{
+    QueueLen = 0;
+    QueueConfirmed = false;
+    LoRaMesh_RegisterApplication((PortHandlerFunction_t) & LoRaAggr_OnPacketRx,
+            LORAMESH_CONFIG_AGGR_PORT);
+}
+
+uint8_t LoRaAggr_Put( uint32_t srcAddr, uint8_t fPort, uint8_t *data, uint8_t size,
+        bool isConfirmed )
+{
+    uint16_t recSize = LORAAGGR_RECORD_HDR_SIZE + size;
+    bool isForwarded = (srcAddr != pLoRaDevice->devAddr);
+    uint32_t primask;
+    uint8_t *rec;
+
+    if ( fPort < LORAFRM_LOWEST_FPORT || fPort >= LORAFRM_HIGHEST_FPORT
+            || fPort == LORAMESH_CONFIG_AGGR_PORT ) {
+        return ERR_RANGE;
+    }
+    if ( isForwarded ) {
+        recSize += LORAAGGR_FORWARD_HDR_SIZE;
+    }
+    if ( recSize > LORAMESH_PAYLOAD_SIZE ) {
+        LORASTATS_INC(Mesh, AggrDropped);
+        return ERR_OVERFLOW;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ( QueueLen + recSize > QUEUE_SIZE ) {
+        __set_PRIMASK(primask);
+        LORASTATS_INC(Mesh, AggrDropped);
+        LOG_ERROR("Aggregation queue full, record on port %u dropped.", fPort);
+        return ERR_OVERFLOW;
+    }
+    rec = &Queue[QueueLen];
+    if ( isForwarded ) {
+        *rec++ = LORAAGGR_FORWARD_MARKER;
+        *rec++ = (uint8_t)(srcAddr);
+        *rec++ = (uint8_t)(srcAddr >> 8);
+        *rec++ = (uint8_t)(srcAddr >> 16);
+        *rec++ = (uint8_t)(srcAddr >> 24);
+    }
+    *rec++ = fPort;
+    *rec++ = size;
+    memcpy1(rec, data, size);
+    QueueLen += recSize;
+    QueueConfirmed |= isConfirmed;
+    __set_PRIMASK(primask);
+
+    return ERR_OK;
+}
+
+uint8_t LoRaAggr_Flush( void )
+{
+    uint16_t queueLen, frameSize = 0, recSize;
+    uint8_t maxSize, nofRecords = 0, result;
+    uint32_t primask;
+
+    if ( !LoRaMesh_IsNetworkJoined() ) {
+        return ERR_NOTAVAIL;
+    }
+
+    /* Records are only appended concurrently, the front stays untouched */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    queueLen = QueueLen;
+    __set_PRIMASK(primask);
+    if ( queueLen == 0 ) {
+        return ERR_OK;
+    }
+
+    maxSize = MaxPayloadByDatarate[pLoRaDevice->currDataRateIndex];
+    if ( maxSize > LORAMESH_PAYLOAD_SIZE ) {
+        maxSize = LORAMESH_PAYLOAD_SIZE;
+    }
+
+    /* Take as many whole records as fit into the frame */
+    while ( frameSize < queueLen ) {
+        recSize = RecordSize(&Queue[frameSize], queueLen - frameSize);
+        if ( recSize == 0 || (frameSize + recSize) > maxSize ) {
+            break;
+        }
+        frameSize += recSize;
+        nofRecords++;
+    }
+
+    if ( nofRecords == 1 && Queue[0] != LORAAGGR_FORWARD_MARKER ) {
+        /* A single own record is sent without container */
+        result = LoRaMesh_SendFrame(&Queue[LORAAGGR_RECORD_HDR_SIZE], Queue[1], Queue[0], true,
+                QueueConfirmed);
+    } else if ( nofRecords > 0 ) {
+        result = LoRaMesh_SendFrame(Queue, frameSize, LORAMESH_CONFIG_AGGR_PORT, true,
+                QueueConfirmed);
+        if ( result == ERR_OK ) {
+            LORASTATS_INC(Mesh, AggrFrames);
+            LORASTATS_ADD(Mesh.AggrRecords, nofRecords);
+        }
+    } else {
+        /* The first record does not fit at the current data rate, drop it
+         * instead of blocking the queue */
+        frameSize = RecordSize(Queue, queueLen);
+        if ( frameSize == 0 ) {
+            frameSize = queueLen;
+        }
+        LORASTATS_INC(Mesh, AggrDropped);
+        LOG_ERROR("Record of %u bytes too large for data rate %u, dropped.", frameSize,
+                pLoRaDevice->currDataRateIndex);
+        result = ERR_OVERFLOW;
+    }
+
+    if ( result == ERR_OK || nofRecords == 0 ) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        QueueLen -= frameSize;
+        memmove(Queue, &Queue[frameSize], QueueLen);
+        if ( QueueLen == 0 ) {
+            QueueConfirmed = false;
+        }
+        __set_PRIMASK(primask);
+    }
+
+    return result;
+}
+
+uint16_t LoRaAggr_GetPending( void )
+{
+    return QueueLen;
+}
+
+uint8_t LoRaAggr_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr,
+        uint8_t fPort )
+{
+    uint8_t *rec = LORAMESH_BUF_PAYLOAD_START(buf);
+    uint16_t offset = 0, recSize;
+    uint32_t srcAddr;
+    uint8_t *data;
+
+    (void) fPort;
+
+    while ( offset < payloadSize ) {
+        recSize = RecordSize(&rec[offset], payloadSize - offset);
+        if ( recSize == 0 ) {
+            LORASTATS_INC(Frm, Malformed);
+            LOG_ERROR("Malformed aggregation record from 0x%08x.", devAddr);
+            return ERR_FAILED;
+        }
+
+        srcAddr = devAddr;
+        data = &rec[offset];
+        if ( *data == LORAAGGR_FORWARD_MARKER ) {
+            srcAddr = (uint32_t) data[1] | ((uint32_t) data[2] << 8) | ((uint32_t) data[3] << 16)
+                    | ((uint32_t) data[4] << 24);
+            data += LORAAGGR_FORWARD_HDR_SIZE;
+        }
+
+        if ( pLoRaDevice->devRole == ROUTER ) {
+            /* Bundle the child records into the own uplink */
+            (void) LoRaAggr_Put(srcAddr, data[0], &data[LORAAGGR_RECORD_HDR_SIZE], data[1],
+                    false);
+        } else if ( data[0] != LORAMESH_CONFIG_AGGR_PORT ) {
+            (void) LoRaMesh_OnPacketRx(&data[LORAAGGR_RECORD_HDR_SIZE], data[1], srcAddr, data[0]);
+        }
+        offset += recSize;
+    }
+
+    return ERR_OK;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint16_t RecordSize( uint8_t *rec, uint16_t size )
+{
+    uint16_t recSize = LORAAGGR_RECORD_HDR_SIZE;
+
+    if ( size > 0 && rec[0] == LORAAGGR_FORWARD_MARKER ) {
+        recSize += LORAAGGR_FORWARD_HDR_SIZE;
+    }
+    if ( size < recSize ) {
+        return 0;
+    }
+    recSize += rec[recSize - 1];
+
+    return (size < recSize) ? 0 : recSize;
+}
+#endif /* LORAMESH_CONFIG_AGGR_ENABLED */
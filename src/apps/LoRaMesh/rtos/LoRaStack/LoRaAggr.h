@@ -0,0 +1,87 @@
+/**
+ * \file LoRaAggr.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh uplink aggregation
+ *
+ * Application records are queued instead of being sent in a frame of their
+ * own. At the uplink slot the queued records are packed into one container
+ * frame up to the maximum payload of the current data rate and sent on
+ * LORAMESH_CONFIG_AGGR_PORT. The coordinator unpacks the container and passes
+ * each record to the handler of its port, routers queue the records of their
+ * child nodes again, containers and single records alike, and forward them
+ * with their own uplink.
+ *
+ * Container format, records in queue order:
+ *
+ * <fPort:1><len:1><data:len>                   record of the sender
+ * <0x00><srcAddr:4><fPort:1><len:1><data:len>  record forwarded for srcAddr
+ *
+ * A single record of the sender is sent unpacked on its own port.
+ */
+
+#ifndef __LORAAGGR_H_
+#define __LORAAGGR_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Record header sizes */
+#define LORAAGGR_RECORD_HDR_SIZE                (2)
+#define LORAAGGR_FORWARD_HDR_SIZE               (5)
+
+/*! Forwarded record marker */
+#define LORAAGGR_FORWARD_MARKER                 (0x00)
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears the record queue and registers the container port handler.
+ */
+void LoRaAggr_Init( void );
+
+/*!
+ * \brief Queues a record for the next uplink.
+ *
+ * \param srcAddr Address of the node the record originates from.
+ * \param fPort Port of the record.
+ * \param data Record data.
+ * \param size Record size.
+ * \param isConfirmed Send the container as confirmed frame.
+ *
+ * \retval ERR_OK, ERR_RANGE for an invalid port, ERR_OVERFLOW if the record
+ *         does not fit into a frame or the queue is full.
+ */
+uint8_t LoRaAggr_Put( uint32_t srcAddr, uint8_t fPort, uint8_t *data, uint8_t size,
+        bool isConfirmed );
+
+/*!
+ * \brief Sends the queued records, called at the uplink slot. Records that do
+ *        not fit into the frame stay queued for the next uplink slot.
+ *
+ * \retval ERR_OK, ERR_NOTAVAIL if no network has been joined yet.
+ */
+uint8_t LoRaAggr_Flush( void );
+
+/*!
+ * \brief Returns the number of queued bytes.
+ */
+uint16_t LoRaAggr_GetPending( void );
+
+/*!
+ * \brief Unpacks a received container, port handler of LORAMESH_CONFIG_AGGR_PORT.
+ */
+uint8_t LoRaAggr_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr,
+        uint8_t fPort );
+
+#endif /* __LORAAGGR_H_ */
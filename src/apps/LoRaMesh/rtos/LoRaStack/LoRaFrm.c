@@ -32,102 +32,99 @@ void LoRaFrm_Init( void )
 }
 
 uint8_t LoRaFrm_OnPacketRx( LoRaPhy_PacketDesc *packet, uint32_t devAddr, LoRaFrm_Dir_t fDir,
-        uint32_t fCnt )
+        uint32_t fCnt, uint8_t *nwkSKey, uint8_t *appSKey, bool isMulticast )
 {
-    uint8_t fPayloadSize = 0, fBuffer[LORAFRM_BUFFER_SIZE], *nwkSKey, *appSKey;
-    MulticastGroupInfo_t *multicastGrp;
-    ChildNodeInfo_t *childNode;
+    uint8_t fPayloadSize = 0, fHdrSize, *fPayload;
+    LoRaMacCryptoCtx_t cryptoCtx;
     LoRaFrm_Ctrl_t fCtrl;
     uint8_t fPort;
-    bool isMulticast = false;
 
+    LORALATENCY_RX(LATENCY_STAGE_RX_FRM);
     fCtrl.Value = LORAFRM_BUF_CTRL(packet->phyData);
-    fPort = packet->phyData[LORAFRM_BUF_IDX_PORT(fCtrl.Bits.FOptsLen)];
 
     if ( packet->flags & LORAPHY_PACKET_FLAGS_ACK_REQ ) {
         pLoRaDevice->ctrlFlags.Bits.ackRequested = 1;
     }
 
-    fPayloadSize = LORAPHY_BUF_SIZE(packet->phyData) - LORAFRM_HEADER_SIZE_MIN - LORAFRM_PORT_SIZE
-            - LORAMAC_HEADER_SIZE - LORAMAC_MIC_SIZE - fCtrl.Bits.FOptsLen;
+    fHdrSize = LORAMAC_HEADER_SIZE + LORAFRM_HEADER_SIZE_MIN + fCtrl.Bits.FOptsLen;
+    if ( LORAPHY_BUF_SIZE(packet->phyData) < (fHdrSize + LORAMAC_MIC_SIZE) ) {
+        LORASTATS_INC(Frm, Malformed);
+        return ERR_FAILED;
+    }
 
-    /* Evaluate what kind of message it is */
-    if ( pLoRaDevice->devAddr == devAddr ) {
-        nwkSKey = pLoRaDevice->upLinkSlot.NwkSKey;
-        appSKey = pLoRaDevice->upLinkSlot.AppSKey;
-    } else if ( (childNode = LoRaMesh_FindChildNode(devAddr)) != NULL ) {
-        nwkSKey = childNode->Connection.NwkSKey;
-        appSKey = childNode->Connection.AppSKey;
-    } else if ( (multicastGrp = LoRaMesh_FindMulticastGroup(devAddr)) != NULL ) {
-        nwkSKey = multicastGrp->Connection.NwkSKey;
-        appSKey = multicastGrp->Connection.AppSKey;
-        isMulticast = true;
+    // Decode frame options MAC commands
+    if ( !isMulticast && fCtrl.Bits.FOptsLen > 0 ) {
+        LoRaMac_ProcessCommands(packet->phyData, LORAFRM_BUF_IDX_OPTS,
+                LORAFRM_BUF_IDX_OPTS + fCtrl.Bits.FOptsLen);
     }
 
-    /* Down link link from parent node or network server received */
-    if ( fPort == 0 && !isMulticast ) {
-        /* Decrypt with encrypt function */
-        LoRaMacPayloadEncrypt(LORAFRM_BUF_PAYLOAD_START_WPORT(packet->phyData), fPayloadSize,
-                nwkSKey, devAddr, fDir, fCnt, fBuffer);
+    /* Frame without port and payload */
+    if ( LORAPHY_BUF_SIZE(packet->phyData) < (fHdrSize + LORAFRM_PORT_SIZE + LORAMAC_MIC_SIZE) ) {
+        return ERR_OK;
+    }
 
-        // Decode frame payload MAC commands
-        LoRaMac_ProcessCommands(fBuffer, 0, fPayloadSize);
-    } else {
-        /* Decrypt with encrypt function */
-        LoRaMacPayloadEncrypt(LORAFRM_BUF_PAYLOAD_START_WPORT(packet->phyData), fPayloadSize,
-                appSKey, devAddr, fDir, fCnt, fBuffer);
+    fPort = packet->phyData[LORAFRM_BUF_IDX_PORT(fCtrl.Bits.FOptsLen)];
+    fPayload = &packet->phyData[LORAFRM_BUF_IDX_PORT(fCtrl.Bits.FOptsLen) + LORAFRM_PORT_SIZE];
+    fPayloadSize = LORAPHY_BUF_SIZE(packet->phyData) - fHdrSize - LORAFRM_PORT_SIZE
+            - LORAMAC_MIC_SIZE;
+
+    /* The MIC has already been verified, decrypt in place inside the PHY buffer */
+    if ( (packet->flags & LORAPHY_PACKET_FLAGS_DECRYPTED) == 0 ) {
+        LoRaMacCryptoCtrInit(&cryptoCtx, (fPort == 0 && !isMulticast) ? nwkSKey : appSKey,
+                devAddr, fDir, fCnt);
+        LoRaMacCryptoCtrUpdate(&cryptoCtx, fPayload, fPayloadSize, fPayload);
+        LoRaMacCryptoCtxClear(&cryptoCtx);
     }
 
-    // Decode frame options MAC commands
-    if ( !isMulticast && fCtrl.Bits.FOptsLen > 0 )
-        LoRaMac_ProcessCommands(fBuffer, LORAFRM_HEADER_SIZE_MIN + LORAMAC_HEADER_SIZE,
-                fPayloadSize);
+    if ( fPort == 0 && !isMulticast ) {
+        // Decode frame payload MAC commands
+        LoRaMac_ProcessCommands(fPayload, 0, fPayloadSize);
+    }
 
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("%s - Size %d", __FUNCTION__, fPayloadSize);
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < fPayloadSize; i++ )
-    LOG_TRACE_BARE("0x%02x ", fBuffer[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(fPayload, fPayloadSize);
 #endif
+    LORASTATS_INC(Frm, RxFrames);
 
-    return LoRaMesh_OnPacketRx((uint8_t*) &fBuffer, fPayloadSize, devAddr, fPort); /* Pass message up the stack */
+    return LoRaMesh_OnPacketRx(fPayload, fPayloadSize, devAddr, fPort); /* Pass message up the stack */
 }
 
 uint8_t LoRaFrm_PutPayload( uint8_t* buf, uint16_t bufSize, uint8_t payloadSize, uint32_t devAddr,
         uint8_t fPort, bool isConfirmed )
 {
     uint8_t pktHdrSize = 0, fBuffer[LORAFRM_BUFFER_SIZE], *nwkSKey, *appSKey;
-    MulticastGroupInfo_t *multicastGrp;
-    ChildNodeInfo_t *childNode;
+    LoRaMacCryptoCtx_t cryptoCtx;
+    LoRaMeshSession_t *session;
     LoRaMac_MsgType_t msgType;
     LoRaFrm_Ctrl_t fCtrl;
     LoRaFrm_Dir_t fDir;
     uint32_t fCnt;
+    uint8_t status;
     bool isMulticast = false;
 
     /* Initialize buffer */
     memset1(fBuffer, 0U, LORAFRM_BUFFER_SIZE);
 
     /* Evaluate what kind of message it is */
-    if ( pLoRaDevice->devAddr == devAddr ) {
+    if ( (session = LoRaSession_Find(devAddr)) == NULL ) {
+        return ERR_FAILED;
+    }
+    nwkSKey = session->Connection->NwkSKey;
+    appSKey = session->Connection->AppSKey;
+
+    if ( session->Type == SESSION_TYPE_UPLINK ) {
         msgType = (isConfirmed ? MSG_TYPE_DATA_CONFIRMED_UP : MSG_TYPE_DATA_UNCONFIRMED_UP);
         fDir = UP_LINK;
-        nwkSKey = pLoRaDevice->upLinkSlot.NwkSKey;
-        appSKey = pLoRaDevice->upLinkSlot.AppSKey;
-        fCnt = pLoRaDevice->upLinkSlot.UpLinkCounter;
-    } else if ( (childNode = LoRaMesh_FindChildNode(devAddr)) != NULL ) {
+        fCnt = session->Connection->UpLinkCounter;
+    } else if ( session->Type == SESSION_TYPE_CHILD_NODE ) {
         msgType = (isConfirmed ? MSG_TYPE_DATA_CONFIRMED_DOWN : MSG_TYPE_DATA_UNCONFIRMED_DOWN);
         fDir = DOWN_LINK;
-        nwkSKey = childNode->Connection.NwkSKey;
-        appSKey = childNode->Connection.AppSKey;
-        fCnt = childNode->Connection.DownLinkCounter;
-    } else if ( (multicastGrp = LoRaMesh_FindMulticastGroup(devAddr)) != NULL ) {
+        fCnt = session->Connection->DownLinkCounter;
+    } else {
         msgType = MSG_TYPE_DATA_UNCONFIRMED_DOWN;
         fDir = DOWN_LINK;
-        nwkSKey = multicastGrp->Connection.NwkSKey;
-        appSKey = multicastGrp->Connection.AppSKey;
-        fCnt = multicastGrp->Connection.DownLinkCounter;
+        fCnt = session->Connection->DownLinkCounter;
         isMulticast = true;
         isConfirmed = false;
     }
@@ -140,13 +137,13 @@ uint8_t LoRaFrm_PutPayload( uint8_t* buf, uint16_t bufSize, uint8_t payloadSize,
     fCtrl.Bits.AdrAckReq = 0;
     fCtrl.Bits.Adr = pLoRaDevice->ctrlFlags.Bits.adrCtrlOn;
 
-    /* Payload encryption */
-    if ( (payloadSize > 0) && !isMulticast && (fPort == 0) ) { /* Encrypt frame payload with NwkSKey */
-        LoRaMacPayloadEncrypt(buf, payloadSize, nwkSKey, devAddr, fDir, fCnt,
-                (LORAFRM_BUF_PAYLOAD_START_WPORT(fBuffer) + pLoRaDevice->macCmdBufferIndex));
-    } else if ( payloadSize > 0 ) { /* Encrypt frame payload with AppSKey */
-        LoRaMacPayloadEncrypt(buf, payloadSize, appSKey, devAddr, fDir, fCnt,
+    /* Payload encryption, the frame payload of port 0 is encrypted with the NwkSKey */
+    if ( payloadSize > 0 ) {
+        LoRaMacCryptoCtrInit(&cryptoCtx, (!isMulticast && (fPort == 0)) ? nwkSKey : appSKey,
+                devAddr, fDir, fCnt);
+        LoRaMacCryptoCtrUpdate(&cryptoCtx, buf, payloadSize,
                 (LORAFRM_BUF_PAYLOAD_START_WPORT(fBuffer) + pLoRaDevice->macCmdBufferIndex));
+        LoRaMacCryptoCtxClear(&cryptoCtx);
     }
 
     /* Send ACK if pending */
@@ -204,13 +201,21 @@ uint8_t LoRaFrm_PutPayload( uint8_t* buf, uint16_t bufSize, uint8_t payloadSize,
 
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("%s - Size %d", __FUNCTION__, payloadSize);
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < (payloadSize + 3); i++ )
-    LOG_TRACE_BARE("0x%02x ", fBuffer[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(fBuffer, payloadSize + 3);
 #endif
-    return LoRaMac_PutPayload(fBuffer, sizeof(fBuffer), payloadSize, msgType, devAddr, fCnt,
-            nwkSKey, isMulticast);
+    LORASTATS_INC(Frm, TxFrames);
+    status = LoRaMac_PutPayload(fBuffer, sizeof(fBuffer), payloadSize, msgType, devAddr, fCnt,
+            nwkSKey, session->Connection->ChannelIndex, isMulticast);
+    if ( status == ERR_OK ) {
+        /* The counter holds the value of the next frame */
+        if ( fDir == DOWN_LINK ) {
+            session->Connection->DownLinkCounter++;
+        } else if ( pLoRaDevice->dbgFlags.Bits.upLinkCounterFixed == 0 ) {
+            session->Connection->UpLinkCounter++;
+        }
+        LoRaMesh_StoreFrameCounters(session);
+    }
+    return status;
 }
 
 /*******************************************************************************
@@ -76,13 +76,21 @@ typedef enum LoRaFrm_Dir_e {
 void LoRaFrm_Init( void );
 
 /*!
- * \brief
+ * \brief Handles a received frame whose MIC has already been verified by the
+ * MAC layer. The frame payload is decrypted in place inside the PHY buffer.
  *
  * \param packet Pointer to the packet descriptor
- * \return Error code, ERR_OK if everything is ok, ERR_OVERFLOW if buffer is too small.
+ * \param devAddr Session address
+ * \param fDir Frame direction
+ * \param fCnt Frame counter
+ * \param nwkSKey Network session key of the session
+ * \param appSKey Application session key of the session
+ * \param isMulticast True if the frame belongs to a multicast group
+ * \return Error code, ERR_OK if everything is ok, ERR_FAILED if frame is malformed.
  */
 uint8_t LoRaFrm_OnPacketRx( LoRaPhy_PacketDesc *packet, uint32_t devAddr,
-        LoRaFrm_Dir_t fDir, uint32_t fCnt );
+        LoRaFrm_Dir_t fDir, uint32_t fCnt, uint8_t *nwkSKey, uint8_t *appSKey,
+        bool isMulticast );
 
 /*!
  * \brief Puts a payload into the buffer queue to be sent asynchronously.
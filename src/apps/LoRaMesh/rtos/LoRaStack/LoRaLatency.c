@@ -0,0 +1,256 @@
+/**
+ * \file LoRaLatency.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa stack packet latency tracing
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaLatency.h"
+
+#define LOG_LEVEL_TRACE
+#include "debug.h"
+
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Histograms of the stages followed by the rx and tx totals */
+#define NB_HISTOGRAMS                       (LATENCY_NB_STAGES + 2)
+#define HIST_RX_TOTAL                       (LATENCY_NB_STAGES)
+#define HIST_TX_TOTAL                       (LATENCY_NB_STAGES + 1)
+
+/*! Frames put at the same time, each task puts one frame at a time */
+#define NB_TX_TASKS                         (4)
+
+#if (INCLUDE_xTaskGetCurrentTaskHandle == 0) && (configUSE_MUTEXES == 0)
+#error "LoRaLatency needs xTaskGetCurrentTaskHandle"
+#endif
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Trace of the frame a task is putting, until it is queued */
+typedef struct {
+    bool InUse;
+    TaskHandle_t Task;
+    LoRaLatency_Trace_t Trace;
+} TxTrace_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Stage histograms */
+static LoRaLatency_Hist_t Hist[NB_HISTOGRAMS];
+
+/*! Cycles at the last radio interrupt */
+static volatile uint32_t IrqCycles;
+
+/*! Id of the next trace */
+static uint16_t NextId = 1;
+
+/*! Trace of the frame processed by the stack task */
+static LoRaLatency_Trace_t *RxTrace;
+
+/*! Traces of the frames being put */
+static TxTrace_t TxTraces[NB_TX_TASKS];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Starts a trace */
+static void Start( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage, uint32_t cycles );
+
+/*! \brief Returns the trace of the frame the calling task is putting */
+static TxTrace_t *FindTx( bool alloc );
+
+/*! \brief Adds a time to a histogram */
+static void HistAdd( LoRaLatency_Hist_t *hist, uint32_t us );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaLatency_Reset( void )
+{
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    memset1((uint8_t*) Hist, 0U, sizeof(Hist));
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+}
+
+void LoRaLatency_OnRadioIrq( void )
+{
+    IrqCycles = TimerHwGetCycles();
+}
+
+void LoRaLatency_StartRx( LoRaLatency_Trace_t *trace )
+{
+    Start(trace, LATENCY_STAGE_RX_IRQ, IrqCycles);
+    LoRaLatency_Stamp(trace, LATENCY_STAGE_RX_QUEUE);
+}
+
+void LoRaLatency_SetRx( LoRaLatency_Trace_t *trace )
+{
+    RxTrace = trace;
+}
+
+void LoRaLatency_StampRx( LoRaLatency_Stage_t stage )
+{
+    if ( RxTrace != NULL ) {
+        LoRaLatency_Stamp(RxTrace, stage);
+    }
+}
+
+void LoRaLatency_StampTx( LoRaLatency_Stage_t stage )
+{
+    TxTrace_t *tx = FindTx(stage == LATENCY_STAGE_TX_MESH);
+
+    if ( tx == NULL ) {
+        return; /* Not started or all entries in use, the frame is not traced */
+    }
+    if ( stage == LATENCY_STAGE_TX_MESH ) {
+        Start(&tx->Trace, stage, TimerHwGetCycles());
+    } else {
+        LoRaLatency_Stamp(&tx->Trace, stage);
+    }
+}
+
+void LoRaLatency_TakeTx( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage )
+{
+    TxTrace_t *tx = FindTx(false);
+
+    /* Frames put below the mesh layer (advertising, tests) have no trace */
+    if ( tx == NULL ) {
+        trace->Id = 0;
+        return;
+    }
+    LoRaLatency_Stamp(&tx->Trace, stage);
+    *trace = tx->Trace;
+    tx->InUse = false;
+}
+
+void LoRaLatency_EndTx( void )
+{
+    TxTrace_t *tx = FindTx(false);
+
+    /* The frame has not been queued */
+    if ( tx != NULL ) {
+        tx->InUse = false;
+    }
+}
+
+void LoRaLatency_Stamp( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage )
+{
+    uint32_t cycles = TimerHwGetCycles();
+    uint32_t us, first, total = 0;
+    UBaseType_t uxSavedInterruptStatus;
+
+    /* Stages are stamped in order, a repeated or skipped back stage is ignored */
+    if ( trace->Id == 0 || stage <= trace->Stage ) {
+        return;
+    }
+    first = (stage < LATENCY_STAGE_TX_MESH) ? LATENCY_STAGE_RX_IRQ : LATENCY_STAGE_TX_MESH;
+    us = (cycles - trace->Last) / TIMER_HW_CYCLES_PER_US;
+    trace->Time[stage - first - 1] = us;
+    trace->Last = cycles;
+    trace->Stage = stage;
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    HistAdd(&Hist[stage], us);
+    if ( stage == LATENCY_STAGE_RX_APP || stage == LATENCY_STAGE_TX_DONE ) {
+        total = (cycles - trace->Start) / TIMER_HW_CYCLES_PER_US;
+        HistAdd(&Hist[(stage == LATENCY_STAGE_RX_APP) ? HIST_RX_TOTAL : HIST_TX_TOTAL], total);
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    if ( stage == LATENCY_STAGE_RX_APP || stage == LATENCY_STAGE_TX_DONE ) {
+        LOG_TRACE("Latency %s #%u: %u %u %u %u %u us, total %u us.",
+                (stage == LATENCY_STAGE_RX_APP) ? "rx" : "tx", trace->Id, trace->Time[0],
+                trace->Time[1], trace->Time[2], trace->Time[3], trace->Time[4], total);
+        trace->Id = 0;
+    }
+}
+
+void LoRaLatency_GetHist( uint8_t stage, LoRaLatency_Hist_t *hist )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    if ( stage >= NB_HISTOGRAMS ) {
+        memset1((uint8_t*) hist, 0U, sizeof(LoRaLatency_Hist_t));
+        return;
+    }
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    *hist = Hist[stage];
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void Start( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage, uint32_t cycles )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    memset1((uint8_t*) trace->Time, 0U, sizeof(trace->Time));
+    trace->Stage = stage;
+    trace->Start = cycles;
+    trace->Last = cycles;
+
+    /* Rx traces are started by the radio interrupt */
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    trace->Id = NextId++;
+    if ( NextId == 0 ) {
+        NextId = 1;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+}
+
+static TxTrace_t *FindTx( bool alloc )
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    TxTrace_t *tx = NULL, *free = NULL;
+    UBaseType_t uxSavedInterruptStatus;
+    uint8_t i;
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    for ( i = 0; i < NB_TX_TASKS; i++ ) {
+        if ( !TxTraces[i].InUse ) {
+            if ( free == NULL ) free = &TxTraces[i];
+        } else if ( TxTraces[i].Task == task ) {
+            tx = &TxTraces[i];
+            break;
+        }
+    }
+    if ( tx == NULL && alloc && free != NULL ) {
+        free->InUse = true;
+        free->Task = task;
+        tx = free;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    return tx;
+}
+
+static void HistAdd( LoRaLatency_Hist_t *hist, uint32_t us )
+{
+    uint8_t bucket = (us == 0) ? 0 : (32 - __builtin_clz(us));
+
+    if ( bucket >= LORALATENCY_NB_BUCKETS ) {
+        bucket = LORALATENCY_NB_BUCKETS - 1;
+    }
+    if ( hist->Bucket[bucket] < 0xFFFF ) {
+        hist->Bucket[bucket]++;
+    }
+    hist->Count++;
+    hist->Sum += us;
+    if ( us > hist->Max ) {
+        hist->Max = us;
+    }
+}
+#endif /* LORAMESH_CONFIG_LATENCY_ENABLED */
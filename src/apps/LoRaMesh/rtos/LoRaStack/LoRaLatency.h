@@ -0,0 +1,178 @@
+/**
+ * \file LoRaLatency.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa stack packet latency tracing
+ *
+ * Every frame gets a trace when it enters the stack, the radio interrupt for
+ * received frames and LoRaMesh_PutPayload for sent frames. A frame being
+ * put is traced per calling task until it is queued, then the trace travels
+ * with the PHY pool buffer. Each stage the
+ * frame passes stamps the trace with the core cycle counter, the time since
+ * the previous stage is added to the histogram of the stage. The last stage
+ * adds the total time to the histogram of the direction and logs the stage
+ * times of the frame with LOG_TRACE, decoded on the host with the trace
+ * logger tools.
+ *
+ * Rx: IRQ -> QUEUE (FIFO read, queued) -> PHY (dequeued) -> FRM (MIC verified)
+ *     -> MESH (decrypted) -> APP (port handler returned)
+ * Tx: MESH (put) -> MAC (encrypted) -> QUEUE (MIC computed, queued)
+ *     -> PHY (dequeued for sending) -> RADIO (radio configured, FIFO written)
+ *     -> DONE (tx done interrupt)
+ */
+
+#ifndef __LORALATENCY_H_
+#define __LORALATENCY_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdint.h>
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Number of histogram buckets, bucket n counts times in [2^(n-1), 2^n) us */
+#define LORALATENCY_NB_BUCKETS                  (16)
+
+/*******************************************************************************
+ * MACRO DEFINITIONS
+ ******************************************************************************/
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+#define LORALATENCY_RADIO_IRQ()                 LoRaLatency_OnRadioIrq()
+#define LORALATENCY_RX(stage)                   LoRaLatency_StampRx(stage)
+#define LORALATENCY_TX(stage)                   LoRaLatency_StampTx(stage)
+#define LORALATENCY_START_RX(trace)             LoRaLatency_StartRx(trace)
+#define LORALATENCY_SET_RX(trace)               LoRaLatency_SetRx(trace)
+#define LORALATENCY_TAKE_TX(trace, stage)       LoRaLatency_TakeTx(trace, stage)
+#define LORALATENCY_END_TX()                    LoRaLatency_EndTx()
+#define LORALATENCY_STAMP(trace, stage)         LoRaLatency_Stamp(trace, stage)
+#else
+#define LORALATENCY_RADIO_IRQ()
+#define LORALATENCY_RX(stage)
+#define LORALATENCY_TX(stage)
+#define LORALATENCY_START_RX(trace)
+#define LORALATENCY_SET_RX(trace)
+#define LORALATENCY_TAKE_TX(trace, stage)
+#define LORALATENCY_END_TX()
+#define LORALATENCY_STAMP(trace, stage)
+#endif
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Trace stages, the first stage of a direction starts the trace */
+typedef enum {
+    LATENCY_STAGE_RX_IRQ,
+    LATENCY_STAGE_RX_QUEUE,
+    LATENCY_STAGE_RX_PHY,
+    LATENCY_STAGE_RX_FRM,
+    LATENCY_STAGE_RX_MESH,
+    LATENCY_STAGE_RX_APP,
+    LATENCY_STAGE_TX_MESH,
+    LATENCY_STAGE_TX_MAC,
+    LATENCY_STAGE_TX_QUEUE,
+    LATENCY_STAGE_TX_PHY,
+    LATENCY_STAGE_TX_RADIO,
+    LATENCY_STAGE_TX_DONE,
+    LATENCY_NB_STAGES
+} LoRaLatency_Stage_t;
+
+/*! Number of stages of a direction */
+#define LORALATENCY_NB_RX_STAGES                (LATENCY_STAGE_TX_MESH - LATENCY_STAGE_RX_IRQ)
+#define LORALATENCY_NB_TX_STAGES                (LATENCY_NB_STAGES - LATENCY_STAGE_TX_MESH)
+
+/*! Trace of a frame */
+typedef struct LoRaLatency_Trace_s {
+    uint16_t Id; /* Trace id, 0 if no trace is running */
+    uint8_t Stage; /* Last stage stamped */
+    uint32_t Start; /* Cycles at the first stage */
+    uint32_t Last; /* Cycles at the last stage */
+    uint32_t Time[LORALATENCY_NB_TX_STAGES]; /* Time per stage [us] */
+} LoRaLatency_Trace_t;
+
+/*! Time statistics of a stage or of a direction */
+typedef struct LoRaLatency_Hist_s {
+    uint32_t Count;
+    uint32_t Sum; /* us */
+    uint32_t Max; /* us */
+    uint16_t Bucket[LORALATENCY_NB_BUCKETS]; /* Saturating */
+} LoRaLatency_Hist_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears the histograms.
+ */
+void LoRaLatency_Reset( void );
+
+/*!
+ * \brief Records the time of the radio interrupt, called first in the DIO0
+ *        interrupt of the radio driver.
+ */
+void LoRaLatency_OnRadioIrq( void );
+
+/*!
+ * \brief Starts the trace of a received frame at the radio interrupt and
+ *        stamps LATENCY_STAGE_RX_QUEUE.
+ *
+ * \param trace Trace of the pool buffer holding the frame.
+ */
+void LoRaLatency_StartRx( LoRaLatency_Trace_t *trace );
+
+/*!
+ * \brief Selects the trace of the frame processed by the stack task, the
+ *        following LORALATENCY_RX stamps go to this trace.
+ *
+ * \param trace Trace of the frame, NULL when done.
+ */
+void LoRaLatency_SetRx( LoRaLatency_Trace_t *trace );
+
+/*!
+ * \brief Stamps the frame processed by the stack task.
+ */
+void LoRaLatency_StampRx( LoRaLatency_Stage_t stage );
+
+/*!
+ * \brief Stamps the frame being put by the calling task, LATENCY_STAGE_TX_MESH
+ *        starts a new trace.
+ */
+void LoRaLatency_StampTx( LoRaLatency_Stage_t stage );
+
+/*!
+ * \brief Stamps the frame being put and moves its trace to the pool buffer
+ *        of the frame.
+ *
+ * \param trace Trace of the pool buffer.
+ * \param stage Stage to stamp.
+ */
+void LoRaLatency_TakeTx( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage );
+
+/*!
+ * \brief Drops the trace of the frame being put by the calling task if the
+ *        frame has not been queued.
+ */
+void LoRaLatency_EndTx( void );
+
+/*!
+ * \brief Stamps a trace, may be called from any context.
+ *
+ * \param trace Trace of the frame.
+ * \param stage Stage to stamp.
+ */
+void LoRaLatency_Stamp( LoRaLatency_Trace_t *trace, LoRaLatency_Stage_t stage );
+
+/*!
+ * \brief Returns a copy of the histogram of a stage.
+ *
+ * \param stage Stage, LATENCY_NB_STAGES for the rx total, LATENCY_NB_STAGES + 1
+ *        for the tx total.
+ * \param hist Histogram copy.
+ */
+void LoRaLatency_GetHist( uint8_t stage, LoRaLatency_Hist_t *hist );
+
+#endif /* __LORALATENCY_H_ */
@@ -0,0 +1,54 @@
+/**
+ * \file LoRaLbt.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa listen before talk channel access
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaLbt.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define LBT_BACKOFF_SLOT                    (LORAMESH_CONFIG_LBT_BACKOFF_SLOT_MS)
+#define LBT_MIN_BACKOFF_EXP                 (LORAMESH_CONFIG_LBT_MIN_BACKOFF_EXP)
+#define LBT_MAX_BACKOFF_EXP                 (LORAMESH_CONFIG_LBT_MAX_BACKOFF_EXP)
+#define LBT_MAX_ATTEMPTS                    (LORAMESH_CONFIG_LBT_MAX_ATTEMPTS)
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaLbt_Reset( LoRaLbt_t *lbt )
+{
+    lbt->Attempts = 0;
+}
+
+bool LoRaLbt_Assess( LoRaLbt_t *lbt )
+{
+    if ( lbt->Attempts >= LBT_MAX_ATTEMPTS ) {
+        return false;
+    }
+    lbt->Attempts++;
+    return true;
+}
+
+bool LoRaLbt_OnBusy( LoRaLbt_t *lbt, uint32_t *backoff )
+{
+    uint8_t exp = LBT_MIN_BACKOFF_EXP + lbt->Attempts - 1;
+
+    if ( lbt->Attempts >= LBT_MAX_ATTEMPTS ) {
+        return false;
+    }
+    if ( exp > LBT_MAX_BACKOFF_EXP ) {
+        exp = LBT_MAX_BACKOFF_EXP;
+    }
+    /* The range doubles with each busy assessment */
+    *backoff = (uint32_t) randr(0, (1 << exp) - 1) * LBT_BACKOFF_SLOT;
+    return true;
+}
@@ -0,0 +1,68 @@
+/**
+ * \file LoRaLbt.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa listen before talk channel access
+ *
+ * The channel is assessed before a frame is sent, up to
+ * LORAMESH_CONFIG_LBT_MAX_ATTEMPTS times per frame. A busy channel defers the
+ * frame by randr(0, 2^exp - 1) backoff slots of
+ * LORAMESH_CONFIG_LBT_BACKOFF_SLOT_MS, exp starting at
+ * LORAMESH_CONFIG_LBT_MIN_BACKOFF_EXP and growing by one per busy assessment
+ * up to LORAMESH_CONFIG_LBT_MAX_BACKOFF_EXP. Once the attempts are used up
+ * the frame is sent regardless. The channel assessment itself (CAD or RSSI)
+ * is left to LoRaPhy.
+ */
+
+#ifndef __LORALBT_H_
+#define __LORALBT_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Channel access state of the frame to be sent */
+typedef struct LoRaLbt_s {
+    uint8_t Attempts; /* Channel assessments of the frame */
+} LoRaLbt_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Starts the channel access of a new frame.
+ *
+ * \param lbt Channel access state.
+ */
+void LoRaLbt_Reset( LoRaLbt_t *lbt );
+
+/*!
+ * \brief Decides if the channel is assessed before the frame is sent.
+ *
+ * \param lbt Channel access state.
+ *
+ * \retval bool True if the channel has to be assessed, false if the attempts
+ *         are used up and the frame is sent right away.
+ */
+bool LoRaLbt_Assess( LoRaLbt_t *lbt );
+
+/*!
+ * \brief Handles a busy channel.
+ *
+ * \param lbt Channel access state.
+ * \param backoff Time the frame is deferred by [ms].
+ *
+ * \retval bool True if the frame is deferred, false if it was the last attempt
+ *         and the frame is sent regardless.
+ */
+bool LoRaLbt_OnBusy( LoRaLbt_t *lbt, uint32_t *backoff );
+
+#endif /* __LORALBT_H_ */
@@ -35,6 +35,39 @@ static LoRaMac_BatteryLevelCallback_t batteryLevelCallback = NULL;
 /*******************************************************************************
  * PRIVATE FUNCTION PROTOTYPES (STATIC)
  ******************************************************************************/
+/*! \brief Restores the full frame counter from the 16 bit counter of a frame */
+static uint32_t GetFrameCounter( uint8_t *cntrBuf, uint32_t frameCntr );
+
+/*! \brief Computes the MIC of a data or routed frame with a crypto context of the caller */
+static void ComputeMic( const uint8_t *buf, uint16_t size, const uint8_t *key, uint32_t addr,
+        uint8_t dir, uint32_t seqCntr, uint32_t *mic );
+
+/*! \brief Computes the MIC of a join frame with a crypto context of the caller */
+static void JoinComputeMic( const uint8_t *buf, uint16_t size, const uint8_t *key, uint32_t *mic );
+
+#if(LORAMESH_CONFIG_RX_SINGLE_PASS == 1)
+/*! \brief Returns true if a data frame is forwarded by this node, not delivered to it */
+static bool IsForwarded( LoRaPhy_PacketDesc *packet, LoRaFrm_Dir_t dir );
+
+/*! \brief Computes the MIC of a data frame and decrypts its FRMPayload in place, one pass */
+static void ComputeMicDecrypt( uint8_t *buf, uint16_t size, const uint8_t *nwkSKey,
+        const uint8_t *appSKey, uint32_t addr, uint8_t dir, uint32_t seqCntr, bool isMulticast,
+        uint32_t *mic );
+#endif
+
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+/*! \brief Checks a routed frame, delivers it at its destination or forwards it */
+static uint8_t OnRoutedFrame( LoRaPhy_PacketDesc *packet );
+
+/*! \brief Returns true if the frame of a child node is to be forwarded to the coordinator */
+static bool IsRoutedUpLink( LoRaPhy_PacketDesc *packet );
+
+/*! \brief Wraps the frame of a child node into a routed frame to the coordinator */
+static uint8_t RouteUpLink( LoRaPhy_PacketDesc *packet );
+
+/*! \brief Writes the route header and the MIC of the next hop, queues the frame */
+static uint8_t SendRouted( uint8_t *buf, uint8_t payloadSize, uint8_t rCtrl, uint32_t dest );
+#endif
 
 /*******************************************************************************
  * API FUNCTIONS (PUBLIC)
@@ -46,13 +79,12 @@ void LoRaMac_Init( LoRaMac_BatteryLevelCallback_t callback )
 
 uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
 {
-    uint8_t *payload, payloadSize, macRxBuffer[LORAMAC_BUFFER_SIZE], *micKey;
-    uint32_t micRx = 0, mic = 0, frameCntr = 0, devAddr, rxAddr;
-    uint16_t sequenceCntr = 0, sequenceCntrDiff = 0;
-    MulticastGroupInfo_t *curMulticastGrp = NULL;
-    ChildNodeInfo_t *curChildNode = NULL;
+    uint8_t *payload, payloadSize, *macFrame, *nwkSKey, *appSKey;
+    uint32_t micRx = 0, mic = 0, frameCntr = 0, devAddr, rxAddr, *rxCntr;
+    LoRaMeshSession_t *session;
     LoRaFrm_Dir_t frameDir;
     LoRaMac_Header_t macHdr;
+    bool isMulticast = false;
 
     payload = packet->phyData;
     payloadSize = LORAPHY_BUF_SIZE(packet->phyData);
@@ -60,13 +92,19 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
     /* Check if incoming packet is an advertising beacon */
     if ( (packet->flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_ADVERTISING ) {
         LOG_TRACE("Received advertising beacon.");
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+        LoRaRoute_OnAdvertising(payload, payloadSize, packet->snr);
+#endif
         return LoRaMesh_ProcessAdvertising(payload, payloadSize);
     }
 
     macHdr.Value = LORAMAC_BUF_HDR(packet->phyData);
 
     /* Check if message version matches*/
-    if ( macHdr.Bits.Major != LORAMESH_CONFIG_MAJOR_VERSION ) return ERR_FAILED;
+    if ( macHdr.Bits.Major != LORAMESH_CONFIG_MAJOR_VERSION ) {
+        LORASTATS_INC(Mac, InvalidFrames);
+        return ERR_FAILED;
+    }
 
     switch ( macHdr.Bits.MType ) {
         case MSG_TYPE_JOIN_REQ:
@@ -88,39 +126,40 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
             if ( pLoRaDevice->ctrlFlags.Bits.nwkJoined == 1 ) {
                 return ERR_FAILED;
             }
-            LoRaMacJoinDecrypt(LORAMAC_BUF_PAYLOAD_START(payload), payloadSize - 1,
-                    pLoRaDevice->appKey, macRxBuffer + 1);
+            /* Decrypt in place, the frame is dropped anyway if the MIC does not match */
+            macFrame = LORAPHY_BUF_PAYLOAD_START(payload);
+            LoRaMacJoinDecrypt(macFrame + 1, payloadSize - 1, pLoRaDevice->appKey, macFrame + 1);
 
-            macRxBuffer[0] = macHdr.Value;
+            JoinComputeMic(macFrame, payloadSize - LORAMAC_MIC_SIZE, pLoRaDevice->appKey, &mic);
 
-            LoRaMacJoinComputeMic(macRxBuffer, payloadSize - LORAMAC_MIC_SIZE, pLoRaDevice->appKey,
-                    &mic);
-
-            micRx |= ((uint32_t) macRxBuffer[payloadSize - LORAMAC_MIC_SIZE]);
-            micRx |= ((uint32_t) macRxBuffer[payloadSize - LORAMAC_MIC_SIZE + 1] << 8);
-            micRx |= ((uint32_t) macRxBuffer[payloadSize - LORAMAC_MIC_SIZE + 2] << 16);
-            micRx |= ((uint32_t) macRxBuffer[payloadSize - LORAMAC_MIC_SIZE + 3] << 24);
+            micRx |= ((uint32_t) macFrame[payloadSize - LORAMAC_MIC_SIZE]);
+            micRx |= ((uint32_t) macFrame[payloadSize - LORAMAC_MIC_SIZE + 1] << 8);
+            micRx |= ((uint32_t) macFrame[payloadSize - LORAMAC_MIC_SIZE + 2] << 16);
+            micRx |= ((uint32_t) macFrame[payloadSize - LORAMAC_MIC_SIZE + 3] << 24);
 
             if ( micRx == mic ) {
                 uint8_t receiveDelay1, receiveDelay2;
 
-                LoRaMacJoinComputeSKeys(pLoRaDevice->appKey, (macRxBuffer + 1),
+                /* Session keys change, drop the cached key schedules of the former session */
+                LoRaMacCryptoInvalidateKeys(pLoRaDevice->devAddr);
+                LoRaMacJoinComputeSKeys(pLoRaDevice->appKey, (macFrame + 1),
                         pLoRaDevice->devNonce, pLoRaDevice->upLinkSlot.NwkSKey,
                         pLoRaDevice->upLinkSlot.AppSKey);
+                LoRaMacCryptoInvalidateKeys(LORAMAC_CRYPTO_JOIN_ADDRESS);
 
-                pLoRaDevice->netId = (uint32_t) macRxBuffer[4];
-                pLoRaDevice->netId |= ((uint32_t) macRxBuffer[5] << 8);
-                pLoRaDevice->netId |= ((uint32_t) macRxBuffer[6] << 16);
+                pLoRaDevice->netId = (uint32_t) macFrame[4];
+                pLoRaDevice->netId |= ((uint32_t) macFrame[5] << 8);
+                pLoRaDevice->netId |= ((uint32_t) macFrame[6] << 16);
 
-                pLoRaDevice->devAddr = (uint32_t) macRxBuffer[7];
-                pLoRaDevice->devAddr |= ((uint32_t) macRxBuffer[8] << 8);
-                pLoRaDevice->devAddr |= ((uint32_t) macRxBuffer[9] << 16);
-                pLoRaDevice->devAddr |= ((uint32_t) macRxBuffer[10] << 24);
+                LoRaMesh_SetDevAddr(
+                        (uint32_t) macFrame[7] | ((uint32_t) macFrame[8] << 8)
+                                | ((uint32_t) macFrame[9] << 16)
+                                | ((uint32_t) macFrame[10] << 24));
 
                 // DLSettings
-                LoRaPhy_SetDownLinkSettings((macRxBuffer[11] >> 4) & 0x07, macRxBuffer[11] & 0x0F);
+                LoRaPhy_SetDownLinkSettings((macFrame[11] >> 4) & 0x07, macFrame[11] & 0x0F);
                 // RxDelay
-                receiveDelay1 = (macRxBuffer[12] & 0x0F);
+                receiveDelay1 = (macFrame[12] & 0x0F);
                 if ( receiveDelay1 == 0 ) {
                     receiveDelay1 = 1;
                 }
@@ -136,15 +175,17 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
                     param.DrRange.Value = (DR_5 << 4) | DR_0;
 
                     for ( uint8_t i = 3, j = 0; i < (5 + 3); i++, j += 3 ) {
-                        param.Frequency = ((uint32_t) macRxBuffer[13 + j]
-                                | ((uint32_t) macRxBuffer[14 + j] << 8)
-                                | ((uint32_t) macRxBuffer[15 + j] << 16)) * 100;
+                        param.Frequency = ((uint32_t) macFrame[13 + j]
+                                | ((uint32_t) macFrame[14 + j] << 8)
+                                | ((uint32_t) macFrame[15 + j] << 16)) * 100;
                         LoRaPhy_SetChannel(i, param);
                     }
                 }
                 pLoRaDevice->ctrlFlags.Bits.nwkJoined = 1;
+                LoRaMesh_StoreSession();
                 return ERR_OK;
             } else {
+                LORASTATS_INC(Mac, MicFailures);
                 return ERR_FAILED;
             }
             break;
@@ -158,13 +199,17 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
             rxAddr |= ((uint32_t) payload[LORAFRM_BUF_IDX_DEVADDR + 2] << 16);
             rxAddr |= ((uint32_t) payload[LORAFRM_BUF_IDX_DEVADDR + 3] << 24);
 
-            if ( (curMulticastGrp = LoRaMesh_FindMulticastGroup(rxAddr)) != NULL ) {
-                micKey = curMulticastGrp->Connection.NwkSKey;
-                frameCntr = curMulticastGrp->Connection.DownLinkCounter;
-                devAddr = curMulticastGrp->Connection.Address;
+            session = LoRaSession_Find(rxAddr);
+            if ( session != NULL && session->Type == SESSION_TYPE_MULTICAST ) {
+                nwkSKey = session->Connection->NwkSKey;
+                appSKey = session->Connection->AppSKey;
+                rxCntr = &session->Connection->DownLinkCounter;
+                devAddr = session->Address;
+                isMulticast = true;
             } else {
-                micKey = pLoRaDevice->upLinkSlot.NwkSKey;
-                frameCntr = pLoRaDevice->upLinkSlot.DownLinkCounter;
+                nwkSKey = pLoRaDevice->upLinkSlot.NwkSKey;
+                appSKey = pLoRaDevice->upLinkSlot.AppSKey;
+                rxCntr = &pLoRaDevice->upLinkSlot.DownLinkCounter;
                 devAddr = pLoRaDevice->devAddr;
             }
 
@@ -180,19 +225,27 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
             rxAddr |= ((uint32_t) payload[LORAFRM_BUF_IDX_DEVADDR + 2] << 16);
             rxAddr |= ((uint32_t) payload[LORAFRM_BUF_IDX_DEVADDR + 3] << 24);
 
-            curChildNode = LoRaMesh_FindChildNode(rxAddr);
-            if ( curChildNode != NULL ) {
-                frameCntr = curChildNode->Connection.UpLinkCounter;
-                devAddr = curChildNode->Connection.Address;
-                if ( rxAddr != devAddr ) return ERR_FAILED;
+            session = LoRaSession_Find(rxAddr);
+            if ( session == NULL || session->Type != SESSION_TYPE_CHILD_NODE ) {
+                LORASTATS_INC(Mac, UnknownSession);
+                return ERR_FAILED;
             }
-            micKey = curChildNode->Connection.NwkSKey;
+
+            nwkSKey = session->Connection->NwkSKey;
+            appSKey = session->Connection->AppSKey;
+            rxCntr = &session->Connection->UpLinkCounter;
+            devAddr = session->Address;
             frameDir = UP_LINK;
             break;
         }
         case MSG_TYPE_PROPRIETARY:
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+            return OnRoutedFrame(packet);
+#else
             //Intentional falltrough
+#endif
         default:
+            LORASTATS_INC(Mac, InvalidFrames);
             return ERR_INVALID_TYPE;
             break;
     }
@@ -202,42 +255,77 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet )
     micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE + 2] << 16);
     micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE + 3] << 24);
 
-    sequenceCntr = (uint16_t) payload[LORAFRM_BUF_IDX_CNTR];
-    sequenceCntr |= (uint16_t) payload[LORAFRM_BUF_IDX_CNTR + 1] << 8;
-    sequenceCntrDiff = (sequenceCntr - ((uint16_t)(frameCntr & 0xFFFF)));
+    frameCntr = GetFrameCounter(&payload[LORAFRM_BUF_IDX_CNTR], *rxCntr);
 
-    if ( sequenceCntrDiff < (1 << 15) )
-        frameCntr += sequenceCntrDiff;
-    else
-        frameCntr += 0x10000 + (int16_t) sequenceCntrDiff;
-
-    LoRaMacComputeMic((uint8_t*) &payload[LORAMAC_BUF_IDX_HDR], payloadSize - LORAMAC_MIC_SIZE,
-            micKey, devAddr, frameDir, frameCntr, &mic);
+#if(LORAMESH_CONFIG_RX_SINGLE_PASS == 1)
+    /* Frames for this node are decrypted along with the MIC check, forwarded ones stay intact */
+    if ( !IsForwarded(packet, frameDir) ) {
+        ComputeMicDecrypt(&payload[LORAMAC_BUF_IDX_HDR], payloadSize - LORAMAC_MIC_SIZE, nwkSKey,
+                appSKey, devAddr, frameDir, frameCntr, isMulticast, &mic);
+        packet->flags |= LORAPHY_PACKET_FLAGS_DECRYPTED;
+    } else
+#endif
+    {
+        ComputeMic(&payload[LORAMAC_BUF_IDX_HDR], payloadSize - LORAMAC_MIC_SIZE, nwkSKey,
+                devAddr, frameDir, frameCntr, &mic);
+    }
 
     if ( mic == micRx ) {
+        /* The counter holds the next expected value, older frames are replays */
+        if ( frameCntr < *rxCntr ) {
+            LORASTATS_INC(Mac, Replays);
+            LOG_ERROR("Frame counter %u of 0x%08x already received.", frameCntr, devAddr);
+            return ERR_FAILED;
+        }
+        *rxCntr = frameCntr + 1;
+        if ( session != NULL ) {
+            LoRaMesh_StoreFrameCounters(session);
+        }
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
         LOG_TRACE("%s - Size %d", __FUNCTION__, payloadSize - LORAMAC_MIC_SIZE);
-        LOG_TRACE_BARE("\t");
-        for ( uint8_t i = 0; i < ((payloadSize - LORAMAC_MIC_SIZE) + 2); i++ )
-        LOG_TRACE_BARE("0x%02x ", payload[i]);
-        LOG_TRACE_BARE("\r\n");
+        LOG_TRACE_HEX(payload, (payloadSize - LORAMAC_MIC_SIZE) + 2);
 #endif
-        return LoRaFrm_OnPacketRx(packet, devAddr, frameDir, frameCntr);
+        LORASTATS_INC(Mac, RxFrames);
+        if ( frameDir == UP_LINK ) {
+            LoRaStats_LinkUpdate(&((ChildNodeInfo_t*) session->Info)->Link, packet->rssi,
+                    packet->snr, frameCntr);
+        } else if ( !isMulticast ) {
+            LoRaStats_LinkUpdate(&LoRaStats.UpLink, packet->rssi, packet->snr, frameCntr);
+        }
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+        if ( !isMulticast && (packet->flags & LORAPHY_PACKET_FLAGS_ROUTED) == 0 ) {
+            LoRaFrm_Ctrl_t fCtrl;
+
+            fCtrl.Value = payload[LORAFRM_BUF_IDX_CTRL];
+            LoRaRoute_OnFrame(devAddr, packet->snr, fCtrl.Bits.Ack);
+        }
+        if ( frameDir == UP_LINK && (packet->flags & LORAPHY_PACKET_FLAGS_ROUTED) == 0
+                && RouteUpLink(packet) == ERR_OK ) {
+            /* Forwarded towards the coordinator, not for this node */
+            return ERR_OK;
+        }
+#endif
+        /* Hand over the resolved session, no further look up required */
+        return LoRaFrm_OnPacketRx(packet, devAddr, frameDir, frameCntr, nwkSKey, appSKey,
+                isMulticast);
     } else {
         LOG_ERROR("Message integrity code not valid.");
+        LORASTATS_INC(Mac, MicFailures);
     }
 
     return ERR_FAILED;
 }
 
 uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
-        LoRaMac_MsgType_t type, uint32_t addr, uint32_t seqCntr, uint8_t *key, bool isMulticast )
+        LoRaMac_MsgType_t type, uint32_t addr, uint32_t seqCntr, uint8_t *key, uint8_t channel,
+        bool isMulticast )
 {
     LoRaMac_Header_t macHdr;
     LoRaFrm_Dir_t dir = DOWN_LINK;
     uint8_t flags = LORAPHY_PACKET_FLAGS_NONE;
     uint32_t mic = 0;
 
+    LORALATENCY_TX(LATENCY_STAGE_TX_MAC);
     macHdr.Value = 0;
 
     macHdr.Bits.MType = type;
@@ -248,7 +336,7 @@ uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
 
     switch ( macHdr.Bits.MType ) {
         case MSG_TYPE_JOIN_REQ:
-            LoRaMacJoinComputeMic(buf, payloadSize & 0xFF, pLoRaDevice->appKey, &mic);
+            JoinComputeMic(buf, payloadSize & 0xFF, pLoRaDevice->appKey, &mic);
 
             *LORAMAC_BUF_MIC_START(buf, payloadSize++) = mic & 0xFF;
             *LORAMAC_BUF_MIC_START(buf, payloadSize++) = (mic >> 8) & 0xFF;
@@ -257,7 +345,7 @@ uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
 
             flags = LORAPHY_PACKET_FLAGS_JOIN_REQ;
 
-            return LoRaPhy_PutPayload(buf, bufSize, payloadSize, flags);
+            return LoRaPhy_PutPayload(buf, bufSize, payloadSize, channel, flags);
         case MSG_TYPE_JOIN_ACCEPT:
             return ERR_NOTAVAIL;
         case MSG_TYPE_DATA_UNCONFIRMED_UP:
@@ -275,9 +363,14 @@ uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
         default:
             return ERR_INVALID_TYPE;
     }
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    if ( type == MSG_TYPE_DATA_CONFIRMED_UP || type == MSG_TYPE_DATA_CONFIRMED_DOWN ) {
+        /* ACK history of the link */
+        LoRaRoute_OnConfirmedTx(addr);
+    }
+#endif
 
-    LoRaMacComputeMic((uint8_t*) &buf[LORAMAC_BUF_IDX_HDR], payloadSize, key, addr, dir, seqCntr,
-            &mic);
+    ComputeMic(&buf[LORAMAC_BUF_IDX_HDR], payloadSize, key, addr, dir, seqCntr, &mic);
 
     if ( (payloadSize + LORAMAC_MIC_SIZE - 1 /* MAC header already added */)
             > LORAMAC_PAYLOAD_SIZE ) {
@@ -291,12 +384,9 @@ uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
 
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("%s - Size %d", __FUNCTION__, payloadSize);
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < (payloadSize + 2); i++ )
-    LOG_TRACE_BARE("0x%02x ", buf[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(buf, payloadSize + 2);
 #endif
-    return LoRaPhy_PutPayload(buf, bufSize, payloadSize, flags);
+    return LoRaPhy_PutPayload(buf, bufSize, payloadSize, channel, flags);
 }
 
 uint8_t LoRaMac_AddCommand( uint8_t cmd, uint8_t *args, size_t argsSize )
@@ -449,6 +539,7 @@ void LoRaMac_ProcessCommands( uint8_t *payload, uint8_t macIndex, uint8_t comman
                     pLoRaDevice->currDataRateIndex = datarate;
                     pLoRaDevice->currTxPowerIndex = txPower;
                     pLoRaDevice->nbRep = nbRep;
+                    LoRaMesh_StoreSession();
                 }
                 LoRaMac_AddCommand(MAC_COMMAND_LINK_ADR, (uint8_t*) &status, sizeof(status));
                 break;
@@ -534,6 +625,7 @@ void LoRaMac_ProcessCommands( uint8_t *payload, uint8_t macIndex, uint8_t comman
                 }
                 if ( (status & 0x03) == 0x03 ) {
                     LoRaPhy_SetChannel(channelIndex, chParam);
+                    LoRaMesh_StoreSession();
                 }
                 LoRaMac_AddCommand(MAC_COMMAND_NEW_CHANNEL, (uint8_t*) &status, sizeof(status));
                 break;
@@ -583,6 +675,332 @@ void LoRaMac_ProcessCommands( uint8_t *payload, uint8_t macIndex, uint8_t comman
 /*******************************************************************************
  * PRIVATE FUNCTIONS (STATIC)
  ******************************************************************************/
+static uint32_t GetFrameCounter( uint8_t *cntrBuf, uint32_t frameCntr )
+{
+    uint16_t sequenceCntr, sequenceCntrDiff;
+
+    sequenceCntr = (uint16_t) cntrBuf[0];
+    sequenceCntr |= (uint16_t) cntrBuf[1] << 8;
+    sequenceCntrDiff = (sequenceCntr - ((uint16_t)(frameCntr & 0xFFFF)));
+
+    if ( sequenceCntrDiff < (1 << 15) )
+        frameCntr += sequenceCntrDiff;
+    else
+        frameCntr += 0x10000 + (int16_t) sequenceCntrDiff;
+
+    return frameCntr;
+}
+
+static void ComputeMic( const uint8_t *buf, uint16_t size, const uint8_t *key, uint32_t addr,
+        uint8_t dir, uint32_t seqCntr, uint32_t *mic )
+{
+    LoRaMacCryptoCtx_t cryptoCtx;
+
+    LoRaMacCryptoMicInit(&cryptoCtx, key, addr, dir, seqCntr, size);
+    LoRaMacCryptoMicUpdate(&cryptoCtx, buf, size);
+    LoRaMacCryptoMicFinal(&cryptoCtx, mic);
+}
+
+static void JoinComputeMic( const uint8_t *buf, uint16_t size, const uint8_t *key, uint32_t *mic )
+{
+    LoRaMacCryptoCtx_t cryptoCtx;
+
+    LoRaMacCryptoJoinMicInit(&cryptoCtx, key);
+    LoRaMacCryptoMicUpdate(&cryptoCtx, buf, size);
+    LoRaMacCryptoMicFinal(&cryptoCtx, mic);
+}
+
+#if(LORAMESH_CONFIG_RX_SINGLE_PASS == 1)
+static bool IsForwarded( LoRaPhy_PacketDesc *packet, LoRaFrm_Dir_t dir )
+{
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    return dir == UP_LINK && (packet->flags & LORAPHY_PACKET_FLAGS_ROUTED) == 0
+            && IsRoutedUpLink(packet);
+#else
+    return false;
+#endif
+}
+
+static void ComputeMicDecrypt( uint8_t *buf, uint16_t size, const uint8_t *nwkSKey,
+        const uint8_t *appSKey, uint32_t addr, uint8_t dir, uint32_t seqCntr, bool isMulticast,
+        uint32_t *mic )
+{
+    LoRaMacCryptoCtx_t micCtx, ctrCtx;
+    LoRaFrm_Ctrl_t fCtrl;
+    uint16_t portIdx;
+
+    fCtrl.Value = buf[LORAFRM_BUF_IDX_CTRL - LORAMAC_BUF_IDX_HDR];
+    portIdx = LORAFRM_BUF_IDX_PORT(fCtrl.Bits.FOptsLen) - LORAMAC_BUF_IDX_HDR;
+
+    LoRaMacCryptoMicInit(&micCtx, nwkSKey, addr, dir, seqCntr, size);
+    if ( (portIdx + LORAFRM_PORT_SIZE) >= size ) { /* No FRMPayload */
+        LoRaMacCryptoMicUpdate(&micCtx, buf, size);
+    } else {
+        LoRaMacCryptoMicUpdate(&micCtx, buf, portIdx + LORAFRM_PORT_SIZE);
+        /* The FRMPayload of port 0 is encrypted with the NwkSKey */
+        LoRaMacCryptoCtrInit(&ctrCtx, (buf[portIdx] == 0 && !isMulticast) ? nwkSKey : appSKey,
+                addr, dir, seqCntr);
+        LoRaMacCryptoMicDecryptUpdate(&micCtx, &ctrCtx, &buf[portIdx + LORAFRM_PORT_SIZE],
+                size - portIdx - LORAFRM_PORT_SIZE);
+        LoRaMacCryptoCtxClear(&ctrCtx);
+    }
+    LoRaMacCryptoMicFinal(&micCtx, mic);
+}
+#endif
+
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+static uint8_t OnRoutedFrame( LoRaPhy_PacketDesc *packet )
+{
+    uint8_t *payload = packet->phyData, payloadSize, *nwkSKey, rCtrl, hops;
+    uint32_t micRx = 0, mic = 0, frameCntr, linkAddr, dest, origin, *rxCntr;
+    LoRaMeshSession_t *session = NULL;
+    LoRaMac_Header_t macHdr;
+    LoRaFrm_Dir_t frameDir;
+
+    payloadSize = LORAPHY_BUF_SIZE(payload);
+    if ( payloadSize < (LORAMAC_ROUTE_OVERHEAD + LORAMAC_HEADER_SIZE + LORAFRM_HEADER_SIZE_MIN
+            + LORAMAC_MIC_SIZE) ) {
+        LORASTATS_INC(Mac, InvalidFrames);
+        return ERR_INVALID_TYPE;
+    }
+
+    linkAddr = (uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_ADDR];
+    linkAddr |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_ADDR + 1] << 8);
+    linkAddr |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_ADDR + 2] << 16);
+    linkAddr |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_ADDR + 3] << 24);
+    rCtrl = payload[LORAMAC_BUF_IDX_ROUTE_CTRL];
+    dest = (uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_DEST];
+    dest |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_DEST + 1] << 8);
+    dest |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_DEST + 2] << 16);
+    dest |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_DEST + 3] << 24);
+
+    /* Authenticate the hop with the session of the link, the frame of the
+     * origin stays untouched */
+    if ( (rCtrl & LORAMAC_ROUTE_CTRL_DOWN) != 0 ) {
+        if ( linkAddr != pLoRaDevice->devAddr ) {
+            /* Routed to another child node of the parent */
+            return ERR_NOTAVAIL;
+        }
+        session = LoRaSession_Find(linkAddr);
+        nwkSKey = pLoRaDevice->upLinkSlot.NwkSKey;
+        rxCntr = &pLoRaDevice->upLinkSlot.DownLinkCounter;
+        frameDir = DOWN_LINK;
+    } else {
+        session = LoRaSession_Find(linkAddr);
+        if ( session == NULL || session->Type != SESSION_TYPE_CHILD_NODE ) {
+            LORASTATS_INC(Mac, UnknownSession);
+            return ERR_FAILED;
+        }
+        nwkSKey = session->Connection->NwkSKey;
+        rxCntr = &session->Connection->UpLinkCounter;
+        frameDir = UP_LINK;
+    }
+    frameCntr = GetFrameCounter(&payload[LORAMAC_BUF_IDX_ROUTE_CNTR], *rxCntr);
+
+    micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE]);
+    micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE + 1] << 8);
+    micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE + 2] << 16);
+    micRx |= ((uint32_t) payload[LORAMAC_BUF_IDX_HDR + payloadSize - LORAMAC_MIC_SIZE + 3] << 24);
+
+    ComputeMic(&payload[LORAMAC_BUF_IDX_HDR], payloadSize - LORAMAC_MIC_SIZE,
+            nwkSKey, linkAddr, frameDir, frameCntr, &mic);
+
+    if ( mic != micRx ) {
+        LOG_ERROR("Message integrity code of routed frame not valid.");
+        LORASTATS_INC(Mac, MicFailures);
+        return ERR_FAILED;
+    }
+    /* The hop shares the counter of the link session, a replayed routed frame
+     * would be forwarded over every further hop */
+    if ( frameCntr < *rxCntr ) {
+        LORASTATS_INC(Mac, Replays);
+        LOG_ERROR("Routed frame counter %u of 0x%08x already received.", frameCntr, linkAddr);
+        return ERR_FAILED;
+    }
+    *rxCntr = frameCntr + 1;
+    if ( session != NULL ) {
+        LoRaMesh_StoreFrameCounters(session);
+    }
+
+    LORASTATS_INC(Mac, RxFrames);
+    if ( frameDir == UP_LINK ) {
+        LoRaStats_LinkUpdate(&((ChildNodeInfo_t*) session->Info)->Link, packet->rssi,
+                packet->snr, frameCntr);
+    } else {
+        LoRaStats_LinkUpdate(&LoRaStats.UpLink, packet->rssi, packet->snr, frameCntr);
+    }
+    LoRaRoute_OnFrame(linkAddr, packet->snr, false);
+
+    hops = (rCtrl & LORAMAC_ROUTE_CTRL_HOPS_MASK) + 1;
+    if ( frameDir == UP_LINK ) {
+        /* Route back to the origin over the child node */
+        origin = (uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_FRAME + 1];
+        origin |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_FRAME + 2] << 8);
+        origin |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_FRAME + 3] << 16);
+        origin |= ((uint32_t) payload[LORAMAC_BUF_IDX_ROUTE_FRAME + 4] << 24);
+        LoRaRoute_Learn(origin, linkAddr, hops);
+    }
+
+    if ( dest == pLoRaDevice->devAddr ) {
+        macHdr.Value = payload[LORAMAC_BUF_IDX_ROUTE_FRAME];
+        if ( macHdr.Bits.MType == MSG_TYPE_PROPRIETARY ) {
+            LORASTATS_INC(Mac, InvalidFrames);
+            return ERR_INVALID_TYPE;
+        }
+        /* Unwrap in place and process the frame as if received from the origin */
+        payloadSize -= LORAMAC_ROUTE_OVERHEAD;
+        memmove(&payload[LORAMAC_BUF_IDX_HDR], &payload[LORAMAC_BUF_IDX_ROUTE_FRAME],
+                payloadSize);
+        LORAPHY_BUF_SIZE(payload) = payloadSize;
+        packet->flags |= LORAPHY_PACKET_FLAGS_ROUTED;
+        LORASTATS_INC(Mac, RouteDelivered);
+        return LoRaMac_OnPacketRx(packet);
+    }
+
+    if ( hops >= LORAMESH_CONFIG_ROUTE_MAX_HOPS ) {
+        LORASTATS_INC(Mac, RouteDropped);
+        LOG_ERROR("Routed frame to 0x%08x dropped after %u hops.", dest, hops);
+        return ERR_RANGE;
+    }
+
+    return SendRouted(payload, payloadSize, (rCtrl & LORAMAC_ROUTE_CTRL_DOWN) | hops, dest);
+}
+
+static bool IsRoutedUpLink( LoRaPhy_PacketDesc *packet )
+{
+    uint8_t *payload = packet->phyData, portIdx;
+    LoRaFrm_Ctrl_t fCtrl;
+
+    if ( pLoRaDevice->ctrlFlags.Bits.nwkJoined == 0 || pLoRaDevice->coordinatorAddr == 0
+            || pLoRaDevice->coordinatorAddr == pLoRaDevice->devAddr ) {
+        return false;
+    }
+
+    /* Frames with application payload only, MAC commands are for the parent */
+    fCtrl.Value = payload[LORAFRM_BUF_IDX_CTRL];
+    portIdx = LORAFRM_BUF_IDX_PORT(fCtrl.Bits.FOptsLen);
+    return (portIdx + LORAMAC_MIC_SIZE) < (LORAMAC_BUF_IDX_HDR + LORAPHY_BUF_SIZE(payload))
+            && payload[portIdx] != 0;
+}
+
+static uint8_t RouteUpLink( LoRaPhy_PacketDesc *packet )
+{
+    uint8_t *payload = packet->phyData, payloadSize;
+
+    if ( !IsRoutedUpLink(packet) ) {
+        return ERR_NOTAVAIL;
+    }
+    payloadSize = LORAPHY_BUF_SIZE(payload);
+
+    if ( (payloadSize + LORAMAC_ROUTE_OVERHEAD) > LORAPHY_PAYLOAD_SIZE
+            || !LoRaPhy_IsPoolBuffer(payload) ) {
+        LORASTATS_INC(Mac, RouteDropped);
+        return ERR_OVERFLOW;
+    }
+
+    /* Make room for the route header in the receive buffer */
+    memmove(&payload[LORAMAC_BUF_IDX_ROUTE_FRAME], &payload[LORAMAC_BUF_IDX_HDR], payloadSize);
+
+    (void) SendRouted(payload, payloadSize + LORAMAC_ROUTE_OVERHEAD, 1,
+            pLoRaDevice->coordinatorAddr);
+    /* The frame is gone, dropped or not */
+    return ERR_OK;
+}
+
+static uint8_t SendRouted( uint8_t *buf, uint8_t payloadSize, uint8_t rCtrl, uint32_t dest )
+{
+    const LoRaRoute_Entry_t *route;
+    LoRaMeshSession_t *session;
+    ConnectionInfo_t *connection;
+    LoRaMac_Header_t macHdr;
+    LoRaFrm_Dir_t dir;
+    uint32_t linkAddr, seqCntr, mic = 0;
+    uint8_t status;
+
+    if ( (rCtrl & LORAMAC_ROUTE_CTRL_DOWN) != 0 ) {
+        /* Towards the child node the destination is reached over */
+        linkAddr = dest;
+        session = LoRaSession_Find(linkAddr);
+        if ( (session == NULL || session->Type != SESSION_TYPE_CHILD_NODE)
+                && (route = LoRaRoute_Lookup(dest)) != NULL ) {
+            linkAddr = route->NextHop;
+            session = LoRaSession_Find(linkAddr);
+        }
+        if ( session == NULL || session->Type != SESSION_TYPE_CHILD_NODE ) {
+            LORASTATS_INC(Mac, RouteDropped);
+            LOG_ERROR("No route to 0x%08x.", dest);
+            return ERR_NOTAVAIL;
+        }
+        connection = session->Connection;
+        seqCntr = connection->DownLinkCounter;
+        dir = DOWN_LINK;
+    } else {
+        /* Towards the coordinator over the parent */
+        connection = &pLoRaDevice->upLinkSlot;
+        linkAddr = pLoRaDevice->devAddr;
+        session = LoRaSession_Find(linkAddr);
+        seqCntr = connection->UpLinkCounter;
+        dir = UP_LINK;
+    }
+
+    if ( payloadSize > (MaxPayloadByDatarate[pLoRaDevice->currDataRateIndex] + LORAMAC_HEADER_SIZE
+            + LORAFRM_HEADER_SIZE_MIN + LORAFRM_PORT_SIZE + LORAMAC_MIC_SIZE) ) {
+        LORASTATS_INC(Mac, RouteDropped);
+        LOG_ERROR("Routed frame of %u bytes too large for data rate %u.", payloadSize,
+                pLoRaDevice->currDataRateIndex);
+        return ERR_OVERFLOW;
+    }
+
+    macHdr.Value = 0;
+    macHdr.Bits.MType = MSG_TYPE_PROPRIETARY;
+    macHdr.Bits.Major = LORAMESH_CONFIG_MAJOR_VERSION;
+
+    buf[LORAMAC_BUF_IDX_HDR] = macHdr.Value;
+    buf[LORAMAC_BUF_IDX_ROUTE_ADDR] = (linkAddr) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_ADDR + 1] = (linkAddr >> 8) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_ADDR + 2] = (linkAddr >> 16) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_ADDR + 3] = (linkAddr >> 24) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_CNTR] = seqCntr & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_CNTR + 1] = (seqCntr >> 8) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_CTRL] = rCtrl;
+    buf[LORAMAC_BUF_IDX_ROUTE_DEST] = (dest) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_DEST + 1] = (dest >> 8) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_DEST + 2] = (dest >> 16) & 0xFF;
+    buf[LORAMAC_BUF_IDX_ROUTE_DEST + 3] = (dest >> 24) & 0xFF;
+
+    ComputeMic(&buf[LORAMAC_BUF_IDX_HDR], payloadSize - LORAMAC_MIC_SIZE,
+            connection->NwkSKey, linkAddr, dir, seqCntr, &mic);
+
+    *LORAMAC_BUF_MIC_START(buf, payloadSize - LORAMAC_MIC_SIZE) = mic & 0xFF;
+    *LORAMAC_BUF_MIC_START(buf, payloadSize - LORAMAC_MIC_SIZE + 1) = (mic >> 8) & 0xFF;
+    *LORAMAC_BUF_MIC_START(buf, payloadSize - LORAMAC_MIC_SIZE + 2) = (mic >> 16) & 0xFF;
+    *LORAMAC_BUF_MIC_START(buf, payloadSize - LORAMAC_MIC_SIZE + 3) = (mic >> 24) & 0xFF;
+
+    /* Receive buffer is retained by the queue, no copy */
+    status = LoRaPhy_PutPayload(buf, LORAPHY_BUFFER_SIZE, payloadSize, connection->ChannelIndex,
+            LORAPHY_PACKET_FLAGS_FRM_REGULAR);
+    if ( status != ERR_OK ) {
+        LORASTATS_INC(Mac, RouteDropped);
+        return status;
+    }
+
+    /* The counter holds the value of the next frame of the link, every hop
+     * sends with a new one */
+    if ( dir == DOWN_LINK ) {
+        connection->DownLinkCounter++;
+    } else if ( pLoRaDevice->dbgFlags.Bits.upLinkCounterFixed == 0 ) {
+        connection->UpLinkCounter++;
+    }
+    if ( session != NULL ) {
+        LoRaMesh_StoreFrameCounters(session);
+    }
+
+    LORASTATS_INC(Mac, RouteForwarded);
+    LOG_TRACE("Forward routed frame to 0x%08x over 0x%08x.", dest, linkAddr);
+
+    return ERR_OK;
+}
+#endif /* LORAMESH_CONFIG_ROUTING_ENABLED */
 
 /*******************************************************************************
  * END OF CODE
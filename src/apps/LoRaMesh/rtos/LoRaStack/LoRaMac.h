@@ -30,6 +30,18 @@
 
 #define LORAMAC_JOIN_MESH_MSG_LENGTH        (0x1B)
 #define LORAMAC_REBIND_MESH_MSG_LENGTH      (0x1F)
+
+/* Routed frame, MType proprietary: <Hdr><LinkAddr:4><LinkCntr:2><RCtrl:1><Dest:4>
+ * <frame of the origin><MIC:4>, the MIC of the link session of each hop */
+#define LORAMAC_ROUTE_HDR_SIZE              (12)
+#define LORAMAC_ROUTE_OVERHEAD              (LORAMAC_ROUTE_HDR_SIZE+LORAMAC_MIC_SIZE)
+#define LORAMAC_BUF_IDX_ROUTE_ADDR          (LORAMAC_BUF_IDX_PAYLOAD+0) /* <LinkAddr> index */
+#define LORAMAC_BUF_IDX_ROUTE_CNTR          (LORAMAC_BUF_IDX_PAYLOAD+4) /* <LinkCntr> index */
+#define LORAMAC_BUF_IDX_ROUTE_CTRL          (LORAMAC_BUF_IDX_PAYLOAD+6) /* <RCtrl> index */
+#define LORAMAC_BUF_IDX_ROUTE_DEST          (LORAMAC_BUF_IDX_PAYLOAD+7) /* <Dest> index */
+#define LORAMAC_BUF_IDX_ROUTE_FRAME         (LORAMAC_BUF_IDX_HDR+LORAMAC_ROUTE_HDR_SIZE) /* <frame> index */
+#define LORAMAC_ROUTE_CTRL_DOWN             (0x80) /* Towards a child node */
+#define LORAMAC_ROUTE_CTRL_HOPS_MASK        (0x7F) /* Hops travelled */
 /*******************************************************************************
  * MACRO DEFINITIONS
  ******************************************************************************/
@@ -121,11 +133,12 @@ uint8_t LoRaMac_OnPacketRx( LoRaPhy_PacketDesc *packet );
  * \param fBufferSize Size of message buffer, must be of LORAMAC_BUFFER_SIZE.
  * \param payloadSize Size of the payload in bytes.
  * \param type LoRa messsage type.
+ * \param channel Index of the channel the message is sent on.
  *
  * \return Error code, ERR_OK if everything is ok, ERR_OVERFLOW if buffer is too small.
  */
 uint8_t LoRaMac_PutPayload( uint8_t* buf, size_t bufSize, size_t payloadSize,
-        LoRaMac_MsgType_t type, uint32_t addr, uint32_t seqCntr, uint8_t *key,
+        LoRaMac_MsgType_t type, uint32_t addr, uint32_t seqCntr, uint8_t *key, uint8_t channel,
         bool isMulticast );
 
 /*!
@@ -11,6 +11,7 @@
 #define __LORAMESH_CONFIG_H_
 
 #include "board.h"
+#include "LoRaMac-board.h"
 #include "LoRaMesh_AppConfig.h"
 
 /* Default configuration items, can be overwritten by the application configuration header file: */
@@ -107,14 +108,46 @@
 #define LORAMESH_CONFIG_MAX_NOF_CHILD_NODES                 (8)
 #endif
 
+/* Number of sessions: child nodes, multicast groups and the own up link */
+#define LORAMESH_CONFIG_NOF_SESSIONS                        (LORAMESH_CONFIG_MAX_NOF_CHILD_NODES + LORAMESH_CONFIG_MAX_NOF_MULTICAST_GROUPS + 1)
+
+/* Number of entries of the session hash table (power of two, 16 bytes each).
+ * Has to be larger than the number of sessions, by default the smallest power
+ * of two keeping the load factor at 1/2 or below: 1.5 probes per lookup and
+ * 2.5 per miss. Lookups get slow above a load factor of 3/4 (bench-session). */
+#ifndef LORAMESH_CONFIG_SESSION_TABLE_SIZE
+#if (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 32
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (32)
+#elif (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 64
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (64)
+#elif (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 128
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (128)
+#elif (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 256
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (256)
+#elif (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 512
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (512)
+#elif (2 * LORAMESH_CONFIG_NOF_SESSIONS) <= 1024
+#define LORAMESH_CONFIG_SESSION_TABLE_SIZE                  (1024)
+#else
+#error "Too many child nodes and multicast groups for the session table"
+#endif
+#endif
+
 /*! Maximal number of fPort handlers */
 #ifndef LORAMESH_CONFIG_MAX_NOF_PORT_HANDLERS
 #define LORAMESH_CONFIG_MAX_NOF_PORT_HANDLERS               (16)
 #endif
 
+/* Scheduler events of the own transmissions and reception windows */
+#ifndef LORAMESH_CONFIG_NOF_OWN_SCHEDULER_EVENTS
+#define LORAMESH_CONFIG_NOF_OWN_SCHEDULER_EVENTS            (40)
+/*!< Occurrences per advertising interval, an uplink takes three (uplink, rx1 and rx2 window) */
+#endif
+
 /* Maximal number of LoRaMesh scheduler events */
 #ifndef LORAMESH_CONFIG_MAX_NOF_SCHEDULER_EVENTS
-#define LORAMESH_CONFIG_MAX_NOF_SCHEDULER_EVENTS            (64)
+#define LORAMESH_CONFIG_MAX_NOF_SCHEDULER_EVENTS            (LORAMESH_CONFIG_NOF_OWN_SCHEDULER_EVENTS + (3 * LORAMESH_CONFIG_MAX_NOF_CHILD_NODES))
+/*!< The own events and an uplink with its rx1 and rx2 windows per child node and advertising interval */
 #endif
 
 #ifndef LORAMESH_CONFIG_MAX_NOF_SCHEDULER_EVENT_HANDLERS
@@ -126,6 +159,104 @@
 /*!< Size of the physical transceiver payload (bytes) */
 #endif
 
+/* Receive path */
+#ifndef LORAMESH_CONFIG_RX_SINGLE_PASS
+#define LORAMESH_CONFIG_RX_SINGLE_PASS                      (1)
+/*!< 1: the MIC of a frame for this node is checked while its FRMPayload is decrypted in place, one pass over the frame, takes a second crypto context (about 310 bytes) on the stack; 0: MIC pass, then decryption pass. */
+#endif
+
+/* Listen before talk */
+#ifndef LORAMESH_CONFIG_LBT_ENABLED
+#define LORAMESH_CONFIG_LBT_ENABLED                         (0)
+/*!< 1: Channel activity detection (LoRa) or RSSI check (FSK) before each transmission. */
+#endif
+#ifndef LORAMESH_CONFIG_LBT_RSSI_THRESHOLD
+#define LORAMESH_CONFIG_LBT_RSSI_THRESHOLD                  (-90)
+/*!< FSK channel busy above this RSSI in dBm. */
+#endif
+#ifndef LORAMESH_CONFIG_LBT_BACKOFF_SLOT_MS
+#define LORAMESH_CONFIG_LBT_BACKOFF_SLOT_MS                 (50)
+/*!< Backoff slot duration in ms. */
+#endif
+#ifndef LORAMESH_CONFIG_LBT_MIN_BACKOFF_EXP
+#define LORAMESH_CONFIG_LBT_MIN_BACKOFF_EXP                 (1)
+/*!< Backoff exponent of the first retry, the backoff is random in [0, 2^exp - 1] slots. */
+#endif
+#ifndef LORAMESH_CONFIG_LBT_MAX_BACKOFF_EXP
+#define LORAMESH_CONFIG_LBT_MAX_BACKOFF_EXP                 (5)
+/*!< Largest backoff exponent. */
+#endif
+#ifndef LORAMESH_CONFIG_LBT_MAX_ATTEMPTS
+#define LORAMESH_CONFIG_LBT_MAX_ATTEMPTS                    (5)
+/*!< Channel assessments before the frame is sent regardless of the channel state. */
+#endif
+
+/* Session persistence */
+#ifndef LORAMESH_CONFIG_NVM_KEY_BASE
+#define LORAMESH_CONFIG_NVM_KEY_BASE                        (0)
+/*!< First NVM key used by the stack. */
+#endif
+#define LORAMESH_CONFIG_NVM_NB_SESSION_KEYS                 (3 + ((LORA_MAX_NB_CHANNELS + 7) / 8))
+/*!< NVM keys of the session: device, frame counters and a record per 8 channels. */
+#define LORAMESH_CONFIG_NVM_NB_KEYS                         (LORAMESH_CONFIG_NVM_NB_SESSION_KEYS + LORAMESH_CONFIG_MAX_NOF_CHILD_NODES)
+/*!< NVM keys used by the stack, session and a key per child node. */
+
+/* Statistics */
+#ifndef LORAMESH_CONFIG_STATS_ENABLED
+#define LORAMESH_CONFIG_STATS_ENABLED                       (1)
+/*!< 1: count layer events, airtime and link quality (LoRaStats); 0: no statistics. */
+#endif
+#ifndef LORAMESH_CONFIG_STATS_LINK_AVG_WEIGHT
+#define LORAMESH_CONFIG_STATS_LINK_AVG_WEIGHT               (8)
+/*!< A new frame is weighted 1/weight in the average RSSI and SNR of a link. */
+#endif
+
+/* Latency tracing */
+#ifndef LORAMESH_CONFIG_LATENCY_ENABLED
+#define LORAMESH_CONFIG_LATENCY_ENABLED                     (0)
+/*!< 1: trace the stage times of every frame with the core cycle counter (LoRaLatency); 0: no tracing. */
+#endif
+
+/* Uplink aggregation */
+#ifndef LORAMESH_CONFIG_AGGR_ENABLED
+#define LORAMESH_CONFIG_AGGR_ENABLED                        (1)
+/*!< 1: LoRaMesh_QueueFrame packs the records of a node into one frame per uplink slot (LoRaAggr); 0: one frame per record. */
+#endif
+#ifndef LORAMESH_CONFIG_AGGR_PORT
+#define LORAMESH_CONFIG_AGGR_PORT                           (223)
+/*!< Port of the aggregation containers, not available to the application. */
+#endif
+#ifndef LORAMESH_CONFIG_AGGR_QUEUE_SIZE
+#define LORAMESH_CONFIG_AGGR_QUEUE_SIZE                     (256)
+/*!< Size of the record queue in bytes, a record takes its size plus 2 bytes (7 if forwarded). */
+#endif
+
+/* Multi-hop routing */
+#ifndef LORAMESH_CONFIG_ROUTING_ENABLED
+#define LORAMESH_CONFIG_ROUTING_ENABLED                     (0)
+/*!< 1: routers forward the frames of their child nodes unchanged towards the coordinator (LoRaRoute), the coordinator needs the sessions of all nodes; 0: frames reach the parent only. */
+#endif
+#ifndef LORAMESH_CONFIG_ROUTE_TABLE_SIZE
+#define LORAMESH_CONFIG_ROUTE_TABLE_SIZE                    (16)
+/*!< Number of routes, one per destination. */
+#endif
+#ifndef LORAMESH_CONFIG_ROUTE_NOF_NEIGHBORS
+#define LORAMESH_CONFIG_ROUTE_NOF_NEIGHBORS                 (8)
+/*!< Number of neighbors the link ETX is estimated for, the least recently heard one is replaced. */
+#endif
+#ifndef LORAMESH_CONFIG_ROUTE_MAX_HOPS
+#define LORAMESH_CONFIG_ROUTE_MAX_HOPS                      (8)
+/*!< A routed frame is dropped after this number of hops (at most 127). */
+#endif
+#ifndef LORAMESH_CONFIG_ROUTE_TIMEOUT
+#define LORAMESH_CONFIG_ROUTE_TIMEOUT                       (600000)
+/*!< A route expires if not refreshed within this time in ms, a few advertising intervals. */
+#endif
+#ifndef LORAMESH_CONFIG_ROUTE_HYSTERESIS
+#define LORAMESH_CONFIG_ROUTE_HYSTERESIS                    (8)
+/*!< A route is replaced by a route over another next hop if its metric is lower by this value (1/16 ETX). */
+#endif
+
 /* Configuration for Rx and Tx queues */
 #ifndef LORAMESH_CONFIG_MSG_QUEUE_RX_LENGTH
 #define LORAMESH_CONFIG_MSG_QUEUE_RX_LENGTH                 (2)
@@ -135,6 +266,10 @@
 #define LORAMESH_CONFIG_MSG_QUEUE_TX_LENGTH                 (2)
 /*!< Number items in the Tx message queue. The higher, the more items can be buffered. */
 #endif
+#ifndef LORAMESH_CONFIG_PHY_BUFFER_POOL_SIZE
+#define LORAMESH_CONFIG_PHY_BUFFER_POOL_SIZE                (LORAMESH_CONFIG_MSG_QUEUE_RX_LENGTH+LORAMESH_CONFIG_MSG_QUEUE_TX_LENGTH+2)
+/*!< Number of LoRaPhy packet buffers. Queued messages, the packet being processed and the one being received each hold a buffer. */
+#endif
 #ifndef LORAMESH_CONFIG_MSG_QUEUE_PUT_BLOCK_TIME_MS
 #define LORAMESH_CONFIG_MSG_QUEUE_PUT_BLOCK_TIME_MS         (200/portTICK_RATE_MS)
 /*!< Blocking time for putting items into the message queue before timeout. Use portMAX_DELAY for blocking. */
@@ -13,7 +13,10 @@
 #include "board.h"
 
 #include "LoRaMacCrypto.h"
+#include "LoRaMacScheduler.h"
 #include "LoRaMesh.h"
+#include "LoRaSlots.h"
+#include "nvm.h"
 
 #define LOG_LEVEL_ERROR
 #include "debug.h"
@@ -26,19 +29,60 @@
 #define MAX_NOF_CHILD_NODES                 LORAMESH_CONFIG_MAX_NOF_CHILD_NODES
 #define MAX_NOF_PORT_HANDLERS               LORAMESH_CONFIG_MAX_NOF_PORT_HANDLERS
 
-#define ADVERTISING_INTERVAL_US             (30000000)
+#define ADVERTISING_INTERVAL_US             LORASLOTS_ADVERTISING_INTERVAL_US
 #define ADVERTISING_INTERVAL_MS             (ADVERTISING_INTERVAL_US / 1000)
 #define ADVERTISING_INTERVAL_SEC            (ADVERTISING_INTERVAL_MS / 1000)
-#define ADVERTISING_GUARD_TIME              (2280000)
-#define ADVERTISING_RESERVED_TIME           (2120000)
-#define AVAILABLE_SLOT_TIME                 (ADVERTISING_INTERVAL_US-ADVERTISING_GUARD_TIME-ADVERTISING_RESERVED_TIME)
-#define TIME_PER_SLOT                       (50000)
-#define NOF_AVAILABLE_SLOTS                 (AVAILABLE_SLOT_TIME / TIME_PER_SLOT)
-
-#define RECEPTION_RESERVED_TIME             (50000)
+#define ADVERTISING_RESERVED_TIME           LORASLOTS_ADVERTISING_RESERVED_TIME
+#define TIME_PER_SLOT                       LORASLOTS_TIME_PER_SLOT
+/*! Minimum scheduler timeout [us], the resolution of the regular timers */
+#define SCHEDULER_MIN_TIMEOUT               1000
+#define NOF_AVAILABLE_SLOTS                 LORASLOTS_NOF_SLOTS
+
+#define RECEPTION_RESERVED_TIME             LORASLOTS_RECEPTION_RESERVED_TIME
+
+/*! NVM keys of the session records */
+#define NVM_CHANNELS_PER_RECORD             (8)
+#define NVM_NB_CHANNEL_RECORDS              ((LORA_MAX_NB_CHANNELS + NVM_CHANNELS_PER_RECORD - 1) / NVM_CHANNELS_PER_RECORD)
+#define NVM_KEY_DEVICE                      (LORAMESH_CONFIG_NVM_KEY_BASE)
+#define NVM_KEY_UP_LINK_COUNTER             (LORAMESH_CONFIG_NVM_KEY_BASE + 1)
+#define NVM_KEY_DOWN_LINK_COUNTER           (LORAMESH_CONFIG_NVM_KEY_BASE + 2)
+#define NVM_KEY_CHANNELS                    (LORAMESH_CONFIG_NVM_KEY_BASE + 3)
+#define NVM_KEY_CHILD_NODES                 (NVM_KEY_CHANNELS + NVM_NB_CHANNEL_RECORDS)
+
+#if ((NVM_KEY_CHILD_NODES + MAX_NOF_CHILD_NODES) > NVM_MAX_KEYS)
+#error "NVM_MAX_KEYS too small for the session records"
+#endif
+#if (NVM_PENDING_SLOTS < (3 + NVM_NB_CHANNEL_RECORDS))
+#error "NVM_PENDING_SLOTS too small to queue the session records at once"
+#endif
 /*******************************************************************************
  * PRIVATE TYPE DEFINITIONS
  ******************************************************************************/
+/*! NVM record of the device session, at most NVM_MAX_VALUE_SIZE bytes */
+typedef struct NvmDeviceRecord_s {
+    uint32_t NetId;
+    uint32_t DevAddr;
+    uint32_t CoordinatorAddr;
+    uint16_t DevNonce;
+    uint8_t Joined;
+    uint8_t DevRole;
+    uint16_t ChannelsMask[6];
+    uint8_t NwkSKey[16];
+    uint8_t AppSKey[16];
+} NvmDeviceRecord_t;
+
+/*! NVM record of NVM_CHANNELS_PER_RECORD channels, frequency 0 if not defined */
+typedef struct NvmChannelsRecord_s {
+    uint32_t Frequency[NVM_CHANNELS_PER_RECORD];
+    int8_t DrRange[NVM_CHANNELS_PER_RECORD];
+    uint8_t Band[NVM_CHANNELS_PER_RECORD];
+} NvmChannelsRecord_t;
+
+/*! NVM record of a child node */
+typedef struct NvmChildNodeRecord_s {
+    ConnectionInfo_t Connection;
+    uint32_t Periodicity;
+} NvmChildNodeRecord_t;
 
 /*******************************************************************************
  * PRIVATE VARIABLES (STATIC)
@@ -103,8 +147,8 @@ static LoRaSchedulerEventHandler_t *pFreeEventHandler;
 /*! Event scheduler timer*/
 static TimerEvent_t EventSchedulerTimer;
 
-/*! Advertising */
-static uint32_t LastAdvertisingWindow;
+/*! Start of the last advertising window, precise time [us] */
+static TimerTime_t LastAdvertisingWindow;
 
 /*! Multicast groups */
 static MulticastGroupInfo_t multicastGrpList[MAX_NOF_MULTICAST_GROUPS];
@@ -114,6 +158,12 @@ static MulticastGroupInfo_t *pFreeMulticastGrp;
 static ChildNodeInfo_t childNodeList[MAX_NOF_CHILD_NODES];
 static ChildNodeInfo_t *pFreeChildNode;
 
+/*! True if the session of the last run has been restored from the NVM */
+static bool SessionRestored;
+
+/*! True if the session could not be queued for the NVM, retried on the next frame */
+static bool SessionStorePending;
+
 /*! Rx message handlers */
 static PortHandler_t portHandlers[MAX_NOF_PORT_HANDLERS];
 static PortHandler_t *pPortHandlers;
@@ -136,6 +186,9 @@ static void OnEventSchedulerTimerEvent( TimerHandle_t xTimer );
 /*! \brief Function executed on advertising event */
 static void AdvertisingEvent( void );
 
+/*! \brief Timeout from the elapsed time to the start of a slot */
+static uint32_t SlotTimeout( uint16_t slot, uint32_t elapsed );
+
 /*! \brief Schedule new event */
 static uint8_t ScheduleEvent( LoRaSchedulerEventHandler_t *evtHandler,
         LoRaSchedulerEventType_t eventType, uint16_t firstSlot, TimerTime_t interval,
@@ -144,9 +197,8 @@ static uint8_t ScheduleEvent( LoRaSchedulerEventHandler_t *evtHandler,
 /*! \brief Remove scheduler event */
 static uint8_t RemoveEvent( LoRaSchedulerEventHandler_t *evtHandler );
 
-/*! \brief Find free slots for given event */
-static uint8_t FindFreeSlots( uint16_t firstSlot, TimerTime_t interval, uint16_t durationInSlots,
-        uint8_t *nofAllocatedSlots, uint16_t *allocatedSlots, bool scheduleRxWindows );
+/*! \brief Insert scheduler event sorted by start slot */
+static void InsertEvent( LoRaSchedulerEvent_t *evt );
 
 /*! \brief Allocate new scheduler event */
 static LoRaSchedulerEvent_t *AllocateEvent( void );
@@ -165,7 +217,7 @@ ChildNodeInfo_t* CreateChildNode( uint32_t devAddr, uint8_t* nwkSKey, uint8_t* a
         uint32_t frequency, uint32_t interval );
 
 /*! \brief Add child node at the tail of the list. */
-void ChildNodeAdd( ChildNodeInfo_t* childNode );
+uint8_t ChildNodeAdd( ChildNodeInfo_t* childNode );
 
 /*! \brief Remove child node from the list. */
 void ChildNodeRemove( ChildNodeInfo_t* childNode );
@@ -175,11 +227,20 @@ MulticastGroupInfo_t* CreateMulticastGroup( uint32_t grpAddr, uint8_t* nwkSKey,
         uint32_t frequency, uint32_t interval, bool isOwner );
 
 /*! \brief Add mutlicast group. */
-void MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp );
+uint8_t MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp );
 
 /*! \brief Remove multicast group. */
 void MulticastGroupRemove( MulticastGroupInfo_t *multicastGrp );
 
+/*! \brief Restore the session stored in the NVM */
+static void RestoreSession( void );
+
+/*! \brief Restore the child nodes stored in the NVM */
+static void RestoreChildNodes( void );
+
+/*! \brief Store a child node in the NVM */
+static bool StoreChildNode( ChildNodeInfo_t* childNode );
+
 /*! \brief Print status */
 static uint8_t PrintStatus( Shell_ConstStdIO_t *io );
 
@@ -195,6 +256,26 @@ static uint8_t PrintChildNodes( Shell_ConstStdIO_t *io );
 /*! \brief Print multicast group information. */
 static uint8_t PrintMulticastGroups( Shell_ConstStdIO_t *io );
 
+/*! \brief Print statistics */
+static uint8_t PrintStats( Shell_ConstStdIO_t *io );
+
+/*! \brief Print the link statistics of a peer */
+static void PrintLinkStats( const unsigned char *title, LoRaStats_Link_t *link,
+        Shell_ConstStdIO_t *io );
+
+/*! \brief Print the binary statistics snapshot */
+static uint8_t PrintStatsSnapshot( Shell_ConstStdIO_t *io );
+
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+/*! \brief Print the routing and the neighbor table */
+static uint8_t PrintRoutes( Shell_ConstStdIO_t *io );
+#endif
+
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+/*! \brief Print the latency histograms */
+static uint8_t PrintLatency( Shell_ConstStdIO_t *io );
+#endif
+
 /*******************************************************************************
  * MODULE VARIABLES (PUBLIC)
  ******************************************************************************/
@@ -234,6 +315,30 @@ byte LoRaMesh_ParseCommand( const unsigned char *cmd, bool *handled, Shell_Const
     } else if ( (strcmp((char*) cmd, "lora multicastgroups") == 0) ) {
         *handled = true;
         return PrintMulticastGroups(io);
+    } else if ( (strcmp((char*) cmd, "lora stats") == 0) ) {
+        *handled = true;
+        return PrintStats(io);
+    } else if ( (strcmp((char*) cmd, "lora stats reset") == 0) ) {
+        *handled = true;
+        LoRaStats_Reset();
+        return ERR_OK;
+    } else if ( (strcmp((char*) cmd, "lora stats dump") == 0) ) {
+        *handled = true;
+        return PrintStatsSnapshot(io);
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    } else if ( (strcmp((char*) cmd, "lora routes") == 0) ) {
+        *handled = true;
+        return PrintRoutes(io);
+#endif
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+    } else if ( (strcmp((char*) cmd, "lora latency") == 0) ) {
+        *handled = true;
+        return PrintLatency(io);
+    } else if ( (strcmp((char*) cmd, "lora latency reset") == 0) ) {
+        *handled = true;
+        LoRaLatency_Reset();
+        return ERR_OK;
+#endif
     }
     return ERR_OK;
 }
@@ -241,12 +346,13 @@ byte LoRaMesh_ParseCommand( const unsigned char *cmd, bool *handled, Shell_Const
 void LoRaMesh_Init( LoRaMeshCallbacks_t *callbacks )
 {
 //    LoRaSchedulerEventHandler_t *handler;
-    uint8_t i;
+    uint16_t i;
 
     LoRaMeshCallbacks = callbacks;
 
     /* Assign LoRa device structure pointer */
     pLoRaDevice = (LoRaDevice_t*) &LoRaDevice;
+    LoRaStats_Reset();
 
     /* Create a list with rx message handler */
     pPortHandlers = NULL;
@@ -262,15 +368,22 @@ void LoRaMesh_Init( LoRaMeshCallbacks_t *callbacks )
     for ( i = 0; i < MAX_NOF_SCHEDULER_EVENTS - 1; i++ ) {
         eventSchedulerList[i].next = &eventSchedulerList[i + 1];
     }
+    LoRaSlots_Init();
     /* Init event handlers list */
     pEventHandlers = NULL;
     pFreeEventHandler = eventHandlerList;
     for ( i = 0; i < MAX_NOF_SCHEDULER_EVENT_HANDLERS - 1; i++ ) {
         eventHandlerList[i].next = &eventHandlerList[i + 1];
     }
+#if(LORAMESH_CONFIG_AGGR_ENABLED == 1)
+    LoRaAggr_Init();
+#endif
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    LoRaRoute_Init();
+#endif
 
     /* Event scheduler timer */
-    TimerInit(&EventSchedulerTimer, "EventSchedulerTimer", (void*) NULL, OnEventSchedulerTimerEvent,
+    TimerInitPrecise(&EventSchedulerTimer, "EventSchedulerTimer", (void*) NULL, OnEventSchedulerTimerEvent,
             false);
 
     /* Init child node list */
@@ -285,10 +398,22 @@ void LoRaMesh_Init( LoRaMeshCallbacks_t *callbacks )
         multicastGrpList[i].next = &multicastGrpList[i + 1];
     }
 
+    /* Init session table with the own up link */
+    LoRaSession_Init();
+    LoRaMesh_SetDevAddr(pLoRaDevice->devAddr);
+
     /* Initialize stack */
     LoRaFrm_Init();
     LoRaMac_Init(LoRaMeshCallbacks->GetBatteryLevel);
     LoRaPhy_Init();
+
+    /* Continue the session of the last run, no join required */
+    SessionRestored = false;
+    if ( NvmInit() ) {
+        RestoreSession();
+    } else {
+        LOG_ERROR("NVM not available, session is not persisted.");
+    }
 }
 
 uint8_t LoRaMesh_RegisterApplication( PortHandlerFunction_t fHandler, uint8_t fPort )
@@ -372,8 +497,15 @@ uint8_t LoRaMesh_RegisterTransmission( uint16_t firstSlot, uint32_t interval,
     }
 
     if ( evtType == EVENT_TYPE_UPLINK ) {
-        pLoRaDevice->upLinkSlot.UpLinkCounter = 0;
-        pLoRaDevice->upLinkSlot.DownLinkCounter = 0;
+        /* A restored session keeps its frame counters, reusing them would be rejected */
+        if ( !SessionRestored ) {
+            pLoRaDevice->upLinkSlot.UpLinkCounter = 0;
+            pLoRaDevice->upLinkSlot.DownLinkCounter = 0;
+            if ( !NvmCounterSet(NVM_KEY_UP_LINK_COUNTER, 0)
+                    || !NvmCounterSet(NVM_KEY_DOWN_LINK_COUNTER, 0) ) {
+                LOG_ERROR("Unable to store the frame counters.");
+            }
+        }
         pLoRaDevice->upLinkSlot.DataRateIndex = LORAMAC_DEFAULT_DATARATE;
         pLoRaDevice->upLinkSlot.TxPowerIndex = LORAMAC_DEFAULT_TX_POWER;
 #if defined(NODE_B)
@@ -392,15 +524,17 @@ uint8_t LoRaMesh_RegisterTransmission( uint16_t firstSlot, uint32_t interval,
 
 uint8_t LoRaMesh_RemoveTransmission( uint32_t interval, void (*callback)( void *param ) )
 {
-    LoRaSchedulerEventHandler_t * evtHandler;
-    uint8_t result;
+    LoRaSchedulerEventHandler_t *evtHandler, *nextHandler;
+    uint8_t result = ERR_NOTAVAIL;
 
+    evtHandler = pEventHandlers;
     while ( evtHandler != NULL ) {
+        nextHandler = evtHandler->next;
         if ( (evtHandler->eventIntervalTicks == (interval / 1e2))
                 && (evtHandler->callback == callback) ) {
             if ( (result = RemoveEvent(evtHandler)) == ERR_OK ) FreeEventHandler(evtHandler);
         }
-        evtHandler = evtHandler->next;
+        evtHandler = nextHandler;
     }
 
     return result;
@@ -413,6 +547,11 @@ uint8_t LoRaMesh_RegisterReceptionWindow( uint16_t firstSlot, uint32_t interval,
     uint8_t result;
 
     handler = AllocateEventHandler();
+    if ( handler == NULL ) {
+        LOG_ERROR("Unable to allocate event handlers.");
+        return ERR_NOTAVAIL;
+    }
+    handler->eventIntervalTicks = interval / 1e2; /* 10ms per Tick */
     handler->callback = callback;
     handler->param = param;
 
@@ -426,15 +565,17 @@ uint8_t LoRaMesh_RegisterReceptionWindow( uint16_t firstSlot, uint32_t interval,
 
 uint8_t LoRaMesh_RemoveReceptionWindow( uint32_t interval, void (*callback)( void *param ) )
 {
-    LoRaSchedulerEventHandler_t *handler;
-    uint8_t result;
+    LoRaSchedulerEventHandler_t *handler, *nextHandler;
+    uint8_t result = ERR_NOTAVAIL;
 
+    handler = pEventHandlers;
     while ( handler != NULL ) {
+        nextHandler = handler->next;
         if ( (handler->eventIntervalTicks == (interval / 1e2))
                 && (handler->callback == callback) ) {
             if ( (result = RemoveEvent(handler)) == ERR_OK ) FreeEventHandler(handler);
         }
-        handler = handler->next;
+        handler = nextHandler;
     }
 
     return result;
@@ -460,13 +601,29 @@ uint8_t LoRaMesh_SendFrame( uint8_t *appPayload, size_t appPayloadSize, uint8_t
         i++;
     }
 
-    /*! \todo this is a workaround */
-    pLoRaDevice->currChannelIndex = pLoRaDevice->upLinkSlot.ChannelIndex;
-
     return LoRaMesh_PutPayload(buf, sizeof(buf), appPayloadSize, pLoRaDevice->devAddr, fPort,
             isConfirmed);
 }
 
+uint8_t LoRaMesh_QueueFrame( uint8_t *appPayload, size_t appPayloadSize, uint8_t fPort,
+        bool isConfirmed )
+{
+#if(LORAMESH_CONFIG_AGGR_ENABLED == 1)
+    if ( !LoRaMesh_IsNetworkJoined() ) {
+        return ERR_NOTAVAIL;   // No network has been joined yet
+    }
+
+    if ( appPayloadSize > LORAMESH_PAYLOAD_SIZE ) {
+        return ERR_OVERFLOW; /* block too large for payload */
+    }
+
+    return LoRaAggr_Put(pLoRaDevice->devAddr, fPort, appPayload, (uint8_t) appPayloadSize,
+            isConfirmed);
+#else
+    return LoRaMesh_SendFrame(appPayload, appPayloadSize, fPort, true, isConfirmed);
+#endif
+}
+
 uint8_t LoRaMesh_SendMulticast( uint8_t *appPayload, size_t appPayloadSize, uint8_t fPort )
 {
     uint8_t i, buf[LORAMESH_BUFFER_SIZE];
@@ -494,9 +651,6 @@ uint8_t LoRaMesh_SendMulticast( uint8_t *appPayload, size_t appPayloadSize, uint
 
     if ( multicastGrp == NULL ) return ERR_DISABLED;
 
-    /*! \todo this is a workaround */
-    pLoRaDevice->currChannelIndex = multicastGrp->Connection.ChannelIndex;
-
     return LoRaMesh_PutPayload(buf, sizeof(buf), appPayloadSize, multicastGrp->Connection.Address,
             fPort, false);
 }
@@ -506,6 +660,9 @@ uint8_t LoRaMesh_SendAdvertising( void )
     uint8_t buf[LORAMESH_ADVERTISING_MSG_LENGTH + LORAPHY_HEADER_SIZE], payloadSize, phyFlags,
             devRank;
     int32_t latiBin, longiBin;
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    uint32_t coordAddr;
+#endif
 
     payloadSize = 0;
     phyFlags = LORAPHY_PACKET_FLAGS_FRM_ADVERTISING;
@@ -559,7 +716,18 @@ uint8_t LoRaMesh_SendAdvertising( void )
     buf[LORAPHY_BUF_IDX_PAYLOAD + (payloadSize++)] = (uint8_t)(
             pLoRaDevice->advertisingSlot.Duration / 1e6);
 
-    return LoRaPhy_PutPayload(buf, sizeof(buf), payloadSize, phyFlags);
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    /* Path metric to the advertised coordinator, 0 if the node nominated itself */
+    coordAddr = (uint32_t) buf[LORAMESH_ADVERITSING_COORD_ADR_IDX];
+    coordAddr |= ((uint32_t) buf[LORAMESH_ADVERITSING_COORD_ADR_IDX + 1] << 8);
+    coordAddr |= ((uint32_t) buf[LORAMESH_ADVERITSING_COORD_ADR_IDX + 2] << 16);
+    coordAddr |= ((uint32_t) buf[LORAMESH_ADVERITSING_COORD_ADR_IDX + 3] << 24);
+    buf[LORAPHY_BUF_IDX_PAYLOAD + (payloadSize++)] =
+            (coordAddr == pLoRaDevice->devAddr) ? 0 : LoRaRoute_GetAdvertisedMetric();
+#endif
+
+    return LoRaPhy_PutPayload(buf, sizeof(buf), payloadSize, pLoRaDevice->currChannelIndex,
+            phyFlags);
 }
 
 uint8_t LoRaMesh_ProcessAdvertising( uint8_t *aPayload, uint8_t aPayloadSize )
@@ -567,6 +735,8 @@ uint8_t LoRaMesh_ProcessAdvertising( uint8_t *aPayload, uint8_t aPayloadSize )
     uint32_t coordAddr = 0x00, devAddr = 0x00;
     uint8_t rank, role;
 
+    LORASTATS_INC(Mesh, AdvertisingRx);
+
     devAddr |= (aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX]);
     devAddr |= (aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX + 1] << 8);
     devAddr |= (aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX + 2] << 16);
@@ -625,7 +795,7 @@ uint8_t LoRaMesh_JoinReq( uint8_t * devEui, uint8_t * appEui, uint8_t * appKey )
     LORAMAC_BUF_PAYLOAD_START(mPayload)[mPayloadSize++] = (pLoRaDevice->devNonce >> 8) & 0xFF;
 
     return LoRaMac_PutPayload((uint8_t*) &mPayload, sizeof(mPayload), mPayloadSize,
-            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, false);
+            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, pLoRaDevice->currChannelIndex, false);
 }
 
 uint8_t LoRaMesh_JoinMeshReq( uint8_t * devEui, uint8_t * appEui, uint8_t * appKey )
@@ -657,7 +827,7 @@ uint8_t LoRaMesh_JoinMeshReq( uint8_t * devEui, uint8_t * appEui, uint8_t * appK
     LORAMAC_BUF_PAYLOAD_START(mPayload)[mPayloadSize++] = (longiBin >> 24) & 0xFF;
 
     return LoRaMac_PutPayload((uint8_t*) &mPayload, sizeof(mPayload), mPayloadSize,
-            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, false);
+            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, pLoRaDevice->currChannelIndex, false);
 }
 
 uint8_t LoRaMesh_ProcessJoinMeshReq( uint8_t *payload, uint8_t payloadSize )
@@ -691,7 +861,7 @@ uint8_t LoRaMesh_ProcessJoinMeshReq( uint8_t *payload, uint8_t payloadSize )
         newChild = CreateChildNode(LoRaMesh_GenerateDeviceAddress(devNonce), nwkSKey, appSKey, 0,
                 0);
         if ( newChild == NULL ) return ERR_FAILED;
-        ChildNodeAdd(newChild);
+        if ( ChildNodeAdd(newChild) != ERR_OK ) return ERR_FAILED;
         if ( pLoRaDevice->devRole == NODE ) pLoRaDevice->devRole = ROUTER;
     }
 
@@ -729,7 +899,7 @@ uint8_t LoRaMesh_RebindMeshReq( void )
     LORAMAC_BUF_PAYLOAD_START(mPayload)[mPayloadSize++] = (longiBin >> 24) & 0xFF;
 
     return LoRaMac_PutPayload((uint8_t*) &mPayload, sizeof(mPayload), mPayloadSize,
-            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, false);
+            MSG_TYPE_JOIN_REQ, 0x00, 0x00, NULL, pLoRaDevice->currChannelIndex, false);
 }
 
 uint8_t LoRaMesh_ProcessRebindMeshReq( uint8_t *payload, uint8_t payloadSize )
@@ -773,15 +943,30 @@ uint8_t LoRaMesh_LinkCheckReq( void )
 
 uint8_t LoRaMesh_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr, uint8_t fPort )
 {
+    uint8_t result;
+
+    LORALATENCY_RX(LATENCY_STAGE_RX_MESH);
     if ( fPort >= LORAFRM_LOWEST_FPORT && fPort <= LORAFRM_HIGHEST_FPORT ) {
+#if(LORAMESH_CONFIG_AGGR_ENABLED == 1)
+        if ( pLoRaDevice->devRole == ROUTER && fPort != LORAMESH_CONFIG_AGGR_PORT
+                && LoRaMesh_FindChildNode(devAddr) != NULL ) {
+            /* A single record sent unpacked by a child, forwarded with the own uplink */
+            return LoRaAggr_Put(devAddr, fPort, LORAMESH_BUF_PAYLOAD_START(buf), payloadSize,
+                    false);
+        }
+#endif
         PortHandler_t *iterHandler = pPortHandlers;
         while ( iterHandler != NULL ) {
             if ( iterHandler->fPort == fPort && iterHandler->fHandler != NULL ) {
-                return iterHandler->fHandler(buf, payloadSize, devAddr, fPort);
+                LORASTATS_INC(App, RxFrames);
+                result = iterHandler->fHandler(buf, payloadSize, devAddr, fPort);
+                LORALATENCY_RX(LATENCY_STAGE_RX_APP);
+                return result;
             }
             iterHandler = iterHandler->next;
         }
     }
+    LORASTATS_INC(App, NoPortHandler);
 
     return ERR_FAILED;
 }
@@ -789,15 +974,18 @@ uint8_t LoRaMesh_OnPacketRx( uint8_t *buf, uint8_t payloadSize, uint32_t devAddr
 uint8_t LoRaMesh_PutPayload( uint8_t* buf, uint16_t bufSize, uint8_t payloadSize, uint32_t devAddr,
         uint8_t fPort, bool isConfirmed )
 {
+    uint8_t status;
+
     /* Add app information */
+    LORALATENCY_TX(LATENCY_STAGE_TX_MESH);
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("%s - Size %d", __FUNCTION__, payloadSize);
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < payloadSize; i++ )
-    LOG_TRACE_BARE("0x%02x ", buf[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(buf, payloadSize);
 #endif
-    return LoRaFrm_PutPayload(buf, bufSize, payloadSize, devAddr, fPort, isConfirmed);
+    LORASTATS_INC(App, TxFrames);
+    status = LoRaFrm_PutPayload(buf, bufSize, payloadSize, devAddr, fPort, isConfirmed);
+    LORALATENCY_END_TX();
+    return status;
 }
 
 bool LoRaMesh_IsNetworkJoined( void )
@@ -816,13 +1004,10 @@ uint32_t LoRaMesh_GenerateDeviceAddress( uint16_t nonce )
 
 ChildNodeInfo_t* LoRaMesh_FindChildNode( uint32_t devAddr )
 {
-    if ( pLoRaDevice->childNodes != NULL ) {
-        ChildNodeInfo_t *childNode = pLoRaDevice->childNodes;
+    LoRaMeshSession_t *session = LoRaSession_Find(devAddr);
 
-        while ( childNode != NULL ) {
-            if ( childNode->Connection.Address == devAddr ) return childNode;
-            childNode = childNode->next;
-        }
+    if ( session != NULL && session->Type == SESSION_TYPE_CHILD_NODE ) {
+        return (ChildNodeInfo_t*) session->Info;
     }
 
     return NULL;
@@ -830,25 +1015,95 @@ ChildNodeInfo_t* LoRaMesh_FindChildNode( uint32_t devAddr )
 
 MulticastGroupInfo_t* LoRaMesh_FindMulticastGroup( uint32_t grpAddr )
 {
-    if ( pLoRaDevice->multicastGroups != NULL ) {
-        MulticastGroupInfo_t *grp = pLoRaDevice->multicastGroups;
+    LoRaMeshSession_t *session = LoRaSession_Find(grpAddr);
 
-        while ( grp != NULL ) {
-            if ( grp->Connection.Address == grpAddr ) return grp;
-            grp = grp->next;
-        }
+    if ( session != NULL && session->Type == SESSION_TYPE_MULTICAST ) {
+        return (MulticastGroupInfo_t*) session->Info;
     }
 
     return NULL;
 }
 
+void LoRaMesh_StoreSession( void )
+{
+    NvmDeviceRecord_t device;
+    NvmChannelsRecord_t channels;
+    LoRaPhy_ChannelParams_t channelList[LORA_MAX_NB_CHANNELS];
+    uint8_t id;
+
+    device.NetId = pLoRaDevice->netId;
+    device.DevAddr = pLoRaDevice->devAddr;
+    device.CoordinatorAddr = pLoRaDevice->coordinatorAddr;
+    device.DevNonce = pLoRaDevice->devNonce;
+    device.Joined = pLoRaDevice->ctrlFlags.Bits.nwkJoined;
+    device.DevRole = (uint8_t) pLoRaDevice->devRole;
+    memcpy1((uint8_t*) device.ChannelsMask, (uint8_t*) pLoRaDevice->channelsMask,
+            sizeof(device.ChannelsMask));
+    memcpy1(device.NwkSKey, pLoRaDevice->upLinkSlot.NwkSKey, 16);
+    memcpy1(device.AppSKey, pLoRaDevice->upLinkSlot.AppSKey, 16);
+
+    /* Retried with the next frame if any record can not be queued */
+    SessionStorePending = true;
+    if ( !NvmWrite(NVM_KEY_DEVICE, &device, sizeof(device)) ) {
+        LOG_ERROR("Unable to store the session.");
+        return;
+    }
+
+    LoRaPhy_GetChannels(channelList);
+    for ( uint8_t i = 0; i < NVM_NB_CHANNEL_RECORDS; i++ ) {
+        for ( uint8_t j = 0; j < NVM_CHANNELS_PER_RECORD; j++ ) {
+            id = i * NVM_CHANNELS_PER_RECORD + j;
+            channels.Frequency[j] = (id < LORA_MAX_NB_CHANNELS) ? channelList[id].Frequency : 0;
+            channels.DrRange[j] = (id < LORA_MAX_NB_CHANNELS) ? channelList[id].DrRange.Value : 0;
+            channels.Band[j] = (id < LORA_MAX_NB_CHANNELS) ? channelList[id].Band : 0;
+        }
+        if ( !NvmWrite(NVM_KEY_CHANNELS + i, &channels, sizeof(channels)) ) {
+            LOG_ERROR("Unable to store the channels.");
+            return;
+        }
+    }
+
+    if ( !NvmCounterSet(NVM_KEY_UP_LINK_COUNTER, pLoRaDevice->upLinkSlot.UpLinkCounter)
+            || !NvmCounterSet(NVM_KEY_DOWN_LINK_COUNTER, pLoRaDevice->upLinkSlot.DownLinkCounter) ) {
+        LOG_ERROR("Unable to store the frame counters.");
+        return;
+    }
+    SessionStorePending = false;
+}
+
+void LoRaMesh_StoreFrameCounters( LoRaMeshSession_t *session )
+{
+    if ( SessionStorePending ) {
+        LoRaMesh_StoreSession();
+    }
+
+    if ( session->Type == SESSION_TYPE_UPLINK ) {
+        if ( !NvmCounterUpdate(NVM_KEY_UP_LINK_COUNTER, pLoRaDevice->upLinkSlot.UpLinkCounter)
+                || !NvmCounterUpdate(NVM_KEY_DOWN_LINK_COUNTER,
+                        pLoRaDevice->upLinkSlot.DownLinkCounter) ) {
+            LOG_ERROR("Unable to store the frame counters.");
+        }
+    } else if ( session->Type == SESSION_TYPE_CHILD_NODE ) {
+        /* Coalesced in the pending slot of the child node until the NVM task runs */
+        (void) StoreChildNode((ChildNodeInfo_t*) session->Info);
+    }
+}
+
 /*******************************************************************************
  * PUBLIC SETUP FUNCTIONS
  ******************************************************************************/
 void LoRaMesh_SetNwkIds( uint32_t netID, uint32_t devAddr, uint8_t *nwkSKey, uint8_t *appSKey )
 {
+    /* Other IDs than the restored ones start a new session */
+    if ( devAddr != pLoRaDevice->devAddr || memcmp(nwkSKey, pLoRaDevice->upLinkSlot.NwkSKey, 16) != 0
+            || memcmp(appSKey, pLoRaDevice->upLinkSlot.AppSKey, 16) != 0 ) {
+        SessionRestored = false;
+    }
+
+    LoRaMacCryptoInvalidateKeys(pLoRaDevice->devAddr);
+
     pLoRaDevice->netId = netID;
-    pLoRaDevice->devAddr = devAddr;
+    LoRaMesh_SetDevAddr(devAddr);
 
     for ( uint8_t i = 0; i < 16; i++ ) {
         pLoRaDevice->upLinkSlot.AppSKey[i] = appSKey[i];
@@ -856,6 +1111,20 @@ void LoRaMesh_SetNwkIds( uint32_t netID, uint32_t devAddr, uint8_t *nwkSKey, uin
     }
 
     pLoRaDevice->ctrlFlags.Bits.nwkJoined = 1;
+    LoRaMesh_StoreSession();
+}
+
+void LoRaMesh_SetDevAddr( uint32_t devAddr )
+{
+    LoRaMeshSession_t *session = LoRaSession_Find(pLoRaDevice->devAddr);
+
+    if ( session != NULL && session->Type == SESSION_TYPE_UPLINK ) {
+        LoRaSession_Remove(pLoRaDevice->devAddr);
+    }
+
+    pLoRaDevice->devAddr = devAddr;
+    pLoRaDevice->upLinkSlot.Address = devAddr;
+    LoRaSession_Add(devAddr, SESSION_TYPE_UPLINK, &pLoRaDevice->upLinkSlot, NULL);
 }
 
 void LoRaMesh_SetDeviceClass( DeviceClass_t devClass )
@@ -929,6 +1198,7 @@ void LoRaMesh_TestSetDutyCycleCtrlOff( bool enable )
 {
     if ( pLoRaDevice != NULL ) {
         pLoRaDevice->dbgFlags.Bits.dutyCycleCtrlOff = (enable ? 1U : 0U);
+        LoRaMacSchedulerSetDutyCycleOn(!enable);
     }
 }
 
@@ -950,11 +1220,15 @@ void LoRaMesh_TestSetMic( uint16_t upLinkCounter )
 void LoRaMesh_TestCreateChildNode( uint32_t devAddr, uint32_t interval, uint32_t freqChannel,
         uint8_t *nwkSKey, uint8_t *appSKey )
 {
-    ChildNodeInfo_t *newChildNode = CreateChildNode(devAddr, nwkSKey, appSKey, freqChannel,
-            interval);
+    ChildNodeInfo_t *newChildNode;
 
+    if ( LoRaMesh_FindChildNode(devAddr) != NULL ) {
+        return; /* restored from the NVM */
+    }
+
+    newChildNode = CreateChildNode(devAddr, nwkSKey, appSKey, freqChannel, interval);
     if ( newChildNode != NULL ) {
-        ChildNodeAdd(newChildNode);
+        (void) ChildNodeAdd(newChildNode);
     }
 }
 
@@ -965,7 +1239,7 @@ void LoRaMesh_TestCreateMulticastGroup( uint32_t grpAddr, uint32_t interval, uin
             interval, isOwner);
 
     if ( newGrp != NULL ) {
-        MulticastGroupAdd(newGrp);
+        (void) MulticastGroupAdd(newGrp);
     }
 }
 
@@ -989,6 +1263,10 @@ void LoRaMesh_TestOpenReceptionWindow( uint8_t channel, uint8_t datarate )
 /*!
  * Schedule a LoRaMesh event
  *
+ * \remark All occurrences of the event (and the rx windows of uplinks) are
+ *         reserved in the slot bitmap and inserted into the sorted scheduler
+ *         list. Either all occurrences are scheduled or none.
+ *
  * \param[OUT] eHandler Allocated event handler
  * \param[IN] firstSlot First event occurrence (0xFFFF if first occurrence can be
  *            selected by the scheduler)
@@ -1001,16 +1279,19 @@ static uint8_t ScheduleEvent( LoRaSchedulerEventHandler_t *evtHandler,
         LoRaSchedulerEventType_t eventType, uint16_t firstSlot, TimerTime_t interval,
         TimerTime_t duration )
 {
-    LoRaSchedulerEvent_t *evt = NULL;
-    uint16_t durationInSlots;
-    uint16_t allocatedSlots[32];
+    LoRaSchedulerEvent_t *evt;
+    LoRaSlotPattern_t pattern;
+    uint16_t durationInSlots, intervalInSlots, startSlot, nofOccurrences;
+    uint16_t i, nofEvents;
     bool receptionWindows = false;
-    uint8_t i, j, nofAllocatedSlots;
 
-    if ( firstSlot < 0 || (firstSlot > 512 && firstSlot != 0xFFFF) ) {
+    if ( firstSlot >= NOF_AVAILABLE_SLOTS && firstSlot != LORASLOTS_ANY_SLOT ) {
         return ERR_RANGE;
     }
 
+    intervalInSlots = interval / TIME_PER_SLOT;
+    if ( intervalInSlots == 0 ) return ERR_RANGE;
+
     if ( eventType == EVENT_TYPE_UPLINK ) {
         receptionWindows = true;
     }
@@ -1018,71 +1299,50 @@ static uint8_t ScheduleEvent( LoRaSchedulerEventHandler_t *evtHandler,
     durationInSlots = duration / TIME_PER_SLOT;
     if ( duration % TIME_PER_SLOT != 0 ) durationInSlots++;
 
-    if ( FindFreeSlots(firstSlot, interval, durationInSlots, (uint8_t*) &nofAllocatedSlots,
-            (uint16_t*) &allocatedSlots, receptionWindows) != ERR_OK ) return ERR_FAILED;
+    pattern.Interval = intervalInSlots;
+    pattern.Duration = durationInSlots;
+    pattern.RxWindows = receptionWindows;
+    pattern.Rx1Delay = pLoRaDevice->rxWindow1Delay / TIME_PER_SLOT;
+    pattern.Rx2Delay = pLoRaDevice->rxWindow2Delay / TIME_PER_SLOT;
+    if ( LoRaSlots_Find(firstSlot, &pattern, &startSlot, &nofOccurrences) != ERR_OK ) {
+        LORASTATS_INC(Mesh, SchedulerNoSlot);
+        return ERR_FAILED;
+    }
 
-    for ( i = 0; i < nofAllocatedSlots; i++ ) {
-        evt = AllocateEvent();
+    /* Make sure enough events are available before touching the scheduler list */
+    nofEvents = receptionWindows ? (3 * nofOccurrences) : nofOccurrences;
+    for ( i = 0, evt = pFreeSchedulerEvent; i < nofEvents && evt != NULL; i++ ) {
+        evt = evt->next;
+    }
+    if ( i < nofEvents ) {
+        LOG_ERROR("Unable to allocate event.");
+        LORASTATS_INC(Mesh, SchedulerNoEvent);
+        return ERR_NOTAVAIL;
+    }
 
-        if ( evt == NULL ) {
-            LOG_ERROR("Unable to allocate event.");
-            return ERR_NOTAVAIL;
-        }
+    for ( i = 0; i < nofOccurrences; i++ ) {
+        evt = AllocateEvent();
         evt->eventType = eventType;
         evt->eventHandler = evtHandler;
-        evt->startSlot = allocatedSlots[i];
+        evt->startSlot = startSlot + (intervalInSlots * i);
         evt->endSlot = evt->startSlot + durationInSlots;
-
-        if ( pEventScheduler == NULL ) {
-            evt->next = NULL;
-            pNextSchedulerEvent = evt;
-            pEventScheduler = evt;
-        } else {
-            LoRaSchedulerEvent_t *iterEvt = pEventScheduler;
-            while ( iterEvt != NULL ) {
-                if ( iterEvt == pEventScheduler && evt->endSlot < iterEvt->startSlot ) {
-                    evt->next = iterEvt;
-                    pNextSchedulerEvent = evt;
-                    pEventScheduler = evt;
-                    break;
-                } else if ( ((iterEvt->endSlot < evt->startSlot) && (iterEvt->next != NULL)
-                        && (iterEvt->next->startSlot > evt->endSlot))
-                        || ((iterEvt->next == NULL) && (iterEvt->endSlot < evt->startSlot)) ) {
-                    evt->next = iterEvt->next;
-                    iterEvt->next = evt;
-                    break;
-                }
-                iterEvt = iterEvt->next;
-            }
-        }
+        LoRaSlots_Reserve(evt->startSlot, evt->endSlot);
+        InsertEvent(evt);
 
         if ( receptionWindows ) {
             LoRaSchedulerEvent_t *rxEvt;
+            uint8_t j;
             for ( j = 0; j < 2; j++ ) {
                 rxEvt = AllocateEvent();
-                if ( rxEvt == NULL ) {
-                    LOG_ERROR("Coulnd't allocate reception window %u", j);
-                    return ERR_NOTAVAIL;
-                }
                 rxEvt->eventType = (j == 0) ? EVENT_TYPE_RX1_WINDOW : EVENT_TYPE_RX2_WINDOW;
-                rxEvt->eventHandler = NULL;   //&eventHandlerList[j];
-                rxEvt->startSlot = allocatedSlots[(i + 1) + j];
+                rxEvt->eventHandler = evtHandler;
+                rxEvt->startSlot = evt->endSlot
+                        + (((j == 0) ? pLoRaDevice->rxWindow1Delay : pLoRaDevice->rxWindow2Delay)
+                                / TIME_PER_SLOT);
                 rxEvt->endSlot = rxEvt->startSlot + (RECEPTION_RESERVED_TIME / TIME_PER_SLOT);
-
-                /* Place in scheduler event list */
-                LoRaSchedulerEvent_t *iterEvt = pEventScheduler;
-                while ( iterEvt != NULL ) {
-                    if ( ((iterEvt->endSlot < rxEvt->startSlot) && (iterEvt->next != NULL)
-                            && (iterEvt->next->startSlot > rxEvt->endSlot))
-                            || ((iterEvt->next == NULL) && (iterEvt->endSlot < rxEvt->startSlot)) ) {
-                        rxEvt->next = iterEvt->next;
-                        iterEvt->next = rxEvt;
-                        break;
-                    }
-                    iterEvt = iterEvt->next;
-                }
+                LoRaSlots_Reserve(rxEvt->startSlot, rxEvt->endSlot);
+                InsertEvent(rxEvt);
             }
-            i += 2;
         }
     }
 
@@ -1093,46 +1353,38 @@ static uint8_t ScheduleEvent( LoRaSchedulerEventHandler_t *evtHandler,
 /*!
  * Remove event
  *
+ * \remark Removes all occurrences and rx windows of the event handler in a
+ *         single pass over the scheduler list. The event handler itself is
+ *         not freed.
+ *
  * \param[IN] evtHandler Pointer to scheduler event handler to remove
  *
  * \retval status ERR_OK if removed successfully
  */
 static uint8_t RemoveEvent( LoRaSchedulerEventHandler_t *evtHandler )
 {
-    LoRaSchedulerEvent_t *iterEvt;
+    LoRaSchedulerEvent_t *iterEvt, *prevEvt, *nextEvt;
 
     /* Find and remove all related scheduler events */
+    prevEvt = NULL;
     iterEvt = pEventScheduler;
     while ( iterEvt != NULL ) {
+        nextEvt = iterEvt->next;
         if ( iterEvt->eventHandler == evtHandler ) {
-            /* In case it's an uplink event we also have to remove related rx windows */
-            if ( iterEvt->eventType == EVENT_TYPE_UPLINK ) {
-                LoRaSchedulerEvent_t *iterRxEvt = pEventScheduler;
-                /* Remove rx1 window */
-                while ( iterRxEvt != NULL ) {
-                    if ( iterRxEvt->startSlot
-                            == (iterEvt->startSlot + (pLoRaDevice->rxWindow1Delay / TIME_PER_SLOT)) ) {
-                        /* Corresponding rx1 window found */
-                        FreeEvent(iterRxEvt);
-                        break;
-                    }
-                    iterRxEvt = iterRxEvt->next;
-                }
-                /* Remove rx2 window */
-                iterRxEvt = pEventScheduler;
-                while ( iterRxEvt != NULL ) {
-                    if ( iterRxEvt->startSlot
-                            == (iterEvt->startSlot + (pLoRaDevice->rxWindow2Delay / TIME_PER_SLOT)) ) {
-                        /* Corresponding rx2 window found */
-                        FreeEvent(iterRxEvt);
-                        break;
-                    }
-                    iterRxEvt = iterRxEvt->next;
-                }
+            if ( prevEvt == NULL ) {
+                pEventScheduler = nextEvt;
+            } else {
+                prevEvt->next = nextEvt;
             }
+            if ( pNextSchedulerEvent == iterEvt ) {
+                pNextSchedulerEvent = (nextEvt != NULL) ? nextEvt : pEventScheduler;
+            }
+            LoRaSlots_Release(iterEvt->startSlot, iterEvt->endSlot);
             FreeEvent(iterEvt);
+        } else {
+            prevEvt = iterEvt;
         }
-        iterEvt = iterEvt->next;
+        iterEvt = nextEvt;
     }
 
     /* Check if scheduler list is empty */
@@ -1140,176 +1392,31 @@ static uint8_t RemoveEvent( LoRaSchedulerEventHandler_t *evtHandler )
         TimerStop(&EventSchedulerTimer);
         pNextSchedulerEvent = NULL;
     }
-    /* Free event handler */
-    FreeEventHandler(evtHandler);
     return ERR_OK;
 }
 
 /*!
- * Find a specified number of free slots within the advertising window
- *
- * \param[IN] interval Time between slots
- * \param[IN] durationInSlots Duration of a single allocation
- * \param[OUT] nofAllocatedSlots  Number of allocated slots
- * \param[OUT] allocatedSlots Allocated slot numbers
- * \param[IN] scheduleRxWindows Schedule rx1 and rx2 windows (only for uplinks)
+ * Insert event into the scheduler list sorted by start slot
  *
- * \retval status ERR_OK if slot allocation was successful
+ * \param[IN] evt Scheduler event with reserved slots
  */
-static uint8_t FindFreeSlots( uint16_t firstSlot, TimerTime_t interval, uint16_t durationInSlots,
-        uint8_t *nofAllocatedSlots, uint16_t *allocatedSlots, bool scheduleRxWindows )
+static void InsertEvent( LoRaSchedulerEvent_t *evt )
 {
-    uint8_t nofAllocationTries = 10, maxNofSlots;
-    uint16_t slots[32];
-    LoRaSchedulerEvent_t *evt;
-    uint16_t i = 0;
-
-    *(nofAllocatedSlots) = 0;
-
-    /* Calculate max number of slot allocations */
-    maxNofSlots = (AVAILABLE_SLOT_TIME / interval);
-    if ( (AVAILABLE_SLOT_TIME % interval) > 0 ) maxNofSlots += 1;
-
-    if ( pEventScheduler == NULL ) {
-        uint16_t slot;
-        if ( firstSlot == 0xFFFF ) firstSlot = 0;
-        for ( i = 0; i < maxNofSlots; i++ ) {
-            slot = firstSlot + ((interval / TIME_PER_SLOT) * i);
-            if ( scheduleRxWindows ) {
-                uint16_t slotRx1, slotRx2;
-                slotRx1 = slot + durationInSlots + (pLoRaDevice->rxWindow1Delay / TIME_PER_SLOT);
-                slotRx2 = slot + durationInSlots + (pLoRaDevice->rxWindow2Delay / TIME_PER_SLOT);
-                /* Make sure Rx windows fit in as well */
-                if ( (slotRx2 + durationInSlots) < NOF_AVAILABLE_SLOTS ) {
-                    *(allocatedSlots++) = slot;
-                    *(allocatedSlots++) = slotRx1;
-                    *(allocatedSlots++) = slotRx2;
-                    *(nofAllocatedSlots) += 3;
-                    continue;
-                }
-                break;
-            } else {
-                if ( (slot + durationInSlots) < NOF_AVAILABLE_SLOTS ) {
-                    *(allocatedSlots++) = slot;
-                    *(nofAllocatedSlots) += 1;
-                }
-            }
-        }
-    } else {
-        bool allocationDone = false, allocationAborted = false;
-        uint16_t nextSlot = 0, offSet = 0;
-        uint32_t timeFrame = 0;
-
-        if ( scheduleRxWindows ) maxNofSlots *= 3;
-
-        slots[0] = 0xFFFF;
-
-        while ( !allocationDone && !allocationAborted && nofAllocationTries > 0 ) {
-            /* Find first free slot */
-            evt = pEventScheduler;
-            while ( evt != NULL ) {
-                if ( firstSlot == 0xFFFF ) { /* Free to select any free slot */
-                    if ( evt->next != NULL ) {
-                        timeFrame = (evt->next->startSlot - evt->endSlot);
-                    } else {
-                        timeFrame = NOF_AVAILABLE_SLOTS - evt->endSlot - 1;
-                    }
-
-                    if ( timeFrame > durationInSlots ) {
-                        /* Potential first slot found */
-                        slots[0] = (evt->endSlot + 1 + offSet);
-                        *(nofAllocatedSlots) += 1;
-                        break;
-                    }
-                } else { /* Check if requested first slot is available */
-                    if ( (evt == pEventScheduler && evt->startSlot > firstSlot) ) {
-                        if ( (firstSlot + durationInSlots) < evt->startSlot ) {
-                            /* First slot available */
-                            slots[0] = firstSlot;
-                            *(nofAllocatedSlots) += 1;
-                            break;
-                        }
-                    } else if ( firstSlot > evt->endSlot && evt->next != NULL
-                            && firstSlot < evt->next->startSlot ) {
-                        if ( (evt->endSlot + firstSlot + durationInSlots + 1)
-                                < evt->next->startSlot ) {
-                            /* First slot available */
-                            slots[0] = firstSlot;
-                            *(nofAllocatedSlots) += 1;
-                            break;
-                        }
-                    }
-                }
-                evt = evt->next;
-            }
-
-            if ( slots[0] == 0xFFFF ) {
-                /* Unable to allocate first slot */
-                return ERR_FAILED;
-            }
+    LoRaSchedulerEvent_t *iterEvt;
 
-            /* Allocate recurring events */
-            for ( i = 1; i < maxNofSlots; i++ ) {
-                if ( scheduleRxWindows ) {
-                    if ( (i % 3) == 1 ) {
-                        nextSlot = slots[0] + durationInSlots
-                                + ((interval / TIME_PER_SLOT) * (i / 3))
-                                + (pLoRaDevice->rxWindow1Delay / TIME_PER_SLOT);
-                    } else if ( (i % 3) == 2 ) {
-                        nextSlot = slots[0] + durationInSlots
-                                + ((interval / TIME_PER_SLOT) * (i / 3))
-                                + (pLoRaDevice->rxWindow2Delay / TIME_PER_SLOT);
-                    } else {
-                        nextSlot = slots[0] + ((interval / TIME_PER_SLOT) * (i / 3));
-                        /* Check if rx2 window fits within available slots */
-                        if ( (nextSlot + (pLoRaDevice->rxWindow2Delay / TIME_PER_SLOT))
-                                > NOF_AVAILABLE_SLOTS ) {
-                            allocationDone = true;
-                            break;
-                        }
-                    }
-                } else {
-                    nextSlot = slots[0] + ((interval / TIME_PER_SLOT) * i);
-                }
-                slots[i] = 0xFFFF;
-                while ( evt != NULL ) {
-                    if ( evt->endSlot < nextSlot ) {
-                        if ( ((evt->next != NULL) && (evt->next->startSlot > nextSlot))
-                                || ((evt->next == NULL)
-                                        && ((NOF_AVAILABLE_SLOTS - durationInSlots) > nextSlot)) ) {
-                            slots[i] = nextSlot;
-                            *(nofAllocatedSlots) += 1;
-                            break;
-                        }
-                    } else {
-                        offSet +=
-                                ((evt->startSlot + (evt->endSlot - evt->startSlot)) - nextSlot + 1);
-                        break;
-                    }
-                    evt = evt->next;
-                }
-                /* Allocation not possible */
-                if ( firstSlot != 0xFFFF && slots[i] == 0xFFFF ) {
-                    allocationAborted = true;
-                    break;
-                } else if ( slots[i] == 0xFFFF ) {
-                    *(nofAllocatedSlots) = 0; /* Reset */
-                    nofAllocationTries--;
-                    break;
-                }
-            }
-            if ( i == (maxNofSlots) ) allocationDone = true;
-        }
+    if ( pEventScheduler == NULL || evt->startSlot < pEventScheduler->startSlot ) {
+        evt->next = pEventScheduler;
+        pEventScheduler = evt;
+        pNextSchedulerEvent = evt;
+        return;
+    }
 
-        if ( nofAllocationTries == 0 ) {
-            return ERR_FAILED;
-        } else {
-            for ( i = 0; i < (*nofAllocatedSlots); i++ ) {
-                *(allocatedSlots++) = slots[i];
-            }
-        }
+    iterEvt = pEventScheduler;
+    while ( iterEvt->next != NULL && iterEvt->next->startSlot < evt->startSlot ) {
+        iterEvt = iterEvt->next;
     }
-    return ERR_OK;
+    evt->next = iterEvt->next;
+    iterEvt->next = evt;
 }
 
 /*!
@@ -1323,7 +1430,7 @@ static void AdvertisingEvent( void )
     /* Add packet to message queue */
     LoRaMesh_SendAdvertising();
 
-    LastAdvertisingWindow = TimerGetCurrentTime();
+    LastAdvertisingWindow = TimerGetPreciseTime();
 
     /* Restart event scheduler */
     if ( pEventScheduler != NULL ) {
@@ -1341,7 +1448,7 @@ static void AdvertisingEvent( void )
  */
 static void OnEventSchedulerTimerEvent( TimerHandle_t xTimer )
 {
-    uint32_t nextEvtTime, currTime;
+    uint32_t nextEvtTime, elapsed;
     uint16_t slot;
 
     TimerStop(&EventSchedulerTimer);
@@ -1349,11 +1456,11 @@ static void OnEventSchedulerTimerEvent( TimerHandle_t xTimer )
 
     if ( pNextSchedulerEvent == NULL ) return;
 
-    currTime = TimerGetCurrentTime();
-    slot = ((((currTime - LastAdvertisingWindow) * portTICK_PERIOD_MS) * 1000)
-            - ADVERTISING_RESERVED_TIME) / TIME_PER_SLOT;
+    /* Precise time base, the tick count would be off by up to one tick */
+    elapsed = (uint32_t) (TimerGetPreciseTime() - LastAdvertisingWindow);
+    slot = (elapsed - ADVERTISING_RESERVED_TIME) / TIME_PER_SLOT;
 
-    LOG_TRACE("Event scheduler at slot %u (%u ms)", slot, currTime);
+    LOG_TRACE("Event scheduler at slot %u (%u us)", slot, elapsed);
 
     if ( pNextSchedulerEvent->next == NULL ) {
         /* Restart scheduler */
@@ -1361,21 +1468,28 @@ static void OnEventSchedulerTimerEvent( TimerHandle_t xTimer )
         return;
     } else if ( pNextSchedulerEvent->startSlot == slot ) {
         /* Start scheduler timer */
-        nextEvtTime = ((pNextSchedulerEvent->next->startSlot - pNextSchedulerEvent->startSlot)
-                * TIME_PER_SLOT);
+        nextEvtTime = SlotTimeout(pNextSchedulerEvent->next->startSlot, elapsed);
         /* Start scheduler timer */
         TimerSetValue(&EventSchedulerTimer, nextEvtTime);
         TimerStart(&EventSchedulerTimer);
         /* Invoke callback function */
-        if ( pNextSchedulerEvent->eventHandler != NULL
+        if ( pNextSchedulerEvent->eventType != EVENT_TYPE_RX1_WINDOW
+                && pNextSchedulerEvent->eventType != EVENT_TYPE_RX2_WINDOW
+                && pNextSchedulerEvent->eventHandler != NULL
                 && pNextSchedulerEvent->eventHandler->callback != NULL ) {
             pNextSchedulerEvent->eventHandler->callback(pNextSchedulerEvent->eventHandler->param);
         }
+#if(LORAMESH_CONFIG_AGGR_ENABLED == 1)
+        /* Send the records queued up to and by the uplink callback */
+        if ( pNextSchedulerEvent->eventType == EVENT_TYPE_UPLINK ) {
+            (void) LoRaAggr_Flush();
+        }
+#endif
     } else {
         LOG_ERROR("Drift occurred. Skip event. (Start %u / Current %u)",
                 pNextSchedulerEvent->startSlot, slot);
         /* Start scheduler timer */
-        nextEvtTime = ((pNextSchedulerEvent->next->startSlot - slot) * TIME_PER_SLOT);
+        nextEvtTime = SlotTimeout(pNextSchedulerEvent->next->startSlot, elapsed);
         /* Start scheduler timer */
         TimerSetValue(&EventSchedulerTimer, nextEvtTime);
         TimerStart(&EventSchedulerTimer);
@@ -1385,6 +1499,26 @@ static void OnEventSchedulerTimerEvent( TimerHandle_t xTimer )
     pNextSchedulerEvent = pNextSchedulerEvent->next;
 }
 
+/*!
+ * Computes the scheduler timeout to the start of a slot. The slot start is
+ * relative to the advertising window, thus the latency of the timer callbacks
+ * does not add up over the slots.
+ *
+ * \param slot Slot to be started
+ * \param elapsed Time since the start of the advertising window [us]
+ *
+ * \retval uint32_t Timeout [us], at least SCHEDULER_MIN_TIMEOUT
+ */
+static uint32_t SlotTimeout( uint16_t slot, uint32_t elapsed )
+{
+    uint32_t start = ADVERTISING_RESERVED_TIME + (slot * TIME_PER_SLOT);
+
+    if ( start < elapsed + SCHEDULER_MIN_TIMEOUT ) {
+        return SCHEDULER_MIN_TIMEOUT;
+    }
+    return start - elapsed;
+}
+
 /*!
  * Evaluates probability of a node to accept a join mesh or rebind
  * mesh request depending on distance to the node and the current
@@ -1440,7 +1574,7 @@ static LoRaSchedulerEvent_t *AllocateEvent( void )
     if ( evt != NULL ) {
         pFreeSchedulerEvent = evt->next;
         evt->startSlot = 0;
-        evt->startSlot = 0;
+        evt->endSlot = 0;
         evt->next = NULL;
         evt->eventType = EVENT_TYPE_NONE;
         evt->eventHandler = NULL;
@@ -1452,34 +1586,18 @@ static LoRaSchedulerEvent_t *AllocateEvent( void )
 /*!
  * Free allocated LoRa scheduler event
  *
+ * \remark The event must already be unlinked from the scheduler list.
+ *
  * \param[IN] evt LoRa scheduler event to be freed
  */
 static void FreeEvent( LoRaSchedulerEvent_t *evt )
 {
-    if ( pEventScheduler != NULL ) {
-        LoRaSchedulerEvent_t *prevEvt, *iterEvt;
-        prevEvt = NULL;
-        iterEvt = pEventScheduler;
-
-        while ( iterEvt != NULL ) {
-            if ( iterEvt == evt ) {
-                if ( prevEvt == NULL ) {
-                    pEventScheduler = iterEvt->next;
-                } else {
-                    prevEvt->next = iterEvt->next;
-                }
-                iterEvt->next = pFreeSchedulerEvent;
-                iterEvt->startSlot = 0;
-                iterEvt->endSlot = 0;
-                evt->eventType = EVENT_TYPE_NONE;
-                iterEvt->eventHandler = NULL;
-                pFreeSchedulerEvent = iterEvt;
-                break;
-            }
-            prevEvt = iterEvt;
-            iterEvt = iterEvt->next;
-        }
-    }
+    evt->next = pFreeSchedulerEvent;
+    evt->startSlot = 0;
+    evt->endSlot = 0;
+    evt->eventType = EVENT_TYPE_NONE;
+    evt->eventHandler = NULL;
+    pFreeSchedulerEvent = evt;
 }
 
 /*!
@@ -1554,6 +1672,7 @@ ChildNodeInfo_t* CreateChildNode( uint32_t devAddr, uint8_t* nwkSKey, uint8_t* a
 
     if ( newNode != NULL ) {
         pFreeChildNode = newNode->next;
+        LoRaMacCryptoInvalidateKeys(devAddr);
         newNode->Connection.Address = devAddr;
         memcpy1(newNode->Connection.AppSKey, appSKey, 16);
         memcpy1(newNode->Connection.NwkSKey, nwkSKey, 16);
@@ -1562,6 +1681,7 @@ ChildNodeInfo_t* CreateChildNode( uint32_t devAddr, uint8_t* nwkSKey, uint8_t* a
         newNode->Connection.DataRateIndex = LORAMAC_DEFAULT_DATARATE;
         newNode->Connection.TxPowerIndex = LORAMAC_DEFAULT_TX_POWER;
         newNode->Periodicity = interval;
+        LoRaStats_LinkReset(&newNode->Link);
         return newNode;
     }
     return NULL;
@@ -1571,12 +1691,21 @@ ChildNodeInfo_t* CreateChildNode( uint32_t devAddr, uint8_t* nwkSKey, uint8_t* a
  * \brief Add child node at the tail of the list.
  *
  * \param childNode Child Node to append
+ *
+ * \retval uint8_t Status [ERR_OK, ERR_FAILED: no session, the node is freed]
  */
-void ChildNodeAdd( ChildNodeInfo_t* childNode )
+uint8_t ChildNodeAdd( ChildNodeInfo_t* childNode )
 {
 // Reset uplink counter
     childNode->Connection.UpLinkCounter = 0;
 
+    if ( LoRaSession_Add(childNode->Connection.Address, SESSION_TYPE_CHILD_NODE,
+            &childNode->Connection, childNode) == NULL ) {
+        childNode->next = pFreeChildNode;
+        pFreeChildNode = childNode;
+        return ERR_FAILED;
+    }
+
     if ( pLoRaDevice->childNodes == NULL ) {
         childNode->next = NULL;
         pLoRaDevice->childNodes = childNode;
@@ -1584,6 +1713,10 @@ void ChildNodeAdd( ChildNodeInfo_t* childNode )
         childNode->next = pLoRaDevice->childNodes;
         pLoRaDevice->childNodes = childNode;
     }
+
+    /* The child node works without persistence, the failure is logged */
+    (void) StoreChildNode(childNode);
+    return ERR_OK;
 }
 
 /*!
@@ -1593,17 +1726,21 @@ void ChildNodeAdd( ChildNodeInfo_t* childNode )
  */
 void ChildNodeRemove( ChildNodeInfo_t* childNode )
 {
-    if ( pLoRaDevice->childNodes != NULL ) {
-        ChildNodeInfo_t* iterNode = pLoRaDevice->childNodes;
-
-        while ( iterNode->next != NULL ) {
-            if ( iterNode->next == childNode ) {
-                iterNode->next = childNode->next;
-                childNode->next = pFreeChildNode;
-                pFreeChildNode = childNode;
+    ChildNodeInfo_t** iterNode = &pLoRaDevice->childNodes;
+
+    while ( *iterNode != NULL ) {
+        if ( *iterNode == childNode ) {
+            *iterNode = childNode->next;
+            LoRaSession_Remove(childNode->Connection.Address);
+            LoRaMacCryptoInvalidateKeys(childNode->Connection.Address);
+            if ( !NvmDelete(NVM_KEY_CHILD_NODES + (childNode - childNodeList)) ) {
+                LOG_ERROR("Unable to delete child node 0x%08x.", childNode->Connection.Address);
             }
-            iterNode = iterNode->next;
+            childNode->next = pFreeChildNode;
+            pFreeChildNode = childNode;
+            break;
         }
+        iterNode = &(*iterNode)->next;
     }
 }
 
@@ -1623,6 +1760,7 @@ MulticastGroupInfo_t* CreateMulticastGroup( uint32_t grpAddr, uint8_t* nwkSKey,
 
     if ( newGrp != NULL ) {
         pFreeMulticastGrp = newGrp->next;
+        LoRaMacCryptoInvalidateKeys(grpAddr);
         newGrp->Connection.Address = grpAddr;
         memcpy1(newGrp->Connection.AppSKey, appSKey, 16);
         memcpy1(newGrp->Connection.NwkSKey, nwkSKey, 16);
@@ -1641,12 +1779,21 @@ MulticastGroupInfo_t* CreateMulticastGroup( uint32_t grpAddr, uint8_t* nwkSKey,
  * \brief Add mutlicast group.
  *
  * \param multicastGrp Pointer to information structure of the multicast group to be added.
+ *
+ * \retval uint8_t Status [ERR_OK, ERR_FAILED: no session, the group is freed]
  */
-void MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp )
+uint8_t MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp )
 {
 // Reset downlink counter
     multicastGrp->Connection.DownLinkCounter = 0;
 
+    if ( LoRaSession_Add(multicastGrp->Connection.Address, SESSION_TYPE_MULTICAST,
+            &multicastGrp->Connection, multicastGrp) == NULL ) {
+        multicastGrp->next = pFreeMulticastGrp;
+        pFreeMulticastGrp = multicastGrp;
+        return ERR_FAILED;
+    }
+
     if ( pLoRaDevice->multicastGroups == NULL ) {
         multicastGrp->next = NULL;
         pLoRaDevice->multicastGroups = multicastGrp;
@@ -1654,6 +1801,7 @@ void MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp )
         multicastGrp->next = pLoRaDevice->multicastGroups;
         pLoRaDevice->multicastGroups = multicastGrp;
     }
+    return ERR_OK;
 }
 
 /*!
@@ -1663,18 +1811,145 @@ void MulticastGroupAdd( MulticastGroupInfo_t *multicastGrp )
  */
 void MulticastGroupRemove( MulticastGroupInfo_t *multicastGrp )
 {
-    if ( pLoRaDevice->multicastGroups != NULL ) {
-        MulticastGroupInfo_t* iterGrp = pLoRaDevice->multicastGroups;
+    MulticastGroupInfo_t** iterGrp = &pLoRaDevice->multicastGroups;
+
+    while ( *iterGrp != NULL ) {
+        if ( *iterGrp == multicastGrp ) {
+            *iterGrp = multicastGrp->next;
+            LoRaSession_Remove(multicastGrp->Connection.Address);
+            LoRaMacCryptoInvalidateKeys(multicastGrp->Connection.Address);
+            multicastGrp->next = pFreeMulticastGrp;
+            pFreeMulticastGrp = multicastGrp;
+            break;
+        }
+        iterGrp = &(*iterGrp)->next;
+    }
+}
 
-        while ( iterGrp->next != NULL ) {
-            if ( iterGrp->next == multicastGrp ) {
-                iterGrp->next = multicastGrp->next;
-                multicastGrp->next = pFreeMulticastGrp;
-                pFreeMulticastGrp = multicastGrp;
+/*!
+ * \brief Restore the device session, the channels, the frame counters and the
+ *        child nodes stored in the NVM.
+ */
+static void RestoreSession( void )
+{
+    NvmDeviceRecord_t device;
+    NvmChannelsRecord_t channels;
+    LoRaPhy_ChannelParams_t channel;
+    uint8_t id;
+
+    if ( NvmRead(NVM_KEY_DEVICE, &device, sizeof(device)) != sizeof(device) ) {
+        return; /* nothing stored */
+    }
+
+    /* Without the frame counters the session can not be continued */
+    if ( !NvmCounterRestore(NVM_KEY_UP_LINK_COUNTER, &pLoRaDevice->upLinkSlot.UpLinkCounter)
+            || !NvmCounterRestore(NVM_KEY_DOWN_LINK_COUNTER,
+                    &pLoRaDevice->upLinkSlot.DownLinkCounter) ) {
+        LOG_ERROR("Frame counters not restored, the session is not continued.");
+        pLoRaDevice->upLinkSlot.UpLinkCounter = 0;
+        pLoRaDevice->upLinkSlot.DownLinkCounter = 0;
+        return;
+    }
+
+    for ( uint8_t i = 0; i < NVM_NB_CHANNEL_RECORDS; i++ ) {
+        if ( NvmRead(NVM_KEY_CHANNELS + i, &channels, sizeof(channels)) != sizeof(channels) ) {
+            continue;
+        }
+        for ( uint8_t j = 0; j < NVM_CHANNELS_PER_RECORD; j++ ) {
+            id = i * NVM_CHANNELS_PER_RECORD + j;
+            if ( id < LORA_MAX_NB_CHANNELS && channels.Frequency[j] != 0 ) {
+                channel.Frequency = channels.Frequency[j];
+                channel.DrRange.Value = channels.DrRange[j];
+                channel.Band = channels.Band[j];
+                LoRaPhy_SetChannel(id, channel);
             }
-            iterGrp = iterGrp->next;
         }
     }
+    memcpy1((uint8_t*) pLoRaDevice->channelsMask, (uint8_t*) device.ChannelsMask,
+            sizeof(device.ChannelsMask));
+
+    pLoRaDevice->netId = device.NetId;
+    pLoRaDevice->coordinatorAddr = device.CoordinatorAddr;
+    pLoRaDevice->devNonce = device.DevNonce;
+    pLoRaDevice->devRole = (DeviceRole_t) device.DevRole;
+    memcpy1(pLoRaDevice->upLinkSlot.NwkSKey, device.NwkSKey, 16);
+    memcpy1(pLoRaDevice->upLinkSlot.AppSKey, device.AppSKey, 16);
+    LoRaMacCryptoInvalidateKeys(pLoRaDevice->devAddr);
+    LoRaMesh_SetDevAddr(device.DevAddr);
+    pLoRaDevice->ctrlFlags.Bits.nwkJoined = device.Joined;
+
+    RestoreChildNodes();
+    if ( !NvmProcess() ) {
+        LOG_ERROR("Restored session not written.");
+    }
+
+    SessionRestored = true;
+    LOG_TRACE("Session of device 0x%08x restored (up link counter %u).", device.DevAddr,
+            pLoRaDevice->upLinkSlot.UpLinkCounter);
+}
+
+/*!
+ * \brief Restore the child nodes, each one keeps its child node list entry.
+ */
+static void RestoreChildNodes( void )
+{
+    NvmChildNodeRecord_t record;
+    ChildNodeInfo_t *childNode, **iterNode;
+
+    for ( uint16_t i = 0; i < MAX_NOF_CHILD_NODES; i++ ) {
+        if ( NvmRead(NVM_KEY_CHILD_NODES + i, &record, sizeof(record)) != sizeof(record) ) {
+            continue;
+        }
+        childNode = &childNodeList[i];
+
+        /* Take the entry out of the free list */
+        iterNode = &pFreeChildNode;
+        while ( *iterNode != NULL && *iterNode != childNode ) {
+            iterNode = &(*iterNode)->next;
+        }
+        if ( *iterNode == NULL ) {
+            continue;
+        }
+        *iterNode = childNode->next;
+
+        childNode->Connection = record.Connection;
+        childNode->Periodicity = record.Periodicity;
+        /* The last down link counters may not have been written before the reset */
+        childNode->Connection.DownLinkCounter += NVM_COUNTER_GAP;
+        LoRaMacCryptoInvalidateKeys(childNode->Connection.Address);
+        if ( LoRaSession_Add(childNode->Connection.Address, SESSION_TYPE_CHILD_NODE,
+                &childNode->Connection, childNode) == NULL ) {
+            childNode->next = pFreeChildNode;
+            pFreeChildNode = childNode;
+            continue;
+        }
+        childNode->next = pLoRaDevice->childNodes;
+        pLoRaDevice->childNodes = childNode;
+
+        /* Stored with the gap before it is used. LoRaMesh_Init runs before the
+         * scheduler is started, the pending values are written right away */
+        (void) NvmProcess();
+        (void) StoreChildNode(childNode);
+    }
+}
+
+/*!
+ * \brief Store a child node, the key follows from its child node list entry.
+ *
+ * \param childNode Child node to store.
+ * \retval True if the child node has been queued for the NVM.
+ */
+static bool StoreChildNode( ChildNodeInfo_t* childNode )
+{
+    NvmChildNodeRecord_t record;
+
+    record.Connection = childNode->Connection;
+    record.Periodicity = childNode->Periodicity;
+    if ( !NvmWrite(NVM_KEY_CHILD_NODES + (childNode - childNodeList), &record, sizeof(record)) ) {
+        LOG_ERROR("Unable to store child node 0x%08x.", childNode->Connection.Address);
+        return false;
+    }
+    return true;
 }
 
 /*******************************************************************************
@@ -1687,7 +1962,9 @@ void MulticastGroupRemove( MulticastGroupInfo_t *multicastGrp )
  */
 static uint8_t PrintStatus( Shell_ConstStdIO_t *io )
 {
-    byte buf[64];
+    uint8_t nofPoolBuffers, nofUsedBuffers, maxUsedBuffers;
+    uint32_t nofAssessments, nofBusy;
+    byte buf[64], title[16];
 
     Shell_SendStatusStr((unsigned char*) "lora", (unsigned char*) "\r\n", io->stdOut);
     /* Address */
@@ -1720,6 +1997,37 @@ static uint8_t PrintStatus( Shell_ConstStdIO_t *io )
     Shell_SendStatusStr((unsigned char*) "  Mcast Grps", buf, io->stdOut);
     Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
 
+    /* Phy buffer pool usage */
+    nofPoolBuffers = LoRaPhy_GetBufferPoolStats(&nofUsedBuffers, &maxUsedBuffers);
+    custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
+    strcatNum8u(buf, sizeof(buf), nofUsedBuffers);
+    custom_strcat(buf, sizeof(buf), (byte*) "/");
+    strcatNum8u(buf, sizeof(buf), nofPoolBuffers);
+    custom_strcat(buf, sizeof(buf), (byte*) " (max ");
+    strcatNum8u(buf, sizeof(buf), maxUsedBuffers);
+    custom_strcat(buf, sizeof(buf), (byte*) ")");
+    Shell_SendStatusStr((unsigned char*) "  Phy Buffers", buf, io->stdOut);
+    Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+
+    /* Listen before talk busy ratio of the assessed channels */
+    for ( uint8_t i = 0; i < LORA_MAX_NB_CHANNELS; i++ ) {
+        LoRaPhy_GetLbtStats(i, &nofAssessments, &nofBusy);
+        if ( nofAssessments == 0 ) {
+            continue;
+        }
+        custom_strcpy((unsigned char*) title, sizeof("  LBT Ch"), (unsigned char*) "  LBT Ch");
+        strcatNum8u(title, sizeof(title), i);
+        custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
+        strcatNum32u(buf, sizeof(buf), nofBusy);
+        custom_strcat(buf, sizeof(buf), (byte*) "/");
+        strcatNum32u(buf, sizeof(buf), nofAssessments);
+        custom_strcat(buf, sizeof(buf), (byte*) " busy (");
+        strcatNum32u(buf, sizeof(buf), (nofBusy * 100) / nofAssessments);
+        custom_strcat(buf, sizeof(buf), (byte*) "%)");
+        Shell_SendStatusStr(title, buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
     return ERR_OK;
 }
 
@@ -1740,6 +2048,16 @@ static uint8_t PrintHelp( Shell_ConstStdIO_t *io )
             (unsigned char*) "Print child nodes list\r\n", io->stdOut);
     Shell_SendHelpStr((unsigned char*) "  multicastgroups",
             (unsigned char*) "Print multicast groups list\r\n", io->stdOut);
+    Shell_SendHelpStr((unsigned char*) "  stats [reset|dump]",
+            (unsigned char*) "Print, clear or dump (hex) the statistics\r\n", io->stdOut);
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+    Shell_SendHelpStr((unsigned char*) "  routes",
+            (unsigned char*) "Print the routing and the neighbor table\r\n", io->stdOut);
+#endif
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+    Shell_SendHelpStr((unsigned char*) "  latency [reset]",
+            (unsigned char*) "Print or clear the stage latency histograms\r\n", io->stdOut);
+#endif
 
     return ERR_OK;
 }
@@ -1753,13 +2071,14 @@ static uint8_t PrintEventSchedulerList( Shell_ConstStdIO_t *io )
 {
     LoRaSchedulerEvent_t* evt = pEventScheduler;
     byte buf[64];
-    uint8_t i = 0;
+    uint16_t evtSlots;
+    uint16_t i = 0;
 
     Shell_SendStr((unsigned char*) SHELL_DASH_LINE, io->stdOut);
     Shell_SendStr((unsigned char*) "\r\n\tEvent \t\tStart \tEnd\r\n", io->stdOut);
     while ( evt != NULL ) {
         custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
-        strcatNum8u(buf, sizeof(buf), (i + 1));
+        strcatNum16u(buf, sizeof(buf), (i + 1));
         switch ( evt->eventType ) {
             case EVENT_TYPE_UPLINK:
                 custom_strcat(buf, sizeof(buf), (byte*) "\tUplink\t\t");
@@ -1788,6 +2107,15 @@ static uint8_t PrintEventSchedulerList( Shell_ConstStdIO_t *io )
         evt = evt->next;
     }
 
+    /* Slot usage */
+    evtSlots = LoRaSlots_GetNofReserved();
+    custom_strcpy((unsigned char*) buf, sizeof(buf), (unsigned char*) "\r\n\tReserved slots: ");
+    strcatNum16u(buf, sizeof(buf), evtSlots);
+    custom_strcat(buf, sizeof(buf), (byte*) "/");
+    strcatNum16u(buf, sizeof(buf), NOF_AVAILABLE_SLOTS);
+    custom_strcat(buf, sizeof(buf), (byte*) "\r\n");
+    Shell_SendStr((unsigned char*) buf, io->stdOut);
+
     return ERR_OK;
 }
 
@@ -1909,3 +2237,224 @@ static uint8_t PrintMulticastGroups( Shell_ConstStdIO_t *io )
 /*******************************************************************************
  * END OF CODE
  ******************************************************************************/
+
+/*!
+ * \brief Print out the layer counters, the band usage and the link statistics.
+ *
+ * \param io Std io to be used for print out.
+ */
+static uint8_t PrintStats( Shell_ConstStdIO_t *io )
+{
+    /* Same order as the counters in LoRaStats_t */
+    static const char * const counterNames[] = { "  Phy TxFrames", "  Phy TxTimeouts",
+            "  Phy RxFrames", "  Phy RxTimeouts", "  Phy RxErrors", "  Phy QueueFull",
+            "  Phy NoBuffer", "  Mac RxFrames", "  Mac MicFailures", "  Mac UnknownSes",
+            "  Mac Invalid", "  Mac Forwarded", "  Mac RouteDeliv", "  Mac RouteDrop",
+            "  Mac Replays", "  Frm TxFrames", "  Frm RxFrames", "  Frm Malformed",
+            "  Mesh AdvRx", "  Mesh NoSlot", "  Mesh NoEvent", "  Mesh AggrFrames",
+            "  Mesh AggrRecs", "  Mesh AggrDrop", "  App TxFrames", "  App RxFrames",
+            "  App NoPort" };
+    const uint32_t *cntr = (const uint32_t*) &LoRaStats;
+    ChildNodeInfo_t* childNode = pLoRaDevice->childNodes;
+    byte buf[64], title[16];
+    uint8_t i;
+
+    Shell_SendStatusStr((unsigned char*) "lora stats", (unsigned char*) "\r\n", io->stdOut);
+    for ( i = 0; i < (sizeof(counterNames) / sizeof(counterNames[0])); i++ ) {
+        custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
+        strcatNum32u(buf, sizeof(buf), cntr[i]);
+        Shell_SendStatusStr((unsigned char*) counterNames[i], buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
+    /* Band usage */
+    for ( i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
+        custom_strcpy((unsigned char*) title, sizeof("  Band"), (unsigned char*) "  Band");
+        strcatNum8u(title, sizeof(title), i);
+        custom_strcpy((unsigned char*) buf, sizeof("airtime "), (unsigned char*) "airtime ");
+        strcatNum32u(buf, sizeof(buf), LoRaStats.TxAirtime[i]);
+        custom_strcat(buf, sizeof(buf), (byte*) " ms, blocked ");
+        strcatNum32u(buf, sizeof(buf), LoRaStats.BlockedTime[i]);
+        custom_strcat(buf, sizeof(buf), (byte*) " ms");
+        Shell_SendStatusStr(title, buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
+    /* Link quality */
+    PrintLinkStats((unsigned char*) "  Up Link", &LoRaStats.UpLink, io);
+    while ( childNode != NULL ) {
+        custom_strcpy((unsigned char*) title, sizeof("  0x"), (unsigned char*) "  0x");
+        strcatNum32Hex(title, sizeof(title), childNode->Connection.Address);
+        PrintLinkStats(title, &childNode->Link, io);
+        childNode = childNode->next;
+    }
+
+    return ERR_OK;
+}
+
+/*!
+ * \brief Print out the statistics of a link.
+ *
+ * \param title Link name.
+ * \param link Link statistics.
+ * \param io Std io to be used for print out.
+ */
+static void PrintLinkStats( const unsigned char *title, LoRaStats_Link_t *link,
+        Shell_ConstStdIO_t *io )
+{
+    byte buf[64];
+
+    custom_strcpy((unsigned char*) buf, sizeof("rx "), (unsigned char*) "rx ");
+    strcatNum32u(buf, sizeof(buf), link->RxFrames);
+    custom_strcat(buf, sizeof(buf), (byte*) ", lost ");
+    strcatNum32u(buf, sizeof(buf), link->LostFrames);
+    if ( link->RxFrames > 0 ) {
+        custom_strcat(buf, sizeof(buf), (byte*) ", rssi ");
+        strcatNum16s(buf, sizeof(buf), link->LastRssi);
+        custom_strcat(buf, sizeof(buf), (byte*) "/");
+        strcatNum16s(buf, sizeof(buf), link->AvgRssi / 16);
+        custom_strcat(buf, sizeof(buf), (byte*) " dBm, snr ");
+        strcatNum16s(buf, sizeof(buf), link->LastSnr);
+        custom_strcat(buf, sizeof(buf), (byte*) "/");
+        strcatNum16s(buf, sizeof(buf), link->AvgSnr / 16);
+        custom_strcat(buf, sizeof(buf), (byte*) " dB");
+    }
+    Shell_SendStatusStr((unsigned char*) title, buf, io->stdOut);
+    Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+}
+
+/*!
+ * \brief Print out the binary statistics snapshot as hex string.
+ *
+ * \param io Std io to be used for print out.
+ */
+static uint8_t PrintStatsSnapshot( Shell_ConstStdIO_t *io )
+{
+    uint8_t snapshot[LORASTATS_SNAPSHOT_SIZE(MAX_NOF_CHILD_NODES + 1)];
+    size_t i, size;
+    byte buf[2 * 16 + 3];
+
+    size = LoRaStats_GetSnapshot(snapshot, sizeof(snapshot));
+    for ( i = 0; i < size; i++ ) {
+        if ( (i % 16) == 0 ) {
+            custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
+        }
+        strcatNum8Hex(buf, sizeof(buf), snapshot[i]);
+        if ( (i % 16) == 15 || i == (size - 1) ) {
+            custom_strcat(buf, sizeof(buf), (byte*) "\r\n");
+            Shell_SendStr((unsigned char*) buf, io->stdOut);
+        }
+    }
+
+    return ERR_OK;
+}
+
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+/*!
+ * \brief Print out the routes and the neighbor links, ETX with one decimal.
+ *
+ * \param io Std io to be used for print out.
+ */
+static uint8_t PrintRoutes( Shell_ConstStdIO_t *io )
+{
+    const LoRaRoute_Entry_t *route;
+    const LoRaRoute_Neighbor_t *neighbor;
+    uint32_t now = (uint32_t)(TimerGetCurrentTime() * portTICK_PERIOD_MS);
+    uint16_t etx;
+    byte buf[64], title[16];
+    uint8_t i;
+
+    Shell_SendStatusStr((unsigned char*) "lora routes", (unsigned char*) "\r\n", io->stdOut);
+    for ( i = 0; i < LORAMESH_CONFIG_ROUTE_TABLE_SIZE; i++ ) {
+        if ( (route = LoRaRoute_GetEntry(i)) == NULL ) {
+            continue;
+        }
+        custom_strcpy((unsigned char*) title, sizeof("  0x"), (unsigned char*) "  0x");
+        strcatNum32Hex(title, sizeof(title), route->Dest);
+        custom_strcpy((unsigned char*) buf, sizeof("via 0x"), (unsigned char*) "via 0x");
+        strcatNum32Hex(buf, sizeof(buf), route->NextHop);
+        custom_strcat(buf, sizeof(buf), (byte*) ", etx ");
+        strcatNum16u(buf, sizeof(buf), route->Metric / LORAROUTE_ETX_ONE);
+        custom_strcat(buf, sizeof(buf), (byte*) ".");
+        strcatNum8u(buf, sizeof(buf), ((route->Metric % LORAROUTE_ETX_ONE) * 10) / LORAROUTE_ETX_ONE);
+        custom_strcat(buf, sizeof(buf), (byte*) ", age ");
+        strcatNum32u(buf, sizeof(buf), (now - route->Refreshed) / 1000);
+        custom_strcat(buf, sizeof(buf), (byte*) " s");
+        Shell_SendStatusStr((unsigned char*) title, buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
+    Shell_SendStatusStr((unsigned char*) "lora neighbors", (unsigned char*) "\r\n", io->stdOut);
+    for ( i = 0; i < LORAMESH_CONFIG_ROUTE_NOF_NEIGHBORS; i++ ) {
+        if ( (neighbor = LoRaRoute_GetNeighbor(i)) == NULL ) {
+            continue;
+        }
+        etx = LoRaRoute_GetLinkEtx(neighbor->Addr);
+        custom_strcpy((unsigned char*) title, sizeof("  0x"), (unsigned char*) "  0x");
+        strcatNum32Hex(title, sizeof(title), neighbor->Addr);
+        custom_strcpy((unsigned char*) buf, sizeof("snr "), (unsigned char*) "snr ");
+        strcatNum16s(buf, sizeof(buf), neighbor->AvgSnr / 16);
+        custom_strcat(buf, sizeof(buf), (byte*) " dB, ack ");
+        if ( neighbor->AckKnown ) {
+            strcatNum8u(buf, sizeof(buf), ((uint16_t) neighbor->AckRatio * 100) / 0xFF);
+            custom_strcat(buf, sizeof(buf), (byte*) "%");
+        } else {
+            custom_strcat(buf, sizeof(buf), (byte*) "-");
+        }
+        custom_strcat(buf, sizeof(buf), (byte*) ", etx ");
+        strcatNum16u(buf, sizeof(buf), etx / LORAROUTE_ETX_ONE);
+        custom_strcat(buf, sizeof(buf), (byte*) ".");
+        strcatNum8u(buf, sizeof(buf), ((etx % LORAROUTE_ETX_ONE) * 10) / LORAROUTE_ETX_ONE);
+        Shell_SendStatusStr((unsigned char*) title, buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
+    return ERR_OK;
+}
+#endif
+
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+/*!
+ * \brief Print out the latency histograms of the stages, bucket n counts the
+ *        times in [2^(n-1), 2^n) us.
+ *
+ * \param io Std io to be used for print out.
+ */
+static uint8_t PrintLatency( Shell_ConstStdIO_t *io )
+{
+    /* Time from the previous stage to the stage, same order as LoRaLatency_Stage_t */
+    static const char * const stageNames[] = { "  Rx Irq", "  Rx Spi", "  Rx Queue",
+            "  Rx Mic", "  Rx Decrypt", "  Rx App", "  Tx Mesh", "  Tx Encrypt", "  Tx Mic",
+            "  Tx Queue", "  Tx Radio", "  Tx Air", "  Rx Total", "  Tx Total" };
+    LoRaLatency_Hist_t hist;
+    byte buf[96];
+    uint8_t i, j;
+
+    Shell_SendStatusStr((unsigned char*) "lora latency", (unsigned char*) "\r\n", io->stdOut);
+    for ( i = 0; i < (sizeof(stageNames) / sizeof(stageNames[0])); i++ ) {
+        LoRaLatency_GetHist(i, &hist);
+        if ( hist.Count == 0 ) {
+            continue;
+        }
+        custom_strcpy((unsigned char*) buf, sizeof("n "), (unsigned char*) "n ");
+        strcatNum32u(buf, sizeof(buf), hist.Count);
+        custom_strcat(buf, sizeof(buf), (byte*) ", avg ");
+        strcatNum32u(buf, sizeof(buf), hist.Sum / hist.Count);
+        custom_strcat(buf, sizeof(buf), (byte*) " us, max ");
+        strcatNum32u(buf, sizeof(buf), hist.Max);
+        custom_strcat(buf, sizeof(buf), (byte*) " us");
+        Shell_SendStatusStr((unsigned char*) stageNames[i], buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+
+        custom_strcpy((unsigned char*) buf, sizeof(""), (unsigned char*) "");
+        for ( j = 0; j < LORALATENCY_NB_BUCKETS; j++ ) {
+            strcatNum16u(buf, sizeof(buf), hist.Bucket[j]);
+            custom_strcat(buf, sizeof(buf), (byte*) " ");
+        }
+        Shell_SendStatusStr((unsigned char*) "    hist", buf, io->stdOut);
+        Shell_SendStr((unsigned char*) "\r\n", io->stdOut);
+    }
+
+    return ERR_OK;
+}
+#endif
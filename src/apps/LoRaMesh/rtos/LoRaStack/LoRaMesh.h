@@ -13,10 +13,16 @@
 /*******************************************************************************
  * INCLUDE FILES
  ******************************************************************************/
+#include <time.h>
 #include "LoRaMesh-config.h"
 #include "LoRaFrm.h"
 #include "LoRaMac.h"
 #include "LoRaPhy.h"
+#include "LoRaAggr.h"
+#include "LoRaRoute.h"
+#include "LoRaSession.h"
+#include "LoRaLatency.h"
+#include "LoRaStats.h"
 #include "Shell.h"
 
 /*******************************************************************************
@@ -31,12 +37,17 @@
 #define LORAMESH_BUF_IDX_PAYLOAD             (LORAMESH_HEADER_SIZE) /* <app payload> index */
 
 /* Advertising definitions */
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+#define LORAMESH_ADVERTISING_MSG_LENGTH      (0x18)
+#else
 #define LORAMESH_ADVERTISING_MSG_LENGTH      (0x17)
+#endif
 #define LORAMESH_ADVERITSING_DEV_ADR_IDX     (LORAPHY_BUF_IDX_PAYLOAD)
 #define LORAMESH_ADVERITSING_ROLE_RANK_IDX   (LORAPHY_BUF_IDX_PAYLOAD + 4)
 #define LORAMESH_ADVERITSING_LOCATION_IDX    (LORAPHY_BUF_IDX_PAYLOAD + 5)
 #define LORAMESH_ADVERITSING_COORD_ADR_IDX   (LORAPHY_BUF_IDX_PAYLOAD + 13)
 #define LORAMESH_ADVERITSING_SLOT_INFO_IDX   (LORAPHY_BUF_IDX_PAYLOAD + 17)
+#define LORAMESH_ADVERITSING_METRIC_IDX      (LORAPHY_BUF_IDX_PAYLOAD + 23)
 /*******************************************************************************
  * MACRO DEFINITIONS
  ******************************************************************************/
@@ -77,6 +88,7 @@ typedef struct MulticastGroupInfo_s {
 typedef struct ChildNodeInfo_s {
     ConnectionInfo_t Connection;
     uint32_t Periodicity;
+    LoRaStats_Link_t Link;
     struct ChildNodeInfo_s *next;
 } ChildNodeInfo_t;
 
@@ -319,6 +331,22 @@ uint8_t LoRaMesh_RemoveReceptionWindow( uint32_t interval, void (*callback)( voi
 uint8_t LoRaMesh_SendFrame( uint8_t *appPayload, size_t appPayloadSize, uint8_t fPort,
         bool isUpLink, bool isConfirmed );
 
+/*!
+ * Queues an uplink record, the records queued are packed into one frame at
+ * the next uplink slot. Sends the record immediately if aggregation is
+ * disabled.
+ *
+ * \param [IN] appPayload     Record data
+ * \param [IN] appPayloadSize Record size
+ * \param [IN] fPort          Record port (must be > 0)
+ * \param [IN] isConfirmed    Confirmed frame
+ *
+ * \retval status             [0: OK, 1: Port error,
+ *                              3: Queue full or record too large, 7: No network joined]
+ */
+uint8_t LoRaMesh_QueueFrame( uint8_t *appPayload, size_t appPayloadSize, uint8_t fPort,
+        bool isConfirmed );
+
 /*!
  * LoRaMAC layer send multicast
  *
@@ -403,6 +431,9 @@ uint8_t LoRaMesh_LinkCheckReq( void );
 /*!
  * Handles received message on the transport layer.
  *
+ * \remark buf points into the PHY receive buffer and is only valid for the
+ * duration of the call
+ *
  * \param [IN] buf Received frame data buffer
  * \param [IN] payloadSize Received frame payload size
  * \param [IN] fPort Frame port
@@ -456,6 +487,24 @@ ChildNodeInfo_t* LoRaMesh_FindChildNode( uint32_t devAddr );
  */
 MulticastGroupInfo_t* LoRaMesh_FindMulticastGroup( uint32_t grpAddr );
 
+/*!
+ * \brief Stores the session (network IDs, keys, channels and frame counters)
+ *        in the NVM, restored by LoRaMesh_Init after a reset.
+ *
+ * \remark Write-behind, the call does not wait for the memory.
+ */
+void LoRaMesh_StoreSession( void );
+
+/*!
+ * \brief Stores the frame counters of a session after they changed, cheap
+ *        enough to be called for every frame. The counters of the own up link
+ *        are written every NVM_COUNTER_STEP frames, a child node is queued on
+ *        every change. Multicast groups are not stored.
+ *
+ * \param session Session whose counters changed.
+ */
+void LoRaMesh_StoreFrameCounters( LoRaMeshSession_t *session );
+
 /*******************************************************************************
  * SETUP FUNCTION PROTOTYPES (PUBLIC)
  ******************************************************************************/
@@ -476,6 +525,13 @@ MulticastGroupInfo_t* LoRaMesh_FindMulticastGroup( uint32_t grpAddr );
  */
 void LoRaMesh_SetNwkIds( uint32_t netID, uint32_t devAddr, uint8_t *nwkSKey, uint8_t *appSKey );
 
+/*!
+ * Sets the device address and updates the up link session.
+ *
+ * \param [IN] devAddr Device address
+ */
+void LoRaMesh_SetDevAddr( uint32_t devAddr );
+
 /*!
  * Sets the LoRa end devices class
  *
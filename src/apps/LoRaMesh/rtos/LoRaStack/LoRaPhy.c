@@ -13,6 +13,8 @@
 #include "board.h"
 #include "LoRaMesh.h"
 #include "LoRaPhy.h"
+#include "LoRaLbt.h"
+#include "LoRaMacScheduler.h"
 
 #define LOG_LEVEL_ERROR
 #include "debug.h"
@@ -47,6 +49,8 @@
 #define MSG_QUEUE_RX_NOF_ITEMS              (LORAMESH_CONFIG_MSG_QUEUE_RX_LENGTH) /* number of items in the queue */
 #define MSG_QUEUE_TX_NOF_ITEMS              (LORAMESH_CONFIG_MSG_QUEUE_TX_LENGTH) /* number of items in the queue */
 #define MSG_QUEUE_PUT_WAIT                  (LORAMESH_CONFIG_MSG_QUEUE_PUT_BLOCK_TIME_MS) /* blocking time for putting messages into queue */
+#define BUFFER_POOL_NOF_ITEMS               (LORAMESH_CONFIG_PHY_BUFFER_POOL_SIZE) /* number of packet buffers */
+#define BUFFER_INDEX(buf)                   (((buf) - bufferPool[0]) / LORAPHY_BUFFER_SIZE)
 
 #define LORAPHY_TXTYPE_ADVERTISING          (0)
 #define LORAPHY_TXTYPE_REGULAR              (1)
@@ -57,6 +61,16 @@
 #define LORAPHY_RXSLOT_RX2WINDOW            (2)
 #define LORAPHY_RXSLOT_TIME_SYNCHRONIZED    (3)
 
+/* Listen before talk */
+#define LBT_ENABLED                         (LORAMESH_CONFIG_LBT_ENABLED)
+#define LBT_RSSI_THRESHOLD                  (LORAMESH_CONFIG_LBT_RSSI_THRESHOLD)
+/*! A channel activity detection lasts a few symbols, give up waiting for CadDone after this time */
+#define LBT_CAD_TIMEOUT                     (100 / portTICK_PERIOD_MS)
+
+/*! Converts a time on air [us] to RTOS ticks, rounded up */
+#define US_TO_TICKS(us)                     (((us) + (1000 * portTICK_PERIOD_MS) - 1) \
+                                                / (1000 * portTICK_PERIOD_MS))
+
 /*******************************************************************************
  * PRIVATE TYPE DEFINITIONS
  ******************************************************************************/
@@ -76,7 +90,8 @@ typedef union {
          *   2: Rx2
          *   3: Synch Rx
          */
-        uint8_t reserved :2;
+        uint8_t CadDone :1; /* 1: Channel activity detection done */
+        uint8_t ChannelBusy :1; /* 1: Channel activity detected */
     } Bits;
 } LoRaPhy_Flags_t;
 
@@ -101,8 +116,17 @@ static LoRaPhy_Flags_t phyFlags;
 /* Incoming packet descriptor */
 static LoRaPhy_PacketDesc rxPacket;
 
-/* Incoming packet buffer */
-static uint8_t rxPacketBuffer[LORAPHY_BUFFER_SIZE];
+/*! Packet buffer pool, the message queues only carry buffer pointers */
+static uint8_t bufferPool[BUFFER_POOL_NOF_ITEMS][LORAPHY_BUFFER_SIZE];
+static uint8_t bufferRefCount[BUFFER_POOL_NOF_ITEMS];
+static LoRaPhy_LastConnection_t bufferLink[BUFFER_POOL_NOF_ITEMS]; /* RSSI and SNR of received frames */
+static uint8_t bufferChannel[BUFFER_POOL_NOF_ITEMS]; /* Channel index of frames to be sent */
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+static LoRaLatency_Trace_t bufferTrace[BUFFER_POOL_NOF_ITEMS]; /* Latency trace of the frame */
+static LoRaLatency_Trace_t txAirTrace; /* Latency trace of the frame on air */
+#endif
+static uint8_t bufferPoolUsed;
+static uint8_t bufferPoolHighWaterMark;
 
 /*! LoRaPhy reception windows delay from end of Tx */
 static uint32_t ReceiveDelay1;
@@ -121,8 +145,9 @@ static uint32_t MaxRxWindow;
 /*! Agregated duty cycle management */
 static uint16_t MaxDCycle = 0;
 static uint16_t AggregatedDCycle = 0;
-static TimerTime_t AggregatedLastTxDoneTime = 0;
-static TimerTime_t AggregatedTimeOff = 0;
+
+/*! Earliest time a deferred frame may be sent [ticks] */
+static TimerTime_t NextTxTime = 0;
 
 /*! LoRaPhy bands */
 static LoRaPhy_Band_t Bands[LORA_MAX_NB_BANDS] = { BAND0, BAND1, BAND2, BAND3, BAND4, };
@@ -134,6 +159,17 @@ static LoRaPhy_ChannelParams_t Channels[LORA_MAX_NB_CHANNELS] = { LC1, LC2, LC3,
 /*! Last transmission time on air */
 static TimerTime_t TxTimeOnAir = 0;
 
+/*! Frame waiting for the end of the channel activity detection */
+static uint8_t *CadTxBuf = NULL;
+static TimerTime_t CadStartTime;
+
+/*! Channel access of the current frame */
+static LoRaLbt_t Lbt;
+
+/*! Listen before talk statistics per channel */
+static uint32_t LbtAssessments[LORA_MAX_NB_CHANNELS];
+static uint32_t LbtBusy[LORA_MAX_NB_CHANNELS];
+
 /*! LoRaPhy reception window timers */
 static TimerEvent_t RxWindow1Timer;
 static TimerEvent_t RxWindow2Timer;
@@ -145,18 +181,28 @@ static TimerEvent_t RxWindow2Timer;
 static void HandleStateMachine( void );
 
 /*! \brief Retrieves outgoing message from tx queue */
-static uint8_t GetTxMsg( uint8_t *buf, size_t bufSize );
+static uint8_t* GetTxMsg( void );
 
 /*! \brief Retrieves incoming message from rx queue */
-static uint8_t GetRxMsg( uint8_t *buf, size_t bufSize );
+static uint8_t* GetRxMsg( void );
 
 /*! \brief Adds an element to rx or tx queue */
-static uint8_t QueuePut( uint8_t *buf, size_t bufSize, size_t payloadSize, bool fromISR, bool isTx,
-        bool toBack, uint8_t flags );
+static uint8_t QueuePut( uint8_t *buf, size_t payloadSize, bool fromISR, bool isTx, bool toBack,
+        uint8_t flags );
+
+/*! \brief Copy a message into a pool buffer and queue it. */
+static uint8_t QueueCopy( uint8_t *buf, size_t bufSize, size_t payloadSize, bool isTx,
+        bool toBack, uint8_t channel, uint8_t flags );
 
 /*! \brief Check if tx queue contains any messages and send them if so */
 static uint8_t CheckTx( void );
 
+/*! \brief Hands a frame over to the radio */
+static uint8_t SendFrame( uint8_t *txBuf );
+
+/*! \brief Puts a frame back and defers it by the backoff */
+static void LbtBackoff( uint8_t *txBuf, uint32_t backoff );
+
 /*! \brief Sets up and opens a reception window with the specified settings */
 static void OpenReceptionWindow( uint32_t freq, int8_t datarate, uint32_t bandwidth,
         uint16_t timeout, bool rxContinuous );
@@ -194,7 +240,7 @@ static void OnRxWindow2TimerEvent( TimerHandle_t xTimer );
 void LoRaPhy_Init( void )
 {
     /* Initialize structures */
-    msgRxQueue = xQueueCreate(MSG_QUEUE_RX_NOF_ITEMS, LORAPHY_BUFFER_SIZE);
+    msgRxQueue = xQueueCreate(MSG_QUEUE_RX_NOF_ITEMS, sizeof(uint8_t*));
     if ( msgRxQueue == NULL ) { /* queue creation failed! */
         LOG_ERROR("Could not create Rx queue at %s line %d", __FILE__,
         __LINE__);
@@ -203,7 +249,7 @@ void LoRaPhy_Init( void )
     }
     vQueueAddToRegistry(msgRxQueue, "RadioRxMsg");
 
-    msgTxQueue = xQueueCreate(MSG_QUEUE_TX_NOF_ITEMS, LORAPHY_BUFFER_SIZE);
+    msgTxQueue = xQueueCreate(MSG_QUEUE_TX_NOF_ITEMS, sizeof(uint8_t*));
     if ( msgTxQueue == NULL ) { /* queue creation failed! */
         LOG_ERROR("Could not create Rx queue at %s line %d", __FILE__,
         __LINE__);
@@ -233,8 +279,7 @@ void LoRaPhy_Init( void )
     /* Initialize duty cycle variables */
     MaxDCycle = 0;
     AggregatedDCycle = 1;
-    AggregatedLastTxDoneTime = 0;
-    AggregatedTimeOff = 0;
+    NextTxTime = 0;
 
     /* Reception window parameters */
     Rx1DrOffset = 0;
@@ -244,18 +289,45 @@ void LoRaPhy_Init( void )
     /* Default channels mask */
     pLoRaDevice->channelsMask[0] = LC(1) + LC(2) + LC(3);
 
-    /* init Rx descriptor */
-    rxPacket.phyData = &rxPacketBuffer[0];
-    rxPacket.phySize = sizeof(rxPacketBuffer);
-    rxPacket.rxtx = LORAPHY_BUF_PAYLOAD_START(rxPacket.phyData); /* we transmit the size too */
+    /* Initialize the channel scheduler */
+    LoRaMacSchedulerInit(pLoRaDevice->dbgFlags.Bits.dutyCycleCtrlOff == 0);
+    for ( uint8_t i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
+        LoRaMacSchedulerSetBand(i, Bands[i].DCycle);
+    }
+    for ( uint8_t i = 0; i < LORA_MAX_NB_CHANNELS; i++ ) {
+        LoRaMacSchedulerSetChannel(i, Channels[i].Band, Channels[i].DrRange.Fields.Min,
+                Channels[i].DrRange.Fields.Max, Channels[i].Frequency != 0);
+    }
+    LoRaMacSchedulerSetAggregatedDutyCycle(AggregatedDCycle);
+    LoRaMacSchedulerSetChannelsMask(pLoRaDevice->channelsMask);
+
+    /* Initialize listen before talk */
+    CadTxBuf = NULL;
+    LoRaLbt_Reset(&Lbt);
+    for ( uint8_t i = 0; i < LORA_MAX_NB_CHANNELS; i++ ) {
+        LbtAssessments[i] = 0;
+        LbtBusy[i] = 0;
+    }
+
+    /* Init buffer pool */
+    for ( uint8_t i = 0; i < BUFFER_POOL_NOF_ITEMS; i++ ) {
+        bufferRefCount[i] = 0;
+    }
+    bufferPoolUsed = 0;
+    bufferPoolHighWaterMark = 0;
+
+    /* init Rx descriptor, points to the pool buffer of the processed message */
+    rxPacket.phyData = NULL;
+    rxPacket.phySize = LORAPHY_BUFFER_SIZE;
+    rxPacket.rxtx = NULL;
 
     /*
      * Initialize Timers
      */
     /* RX1 delay timer & config */
-    TimerInit(&RxWindow1Timer, "RxWindow1Timer", (void*) NULL, OnRxWindow1TimerEvent, false);
+    TimerInitPrecise(&RxWindow1Timer, "RxWindow1Timer", (void*) NULL, OnRxWindow1TimerEvent, false);
     /* RX2 delay timer & config */
-    TimerInit(&RxWindow2Timer, "RxWindow2Timer", (void*) NULL, OnRxWindow2TimerEvent, false);
+    TimerInitPrecise(&RxWindow2Timer, "RxWindow2Timer", (void*) NULL, OnRxWindow2TimerEvent, false);
 
     /* Initialize Radio driver */
     radioEvents.CadDone = OnCadDone;
@@ -269,33 +341,123 @@ void LoRaPhy_Init( void )
 
 uint8_t LoRaPhy_Process( void )
 {
-    uint8_t result;
+    uint8_t *rxBuf;
 
     HandleStateMachine(); /* process state machine */
     /* process rx message */
-    result = GetRxMsg(rxPacket.phyData, rxPacket.phySize);
-    if ( result == ERR_OK ) {
-        /* Handle incoming packet */
+    rxBuf = GetRxMsg();
+    if ( rxBuf != NULL ) {
+        /* Handle incoming packet in place, the buffer is passed up the stack */
+        rxPacket.phyData = rxBuf;
+        rxPacket.rxtx = LORAPHY_BUF_PAYLOAD_START(rxBuf);
+        rxPacket.rssi = bufferLink[BUFFER_INDEX(rxBuf)].Rssi;
+        rxPacket.snr = bufferLink[BUFFER_INDEX(rxBuf)].Snr;
+        LORALATENCY_SET_RX(&bufferTrace[BUFFER_INDEX(rxBuf)]);
+        LORALATENCY_RX(LATENCY_STAGE_RX_PHY);
         if ( LoRaPhy_OnPacketRx(&rxPacket) == ERR_OK ) {
             /* Packet handled */
         }
+        LORALATENCY_SET_RX(NULL);
+        rxPacket.phyData = NULL;
+        rxPacket.rxtx = NULL;
+        LoRaPhy_ReleaseBuffer(rxBuf);
     }
     return ERR_OK;
 }
 
-uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t flags )
+uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t channel,
+        uint8_t flags )
+{
+    if ( channel >= LORA_MAX_NB_CHANNELS ) {
+        return ERR_RANGE;
+    }
+    if ( LoRaPhy_IsPoolBuffer(buf) ) {
+        LoRaPhy_RetainBuffer(buf);
+        bufferChannel[BUFFER_INDEX(buf)] = channel;
+        LORALATENCY_TAKE_TX(&bufferTrace[BUFFER_INDEX(buf)], LATENCY_STAGE_TX_QUEUE);
+        return QueuePut(buf, payloadSize, false, true, true, flags);
+    }
+    return QueueCopy(buf, bufSize, payloadSize, true, true, channel, flags);
+}
+
+uint8_t* LoRaPhy_AllocBuffer( void )
+{
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint8_t *buf = NULL;
+
+    for ( uint8_t i = 0; i < BUFFER_POOL_NOF_ITEMS; i++ ) {
+        if ( bufferRefCount[i] == 0 ) {
+            bufferRefCount[i] = 1;
+            if ( ++bufferPoolUsed > bufferPoolHighWaterMark ) {
+                bufferPoolHighWaterMark = bufferPoolUsed;
+            }
+            buf = bufferPool[i];
+            break;
+        }
+    }
+    if ( buf == NULL ) {
+        LORASTATS_INC(Phy, NoBuffer);
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    return buf;
+}
+
+void LoRaPhy_RetainBuffer( uint8_t *buf )
 {
-    return QueuePut(buf, bufSize, payloadSize, false, true, true, flags);
+    UBaseType_t uxSavedInterruptStatus;
+
+    if ( !LoRaPhy_IsPoolBuffer(buf) ) return;
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    bufferRefCount[(buf - bufferPool[0]) / LORAPHY_BUFFER_SIZE]++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+}
+
+void LoRaPhy_ReleaseBuffer( uint8_t *buf )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    uint8_t *refCount;
+
+    if ( !LoRaPhy_IsPoolBuffer(buf) ) return;
+
+    refCount = &bufferRefCount[(buf - bufferPool[0]) / LORAPHY_BUFFER_SIZE];
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    if ( *refCount > 0 && --(*refCount) == 0 ) {
+        bufferPoolUsed--;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+}
+
+bool LoRaPhy_IsPoolBuffer( uint8_t *buf )
+{
+    return (buf >= bufferPool[0] && buf < bufferPool[BUFFER_POOL_NOF_ITEMS]
+            && ((buf - bufferPool[0]) % LORAPHY_BUFFER_SIZE) == 0);
+}
+
+uint8_t LoRaPhy_GetBufferPoolStats( uint8_t *nofUsed, uint8_t *highWaterMark )
+{
+    *nofUsed = bufferPoolUsed;
+    *highWaterMark = bufferPoolHighWaterMark;
+    return BUFFER_POOL_NOF_ITEMS;
+}
+
+void LoRaPhy_GetLbtStats( uint8_t channel, uint32_t *nofAssessments, uint32_t *nofBusy )
+{
+    if ( channel >= LORA_MAX_NB_CHANNELS ) {
+        *nofAssessments = 0;
+        *nofBusy = 0;
+        return;
+    }
+    *nofAssessments = LbtAssessments[channel];
+    *nofBusy = LbtBusy[channel];
 }
 
 uint8_t LoRaPhy_OnPacketRx( LoRaPhy_PacketDesc *packet )
 {
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("%s - Size %d", __FUNCTION__, LORAPHY_BUF_SIZE(packet->phyData));
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < (LORAPHY_BUF_SIZE(packet->phyData) + 2); i++ )
-    LOG_TRACE_BARE("0x%02x ", packet->phyData[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(packet->phyData, LORAPHY_BUF_SIZE(packet->phyData) + 2);
 #endif
 
     return LoRaMac_OnPacketRx(packet); /* Pass message up the stack */
@@ -358,6 +520,8 @@ void LoRaPhy_SetChannel( uint8_t id, LoRaPhy_ChannelParams_t params )
         Channels[id].Frequency = 0;
         Channels[id].DrRange.Value = 0;
     }
+    LoRaMacSchedulerSetChannel(id, Channels[id].Band, Channels[id].DrRange.Fields.Min,
+            Channels[id].DrRange.Fields.Max, Channels[id].Frequency != 0);
 
     // Check if it is a valid channel
     if ( Channels[id].Frequency == 0 ) {
@@ -417,6 +581,7 @@ void LoRaPhy_SetMaxDutyCycle( uint8_t maxDCycle )
     if ( maxDCycle >= 0 && maxDCycle < 16 ) {
         MaxDCycle = maxDCycle;
         AggregatedDCycle = 1 << maxDCycle;
+        LoRaMacSchedulerSetAggregatedDutyCycle(AggregatedDCycle);
     }
 }
 
@@ -479,7 +644,7 @@ uint8_t LoRaPhy_TestSetContinuousRx( uint32_t freq, uint8_t dr )
 
 uint8_t LoRaPhy_QueueRxMessage( uint8_t *payload, size_t payloadSize, bool toBack, uint8_t flags )
 {
-    return QueuePut(payload, LORAPHY_BUFFER_SIZE, payloadSize, false, false, toBack, flags);
+    return QueueCopy(payload, LORAPHY_BUFFER_SIZE, payloadSize, false, toBack, 0, flags);
 }
 
 uint8_t LoRaPhy_TestSendFrame( uint8_t *buf, size_t bufSize )
@@ -528,6 +693,7 @@ uint8_t LoRaPhy_TestOpenRxWindow( uint8_t ch, uint8_t datarate )
  */
 static void HandleStateMachine()
 {
+    uint32_t backoff;
     uint8_t result;
 
     for ( ;; ) {
@@ -560,6 +726,27 @@ static void HandleStateMachine()
                 }
                 return;
             }
+            case PHY_CAD:
+                if ( phyFlags.Bits.CadDone == 1 ) {
+                    phyFlags.Bits.CadDone = 0;
+                    if ( phyFlags.Bits.ChannelBusy == 1 && LoRaLbt_OnBusy(&Lbt, &backoff) ) {
+                        LbtBackoff(CadTxBuf, backoff);
+                        CadTxBuf = NULL;
+                        LOG_TRACE("Channel busy. Radio idle.");
+                        phyStatus = PHY_IDLE;
+                        return;
+                    }
+                } else if ( (TimerGetCurrentTime() - CadStartTime) < LBT_CAD_TIMEOUT ) {
+                    return; /* Channel activity detection running */
+                } else {
+                    LOG_ERROR("Channel activity detection timeout.");
+                    Radio.Sleep();
+                }
+                (void) SendFrame(CadTxBuf);
+                CadTxBuf = NULL;
+                LOG_TRACE("Radio wait tx done.");
+                phyStatus = PHY_WAIT_FOR_TXDONE;
+                break;
             case PHY_WAIT_FOR_TXDONE:
                 if ( phyFlags.Bits.TxDone == 1 ) {
                     phyFlags.Bits.TxDone = 0;
@@ -601,52 +788,48 @@ static void HandleStateMachine()
 /*!
  * \brief Retrieve outgoing message from tx queue.
  *
- * \param buf Pointer to the buffer to which the message will be copied.
- * \param bufSize Size of the target buffer.
+ * \retval uint8_t* Pool buffer of the message (to be released by the caller)
+ *         or NULL if the queue is empty.
  */
-static uint8_t GetTxMsg( uint8_t *buf, size_t bufSize )
+static uint8_t* GetTxMsg( void )
 {
-    if ( bufSize < LORAPHY_BUFFER_SIZE ) {
-        return ERR_OVERFLOW; /* not enough space in buffer */
-    }
-    if ( xQueueReceive(msgTxQueue, buf, 0) == pdPASS ) {
+    uint8_t *buf;
+
+    if ( xQueueReceive(msgTxQueue, &buf, 0) == pdPASS ) {
         /* received message from queue */
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
         LOG_TRACE("LoRaPhy %s - Size %d", __FUNCTION__, LORAPHY_BUF_SIZE(buf));
-        LOG_TRACE_BARE("\t");
-        for ( uint8_t i = 0; i < (LORAPHY_BUF_SIZE(buf) + 2); i++ )
-        LOG_TRACE_BARE("0x%02x ", buf[i]);
-        LOG_TRACE_BARE("\r\n");
+        LOG_TRACE_HEX(buf, LORAPHY_BUF_SIZE(buf) + 2);
 #endif
-        return ERR_OK;
+        return buf;
     }
-    return ERR_RXEMPTY;
+    return NULL;
 }
 
 /*!
  * \brief Retrieve incoming message from rx queue.
  *
- * \param buf Pointer to the buffer to which the message will be copied.
- * \param bufSize Size of the target buffer.
+ * \retval uint8_t* Pool buffer of the message (to be released by the caller)
+ *         or NULL if the queue is empty.
  */
-static uint8_t GetRxMsg( uint8_t *buf, size_t bufSize )
+static uint8_t* GetRxMsg( void )
 {
-    /* first byte in the queue is the size of the item */
-    if ( bufSize < LORAPHY_BUFFER_SIZE ) {
-        return ERR_OVERFLOW; /* not enough space in buffer */
-    }
-    if ( xQueueReceive(msgRxQueue, buf, 0) == pdPASS ) { /* immediately returns if queue is empty */
+    uint8_t *buf;
+
+    if ( xQueueReceive(msgRxQueue, &buf, 0) == pdPASS ) { /* immediately returns if queue is empty */
         /* received message from queue */
-        return ERR_OK;
+        return buf;
     }
-    return ERR_RXEMPTY;
+    return NULL;
 }
 
 /*!
- * \brief Queues a message to be sent to the radio transceiver.
+ * \brief Queues a pool buffer to the tx or rx message queue.
  *
- * \param buf Pointer to the message data to be sent.
- * \param bufSize Size of buffer.
+ * \remark The queue takes over one reference of the buffer. The reference is
+ *         dropped if the buffer could not be queued.
+ *
+ * \param buf Pool buffer with the message.
  * \param payloadSize Size of payload data.
  * \param fromISR If called from an ISR routine.
  * \param isTx If message is TX or RX.
@@ -654,18 +837,14 @@ static uint8_t GetRxMsg( uint8_t *buf, size_t bufSize )
  *
  * \return Error code, ERR_OK if message has been queued.
  */
-static uint8_t QueuePut( uint8_t *buf, size_t bufSize, size_t payloadSize, bool fromISR, bool isTx,
-        bool toBack, uint8_t flags )
+static uint8_t QueuePut( uint8_t *buf, size_t payloadSize, bool fromISR, bool isTx, bool toBack,
+        uint8_t flags )
 {
-    /* data format is: dataSize(8bit) data */
+    /* data format is: flags(8bit) dataSize(8bit) data */
     uint8_t res = ERR_OK;
     xQueueHandle queue;
     BaseType_t qRes;
 
-    if ( bufSize != LORAPHY_BUFFER_SIZE ) {
-        return ERR_OVERFLOW; /* must be exactly this buffer size!!! */
-    }
-
     if ( isTx ) {
         queue = msgTxQueue;
     } else {
@@ -677,10 +856,7 @@ static uint8_t QueuePut( uint8_t *buf, size_t bufSize, size_t payloadSize, bool
 
 #if(LORAMESH_DEBUG_OUTPUT_PAYLOAD == 1)
     LOG_TRACE("LoRaPhy %s - Size %d", __FUNCTION__, payloadSize);
-    LOG_TRACE_BARE("\t");
-    for ( uint8_t i = 0; i < (payloadSize + 2); i++ )
-    LOG_TRACE_BARE("0x%02x ", buf[i]);
-    LOG_TRACE_BARE("\r\n");
+    LOG_TRACE_HEX(buf, payloadSize + 2);
 #endif
 
     if ( fromISR ) {
@@ -688,9 +864,9 @@ static uint8_t QueuePut( uint8_t *buf, size_t bufSize, size_t payloadSize, bool
         pxHigherPriorityTaskWoken;
 
         if ( toBack ) {
-            qRes = xQueueSendToBackFromISR(queue, buf, &pxHigherPriorityTaskWoken);
+            qRes = xQueueSendToBackFromISR(queue, &buf, &pxHigherPriorityTaskWoken);
         } else {
-            qRes = xQueueSendToFrontFromISR(queue, buf, &pxHigherPriorityTaskWoken);
+            qRes = xQueueSendToFrontFromISR(queue, &buf, &pxHigherPriorityTaskWoken);
         }
         if ( qRes != pdTRUE ) {
             /* was not able to send to the queue. Well, not much we can do here... */
@@ -698,21 +874,60 @@ static uint8_t QueuePut( uint8_t *buf, size_t bufSize, size_t payloadSize, bool
         }
     } else {
         if ( toBack ) {
-            qRes = xQueueSendToBack(queue, buf, MSG_QUEUE_PUT_WAIT);
+            qRes = xQueueSendToBack(queue, &buf, MSG_QUEUE_PUT_WAIT);
         } else {
-            qRes = xQueueSendToFront(queue, buf, MSG_QUEUE_PUT_WAIT);
+            qRes = xQueueSendToFront(queue, &buf, MSG_QUEUE_PUT_WAIT);
         }
         if ( qRes != pdTRUE ) {
             res = ERR_BUSY;
         }
     }
+    if ( res != ERR_OK ) {
+        LORASTATS_INC(Phy, QueueFull);
+        LoRaPhy_ReleaseBuffer(buf);
+    }
     return res;
 }
 
+/*!
+ * \brief Copies a message into a pool buffer and queues it.
+ *
+ * \param buf Pointer to the message data.
+ * \param bufSize Size of buffer.
+ * \param payloadSize Size of payload data.
+ * \param isTx If message is TX or RX.
+ * \param toBack Queue at the back or the front.
+ * \param channel Channel index of a tx message, ignored for rx messages.
+ * \param flags Packet flags.
+ *
+ * \return Error code, ERR_OK if message has been queued.
+ */
+static uint8_t QueueCopy( uint8_t *buf, size_t bufSize, size_t payloadSize, bool isTx,
+        bool toBack, uint8_t channel, uint8_t flags )
+{
+    uint8_t *poolBuf;
+
+    if ( bufSize != LORAPHY_BUFFER_SIZE || payloadSize > LORAPHY_PAYLOAD_SIZE ) {
+        return ERR_OVERFLOW; /* must be exactly this buffer size!!! */
+    }
+    if ( (poolBuf = LoRaPhy_AllocBuffer()) == NULL ) {
+        return ERR_NOTAVAIL;
+    }
+    memcpy1(LORAPHY_BUF_PAYLOAD_START(poolBuf), LORAPHY_BUF_PAYLOAD_START(buf), payloadSize);
+    if ( isTx ) {
+        bufferChannel[BUFFER_INDEX(poolBuf)] = channel;
+        LORALATENCY_TAKE_TX(&bufferTrace[BUFFER_INDEX(poolBuf)], LATENCY_STAGE_TX_QUEUE);
+    }
+
+    return QueuePut(poolBuf, payloadSize, false, isTx, toBack, flags);
+}
+
 /*!
  * Check tx message queue to see if any messages are pending.
  *
  * \retvalue    ERR_OK          Transmission started successfully.
+ *              ERR_BUSY        Band or channel not available yet, the message stays queued,
+ *                              or channel activity detection started (PHY_CAD).
  *              ERR_NOTAVAIL    No channel available.
  *              ERR_VALUE       Invalid tx type selected.
  *              ERR_DISABLED    Device was remotely disable (MaxDCycle setting).
@@ -722,15 +937,27 @@ static uint8_t CheckTx( void )
 {
     LoRaPhy_ChannelParams_t channel;
     uint8_t flags;
-    uint8_t TxDataBuffer[LORAPHY_BUFFER_SIZE];
+    uint8_t *txBuf;
+    TimerTime_t curTime, timeOff;
 
-    if ( GetTxMsg(TxDataBuffer, sizeof(TxDataBuffer)) == ERR_OK ) {
+    curTime = TimerGetCurrentTime();
+    if ( curTime < NextTxTime ) {
+        return ERR_BUSY; /* deferred frame, nothing can be sent before NextTxTime */
+    }
+
+    if ( (txBuf = GetTxMsg()) != NULL ) {
 #if 0
-        if ( SetNextChannel() != ERR_OK ) {
-            return ERR_NOTAVAIL;
+        uint8_t result;
+
+        if ( (result = SetNextChannel()) != ERR_OK ) {
+            (void) QueuePut(txBuf, LORAPHY_BUF_SIZE(txBuf), false, true, false,
+                    LORAPHY_BUF_FLAGS(txBuf));
+            return result;
         }
 #endif
-        flags = LORAPHY_BUF_FLAGS(TxDataBuffer);
+        flags = LORAPHY_BUF_FLAGS(txBuf);
+        /* Channel the frame was queued for, the reception windows follow on it */
+        pLoRaDevice->currChannelIndex = bufferChannel[BUFFER_INDEX(txBuf)];
         channel = Channels[pLoRaDevice->currChannelIndex];
 
         if ( flags & LORAPHY_PACKET_FLAGS_JOIN_REQ ) {
@@ -742,65 +969,126 @@ static uint8_t CheckTx( void )
         }
 
         Radio.SetChannel(channel.Frequency);
-        Radio.SetMaxPayloadLength(MODEM_LORA, LORAPHY_BUF_SIZE(TxDataBuffer));
+        Radio.SetMaxPayloadLength(MODEM_LORA, LORAPHY_BUF_SIZE(txBuf));
 
         if ( pLoRaDevice->currDataRateIndex == DR_7 ) {   // High Speed FSK channel
             Radio.SetTxConfig(MODEM_FSK, TxPowers[pLoRaDevice->currTxPowerIndex], 25e3, 0,
                     Datarates[pLoRaDevice->currDataRateIndex] * 1e3, 0, 5, false, true, 0, 0, false,
                     TX_TIMEOUT);
-            TxTimeOnAir = Radio.TimeOnAir(MODEM_FSK, LORAPHY_BUF_SIZE(TxDataBuffer));
+            TxTimeOnAir = Radio.TimeOnAir(MODEM_FSK, LORAPHY_BUF_SIZE(txBuf));
         } else if ( pLoRaDevice->currDataRateIndex == DR_6 ) {   // High speed LoRa channel
             Radio.SetTxConfig(MODEM_LORA, TxPowers[pLoRaDevice->currTxPowerIndex], 0, 1,
                     Datarates[pLoRaDevice->currDataRateIndex], 1, 8, false, true, 0, 0, false,
                     TX_TIMEOUT);
-            TxTimeOnAir = Radio.TimeOnAir(MODEM_LORA, LORAPHY_BUF_SIZE(TxDataBuffer));
+            TxTimeOnAir = Radio.TimeOnAir(MODEM_LORA, LORAPHY_BUF_SIZE(txBuf));
         } else {   // Normal LoRa channel
             Radio.SetTxConfig(MODEM_LORA, TxPowers[pLoRaDevice->currTxPowerIndex], 0, 0,
                     Datarates[pLoRaDevice->currDataRateIndex], 1, 8, false, true, 0, 0, false,
                     TX_TIMEOUT);
-            TxTimeOnAir = Radio.TimeOnAir(MODEM_LORA, LORAPHY_BUF_SIZE(TxDataBuffer));
+            TxTimeOnAir = Radio.TimeOnAir(MODEM_LORA, LORAPHY_BUF_SIZE(txBuf));
         }
 
         if ( MaxDCycle == 255 ) {
+            LoRaPhy_ReleaseBuffer(txBuf);
             return ERR_DISABLED;
         }
-        if ( MaxDCycle == 0 ) {
-            AggregatedTimeOff = 0;
-        }
 
-        if ( MAX(Bands[channel.Band].TimeOff, AggregatedTimeOff) > (TimerGetCurrentTime()) ) {
-            // Schedule transmission
-            LOG_TRACE("Send in %d ticks on channel %d (DR: %u).",
-                    MAX(Bands[channel.Band].TimeOff, AggregatedTimeOff), channel.Frequency,
-                    pLoRaDevice->currDataRateIndex);
-            vTaskDelay(
-                    MAX(Bands[channel.Band].TimeOff, AggregatedTimeOff)
-                            / MAX(Bands[channel.Band].TimeOff, AggregatedTimeOff));
-        } else {
-            // Send now
-            LOG_TRACE("Sending at %u ms on channel %d (DR: %u).",
-                    (uint32_t)(TimerGetCurrentTime() * portTICK_PERIOD_MS), channel.Frequency,
-                    pLoRaDevice->currDataRateIndex);
-            Radio.Send(LORAPHY_BUF_PAYLOAD_START(TxDataBuffer), LORAPHY_BUF_SIZE(TxDataBuffer));
-//            LOG_DEBUG("Send data on channel with frequency %u Hz", channel.Frequency);
+        timeOff = LoRaMacSchedulerGetBandTimeOff(channel.Band, curTime);
+        if ( timeOff > 0 ) {
+            /* Band not free yet, put the message back and retry at the exact instant */
+            NextTxTime = curTime + timeOff;
+            LORASTATS_ADD(BlockedTime[channel.Band], (uint32_t) timeOff * portTICK_PERIOD_MS);
+            LOG_TRACE("Send in %u ticks on channel %u (DR: %u).", (uint32_t) timeOff,
+                    channel.Frequency, pLoRaDevice->currDataRateIndex);
+            (void) QueuePut(txBuf, LORAPHY_BUF_SIZE(txBuf), false, true, false, flags);
+            return ERR_BUSY;
         }
-
-        if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_ADVERTISING ) {
-            phyFlags.Bits.TxType = LORAPHY_TXTYPE_ADVERTISING;
-        } else if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_REGULAR ) {
-            phyFlags.Bits.TxType = LORAPHY_TXTYPE_REGULAR;
-        } else if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK)
-                == LORAPHY_PACKET_FLAGS_FRM_MULTICAST ) {
-            phyFlags.Bits.TxType = LORAPHY_TXTYPE_MULTICAST;
-        } else {
-            return ERR_VALUE;
+#if (LBT_ENABLED == 1)
+        if ( LoRaLbt_Assess(&Lbt) ) {
+            uint32_t backoff;
+
+            LbtAssessments[pLoRaDevice->currChannelIndex]++;
+            if ( pLoRaDevice->currDataRateIndex == DR_7 ) {
+                /* No channel activity detection for FSK, the RSSI check only takes 1 ms */
+                if ( !Radio.IsChannelFree(MODEM_FSK, channel.Frequency, LBT_RSSI_THRESHOLD) ) {
+                    LbtBusy[pLoRaDevice->currChannelIndex]++;
+                    if ( LoRaLbt_OnBusy(&Lbt, &backoff) ) {
+                        LbtBackoff(txBuf, backoff);
+                        return ERR_BUSY;
+                    }
+                }
+            } else {
+                /* The frame is sent from PHY_CAD once the channel is found free */
+                CadTxBuf = txBuf;
+                CadStartTime = curTime;
+                phyFlags.Bits.CadDone = 0;
+                phyStatus = PHY_CAD;
+                Radio.StartCad();
+                return ERR_BUSY;
+            }
         }
-
-        return ERR_OK;
+#endif
+        // Send now
+        return SendFrame(txBuf);
     }
     return ERR_NOTAVAIL; /* no data to send? */
 }
 
+/*!
+ * \brief Hands a frame over to the radio configured by CheckTx.
+ *
+ * \param txBuf Pool buffer of the frame, released once in the radio FIFO.
+ *
+ * \retvalue    ERR_OK          Transmission started successfully.
+ *              ERR_VALUE       Invalid tx type selected.
+ */
+static uint8_t SendFrame( uint8_t *txBuf )
+{
+    uint8_t flags = LORAPHY_BUF_FLAGS(txBuf);
+    uint8_t result = ERR_OK;
+
+    LOG_TRACE("Sending at %u ms on channel %d (DR: %u).",
+            (uint32_t)(TimerGetCurrentTime() * portTICK_PERIOD_MS),
+            Channels[pLoRaDevice->currChannelIndex].Frequency, pLoRaDevice->currDataRateIndex);
+    LORALATENCY_STAMP(&bufferTrace[BUFFER_INDEX(txBuf)], LATENCY_STAGE_TX_PHY);
+    Radio.Send(LORAPHY_BUF_PAYLOAD_START(txBuf), LORAPHY_BUF_SIZE(txBuf));
+    LORALATENCY_STAMP(&bufferTrace[BUFFER_INDEX(txBuf)], LATENCY_STAGE_TX_RADIO);
+#if(LORAMESH_CONFIG_LATENCY_ENABLED == 1)
+    txAirTrace = bufferTrace[BUFFER_INDEX(txBuf)];
+#endif
+    LoRaLbt_Reset(&Lbt);
+
+    if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_ADVERTISING ) {
+        phyFlags.Bits.TxType = LORAPHY_TXTYPE_ADVERTISING;
+    } else if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_REGULAR ) {
+        phyFlags.Bits.TxType = LORAPHY_TXTYPE_REGULAR;
+    } else if ( (flags & LORAPHY_PACKET_FLAGS_FRM_MASK) == LORAPHY_PACKET_FLAGS_FRM_MULTICAST ) {
+        phyFlags.Bits.TxType = LORAPHY_TXTYPE_MULTICAST;
+    } else {
+        result = ERR_VALUE;
+    }
+
+    /* The radio FIFO holds the frame now */
+    LoRaPhy_ReleaseBuffer(txBuf);
+    return result;
+}
+
+/*!
+ * \brief Puts a frame back at the front of the tx queue and defers it by the
+ *        backoff of LoRaLbt_OnBusy. The band time off is checked again before
+ *        the retry.
+ *
+ * \param txBuf Pool buffer of the frame.
+ * \param backoff Backoff [ms].
+ */
+static void LbtBackoff( uint8_t *txBuf, uint32_t backoff )
+{
+    NextTxTime = TimerGetCurrentTime() + (backoff / portTICK_PERIOD_MS);
+    LOG_TRACE("Channel busy, retry in %u ticks.",
+            (uint32_t)(NextTxTime - TimerGetCurrentTime()));
+    (void) QueuePut(txBuf, LORAPHY_BUF_SIZE(txBuf), false, true, false, LORAPHY_BUF_FLAGS(txBuf));
+}
+
 /*!
  * Open up a reception window with specified settings.
  *
@@ -849,64 +1137,22 @@ static void OpenReceptionWindow( uint32_t freq, int8_t datarate, uint32_t bandwi
  */
 static uint8_t SetNextChannel( void )
 {
-    uint8_t i = 0;
-    uint8_t j = 0;
-    uint8_t k = 0;
-    uint8_t nbEnabledChannels = 0;
-    uint8_t enabledChannels[LORA_MAX_NB_CHANNELS];
     TimerTime_t curTime = TimerGetCurrentTime();
-
-    memset1(enabledChannels, 0, LORA_MAX_NB_CHANNELS);
-
-// Update Aggregated duty cycle
-    if ( AggregatedTimeOff < (curTime - AggregatedLastTxDoneTime) ) {
-        AggregatedTimeOff = 0;
-    }
-
-// Update bands Time OFF
-    TimerTime_t minTime = (TimerTime_t)(-1);
-    for ( i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
-        if ( pLoRaDevice->dbgFlags.Bits.dutyCycleCtrlOff == 0 ) {
-            if ( Bands[i].TimeOff < (curTime - Bands[i].LastTxDoneTime) ) {
-                Bands[i].TimeOff = 0;
-            }
-            if ( Bands[i].TimeOff != 0 ) {
-                minTime = MIN(Bands[i].TimeOff, minTime);
-            }
-        } else {
-            minTime = 0;
-            Bands[i].TimeOff = 0;
-        }
-    }
-
-// Search how many channels are enabled
-    for ( i = 0, k = 0; i < LORA_MAX_NB_CHANNELS; i += 16, k++ ) {
-        for ( j = 0; j < 16; j++ ) {
-            if ( (pLoRaDevice->channelsMask[k] & (1 << j)) != 0 ) {
-                if ( Channels[i + j].Frequency == 0 ) {   // Check if the channel is enabled
-                    continue;
-                }
-                if ( ((Channels[i + j].DrRange.Fields.Min <= pLoRaDevice->currChannelIndex)
-                        && (pLoRaDevice->currDataRateIndex <= Channels[i + j].DrRange.Fields.Max))
-                        == false ) {   // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if ( Bands[Channels[i + j].Band].TimeOff > 0 ) {   // Check if the band is available for transmission
-                    continue;
-                }
-                if ( AggregatedTimeOff > 0 ) {   // Check if there is time available for transmission
-                    continue;
-                }
-                enabledChannels[nbEnabledChannels++] = i + j;
-            }
-        }
-    }
-    if ( nbEnabledChannels > 0 ) {
-        pLoRaDevice->currChannelIndex = enabledChannels[randr(0, nbEnabledChannels - 1)];
-        return 0;
+    TimerTime_t waitTime;
+
+    /* Apply the channels mask changes done by the upper layers */
+    LoRaMacSchedulerSetChannelsMask(pLoRaDevice->channelsMask);
+
+    switch ( LoRaMacSchedulerNextChannel(pLoRaDevice->currDataRateIndex, curTime,
+            &pLoRaDevice->currChannelIndex, &waitTime) ) {
+        case LORAMAC_SCHEDULER_OK:
+            return ERR_OK;
+        case LORAMAC_SCHEDULER_WAIT:
+            NextTxTime = curTime + waitTime;
+            return ERR_BUSY;
+        default:
+            return ERR_NOTAVAIL;
     }
-
-    return ERR_OK;
 }
 
 static void OnRadioTxDone( void )
@@ -915,17 +1161,13 @@ static void OnRadioTxDone( void )
 
     LOG_TRACE("Transmitted successfully (%u ms).", (uint32_t)(curTime * portTICK_PERIOD_MS));
 
-// Update Band Time OFF
-    Bands[Channels[pLoRaDevice->currChannelIndex].Band].LastTxDoneTime = curTime;
-    if ( pLoRaDevice->dbgFlags.Bits.dutyCycleCtrlOff == 0 ) {
-        Bands[Channels[pLoRaDevice->currChannelIndex].Band].TimeOff = TxTimeOnAir
-                * Bands[Channels[pLoRaDevice->currChannelIndex].Band].DCycle - TxTimeOnAir;
-    } else {
-        Bands[Channels[pLoRaDevice->currChannelIndex].Band].TimeOff = 0;
-    }
-// Update Agregated Time OFF
-    AggregatedLastTxDoneTime = curTime;
-    AggregatedTimeOff = AggregatedTimeOff + (TxTimeOnAir * AggregatedDCycle - TxTimeOnAir);
+    LORALATENCY_STAMP(&txAirTrace, LATENCY_STAGE_TX_DONE);
+    LORASTATS_INC(Phy, TxFrames);
+    LORASTATS_ADD(TxAirtime[Channels[pLoRaDevice->currChannelIndex].Band], TxTimeOnAir / 1000);
+
+// Update Band and Agregated Time OFF
+    LoRaMacSchedulerTxDone(Channels[pLoRaDevice->currChannelIndex].Band, curTime,
+            US_TO_TICKS(TxTimeOnAir));
 
     if ( phyFlags.Bits.TxType == LORAPHY_TXTYPE_ADVERTISING ) {
         /* Open advertising beacon reception window */
@@ -948,17 +1190,25 @@ static void OnRadioTxDone( void )
 
 static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
 {
-    LoRaPhy_PacketDesc packet;
+    uint8_t *rxBuf = payload;
 
     LOG_DEBUG("Received %u bytes.", size);
 
-    packet.flags = LORAPHY_PACKET_FLAGS_NONE;
-    packet.phyData = payload;
-    packet.rxtx = LORAPHY_BUF_PAYLOAD_START(packet.phyData);
-    packet.phySize = LORAPHY_BUFFER_SIZE;
+    if ( !LoRaPhy_IsPoolBuffer(rxBuf) ) {
+        /* Frame was not read into a pool buffer (FSK), payload starts at index 0 */
+        if ( size > LORAPHY_PAYLOAD_SIZE || (rxBuf = LoRaPhy_AllocBuffer()) == NULL ) {
+            LOG_ERROR("No buffer for received frame.");
+            return;
+        }
+        memcpy1(LORAPHY_BUF_PAYLOAD_START(rxBuf), payload, size);
+    }
+    bufferLink[BUFFER_INDEX(rxBuf)].Rssi = rssi;
+    bufferLink[BUFFER_INDEX(rxBuf)].Snr = snr;
+    LORALATENCY_START_RX(&bufferTrace[BUFFER_INDEX(rxBuf)]);
 
-    if ( QueuePut(packet.phyData, packet.phySize, size, true, false, true, packet.flags)
-            == ERR_OK ) {
+    /* Ownership of the pool buffer passes to the rx queue */
+    if ( QueuePut(rxBuf, size, true, false, true, LORAPHY_PACKET_FLAGS_NONE) == ERR_OK ) {
+        LORASTATS_INC(Phy, RxFrames);
         phyFlags.Bits.RxDone = 1;
     } else {
         LOG_ERROR("Failed to put received frame to queue.");
@@ -967,19 +1217,18 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
 
 static void OnCadDone( bool channelActivityDetected )
 {
-#if defined(LOG_LEVEL_TRACE)
-    uint64_t curTime = TimerGetCurrentTime();
-#endif
     Radio.Sleep();
-    if ( !channelActivityDetected ) {
-        LOG_TRACE("Channel clear. Send packet now (%d%d)", *(((int*) (&curTime)) + 1), curTime);
-//        Radio.Send(LoRaMacBuffer, LoRaMacBufferPktLen);
+    if ( channelActivityDetected ) {
+        LbtBusy[pLoRaDevice->currChannelIndex]++;
     }
+    phyFlags.Bits.ChannelBusy = channelActivityDetected ? 1 : 0;
+    phyFlags.Bits.CadDone = 1;
 }
 
 static void OnRadioTxTimeout( void )
 {
     LOG_ERROR("Tx timeout occurred.");
+    LORASTATS_INC(Phy, TxTimeouts);
 
     phyStatus = PHY_TIMEOUT;
     phyFlags.Bits.TxDone = 0;
@@ -998,6 +1247,7 @@ static void OnRadioRxTimeout( void )
         LOG_TRACE("Time synchronized reception window timeout occurred.");
     }
 #endif
+    LORASTATS_INC(Phy, RxTimeouts);
 
     phyStatus = PHY_TIMEOUT;
     phyFlags.Bits.RxDone = 0;
@@ -1006,6 +1256,7 @@ static void OnRadioRxTimeout( void )
 static void OnRadioRxError( void )
 {
     LOG_ERROR("Rx error occurred (Slot %d).", phyFlags.Bits.RxSlot);
+    LORASTATS_INC(Phy, RxErrors);
 
     if ( pLoRaDevice->devClass != CLASS_C ) {
         Radio.Sleep();
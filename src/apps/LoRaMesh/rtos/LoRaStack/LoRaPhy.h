@@ -43,6 +43,8 @@
 #define LORAPHY_PACKET_FLAGS_FRM_ADVERTISING    (2<<0)  /*!< advertising received */
 #define LORAPHY_PACKET_FLAGS_JOIN_REQ           (1<<3)  /*!< join request message */
 #define LORAPHY_PACKET_FLAGS_ACK_REQ            (1<<4)  /*!< acknowledge requested */
+#define LORAPHY_PACKET_FLAGS_ROUTED             (1<<5)  /*!< frame unwrapped from a routed frame */
+#define LORAPHY_PACKET_FLAGS_DECRYPTED          (1<<6)  /*!< FRMPayload decrypted in place with the MIC check */
 
 #define LORAPHY_PACKET_FLAGS_FRM_MASK           (0x3)
 
@@ -60,6 +62,7 @@ typedef enum {
     PHY_INITIAL_STATE,
     PHY_POWER_DOWN,
     PHY_IDLE,
+    PHY_CAD,
     PHY_WAIT_FOR_TXDONE,
     PHY_RECEIVING,
     PHY_ADVERTISING,
@@ -129,6 +132,8 @@ typedef struct {
     uint8_t *phyData; /*!< pointer to the PHY data buffer */
     size_t phySize; /*!< size of PHY data buffer */
     uint8_t *rxtx; /*!< pointer into phyData, start of TX/RX data */
+    int16_t rssi; /*!< RSSI of a received packet [dBm] */
+    int8_t snr; /*!< SNR of a received packet [dB] */
 } LoRaPhy_PacketDesc;
 
 /*******************************************************************************
@@ -139,6 +144,55 @@ typedef struct {
  */
 void LoRaPhy_Init( void );
 
+/*!
+ * Allocates a packet buffer of LORAPHY_BUFFER_SIZE bytes from the buffer pool.
+ *
+ * \remark Interrupt safe. The buffer is returned with a reference count of one.
+ *
+ * \retval uint8_t* Pointer to the buffer or NULL if the pool is exhausted.
+ */
+uint8_t* LoRaPhy_AllocBuffer( void );
+
+/*!
+ * Takes an additional reference on a pool buffer.
+ *
+ * \param buf Pointer to a buffer returned by LoRaPhy_AllocBuffer.
+ */
+void LoRaPhy_RetainBuffer( uint8_t *buf );
+
+/*!
+ * Drops a reference on a pool buffer, the buffer is freed with the last one.
+ *
+ * \param buf Pointer to a buffer returned by LoRaPhy_AllocBuffer.
+ */
+void LoRaPhy_ReleaseBuffer( uint8_t *buf );
+
+/*!
+ * Checks if a buffer belongs to the buffer pool.
+ *
+ * \param buf Pointer to the buffer.
+ * \retval bool True if it is a pool buffer.
+ */
+bool LoRaPhy_IsPoolBuffer( uint8_t *buf );
+
+/*!
+ * Returns the buffer pool usage.
+ *
+ * \param nofUsed Number of buffers currently in use.
+ * \param highWaterMark Maximum number of buffers used at the same time.
+ * \retval uint8_t Total number of pool buffers.
+ */
+uint8_t LoRaPhy_GetBufferPoolStats( uint8_t *nofUsed, uint8_t *highWaterMark );
+
+/*!
+ * Returns the listen before talk statistics of a channel.
+ *
+ * \param channel Channel index.
+ * \param nofAssessments Number of channel assessments.
+ * \param nofBusy Number of assessments that found the channel busy.
+ */
+void LoRaPhy_GetLbtStats( uint8_t channel, uint32_t *nofAssessments, uint32_t *nofBusy );
+
 /*!
  * LoRa physical layer process.
  */
@@ -154,12 +208,19 @@ uint8_t LoRaPhy_OnPacketRx( LoRaPhy_PacketDesc *packet );
 
 /*!
  * \brief Puts a packet into the queue to be sent.
+ *
+ * \remark Pool buffers are queued without copying, the queue takes its own
+ *         reference. Other buffers are copied into a pool buffer.
+ *
  * \param buf Pointer to the packet buffer.
  * \param bufSize Size of the payload buffer.
  * \param payloadSize Size of payload data.
- * \return Error code, ERR_OK for everything fine.
+ * \param channel Index of the channel the packet is sent on.
+ * \param flags Packet flags, see LORAPHY_PACKET_FLAGS_XXXX.
+ * \return Error code, ERR_OK for everything fine, ERR_RANGE for an invalid channel.
  */
-uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t flags );
+uint8_t LoRaPhy_PutPayload( uint8_t *buf, size_t bufSize, size_t payloadSize, uint8_t channel,
+        uint8_t flags );
 
 /*!
  *
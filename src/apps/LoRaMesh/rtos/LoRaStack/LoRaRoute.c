@@ -0,0 +1,355 @@
+/**
+ * \file LoRaRoute.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh multi-hop routing table
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMesh.h"
+#include "LoRaRoute.h"
+
+#define LOG_LEVEL_TRACE
+#include "debug.h"
+
+#if(LORAMESH_CONFIG_ROUTING_ENABLED == 1)
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define TABLE_SIZE                          LORAMESH_CONFIG_ROUTE_TABLE_SIZE
+#define NOF_NEIGHBORS                       LORAMESH_CONFIG_ROUTE_NOF_NEIGHBORS
+
+/*! Weight of a new sample in the neighbor averages (1/AVG_WEIGHT) */
+#define AVG_WEIGHT                          LORAMESH_CONFIG_STATS_LINK_AVG_WEIGHT
+
+/*! Delivery ratio [1/256] at the lower and the upper end of the SNR margin */
+#define DELIVERY_MIN                        (26)
+#define DELIVERY_MAX                        (256)
+
+/*! SNR margin [1/16 dB] over the demodulation floor of DELIVERY_MIN and DELIVERY_MAX */
+#define MARGIN_MIN                          (-40)
+#define MARGIN_MAX                          (160)
+
+/*! Link ETX of a neighbor nothing has been received from yet */
+#define LINK_ETX_UNKNOWN                    (3 * LORAROUTE_ETX_ONE)
+
+/*! Current time [ms], the timer counts RTOS ticks on the target and us on the host */
+#if defined(FSL_RTOS_FREE_RTOS) || defined(USE_FREE_RTOS)
+#define NOW()                               ((uint32_t)(TimerGetCurrentTime() * portTICK_PERIOD_MS))
+#else
+#define NOW()                               ((uint32_t)(TimerGetCurrentTime() / 1000))
+#endif
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static LoRaRoute_Entry_t RouteTable[TABLE_SIZE];
+static LoRaRoute_Neighbor_t Neighbors[NOF_NEIGHBORS];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Inserts or updates the route to dest */
+static void UpdateRoute( uint32_t dest, uint32_t nextHop, uint16_t metric );
+
+/*! \brief Returns true if the route has not been refreshed in time */
+static bool IsExpired( const LoRaRoute_Entry_t *entry, uint32_t now );
+
+/*! \brief Returns the neighbor, allocates it if create is true */
+static LoRaRoute_Neighbor_t *FindNeighbor( uint32_t addr, bool create );
+
+/*! \brief Returns the delivery ratio [1/256] at an SNR [1/16 dB] */
+static uint16_t SnrToDelivery( int16_t snr );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaRoute_Init( void )
+{
+    memset1((uint8_t*) RouteTable, 0U, sizeof(RouteTable));
+    memset1((uint8_t*) Neighbors, 0U, sizeof(Neighbors));
+}
+
+void LoRaRoute_OnAdvertising( uint8_t *aPayload, uint8_t aPayloadSize, int8_t snr )
+{
+    const LoRaRoute_Entry_t *route;
+    uint32_t addr, coordAddr;
+    uint16_t linkEtx, metric;
+    uint8_t advMetric;
+
+    if ( aPayloadSize < LORAMESH_ADVERTISING_MSG_LENGTH ) {
+        /* Beacon of a node without routing */
+        return;
+    }
+
+    addr = (uint32_t) aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX];
+    addr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX + 1] << 8);
+    addr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX + 2] << 16);
+    addr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_DEV_ADR_IDX + 3] << 24);
+    coordAddr = (uint32_t) aPayload[LORAMESH_ADVERITSING_COORD_ADR_IDX];
+    coordAddr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_COORD_ADR_IDX + 1] << 8);
+    coordAddr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_COORD_ADR_IDX + 2] << 16);
+    coordAddr |= ((uint32_t) aPayload[LORAMESH_ADVERITSING_COORD_ADR_IDX + 3] << 24);
+    advMetric = aPayload[LORAMESH_ADVERITSING_METRIC_IDX];
+
+    if ( addr == 0 || addr == pLoRaDevice->devAddr ) {
+        return;
+    }
+
+    LoRaRoute_OnFrame(addr, snr, false);
+    linkEtx = LoRaRoute_GetLinkEtx(addr);
+    UpdateRoute(addr, addr, linkEtx);
+
+    if ( advMetric == LORAROUTE_ADV_METRIC_NONE || coordAddr == 0
+            || coordAddr == pLoRaDevice->devAddr || coordAddr == addr ) {
+        return;
+    }
+    metric = (uint16_t) advMetric * LORAROUTE_ADV_METRIC_UNIT;
+    route = LoRaRoute_Lookup(coordAddr);
+    if ( route != NULL && route->NextHop != addr && metric >= route->Metric ) {
+        /* Neighbor is not closer to the coordinator, it may route over this
+         * node itself */
+        return;
+    }
+    UpdateRoute(coordAddr, addr, metric + linkEtx);
+}
+
+void LoRaRoute_OnFrame( uint32_t linkAddr, int8_t snr, bool isAck )
+{
+    LoRaRoute_Neighbor_t *neighbor;
+
+    if ( (neighbor = FindNeighbor(linkAddr, true)) == NULL ) {
+        return;
+    }
+
+    if ( neighbor->LastSeen == 0 ) {
+        /* First frame, start the average at the sample */
+        neighbor->AvgSnr = snr * 16;
+    } else {
+        neighbor->AvgSnr += ((snr * 16) - neighbor->AvgSnr) / AVG_WEIGHT;
+    }
+    neighbor->LastSeen = NOW() | 1;
+
+    if ( isAck && neighbor->AckPending ) {
+        neighbor->AckPending = 0;
+        neighbor->AckRatio += (0xFF - neighbor->AckRatio + AVG_WEIGHT - 1) / AVG_WEIGHT;
+    }
+}
+
+void LoRaRoute_OnConfirmedTx( uint32_t linkAddr )
+{
+    /* Called from the sending task, only the ACK state of a known neighbor
+     * changes, the tables themselves are updated by the stack task only */
+    LoRaRoute_Neighbor_t *neighbor = FindNeighbor(linkAddr, false);
+
+    if ( neighbor == NULL ) {
+        return;
+    }
+    if ( !neighbor->AckKnown ) {
+        neighbor->AckKnown = 1;
+        neighbor->AckRatio = 0xFF;
+    } else if ( neighbor->AckPending ) {
+        /* Former confirmed frame has not been acknowledged */
+        neighbor->AckRatio -= neighbor->AckRatio / AVG_WEIGHT;
+    }
+    neighbor->AckPending = 1;
+}
+
+void LoRaRoute_Learn( uint32_t dest, uint32_t nextHop, uint8_t hops )
+{
+    uint16_t metric;
+
+    if ( dest == pLoRaDevice->devAddr || dest == nextHop || hops < 2 ) {
+        return;
+    }
+    /* The metric beyond the next hop is not known, count it with the hops */
+    metric = LoRaRoute_GetLinkEtx(nextHop) + (uint16_t)(hops - 1) * LORAROUTE_ETX_ONE;
+    UpdateRoute(dest, nextHop, metric);
+}
+
+const LoRaRoute_Entry_t *LoRaRoute_Lookup( uint32_t dest )
+{
+    uint32_t now = NOW();
+    uint8_t i;
+
+    if ( dest == 0 ) {
+        return NULL;
+    }
+    for ( i = 0; i < TABLE_SIZE; i++ ) {
+        if ( RouteTable[i].Dest == dest ) {
+            return IsExpired(&RouteTable[i], now) ? NULL : &RouteTable[i];
+        }
+    }
+    return NULL;
+}
+
+uint8_t LoRaRoute_GetAdvertisedMetric( void )
+{
+    const LoRaRoute_Entry_t *route;
+    uint16_t linkEtx;
+    uint32_t metric;
+
+    if ( pLoRaDevice->coordinatorAddr == pLoRaDevice->devAddr ) {
+        return 0;
+    }
+    if ( pLoRaDevice->coordinatorAddr == 0
+            || (route = LoRaRoute_Lookup(pLoRaDevice->coordinatorAddr)) == NULL ) {
+        return LORAROUTE_ADV_METRIC_NONE;
+    }
+    /* The own uplinks go over the parent, whatever neighbor the route to the
+     * coordinator uses. Beacons do not tell which neighbor is the parent, the
+     * path beyond it is taken from the route, the first hop from the link of
+     * the own session. */
+    linkEtx = LoRaRoute_GetLinkEtx(route->NextHop);
+    metric = (route->Metric > linkEtx) ? (route->Metric - linkEtx) : 0;
+    metric += LoRaRoute_GetLinkEtx(pLoRaDevice->devAddr);
+    metric = (metric + LORAROUTE_ADV_METRIC_UNIT - 1) / LORAROUTE_ADV_METRIC_UNIT;
+
+    return (metric >= LORAROUTE_ADV_METRIC_NONE) ? (LORAROUTE_ADV_METRIC_NONE - 1) : metric;
+}
+
+uint16_t LoRaRoute_GetLinkEtx( uint32_t addr )
+{
+    LoRaRoute_Neighbor_t *neighbor = FindNeighbor(addr, false);
+    uint32_t dr, df;
+
+    if ( neighbor == NULL || neighbor->LastSeen == 0 ) {
+        return LINK_ETX_UNKNOWN;
+    }
+
+    /* Reverse delivery ratio from the SNR, forward from the ACK history,
+     * assumed symmetric as long as no confirmed frame has been sent */
+    dr = SnrToDelivery(neighbor->AvgSnr);
+    if ( neighbor->AckKnown ) {
+        df = (uint32_t) neighbor->AckRatio + 1;
+        if ( df < DELIVERY_MIN ) {
+            df = DELIVERY_MIN;
+        }
+    } else {
+        df = dr;
+    }
+
+    return (uint16_t)(((uint32_t) LORAROUTE_ETX_ONE * DELIVERY_MAX * DELIVERY_MAX) / (df * dr));
+}
+
+const LoRaRoute_Entry_t *LoRaRoute_GetEntry( uint8_t index )
+{
+    if ( index >= TABLE_SIZE || RouteTable[index].Dest == 0
+            || IsExpired(&RouteTable[index], NOW()) ) {
+        return NULL;
+    }
+    return &RouteTable[index];
+}
+
+const LoRaRoute_Neighbor_t *LoRaRoute_GetNeighbor( uint8_t index )
+{
+    if ( index >= NOF_NEIGHBORS || Neighbors[index].Addr == 0 ) {
+        return NULL;
+    }
+    return &Neighbors[index];
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void UpdateRoute( uint32_t dest, uint32_t nextHop, uint16_t metric )
+{
+    LoRaRoute_Entry_t *entry = NULL, *worst = NULL;
+    uint32_t now = NOW();
+    uint8_t i;
+
+    for ( i = 0; i < TABLE_SIZE; i++ ) {
+        if ( RouteTable[i].Dest == dest ) {
+            entry = &RouteTable[i];
+            break;
+        }
+        if ( RouteTable[i].Dest == 0 || IsExpired(&RouteTable[i], now) ) {
+            if ( entry == NULL ) {
+                entry = &RouteTable[i];
+            }
+        } else if ( worst == NULL || RouteTable[i].Metric > worst->Metric ) {
+            worst = &RouteTable[i];
+        }
+    }
+
+    if ( entry != NULL && entry->Dest == dest ) {
+        /* Keep the next hop unless the new one is clearly better */
+        if ( entry->NextHop != nextHop && !IsExpired(entry, now)
+                && (uint32_t) metric + LORAMESH_CONFIG_ROUTE_HYSTERESIS >= entry->Metric ) {
+            return;
+        }
+    } else if ( entry == NULL ) {
+        /* Table full, replace the worst route if the new one is better */
+        if ( worst == NULL || metric >= worst->Metric ) {
+            return;
+        }
+        entry = worst;
+    }
+
+    if ( entry->Dest != dest || entry->NextHop != nextHop ) {
+        LOG_TRACE("Route to 0x%08x via 0x%08x (ETX %u/16).", dest, nextHop, metric);
+    }
+    entry->Dest = dest;
+    entry->NextHop = nextHop;
+    entry->Metric = metric;
+    entry->Refreshed = now;
+}
+
+static bool IsExpired( const LoRaRoute_Entry_t *entry, uint32_t now )
+{
+    return ((now - entry->Refreshed) > LORAMESH_CONFIG_ROUTE_TIMEOUT);
+}
+
+static LoRaRoute_Neighbor_t *FindNeighbor( uint32_t addr, bool create )
+{
+    LoRaRoute_Neighbor_t *neighbor = NULL;
+    uint8_t i;
+
+    if ( addr == 0 ) {
+        return NULL;
+    }
+    for ( i = 0; i < NOF_NEIGHBORS; i++ ) {
+        if ( Neighbors[i].Addr == addr ) {
+            return &Neighbors[i];
+        }
+        /* Free slot, otherwise the least recently heard neighbor */
+        if ( neighbor == NULL || Neighbors[i].LastSeen < neighbor->LastSeen ) {
+            neighbor = &Neighbors[i];
+        }
+    }
+    if ( !create ) {
+        return NULL;
+    }
+
+    memset1((uint8_t*) neighbor, 0U, sizeof(LoRaRoute_Neighbor_t));
+    neighbor->Addr = addr;
+
+    return neighbor;
+}
+
+static uint16_t SnrToDelivery( int16_t snr )
+{
+    int16_t sf = Datarates[pLoRaDevice->currDataRateIndex], margin;
+
+    if ( sf < 7 || sf > 12 ) {
+        /* SF7 at 250 kHz and FSK */
+        sf = 7;
+    }
+    /* Demodulation floor -7.5 dB at SF7, 2.5 dB lower per spreading factor */
+    margin = snr + 120 + 40 * (sf - 7);
+
+    if ( margin <= MARGIN_MIN ) {
+        return DELIVERY_MIN;
+    } else if ( margin >= MARGIN_MAX ) {
+        return DELIVERY_MAX;
+    }
+    return DELIVERY_MIN
+            + ((int32_t)(margin - MARGIN_MIN) * (DELIVERY_MAX - DELIVERY_MIN))
+                    / (MARGIN_MAX - MARGIN_MIN);
+}
+#endif /* LORAMESH_CONFIG_ROUTING_ENABLED */
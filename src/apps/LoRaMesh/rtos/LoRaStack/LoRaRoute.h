@@ -0,0 +1,143 @@
+/**
+ * \file LoRaRoute.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh multi-hop routing table
+ *
+ * The routing table holds one route per destination, the next hop and the
+ * path metric. Routes to the coordinator are learned from the advertising
+ * beacons, every beacon carries the path metric of the sender. Routes to
+ * nodes behind a child node are learned from the frames forwarded by it.
+ * Routes not refreshed within LORAMESH_CONFIG_ROUTE_TIMEOUT expire.
+ *
+ * The metric is the expected transmission count (ETX) in 1/16, the sum of
+ * the link ETX along the path. The link ETX is 1 / (df * dr), dr estimated
+ * from the SNR margin of the received frames over the demodulation floor of
+ * the current spreading factor, df from the ACK history of the confirmed
+ * frames sent over the link (dr as long as no confirmed frame has been sent).
+ * The link to the parent is the one of the own session, its neighbor entry
+ * carries the own address.
+ */
+
+#ifndef __LORAROUTE_H_
+#define __LORAROUTE_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! ETX of a perfect link */
+#define LORAROUTE_ETX_ONE                       (16)
+
+/*! No route, advertised path metric of a node without route */
+#define LORAROUTE_METRIC_NONE                   (0xFFFF)
+#define LORAROUTE_ADV_METRIC_NONE               (0xFF)
+
+/*! Advertised path metric unit [1/16 ETX] */
+#define LORAROUTE_ADV_METRIC_UNIT               (4)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Route */
+typedef struct LoRaRoute_Entry_s {
+    uint32_t Dest; /* 0 if unused */
+    uint32_t NextHop;
+    uint16_t Metric; /* Path ETX [1/16] */
+    uint32_t Refreshed; /* ms */
+} LoRaRoute_Entry_t;
+
+/*! Neighbor link */
+typedef struct LoRaRoute_Neighbor_s {
+    uint32_t Addr; /* 0 if unused, the own address for the parent */
+    int16_t AvgSnr; /* 1/16 dB */
+    uint8_t AckRatio; /* Acknowledged confirmed frames [1/255] */
+    uint8_t AckKnown :1; /* 1: A confirmed frame has been sent */
+    uint8_t AckPending :1; /* 1: Last confirmed frame not acknowledged yet */
+    uint32_t LastSeen; /* ms */
+} LoRaRoute_Neighbor_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears the routing and the neighbor table.
+ */
+void LoRaRoute_Init( void );
+
+/*!
+ * \brief Updates the neighbor and the route to its coordinator with a
+ *        received advertising beacon.
+ *
+ * \param aPayload Beacon PHY buffer.
+ * \param aPayloadSize Beacon size.
+ * \param snr Beacon SNR [dB].
+ */
+void LoRaRoute_OnAdvertising( uint8_t *aPayload, uint8_t aPayloadSize, int8_t snr );
+
+/*!
+ * \brief Accounts an authenticated frame to a link.
+ *
+ * \param linkAddr Device address of the frame, the own address for frames of
+ *        the parent.
+ * \param snr Frame SNR [dB].
+ * \param isAck True if the frame acknowledges a confirmed frame.
+ */
+void LoRaRoute_OnFrame( uint32_t linkAddr, int8_t snr, bool isAck );
+
+/*!
+ * \brief Accounts a confirmed frame sent over a link, an unacknowledged
+ *        former one counts as lost.
+ *
+ * \param linkAddr Device address of the frame.
+ */
+void LoRaRoute_OnConfirmedTx( uint32_t linkAddr );
+
+/*!
+ * \brief Learns the route to the origin of a frame forwarded by a child node.
+ *
+ * \param dest Origin of the frame.
+ * \param nextHop Child node the frame has been received from.
+ * \param hops Hops the frame has travelled from the origin, at least 2.
+ */
+void LoRaRoute_Learn( uint32_t dest, uint32_t nextHop, uint8_t hops );
+
+/*!
+ * \brief Returns the route to a destination.
+ *
+ * \retval Route, NULL if there is no valid route.
+ */
+const LoRaRoute_Entry_t *LoRaRoute_Lookup( uint32_t dest );
+
+/*!
+ * \brief Returns the path metric to the coordinator for the beacon.
+ *
+ * \retval Metric in LORAROUTE_ADV_METRIC_UNIT, LORAROUTE_ADV_METRIC_NONE if
+ *         there is no route.
+ */
+uint8_t LoRaRoute_GetAdvertisedMetric( void );
+
+/*!
+ * \brief Returns the ETX of the link to a neighbor [1/16].
+ */
+uint16_t LoRaRoute_GetLinkEtx( uint32_t addr );
+
+/*!
+ * \brief Returns a routing table entry, NULL if unused or expired.
+ */
+const LoRaRoute_Entry_t *LoRaRoute_GetEntry( uint8_t index );
+
+/*!
+ * \brief Returns a neighbor table entry, NULL if unused.
+ */
+const LoRaRoute_Neighbor_t *LoRaRoute_GetNeighbor( uint8_t index );
+
+#endif /* __LORAROUTE_H_ */
@@ -0,0 +1,130 @@
+/**
+ * \file LoRaSession.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh session table
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaSession.h"
+
+#define LOG_LEVEL_TRACE
+#include "debug.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define TABLE_SIZE                          LORAMESH_CONFIG_SESSION_TABLE_SIZE
+#define TABLE_MASK                          (TABLE_SIZE - 1)
+
+#if ((TABLE_SIZE & TABLE_MASK) != 0)
+#error "LORAMESH_CONFIG_SESSION_TABLE_SIZE has to be a power of two"
+#endif
+#if (TABLE_SIZE <= LORAMESH_CONFIG_NOF_SESSIONS)
+#error "LORAMESH_CONFIG_SESSION_TABLE_SIZE too small for child nodes and multicast groups"
+#endif
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Session table, open addressing with linear probing */
+static LoRaMeshSession_t SessionTable[TABLE_SIZE];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Home position of an address in the session table */
+static uint16_t SessionHash( uint32_t addr );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaSession_Init( void )
+{
+    uint16_t i;
+
+    for ( i = 0; i < TABLE_SIZE; i++ ) {
+        SessionTable[i].Type = SESSION_TYPE_NONE;
+    }
+}
+
+LoRaMeshSession_t* LoRaSession_Find( uint32_t addr )
+{
+    uint16_t i, idx = SessionHash(addr);
+
+    for ( i = 0; i < TABLE_SIZE; i++ ) {
+        if ( SessionTable[idx].Type == SESSION_TYPE_NONE ) break;
+        if ( SessionTable[idx].Address == addr ) return &SessionTable[idx];
+        idx = (idx + 1) & TABLE_MASK;
+    }
+
+    return NULL;
+}
+
+LoRaMeshSession_t* LoRaSession_Add( uint32_t addr, LoRaMeshSessionType_t type,
+        struct ConnectionInfo_s *connection, void *info )
+{
+    uint16_t i, idx = SessionHash(addr);
+
+    for ( i = 0; i < TABLE_SIZE; i++ ) {
+        if ( SessionTable[idx].Type != SESSION_TYPE_NONE && SessionTable[idx].Address == addr
+                && SessionTable[idx].Type != type ) {
+            LOG_ERROR("Address 0x%08x already used by another session type.", addr);
+            return NULL;
+        }
+        if ( SessionTable[idx].Type == SESSION_TYPE_NONE || SessionTable[idx].Address == addr ) {
+            SessionTable[idx].Address = addr;
+            SessionTable[idx].Type = type;
+            SessionTable[idx].Connection = connection;
+            SessionTable[idx].Info = info;
+            return &SessionTable[idx];
+        }
+        idx = (idx + 1) & TABLE_MASK;
+    }
+
+    LOG_ERROR("Session table full.");
+    return NULL;
+}
+
+void LoRaSession_Remove( uint32_t addr )
+{
+    LoRaMeshSession_t *session = LoRaSession_Find(addr);
+    uint16_t hole, idx, home;
+
+    if ( session == NULL ) return;
+
+    /* Following entries of the probe sequence are shifted back, no tombstones */
+    hole = (uint16_t)(session - SessionTable);
+    idx = hole;
+    for ( ;; ) {
+        idx = (idx + 1) & TABLE_MASK;
+        if ( SessionTable[idx].Type == SESSION_TYPE_NONE ) break;
+        home = SessionHash(SessionTable[idx].Address);
+        /* Move the entry unless its home lies cyclically within (hole, idx] */
+        if ( ((idx - home) & TABLE_MASK) >= ((idx - hole) & TABLE_MASK) ) {
+            SessionTable[hole] = SessionTable[idx];
+            hole = idx;
+        }
+    }
+    SessionTable[hole].Type = SESSION_TYPE_NONE;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*!
+ * \brief Home position of an address in the session table.
+ *
+ * \param addr Device or group address
+ */
+static uint16_t SessionHash( uint32_t addr )
+{
+    /* Fibonacci hashing, device addresses often only differ in the low bits */
+    addr *= 0x9E3779B1UL;
+    return (uint16_t)((addr ^ (addr >> 16)) & TABLE_MASK);
+}
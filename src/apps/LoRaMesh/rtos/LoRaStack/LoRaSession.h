@@ -0,0 +1,85 @@
+/**
+ * \file LoRaSession.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh session table
+ *
+ * One table keyed by the 32 bit device or group address holds the sessions of
+ * the own up link, of the child nodes and of the multicast groups. The table
+ * uses open addressing with linear probing over a static pool of
+ * LORAMESH_CONFIG_SESSION_TABLE_SIZE entries, a removed entry shifts the
+ * following entries of its probe sequence back so no tombstones are needed.
+ *
+ * The table size is derived from the number of child nodes and multicast
+ * groups, see LoRaMesh-config.h. A lookup takes 1.5 probes on average at the
+ * default load factor of at most 1/2, bench-session measures the lookup cost
+ * as the table fills.
+ */
+
+#ifndef __LORASESSION_H_
+#define __LORASESSION_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! LoRaMesh session types */
+typedef enum {
+    SESSION_TYPE_NONE, SESSION_TYPE_UPLINK, SESSION_TYPE_CHILD_NODE, SESSION_TYPE_MULTICAST
+} LoRaMeshSessionType_t;
+
+/*! LoRaMesh session table entry */
+typedef struct LoRaMeshSession_s {
+    uint32_t Address; /* Device or group address, key of the session */
+    LoRaMeshSessionType_t Type; /* Session type, SESSION_TYPE_NONE if unused */
+    struct ConnectionInfo_s *Connection; /* Keys and frame counters */
+    void *Info; /* ChildNodeInfo_t or MulticastGroupInfo_t, NULL for the own up link */
+} LoRaMeshSession_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Removes all sessions.
+ */
+void LoRaSession_Init( void );
+
+/*!
+ * \brief Find the session of an address.
+ *
+ * \param addr Device or group address.
+ *
+ * \return LoRaMeshSession_t* Returns pointer to the session or NULL if not found.
+ */
+LoRaMeshSession_t* LoRaSession_Find( uint32_t addr );
+
+/*!
+ * \brief Add a session or update the session of an existing address.
+ *
+ * \param addr Device or group address.
+ * \param type Session type.
+ * \param connection Connection information of the session.
+ * \param info Child node or multicast group information.
+ *
+ * \return LoRaMeshSession_t* Pointer to the session or NULL if the table is full
+ *         or the address is used by a session of another type.
+ */
+LoRaMeshSession_t* LoRaSession_Add( uint32_t addr, LoRaMeshSessionType_t type,
+        struct ConnectionInfo_s *connection, void *info );
+
+/*!
+ * \brief Remove the session of an address.
+ *
+ * \param addr Device or group address.
+ */
+void LoRaSession_Remove( uint32_t addr );
+
+#endif /* __LORASESSION_H_ */
@@ -0,0 +1,216 @@
+/**
+ * \file LoRaSlots.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh scheduler slot bitmap
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaSlots.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NOF_SLOTS                           LORASLOTS_NOF_SLOTS
+#define RX_WINDOW_SLOTS                     (LORASLOTS_RECEPTION_RESERVED_TIME / LORASLOTS_TIME_PER_SLOT)
+
+#define SLOT_BITMAP_WORDS                   ((NOF_SLOTS + 31) / 32)
+#define SLOT_OP_CHECK                       (0)
+#define SLOT_OP_RESERVE                     (1)
+#define SLOT_OP_RELEASE                     (2)
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! One bit per slot, set if reserved */
+static uint32_t SlotBitmap[SLOT_BITMAP_WORDS];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Checks all occurrences of a periodic event starting at slot */
+static bool CheckSlotPattern( uint16_t slot, const LoRaSlotPattern_t *pattern,
+        uint16_t *nofOccurrences );
+
+/*! \brief Mask of the bits within a bitmap word covering [first, last] */
+static uint32_t SlotMask( uint8_t first, uint8_t last );
+
+/*! \brief Applies an operation on the bitmap range [startSlot, endSlot] */
+static bool SlotBitmapOp( uint16_t startSlot, uint16_t endSlot, uint8_t op );
+
+/*! \brief Returns the first free slot at or after slot */
+static uint16_t FindFreeSlot( uint16_t slot );
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaSlots_Init( void )
+{
+    memset1((uint8_t*) SlotBitmap, 0, sizeof(SlotBitmap));
+}
+
+uint8_t LoRaSlots_Find( uint16_t firstSlot, const LoRaSlotPattern_t *pattern,
+        uint16_t *startSlot, uint16_t *nofOccurrences )
+{
+    uint16_t slot;
+
+    if ( firstSlot != LORASLOTS_ANY_SLOT ) {
+        if ( CheckSlotPattern(firstSlot, pattern, nofOccurrences) ) {
+            *startSlot = firstSlot;
+            return ERR_OK;
+        }
+        return ERR_FAILED;
+    }
+
+    slot = FindFreeSlot(0);
+    while ( slot < NOF_SLOTS ) {
+        if ( CheckSlotPattern(slot, pattern, nofOccurrences) ) {
+            *startSlot = slot;
+            return ERR_OK;
+        }
+        slot = FindFreeSlot(slot + 1);
+    }
+    return ERR_FAILED;
+}
+
+bool LoRaSlots_AreFree( uint16_t startSlot, uint16_t endSlot )
+{
+    return SlotBitmapOp(startSlot, endSlot, SLOT_OP_CHECK);
+}
+
+void LoRaSlots_Reserve( uint16_t startSlot, uint16_t endSlot )
+{
+    (void) SlotBitmapOp(startSlot, endSlot, SLOT_OP_RESERVE);
+}
+
+void LoRaSlots_Release( uint16_t startSlot, uint16_t endSlot )
+{
+    (void) SlotBitmapOp(startSlot, endSlot, SLOT_OP_RELEASE);
+}
+
+uint16_t LoRaSlots_GetNofReserved( void )
+{
+    uint16_t i, nofReserved = 0;
+
+    for ( i = 0; i < SLOT_BITMAP_WORDS; i++ ) {
+        nofReserved += __builtin_popcount(SlotBitmap[i]);
+    }
+    return nofReserved;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*!
+ * Check if all occurrences of a periodic event starting at the given slot are
+ * free
+ *
+ * \param[IN] slot First slot of the event
+ * \param[IN] pattern Periodic event
+ * \param[OUT] nofOccurrences Number of occurrences within the slot window
+ *
+ * \retval bool True if the first occurrence fits and no occurrence collides
+ */
+static bool CheckSlotPattern( uint16_t slot, const LoRaSlotPattern_t *pattern,
+        uint16_t *nofOccurrences )
+{
+    uint16_t rx1Offset, rx2Offset, lastSlot, end, n;
+
+    rx1Offset = pattern->Duration + pattern->Rx1Delay;
+    rx2Offset = pattern->Duration + pattern->Rx2Delay;
+    lastSlot = pattern->RxWindows ? (rx2Offset + RX_WINDOW_SLOTS) : pattern->Duration;
+
+    /* Occurrences of the same event may not overlap */
+    if ( lastSlot >= pattern->Interval
+            && ((uint32_t) slot + pattern->Interval + lastSlot) < NOF_SLOTS ) return false;
+
+    for ( n = 0; ((uint32_t) slot + lastSlot) < NOF_SLOTS; n++ ) {
+        end = slot + pattern->Duration;
+        if ( !LoRaSlots_AreFree(slot, end) ) return false;
+        if ( pattern->RxWindows ) {
+            end = slot + rx1Offset;
+            if ( !LoRaSlots_AreFree(end, end + RX_WINDOW_SLOTS) ) return false;
+            end = slot + rx2Offset;
+            if ( !LoRaSlots_AreFree(end, end + RX_WINDOW_SLOTS) ) return false;
+        }
+        slot += pattern->Interval;
+    }
+
+    *nofOccurrences = n;
+    return (n > 0);
+}
+
+/*!
+ * Mask of the bits within a bitmap word covering slots [first, last]
+ *
+ * \param[IN] first First bit (0..31)
+ * \param[IN] last Last bit (first..31)
+ */
+static uint32_t SlotMask( uint8_t first, uint8_t last )
+{
+    return (0xFFFFFFFFUL >> (31 - last)) & (0xFFFFFFFFUL << first);
+}
+
+/*!
+ * Apply an operation word by word on the bitmap range [startSlot, endSlot]
+ *
+ * \param[IN] startSlot First slot
+ * \param[IN] endSlot Last slot (inclusive)
+ * \param[IN] op SLOT_OP_CHECK, SLOT_OP_RESERVE or SLOT_OP_RELEASE
+ *
+ * \retval bool SLOT_OP_CHECK: true if no slot of the range is reserved
+ */
+static bool SlotBitmapOp( uint16_t startSlot, uint16_t endSlot, uint8_t op )
+{
+    uint16_t word;
+    uint32_t mask;
+
+    if ( startSlot > endSlot || endSlot >= NOF_SLOTS ) return false;
+
+    for ( word = (startSlot >> 5); word <= (endSlot >> 5); word++ ) {
+        mask = SlotMask((word == (startSlot >> 5)) ? (startSlot & 0x1F) : 0,
+                (word == (endSlot >> 5)) ? (endSlot & 0x1F) : 31);
+        switch ( op ) {
+            case SLOT_OP_CHECK:
+                if ( (SlotBitmap[word] & mask) != 0 ) return false;
+                break;
+            case SLOT_OP_RESERVE:
+                SlotBitmap[word] |= mask;
+                break;
+            default:
+                SlotBitmap[word] &= ~mask;
+                break;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Find the first free slot at or after the given slot
+ *
+ * \param[IN] slot Slot to start the search from
+ *
+ * \retval slot First free slot or NOF_SLOTS if none is free
+ */
+static uint16_t FindFreeSlot( uint16_t slot )
+{
+    uint16_t word;
+    uint32_t freeBits;
+
+    if ( slot >= NOF_SLOTS ) return NOF_SLOTS;
+
+    word = slot >> 5;
+    freeBits = ~SlotBitmap[word] & (0xFFFFFFFFUL << (slot & 0x1F));
+    while ( freeBits == 0 ) {
+        if ( ++word >= SLOT_BITMAP_WORDS ) return NOF_SLOTS;
+        freeBits = ~SlotBitmap[word];
+    }
+    slot = (word << 5) + __builtin_ctz(freeBits);
+
+    return (slot < NOF_SLOTS) ? slot : NOF_SLOTS;
+}
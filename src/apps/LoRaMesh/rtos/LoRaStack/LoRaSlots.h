@@ -0,0 +1,107 @@
+/**
+ * \file LoRaSlots.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa mesh scheduler slot bitmap
+ *
+ * The part of the advertising interval between the advertising reserved time
+ * and the guard time is divided into LORASLOTS_NOF_SLOTS slots of
+ * LORASLOTS_TIME_PER_SLOT. One bit per slot marks it as reserved by an event
+ * of the scheduler. A periodic event is placed at the first slot where all
+ * its occurrences, and the rx1 and rx2 windows of an uplink, find free slots.
+ * Candidates are taken from the bitmap by skipping whole occupied words, so a
+ * search costs O(LORASLOTS_NOF_SLOTS / 32) per candidate.
+ */
+
+#ifndef __LORASLOTS_H_
+#define __LORASLOTS_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Advertising interval and its parts without slots (us) */
+#define LORASLOTS_ADVERTISING_INTERVAL_US       (30000000)
+#define LORASLOTS_ADVERTISING_GUARD_TIME        (2280000)
+#define LORASLOTS_ADVERTISING_RESERVED_TIME     (2120000)
+
+/*! Slot duration and slots of an advertising interval */
+#define LORASLOTS_TIME_PER_SLOT                 (50000)
+#define LORASLOTS_NOF_SLOTS                     ((LORASLOTS_ADVERTISING_INTERVAL_US \
+                                                    - LORASLOTS_ADVERTISING_GUARD_TIME \
+                                                    - LORASLOTS_ADVERTISING_RESERVED_TIME) \
+                                                    / LORASLOTS_TIME_PER_SLOT)
+
+/*! Time reserved for a reception window (us) */
+#define LORASLOTS_RECEPTION_RESERVED_TIME       (50000)
+
+/*! First slot selected by LoRaSlots_Find */
+#define LORASLOTS_ANY_SLOT                      (0xFFFF)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Periodic event */
+typedef struct LoRaSlotPattern_s {
+    uint16_t Interval; /* Slots between two occurrences */
+    uint16_t Duration; /* Slots of an occurrence after its first slot */
+    bool RxWindows; /* Rx1 and rx2 windows follow every occurrence */
+    uint16_t Rx1Delay; /* Slots between the end of an occurrence and the rx1 window */
+    uint16_t Rx2Delay; /* Slots between the end of an occurrence and the rx2 window */
+} LoRaSlotPattern_t;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Releases all slots.
+ */
+void LoRaSlots_Init( void );
+
+/*!
+ * \brief Find the first slot of a periodic event whose occurrences all fit
+ *        into free slots.
+ *
+ * \remark Occurrences which would not fit completely into the slot window are
+ *         dropped. Overlapping occurrences of the same event are rejected.
+ *
+ * \param firstSlot Requested first slot, LORASLOTS_ANY_SLOT if any slot may be used.
+ * \param pattern Periodic event.
+ * \param startSlot First slot of the event.
+ * \param nofOccurrences Number of occurrences within the slot window.
+ *
+ * \retval ERR_OK if free slots were found, ERR_FAILED otherwise.
+ */
+uint8_t LoRaSlots_Find( uint16_t firstSlot, const LoRaSlotPattern_t *pattern,
+        uint16_t *startSlot, uint16_t *nofOccurrences );
+
+/*!
+ * \brief Check if the slots [startSlot, endSlot] are free.
+ *
+ * \retval bool False if a slot is reserved or the range lies outside the slot window.
+ */
+bool LoRaSlots_AreFree( uint16_t startSlot, uint16_t endSlot );
+
+/*!
+ * \brief Reserve the slots [startSlot, endSlot].
+ */
+void LoRaSlots_Reserve( uint16_t startSlot, uint16_t endSlot );
+
+/*!
+ * \brief Release the slots [startSlot, endSlot].
+ */
+void LoRaSlots_Release( uint16_t startSlot, uint16_t endSlot );
+
+/*!
+ * \brief Returns the number of reserved slots.
+ */
+uint16_t LoRaSlots_GetNofReserved( void );
+
+#endif /* __LORASLOTS_H_ */
@@ -0,0 +1,143 @@
+/**
+ * \file LoRaStats.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa stack statistics
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMesh.h"
+#include "LoRaStats.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Weight of a new sample in the link averages (1/LINK_AVG_WEIGHT) */
+#define LINK_AVG_WEIGHT                     LORAMESH_CONFIG_STATS_LINK_AVG_WEIGHT
+
+/*! Number of layer counters, all counters precede the band statistics */
+#define NOF_COUNTERS                        (offsetof(LoRaStats_t, TxAirtime) / sizeof(uint32_t))
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Writes a little endian value to the snapshot */
+static uint8_t *PutValue( uint8_t *buf, uint32_t value, uint8_t size );
+
+/*! \brief Writes a link to the snapshot */
+static uint8_t *PutLink( uint8_t *buf, uint32_t addr, LoRaStats_Link_t *link );
+
+/*******************************************************************************
+ * MODULE VARIABLES (PUBLIC)
+ ******************************************************************************/
+LoRaStats_t LoRaStats;
+
+/*******************************************************************************
+ * API FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaStats_Reset( void )
+{
+    ChildNodeInfo_t *childNode;
+
+    memset1((uint8_t*) &LoRaStats, 0U, sizeof(LoRaStats_t));
+
+    if ( pLoRaDevice != NULL ) {
+        for ( childNode = pLoRaDevice->childNodes; childNode != NULL;
+                childNode = childNode->next ) {
+            LoRaStats_LinkReset(&childNode->Link);
+        }
+    }
+}
+
+void LoRaStats_LinkReset( LoRaStats_Link_t *link )
+{
+    memset1((uint8_t*) link, 0U, sizeof(LoRaStats_Link_t));
+}
+
+void LoRaStats_LinkUpdate( LoRaStats_Link_t *link, int16_t rssi, int8_t snr, uint32_t fCnt )
+{
+#if(LORAMESH_CONFIG_STATS_ENABLED == 1)
+    if ( link->RxFrames == 0 ) {
+        /* First frame, start the averages at the sample */
+        link->AvgRssi = rssi * 16;
+        link->AvgSnr = snr * 16;
+    } else {
+        link->AvgRssi += ((rssi * 16) - link->AvgRssi) / LINK_AVG_WEIGHT;
+        link->AvgSnr += ((snr * 16) - link->AvgSnr) / LINK_AVG_WEIGHT;
+        if ( fCnt > (link->LastFCnt + 1) ) {
+            link->LostFrames += fCnt - link->LastFCnt - 1;
+        }
+    }
+    link->RxFrames++;
+    link->LastFCnt = fCnt;
+    link->LastRssi = rssi;
+    link->LastSnr = snr;
+#endif
+}
+
+size_t LoRaStats_GetSnapshot( uint8_t *buf, size_t bufSize )
+{
+    const uint32_t *cntr = (const uint32_t*) &LoRaStats;
+    ChildNodeInfo_t *childNode;
+    uint8_t *ptr = buf, *nofLinks;
+    uint8_t i;
+
+    if ( bufSize < LORASTATS_SNAPSHOT_SIZE(1) ) {
+        return 0;
+    }
+
+    *ptr++ = LORASTATS_SNAPSHOT_VERSION;
+    *ptr++ = (uint8_t) NOF_COUNTERS;
+    for ( i = 0; i < NOF_COUNTERS; i++ ) {
+        ptr = PutValue(ptr, cntr[i], 4);
+    }
+
+    *ptr++ = LORA_MAX_NB_BANDS;
+    for ( i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
+        ptr = PutValue(ptr, LoRaStats.TxAirtime[i], 4);
+        ptr = PutValue(ptr, LoRaStats.BlockedTime[i], 4);
+    }
+
+    nofLinks = ptr++;
+    *nofLinks = 1;
+    ptr = PutLink(ptr, pLoRaDevice->devAddr, &LoRaStats.UpLink);
+
+    for ( childNode = pLoRaDevice->childNodes; childNode != NULL; childNode = childNode->next ) {
+        if ( (size_t)(ptr - buf) + LORASTATS_SNAPSHOT_LINK_SIZE > bufSize || *nofLinks == 0xFF ) {
+            break;
+        }
+        ptr = PutLink(ptr, childNode->Connection.Address, &childNode->Link);
+        (*nofLinks)++;
+    }
+
+    return (size_t)(ptr - buf);
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint8_t *PutValue( uint8_t *buf, uint32_t value, uint8_t size )
+{
+    while ( size-- > 0 ) {
+        *buf++ = (uint8_t) value;
+        value >>= 8;
+    }
+    return buf;
+}
+
+static uint8_t *PutLink( uint8_t *buf, uint32_t addr, LoRaStats_Link_t *link )
+{
+    buf = PutValue(buf, addr, 4);
+    buf = PutValue(buf, link->RxFrames, 4);
+    buf = PutValue(buf, link->LostFrames, 4);
+    buf = PutValue(buf, (uint16_t) link->LastRssi, 2);
+    buf = PutValue(buf, (uint8_t) link->LastSnr, 1);
+    buf = PutValue(buf, (uint16_t) link->AvgRssi, 2);
+    buf = PutValue(buf, (uint16_t) link->AvgSnr, 2);
+    return buf;
+}
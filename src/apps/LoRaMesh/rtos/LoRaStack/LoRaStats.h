@@ -0,0 +1,172 @@
+/**
+ * \file LoRaStats.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \version 1.0
+ *
+ * \brief LoRa stack statistics
+ *
+ * Every layer counts its events in its own counter group. Counters are plain
+ * increments, they may be incremented from the radio interrupt and the stack
+ * task, a rare lost increment is accepted for the sake of speed.
+ */
+
+#ifndef __LORASTATS_H_
+#define __LORASTATS_H_
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "LoRaMac-board.h"
+#include "LoRaMesh-config.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*!
+ * Binary snapshot format (little endian):
+ *
+ * <version:1><nofCntrs:1><cntr:4>*nofCntrs
+ * <nofBands:1>(<airtime ms:4><blocked ms:4>)*nofBands
+ * <nofLinks:1>(<addr:4><rxFrames:4><lostFrames:4><lastRssi:2><lastSnr:1><avgRssi:2><avgSnr:2>)*nofLinks
+ *
+ * The first link is the own up link, followed by the child nodes. Average
+ * values are in 1/16 dB.
+ */
+#define LORASTATS_SNAPSHOT_VERSION              (2)
+#define LORASTATS_SNAPSHOT_LINK_SIZE            (19)
+
+/*******************************************************************************
+ * MACRO DEFINITIONS
+ ******************************************************************************/
+#if(LORAMESH_CONFIG_STATS_ENABLED == 1)
+#define LORASTATS_INC(layer, cntr)              (LoRaStats.layer.cntr++)
+#define LORASTATS_ADD(field, val)               (LoRaStats.field += (val))
+#else
+#define LORASTATS_INC(layer, cntr)
+#define LORASTATS_ADD(field, val)
+#endif
+
+/*! Size of a snapshot with nofLinks links (own up link included) */
+#define LORASTATS_SNAPSHOT_SIZE(nofLinks)       (2 + offsetof(LoRaStats_t, TxAirtime) + 1 \
+                                                    + (8 * LORA_MAX_NB_BANDS) + 1 \
+                                                    + (LORASTATS_SNAPSHOT_LINK_SIZE * (nofLinks)))
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Physical layer counters */
+typedef struct LoRaStats_Phy_s {
+    uint32_t TxFrames; /* Transmissions completed */
+    uint32_t TxTimeouts; /* Transmissions aborted by the radio */
+    uint32_t RxFrames; /* Frames received and queued */
+    uint32_t RxTimeouts; /* Reception windows closed without frame */
+    uint32_t RxErrors; /* Frames received with CRC or header error */
+    uint32_t QueueFull; /* Frames dropped, rx or tx queue full */
+    uint32_t NoBuffer; /* Frames dropped, buffer pool exhausted */
+} LoRaStats_Phy_t;
+
+/*! MAC layer counters */
+typedef struct LoRaStats_Mac_s {
+    uint32_t RxFrames; /* Frames with a valid MIC */
+    uint32_t MicFailures; /* Frames with an invalid MIC */
+    uint32_t UnknownSession; /* Frames of an unknown child node */
+    uint32_t InvalidFrames; /* Frames of another version or unknown type */
+    uint32_t RouteForwarded; /* Frames forwarded to the next hop */
+    uint32_t RouteDelivered; /* Routed frames unwrapped at their destination */
+    uint32_t RouteDropped; /* Routed frames dropped, no route, too many hops or too large */
+    uint32_t Replays; /* Frames with a valid MIC and an already received frame counter */
+} LoRaStats_Mac_t;
+
+/*! Frame layer counters */
+typedef struct LoRaStats_Frm_s {
+    uint32_t TxFrames; /* Data frames passed to the MAC */
+    uint32_t RxFrames; /* Data frames passed to the mesh layer */
+    uint32_t Malformed; /* Frames shorter than their header */
+} LoRaStats_Frm_t;
+
+/*! Mesh layer counters */
+typedef struct LoRaStats_Mesh_s {
+    uint32_t AdvertisingRx; /* Advertising beacons received */
+    uint32_t SchedulerNoSlot; /* Events refused, no free slot pattern */
+    uint32_t SchedulerNoEvent; /* Events refused, scheduler events exhausted */
+    uint32_t AggrFrames; /* Aggregation containers sent */
+    uint32_t AggrRecords; /* Records sent in aggregation containers */
+    uint32_t AggrDropped; /* Records dropped, queue full or too large */
+} LoRaStats_Mesh_t;
+
+/*! Application layer counters */
+typedef struct LoRaStats_App_s {
+    uint32_t TxFrames; /* Payloads put by the application */
+    uint32_t RxFrames; /* Payloads delivered to a port handler */
+    uint32_t NoPortHandler; /* Payloads without port handler */
+} LoRaStats_App_t;
+
+/*! Link quality of a peer */
+typedef struct LoRaStats_Link_s {
+    uint32_t RxFrames; /* Authenticated frames received */
+    uint32_t LostFrames; /* Frames missed, gaps in the frame counter */
+    uint32_t LastFCnt; /* Frame counter of the last frame */
+    int16_t LastRssi; /* dBm */
+    int8_t LastSnr; /* dB */
+    int16_t AvgRssi; /* 1/16 dBm */
+    int16_t AvgSnr; /* 1/16 dB */
+} LoRaStats_Link_t;
+
+/*! LoRa stack statistics */
+typedef struct LoRaStats_s {
+    LoRaStats_Phy_t Phy;
+    LoRaStats_Mac_t Mac;
+    LoRaStats_Frm_t Frm;
+    LoRaStats_Mesh_t Mesh;
+    LoRaStats_App_t App;
+    uint32_t TxAirtime[LORA_MAX_NB_BANDS]; /* Cumulated time on air per band [ms] */
+    uint32_t BlockedTime[LORA_MAX_NB_BANDS]; /* Cumulated duty cycle wait per band [ms] */
+    LoRaStats_Link_t UpLink; /* Down link frames received from the parent */
+} LoRaStats_t;
+
+/*******************************************************************************
+ * MODULE VARIABLES (PUBLIC)
+ ******************************************************************************/
+/*! LoRa stack statistics, use the LORASTATS_ macros to update them */
+extern LoRaStats_t LoRaStats;
+
+/*******************************************************************************
+ * API FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears all counters and the link statistics of the child nodes.
+ */
+void LoRaStats_Reset( void );
+
+/*!
+ * \brief Clears the statistics of a link.
+ *
+ * \param link Link statistics.
+ */
+void LoRaStats_LinkReset( LoRaStats_Link_t *link );
+
+/*!
+ * \brief Accounts an authenticated frame to a link.
+ *
+ * \param link Link statistics.
+ * \param rssi Frame RSSI [dBm].
+ * \param snr Frame SNR [dB].
+ * \param fCnt Full frame counter of the frame.
+ */
+void LoRaStats_LinkUpdate( LoRaStats_Link_t *link, int16_t rssi, int8_t snr, uint32_t fCnt );
+
+/*!
+ * \brief Serializes the statistics into a compact binary snapshot.
+ *
+ * \param buf Snapshot buffer.
+ * \param bufSize Size of the snapshot buffer.
+ *
+ * \retval Snapshot size, child nodes that do not fit anymore are left out.
+ *         0 if the buffer is too small for the counters.
+ */
+size_t LoRaStats_GetSnapshot( uint8_t *buf, size_t bufSize );
+
+#endif /* __LORASTATS_H_ */
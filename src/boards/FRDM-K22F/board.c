@@ -10,6 +10,7 @@
  * INCLUDE FILES
  ******************************************************************************/
 #include "board.h"
+#include "debug.h"
 #include "fsl_clock_manager.h"
 #include "fsl_os_abstraction.h"
 #include "fsl_wdog_hal.h"
@@ -279,6 +280,9 @@ void BoardInitMcu( void )
         GpioInit(&Uart1.Tx, UART1_TX, PIN_ALTERNATE_FCT, PIN_PUSH_PULL, PIN_PULL_UP, 1);
         GpioInit(&Uart1.Rx, UART1_RX, PIN_ALTERNATE_FCT, PIN_PUSH_PULL, PIN_PULL_UP, 1);
         DbgConsole_Init(1, 115200, kDebugConsoleUART);
+#if defined(LOG_DEFERRED)
+        TraceInit();
+#endif /* LOG_DEFERRED */
         TimerSetLowPowerEnable(false);
 #elif( LOW_POWER_MODE_ENABLE )
         TimerSetLowPowerEnable( true );
@@ -10,9 +10,10 @@
  * INCLUDE FILES
  ******************************************************************************/
 #include "board.h"
-
-#define LOG_LEVEL_TRACE
-#include "debug.h"
+#if defined(USE_FREE_RTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+#endif /* USE_FREE_RTOS */
 
 /*******************************************************************************
  * PRIVATE CONSTANT DEFINITIONS
@@ -23,6 +24,15 @@
 //#define FIFO_TX_SIZE                                128
 #define FIFO_RX_SIZE                                128
 
+#if defined(USE_FREE_RTOS)
+/*! GPS task, parses the received NMEA data */
+#define GPS_TASK_STACK_SIZE                         configMINIMAL_STACK_SIZE
+#define GPS_TASK_PRIO                               (tskIDLE_PRIORITY + 1)
+
+/*! Time to collect more bytes after the first one woke the task up [ms] */
+#define GPS_TASK_COLLECT_TIME                       20
+#endif /* USE_FREE_RTOS */
+
 /*******************************************************************************
  * PRIVATE VARIABLES (STATIC)
  ******************************************************************************/
@@ -30,9 +40,17 @@
 //uint8_t TxBuffer[FIFO_TX_SIZE];
 uint8_t RxBuffer[FIFO_RX_SIZE];
 
-/*! Nmea string */
-int8_t NmeaString[128];
-uint8_t NmeaStringSize = 0;
+#if defined(USE_FREE_RTOS)
+/*! GPS task handle, notified by the UART receive interrupt */
+static xTaskHandle GpsTaskHandle = NULL;
+#endif /* USE_FREE_RTOS */
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+#if defined(USE_FREE_RTOS)
+static void GpsTask( void *pvParameters );
+#endif /* USE_FREE_RTOS */
 
 /*******************************************************************************
  * MODULE FUNCTIONS (PUBLIC)
@@ -51,8 +69,6 @@ void GpsMcuOnPpsSignal( void )
 
 void GpsMcuInit( void )
 {
-    NmeaStringSize = 0;
-
     //FifoInit( &Uart0.FifoTx, TxBuffer, FIFO_TX_SIZE );
     FifoInit(&Uart0.FifoRx, RxBuffer, FIFO_RX_SIZE);
     Uart0.IrqNotify = GpsMcuIrqNotify;
@@ -64,29 +80,53 @@ void GpsMcuInit( void )
     UartInit(&Uart0, UART_0, UART0_TX, UART0_RX);
     UartConfig(&Uart0, RX_ONLY, 4800, UART_8_BIT, UART_1_STOP_BIT, NO_PARITY,
             NO_FLOW_CTRL);
+
+#if defined(USE_FREE_RTOS)
+    if ( xTaskCreate(GpsTask, "Gps", GPS_TASK_STACK_SIZE, (void*) NULL, GPS_TASK_PRIO,
+            &GpsTaskHandle) != pdPASS ) {
+        /*lint -e527 */
+        for ( ;; ) {
+        }; /* error! probably out of memory */
+        /*lint +e527 */
+    }
+#endif /* USE_FREE_RTOS */
+}
+
+void GpsMcuProcess( void )
+{
+    /* The receiver stays enabled */
+    (void) GpsProcessFifo(&Uart0.FifoRx);
 }
 
 void GpsMcuIrqNotify( UartNotifyId_t id )
 {
-    uint8_t data;
-    if ( id == UART_NOTIFY_RX ) {
-        if ( UartGetChar(&Uart0, &data) == 0 ) {
-            if ( (data == '$') || (NmeaStringSize >= 128) ) {
-                NmeaStringSize = 0;
-            }
-
-            NmeaString[NmeaStringSize++] = (int8_t) data;
-
-            if ( data == '\n' ) {
-                NmeaString[NmeaStringSize] = '\0';
-                LOG_TRACE_BARE("%s", NmeaString);
-                GpsParseGpsData(NmeaString, NmeaStringSize);
-//                UartDeInit (&Uart0);
-                BlockLowPowerDuringTask(false);
-            }
-        }
+#if defined(USE_FREE_RTOS)
+    portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+    /* The byte is already in the FIFO, the GPS task parses it */
+    if ( (id == UART_NOTIFY_RX) && (GpsTaskHandle != NULL) ) {
+        vTaskNotifyGiveFromISR(GpsTaskHandle, &xHigherPriorityTaskWoken);
+        portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+    }
+#endif /* USE_FREE_RTOS */
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+#if defined(USE_FREE_RTOS)
+static void GpsTask( void *pvParameters )
+{
+    (void) pvParameters; /* not used */
+
+    for ( ;; ) {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(GPS_TASK_COLLECT_TIME / portTICK_RATE_MS);
+        GpsMcuProcess();
     }
 }
+#endif /* USE_FREE_RTOS */
+
 /*******************************************************************************
  * END OF CODE
  ******************************************************************************/
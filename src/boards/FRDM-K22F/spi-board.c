@@ -184,3 +184,60 @@ uint16_t SpiInOut(Spi_t *obj, uint16_t outData)
     return data;
 }
 
+uint8_t SpiMcuTransfer(Spi_t *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)(Spi_t *obj))
+{
+    uint16_t i;
+    uint16_t data;
+
+    if ((obj == NULL) || (obj->Spi) == NULL) {
+        while (1)
+            ;
+    }
+
+    if (obj->isSlave) {
+        return 1;
+    }
+
+    dspi_command_config_t
+    commandConfig =
+    {
+        .isChipSelectContinuous = false,
+        .whichCtar = kDspiCtar0,
+        .whichPcs = kDspiPcs0,
+        .clearTransferCount = true,
+        .isEndOfQueue = false
+    };
+
+    // Restart the transfer once per burst instead of once per byte
+    DSPI_HAL_StopTransfer(obj->Spi);
+    DSPI_HAL_SetFlushFifoCmd(obj->Spi, true, true);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiTxComplete);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiEndOfQueue);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiTxFifoUnderflow);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiTxFifoFillRequest);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiRxFifoOverflow);
+    DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiRxFifoDrainRequest);
+    DSPI_HAL_PresetTransferCount(obj->Spi, 0);
+    DSPI_HAL_StartTransfer(obj->Spi);
+
+    for (i = 0; i < size; i++) {
+        // Write data to PUSHR
+        DSPI_HAL_WriteDataMastermode(obj->Spi, &commandConfig, (tx != NULL) ? tx[i] : 0x00);
+        // Check RFDR flag
+        while (DSPI_HAL_GetStatusFlag(obj->Spi, kDspiRxFifoDrainRequest) == false) {
+        }
+        // Read data from POPR
+        data = DSPI_HAL_ReadData(obj->Spi);
+        // Clear RFDR flag
+        DSPI_HAL_ClearStatusFlag(obj->Spi, kDspiRxFifoDrainRequest);
+        if (rx != NULL) {
+            rx[i] = (uint8_t) data;
+        }
+    }
+
+    if (callback != NULL) {
+        callback(obj);
+    }
+    return 0;
+}
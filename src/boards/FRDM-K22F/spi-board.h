@@ -9,6 +9,11 @@
 #ifndef __SPI_MCU_H__
 #define __SPI_MCU_H__
 
+/*!
+ * The board implements SpiMcuTransfer, used by SpiTransfer
+ */
+#define SPI_MCU_TRANSFER
+
 #include "fsl_dspi_master_driver.h"
 #include "fsl_dspi_slave_driver.h"
 
@@ -30,4 +35,17 @@ struct Spi_s {
     Gpio_t Nss;
 };
 
+/*!
+ * \brief Exchanges a block of bytes in a single DSPI burst
+ *
+ * \param [IN]  obj      SPI object
+ * \param [IN]  tx       Bytes to be sent, NULL sends 0x00
+ * \param [OUT] rx       Received bytes, NULL discards them
+ * \param [IN]  size     Number of bytes to be exchanged
+ * \param [IN]  callback Called once the burst is done, may be NULL
+ * \retval status        [0: OK, 1: Busy]
+ */
+uint8_t SpiMcuTransfer( struct Spi_s *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( struct Spi_s *obj ) );
+
 #endif  // __SPI_MCU_H__
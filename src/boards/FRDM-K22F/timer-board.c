@@ -173,5 +173,17 @@ void TimerHwEnterLowPowerStopMode( void )
     __WFI();
 #endif
 }
+#else
+#include "board.h"
+#include "timer-board.h"
 
-#endif
+uint32_t TimerHwGetCycles( void )
+{
+    if ( (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0u ) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0u;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
+}
+#endif /* FSL_RTOS_FREE_RTOS */
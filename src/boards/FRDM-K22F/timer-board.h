@@ -83,6 +83,21 @@ TimerTime_t TimerHwGetElapsedTime( void );
  */
 void TimerHwEnterLowPowerStopMode( void );
 
-#endif
+#else
+/*------------------------------ Defines ---------------------------------*/
+/*!
+ * Core clock cycles per microsecond of the cycle counter
+ */
+#define TIMER_HW_CYCLES_PER_US      (SystemCoreClock / 1000000U)
+
+/*!
+ * \brief Return the core cycle counter, wraps around after 2^32 cycles
+ *
+ * \remark Based on the DWT cycle counter, enabled on the first call.
+ *         Intended for short interval measurements, may be called from any
+ *         context.
+ */
+uint32_t TimerHwGetCycles( void );
 
+#endif /* FSL_RTOS_FREE_RTOS */
 #endif // __TIMER_BOARD_H__
@@ -7,6 +7,7 @@
  */
 
 #include "board.h"
+#include "debug.h"
 #include "fsl_clock_manager.h"
 #include "fsl_cop_hal.h"
 #include "fsl_smc_hal.h"
@@ -210,6 +211,9 @@ void BoardInitMcu( void )
         GpioInit(&Uart0.Rx, UART0_RX, PIN_ALTERNATE_FCT, PIN_PUSH_PULL, PIN_PULL_UP, 1);
         CLOCK_SYS_SetLpsciSrc(0, kClockLpsciSrcPllFllSel);
         DbgConsole_Init(0, 115200, kDebugConsoleLPSCI);
+#if defined(LOG_DEFERRED)
+        TraceInit();
+#endif /* LOG_DEFERRED */
         TimerSetLowPowerEnable(false);
 #elif( LOW_POWER_MODE_ENABLE )
         TimerSetLowPowerEnable( true );
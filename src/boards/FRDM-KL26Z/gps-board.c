@@ -9,3 +9,7 @@
 void GpsMcuInit(void)
 {
 }
+
+void GpsMcuProcess(void)
+{
+}
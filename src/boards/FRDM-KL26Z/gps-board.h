@@ -22,4 +22,9 @@ typedef struct Position_s {
  */
 void GpsMcuInit(void);
 
+/*!
+ * \brief Parses the received NMEA data, never called from interrupt context
+ */
+void GpsMcuProcess(void);
+
 #endif /* _GPS_BOARD_H_ */
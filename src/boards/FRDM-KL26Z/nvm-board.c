@@ -0,0 +1,32 @@
+/**
+ * \file nvm-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Target board non-volatile memory driver
+ *
+ * No flash area is reserved for the NVM store on this board yet, NvmMcuInit
+ * fails and the store stays unmounted.
+ */
+
+#include "board.h"
+#include "nvm-board.h"
+
+uint8_t NvmMcuInit( void )
+{
+    return FAIL;
+}
+
+uint8_t NvmMcuRead( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    return FAIL;
+}
+
+uint8_t NvmMcuWrite( uint32_t offset, const uint8_t *buffer, uint16_t size )
+{
+    return FAIL;
+}
+
+uint8_t NvmMcuEraseSector( uint32_t offset )
+{
+    return FAIL;
+}
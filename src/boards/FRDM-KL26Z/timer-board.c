@@ -185,4 +185,31 @@ void TimerHwEnterLowPowerStopMode( void )
     __WFI();
 #endif
 }
+#else
+#include "board.h"
+#include "timer-board.h"
+#include "task.h"
+
+uint32_t TimerHwGetCycles( void )
+{
+    uint32_t ticks, load, value;
+    uint32_t primask = __get_PRIMASK();
+
+    /* May be called with the interrupts disabled, e.g. from a critical section */
+    __disable_irq();
+
+    ticks = xTaskGetTickCountFromISR();
+    load = SysTick->LOAD;
+    value = SysTick->VAL;
+    if ( (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0u ) {
+        /* Wrapped but the tick is not yet accounted for by the interrupt */
+        value = SysTick->VAL;
+        ticks++;
+    }
+
+    __set_PRIMASK(primask);
+
+    /* SysTick counts down from load to 0 */
+    return (ticks * (load + 1u)) + (load - value);
+}
 #endif /* FSL_RTOS_FREE_RTOS */
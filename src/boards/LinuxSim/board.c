@@ -0,0 +1,73 @@
+/**
+ * \file board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Host simulation target board general functions implementation
+ *
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Flag to indicate if the MCU is Initialized */
+static bool McuInitialized = false;
+
+/*! Board unique ID */
+static uint8_t UniqueId[8] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void BoardInitPeriph( void )
+{
+}
+
+void BoardInitMcu( void )
+{
+    if ( McuInitialized == false ) {
+        /* The virtual clock has no low power variant */
+        TimerSetLowPowerEnable(false);
+        TimerHwInit();
+
+        McuInitialized = true;
+    }
+}
+
+void BoardDeInitMcu( void )
+{
+    SimMediumDetach(SimRadioGetNode());
+
+    McuInitialized = false;
+}
+
+uint8_t BoardGetBatteryLevel( void )
+{
+    /* Device is connected to an external power source*/
+    return 0;
+}
+
+uint32_t BoardGetRandomSeed( void )
+{
+    uint32_t seed = 0;
+    uint8_t i;
+
+    for ( i = 0; i < sizeof(UniqueId); i++ ) {
+        seed ^= (uint32_t) UniqueId[i] << ((i & 0x03) << 3);
+    }
+    return seed;
+}
+
+void BoardGetUniqueId( uint8_t *id )
+{
+    memcpy1(id, UniqueId, sizeof(UniqueId));
+}
+
+void BoardSetUniqueId( const uint8_t *id )
+{
+    memcpy1(UniqueId, id, sizeof(UniqueId));
+}
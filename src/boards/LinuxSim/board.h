@@ -0,0 +1,124 @@
+/**
+ * \file board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Host simulation target board general functions implementation
+ *
+ * The LinuxSim board runs the bare-metal stack as a host process. Time is a
+ * discrete virtual clock (see timer-board.h) and the radio is a node of the
+ * simulated radio medium (see sim-medium.h). The portable utilities of the
+ * STM32 boards (src/boards/mcu/stm32/utilities.c) are used.
+ */
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "utilities.h"
+#include "timer.h"
+#include "delay.h"
+#include "radio.h"
+#include "sx1276/sx1276Regs-Fsk.h"
+#include "sx1276/sx1276Regs-LoRa.h"
+#include "sim-medium.h"
+#include "sim-radio.h"
+#include "rtc-board.h"
+#include "timer-board.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! NULL definition */
+#ifndef NULL
+#define NULL                           ( ( void * )0 )
+#endif
+
+/*! Generic definition */
+#ifndef SUCCESS
+#define SUCCESS                        1
+#endif
+
+#ifndef FAIL
+#define FAIL                           0
+#endif
+
+/*! Error codes of the Kinetis boards, returned by the portable system modules and the LoRaStack */
+#define ERR_OK                         0x00U /*!< OK */
+#define ERR_RANGE                      0x01U /*!< Parameter out of range. */
+#define ERR_VALUE                      0x02U /*!< Parameter of incorrect value. */
+#define ERR_OVERFLOW                   0x03U /*!< Timer overflow. */
+#define ERR_BUSY                       0x06U /*!< Device is busy. */
+#define ERR_NOTAVAIL                   0x07U /*!< Requested value or method not available. */
+#define ERR_FAILED                     0x11U /*!< Requested functionality or process failed. */
+#define ERR_QFULL                      0x12U /*!< Queue is full. */
+#define ERR_INVALID_TYPE               0x13U /*!< Invalid type. */
+#define ERR_UNKNOWN                    0x14U /*!< */
+
+/*!
+ * The simulation is single threaded, the timer and radio events are raised
+ * from the main loop thus there is nothing to mask.
+ */
+#define __disable_irq()
+#define __enable_irq()
+#define __get_PRIMASK()                ( 0 )
+#define __set_PRIMASK( primask )       ( ( void )( primask ) )
+
+/*!
+ * Random seed generated using the board unique ID
+ */
+#define RAND_SEED                      ( BoardGetRandomSeed( ) )
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes the target board peripherals.
+ */
+void BoardInitMcu( void );
+
+/*!
+ * \brief Initializes the boards peripherals.
+ */
+void BoardInitPeriph( void );
+
+/*!
+ * \brief De-initializes the target board peripherals to decrease power
+ *        consumption.
+ */
+void BoardDeInitMcu( void );
+
+/*!
+ * \brief Measure the Battery level
+ *
+ * \retval value  battery level ( 0: very low, 254: fully charged )
+ */
+uint8_t BoardGetBatteryLevel( void );
+
+/*!
+ * Returns a pseudo random seed generated using the board unique ID
+ *
+ * \retval seed Generated pseudo random seed
+ */
+uint32_t BoardGetRandomSeed( void );
+
+/*!
+ * \brief Gets the board 64 bits unique ID
+ *
+ * \param [IN] id Pointer to an array that will contain the Unique ID
+ */
+void BoardGetUniqueId( uint8_t *id );
+
+/*!
+ * \brief Sets the board 64 bits unique ID, to be called before BoardInitMcu
+ *
+ * \param [IN] id Pointer to an array containing the Unique ID
+ */
+void BoardSetUniqueId( const uint8_t *id );
+
+#endif // __BOARD_H__
@@ -0,0 +1,128 @@
+/**
+ * \file nvm-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host simulation non-volatile memory driver (NOR flash emulator)
+ *
+ * A power failure interrupts the operation in progress: a program unit is
+ * left with its first half programmed, an erase with the first half of the
+ * sector erased. All operations fail until NvmMcuSimPowerOn is called.
+ */
+
+#include "board.h"
+#include "nvm-board.h"
+
+/*----------------------- Local Definitions ------------------------------*/
+#define NVM_MCU_SIZE                                (NVM_MCU_SECTOR_SIZE * NVM_MCU_NB_SECTORS)
+
+/*------------------------ Local Variables -------------------------------*/
+static uint8_t Flash[NVM_MCU_SIZE];
+
+static uint32_t EraseCount[NVM_MCU_NB_SECTORS];
+
+/*!
+ * Remaining operations until the power fails, 0 if no failure is injected
+ */
+static uint32_t PowerFailCountdown = 0;
+
+static bool PoweredOff = false;
+
+/*------------------------ Local Functions -------------------------------*/
+/*!
+ * \brief Counts an operation, returns false if the power fails during it.
+ */
+static bool NvmMcuSimOperation( void );
+
+uint8_t NvmMcuInit( void )
+{
+    return PoweredOff ? FAIL : SUCCESS;
+}
+
+uint8_t NvmMcuRead( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    if ( PoweredOff || (offset + size) > NVM_MCU_SIZE ) {
+        return FAIL;
+    }
+    memcpy1(buffer, &Flash[offset], size);
+    return SUCCESS;
+}
+
+uint8_t NvmMcuWrite( uint32_t offset, const uint8_t *buffer, uint16_t size )
+{
+    uint8_t status = SUCCESS;
+
+    if ( PoweredOff || (offset % NVM_MCU_WRITE_UNIT) != 0 || (size % NVM_MCU_WRITE_UNIT) != 0
+            || (offset + size) > NVM_MCU_SIZE ) {
+        return FAIL;
+    }
+    for ( uint16_t i = 0; i < size; i += NVM_MCU_WRITE_UNIT ) {
+        if ( !NvmMcuSimOperation() ) {
+            for ( uint8_t j = 0; j < (NVM_MCU_WRITE_UNIT / 2); j++ ) {
+                Flash[offset + i + j] &= buffer[i + j];
+            }
+            return FAIL;
+        }
+        for ( uint8_t j = 0; j < NVM_MCU_WRITE_UNIT; j++ ) {
+            Flash[offset + i + j] &= buffer[i + j];
+            if ( Flash[offset + i + j] != buffer[i + j] ) {
+                status = FAIL; /* verify failed, the unit was not erased */
+            }
+        }
+    }
+    return status;
+}
+
+uint8_t NvmMcuEraseSector( uint32_t offset )
+{
+    if ( PoweredOff || (offset % NVM_MCU_SECTOR_SIZE) != 0 || offset >= NVM_MCU_SIZE ) {
+        return FAIL;
+    }
+    EraseCount[offset / NVM_MCU_SECTOR_SIZE]++;
+    if ( !NvmMcuSimOperation() ) {
+        memset1(&Flash[offset], 0xFF, NVM_MCU_SECTOR_SIZE / 2);
+        return FAIL;
+    }
+    memset1(&Flash[offset], 0xFF, NVM_MCU_SECTOR_SIZE);
+    return SUCCESS;
+}
+
+void NvmMcuSimFormat( void )
+{
+    memset1(Flash, 0xFF, sizeof(Flash));
+    memset1((uint8_t*) EraseCount, 0, sizeof(EraseCount));
+    PowerFailCountdown = 0;
+    PoweredOff = false;
+}
+
+void NvmMcuSimPowerFail( uint32_t operations )
+{
+    PowerFailCountdown = operations;
+}
+
+void NvmMcuSimPowerOn( void )
+{
+    PowerFailCountdown = 0;
+    PoweredOff = false;
+}
+
+bool NvmMcuSimIsPoweredOff( void )
+{
+    return PoweredOff;
+}
+
+uint32_t NvmMcuSimGetEraseCount( uint8_t sector )
+{
+    return EraseCount[sector];
+}
+
+static bool NvmMcuSimOperation( void )
+{
+    if ( PowerFailCountdown == 0 ) {
+        return true;
+    }
+    if ( --PowerFailCountdown == 0 ) {
+        PoweredOff = true;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+ * \file nvm-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Host simulation non-volatile memory driver (NOR flash emulator)
+ *
+ * Emulates the tinyK20 data flash: programming only clears bits and is
+ * verified, erasing a sector sets all its bytes to 0xFF. The erase cycles of
+ * every sector are counted and a power failure can be injected after a
+ * number of flash operations, the interrupted operation is left half done.
+ */
+
+#ifndef __NVM_BOARD_H_
+#define __NVM_BOARD_H_
+
+/*!
+ * Erase unit of the emulated flash [bytes]
+ */
+#define NVM_MCU_SECTOR_SIZE                         1024
+
+/*!
+ * Number of emulated flash sectors
+ */
+#define NVM_MCU_NB_SECTORS                          4
+
+/*!
+ * Programming unit of the emulated flash [bytes]
+ */
+#define NVM_MCU_WRITE_UNIT                          4
+
+/*!
+ * \brief Fails while the emulated flash is powered off
+ *
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuInit( void );
+
+/*!
+ * \brief Reads from the emulated flash
+ *
+ * \param [IN] offset Offset from the start of the NVM area
+ * \param [OUT] buffer Data read
+ * \param [IN] size Number of bytes to read
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuRead( uint32_t offset, uint8_t *buffer, uint16_t size );
+
+/*!
+ * \brief Programs the emulated flash and verifies it
+ *
+ * \param [IN] offset Offset from the start of the NVM area, multiple of
+ *                    NVM_MCU_WRITE_UNIT
+ * \param [IN] buffer Data to program
+ * \param [IN] size Number of bytes, multiple of NVM_MCU_WRITE_UNIT
+ * \retval status [SUCCESS, FAIL] FAIL if a bit had to be set
+ */
+uint8_t NvmMcuWrite( uint32_t offset, const uint8_t *buffer, uint16_t size );
+
+/*!
+ * \brief Erases an emulated flash sector
+ *
+ * \param [IN] offset Offset of the sector from the start of the NVM area
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuEraseSector( uint32_t offset );
+
+/*!
+ * \brief Erases the whole emulated flash and clears the erase cycle counters,
+ *        as a new device.
+ */
+void NvmMcuSimFormat( void );
+
+/*!
+ * \brief Cuts the power during a later flash operation.
+ *
+ * \param [IN] operations The power fails during this program unit or erase,
+ *                        counted from now on, 0 never fails
+ */
+void NvmMcuSimPowerFail( uint32_t operations );
+
+/*!
+ * \brief Restores the power after a power failure.
+ */
+void NvmMcuSimPowerOn( void );
+
+/*!
+ * \brief Returns true if the power failure has been injected.
+ */
+bool NvmMcuSimIsPoweredOff( void );
+
+/*!
+ * \brief Returns the erase cycles of a sector.
+ */
+uint32_t NvmMcuSimGetEraseCount( uint8_t sector );
+
+#endif /* __NVM_BOARD_H_ */
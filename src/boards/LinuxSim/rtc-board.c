@@ -0,0 +1,59 @@
+/**
+ * \file rtc-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Host simulation RTC, mapped onto the virtual clock
+ *
+ */
+
+#include "board.h"
+#include "rtc-board.h"
+
+void RtcInit( void )
+{
+    TimerHwInit();
+}
+
+void RtcStopTimer( void )
+{
+    TimerHwStop();
+}
+
+uint32_t RtcGetMinimumTimeout( void )
+{
+    return TimerHwGetMinimumTimeout();
+}
+
+void RtcSetTimeout( uint32_t timeout )
+{
+    TimerHwStart(timeout);
+}
+
+TimerTime_t RtcGetTimerValue( void )
+{
+    return TimerHwGetTime();
+}
+
+uint32_t RtcGetTimerElapsedTime( void )
+{
+    return (uint32_t) TimerHwGetElapsedTime();
+}
+
+void BlockLowPowerDuringTask( bool status )
+{
+    (void) status;
+}
+
+void RtcEnterLowPowerStopMode( void )
+{
+    TimerHwEnterLowPowerStopMode();
+}
+
+void RtcRecoverMcuStatus( void )
+{
+}
+
+void RtcDelayMs( uint32_t delay )
+{
+    TimerHwDelayMs(delay);
+}
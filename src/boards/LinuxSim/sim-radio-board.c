@@ -0,0 +1,21 @@
+/**
+ * \file sim-radio-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Simulated radio driver target board functions implementation
+ *
+ */
+
+#include "board.h"
+#include "radio.h"
+#include "sim-radio.h"
+
+/*!
+ * Radio driver structure initialization
+ */
+const struct Radio_s Radio = { SimRadioInit, SimRadioReset, SimRadioGetStatus, SimRadioSetModem,
+        SimRadioSetChannel, SimRadioIsChannelFree, SimRadioRandom, SimRadioSetRxConfig,
+        SimRadioSetTxConfig, SimRadioCheckRfFrequency, SimRadioGetTimeOnAir, SimRadioSend,
+        SimRadioSetSleep, SimRadioSetStby, SimRadioSetRx, SimRadioStartCad, SimRadioReadRssi,
+        SimRadioWrite, SimRadioRead, SimRadioWriteBuffer, SimRadioReadBuffer,
+        SimRadioSetMaxPayloadLength };
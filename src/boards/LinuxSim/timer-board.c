@@ -0,0 +1,100 @@
+/**
+ * \file timer-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Host simulation virtual clock
+ *
+ * The virtual time is the time of the radio medium, thus the timers and the
+ * radio events of all the nodes share one discrete event time line. The
+ * simulation driver owns the clock: it advances the medium to the earliest
+ * medium event or node alarm (TimerHwGetAlarmTime) and then raises the due
+ * alarms with TimerHwProcess.
+ */
+
+#include "board.h"
+#include "timer-board.h"
+
+/*------------------------ Local Variables -------------------------------*/
+/*!
+ * Time at which the alarm has been armed
+ */
+static TimerTime_t AlarmStartTime = 0;
+
+/*!
+ * Time at which the alarm expires
+ */
+static TimerTime_t AlarmTime = 0;
+
+/*!
+ * Is the alarm armed
+ */
+static bool AlarmArmed = false;
+
+/*------------------------ Public Functions ------------------------------*/
+void TimerHwInit( void )
+{
+    AlarmArmed = false;
+}
+
+void TimerHwDeInit( void )
+{
+    AlarmArmed = false;
+}
+
+uint32_t TimerHwGetMinimumTimeout( void )
+{
+    return 1;
+}
+
+void TimerHwStart( uint32_t timeout )
+{
+    AlarmStartTime = SimMediumGetTime();
+    AlarmTime = AlarmStartTime + timeout;
+    AlarmArmed = true;
+}
+
+void TimerHwStop( void )
+{
+    AlarmArmed = false;
+}
+
+void TimerHwDelayMs( uint32_t delay )
+{
+    /* Only the medium is advanced, the alarms of the other nodes of the
+     * process are raised late by the simulation driver */
+    SimMediumProcess(SimMediumGetTime() + (TimerTime_t) delay * 1000);
+    TimerHwProcess(SimMediumGetTime());
+}
+
+TimerTime_t TimerHwGetTimerValue( void )
+{
+    return SimMediumGetTime();
+}
+
+TimerTime_t TimerHwGetTime( void )
+{
+    return SimMediumGetTime();
+}
+
+TimerTime_t TimerHwGetElapsedTime( void )
+{
+    return SimMediumGetTime() - AlarmStartTime;
+}
+
+void TimerHwEnterLowPowerStopMode( void )
+{
+    /* The simulation driver advances the virtual clock */
+}
+
+TimerTime_t TimerHwGetAlarmTime( void )
+{
+    return (AlarmArmed == true) ? AlarmTime : SIM_MEDIUM_TIME_NEVER;
+}
+
+void TimerHwProcess( TimerTime_t now )
+{
+    if ( (AlarmArmed == true) && (AlarmTime <= now) ) {
+        AlarmArmed = false;
+        TimerIrqHandler();
+    }
+}
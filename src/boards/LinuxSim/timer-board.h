@@ -0,0 +1,92 @@
+/**
+ * \file timer-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Host simulation virtual clock
+ *
+ */
+
+#ifndef __TIMER_BOARD_H__
+#define __TIMER_BOARD_H__
+
+/*!
+ * \brief Timer time variable definition
+ */
+#ifndef TimerTime_t
+typedef uint64_t TimerTime_t;
+#endif
+
+/*!
+ * \brief Initializes the virtual clock
+ *
+ * \remark The clock has a 1 us resolution and is advanced by the simulation
+ *         driver, see TimerHwGetAlarmTime and TimerHwProcess.
+ */
+void TimerHwInit( void );
+
+/*!
+ * \brief DeInitializes the timer
+ */
+void TimerHwDeInit( void );
+
+/*!
+ * \brief Return the minimum timeout the Timer is able to handle
+ *
+ * \retval minimum value for a timeout
+ */
+uint32_t TimerHwGetMinimumTimeout( void );
+
+/*!
+ * \brief Arms the alarm, TimerIrqHandler is called on expiry
+ *
+ * \param [IN] timeout Timeout in us
+ */
+void TimerHwStart( uint32_t timeout );
+
+/*!
+ * \brief Perfoms a standard blocking delay in the code execution
+ *
+ * \param [IN] delay Delay value in ms
+ */
+void TimerHwDelayMs( uint32_t delay );
+
+/*!
+ * \brief Disarms the alarm
+ */
+void TimerHwStop( void );
+
+/*!
+ * \brief Return the value of the timer counter
+ */
+TimerTime_t TimerHwGetTimerValue( void );
+
+/*!
+ * \brief Return the value of the current time in us
+ */
+TimerTime_t TimerHwGetTime( void );
+
+/*!
+ * \brief Return the time elapsed since the alarm has been armed in us
+ */
+TimerTime_t TimerHwGetElapsedTime( void );
+
+/*!
+ * \brief Does nothing, the simulation driver advances the virtual clock
+ */
+void TimerHwEnterLowPowerStopMode( void );
+
+/*!
+ * \brief Returns the expiry time of the armed alarm
+ *
+ * \retval Alarm time in us, SIM_MEDIUM_TIME_NEVER if no alarm is armed
+ */
+TimerTime_t TimerHwGetAlarmTime( void );
+
+/*!
+ * \brief Raises the alarm if it has expired
+ *
+ * \param [IN] now Current virtual time in us
+ */
+void TimerHwProcess( TimerTime_t now );
+
+#endif // __TIMER_BOARD_H__
@@ -15,6 +15,11 @@ Maintainer: Miguel Luis and Gregory Cristian
 #ifndef __SPI_MCU_H__
 #define __SPI_MCU_H__
 
+/*!
+ * The board implements SpiMcuTransfer, used by SpiTransfer
+ */
+#define SPI_MCU_TRANSFER
+
 /*!
  * SPI driver structure definition
  */
@@ -27,4 +32,17 @@ struct Spi_s
     Gpio_t Nss;
 };
 
+/*!
+ * \brief Exchanges a block of bytes using the DMA1 channels 2 (Rx) and 3 (Tx)
+ *
+ * \param [IN]  obj      SPI object
+ * \param [IN]  tx       Bytes to be sent, NULL sends 0x00
+ * \param [OUT] rx       Received bytes, NULL discards them
+ * \param [IN]  size     Number of bytes to be exchanged
+ * \param [IN]  callback Called from the DMA interrupt, NULL blocks
+ * \retval status        [0: OK, 1: Busy]
+ */
+uint8_t SpiMcuTransfer( struct Spi_s *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+                        void ( *callback )( struct Spi_s *obj ) );
+
 #endif  // __SPI_MCU_H__
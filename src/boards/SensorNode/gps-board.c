@@ -23,9 +23,6 @@ Maintainer: Miguel Luis and Gregory Cristian
 //uint8_t TxBuffer[FIFO_TX_SIZE];
 uint8_t RxBuffer[FIFO_RX_SIZE];
 
-int8_t NmeaString[128];
-uint8_t NmeaStringSize = 0;
-
 void GpsMcuOnPpsSignal( void )
 {
     bool parseData = false;
@@ -41,8 +38,6 @@ void GpsMcuOnPpsSignal( void )
 
 void GpsMcuInit( void )
 {
-    NmeaStringSize = 0;
-
     //FifoInit( &Uart1.FifoTx, TxBuffer, FIFO_TX_SIZE );
     FifoInit( &Uart1.FifoRx, RxBuffer, FIFO_RX_SIZE );
     Uart1.IrqNotify = GpsMcuIrqNotify;
@@ -53,27 +48,16 @@ void GpsMcuInit( void )
     GpioSetInterrupt( &GpsPps, IRQ_FALLING_EDGE, IRQ_VERY_LOW_PRIORITY, &GpsMcuOnPpsSignal );
 }
 
-void GpsMcuIrqNotify( UartNotifyId_t id )
+void GpsMcuProcess( void )
 {
-    uint8_t data;
-    if( id == UART_NOTIFY_RX )
+    if( GpsProcessFifo( &Uart1.FifoRx ) == true )
     {
-        if( UartGetChar( &Uart1, &data ) == 0 )
-        {
-            if( ( data == '$' ) || ( NmeaStringSize >= 128 ) )
-            {
-                NmeaStringSize = 0;
-            }
-
-            NmeaString[NmeaStringSize++] = ( int8_t )data;
-
-            if( data == '\n' )
-            {
-                NmeaString[NmeaStringSize] = '\0';
-                GpsParseGpsData( NmeaString, NmeaStringSize );
-                UartDeInit( &Uart1 );
-                BlockLowPowerDuringTask ( false );
-            }
-        }
+        UartDeInit( &Uart1 );
     }
 }
+
+void GpsMcuIrqNotify( UartNotifyId_t id )
+{
+    // The received byte is already in the FIFO, the interrupt wakes up the
+    // main loop which parses it through GpsProcess
+}
@@ -16,6 +16,7 @@
 #include "spi-board.h"
 #include "stm32l1xx_spi.h"
 #include "stm32l1xx_gpio.h"
+#include "stm32l1xx_dma.h"
 
 /*!
  * \brief  Find First Set
@@ -39,6 +40,54 @@ typedef enum {
 
 SPI_InitTypeDef SPI_InitStructure;
 
+/*!
+ * SPI object of the running DMA transfer, NULL when idle
+ */
+static Spi_t * volatile SpiDmaObj = NULL;
+
+/*!
+ * Completion callback of the running DMA transfer
+ */
+static void (*SpiDmaCallback)(Spi_t *obj) = NULL;
+
+/*!
+ * Source of the Tx bytes when no Tx buffer is given
+ */
+static const uint8_t SpiDmaTxDummy = 0x00;
+
+/*!
+ * Destination of the Rx bytes when no Rx buffer is given
+ */
+static uint8_t SpiDmaRxDummy;
+
+/*!
+ * \brief Clocks the DMA1 controller and enables the SPI1 Rx channel interrupt
+ */
+static void SpiDmaInit(void)
+{
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/*!
+ * \brief Ends the running DMA transfer
+ */
+static void SpiDmaComplete(Spi_t *obj)
+{
+    SPI_I2S_DMACmd(obj->Spi, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+    DMA_Cmd(DMA1_Channel2, DISABLE);
+    DMA_Cmd(DMA1_Channel3, DISABLE);
+    DMA_ClearFlag(DMA1_FLAG_GL2 | DMA1_FLAG_GL3);
+    SpiDmaObj = NULL;
+}
+
 void SpiInit(Spi_t *obj, PinNames mosi, PinNames miso, PinNames sclk, PinNames nss)
 {
     /* Check if a proper channel was selected */
@@ -74,6 +123,8 @@ void SpiInit(Spi_t *obj, PinNames mosi, PinNames miso, PinNames sclk, PinNames n
     }
     SpiFrequency(obj, 10000000);
 
+    SpiDmaInit();
+
     SPI_Cmd(obj->Spi, ENABLE);
 }
 
@@ -151,3 +202,87 @@ uint16_t SpiInOut(Spi_t *obj, uint16_t outData)
     return SPI_I2S_ReceiveData(obj->Spi);
 }
 
+uint8_t SpiMcuTransfer(Spi_t *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)(Spi_t *obj))
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    if ((obj == NULL) || (obj->Spi) == NULL) {
+        while (1)
+            ;
+    }
+    if (SpiDmaObj != NULL) {
+        return 1;   // Busy
+    }
+    if (size == 0) {
+        if (callback != NULL) {
+            callback(obj);
+        }
+        return 0;
+    }
+    SpiDmaObj = obj;
+    SpiDmaCallback = callback;
+
+    // Drop a stale received byte
+    while (SPI_I2S_GetFlagStatus(obj->Spi, SPI_I2S_FLAG_RXNE) != RESET) {
+        SPI_I2S_ReceiveData(obj->Spi);
+    }
+
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) &obj->Spi->DR;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_BufferSize = size;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+
+    // Rx channel, higher priority so that no received byte is overwritten
+    DMA_DeInit(DMA1_Channel2);
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)((rx != NULL) ? rx : &SpiDmaRxDummy);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_MemoryInc = (rx != NULL) ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_Init(DMA1_Channel2, &DMA_InitStructure);
+
+    // Tx channel
+    DMA_DeInit(DMA1_Channel3);
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)((tx != NULL) ? tx : &SpiDmaTxDummy);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_MemoryInc = (tx != NULL) ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_Init(DMA1_Channel3, &DMA_InitStructure);
+
+    if (callback != NULL) {
+        DMA_ITConfig(DMA1_Channel2, DMA_IT_TC, ENABLE);
+    }
+    DMA_Cmd(DMA1_Channel2, ENABLE);
+    DMA_Cmd(DMA1_Channel3, ENABLE);
+    SPI_I2S_DMACmd(obj->Spi, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+
+    if (callback == NULL) {
+        // Every byte has been received once the Rx channel is done
+        while (DMA_GetFlagStatus(DMA1_FLAG_TC2) == RESET)
+            ;
+        SpiDmaComplete(obj);
+    }
+    return 0;
+}
+
+/*!
+ * \brief SPI1 Rx DMA channel transfer complete interrupt handler
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    Spi_t *obj = SpiDmaObj;
+
+    if (DMA_GetITStatus(DMA1_IT_TC2) != RESET) {
+        DMA_ClearITPendingBit(DMA1_IT_TC2);
+        DMA_ITConfig(DMA1_Channel2, DMA_IT_TC, DISABLE);
+        if (obj != NULL) {
+            SpiDmaComplete(obj);
+            if (SpiDmaCallback != NULL) {
+                SpiDmaCallback(obj);
+            }
+        }
+    }
+}
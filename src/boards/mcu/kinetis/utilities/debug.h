@@ -11,6 +11,7 @@
 /*******************************************************************************
  * INCLUDE FILES
  ******************************************************************************/
+#include "trace.h"
 
 /*******************************************************************************
  * CONSTANT DEFINITIONS
@@ -29,6 +30,14 @@
 #define LOG_DEFAULT_LEVEL_ERROR       // Only errors get printed
 //#define LOG_DEFAULT_LEVEL_NONE        // Nothing gets printed
 
+/**
+ * Define LOG_DEFERRED to store the trace and debug messages as binary records
+ * (see trace.h) instead of printing them at the call site. The records are
+ * printed by the trace task or read out with a debugger, which makes trace
+ * logging cheap enough for interrupt context and the radio timing.
+ */
+//#define LOG_DEFERRED
+
 /**
  * Undefine log enable flags
  */
@@ -85,20 +94,36 @@
 /**
  * Define log functions.
  */
-#if defined(LOG_TRACE_IS_ENABLED) && defined(DEBUG)
+#if defined(LOG_TRACE_IS_ENABLED) && defined(DEBUG) && defined(LOG_DEFERRED)
+#define LOG_TRACE(fmt, ...)                 TraceWrite(TRACE_LEVEL_TRACE, fmt, TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define LOG_TRACE_BARE(fmt, ...)            TraceWrite(TRACE_LEVEL_TRACE | TRACE_FLAG_BARE, fmt, TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define LOG_TRACE_IF(cond, fmt, ...)        if (cond) { LOG_TRACE(fmt, ##__VA_ARGS__); }
+#define LOG_TRACE_BARE_IF(cond, fmt, ...)   if (cond) { LOG_TRACE_BARE(fmt, ##__VA_ARGS__); }
+#define LOG_TRACE_HEX(data, size)           TraceWriteBuffer(TRACE_LEVEL_TRACE | TRACE_FLAG_BARE, data, size)
+#elif defined(LOG_TRACE_IS_ENABLED) && defined(DEBUG)
 #define LOG_TRACE(fmt, ...)                 debug_printf("TRACE: " fmt "\r\n", ##__VA_ARGS__)
 #define LOG_TRACE_BARE(fmt, ...)            debug_printf(fmt, ##__VA_ARGS__)
 #define LOG_TRACE_IF(cond, fmt, ...)        if (cond) { debug_printf("TRACE: " fmt "\r\n", ##__VA_ARGS__); }
 #define LOG_TRACE_BARE_IF(cond, fmt, ...)   if (cond) { debug_printf(fmt, ##__VA_ARGS__); }
+#define LOG_TRACE_HEX(data, size)           do { debug_printf("\t"); \
+                                                 for (size_t _i = 0; _i < (size_t)(size); _i++) \
+                                                     debug_printf("0x%02x ", ((const uint8_t*)(data))[_i]); \
+                                                 debug_printf("\r\n"); } while (0)
 #else
 #define LOG_TRACE(fmt, ...)
 #define LOG_TRACE_COLORED(fmt, ...)
 #define LOG_TRACE_BARE(fmt, ...)
 #define LOG_TRACE_IF(cond, fmt, ...)
 #define LOG_TRACE_BARE_IF(cond, fmt, ...)
+#define LOG_TRACE_HEX(data, size)
 #endif
 
-#if defined(LOG_DEBUG_IS_ENABLED) && defined(DEBUG)
+#if defined(LOG_DEBUG_IS_ENABLED) && defined(DEBUG) && defined(LOG_DEFERRED)
+#define LOG_DEBUG(fmt, ...)                 TraceWrite(TRACE_LEVEL_DEBUG, fmt, TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define LOG_DEBUG_BARE(fmt, ...)            TraceWrite(TRACE_LEVEL_DEBUG | TRACE_FLAG_BARE, fmt, TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define LOG_DEBUG_IF(cond, fmt, ...)        if (cond) { LOG_DEBUG(fmt, ##__VA_ARGS__); }
+#define LOG_DEBUG_BARE_IF(cond, fmt, ...)   if (cond) { LOG_DEBUG_BARE(fmt, ##__VA_ARGS__); }
+#elif defined(LOG_DEBUG_IS_ENABLED) && defined(DEBUG)
 #define LOG_DEBUG(fmt, ...)                 debug_printf("DEBUG: " fmt "\r\n", ##__VA_ARGS__)
 #define LOG_DEBUG_BARE(fmt, ...)            debug_printf(fmt, ##__VA_ARGS__)
 #define LOG_DEBUG_IF(cond, fmt, ...)        if (cond) { debug_printf("DEBUG: " fmt "\r\n", ##__VA_ARGS__); }
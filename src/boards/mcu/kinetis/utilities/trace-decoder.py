@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+\file trace-decoder.py
+\author Alexander Winiger (alexander.winiger@hslu.ch)
+\date 17.10.2026
+\brief Host decoder of the deferred trace records (see trace.h)
+
+Reads a binary dump of the TraceRing variable and prints the pending records.
+The format strings and %s arguments are looked up in the application ELF.
+
+Dump the ring with gdb while the target is halted:
+    (gdb) dump binary value trace.bin TraceRing
+and decode it:
+    trace-decoder.py LoRaMesh.elf trace.bin
+"""
+import re
+import struct
+import sys
+
+RECORD_MAGIC = 0xA5
+RECORD_HEADER_WORDS = 3
+
+LEVEL_MASK = 0x03
+FLAG_BARE = 0x04
+FLAG_HEX = 0x08
+LEVEL_PREFIX = ("TRACE: ", "DEBUG: ", "ERROR: ", "ERROR: ")
+
+FORMAT_SPEC = re.compile(r"%([-+ #0]*)(\d*)(\.\d+)?(hh|h|ll|l|z|j|t)?([diuoxXcsp%])")
+
+
+class Elf(object):
+    """Minimal reader of the loadable sections of a 32 bit little endian ELF."""
+
+    SHT_NOBITS = 8
+    SHF_ALLOC = 0x2
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("%s is not a 32 bit little endian ELF file" % path)
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset,
+             size) = struct.unpack_from("<IIIIII", self.data, shoff + i * shentsize)
+            if (flags & self.SHF_ALLOC) and sh_type != self.SHT_NOBITS and size > 0:
+                self.sections.append((addr, offset, size))
+
+    def string(self, address):
+        """Returns the string stored at a target address, None if not in the ELF."""
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("latin-1")
+        return None
+
+
+def format_record(elf, fmt, args):
+    """Applies the C format string to the 32 bit arguments."""
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        spec = "%" + flags + width + (precision or "")
+        if conversion in "di":
+            return (spec + "d") % (value - (1 << 32) if value & 0x80000000 else value)
+        if conversion == "u":
+            return (spec + "d") % value
+        if conversion in "oxX":
+            return (spec + conversion) % value
+        if conversion == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conversion == "p":
+            return "0x%08x" % value
+        text = elf.string(value)
+        return (spec + "s") % (text if text is not None else "<0x%08x>" % value)
+
+    return FORMAT_SPEC.sub(convert, fmt)
+
+
+def decode(elf, dump):
+    head, tail, dropped = struct.unpack_from("<III", dump, 0)
+    nb_words = (len(dump) - 12) // 4
+    if nb_words == 0 or (nb_words & (nb_words - 1)) != 0:
+        raise ValueError("dump size does not match a TraceRing variable")
+    buffer = struct.unpack_from("<%dI" % nb_words, dump, 12)
+
+    def word(index):
+        return buffer[index & (nb_words - 1)]
+
+    while tail != head:
+        header = word(tail)
+        if header == 0:
+            print("<record at %u not committed>" % tail)
+            break
+        if (header >> 24) != RECORD_MAGIC:
+            print("<corrupted record header 0x%08x>" % header)
+            break
+        flags = (header >> 16) & 0xFF
+        words = header & 0xFF
+        timestamp = word(tail + 1)
+        value = word(tail + 2)
+        data = [word(tail + RECORD_HEADER_WORDS + i) for i in range(words)]
+
+        line = "[%10u] " % timestamp
+        if not (flags & FLAG_BARE):
+            line += LEVEL_PREFIX[flags & LEVEL_MASK]
+        if flags & FLAG_HEX:
+            raw = struct.pack("<%dI" % words, *data)[:value]
+            line += "\t" + " ".join("0x%02x" % b for b in bytearray(raw))
+        else:
+            fmt = elf.string(value)
+            if fmt is None:
+                line += "<unknown format 0x%08x> %s" % (value, " ".join("0x%08x" % a for a in data))
+            else:
+                line += format_record(elf, fmt, data)
+        print(line.rstrip("\r\n"))
+        tail = (tail + RECORD_HEADER_WORDS + words) & 0xFFFFFFFF
+
+    if dropped:
+        print("%u records dropped" % dropped)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("usage: %s <application.elf> <TraceRing dump>\n" % argv[0])
+        return 1
+    with open(argv[2], "rb") as f:
+        dump = f.read()
+    decode(Elf(argv[1]), dump)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,310 @@
+/**
+ * \file trace.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Deferred binary trace logger
+ *
+ * The ring is indexed by free running word counters. A writer reserves the
+ * words of its record by advancing Head, fills them and commits the record by
+ * writing the header word last. The reader stops at the first header still
+ * being 0, clears the words it consumed and advances Tail. On ARMv7-M the
+ * reservation is a compare and swap loop, on ARMv6-M (no exclusive access
+ * instructions) it is done with the interrupts disabled for a few cycles.
+ *
+ * Record layout [32 bit words]:
+ *  0: TRACE_RECORD_MAGIC << 24 | flags << 16 | number of data words
+ *  1: timestamp
+ *  2: format string address, hex dump size for TRACE_FLAG_HEX
+ *  3: arguments or hex dump bytes (little endian)
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdarg.h>
+#include "board.h"
+#include "debug.h"
+#include "trace.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define TRACE_BUFFER_MASK                           (TRACE_BUFFER_WORDS - 1)
+#define TRACE_RECORD_MAGIC                          0xA5
+
+#define TRACE_HEADER(flags, words)                  (((uint32_t) TRACE_RECORD_MAGIC << 24) \
+                                                        | ((uint32_t)(flags) << 16) | (words))
+#define TRACE_HEADER_FLAGS(header)                  ((uint8_t)((header) >> 16))
+#define TRACE_HEADER_WORDS(header)                  ((uint8_t)(header))
+
+#if defined(USE_FREE_RTOS)
+/*! Trace task, prints the records */
+#define TRACE_TASK_STACK_SIZE                       (configMINIMAL_STACK_SIZE + 100)
+#define TRACE_TASK_PRIO                             (tskIDLE_PRIORITY)
+
+/*! Time between two flushes of the ring [ms] */
+#define TRACE_TASK_INTERVAL                         50
+#endif /* USE_FREE_RTOS */
+
+#if (TRACE_BUFFER_WORDS & TRACE_BUFFER_MASK) != 0
+#error "TRACE_BUFFER_WORDS has to be a power of 2"
+#endif
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Record ring, read out by the host tools as a whole */
+typedef struct TraceRing_s {
+    volatile uint32_t Head;         //! Words reserved by the writers
+    volatile uint32_t Tail;         //! Words consumed by the reader
+    volatile uint32_t Dropped;      //! Records dropped, ring full
+    volatile uint32_t Buffer[TRACE_BUFFER_WORDS];
+} TraceRing_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static TraceRing_t TraceRing;
+
+/*! Dropped counter at the last flush */
+static uint32_t FlushDropped;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool Reserve( uint32_t words, uint32_t *head );
+static void Commit( uint32_t head, uint8_t flags, uint32_t words );
+static void PrintRecord( const TraceRecord_t *record );
+#if defined(USE_FREE_RTOS)
+static void TraceTask( void *pvParameters );
+#endif /* USE_FREE_RTOS */
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void TraceInit( void )
+{
+    memset1((uint8_t*) &TraceRing, 0, sizeof(TraceRing));
+    FlushDropped = 0;
+
+#if defined(USE_FREE_RTOS)
+    if ( xTaskCreate(TraceTask, "Trace", TRACE_TASK_STACK_SIZE, (void*) NULL, TRACE_TASK_PRIO,
+            (xTaskHandle*) NULL) != pdPASS ) {
+        /*lint -e527 */
+        for ( ;; ) {
+        }; /* error! probably out of memory */
+        /*lint +e527 */
+    }
+#endif /* USE_FREE_RTOS */
+}
+
+void TraceWrite( uint8_t flags, const char *fmt, uint8_t nbArgs, ... )
+{
+    va_list ap;
+    uint32_t head;
+
+    if ( nbArgs > TRACE_MAX_ARGS ) {
+        nbArgs = TRACE_MAX_ARGS;
+    }
+    if ( !Reserve(TRACE_RECORD_HEADER_WORDS + nbArgs, &head) ) {
+        return;
+    }
+
+    TraceRing.Buffer[(head + 1) & TRACE_BUFFER_MASK] = (uint32_t) TimerGetCurrentTime();
+    TraceRing.Buffer[(head + 2) & TRACE_BUFFER_MASK] = (uint32_t) fmt;
+    va_start(ap, nbArgs);
+    for ( uint8_t i = 0; i < nbArgs; i++ ) {
+        TraceRing.Buffer[(head + TRACE_RECORD_HEADER_WORDS + i) & TRACE_BUFFER_MASK] = va_arg(ap,
+                uint32_t);
+    }
+    va_end(ap);
+
+    Commit(head, flags & ~TRACE_FLAG_HEX, nbArgs);
+}
+
+void TraceWriteBuffer( uint8_t flags, const void *data, size_t size )
+{
+    const uint8_t *bytes = (const uint8_t*) data;
+    uint32_t head, word;
+    uint8_t words;
+
+    if ( size > TRACE_MAX_HEX_BYTES ) {
+        size = TRACE_MAX_HEX_BYTES;
+    }
+    words = (uint8_t)((size + 3) / 4);
+    if ( !Reserve(TRACE_RECORD_HEADER_WORDS + words, &head) ) {
+        return;
+    }
+
+    TraceRing.Buffer[(head + 1) & TRACE_BUFFER_MASK] = (uint32_t) TimerGetCurrentTime();
+    TraceRing.Buffer[(head + 2) & TRACE_BUFFER_MASK] = (uint32_t) size;
+    for ( uint8_t i = 0; i < words; i++ ) {
+        word = 0;
+        for ( uint8_t j = 0; (j < 4) && ((4 * i + j) < size); j++ ) {
+            word |= (uint32_t) bytes[4 * i + j] << (8 * j);
+        }
+        TraceRing.Buffer[(head + TRACE_RECORD_HEADER_WORDS + i) & TRACE_BUFFER_MASK] = word;
+    }
+
+    Commit(head, flags | TRACE_FLAG_HEX, words);
+}
+
+bool TraceReadRecord( TraceRecord_t *record )
+{
+    uint32_t tail = TraceRing.Tail;
+    uint32_t header, words;
+
+    if ( tail == TraceRing.Head ) {
+        return false;
+    }
+    header = TraceRing.Buffer[tail & TRACE_BUFFER_MASK];
+    if ( header == 0 ) {
+        return false; /* reserved, but not committed yet */
+    }
+    /* The header is written last, the rest of the record is valid now */
+    __sync_synchronize();
+
+    words = TRACE_HEADER_WORDS(header);
+    if ( words > (TRACE_MAX_RECORD_WORDS - TRACE_RECORD_HEADER_WORDS) ) {
+        words = TRACE_MAX_RECORD_WORDS - TRACE_RECORD_HEADER_WORDS;
+    }
+    record->Flags = TRACE_HEADER_FLAGS(header);
+    record->NbWords = (uint8_t) words;
+    record->Timestamp = TraceRing.Buffer[(tail + 1) & TRACE_BUFFER_MASK];
+    record->Value = TraceRing.Buffer[(tail + 2) & TRACE_BUFFER_MASK];
+    for ( uint8_t i = 0; i < words; i++ ) {
+        record->Data[i] = TraceRing.Buffer[(tail + TRACE_RECORD_HEADER_WORDS + i)
+                & TRACE_BUFFER_MASK];
+    }
+
+    /* Headers have to read 0 until the next writer commits them */
+    words = TRACE_RECORD_HEADER_WORDS + TRACE_HEADER_WORDS(header);
+    for ( uint32_t i = 0; i < words; i++ ) {
+        TraceRing.Buffer[(tail + i) & TRACE_BUFFER_MASK] = 0;
+    }
+    __sync_synchronize();
+    TraceRing.Tail = tail + words;
+    return true;
+}
+
+void TraceFlush( void )
+{
+    TraceRecord_t record;
+    uint32_t dropped;
+
+    while ( TraceReadRecord(&record) ) {
+        PrintRecord(&record);
+    }
+
+    dropped = TraceRing.Dropped;
+    if ( dropped != FlushDropped ) {
+        debug_printf("TRACE: %u records dropped\r\n", (unsigned int)(dropped - FlushDropped));
+        FlushDropped = dropped;
+    }
+}
+
+uint32_t TraceGetDropped( void )
+{
+    return TraceRing.Dropped;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*!
+ * \brief Reserves the words of a record.
+ *
+ * \param words Record size [32 bit words].
+ * \param head Index of the first word reserved.
+ * \retval False if the ring is full, the record is counted as dropped.
+ */
+static bool Reserve( uint32_t words, uint32_t *head )
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    uint32_t current;
+
+    do {
+        current = TraceRing.Head;
+        if ( (current + words - TraceRing.Tail) > TRACE_BUFFER_WORDS ) {
+            __sync_fetch_and_add(&TraceRing.Dropped, 1);
+            return false;
+        }
+    } while ( !__sync_bool_compare_and_swap(&TraceRing.Head, current, current + words) );
+
+    *head = current;
+    return true;
+#else
+    bool reserved = false;
+    uint32_t primask = __get_PRIMASK();
+
+    /* May be called with interrupts already masked, keep them masked */
+    __disable_irq();
+    if ( (TraceRing.Head + words - TraceRing.Tail) > TRACE_BUFFER_WORDS ) {
+        TraceRing.Dropped++;
+    } else {
+        *head = TraceRing.Head;
+        TraceRing.Head += words;
+        reserved = true;
+    }
+    __set_PRIMASK(primask);
+    return reserved;
+#endif
+}
+
+/*!
+ * \brief Publishes a filled record to the reader.
+ */
+static void Commit( uint32_t head, uint8_t flags, uint32_t words )
+{
+    __sync_synchronize();
+    TraceRing.Buffer[head & TRACE_BUFFER_MASK] = TRACE_HEADER(flags, words);
+}
+
+static void PrintRecord( const TraceRecord_t *record )
+{
+    const uint32_t *a = record->Data;
+
+    if ( (record->Flags & TRACE_FLAG_BARE) == 0 ) {
+        switch ( record->Flags & TRACE_LEVEL_MASK ) {
+            case TRACE_LEVEL_TRACE:
+                debug_printf("TRACE: ");
+                break;
+            case TRACE_LEVEL_DEBUG:
+                debug_printf("DEBUG: ");
+                break;
+            default:
+                debug_printf(KRED "ERROR: ");
+                break;
+        }
+    }
+
+    if ( record->Flags & TRACE_FLAG_HEX ) {
+        debug_printf("\t");
+        for ( uint32_t i = 0; i < record->Value; i++ ) {
+            debug_printf("0x%02x ", (unsigned int)((a[i / 4] >> (8 * (i % 4))) & 0xFF));
+        }
+    } else {
+        /* Unused trailing arguments are ignored by the formatter */
+        debug_printf((const char*) record->Value, a[0], a[1], a[2], a[3], a[4], a[5], a[6],
+                a[7]);
+    }
+
+    if ( ((record->Flags & TRACE_FLAG_BARE) == 0) || (record->Flags & TRACE_FLAG_HEX) ) {
+        if ( (record->Flags & TRACE_LEVEL_MASK) == TRACE_LEVEL_ERROR ) {
+            debug_printf(KNRM);
+        }
+        debug_printf("\r\n");
+    }
+}
+
+#if defined(USE_FREE_RTOS)
+static void TraceTask( void *pvParameters )
+{
+    (void) pvParameters; /* not used */
+
+    for ( ;; ) {
+        TraceFlush();
+        vTaskDelay(TRACE_TASK_INTERVAL / portTICK_RATE_MS);
+    }
+}
+#endif /* USE_FREE_RTOS */
@@ -0,0 +1,126 @@
+/**
+ * \file trace.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Deferred binary trace logger
+ *
+ * A log call only stores a compact record into a RAM ring: header, timestamp,
+ * address of the format string and the raw 32 bit arguments. Nothing is
+ * formatted at the call site, so the logger may be used from interrupt
+ * context and in timing critical paths. The records are printed later by
+ * TraceFlush (trace task with FreeRTOS) or read out of the ring by a debugger
+ * and decoded on the host with trace-decoder.py and the application ELF.
+ *
+ * Restrictions of the deferred arguments:
+ * - Only 32 bit arguments are supported (integers, characters, pointers).
+ * - A %s argument has to point to a string with static storage duration
+ *   (string literal, __FUNCTION__), only its address is stored.
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Size of the record ring [32 bit words], has to be a power of 2 */
+#ifndef TRACE_BUFFER_WORDS
+#define TRACE_BUFFER_WORDS                          256
+#endif
+
+/*! Maximum number of arguments of a record */
+#define TRACE_MAX_ARGS                              8
+
+/*! Maximum number of bytes of a hex dump record */
+#define TRACE_MAX_HEX_BYTES                         64
+
+/*! Record words in addition to the arguments (header, timestamp, format) */
+#define TRACE_RECORD_HEADER_WORDS                   3
+
+/*! Largest record [32 bit words] */
+#define TRACE_MAX_RECORD_WORDS                      (TRACE_RECORD_HEADER_WORDS \
+                                                        + (TRACE_MAX_HEX_BYTES / 4))
+
+/*! Record flags, the level is stored in the lowest two bits */
+#define TRACE_LEVEL_TRACE                           0x00
+#define TRACE_LEVEL_DEBUG                           0x01
+#define TRACE_LEVEL_ERROR                           0x02
+#define TRACE_LEVEL_MASK                            0x03
+#define TRACE_FLAG_BARE                             0x04    //! No prefix and line end
+#define TRACE_FLAG_HEX                              0x08    //! Hex dump of raw bytes
+
+/*******************************************************************************
+ * MACRO DEFINITIONS
+ ******************************************************************************/
+/*! Number of arguments of a variadic macro call [0 .. 8] */
+#define TRACE_NARGS(...)                            TRACE_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define TRACE_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)    n
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Record read from the ring */
+typedef struct TraceRecord_s {
+    uint8_t Flags;                  //! TRACE_LEVEL_x | TRACE_FLAG_x
+    uint8_t NbWords;                //! Valid words in Data
+    uint32_t Timestamp;             //! TimerGetCurrentTime() at the log call
+    uint32_t Value;                 //! Format string address or hex dump size [bytes]
+    uint32_t Data[TRACE_MAX_RECORD_WORDS - TRACE_RECORD_HEADER_WORDS]; //! Arguments or bytes
+} TraceRecord_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears the ring and, with FreeRTOS, starts the trace task printing
+ *        the records.
+ */
+void TraceInit( void );
+
+/*!
+ * \brief Stores a formatted log record, may be called from any context.
+ *
+ * \param flags Record flags.
+ * \param fmt Format string with static storage duration.
+ * \param nbArgs Number of 32 bit arguments following.
+ */
+void TraceWrite( uint8_t flags, const char *fmt, uint8_t nbArgs, ... );
+
+/*!
+ * \brief Stores a hex dump record, may be called from any context.
+ *
+ * \param flags Record flags.
+ * \param data Bytes to dump, truncated to TRACE_MAX_HEX_BYTES.
+ * \param size Number of bytes.
+ */
+void TraceWriteBuffer( uint8_t flags, const void *data, size_t size );
+
+/*!
+ * \brief Removes the oldest complete record from the ring.
+ *
+ * \remark Only one reader at a time is supported.
+ *
+ * \param record Record read.
+ * \retval True if a record has been read.
+ */
+bool TraceReadRecord( TraceRecord_t *record );
+
+/*!
+ * \brief Prints all pending records with debug_printf.
+ *
+ * \remark Call it from the lowest priority context only.
+ */
+void TraceFlush( void );
+
+/*!
+ * \brief Returns the number of records dropped because the ring was full.
+ */
+uint32_t TraceGetDropped( void );
+
+#endif // __TRACE_H__
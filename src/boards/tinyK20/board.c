@@ -114,6 +114,9 @@ void BoardInitMcu( void )
                 NO_FLOW_CTRL);
 #endif
         DbgConsole_Init(&Uart1);
+#if defined(LOG_DEFERRED)
+        TraceInit();
+#endif /* LOG_DEFERRED */
         TimerSetLowPowerEnable(false);
 #elif( LOW_POWER_MODE_ENABLE )
         TimerSetLowPowerEnable(true);
@@ -128,6 +131,9 @@ void BoardInitMcu( void )
         } else {
             TimerHwInit();
         }
+#else
+        /* Precise timer backend, coarse timers use the FreeRTOS timer task */
+        TimerHwInit();
 #endif /* USE_FREE_RTOS */
 
         McuInitialized = true;
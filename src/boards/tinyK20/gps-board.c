@@ -10,10 +10,6 @@
  * INCLUDE FILES
  ******************************************************************************/
 #include "board.h"
-#include <string.h>
-
-#define LOG_LEVEL_NONE
-#include "debug.h"
 
 /*******************************************************************************
  * PRIVATE CONSTANT DEFINITIONS
@@ -21,8 +17,14 @@
 /*! FIFO buffers size */
 #define GPS_FIFO_RX_SIZE                                128
 
-/*! Maximum NMEA message length */
-#define NMEA_MAX_MESSAGE_LENGTH                         128
+#if defined(USE_FREE_RTOS)
+/*! GPS task, parses the received NMEA data */
+#define GPS_TASK_STACK_SIZE                             configMINIMAL_STACK_SIZE
+#define GPS_TASK_PRIO                                   (tskIDLE_PRIORITY + 1)
+
+/*! Time to collect more bytes after the first one woke the task up [ms] */
+#define GPS_TASK_COLLECT_TIME                           20
+#endif /* USE_FREE_RTOS */
 
 /*! Nmea configuration strings */
 //const char psrf_100[] = "$PSRF100,1,19200,8,1,0*38"; /* Set Serial Port */
@@ -37,13 +39,18 @@
 /*! FIFO buffers */
 static uint8_t Gps_RxBuffer[GPS_FIFO_RX_SIZE];
 
-/*! Nmea string */
-static char NmeaString[NMEA_MAX_MESSAGE_LENGTH];
-static uint8_t NmeaStringLength = 0;
+#if defined(USE_FREE_RTOS)
+/*! GPS task handle, notified by the UART receive interrupt */
+static xTaskHandle GpsTaskHandle = NULL;
+#endif /* USE_FREE_RTOS */
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+#if defined(USE_FREE_RTOS)
+static void GpsTask( void *pvParameters );
+#endif /* USE_FREE_RTOS */
 
-/*! */
-static bool rmcMsgParsed;
-static bool ggaMsgParsed;
 /*******************************************************************************
  * MODULE FUNCTIONS (PUBLIC)
  ******************************************************************************/
@@ -60,8 +67,6 @@ void GpsMcuOnPpsSignal( void )
 
 void GpsMcuInit( void )
 {
-    NmeaStringLength = 0;
-
     FifoInit(&Uart0.FifoRx, Gps_RxBuffer, GPS_FIFO_RX_SIZE);
     Uart0.IrqNotify = GpsMcuIrqNotify;
 
@@ -79,41 +84,49 @@ void GpsMcuInit( void )
     GpioInit(&GpsPps, PPS, PIN_INPUT, PIN_PUSH_PULL, PIN_NO_PULL, 1);
     GpioSetInterrupt(&GpsPps, IRQ_RISING_EDGE, IRQ_VERY_LOW_PRIORITY, &GpsMcuOnPpsSignal);
 
-    rmcMsgParsed = false;
-    ggaMsgParsed = false;
+#if defined(USE_FREE_RTOS)
+    if ( xTaskCreate(GpsTask, "Gps", GPS_TASK_STACK_SIZE, (void*) NULL, GPS_TASK_PRIO,
+            &GpsTaskHandle) != pdPASS ) {
+        /*lint -e527 */
+        for ( ;; ) {
+        }; /* error! probably out of memory */
+        /*lint +e527 */
+    }
+#endif /* USE_FREE_RTOS */
+}
+
+void GpsMcuProcess( void )
+{
+    if ( GpsProcessFifo(&Uart0.FifoRx) == true ) {
+        UartEnableReceiver(&Uart0, false);
+    }
 }
 
 void GpsMcuIrqNotify( UartNotifyId_t id )
 {
-    uint8_t data;
-    if ( id == UART_NOTIFY_RX ) {
-        while ( UartGetChar(&Uart0, &data) != ERR_RXEMPTY ) {
-            if ( (data == '$') || (NmeaStringLength >= NMEA_MAX_MESSAGE_LENGTH) ) {
-                NmeaStringLength = 0;
-            }
-//            LOG_TRACE_BARE("%c", (char) data);
-            NmeaString[NmeaStringLength++] = (int8_t) data;
-
-            if ( data == '\n' ) {
-                NmeaString[NmeaStringLength] = '\0';
-                if ( !ggaMsgParsed && strncmp(NmeaString, (const char*) "$GPGGA", 6) == 0 ) {
-                    if ( GpsParseGpsData(NmeaString, NmeaStringLength) == SUCCESS ) {
-                        rmcMsgParsed = false;
-                        ggaMsgParsed = true;
-                        UartEnableReceiver(&Uart0, false);
-                        BlockLowPowerDuringTask(false);
-                        LOG_TRACE_BARE("NMEA: %s", NmeaString);
-                    }
-                } else if ( !rmcMsgParsed && strncmp(NmeaString, (const char*) "$GPRMC", 6) == 0 ) {
-                    if ( GpsParseGpsData(NmeaString, NmeaStringLength) == SUCCESS ) {
-                        rmcMsgParsed = true;
-                        ggaMsgParsed = false;
-                        UartEnableReceiver(&Uart0, false);
-                        BlockLowPowerDuringTask(false);
-                        LOG_TRACE_BARE("NMEA: %s", NmeaString);
-                    }
-                }
-            }
-        }
+#if defined(USE_FREE_RTOS)
+    portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+    /* The byte is already in the FIFO, the GPS task parses it */
+    if ( (id == UART_NOTIFY_RX) && (GpsTaskHandle != NULL) ) {
+        vTaskNotifyGiveFromISR(GpsTaskHandle, &xHigherPriorityTaskWoken);
+        portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+    }
+#endif /* USE_FREE_RTOS */
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+#if defined(USE_FREE_RTOS)
+static void GpsTask( void *pvParameters )
+{
+    (void) pvParameters; /* not used */
+
+    for ( ;; ) {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(GPS_TASK_COLLECT_TIME / portTICK_RATE_MS);
+        GpsMcuProcess();
     }
 }
+#endif /* USE_FREE_RTOS */
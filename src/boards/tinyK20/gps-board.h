@@ -28,7 +28,13 @@ void GpsMcuOnPpsSignal( void );
 void GpsMcuInit( void );
 
 /*!
- * \brief IRQ handler for the UART receiver
+ * \brief Parses the received NMEA data and disables the receiver once the
+ *        position has been updated, never called from interrupt context
+ */
+void GpsMcuProcess( void );
+
+/*!
+ * \brief IRQ handler for the UART receiver, only signals the received data
  */
 void GpsMcuIrqNotify( UartNotifyId_t id );
 
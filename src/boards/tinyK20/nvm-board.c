@@ -0,0 +1,124 @@
+/**
+ * \file nvm-board.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Target board non-volatile memory driver (FlexNVM data flash)
+ *
+ * The NVM area occupies the first sectors of the FlexNVM block, which is
+ * mapped at 0x10000000. Programming the FlexNVM does not stall the code
+ * executing from the program flash, no RAM function is required.
+ */
+
+#include "board.h"
+#include "nvm-board.h"
+
+/*----------------------- Local Definitions ------------------------------*/
+/*!
+ * FlexNVM base address for read accesses
+ */
+#define NVM_MCU_READ_BASE                           0x10000000u
+
+/*!
+ * FlexNVM base address of the flash commands
+ */
+#define NVM_MCU_CMD_BASE                            0x00800000u
+
+/*!
+ * Flash memory module commands
+ */
+#define FTFL_CMD_PROGRAM_LONGWORD                   0x06
+#define FTFL_CMD_ERASE_SECTOR                       0x09
+
+/*!
+ * Flash command error flags
+ */
+#define FTFL_FSTAT_ERRORS                           (FTFL_FSTAT_RDCOLERR_MASK | FTFL_FSTAT_ACCERR_MASK \
+                                                        | FTFL_FSTAT_FPVIOL_MASK | FTFL_FSTAT_MGSTAT0_MASK)
+
+/*------------------------ Local Functions -------------------------------*/
+static uint8_t NvmMcuCommand( uint8_t cmd, uint32_t offset, const uint8_t *data );
+
+uint8_t NvmMcuInit( void )
+{
+    uint8_t depart = (SIM_FCFG1 & SIM_FCFG1_DEPART_MASK) >> SIM_FCFG1_DEPART_SHIFT;
+
+    /* DEPART 0x0 (partitioned) and 0xF (factory state) leave the whole FlexNVM as data flash */
+    if ( (depart != 0x0) && (depart != 0xF) ) {
+        return FAIL;
+    }
+    return SUCCESS;
+}
+
+uint8_t NvmMcuRead( uint32_t offset, uint8_t *buffer, uint16_t size )
+{
+    if ( (offset + size) > (NVM_MCU_SECTOR_SIZE * NVM_MCU_NB_SECTORS) ) {
+        return FAIL;
+    }
+    memcpy1(buffer, (uint8_t*)(NVM_MCU_READ_BASE + offset), size);
+    return SUCCESS;
+}
+
+uint8_t NvmMcuWrite( uint32_t offset, const uint8_t *buffer, uint16_t size )
+{
+    if ( ((offset | size) & (NVM_MCU_WRITE_UNIT - 1)) != 0
+            || (offset + size) > (NVM_MCU_SECTOR_SIZE * NVM_MCU_NB_SECTORS) ) {
+        return FAIL;
+    }
+
+    for ( uint16_t i = 0; i < size; i += NVM_MCU_WRITE_UNIT ) {
+        if ( NvmMcuCommand(FTFL_CMD_PROGRAM_LONGWORD, offset + i, &buffer[i]) == FAIL ) {
+            return FAIL;
+        }
+    }
+
+    /* Verify, a torn or disturbed write must not go unnoticed */
+    if ( memcmp((const void*)(NVM_MCU_READ_BASE + offset), buffer, size) != 0 ) {
+        return FAIL;
+    }
+    return SUCCESS;
+}
+
+uint8_t NvmMcuEraseSector( uint32_t offset )
+{
+    if ( (offset % NVM_MCU_SECTOR_SIZE) != 0
+            || offset >= (NVM_MCU_SECTOR_SIZE * NVM_MCU_NB_SECTORS) ) {
+        return FAIL;
+    }
+    return NvmMcuCommand(FTFL_CMD_ERASE_SECTOR, offset, NULL);
+}
+
+/*!
+ * \brief Launches a flash command and waits for its completion
+ *
+ * \param [IN] cmd Flash command
+ * \param [IN] offset Offset from the start of the FlexNVM
+ * \param [IN] data Longword to program, NULL for an erase
+ * \retval status [SUCCESS, FAIL]
+ */
+static uint8_t NvmMcuCommand( uint8_t cmd, uint32_t offset, const uint8_t *data )
+{
+    uint32_t address = NVM_MCU_CMD_BASE + offset;
+
+    while ( (FTFL_FSTAT & FTFL_FSTAT_CCIF_MASK) == 0 ) {
+    }
+    /* Clear the error flags of the previous command */
+    FTFL_FSTAT = FTFL_FSTAT_RDCOLERR_MASK | FTFL_FSTAT_ACCERR_MASK | FTFL_FSTAT_FPVIOL_MASK;
+
+    FTFL_FCCOB0 = cmd;
+    FTFL_FCCOB1 = (uint8_t)(address >> 16);
+    FTFL_FCCOB2 = (uint8_t)(address >> 8);
+    FTFL_FCCOB3 = (uint8_t) address;
+    if ( data != NULL ) {
+        /* FCCOB4 holds the most significant byte of the little endian longword */
+        FTFL_FCCOB4 = data[3];
+        FTFL_FCCOB5 = data[2];
+        FTFL_FCCOB6 = data[1];
+        FTFL_FCCOB7 = data[0];
+    }
+
+    FTFL_FSTAT = FTFL_FSTAT_CCIF_MASK;
+    while ( (FTFL_FSTAT & FTFL_FSTAT_CCIF_MASK) == 0 ) {
+    }
+
+    return ((FTFL_FSTAT & FTFL_FSTAT_ERRORS) == 0) ? SUCCESS : FAIL;
+}
@@ -0,0 +1,63 @@
+/**
+ * \file nvm-board.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Target board non-volatile memory driver (FlexNVM data flash)
+ *
+ */
+
+#ifndef __NVM_BOARD_H_
+#define __NVM_BOARD_H_
+
+/*!
+ * Erase unit of the data flash [bytes]
+ */
+#define NVM_MCU_SECTOR_SIZE                         1024
+
+/*!
+ * Number of data flash sectors used by the NVM store
+ */
+#define NVM_MCU_NB_SECTORS                          4
+
+/*!
+ * Programming unit of the data flash [bytes]
+ */
+#define NVM_MCU_WRITE_UNIT                          4
+
+/*!
+ * \brief Checks the FlexNVM partitioning of the device
+ *
+ * \retval status [SUCCESS, FAIL] FAIL if the data flash is too small
+ */
+uint8_t NvmMcuInit( void );
+
+/*!
+ * \brief Reads from the data flash
+ *
+ * \param [IN] offset Offset from the start of the NVM area
+ * \param [OUT] buffer Data read
+ * \param [IN] size Number of bytes to read
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuRead( uint32_t offset, uint8_t *buffer, uint16_t size );
+
+/*!
+ * \brief Programs erased data flash and verifies it
+ *
+ * \param [IN] offset Offset from the start of the NVM area, multiple of
+ *                    NVM_MCU_WRITE_UNIT
+ * \param [IN] buffer Data to program
+ * \param [IN] size Number of bytes, multiple of NVM_MCU_WRITE_UNIT
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuWrite( uint32_t offset, const uint8_t *buffer, uint16_t size );
+
+/*!
+ * \brief Erases a data flash sector, all its bytes read 0xFF afterwards
+ *
+ * \param [IN] offset Offset of the sector from the start of the NVM area
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t NvmMcuEraseSector( uint32_t offset );
+
+#endif /* __NVM_BOARD_H_ */
@@ -21,6 +21,62 @@ typedef enum {
     SPI_0 = (uint32_t) SPI0_BASE_PTR
 } SPIName;
 
+/*! eDMA channel writing the Tx bytes to PUSHR */
+#define SPI_DMA_TX_CHANNEL              0
+/*! eDMA channel reading the Rx bytes from POPR, higher priority than Tx */
+#define SPI_DMA_RX_CHANNEL              1
+/*! DMAMUX request sources of the SPI0 Tx and Rx FIFOs */
+#define SPI_DMA_TX_SOURCE               15
+#define SPI_DMA_RX_SOURCE               14
+/*! DMA interrupt priority, has to be within the FreeRTOS syscall range */
+#define SPI_DMA_ISR_PRIOR               configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/*------------------------ Local Variables -------------------------------*/
+/*! SPI object of the running DMA transfer, NULL when idle */
+static Spi_t * volatile SpiDmaObj = NULL;
+/*! Completion callback of the running DMA transfer */
+static void (*SpiDmaCallback)( Spi_t *obj ) = NULL;
+/*! Source of the Tx bytes when no Tx buffer is given */
+static const uint8_t SpiDmaTxDummy = 0x00;
+/*! Destination of the Rx bytes when no Rx buffer is given */
+static uint8_t SpiDmaRxDummy;
+
+/*------------------------ Local Functions -------------------------------*/
+/*!
+ * \brief Clocks the eDMA and routes the SPI0 requests to the Tx/Rx channels.
+ */
+static void SpiDmaInit( void )
+{
+    SIM_SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;
+
+    DMA_CERQ = DMA_CERQ_CERQ(SPI_DMA_TX_CHANNEL);
+    DMA_CERQ = DMA_CERQ_CERQ(SPI_DMA_RX_CHANNEL);
+
+    DMAMUX_CHCFG(SPI_DMA_TX_CHANNEL) = 0u;
+    DMAMUX_CHCFG(SPI_DMA_TX_CHANNEL) = DMAMUX_CHCFG_ENBL_MASK
+            | DMAMUX_CHCFG_SOURCE(SPI_DMA_TX_SOURCE);
+    DMAMUX_CHCFG(SPI_DMA_RX_CHANNEL) = 0u;
+    DMAMUX_CHCFG(SPI_DMA_RX_CHANNEL) = DMAMUX_CHCFG_ENBL_MASK
+            | DMAMUX_CHCFG_SOURCE(SPI_DMA_RX_SOURCE);
+
+    /* Set interrupt priority and enable interrupt */
+    NVIC_BASE_PTR->IP[DMA1_IRQn] = SPI_DMA_ISR_PRIOR;
+    NVIC_BASE_PTR->ISER[(((uint32_t)(int32_t) DMA1_IRQn) >> 5UL)] =
+            (uint32_t)(1UL << (((uint32_t)(int32_t) DMA1_IRQn) & 0x1FUL));
+}
+
+/*!
+ * \brief Ends the running DMA transfer.
+ */
+static void SpiDmaComplete( Spi_t *obj )
+{
+    obj->Spi->RSER = 0;
+    DMA_CDNE = DMA_CDNE_CDNE(SPI_DMA_TX_CHANNEL);
+    DMA_CDNE = DMA_CDNE_CDNE(SPI_DMA_RX_CHANNEL);
+    SpiDmaObj = NULL;
+}
+
 void SpiInit(Spi_t *obj, PinNames mosi, PinNames miso, PinNames sclk, PinNames nss)
 {
     /* Check if a proper channel was selected */
@@ -76,6 +132,8 @@ void SpiInit(Spi_t *obj, PinNames mosi, PinNames miso, PinNames sclk, PinNames n
 
     /* Enable DSPI module */
     obj->Spi->MCR &= ~(SPI_MCR_MDIS_MASK);
+
+    SpiDmaInit();
 }
 
 void SpiDeInit(Spi_t *obj)
@@ -244,3 +302,100 @@ uint16_t SpiInOut(Spi_t *obj, uint16_t outData)
     return data;
 }
 
+uint8_t SpiMcuTransfer(Spi_t *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)(Spi_t *obj))
+{
+    uint32_t cmd;
+
+    if ((obj == NULL) || (obj->Spi) == NULL) {
+        LOG_ERROR("Spi object has not been initialized.");
+        while (1)
+            ;
+    }
+    if (obj->isSlave) {
+        LOG_ERROR("Slave transfer has not yet been implemented.");
+        return 1;
+    }
+    if (SpiDmaObj != NULL) {
+        return 1;   // Busy
+    }
+    if (size == 0) {
+        if (callback != NULL) {
+            callback(obj);
+        }
+        return 0;
+    }
+    SpiDmaObj = obj;
+    SpiDmaCallback = callback;
+
+    /* Restart the transfer once per burst instead of once per byte */
+    obj->Spi->MCR |= SPI_MCR_HALT_MASK;
+    obj->Spi->MCR |= (SPI_MCR_CLR_RXF_MASK | SPI_MCR_CLR_TXF_MASK);
+    obj->Spi->SR |= (SPI_SR_TCF_MASK | SPI_SR_EOQF_MASK | SPI_SR_TFUF_MASK | SPI_SR_TFFF_MASK
+            | SPI_SR_RFOF_MASK | SPI_SR_RFDF_MASK);
+    obj->Spi->TCR = 0u;
+    obj->Spi->MCR &= ~(SPI_MCR_HALT_MASK);
+
+    /* Rx channel: POPR to the Rx buffer, one byte per request */
+    DMA_TCD1_SADDR = (uint32_t) &obj->Spi->POPR;
+    DMA_TCD1_SOFF = 0;
+    DMA_TCD1_ATTR = DMA_ATTR_SSIZE(0) | DMA_ATTR_DSIZE(0);
+    DMA_TCD1_NBYTES_MLNO = 1;
+    DMA_TCD1_SLAST = 0;
+    DMA_TCD1_DADDR = (uint32_t)((rx != NULL) ? rx : &SpiDmaRxDummy);
+    DMA_TCD1_DOFF = (rx != NULL) ? 1 : 0;
+    DMA_TCD1_CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(size);
+    DMA_TCD1_BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(size);
+    DMA_TCD1_DLASTSGA = 0;
+    DMA_TCD1_CSR = DMA_CSR_DREQ_MASK | ((callback != NULL) ? DMA_CSR_INTMAJOR_MASK : 0);
+    DMA_SERQ = DMA_SERQ_SERQ(SPI_DMA_RX_CHANNEL);
+
+    /* Tx channel: the remaining bytes to the TXDATA half of PUSHR, the command
+     * half keeps the value of the first 32 bits write below */
+    if (size > 1) {
+        DMA_TCD0_SADDR = (uint32_t)((tx != NULL) ? (tx + 1) : &SpiDmaTxDummy);
+        DMA_TCD0_SOFF = (tx != NULL) ? 1 : 0;
+        DMA_TCD0_ATTR = DMA_ATTR_SSIZE(0) | DMA_ATTR_DSIZE(0);
+        DMA_TCD0_NBYTES_MLNO = 1;
+        DMA_TCD0_SLAST = 0;
+        DMA_TCD0_DADDR = (uint32_t) &obj->Spi->PUSHR;
+        DMA_TCD0_DOFF = 0;
+        DMA_TCD0_CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(size - 1);
+        DMA_TCD0_BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(size - 1);
+        DMA_TCD0_DLASTSGA = 0;
+        DMA_TCD0_CSR = DMA_CSR_DREQ_MASK;
+        DMA_SERQ = DMA_SERQ_SERQ(SPI_DMA_TX_CHANNEL);
+    }
+
+    /* First frame with the command: Ctar0, Pcs0, clear transfer count */
+    cmd = (SPI_PUSHR_PCS(1)) | ((uint32_t)(1) << SPI_PUSHR_CTCNT_SHIFT);
+    obj->Spi->PUSHR = cmd | ((tx != NULL) ? tx[0] : 0x00);
+
+    /* Hand the Rx drain and Tx fill requests over to the eDMA */
+    obj->Spi->RSER = SPI_RSER_RFDF_RE_MASK | SPI_RSER_RFDF_DIRS_MASK
+            | ((size > 1) ? (SPI_RSER_TFFF_RE_MASK | SPI_RSER_TFFF_DIRS_MASK) : 0);
+
+    if (callback == NULL) {
+        /* Every byte has been received once the Rx major loop is done */
+        while ((DMA_TCD1_CSR & DMA_CSR_DONE_MASK) == 0) {
+        }
+        SpiDmaComplete(obj);
+    }
+    return 0;
+}
+
+/*!
+ * \brief SPI Rx DMA channel major loop complete interrupt handler.
+ */
+void DMA1_IRQHandler( void )
+{
+    Spi_t *obj = SpiDmaObj;
+
+    DMA_CINT = DMA_CINT_CINT(SPI_DMA_RX_CHANNEL);
+    if (obj != NULL) {
+        SpiDmaComplete(obj);
+        if (SpiDmaCallback != NULL) {
+            SpiDmaCallback(obj);
+        }
+    }
+}
@@ -9,6 +9,11 @@
 #ifndef __SPI_MCU_H__
 #define __SPI_MCU_H__
 
+/*!
+ * The board implements SpiMcuTransfer, used by SpiTransfer
+ */
+#define SPI_MCU_TRANSFER
+
 /* Defines constant value arrays for the baud rate pre-scalar and scalar divider values.*/
 static const uint32_t s_baudratePrescaler[] = { 2, 3, 5, 7 };
 static const uint32_t s_baudrateScaler[] = { 2, 4, 6, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
@@ -31,4 +36,17 @@ struct Spi_s {
     Gpio_t Nss;
 };
 
+/*!
+ * \brief Exchanges a block of bytes using the eDMA channels 0 (Tx) and 1 (Rx)
+ *
+ * \param [IN]  obj      SPI object
+ * \param [IN]  tx       Bytes to be sent, NULL sends 0x00
+ * \param [OUT] rx       Received bytes, NULL discards them
+ * \param [IN]  size     Number of bytes to be exchanged
+ * \param [IN]  callback Called from the DMA interrupt, NULL blocks
+ * \retval status        [0: OK, 1: Busy]
+ */
+uint8_t SpiMcuTransfer( struct Spi_s *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( struct Spi_s *obj ) );
+
 #endif  // __SPI_MCU_H__
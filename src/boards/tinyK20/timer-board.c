@@ -208,4 +208,161 @@ void TimerHwEnterLowPowerStopMode( void )
     __WFI();
 #endif
 }
+#else
+#include "board.h"
+#include "timer-board.h"
+
+/*------------------------- Local Defines --------------------------------*/
+/*!
+ * PIT counts per microsecond
+ */
+#define HWTIMER_COUNTS_PER_US                           (CPU_BUS_CLK_HZ / 1000000U)
+
+/*!
+ * Minimum alarm timeout in us, covers the interrupt entry latency
+ */
+#define HWTIMER_MIN_TIMEOUT                             5
+
+/*!
+ * Maximum alarm timeout in us, longer timeouts expire early and are re-armed
+ * by the timer module
+ */
+#define HWTIMER_MAX_TIMEOUT                             (0xFFFFFFFFu / HWTIMER_COUNTS_PER_US)
+
+/*!
+ * PIT interrupt priority, has to be within the FreeRTOS syscall range
+ */
+#define HWTIMER_ISR_PRIOR                               configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/*!
+ * Trace enable (DEMCR) and cycle counter enable (DWT_CTRL) bits
+ */
+#define HWTIMER_DEMCR_TRCENA                            (1u << 24)
+#define HWTIMER_DWT_CTRL_CYCCNTENA                      (1u << 0)
+
+/*------------------------ Local Variables -------------------------------*/
+/*!
+ * Number of time base channel wraps (upper 32 bits of the PIT count)
+ */
+static volatile uint32_t TimerHwOverflowCounter = 0;
+
+/*!
+ * \brief Returns the elapsed PIT counts since TimerHwInit
+ */
+static TimerTime_t TimerHwGetCounts( void );
+
+void TimerHwInit( void )
+{
+    /* Enable PIT clock and module, stop the timers in debug mode */
+    SIM_SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT_MCR = PIT_MCR_FRZ_MASK;
+
+    /* Free running time base */
+    PIT_TCTRL(HWTIMER_TIME_CHANNEL) = 0u;
+    PIT_LDVAL(HWTIMER_TIME_CHANNEL) = 0xFFFFFFFFu;
+    PIT_TFLG(HWTIMER_TIME_CHANNEL) = PIT_TFLG_TIF_MASK;
+    PIT_TCTRL(HWTIMER_TIME_CHANNEL) = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+
+    /* One shot alarm, started by TimerHwStart */
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = 0u;
+    PIT_TFLG(HWTIMER_ALARM_CHANNEL) = PIT_TFLG_TIF_MASK;
+
+    /* Set interrupt priority and enable interrupts */
+    NVIC_BASE_PTR->IP[PIT0_IRQn] = HWTIMER_ISR_PRIOR;
+    NVIC_BASE_PTR->IP[PIT1_IRQn] = HWTIMER_ISR_PRIOR;
+    NVIC_BASE_PTR->ISER[(((uint32_t)(int32_t) PIT0_IRQn) >> 5UL)] =
+            (uint32_t)(1UL << (((uint32_t)(int32_t) PIT0_IRQn) & 0x1FUL));
+    NVIC_BASE_PTR->ISER[(((uint32_t)(int32_t) PIT1_IRQn) >> 5UL)] =
+            (uint32_t)(1UL << (((uint32_t)(int32_t) PIT1_IRQn) & 0x1FUL));
+
+    /* Free running core cycle counter */
+    DEMCR |= HWTIMER_DEMCR_TRCENA;
+    DWT_CYCCNT = 0u;
+    DWT_CTRL |= HWTIMER_DWT_CTRL_CYCCNTENA;
+}
+
+void TimerHwDeInit( void )
+{
+    PIT_TCTRL(HWTIMER_TIME_CHANNEL) = 0u;
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = 0u;
+    PIT_MCR = PIT_MCR_MDIS_MASK;
+}
+
+uint32_t TimerHwGetMinimumTimeout( void )
+{
+    return HWTIMER_MIN_TIMEOUT;
+}
+
+void TimerHwStart( uint32_t timeout )
+{
+    if ( timeout < HWTIMER_MIN_TIMEOUT ) {
+        timeout = HWTIMER_MIN_TIMEOUT;
+    } else if ( timeout > HWTIMER_MAX_TIMEOUT ) {
+        timeout = HWTIMER_MAX_TIMEOUT;
+    }
+
+    /* The load value is only taken over when the channel is (re)enabled */
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = 0u;
+    PIT_TFLG(HWTIMER_ALARM_CHANNEL) = PIT_TFLG_TIF_MASK;
+    PIT_LDVAL(HWTIMER_ALARM_CHANNEL) = (timeout * HWTIMER_COUNTS_PER_US) - 1u;
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+}
+
+void TimerHwStop( void )
+{
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = 0u;
+    PIT_TFLG(HWTIMER_ALARM_CHANNEL) = PIT_TFLG_TIF_MASK;
+}
+
+TimerTime_t TimerHwGetTime( void )
+{
+    return TimerHwGetCounts() / HWTIMER_COUNTS_PER_US;
+}
+
+uint32_t TimerHwGetCycles( void )
+{
+    return DWT_CYCCNT;
+}
+
+static TimerTime_t TimerHwGetCounts( void )
+{
+    uint32_t overflows;
+    uint32_t count;
+
+    __disable_irq();
+
+    overflows = TimerHwOverflowCounter;
+    count = PIT_CVAL(HWTIMER_TIME_CHANNEL);
+    if ( (PIT_TFLG(HWTIMER_TIME_CHANNEL) & PIT_TFLG_TIF_MASK) != 0u ) {
+        /* Wrapped but not yet accounted for by the interrupt */
+        count = PIT_CVAL(HWTIMER_TIME_CHANNEL);
+        overflows++;
+    }
+
+    __enable_irq();
+
+    /* PIT channels count down */
+    return (((TimerTime_t) overflows << 32) | (0xFFFFFFFFu - count));
+}
+
+/*!
+ * @brief Time base wrap interrupt service routine.
+ */
+void PIT0_IRQHandler( void )
+{
+    PIT_TFLG(HWTIMER_TIME_CHANNEL) = PIT_TFLG_TIF_MASK;
+    TimerHwOverflowCounter++;
+}
+
+/*!
+ * @brief Alarm interrupt service routine.
+ */
+void PIT1_IRQHandler( void )
+{
+    /* One shot: stop the channel before it reloads */
+    PIT_TCTRL(HWTIMER_ALARM_CHANNEL) = 0u;
+    PIT_TFLG(HWTIMER_ALARM_CHANNEL) = PIT_TFLG_TIF_MASK;
+
+    TimerIrqHandler();
+}
 #endif /* USE_FREE_RTOS */
@@ -82,5 +82,81 @@ TimerTime_t TimerHwGetElapsedTime( void );
  */
 void TimerHwEnterLowPowerStopMode( void );
 
+#else
+/*------------------------------ Defines ---------------------------------*/
+/*!
+ * Used PIT channels for the precise timer time base and alarm
+ */
+#define HWTIMER_TIME_CHANNEL        0
+#define HWTIMER_ALARM_CHANNEL       1
+
+/*!
+ * The board provides a precise (microsecond) hardware timer for the
+ * FreeRTOS timer backend
+ */
+#define TIMER_HW_PRECISE            1
+
+/*!
+ * \brief Timer time variable definition
+ */
+#ifndef TimerTime_t
+typedef uint64_t TimerTime_t;
+#endif
+
+/*!
+ * \brief Initializes the precise hardware timer
+ *
+ * \remark The timer is based on PIT channel 0 (free running time base) and
+ *         PIT channel 1 (one shot alarm) clocked by the bus clock. The PIT
+ *         keeps running in wait mode, thus it also wakes up the MCU from
+ *         FreeRTOS tickless idle. The LPTMR is not used by the RTOS tick
+ *         (configSYSTICK_USE_LOW_POWER_TIMER 0) but is a 16 bit counter
+ *         clocked by the 1 kHz LPO or the 32 kHz ERCLK, too coarse for the
+ *         microsecond time base.
+ */
+void TimerHwInit( void );
+
+/*!
+ * \brief DeInitializes the precise hardware timer
+ */
+void TimerHwDeInit( void );
+
+/*!
+ * \brief Return the minimum timeout the precise timer is able to handle
+ *
+ * \retval minimum value for a timeout in us
+ */
+uint32_t TimerHwGetMinimumTimeout( void );
+
+/*!
+ * \brief Arms the one shot alarm, TimerIrqHandler is called on expiry
+ *
+ * \param [IN] timeout Timeout in us
+ */
+void TimerHwStart( uint32_t timeout );
+
+/*!
+ * \brief Disarms the one shot alarm
+ */
+void TimerHwStop( void );
+
+/*!
+ * \brief Return the value of the current time in us
+ */
+TimerTime_t TimerHwGetTime( void );
+
+/*!
+ * Core clock cycles per microsecond of the cycle counter
+ */
+#define TIMER_HW_CYCLES_PER_US      (CPU_CORE_CLK_HZ / 1000000U)
+
+/*!
+ * \brief Return the core cycle counter (DWT), wraps around after 2^32 cycles
+ *
+ * \remark Intended for short interval measurements, may be called from any
+ *         context.
+ */
+uint32_t TimerHwGetCycles( void );
+
 #endif /* USE_FREE_RTOS */
 #endif // __TIMER_BOARD_H__
@@ -174,9 +174,7 @@ uint8_t UartMcuPutChar( Uart_t *obj, uint8_t data )
 {
 #if !defined(USE_CUSTOM_UART_HAL)
     if ( IsFifoFull(&obj->FifoTx) == false ) {
-        __disable_irq();
         FifoPush(&obj->FifoTx, data);
-        __enable_irq();
         /* Enable the UART Transmit interrupt */
         g_uartBase[obj->UartId]->C2 |= UART_C2_TCIE_MASK;
         return 0;   // OK
@@ -193,12 +191,48 @@ uint8_t UartMcuPutChar( Uart_t *obj, uint8_t data )
 
 uint8_t UartMcuPutBuffer( Uart_t *obj, uint8_t *txBuff, size_t txSize )
 {
+#if !defined(USE_CUSTOM_UART_HAL)
+    uint32_t primask, irqMask;
+    uint8_t irqIndex;
+    uint16_t pushed;
+
+    while ( txSize > 0 ) {
+        pushed = FifoPushBuffer(&obj->FifoTx, txBuff,
+                (txSize > UINT16_MAX) ? UINT16_MAX : (uint16_t) txSize);
+        if ( pushed > 0 ) {
+            /* Enable the UART Transmit interrupt */
+            g_uartBase[obj->UartId]->C2 |= UART_C2_TCIE_MASK;
+            txBuff += pushed;
+            txSize -= pushed;
+        } else if ( (__get_PRIMASK() != 0) || (__get_IPSR() != 0) ) {
+            /* The TX interrupt may not be able to drain the FIFO. Take over
+             * the consumer side of the FIFO with the interrupts disabled,
+             * wait for the data register to be empty and send one byte by
+             * polling. A UART interrupt preempted by the caller may be inside
+             * FifoPop, the remaining data is dropped then. */
+            irqIndex = ((uint32_t) (int32_t) g_uartIrq[obj->UartId]) >> 5UL;
+            irqMask = 1UL << (((uint32_t) (int32_t) g_uartIrq[obj->UartId]) & 0x1FUL);
+            primask = __get_PRIMASK();
+            __disable_irq();
+            if ( (NVIC_BASE_PTR->IABR[irqIndex] & irqMask) != 0 ) {
+                __set_PRIMASK(primask);
+                return ERR_TXFULL;
+            }
+            while ( ((g_uartBase[obj->UartId]->S1) & UART_S1_TDRE_MASK) == 0 ) {
+            }
+            g_uartBase[obj->UartId]->D = FifoPop(&obj->FifoTx);
+            __set_PRIMASK(primask);
+        }
+        /* Otherwise wait for the TX interrupt to free space in the FIFO */
+    }
+#else
     while ( txSize-- ) {
         while ( ((g_uartBase[obj->UartId]->S1) & UART_S1_TDRE_MASK) == 0 ) {
         }
 
         UartMcuPutChar(obj, *txBuff++);
     }
+#endif
 
     return ERR_OK;
 }
@@ -206,9 +240,7 @@ uint8_t UartMcuPutBuffer( Uart_t *obj, uint8_t *txBuff, size_t txSize )
 uint8_t UartMcuGetChar( Uart_t *obj, uint8_t *data )
 {
     if ( IsFifoEmpty(&obj->FifoRx) == false ) {
-        __disable_irq();
         *data = FifoPop(&obj->FifoRx);
-        __enable_irq();
         return ERR_OK;   // OK
     }
     return ERR_RXEMPTY;   // Busy
@@ -216,8 +248,9 @@ uint8_t UartMcuGetChar( Uart_t *obj, uint8_t *data )
 
 uint8_t UartMcuGetBuffer( Uart_t *obj, uint8_t *rxBuff, size_t rxSize )
 {
-    while ( (rxSize--) > 0 && !IsFifoEmpty(&obj->FifoRx) ) {
-        UartMcuGetChar(obj, rxBuff++);
+    if ( FifoPopBuffer(&obj->FifoRx, rxBuff,
+            (rxSize > UINT16_MAX) ? UINT16_MAX : (uint16_t) rxSize) == 0 ) {
+        return ERR_RXEMPTY;
     }
 
     return ERR_OK;
@@ -254,10 +287,8 @@ void UartInterruptHandler( Uart_t *obj )
     if ( ((g_uartBase[obj->UartId]->S1) & UART_S1_RDRF_MASK) > 0 ) {
         data = g_uartBase[obj->UartId]->S1; /* Reset RDRF flag by reading register S1 */
         data = g_uartBase[obj->UartId]->D;
-        if ( IsFifoFull(&obj->FifoRx) == false ) {
-            // Read one byte from the receive data register
-            FifoPush(&obj->FifoRx, data);
-        }
+        // Dropped and counted as FIFO overflow if the FIFO is full
+        FifoPush(&obj->FifoRx, data);
         if ( obj->IrqNotify != NULL ) {
             obj->IrqNotify(UART_NOTIFY_RX);
         }
@@ -16,6 +16,11 @@ typedef enum {
     UART_0, UART_1, UART_2, UART_USB_CDC = 255,
 } UartId_t;
 
+/*!
+ * The board implements UartMcuPutBuffer, used by UartPutBuffer
+ */
+#define UART_MCU_PUT_BUFFER
+
 /*!
  * \brief Initializes the UART object and MCU peripheral
  *
@@ -62,11 +67,15 @@ void UartMcuDisable( Uart_t *obj );
 uint8_t UartMcuPutChar( Uart_t *obj, uint8_t data );
 
 /*!
- * \brief Sends a character to the UART
+ * \brief Sends a buffer to the UART
  *
- * \param [IN] obj   UART object
- * \param [IN] data  Character to be sent
- * \retval status    [0: OK, 1: Busy]
+ * \remark Blocks until the whole buffer is in the TX FIFO. With interrupts
+ *         masked or from an ISR the FIFO is drained by polling.
+ *
+ * \param [IN] obj     UART object
+ * \param [IN] txBuff  Buffer to be sent
+ * \param [IN] txSize  Size of the buffer
+ * \retval status      [ERR_OK]
  */
 uint8_t UartMcuPutBuffer( Uart_t *obj, uint8_t *txBuff, size_t txSize );
 
@@ -85,11 +94,12 @@ uint8_t UartMcuGetCharsInRxFifo( Uart_t *obj );
 uint8_t UartMcuGetChar( Uart_t *obj, uint8_t *data );
 
 /*!
- * \brief Gets a character from the UART
+ * \brief Gets the received characters from the UART
  *
- * \param [IN] obj   UART object
- * \param [IN] data  Received character
- * \retval status    [0: OK, 1: Busy]
+ * \param [IN] obj     UART object
+ * \param [OUT] rxBuff Buffer the received characters are copied to
+ * \param [IN] rxSize  Size of the buffer
+ * \retval status      [ERR_OK, ERR_RXEMPTY: no data received]
  */
 uint8_t UartMcuGetBuffer( Uart_t *obj, uint8_t *rxBuff, size_t rxSize );
 
@@ -15,6 +15,7 @@ Maintainer: Miguel Luis and Gregory Cristian
 #include "board.h"
 
 #include "LoRaMacCrypto.h"
+#include "LoRaMacScheduler.h"
 #include "LoRaMac.h"
 
 #define LOG_LEVEL_TRACE
@@ -410,8 +411,6 @@ static uint8_t MaxDCycle = 0;
  * Agregated duty cycle management
  */
 static uint16_t AggregatedDCycle;
-static TimerTime_t AggregatedLastTxDoneTime;
-static TimerTime_t AggregatedTimeOff;
 
 /*!
  * Enables/Disables duty cycle management (Test only)
@@ -442,9 +441,21 @@ enum LoRaMacState_e
 uint32_t LoRaMacState = MAC_IDLE;
 
 /*!
- * LoRaMac timer used to check the LoRaMacState (runs every second)
+ * Indicates if an operation waits for its completion events. The MAC state is
+ * then evaluated by the radio and timer events concluding a reception window
+ * or an acknowledge timeout.
+ */
+static bool MacStateCheckPending = false;
+
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
+/*!
+ * LoRaMac timer used to poll the LoRaMacState every MAC_STATE_CHECK_POLL_PERIOD
+ * instead of evaluating it on the completion events. This is the MAC before
+ * the event driven state evaluation, kept to compare the uplink latency on the
+ * host (Linux/test/test-uplink.c).
  */
 static TimerEvent_t MacStateCheckTimer;
+#endif
 
 /*!
  * LoRaMac upper layer event functions
@@ -549,9 +560,27 @@ static void OnRadioRxError( void );
 static void OnRadioRxTimeout( void );
 
 /*!
- * Function executed on Resend Frame timer event.
+ * Evaluates the MAC state after a completion event. Resends the frame or
+ * notifies the upper layer once the operation is finished.
+ */
+static void LoRaMacCheckState( void );
+
+/*!
+ * Evaluates the MAC state, see LoRaMacCheckState
+ */
+static void LoRaMacEvaluateState( void );
+
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
+/*!
+ * Function executed on MacStateCheck timer event
  */
 static void OnMacStateCheckTimerEvent( void );
+#endif
+
+/*!
+ * Calls the upper layer MacEvent callback and clears the event flags
+ */
+static void LoRaMacNotify( LoRaMacEventFlags_t *flags, LoRaMacEventInfo_t *info );
 
 /*!
  * Function executed on duty cycle delayed Tx  timer event
@@ -621,91 +650,48 @@ static int8_t LimitTxPower( int8_t txPower );
 /*!
  * Searches and set the next random available channel
  *
- * \retval status  Function status [0: OK, 1: Unable to find a free channel]
+ * \retval status  Function status [0: OK, 1: Unable to find a free channel,
+ *                 2: No enabled channel supports the datarate, a running
+ *                 transmission has been aborted]
  */
 static uint8_t LoRaMacSetNextChannel( void )
 {
-    uint8_t i = 0;
-    uint8_t j = 0;
-    uint8_t k = 0;
-    uint8_t nbEnabledChannels = 0;
-    uint8_t enabledChannels[LORA_MAX_NB_CHANNELS];
-    TimerTime_t curTime = TimerGetCurrentTime( );
+    TimerTime_t waitTime = 0;
 
-    memset1( enabledChannels, 0, LORA_MAX_NB_CHANNELS );
+    // Apply the channels mask changes done since the last selection
+    LoRaMacSchedulerSetChannelsMask( ChannelsMask );
 
-    // Update Aggregated duty cycle
-    if( AggregatedTimeOff < ( curTime - AggregatedLastTxDoneTime ) )
+    switch( LoRaMacSchedulerNextChannel( ChannelsDatarate, TimerGetCurrentTime( ), &Channel, &waitTime ) )
     {
-        AggregatedTimeOff = 0;
-    }
-
-    // Update bands Time OFF
-    TimerTime_t minTime = ( TimerTime_t )( -1 );
-    for( i = 0; i < LORA_MAX_NB_BANDS; i++ )
-    {
-        if( DutyCycleOn == true )
-        {
-            if( Bands[i].TimeOff < ( curTime - Bands[i].LastTxDoneTime ) )
+        case LORAMAC_SCHEDULER_OK:
+            LoRaMacState &= ~MAC_CHANNEL_CHECK;
+            TimerStop( &ChannelCheckTimer );
+            return 0;
+        case LORAMAC_SCHEDULER_WAIT:
+            // No free channel found.
+            // Check again as soon as the next band becomes available
+            if( ( LoRaMacState & MAC_CHANNEL_CHECK ) == 0 )
             {
-                Bands[i].TimeOff = 0;
+                TimerSetValue( &ChannelCheckTimer, waitTime );
+                TimerStart( &ChannelCheckTimer );
+                LoRaMacState |= MAC_CHANNEL_CHECK;
             }
-            if( Bands[i].TimeOff != 0 )
+            return 1;
+        default:
+            // No enabled channel supports the datarate, waiting does not help.
+            // Abort a running transmission and report it as failed
+            if( ( LoRaMacState & MAC_TX_RUNNING ) == MAC_TX_RUNNING )
             {
-                minTime = MIN( Bands[i].TimeOff, minTime );
-            }
-        }
-        else
-        {
-            minTime = 0;
-            Bands[i].TimeOff = 0;
-        }
-    }
+                LoRaMacState &= ~( MAC_TX_RUNNING | MAC_CHANNEL_CHECK );
+                TimerStop( &ChannelCheckTimer );
+                AckTimeoutRetry = false;
+                ChannelsNbRepCounter = 0;
 
-    // Search how many channels are enabled
-    for( i = 0, k = 0; i < LORA_MAX_NB_CHANNELS; i += 16, k++ )
-    {
-        for( j = 0; j < 16; j++ )
-        {
-            if( ( ChannelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( Channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( ( ( Channels[i + j].DrRange.Fields.Min <= ChannelsDatarate ) &&
-                      ( ChannelsDatarate <= Channels[i + j].DrRange.Fields.Max ) ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( Bands[Channels[i + j].Band].TimeOff > 0 )
-                { // Check if the band is available for transmission
-                    continue;
-                }
-                if( AggregatedTimeOff > 0 )
-                { // Check if there is time available for transmission
-                    continue;
-                }
-                enabledChannels[nbEnabledChannels++] = i + j;
+                LoRaMacEventFlags.Bits.Tx = 1;
+                LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
             }
-        }
+            return 2;
     }
-    if( nbEnabledChannels > 0 )
-    {
-        Channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
-        LoRaMacState &= ~MAC_CHANNEL_CHECK;
-        TimerStop( &ChannelCheckTimer );
-        return 0;
-    }
-    // No free channel found. 
-    // Check again
-    if( ( LoRaMacState & MAC_CHANNEL_CHECK ) == 0 )
-    {
-        TimerSetValue( &ChannelCheckTimer, minTime );
-        TimerStart( &ChannelCheckTimer );
-        LoRaMacState |= MAC_CHANNEL_CHECK;
-    }
-    return 1;
 }
 
 /*
@@ -713,16 +699,32 @@ static uint8_t LoRaMacSetNextChannel( void )
  */
 void OnChannelCheckTimerEvent( void )
 {
+    uint8_t status;
+
     TimerStop( &ChannelCheckTimer );
     
     LoRaMacState &= ~MAC_CHANNEL_CHECK;
-    if( LoRaMacSetNextChannel( ) == 0 )
+    status = LoRaMacSetNextChannel( );
+    if( status == 0 )
     {
         if( ( LoRaMacState & MAC_TX_RUNNING ) == MAC_TX_RUNNING )
         {
            LoRaMacSendFrameOnChannel( Channels[Channel] );
         }
     }
+    else if( status == 2 )
+    {
+        // The transmission has been aborted, report it without evaluating
+        // the Tx flag as a completed transmission
+        if( LoRaMacState == MAC_IDLE )
+        {
+            MacStateCheckPending = false;
+            LoRaMacNotify( &LoRaMacEventFlags, &LoRaMacEventInfo );
+        }
+        return;
+    }
+    // A pending acknowledge retry may proceed now
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -878,8 +880,6 @@ void LoRaMacInit( LoRaMacCallbacks_t *callbacks )
     
     MaxDCycle = 0;
     AggregatedDCycle = 1;
-    AggregatedLastTxDoneTime = 0;
-    AggregatedTimeOff = 0;
 
 #if defined( USE_BAND_433 )
     DutyCycleOn = false;
@@ -893,14 +893,31 @@ void LoRaMacInit( LoRaMacCallbacks_t *callbacks )
     #error "Please define a frequency band in the compiler options."
 #endif
 
+    // Initialize the channel scheduler
+    LoRaMacSchedulerInit( DutyCycleOn );
+    for( uint8_t i = 0; i < LORA_MAX_NB_BANDS; i++ )
+    {
+        LoRaMacSchedulerSetBand( i, Bands[i].DCycle );
+    }
+    for( uint8_t i = 0; i < LORA_MAX_NB_CHANNELS; i++ )
+    {
+        LoRaMacSchedulerSetChannel( i, Channels[i].Band, Channels[i].DrRange.Fields.Min,
+                                    Channels[i].DrRange.Fields.Max, Channels[i].Frequency != 0 );
+    }
+    LoRaMacSchedulerSetAggregatedDutyCycle( AggregatedDCycle );
+    LoRaMacSchedulerSetChannelsMask( ChannelsMask );
+
     MaxRxWindow = MAX_RX_WINDOW;
     ReceiveDelay1 = RECEIVE_DELAY1;
     ReceiveDelay2 = RECEIVE_DELAY2;
     JoinAcceptDelay1 = JOIN_ACCEPT_DELAY1;
     JoinAcceptDelay2 = JOIN_ACCEPT_DELAY2;
 
+    MacStateCheckPending = false;
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
     TimerInit( &MacStateCheckTimer, OnMacStateCheckTimerEvent );
-    TimerSetValue( &MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT );
+    TimerSetValue( &MacStateCheckTimer, MAC_STATE_CHECK_POLL_PERIOD );
+#endif
 
     TimerInit( &ChannelCheckTimer, OnChannelCheckTimerEvent );
     TimerInit( &TxDelayedTimer, OnTxDelayedTimerEvent );
@@ -934,6 +951,8 @@ void LoRaMacSetAdrOn( bool enable )
 
 void LoRaMacInitNwkIds( uint32_t netID, uint32_t devAddr, uint8_t *nwkSKey, uint8_t *appSKey )
 {
+    LoRaMacCryptoInvalidateKeys( LoRaMacDevAddr );
+
     LoRaMacNetID = netID;
     LoRaMacDevAddr = devAddr;
     LoRaMacMemCpy( nwkSKey, LoRaMacNwkSKey, 16 );
@@ -1321,6 +1340,8 @@ uint8_t LoRaMacPrepareFrame( ChannelParams_t channel, LoRaMacHeader_t *macHdr, L
 
 uint8_t LoRaMacSendFrameOnChannel( ChannelParams_t channel )
 {
+    TimerTime_t timeOff;
+
     LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
     LoRaMacEventInfo.TxDatarate = ChannelsDatarate;
 
@@ -1364,19 +1385,19 @@ uint8_t LoRaMacSendFrameOnChannel( ChannelParams_t channel )
     {
         return 6;
     }
-    if( MaxDCycle == 0 )
-    {
-        AggregatedTimeOff = 0;
-    }
 
     LoRaMacState |= MAC_TX_RUNNING;
-    // Starts the MAC layer status check timer
+    // The completion events evaluate the MAC state from now on
+    MacStateCheckPending = true;
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
     TimerStart( &MacStateCheckTimer );
+#endif
     
-    if( MAX( Bands[channel.Band].TimeOff, AggregatedTimeOff ) > ( TimerGetCurrentTime( ) ) )
+    timeOff = LoRaMacSchedulerGetBandTimeOff( channel.Band, TimerGetCurrentTime( ) );
+    if( timeOff > 0 )
     {
-        // Schedule transmission
-        TimerSetValue( &TxDelayedTimer, MAX( Bands[channel.Band].TimeOff, AggregatedTimeOff ) );
+        // Schedule transmission at the instant the band becomes free
+        TimerSetValue( &TxDelayedTimer, timeOff );
         TimerStart( &TxDelayedTimer );
     }
     else
@@ -1588,6 +1609,7 @@ static void LoRaMacProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8
             case SRV_MAC_DUTY_CYCLE_REQ:
                 MaxDCycle = payload[macIndex++];
                 AggregatedDCycle = 1 << MaxDCycle;
+                LoRaMacSchedulerSetAggregatedDutyCycle( AggregatedDCycle );
                 AddMacCommand( MOTE_MAC_DUTY_CYCLE_ANS, 0, 0 );
                 break;
             case SRV_MAC_RX_PARAM_SETUP_REQ:
@@ -1715,19 +1737,8 @@ static void OnRadioTxDone( void )
         OnRxWindow2TimerEvent( );
     }
 
-    // Update Band Time OFF
-    Bands[Channels[Channel].Band].LastTxDoneTime = curTime;
-    if( DutyCycleOn == true )
-    {
-        Bands[Channels[Channel].Band].TimeOff = TxTimeOnAir * Bands[Channels[Channel].Band].DCycle - TxTimeOnAir;
-    }
-    else
-    {
-        Bands[Channels[Channel].Band].TimeOff = 0;
-    }
-    // Update Agregated Time OFF
-    AggregatedLastTxDoneTime = curTime;
-    AggregatedTimeOff = AggregatedTimeOff + ( TxTimeOnAir * AggregatedDCycle - TxTimeOnAir );
+    // Update Band and Agregated Time OFF
+    LoRaMacSchedulerTxDone( Channels[Channel].Band, curTime, TxTimeOnAir );
 
     if( IsRxWindowsEnabled == true )
     {
@@ -1746,6 +1757,7 @@ static void OnRadioTxDone( void )
     {
         ChannelsNbRepCounter++;
     }
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -1816,7 +1828,10 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
                 LoRaMacEventInfo.RxSnr = snr;
                 LoRaMacEventInfo.RxRssi = rssi;
 
+                // Session keys change, drop the cached key schedules of the former session
+                LoRaMacCryptoInvalidateKeys( LoRaMacDevAddr );
                 LoRaMacJoinComputeSKeys( LoRaMacAppKey, LoRaMacRxPayload + 1, LoRaMacDevNonce, LoRaMacNwkSKey, LoRaMacAppSKey );
+                LoRaMacCryptoInvalidateKeys( LORAMAC_CRYPTO_JOIN_ADDRESS );
 
                 LoRaMacNetID = ( uint32_t )LoRaMacRxPayload[4];
                 LoRaMacNetID |= ( ( uint32_t )LoRaMacRxPayload[5] << 8 );
@@ -1904,6 +1919,7 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
                         LoRaMacEventFlags.Bits.Tx = 1;
                         LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_ADDRESS_FAIL;
                         LoRaMacState &= ~MAC_TX_RUNNING;
+                        LoRaMacCheckState( );
                         return;
                     }
                 }
@@ -1918,8 +1934,10 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
                 if( LoRaMacDeviceClass != CLASS_A )
                 {
                     LoRaMacState |= MAC_RX;
-                    // Starts the MAC layer status check timer
+                    MacStateCheckPending = true;
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
                     TimerStart( &MacStateCheckTimer );
+#endif
                 }
                 fCtrl.Value = payload[pktHeaderLen++];
                 
@@ -2065,6 +2083,7 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
             LoRaMacState &= ~MAC_TX_RUNNING;
             break;
     }
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -2084,6 +2103,7 @@ static void OnRadioTxTimeout( void )
     
     LoRaMacEventFlags.Bits.Tx = 1;
     LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_TX_TIMEOUT;
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -2107,6 +2127,7 @@ static void OnRadioRxTimeout( void )
         LoRaMacEventFlags.Bits.Tx = 1;
         LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_RX2_TIMEOUT;
     }
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -2128,6 +2149,7 @@ static void OnRadioRxError( void )
         LoRaMacEventFlags.Bits.Tx = 1;
         LoRaMacEventInfo.Status = LORAMAC_EVENT_INFO_STATUS_RX2_TIMEOUT;
     }
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -2285,12 +2307,41 @@ static void OnRxWindow2TimerEvent( void )
 }
 
 /*!
- * Function executed on MacStateCheck timer event
+ * Called at the end of every event which may conclude a transmission or
+ * reception:
+ *  - Tx done without reception windows, Tx timeout
+ *  - Rx done, Rx timeout and Rx error of the last reception window
+ *  - Acknowledge timeout, channel check
  */
+static void LoRaMacCheckState( void )
+{
+#if !defined( MAC_STATE_CHECK_POLL_PERIOD )
+    LoRaMacEvaluateState( );
+#endif
+}
+
+#if defined( MAC_STATE_CHECK_POLL_PERIOD )
 static void OnMacStateCheckTimerEvent( void )
 {
     TimerStop( &MacStateCheckTimer );
 
+    LoRaMacEvaluateState( );
+    if( MacStateCheckPending == true )
+    {
+        // Operation not finished restart timer
+        TimerStart( &MacStateCheckTimer );
+    }
+}
+#endif
+
+static void LoRaMacEvaluateState( void )
+{
+    if( MacStateCheckPending == false )
+    {
+        // No operation in progress, e.g. Class C reception while idle
+        return;
+    }
+
     if( LoRaMacEventFlags.Bits.Tx == 1 )
     {
         if( NodeAckRequested == false )
@@ -2413,13 +2464,11 @@ static void OnMacStateCheckTimerEvent( void )
     }
     if( LoRaMacState == MAC_IDLE )
     {
+        // Cleared first, the upper layer may start a new operation
+        MacStateCheckPending = false;
         LoRaMacNotify( &LoRaMacEventFlags, &LoRaMacEventInfo );
     }
-    else
-    {
-        // Operation not finished restart timer
-        TimerStart( &MacStateCheckTimer );
-    }
+    // Otherwise the next completion event evaluates the state again
 }
 
 static void OnAckTimeoutTimerEvent( void )
@@ -2428,6 +2477,7 @@ static void OnAckTimeoutTimerEvent( void )
 
     AckTimeoutRetry = true;
     LoRaMacState &= ~MAC_ACK_REQ;
+    LoRaMacCheckState( );
 }
 
 /*!
@@ -2637,6 +2687,8 @@ void LoRaMacSetChannel( uint8_t id, ChannelParams_t params )
 #else
     #error "Please define a frequency band in the compiler options."
 #endif
+    LoRaMacSchedulerSetChannel( id, Channels[id].Band, Channels[id].DrRange.Fields.Min,
+                                Channels[id].DrRange.Fields.Max, Channels[id].Frequency != 0 );
     // Check if it is a valid channel
     if( Channels[id].Frequency == 0 )
     {
@@ -2752,6 +2804,7 @@ uint32_t LoRaMacGetDownLinkCounter( void )
 void LoRaMacTestSetDutyCycleOn( bool enable )
 {
     DutyCycleOn = enable;
+    LoRaMacSchedulerSetDutyCycleOn( enable );
 }
 
 void LoRaMacTestRxWindowsOn( bool enable )
@@ -69,11 +69,6 @@ Maintainer: Miguel Luis and Gregory Cristian
  */
 #define ACK_TIMEOUT_RND                             1000000
 
-/*!
- * Check the Mac layer state every MAC_STATE_CHECK_TIMEOUT
- */
-#define MAC_STATE_CHECK_TIMEOUT                     1000000
-
 /*!
  * Maximum number of times the MAC layer tries to get an acknowledge.
  */
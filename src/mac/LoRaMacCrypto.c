@@ -14,134 +14,404 @@
  */
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "board.h"
 #include "utilities.h"
 
 #include "aes.h"
-#include "cmac.h"
 
 #include "LoRaMacCrypto.h"
 
 /*!
- * CMAC/AES Message Integrity Code (MIC) Block B0 size
+ * CMAC/AES Message Integrity Code (MIC) Block B0 first byte
  */
-#define LORAMAC_MIC_BLOCK_B0_SIZE                   16
+#define LORAMAC_MIC_BLOCK_B0_TAG                    0x49
 
 /*!
- * MIC field computation initial data
+ * Encryption aBlock first byte
  */
-static uint8_t MicBlockB0[] = { 0x49, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00, 0x00 };
+#define LORAMAC_ENC_A_BLOCK_TAG                     0x01
 
 /*!
- * Contains the computed MIC field.
- *
- * \remark Only the 4 first bytes are used
+ * Key schedule cache entry. Holds the expanded AES key schedule and the CMAC
+ * subkeys of one session key.
  */
-static uint8_t Mic[16];
+typedef struct {
+    uint32_t Address; /* Session address the key belongs to */
+    uint8_t Key[16]; /* Raw AES key, validates the entry on lookup */
+    aes_context AesContext; /* Expanded AES key schedule */
+    uint8_t K1[16]; /* CMAC subkey K1 */
+    uint8_t K2[16]; /* CMAC subkey K2 */
+    bool Valid;
+    uint8_t Users; /* Contexts copying from or filling the entry, pinned while not 0 */
+} KeyCacheEntry_t;
 
 /*!
- * Encryption aBlock and sBlock
+ * Key schedule cache
  */
-static uint8_t aBlock[] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00 };
-static uint8_t sBlock[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00 };
+static KeyCacheEntry_t KeyCache[LORAMAC_CRYPTO_KEY_CACHE_SIZE];
 
 /*!
- * AES computation context variable
+ * Index of the next key schedule cache entry to be replaced
  */
-static aes_context AesContext;
+static uint8_t KeyCacheVictim = 0;
 
 /*!
- * CMAC computation context variable
+ * Context of the one-shot MIC and encryption functions. Kept static as the
+ * former AES and CMAC contexts, the functions are not reentrant. Callers
+ * running in several tasks own their context and use the streaming functions.
  */
-static AES_CMAC_CTX AesCmacCtx[1];
+static LoRaMacCryptoCtx_t CryptoCtx;
 
 /*!
- * \brief Computes the LoRaMAC frame MIC field  
+ * \brief Shifts a block left by one bit and applies the CMAC reduction
+ *        polynomial on carry out
  *
- * \param [IN]  buffer          Data buffer
- * \param [IN]  size            Data buffer size
+ * \param [IN]  in              Input block
+ * \param [OUT] out             Shifted block
+ */
+static void CmacShiftBlock( const uint8_t *in, uint8_t *out )
+{
+    uint8_t carry = in[0] & 0x80;
+    uint8_t i;
+
+    for ( i = 0; i < 15; i++ ) {
+        out[i] = (in[i] << 1) | (in[i + 1] >> 7);
+    }
+    out[15] = in[15] << 1;
+    if ( carry != 0 ) {
+        out[15] ^= 0x87;
+    }
+}
+
+/*!
+ * \brief Wipes the expanded key material of a cache entry, a pinned entry is
+ *        only invalidated and wiped by its last user. To be called with
+ *        interrupts disabled.
+ *
+ * \param [IN]  entry           Cache entry
+ */
+static void InvalidateKeyCacheEntry( KeyCacheEntry_t *entry )
+{
+    if ( entry->Users == 0 ) {
+        memset1((uint8_t*) entry, 0, sizeof(KeyCacheEntry_t));
+    } else {
+        entry->Valid = false;
+    }
+}
+
+/*!
+ * \brief Unpins a key schedule cache entry, an entry invalidated while it
+ *        was pinned is wiped by its last user
+ *
+ * \param [IN]  entry           Pinned cache entry
+ */
+static void ReleaseKeyCacheEntry( KeyCacheEntry_t *entry )
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if ( --entry->Users == 0 && !entry->Valid ) {
+        memset1((uint8_t*) entry, 0, sizeof(KeyCacheEntry_t));
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+ * \brief Loads the expanded key schedule and the CMAC subkeys of a session
+ *        key into a caller owned context. The key is only expanded on a
+ *        cache miss.
+ *
+ * \remark Interrupts are only disabled to look up and to pin a cache entry.
+ *         The copy from and into a pinned entry and the key expansion run
+ *         with the previous interrupt mask, a pinned entry is neither
+ *         replaced nor wiped.
+ *
+ * \param [OUT] ctx             Crypto context
  * \param [IN]  key             AES key to be used
+ * \param [IN]  address         Session address the key belongs to
+ */
+static void LoadKeySchedule( LoRaMacCryptoCtx_t *ctx, const uint8_t *key, uint32_t address )
+{
+    KeyCacheEntry_t *entry = NULL, *candidate;
+    uint32_t primask;
+    uint8_t i;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for ( i = 0; i < LORAMAC_CRYPTO_KEY_CACHE_SIZE; i++ ) {
+        candidate = &KeyCache[i];
+        if ( candidate->Valid && candidate->Address == address
+                && memcmp(candidate->Key, key, 16) == 0 ) {
+            entry = candidate;
+            entry->Users++;
+            break;
+        }
+    }
+    __set_PRIMASK(primask);
+
+    if ( entry != NULL ) {
+        ctx->AesContext = entry->AesContext;
+        LoRaMacMemCpy(entry->K1, ctx->K1, 16);
+        LoRaMacMemCpy(entry->K2, ctx->K2, 16);
+        ReleaseKeyCacheEntry(entry);
+        return;
+    }
+
+    memset1((uint8_t*) &ctx->AesContext, 0, sizeof(ctx->AesContext));
+    aes_set_key(key, 16, &ctx->AesContext);
+
+    /* Generate CMAC subkeys */
+    memset1(ctx->K1, 0, 16);
+    aes_encrypt(ctx->K1, ctx->K1, &ctx->AesContext);
+    CmacShiftBlock(ctx->K1, ctx->K1);
+    CmacShiftBlock(ctx->K1, ctx->K2);
+
+    /* Claim the next entry nobody copies from */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for ( i = 0; i < LORAMAC_CRYPTO_KEY_CACHE_SIZE && entry == NULL; i++ ) {
+        candidate = &KeyCache[KeyCacheVictim];
+        KeyCacheVictim = (KeyCacheVictim + 1) % LORAMAC_CRYPTO_KEY_CACHE_SIZE;
+        if ( candidate->Users == 0 ) {
+            entry = candidate;
+            entry->Valid = false;
+            entry->Users = 1;
+        }
+    }
+    __set_PRIMASK(primask);
+
+    if ( entry == NULL ) {
+        /* All entries pinned, the key is not cached */
+        return;
+    }
+
+    entry->Address = address;
+    LoRaMacMemCpy(key, entry->Key, 16);
+    entry->AesContext = ctx->AesContext;
+    LoRaMacMemCpy(ctx->K1, entry->K1, 16);
+    LoRaMacMemCpy(ctx->K2, entry->K2, 16);
+
+    __disable_irq();
+    entry->Valid = true;
+    entry->Users = 0;
+    __set_PRIMASK(primask);
+}
+
+/*!
+ * \brief Fills the session dependent part of a B0 or Ai block
+ *
+ * \param [OUT] block           Block to be filled
+ * \param [IN]  tag             Block type tag
  * \param [IN]  address         Frame address
  * \param [IN]  dir             Frame direction [0: uplink, 1: downlink]
  * \param [IN]  sequenceCounter Frame sequence counter
- * \param [OUT] mic Computed MIC field
  */
-void LoRaMacComputeMic( const uint8_t *buffer, uint16_t size, const uint8_t *key, uint32_t address,
-        uint8_t dir, uint32_t sequenceCounter, uint32_t *mic )
+static void SetSessionBlock( uint8_t *block, uint8_t tag, uint32_t address, uint8_t dir,
+        uint32_t sequenceCounter )
 {
-    MicBlockB0[5] = dir;
+    memset1(block, 0, 16);
+    block[0] = tag;
 
-    MicBlockB0[6] = (address) & 0xFF;
-    MicBlockB0[7] = (address >> 8) & 0xFF;
-    MicBlockB0[8] = (address >> 16) & 0xFF;
-    MicBlockB0[9] = (address >> 24) & 0xFF;
+    block[5] = dir;
 
-    MicBlockB0[10] = (sequenceCounter) & 0xFF;
-    MicBlockB0[11] = (sequenceCounter >> 8) & 0xFF;
-    MicBlockB0[12] = (sequenceCounter >> 16) & 0xFF;
-    MicBlockB0[13] = (sequenceCounter >> 24) & 0xFF;
+    block[6] = (address) & 0xFF;
+    block[7] = (address >> 8) & 0xFF;
+    block[8] = (address >> 16) & 0xFF;
+    block[9] = (address >> 24) & 0xFF;
 
-    MicBlockB0[15] = size & 0xFF;
+    block[10] = (sequenceCounter) & 0xFF;
+    block[11] = (sequenceCounter >> 8) & 0xFF;
+    block[12] = (sequenceCounter >> 16) & 0xFF;
+    block[13] = (sequenceCounter >> 24) & 0xFF;
+}
 
-    AES_CMAC_Init(AesCmacCtx);
+void LoRaMacCryptoInvalidateKeys( uint32_t address )
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t i;
 
-    AES_CMAC_SetKey(AesCmacCtx, key);
+    __disable_irq();
+    for ( i = 0; i < LORAMAC_CRYPTO_KEY_CACHE_SIZE; i++ ) {
+        if ( KeyCache[i].Valid && KeyCache[i].Address == address ) {
+            InvalidateKeyCacheEntry(&KeyCache[i]);
+        }
+    }
+    __set_PRIMASK(primask);
+}
 
-    AES_CMAC_Update(AesCmacCtx, MicBlockB0, LORAMAC_MIC_BLOCK_B0_SIZE);
+void LoRaMacCryptoFlushKeyCache( void )
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t i;
 
-    AES_CMAC_Update(AesCmacCtx, buffer, size & 0xFF);
+    __disable_irq();
+    for ( i = 0; i < LORAMAC_CRYPTO_KEY_CACHE_SIZE; i++ ) {
+        InvalidateKeyCacheEntry(&KeyCache[i]);
+    }
+    KeyCacheVictim = 0;
+    __set_PRIMASK(primask);
+}
+
+void LoRaMacCryptoMicInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key, uint32_t address,
+        uint8_t dir, uint32_t sequenceCounter, uint16_t size )
+{
+    LoadKeySchedule(ctx, key, address);
 
-    AES_CMAC_Final(Mic, AesCmacCtx);
+    memset1(ctx->Block, 0, 16);
 
-    *mic = (uint32_t)(
-            (uint32_t) Mic[3] << 24 | (uint32_t) Mic[2] << 16 | (uint32_t) Mic[1] << 8
-                    | (uint32_t) Mic[0]);
+    /* B0 is kept pending as it might be the last complete block */
+    SetSessionBlock(ctx->Pending, LORAMAC_MIC_BLOCK_B0_TAG, address, dir, sequenceCounter);
+    ctx->Pending[15] = size & 0xFF;
+    ctx->PendingLen = 16;
 }
 
-void LoRaMacPayloadEncrypt( const uint8_t *buffer, uint16_t size, const uint8_t *key,
-        uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint8_t *encBuffer )
+void LoRaMacCryptoJoinMicInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key )
 {
-    uint16_t i;
-    uint8_t bufferIndex = 0;
-    uint16_t ctr = 1;
+    LoadKeySchedule(ctx, key, LORAMAC_CRYPTO_JOIN_ADDRESS);
 
-    memset1(AesContext.ksch, '\0', 240);
-    aes_set_key(key, 16, &AesContext);
+    memset1(ctx->Block, 0, 16);
+    ctx->PendingLen = 0;
+}
 
-    aBlock[5] = dir;
+void LoRaMacCryptoMicUpdate( LoRaMacCryptoCtx_t *ctx, const uint8_t *buffer, uint16_t size )
+{
+    uint8_t i;
+    uint8_t len;
+
+    while ( size > 0 ) {
+        if ( ctx->PendingLen == 16 ) { /* More data follows, pending block is not the last */
+            for ( i = 0; i < 16; i++ ) {
+                ctx->Block[i] ^= ctx->Pending[i];
+            }
+            aes_encrypt(ctx->Block, ctx->Block, &ctx->AesContext);
+            ctx->PendingLen = 0;
+        }
 
-    aBlock[6] = (address) & 0xFF;
-    aBlock[7] = (address >> 8) & 0xFF;
-    aBlock[8] = (address >> 16) & 0xFF;
-    aBlock[9] = (address >> 24) & 0xFF;
+        len = 16 - ctx->PendingLen;
+        if ( size < len ) {
+            len = size;
+        }
+        LoRaMacMemCpy(buffer, ctx->Pending + ctx->PendingLen, len);
+        ctx->PendingLen += len;
+        buffer += len;
+        size -= len;
+    }
+}
 
-    aBlock[10] = (sequenceCounter) & 0xFF;
-    aBlock[11] = (sequenceCounter >> 8) & 0xFF;
-    aBlock[12] = (sequenceCounter >> 16) & 0xFF;
-    aBlock[13] = (sequenceCounter >> 24) & 0xFF;
+void LoRaMacCryptoMicFinal( LoRaMacCryptoCtx_t *ctx, uint32_t *mic )
+{
+    uint8_t i;
 
-    while (size >= 16) {
-        aBlock[15] = ((ctr) & 0xFF);
-        ctr++;
-        aes_encrypt(aBlock, sBlock, &AesContext);
+    if ( ctx->PendingLen == 16 ) { /* Last block is complete */
+        for ( i = 0; i < 16; i++ ) {
+            ctx->Block[i] ^= ctx->Pending[i] ^ ctx->K1[i];
+        }
+    } else { /* Last block needs padding */
+        for ( i = 0; i < ctx->PendingLen; i++ ) {
+            ctx->Block[i] ^= ctx->Pending[i];
+        }
+        ctx->Block[ctx->PendingLen] ^= 0x80;
         for ( i = 0; i < 16; i++ ) {
-            encBuffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
+            ctx->Block[i] ^= ctx->K2[i];
         }
-        size -= 16;
-        bufferIndex += 16;
     }
+    aes_encrypt(ctx->Block, ctx->Block, &ctx->AesContext);
+
+    *mic = (uint32_t)(
+            (uint32_t) ctx->Block[3] << 24 | (uint32_t) ctx->Block[2] << 16
+                    | (uint32_t) ctx->Block[1] << 8 | (uint32_t) ctx->Block[0]);
+
+    LoRaMacCryptoCtxClear(ctx);
+}
+
+void LoRaMacCryptoCtrInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key, uint32_t address,
+        uint8_t dir, uint32_t sequenceCounter )
+{
+    LoadKeySchedule(ctx, key, address);
 
-    if ( size > 0 ) {
-        aBlock[15] = ((ctr) & 0xFF);
-        aes_encrypt(aBlock, sBlock, &AesContext);
-        for ( i = 0; i < size; i++ ) {
-            encBuffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
+    SetSessionBlock(ctx->Block, LORAMAC_ENC_A_BLOCK_TAG, address, dir, sequenceCounter);
+    ctx->Ctr = 1;
+    /* No key stream available yet */
+    ctx->PendingLen = 16;
+}
+
+void LoRaMacCryptoCtrUpdate( LoRaMacCryptoCtx_t *ctx, const uint8_t *buffer, uint16_t size,
+        uint8_t *outBuffer )
+{
+    uint16_t i;
+
+    for ( i = 0; i < size; i++ ) {
+        if ( ctx->PendingLen == 16 ) { /* Generate next key stream block */
+            ctx->Block[15] = ((ctx->Ctr) & 0xFF);
+            ctx->Ctr++;
+            aes_encrypt(ctx->Block, ctx->Pending, &ctx->AesContext);
+            ctx->PendingLen = 0;
         }
+        outBuffer[i] = buffer[i] ^ ctx->Pending[ctx->PendingLen++];
     }
 }
 
+void LoRaMacCryptoMicDecryptUpdate( LoRaMacCryptoCtx_t *micCtx, LoRaMacCryptoCtx_t *ctrCtx,
+        uint8_t *buffer, uint16_t size )
+{
+    uint16_t i;
+    uint8_t j;
+
+    for ( i = 0; i < size; i++ ) {
+        if ( micCtx->PendingLen == 16 ) { /* More data follows, pending block is not the last */
+            for ( j = 0; j < 16; j++ ) {
+                micCtx->Block[j] ^= micCtx->Pending[j];
+            }
+            aes_encrypt(micCtx->Block, micCtx->Block, &micCtx->AesContext);
+            micCtx->PendingLen = 0;
+        }
+        if ( ctrCtx->PendingLen == 16 ) { /* Generate next key stream block */
+            ctrCtx->Block[15] = ((ctrCtx->Ctr) & 0xFF);
+            ctrCtx->Ctr++;
+            aes_encrypt(ctrCtx->Block, ctrCtx->Pending, &ctrCtx->AesContext);
+            ctrCtx->PendingLen = 0;
+        }
+        /* The MIC covers the encrypted byte */
+        micCtx->Pending[micCtx->PendingLen++] = buffer[i];
+        buffer[i] ^= ctrCtx->Pending[ctrCtx->PendingLen++];
+    }
+}
+
+void LoRaMacCryptoCtxClear( LoRaMacCryptoCtx_t *ctx )
+{
+    /* Wipe expanded key material */
+    memset1((uint8_t*) ctx, 0, sizeof(LoRaMacCryptoCtx_t));
+}
+
+/*!
+ * \brief Computes the LoRaMAC frame MIC field  
+ *
+ * \param [IN]  buffer          Data buffer
+ * \param [IN]  size            Data buffer size
+ * \param [IN]  key             AES key to be used
+ * \param [IN]  address         Frame address
+ * \param [IN]  dir             Frame direction [0: uplink, 1: downlink]
+ * \param [IN]  sequenceCounter Frame sequence counter
+ * \param [OUT] mic Computed MIC field
+ */
+void LoRaMacComputeMic( const uint8_t *buffer, uint16_t size, const uint8_t *key, uint32_t address,
+        uint8_t dir, uint32_t sequenceCounter, uint32_t *mic )
+{
+    LoRaMacCryptoMicInit(&CryptoCtx, key, address, dir, sequenceCounter, size);
+    LoRaMacCryptoMicUpdate(&CryptoCtx, buffer, size & 0xFF);
+    LoRaMacCryptoMicFinal(&CryptoCtx, mic);
+}
+
+void LoRaMacPayloadEncrypt( const uint8_t *buffer, uint16_t size, const uint8_t *key,
+        uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint8_t *encBuffer )
+{
+    LoRaMacCryptoCtrInit(&CryptoCtx, key, address, dir, sequenceCounter);
+    LoRaMacCryptoCtrUpdate(&CryptoCtx, buffer, size, encBuffer);
+    LoRaMacCryptoCtxClear(&CryptoCtx);
+}
+
 void LoRaMacPayloadDecrypt( const uint8_t *buffer, uint16_t size, const uint8_t *key,
         uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint8_t *decBuffer )
 {
@@ -151,41 +421,39 @@ void LoRaMacPayloadDecrypt( const uint8_t *buffer, uint16_t size, const uint8_t
 void LoRaMacJoinComputeMic( const uint8_t *buffer, uint16_t size, const uint8_t *key,
         uint32_t *mic )
 {
-    AES_CMAC_Init(AesCmacCtx);
-
-    AES_CMAC_SetKey(AesCmacCtx, key);
-
-    AES_CMAC_Update(AesCmacCtx, buffer, size & 0xFF);
-
-    AES_CMAC_Final(Mic, AesCmacCtx);
-
-    *mic = (uint32_t)(
-            (uint32_t) Mic[3] << 24 | (uint32_t) Mic[2] << 16 | (uint32_t) Mic[1] << 8
-                    | (uint32_t) Mic[0]);
+    LoRaMacCryptoJoinMicInit(&CryptoCtx, key);
+    LoRaMacCryptoMicUpdate(&CryptoCtx, buffer, size & 0xFF);
+    LoRaMacCryptoMicFinal(&CryptoCtx, mic);
 }
 
 void LoRaMacJoinEncrypt( const uint8_t *buffer, uint16_t size, const uint8_t *key,
         uint8_t *encBuffer )
 {
-    memset1(AesContext.ksch, '\0', 240);
-    aes_set_key(key, 16, &AesContext);
-    aes_decrypt(buffer, encBuffer, &AesContext);
+    LoRaMacCryptoCtx_t ctx;
+
+    LoadKeySchedule(&ctx, key, LORAMAC_CRYPTO_JOIN_ADDRESS);
+
+    aes_decrypt(buffer, encBuffer, &ctx.AesContext);
     // Check if optional CFList is included
     if ( size >= 16 ) {
-        aes_decrypt(buffer + 16, encBuffer + 16, &AesContext);
+        aes_decrypt(buffer + 16, encBuffer + 16, &ctx.AesContext);
     }
+    LoRaMacCryptoCtxClear(&ctx);
 }
 
 void LoRaMacJoinDecrypt( const uint8_t *buffer, uint16_t size, const uint8_t *key,
         uint8_t *decBuffer )
 {
-    memset1(AesContext.ksch, '\0', 240);
-    aes_set_key(key, 16, &AesContext);
-    aes_encrypt(buffer, decBuffer, &AesContext);
+    LoRaMacCryptoCtx_t ctx;
+
+    LoadKeySchedule(&ctx, key, LORAMAC_CRYPTO_JOIN_ADDRESS);
+
+    aes_encrypt(buffer, decBuffer, &ctx.AesContext);
     // Check if optional CFList is included
     if ( size >= 16 ) {
-        aes_encrypt(buffer + 16, decBuffer + 16, &AesContext);
+        aes_encrypt(buffer + 16, decBuffer + 16, &ctx.AesContext);
     }
+    LoRaMacCryptoCtxClear(&ctx);
 }
 
 void LoRaMacJoinComputeSKeys( const uint8_t *key, const uint8_t *appNonce, uint16_t devNonce,
@@ -193,19 +461,20 @@ void LoRaMacJoinComputeSKeys( const uint8_t *key, const uint8_t *appNonce, uint1
 {
     uint8_t nonce[16];
     uint8_t *pDevNonce = (uint8_t *) &devNonce;
+    LoRaMacCryptoCtx_t ctx;
 
-    memset1(AesContext.ksch, '\0', 240);
-    aes_set_key(key, 16, &AesContext);
+    LoadKeySchedule(&ctx, key, LORAMAC_CRYPTO_JOIN_ADDRESS);
 
     memset1(nonce, 0, sizeof(nonce));
     nonce[0] = 0x01;
     LoRaMacMemCpy(appNonce, nonce + 1, 6);
     LoRaMacMemCpy(pDevNonce, nonce + 7, 2);
-    aes_encrypt(nonce, nwkSKey, &AesContext);
+    aes_encrypt(nonce, nwkSKey, &ctx.AesContext);
 
     memset1(nonce, 0, sizeof(nonce));
     nonce[0] = 0x02;
     LoRaMacMemCpy(appNonce, nonce + 1, 6);
     LoRaMacMemCpy(pDevNonce, nonce + 7, 2);
-    aes_encrypt(nonce, appSKey, &AesContext);
+    aes_encrypt(nonce, appSKey, &ctx.AesContext);
+    LoRaMacCryptoCtxClear(&ctx);
 }
@@ -15,6 +15,40 @@
 #ifndef __LORAMAC_CRYPTO_H__
 #define __LORAMAC_CRYPTO_H__
 
+#include "aes.h"
+
+/*!
+ * Number of session keys kept expanded by the key schedule cache
+ *
+ * \remark Each entry takes about 300 bytes of RAM
+ */
+#ifndef LORAMAC_CRYPTO_KEY_CACHE_SIZE
+#define LORAMAC_CRYPTO_KEY_CACHE_SIZE               4
+#endif
+
+/*!
+ * Session address under which the AppKey is cached during the join procedure
+ */
+#define LORAMAC_CRYPTO_JOIN_ADDRESS                 0x00000000
+
+/*!
+ * Caller owned crypto context used by the streaming MIC and payload
+ * encryption functions
+ *
+ * \remark Holds a private copy of the expanded key schedule, so several
+ *         contexts can be processed concurrently. Takes about 310 bytes.
+ */
+typedef struct LoRaMacCryptoCtx_s
+{
+    aes_context AesContext; /* Expanded AES key schedule */
+    uint8_t K1[16]; /* CMAC subkey K1 */
+    uint8_t K2[16]; /* CMAC subkey K2 */
+    uint8_t Block[16]; /* MIC: CMAC chaining value, CTR: Ai block */
+    uint8_t Pending[16]; /* MIC: not yet processed data, CTR: key stream block */
+    uint8_t PendingLen; /* MIC: bytes pending, CTR: key stream bytes used */
+    uint16_t Ctr; /* CTR: next block counter */
+}LoRaMacCryptoCtx_t;
+
 /*!
  * Copies size elements of src array to dst array
  * 
@@ -26,6 +60,92 @@
  */
 #define LoRaMacMemCpy( src, dst, size ) memcpy1( dst, src, size )
 
+/*!
+ * Starts a LoRaMAC frame MIC computation
+ *
+ * \param [OUT] ctx             Crypto context
+ * \param [IN]  key             AES key to be used
+ * \param [IN]  address         Frame address
+ * \param [IN]  dir             Frame direction [0: uplink, 1: downlink]
+ * \param [IN]  sequenceCounter Frame sequence counter
+ * \param [IN]  size            Total size of the data to be authenticated
+ */
+void LoRaMacCryptoMicInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key, uint32_t address,
+        uint8_t dir, uint32_t sequenceCounter, uint16_t size );
+
+/*!
+ * Starts a LoRaMAC join frame MIC computation
+ *
+ * \param [OUT] ctx             Crypto context
+ * \param [IN]  key             AES key to be used
+ */
+void LoRaMacCryptoJoinMicInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key );
+
+/*!
+ * Feeds the next piece of data into a MIC computation
+ *
+ * \param [IN]  ctx             Crypto context
+ * \param [IN]  buffer          Data buffer
+ * \param [IN]  size            Data buffer size
+ */
+void LoRaMacCryptoMicUpdate( LoRaMacCryptoCtx_t *ctx, const uint8_t *buffer, uint16_t size );
+
+/*!
+ * Finishes a MIC computation and wipes the context
+ *
+ * \param [IN]  ctx             Crypto context
+ * \param [OUT] mic             Computed MIC field
+ */
+void LoRaMacCryptoMicFinal( LoRaMacCryptoCtx_t *ctx, uint32_t *mic );
+
+/*!
+ * Starts a LoRaMAC payload encryption/decryption
+ *
+ * \param [OUT] ctx             Crypto context
+ * \param [IN]  key             AES key to be used
+ * \param [IN]  address         Frame address
+ * \param [IN]  dir             Frame direction [0: uplink, 1: downlink]
+ * \param [IN]  sequenceCounter Frame sequence counter
+ */
+void LoRaMacCryptoCtrInit( LoRaMacCryptoCtx_t *ctx, const uint8_t *key, uint32_t address,
+        uint8_t dir, uint32_t sequenceCounter );
+
+/*!
+ * Encrypts/decrypts the next piece of payload
+ *
+ * \remark buffer and outBuffer may point to the same location
+ *
+ * \param [IN]  ctx             Crypto context
+ * \param [IN]  buffer          Data buffer
+ * \param [IN]  size            Data buffer size
+ * \param [OUT] outBuffer       Encrypted/decrypted buffer
+ */
+void LoRaMacCryptoCtrUpdate( LoRaMacCryptoCtx_t *ctx, const uint8_t *buffer, uint16_t size,
+        uint8_t *outBuffer );
+
+/*!
+ * Authenticates the next piece of an encrypted payload and decrypts it in
+ * place, in a single pass over the buffer
+ *
+ * \remark Same result as LoRaMacCryptoMicUpdate followed by
+ *         LoRaMacCryptoCtrUpdate on the same piece. The payload is decrypted
+ *         before the MIC is known, it is to be dropped if the MIC is not valid.
+ *
+ * \param [IN]  micCtx          MIC crypto context
+ * \param [IN]  ctrCtx          Payload decryption crypto context
+ * \param [IN/OUT] buffer       Encrypted data in, decrypted data out
+ * \param [IN]  size            Data buffer size
+ */
+void LoRaMacCryptoMicDecryptUpdate( LoRaMacCryptoCtx_t *micCtx, LoRaMacCryptoCtx_t *ctrCtx,
+        uint8_t *buffer, uint16_t size );
+
+/*!
+ * Wipes the key material of a crypto context
+ *
+ * \param [IN]  ctx             Crypto context
+ */
+void LoRaMacCryptoCtxClear( LoRaMacCryptoCtx_t *ctx );
+
 /*!
  * Computes the LoRaMAC frame MIC field  
  *
@@ -113,4 +233,17 @@ void LoRaMacJoinDecrypt( const uint8_t *buffer, uint16_t size, const uint8_t *ke
 void LoRaMacJoinComputeSKeys( const uint8_t *key, const uint8_t *appNonce, uint16_t devNonce,
         uint8_t *nwkSKey, uint8_t *appSKey );
 
+/*!
+ * Removes all cached key schedules of a session. Has to be called whenever
+ * the keys of a session change (join, rebind).
+ *
+ * \param [IN]  address         Session address
+ */
+void LoRaMacCryptoInvalidateKeys( uint32_t address );
+
+/*!
+ * Removes all cached key schedules
+ */
+void LoRaMacCryptoFlushKeyCache( void );
+
 #endif // __LORAMAC_CRYPTO_H__
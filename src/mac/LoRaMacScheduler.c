@@ -0,0 +1,317 @@
+/**
+ * \file LoRaMacScheduler.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Duty cycle band scheduler and transmission channel selection
+ *
+ * Candidates[dr][band] holds the enabled channels of a band supporting the
+ * datarate dr and CandidateCount[dr][band] their number. A channel is enabled
+ * if it is defined and its bit is set in the channels mask. The selection
+ * only visits the bands and, for the selected band, the mask words up to the
+ * chosen channel.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "LoRaMacScheduler.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define CHANNEL_WORD(id)                            ((id) / 16)
+#define CHANNEL_BIT(id)                             ((uint16_t)(1u << ((id) % 16)))
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Channel parameters */
+static uint8_t ChannelBand[LORA_MAX_NB_CHANNELS];
+static int8_t ChannelDrMin[LORA_MAX_NB_CHANNELS];
+static int8_t ChannelDrMax[LORA_MAX_NB_CHANNELS];
+
+/*! Defined channels and last applied channels mask */
+static uint16_t ChannelsValid[LORAMAC_SCHEDULER_MASK_WORDS];
+static uint16_t ChannelsMask[LORAMAC_SCHEDULER_MASK_WORDS];
+
+/*! Enabled channels per datarate and band */
+static uint16_t Candidates[LORAMAC_SCHEDULER_NB_DATARATES][LORA_MAX_NB_BANDS][LORAMAC_SCHEDULER_MASK_WORDS];
+static uint8_t CandidateCount[LORAMAC_SCHEDULER_NB_DATARATES][LORA_MAX_NB_BANDS];
+
+/*! Band duty cycles and the time the bands become free again */
+static uint16_t BandDCycle[LORA_MAX_NB_BANDS];
+static TimerTime_t BandNextFree[LORA_MAX_NB_BANDS];
+
+/*! Aggregated duty cycle of all bands */
+static uint16_t AggregatedDCycle;
+static TimerTime_t AggregatedNextFree;
+
+static bool DutyCycleOn;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool IsChannelEnabled( uint8_t id );
+static void AddCandidate( uint8_t id );
+static void RemoveCandidate( uint8_t id );
+static uint8_t BitCount( uint16_t value );
+static uint8_t SelectCandidate( uint8_t datarate, uint8_t band, uint8_t index );
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void LoRaMacSchedulerInit( bool dutyCycleOn )
+{
+    memset1((uint8_t*) ChannelsValid, 0, sizeof(ChannelsValid));
+    memset1((uint8_t*) ChannelsMask, 0, sizeof(ChannelsMask));
+    memset1((uint8_t*) Candidates, 0, sizeof(Candidates));
+    memset1((uint8_t*) CandidateCount, 0, sizeof(CandidateCount));
+
+    for ( uint8_t i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
+        BandDCycle[i] = 1;
+        BandNextFree[i] = 0;
+    }
+    AggregatedDCycle = 1;
+    AggregatedNextFree = 0;
+    DutyCycleOn = dutyCycleOn;
+}
+
+void LoRaMacSchedulerSetDutyCycleOn( bool dutyCycleOn )
+{
+    DutyCycleOn = dutyCycleOn;
+    if ( dutyCycleOn == false ) {
+        for ( uint8_t i = 0; i < LORA_MAX_NB_BANDS; i++ ) {
+            BandNextFree[i] = 0;
+        }
+    }
+}
+
+void LoRaMacSchedulerSetBand( uint8_t band, uint16_t dCycle )
+{
+    if ( band < LORA_MAX_NB_BANDS ) {
+        BandDCycle[band] = dCycle;
+    }
+}
+
+void LoRaMacSchedulerSetAggregatedDutyCycle( uint16_t aggregatedDCycle )
+{
+    AggregatedDCycle = aggregatedDCycle;
+    if ( aggregatedDCycle <= 1 ) {
+        /* No aggregated restriction, drop the pending time off */
+        AggregatedNextFree = 0;
+    }
+}
+
+void LoRaMacSchedulerSetChannel( uint8_t id, uint8_t band, int8_t drMin, int8_t drMax,
+        bool valid )
+{
+    if ( id >= LORA_MAX_NB_CHANNELS ) {
+        return;
+    }
+    if ( IsChannelEnabled(id) ) {
+        RemoveCandidate(id);
+    }
+
+    ChannelBand[id] = band;
+    ChannelDrMin[id] = drMin;
+    ChannelDrMax[id] = drMax;
+    if ( valid ) {
+        ChannelsValid[CHANNEL_WORD(id)] |= CHANNEL_BIT(id);
+    } else {
+        ChannelsValid[CHANNEL_WORD(id)] &= ~CHANNEL_BIT(id);
+    }
+
+    if ( IsChannelEnabled(id) ) {
+        AddCandidate(id);
+    }
+}
+
+void LoRaMacSchedulerSetChannelsMask( const uint16_t *channelsMask )
+{
+    uint16_t changed;
+    uint8_t bit, id;
+
+    for ( uint8_t i = 0; i < LORAMAC_SCHEDULER_MASK_WORDS; i++ ) {
+        changed = channelsMask[i] ^ ChannelsMask[i];
+        if ( changed == 0 ) {
+            continue;
+        }
+        ChannelsMask[i] = channelsMask[i];
+
+        /* Only defined channels are part of the candidate sets */
+        changed &= ChannelsValid[i];
+        for ( bit = 0; changed != 0; bit++, changed >>= 1 ) {
+            if ( (changed & 0x01) == 0 ) {
+                continue;
+            }
+            id = i * 16 + bit;
+            if ( id >= LORA_MAX_NB_CHANNELS ) {
+                break;
+            }
+            if ( ChannelsMask[i] & CHANNEL_BIT(id) ) {
+                AddCandidate(id);
+            } else {
+                RemoveCandidate(id);
+            }
+        }
+    }
+}
+
+void LoRaMacSchedulerTxDone( uint8_t band, TimerTime_t curTime, TimerTime_t timeOnAir )
+{
+    if ( (DutyCycleOn == true) && (band < LORA_MAX_NB_BANDS) && (BandDCycle[band] > 1) ) {
+        BandNextFree[band] = curTime + timeOnAir * (BandDCycle[band] - 1);
+    }
+    if ( AggregatedDCycle > 1 ) {
+        /* The aggregated time off accumulates over consecutive transmissions */
+        AggregatedNextFree = MAX(AggregatedNextFree, curTime)
+                + timeOnAir * (AggregatedDCycle - 1);
+    }
+}
+
+TimerTime_t LoRaMacSchedulerGetBandTimeOff( uint8_t band, TimerTime_t curTime )
+{
+    TimerTime_t nextFree = AggregatedNextFree;
+
+    if ( (DutyCycleOn == true) && (band < LORA_MAX_NB_BANDS) ) {
+        nextFree = MAX(nextFree, BandNextFree[band]);
+    }
+    return (nextFree > curTime) ? (nextFree - curTime) : 0;
+}
+
+LoRaMacSchedulerStatus_t LoRaMacSchedulerNextChannel( uint8_t datarate, TimerTime_t curTime,
+        uint8_t *channel, TimerTime_t *waitTime )
+{
+    TimerTime_t nextFree;
+    TimerTime_t minNextFree = (TimerTime_t)(-1);
+    uint16_t nbFreeChannels = 0;
+    uint32_t freeBands = 0;
+    uint16_t index;
+    uint8_t band;
+
+    if ( datarate >= LORAMAC_SCHEDULER_NB_DATARATES ) {
+        return LORAMAC_SCHEDULER_NO_CHANNEL;
+    }
+
+    for ( band = 0; band < LORA_MAX_NB_BANDS; band++ ) {
+        if ( CandidateCount[datarate][band] == 0 ) {
+            continue;
+        }
+        nextFree = AggregatedNextFree;
+        if ( DutyCycleOn == true ) {
+            nextFree = MAX(nextFree, BandNextFree[band]);
+        }
+        if ( nextFree > curTime ) {
+            minNextFree = MIN(minNextFree, nextFree);
+            continue;
+        }
+        freeBands |= 1u << band;
+        nbFreeChannels += CandidateCount[datarate][band];
+    }
+
+    if ( nbFreeChannels == 0 ) {
+        if ( minNextFree == (TimerTime_t)(-1) ) {
+            return LORAMAC_SCHEDULER_NO_CHANNEL;
+        }
+        *waitTime = minNextFree - curTime;
+        return LORAMAC_SCHEDULER_WAIT;
+    }
+
+    /* Pick a channel uniformly out of all free bands */
+    index = (uint16_t) randr(0, nbFreeChannels - 1);
+    for ( band = 0; band < LORA_MAX_NB_BANDS; band++ ) {
+        if ( (freeBands & (1u << band)) == 0 ) {
+            continue;
+        }
+        if ( index < CandidateCount[datarate][band] ) {
+            break;
+        }
+        index -= CandidateCount[datarate][band];
+    }
+    *channel = SelectCandidate(datarate, band, (uint8_t) index);
+    return LORAMAC_SCHEDULER_OK;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static bool IsChannelEnabled( uint8_t id )
+{
+    return ((ChannelsValid[CHANNEL_WORD(id)] & ChannelsMask[CHANNEL_WORD(id)] & CHANNEL_BIT(id))
+            != 0);
+}
+
+/*!
+ * \brief Adds an enabled channel to the sets of all its datarates.
+ */
+static void AddCandidate( uint8_t id )
+{
+    uint8_t band = ChannelBand[id];
+
+    if ( band >= LORA_MAX_NB_BANDS ) {
+        return;
+    }
+    for ( int8_t dr = MAX(ChannelDrMin[id], 0);
+            (dr <= ChannelDrMax[id]) && (dr < LORAMAC_SCHEDULER_NB_DATARATES); dr++ ) {
+        Candidates[dr][band][CHANNEL_WORD(id)] |= CHANNEL_BIT(id);
+        CandidateCount[dr][band]++;
+    }
+}
+
+/*!
+ * \brief Removes a channel from the sets of all its datarates.
+ */
+static void RemoveCandidate( uint8_t id )
+{
+    uint8_t band = ChannelBand[id];
+
+    if ( band >= LORA_MAX_NB_BANDS ) {
+        return;
+    }
+    for ( int8_t dr = MAX(ChannelDrMin[id], 0);
+            (dr <= ChannelDrMax[id]) && (dr < LORAMAC_SCHEDULER_NB_DATARATES); dr++ ) {
+        if ( Candidates[dr][band][CHANNEL_WORD(id)] & CHANNEL_BIT(id) ) {
+            Candidates[dr][band][CHANNEL_WORD(id)] &= ~CHANNEL_BIT(id);
+            CandidateCount[dr][band]--;
+        }
+    }
+}
+
+static uint8_t BitCount( uint16_t value )
+{
+    uint8_t count = 0;
+
+    while ( value != 0 ) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+}
+
+/*!
+ * \brief Returns the index-th channel of a candidate set.
+ */
+static uint8_t SelectCandidate( uint8_t datarate, uint8_t band, uint8_t index )
+{
+    uint16_t word;
+    uint8_t count;
+
+    for ( uint8_t i = 0; i < LORAMAC_SCHEDULER_MASK_WORDS; i++ ) {
+        word = Candidates[datarate][band][i];
+        count = BitCount(word);
+        if ( index >= count ) {
+            index -= count;
+            continue;
+        }
+        for ( uint8_t bit = 0; bit < 16; bit++ ) {
+            if ( word & (1u << bit) ) {
+                if ( index == 0 ) {
+                    return i * 16 + bit;
+                }
+                index--;
+            }
+        }
+    }
+    return 0;
+}
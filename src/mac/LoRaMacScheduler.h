@@ -0,0 +1,132 @@
+/**
+ * \file LoRaMacScheduler.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Duty cycle band scheduler and transmission channel selection
+ *
+ * The scheduler keeps the absolute time each band becomes free again and, per
+ * datarate and band, the set of enabled channels supporting the datarate. The
+ * sets are updated incrementally when a channel or the channels mask changes,
+ * so selecting a random free channel does not scan the channel list. When no
+ * channel is free the exact time until the next band becomes available is
+ * returned instead.
+ *
+ * All times are given by the caller in the unit of its TimerTime_t clock, the
+ * time on air has to use the same unit.
+ */
+#ifndef __LORAMAC_SCHEDULER_H__
+#define __LORAMAC_SCHEDULER_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "timer.h"
+#include "LoRaMac-board.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Number of datarates tracked [DR_0 .. DR_15] */
+#define LORAMAC_SCHEDULER_NB_DATARATES              16
+
+/*! Number of 16 bit words of a channels mask */
+#define LORAMAC_SCHEDULER_MASK_WORDS                ((LORA_MAX_NB_CHANNELS + 15) / 16)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Channel selection result */
+typedef enum {
+    LORAMAC_SCHEDULER_OK = 0,       //! A free channel has been selected
+    LORAMAC_SCHEDULER_WAIT,         //! Channels exist but their bands are off
+    LORAMAC_SCHEDULER_NO_CHANNEL    //! No enabled channel supports the datarate
+} LoRaMacSchedulerStatus_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Clears all channels, bands and time off information.
+ *
+ * \param dutyCycleOn Enables the duty cycle restrictions.
+ */
+void LoRaMacSchedulerInit( bool dutyCycleOn );
+
+/*!
+ * \brief Enables or disables the duty cycle restrictions.
+ *
+ * \remark The pending band time off is discarded when disabled.
+ */
+void LoRaMacSchedulerSetDutyCycleOn( bool dutyCycleOn );
+
+/*!
+ * \brief Sets the duty cycle of a band.
+ *
+ * \param band Band index.
+ * \param dCycle Duty cycle divisor, a band transmitting for t stays off for
+ *        t * (dCycle - 1).
+ */
+void LoRaMacSchedulerSetBand( uint8_t band, uint16_t dCycle );
+
+/*!
+ * \brief Sets the aggregated duty cycle divisor of all bands.
+ */
+void LoRaMacSchedulerSetAggregatedDutyCycle( uint16_t aggregatedDCycle );
+
+/*!
+ * \brief Updates the parameters of a channel.
+ *
+ * \param id Channel index.
+ * \param band Band index of the channel.
+ * \param drMin Lowest supported datarate.
+ * \param drMax Highest supported datarate.
+ * \param valid False if the channel is not defined (frequency 0).
+ */
+void LoRaMacSchedulerSetChannel( uint8_t id, uint8_t band, int8_t drMin, int8_t drMax,
+        bool valid );
+
+/*!
+ * \brief Applies the channels mask.
+ *
+ * Only the bits changed since the last call update the channel sets, calling
+ * it with an unchanged mask costs a comparison of LORAMAC_SCHEDULER_MASK_WORDS
+ * words.
+ *
+ * \param channelsMask Channels mask, LORAMAC_SCHEDULER_MASK_WORDS words.
+ */
+void LoRaMacSchedulerSetChannelsMask( const uint16_t *channelsMask );
+
+/*!
+ * \brief Starts the time off of a band after a transmission.
+ *
+ * \param band Band index of the channel used.
+ * \param curTime Time the transmission has been completed.
+ * \param timeOnAir Time on air of the frame.
+ */
+void LoRaMacSchedulerTxDone( uint8_t band, TimerTime_t curTime, TimerTime_t timeOnAir );
+
+/*!
+ * \brief Returns the time until a band may be used.
+ *
+ * \param band Band index.
+ * \param curTime Current time.
+ * \retval Remaining time off of the band, including the aggregated time off.
+ */
+TimerTime_t LoRaMacSchedulerGetBandTimeOff( uint8_t band, TimerTime_t curTime );
+
+/*!
+ * \brief Selects a random free channel supporting the datarate.
+ *
+ * \param datarate Datarate of the transmission.
+ * \param curTime Current time.
+ * \param channel Selected channel index, valid for LORAMAC_SCHEDULER_OK.
+ * \param waitTime Time until a channel becomes free, valid for
+ *        LORAMAC_SCHEDULER_WAIT.
+ * \retval Selection result.
+ */
+LoRaMacSchedulerStatus_t LoRaMacSchedulerNextChannel( uint8_t datarate, TimerTime_t curTime,
+        uint8_t *channel, TimerTime_t *waitTime );
+
+#endif // __LORAMAC_SCHEDULER_H__
@@ -0,0 +1,531 @@
+/**
+ * \file sim-medium.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Simulated radio medium shared by all the nodes of a simulation
+ *
+ * The medium runs on a discrete virtual time in us which is only advanced by
+ * SimMediumProcess. A frame is received by a node which listens with the
+ * same modulation when the transmission starts and the received power is
+ * above the sensitivity of the modulation (log-distance path loss, thermal
+ * noise floor and SNR demodulation limit). The frame is lost if another
+ * transmission on the same channel overlaps it without being at least
+ * SIM_MEDIUM_CAPTURE_THRESHOLD weaker. Different spreading factors are
+ * considered orthogonal.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "sim-medium.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Index of no transmission */
+#define TRANSMISSION_NONE                           (-1)
+
+/*! Power of no signal [dBm] */
+#define POWER_NONE                                  (-1000.0)
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef enum {
+    NODE_STATE_STANDBY = 0, NODE_STATE_RX, NODE_STATE_TX, NODE_STATE_CAD,
+} NodeState_t;
+
+typedef struct {
+    bool InUse;
+    SimMediumEvents_t Events;
+    void *Context;
+    int32_t X;
+    int32_t Y;
+    NodeState_t State;
+    SimMediumModulation_t Modulation;
+    uint64_t Deadline;              //! End of the RX window or of the CAD
+    int16_t Transmission;           //! TX: own transmission, RX: received transmission
+    bool RxContinuous;
+    double RxPower;                 //! Power of the received frame [dBm]
+    double InterferencePower;       //! Strongest overlapping co-channel frame [dBm]
+    bool CadActivity;
+} Node_t;
+
+typedef struct {
+    bool InUse;
+    bool Aborted;
+    int16_t Sender;
+    int32_t X;
+    int32_t Y;
+    SimMediumModulation_t Modulation;
+    int8_t Power;
+    uint64_t End;
+    uint8_t Size;
+    uint8_t Payload[SIM_MEDIUM_MAX_PAYLOAD];
+} Transmission_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static Node_t Nodes[SIM_MEDIUM_MAX_NODES];
+static Transmission_t Transmissions[SIM_MEDIUM_MAX_TRANSMISSIONS];
+
+/*! Current medium time [us] */
+static uint64_t MediumTime;
+
+/*! State of the xorshift pseudo random generator */
+static uint32_t RandomState;
+
+/*! Payload handed to the RxDone callbacks */
+static uint8_t RxPayload[SIM_MEDIUM_MAX_PAYLOAD];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static Node_t *GetNode( int16_t node );
+static double ReceivedPower( Transmission_t *tx, Node_t *node );
+static double NoiseFloor( uint32_t bandwidth );
+static double Sensitivity( const SimMediumModulation_t *modulation );
+static bool IsSameChannel( const SimMediumModulation_t *a, const SimMediumModulation_t *b );
+static bool IsReceivable( Transmission_t *tx, Node_t *node );
+static bool IsChannelActive( Node_t *node );
+static double StrongestInterferer( Node_t *node, int16_t index );
+static void EndTransmission( int16_t index );
+static void EndDeadline( int16_t node );
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void SimMediumInit( uint32_t seed )
+{
+    memset(Nodes, 0, sizeof(Nodes));
+    memset(Transmissions, 0, sizeof(Transmissions));
+    MediumTime = 0;
+    RandomState = (seed != 0) ? seed : 0x2545F491;
+}
+
+int16_t SimMediumAttach( const SimMediumEvents_t *events, void *context, int32_t x, int32_t y )
+{
+    int16_t i;
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_NODES; i++ ) {
+        if ( !Nodes[i].InUse ) {
+            memset(&Nodes[i], 0, sizeof(Node_t));
+            Nodes[i].InUse = true;
+            Nodes[i].Events = *events;
+            Nodes[i].Context = context;
+            Nodes[i].X = x;
+            Nodes[i].Y = y;
+            Nodes[i].State = NODE_STATE_STANDBY;
+            Nodes[i].Deadline = SIM_MEDIUM_TIME_NEVER;
+            Nodes[i].Transmission = TRANSMISSION_NONE;
+            return i;
+        }
+    }
+    return SIM_MEDIUM_NODE_NONE;
+}
+
+void SimMediumDetach( int16_t node )
+{
+    Node_t *n = GetNode(node);
+
+    if ( n != NULL ) {
+        SimMediumStandby(node);
+        n->InUse = false;
+    }
+}
+
+void SimMediumSetPosition( int16_t node, int32_t x, int32_t y )
+{
+    Node_t *n = GetNode(node);
+
+    if ( n != NULL ) {
+        n->X = x;
+        n->Y = y;
+    }
+}
+
+bool SimMediumSend( int16_t node, const SimMediumModulation_t *modulation, int8_t power,
+        const uint8_t *buffer, uint8_t size )
+{
+    Node_t *n = GetNode(node), *rx;
+    Transmission_t *tx = NULL;
+    double rxPower;
+    int16_t i, index = TRANSMISSION_NONE;
+
+    if ( (n == NULL) || (n->State == NODE_STATE_TX) ) {
+        return false;
+    }
+    for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+        if ( !Transmissions[i].InUse ) {
+            index = i;
+            tx = &Transmissions[i];
+            break;
+        }
+    }
+    if ( tx == NULL ) {
+        return false;
+    }
+    SimMediumStandby(node);
+
+    tx->InUse = true;
+    tx->Aborted = false;
+    tx->Sender = node;
+    tx->X = n->X;
+    tx->Y = n->Y;
+    tx->Modulation = *modulation;
+    tx->Power = power;
+    tx->End = MediumTime + SimMediumTimeOnAir(modulation, size);
+    tx->Size = size;
+    memcpy(tx->Payload, buffer, size);
+
+    n->State = NODE_STATE_TX;
+    n->Modulation = *modulation;
+    n->Transmission = index;
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_NODES; i++ ) {
+        rx = &Nodes[i];
+        if ( !rx->InUse || (i == node) ) {
+            continue;
+        }
+        rxPower = ReceivedPower(tx, rx);
+        if ( rx->State == NODE_STATE_RX ) {
+            if ( rx->Transmission != TRANSMISSION_NONE ) {
+                /* Frame overlapping an ongoing reception */
+                if ( IsSameChannel(&Transmissions[rx->Transmission].Modulation, modulation)
+                        && (rxPower > rx->InterferencePower) ) {
+                    rx->InterferencePower = rxPower;
+                }
+            } else if ( IsReceivable(tx, rx) ) {
+                /* Preamble detected, the RX timeout does not apply anymore */
+                rx->Transmission = index;
+                rx->RxPower = rxPower;
+                rx->InterferencePower = StrongestInterferer(rx, index);
+                rx->Deadline = SIM_MEDIUM_TIME_NEVER;
+            }
+        } else if ( rx->State == NODE_STATE_CAD ) {
+            if ( IsSameChannel(&rx->Modulation, modulation)
+                    && (rxPower >= Sensitivity(&rx->Modulation)) ) {
+                rx->CadActivity = true;
+            }
+        }
+    }
+    return true;
+}
+
+void SimMediumRx( int16_t node, const SimMediumModulation_t *modulation, uint32_t timeout,
+        bool continuous )
+{
+    Node_t *n = GetNode(node);
+
+    if ( n == NULL ) {
+        return;
+    }
+    SimMediumStandby(node);
+
+    n->State = NODE_STATE_RX;
+    n->Modulation = *modulation;
+    n->RxContinuous = continuous;
+    n->Deadline = (timeout != 0) ? MediumTime + timeout : SIM_MEDIUM_TIME_NEVER;
+}
+
+void SimMediumStartCad( int16_t node, const SimMediumModulation_t *modulation )
+{
+    Node_t *n = GetNode(node);
+    uint64_t symbolTime;
+
+    if ( n == NULL ) {
+        return;
+    }
+    SimMediumStandby(node);
+
+    n->State = NODE_STATE_CAD;
+    n->Modulation = *modulation;
+    n->CadActivity = IsChannelActive(n);
+
+    if ( modulation->Modem == MODEM_LORA ) {
+        symbolTime = ((uint64_t) 1000000 << modulation->Datarate) / modulation->Bandwidth;
+    } else {
+        symbolTime = 1000;
+    }
+    n->Deadline = MediumTime + 2 * symbolTime;
+}
+
+void SimMediumStandby( int16_t node )
+{
+    Node_t *n = GetNode(node);
+
+    if ( n == NULL ) {
+        return;
+    }
+    if ( (n->State == NODE_STATE_TX) && (n->Transmission != TRANSMISSION_NONE) ) {
+        /* The receivers of the aborted frame are notified at once */
+        Transmissions[n->Transmission].Aborted = true;
+        Transmissions[n->Transmission].End = MediumTime;
+    }
+    n->State = NODE_STATE_STANDBY;
+    n->Transmission = TRANSMISSION_NONE;
+    n->Deadline = SIM_MEDIUM_TIME_NEVER;
+}
+
+int16_t SimMediumRssi( int16_t node, uint32_t frequency, uint32_t bandwidth )
+{
+    Node_t *n = GetNode(node);
+    double power;
+    int16_t i;
+
+    power = pow(10.0, NoiseFloor(bandwidth) / 10.0);
+    if ( n != NULL ) {
+        for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+            if ( Transmissions[i].InUse && !Transmissions[i].Aborted
+                    && (Transmissions[i].Modulation.Frequency == frequency)
+                    && (Transmissions[i].Sender != node) ) {
+                power += pow(10.0, ReceivedPower(&Transmissions[i], n) / 10.0);
+            }
+        }
+    }
+    return (int16_t) floor(10.0 * log10(power) + 0.5);
+}
+
+uint32_t SimMediumTimeOnAir( const SimMediumModulation_t *modulation, uint8_t size )
+{
+    double airTime;
+
+    if ( modulation->Modem == MODEM_LORA ) {
+        double ts = (double) (1 << modulation->Datarate) / modulation->Bandwidth;
+        double tPreamble = (modulation->PreambleLen + 4.25) * ts;
+        double tmp = ceil(
+                (8 * size - 4 * (int32_t) modulation->Datarate + 28 + 16 * modulation->CrcOn
+                        - (modulation->FixLen ? 20 : 0))
+                        / (double) (4 * modulation->Datarate
+                                - (modulation->LowDatarateOptimize ? 8 : 0)))
+                * (modulation->Coderate + 4);
+        double nPayload = 8 + ((tmp > 0) ? tmp : 0);
+
+        airTime = tPreamble + nPayload * ts;
+    } else {
+        /* Preamble, 3 bytes sync word, length byte, payload and CRC */
+        airTime = 8.0
+                * (modulation->PreambleLen + 3 + (modulation->FixLen ? 0 : 1) + size
+                        + (modulation->CrcOn ? 2 : 0)) / modulation->Datarate;
+    }
+    return (uint32_t) floor(airTime * 1e6 + 0.999);
+}
+
+uint32_t SimMediumRandom( void )
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return RandomState;
+}
+
+uint64_t SimMediumGetTime( void )
+{
+    return MediumTime;
+}
+
+uint64_t SimMediumGetNextEventTime( void )
+{
+    uint64_t next = SIM_MEDIUM_TIME_NEVER;
+    int16_t i;
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+        if ( Transmissions[i].InUse && (Transmissions[i].End < next) ) {
+            next = Transmissions[i].End;
+        }
+    }
+    for ( i = 0; i < SIM_MEDIUM_MAX_NODES; i++ ) {
+        if ( Nodes[i].InUse && (Nodes[i].Deadline < next) ) {
+            next = Nodes[i].Deadline;
+        }
+    }
+    return next;
+}
+
+void SimMediumProcess( uint64_t now )
+{
+    uint64_t next;
+    int16_t i;
+
+    while ( (next = SimMediumGetNextEventTime()) <= now ) {
+        MediumTime = next;
+
+        for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+            if ( Transmissions[i].InUse && (Transmissions[i].End <= next) ) {
+                EndTransmission(i);
+            }
+        }
+        for ( i = 0; i < SIM_MEDIUM_MAX_NODES; i++ ) {
+            if ( Nodes[i].InUse && (Nodes[i].Deadline <= next) ) {
+                EndDeadline(i);
+            }
+        }
+    }
+    MediumTime = now;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static Node_t *GetNode( int16_t node )
+{
+    if ( (node < 0) || (node >= SIM_MEDIUM_MAX_NODES) || !Nodes[node].InUse ) {
+        return NULL;
+    }
+    return &Nodes[node];
+}
+
+static double ReceivedPower( Transmission_t *tx, Node_t *node )
+{
+    double dx = (double) node->X - tx->X;
+    double dy = (double) node->Y - tx->Y;
+    double distance = sqrt(dx * dx + dy * dy);
+
+    if ( distance < 1.0 ) {
+        distance = 1.0;
+    }
+    return tx->Power - SIM_MEDIUM_REF_PATH_LOSS
+            - 10.0 * SIM_MEDIUM_PATH_LOSS_EXPONENT * log10(distance);
+}
+
+static double NoiseFloor( uint32_t bandwidth )
+{
+    return -174.0 + 10.0 * log10((double) bandwidth) + SIM_MEDIUM_NOISE_FIGURE;
+}
+
+static double Sensitivity( const SimMediumModulation_t *modulation )
+{
+    double snrLimit;
+
+    if ( modulation->Modem == MODEM_LORA ) {
+        /* SF7: -7.5 dB down to SF12: -20 dB */
+        snrLimit = -7.5 - 2.5 * ((double) modulation->Datarate - 7);
+    } else {
+        snrLimit = 10.0;
+    }
+    return NoiseFloor(modulation->Bandwidth) + snrLimit;
+}
+
+static bool IsSameChannel( const SimMediumModulation_t *a, const SimMediumModulation_t *b )
+{
+    /* The FSK bandwidth is a receiver setting, the datarate identifies the channel */
+    return (a->Modem == b->Modem) && (a->Frequency == b->Frequency)
+            && ((a->Modem == MODEM_FSK) || (a->Bandwidth == b->Bandwidth))
+            && (a->Datarate == b->Datarate);
+}
+
+static bool IsReceivable( Transmission_t *tx, Node_t *node )
+{
+    if ( !IsSameChannel(&tx->Modulation, &node->Modulation) ) {
+        return false;
+    }
+    if ( (tx->Modulation.Modem == MODEM_LORA)
+            && (tx->Modulation.IqInverted != node->Modulation.IqInverted) ) {
+        return false;
+    }
+    return ReceivedPower(tx, node) >= Sensitivity(&node->Modulation);
+}
+
+static bool IsChannelActive( Node_t *node )
+{
+    int16_t i;
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+        if ( Transmissions[i].InUse && !Transmissions[i].Aborted
+                && IsSameChannel(&Transmissions[i].Modulation, &node->Modulation)
+                && (ReceivedPower(&Transmissions[i], node) >= Sensitivity(&node->Modulation)) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static double StrongestInterferer( Node_t *node, int16_t index )
+{
+    double power, strongest = POWER_NONE;
+    int16_t i;
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_TRANSMISSIONS; i++ ) {
+        if ( (i == index) || !Transmissions[i].InUse
+                || !IsSameChannel(&Transmissions[i].Modulation, &Transmissions[index].Modulation) ) {
+            continue;
+        }
+        power = ReceivedPower(&Transmissions[i], node);
+        if ( power > strongest ) {
+            strongest = power;
+        }
+    }
+    return strongest;
+}
+
+static void EndTransmission( int16_t index )
+{
+    Transmission_t *tx = &Transmissions[index];
+    Node_t *n;
+    double snr;
+    int16_t i;
+
+    memcpy(RxPayload, tx->Payload, tx->Size);
+
+    n = GetNode(tx->Sender);
+    if ( !tx->Aborted && (n != NULL) && (n->State == NODE_STATE_TX)
+            && (n->Transmission == index) ) {
+        n->State = NODE_STATE_STANDBY;
+        n->Transmission = TRANSMISSION_NONE;
+        if ( n->Events.TxDone != NULL ) {
+            n->Events.TxDone(n->Context);
+        }
+    }
+
+    for ( i = 0; i < SIM_MEDIUM_MAX_NODES; i++ ) {
+        n = &Nodes[i];
+        if ( !n->InUse || (n->State != NODE_STATE_RX) || (n->Transmission != index) ) {
+            continue;
+        }
+        n->Transmission = TRANSMISSION_NONE;
+        if ( !n->RxContinuous ) {
+            n->State = NODE_STATE_STANDBY;
+        }
+
+        if ( tx->Aborted
+                || (n->RxPower - n->InterferencePower < SIM_MEDIUM_CAPTURE_THRESHOLD) ) {
+            if ( n->Events.RxError != NULL ) {
+                n->Events.RxError(n->Context);
+            }
+        } else if ( n->Events.RxDone != NULL ) {
+            snr = 0.0;
+            if ( tx->Modulation.Modem == MODEM_LORA ) {
+                snr = n->RxPower - NoiseFloor(tx->Modulation.Bandwidth);
+                snr = (snr > 127.0) ? 127.0 : snr;
+            }
+            n->Events.RxDone(n->Context, RxPayload, tx->Size, (int16_t) floor(n->RxPower + 0.5),
+                    (int8_t) floor(snr + 0.5));
+        }
+    }
+    /* Freed last, a callback must not reuse the slot of the frame being delivered */
+    tx->InUse = false;
+}
+
+static void EndDeadline( int16_t node )
+{
+    Node_t *n = &Nodes[node];
+    bool activity;
+
+    n->Deadline = SIM_MEDIUM_TIME_NEVER;
+
+    if ( n->State == NODE_STATE_RX ) {
+        n->State = NODE_STATE_STANDBY;
+        if ( n->Events.RxTimeout != NULL ) {
+            n->Events.RxTimeout(n->Context);
+        }
+    } else if ( n->State == NODE_STATE_CAD ) {
+        activity = n->CadActivity || IsChannelActive(n);
+        n->State = NODE_STATE_STANDBY;
+        if ( n->Events.CadDone != NULL ) {
+            n->Events.CadDone(n->Context, activity);
+        }
+    }
+}
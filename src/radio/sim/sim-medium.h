@@ -0,0 +1,188 @@
+/**
+ * \file sim-medium.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Simulated radio medium shared by all the nodes of a simulation
+ *
+ */
+#ifndef __SIM_MEDIUM_H__
+#define __SIM_MEDIUM_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "radio.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Maximum number of nodes attached to the medium */
+#ifndef SIM_MEDIUM_MAX_NODES
+#define SIM_MEDIUM_MAX_NODES                        256
+#endif
+
+/*! Maximum number of simultaneous transmissions on the medium */
+#ifndef SIM_MEDIUM_MAX_TRANSMISSIONS
+#define SIM_MEDIUM_MAX_TRANSMISSIONS                64
+#endif
+
+/*! Maximum payload size of a transmission */
+#define SIM_MEDIUM_MAX_PAYLOAD                      255
+
+/*! Receiver noise figure [dB] */
+#ifndef SIM_MEDIUM_NOISE_FIGURE
+#define SIM_MEDIUM_NOISE_FIGURE                     6
+#endif
+
+/*! Path loss at the reference distance of 1 m [dB] */
+#ifndef SIM_MEDIUM_REF_PATH_LOSS
+#define SIM_MEDIUM_REF_PATH_LOSS                    31.2
+#endif
+
+/*! Log-distance path loss exponent */
+#ifndef SIM_MEDIUM_PATH_LOSS_EXPONENT
+#define SIM_MEDIUM_PATH_LOSS_EXPONENT               2.7
+#endif
+
+/*! Power margin a frame needs over an interferer on the same channel [dB] */
+#ifndef SIM_MEDIUM_CAPTURE_THRESHOLD
+#define SIM_MEDIUM_CAPTURE_THRESHOLD                6
+#endif
+
+/*! Node handle returned if a node could not be attached */
+#define SIM_MEDIUM_NODE_NONE                        (-1)
+
+/*! Time value of an event which never occurs */
+#define SIM_MEDIUM_TIME_NEVER                       UINT64_MAX
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Modulation parameters of a transmission or a reception */
+typedef struct SimMediumModulation_s {
+    RadioModems_t Modem;        //! Radio modem [MODEM_FSK, MODEM_LORA]
+    uint32_t Frequency;         //! RF frequency [Hz]
+    uint32_t Bandwidth;         //! Channel bandwidth [Hz]
+    uint32_t Datarate;          //! LoRa: spreading factor, FSK: bits/s
+    uint8_t Coderate;           //! LoRa coding rate [1: 4/5 .. 4: 4/8]
+    uint16_t PreambleLen;       //! LoRa: symbols, FSK: bytes
+    bool FixLen;                //! Implicit header / fixed length
+    bool CrcOn;                 //! Payload CRC enabled
+    bool IqInverted;            //! LoRa inverted IQ
+    bool LowDatarateOptimize;   //! LoRa low datarate optimization
+} SimMediumModulation_t;
+
+/*!
+ * \brief Callbacks of a node attached to the medium
+ *
+ * \remark The payload passed to RxDone is owned by the medium and is only
+ *         valid during the callback.
+ */
+typedef struct SimMediumEvents_s {
+    void (*TxDone)( void *context );
+    void (*RxDone)( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+    void (*RxError)( void *context );
+    void (*RxTimeout)( void *context );
+    void (*CadDone)( void *context, bool channelActivityDetected );
+} SimMediumEvents_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Detaches all the nodes and resets the medium time to 0.
+ *
+ * \param seed Seed of the medium pseudo random generator.
+ */
+void SimMediumInit( uint32_t seed );
+
+/*!
+ * \brief Attaches a node to the medium.
+ *
+ * \param events Node callbacks.
+ * \param context Context passed to the node callbacks.
+ * \param x Node position [m].
+ * \param y Node position [m].
+ *
+ * \retval int16_t Node handle, SIM_MEDIUM_NODE_NONE if the medium is full.
+ */
+int16_t SimMediumAttach( const SimMediumEvents_t *events, void *context, int32_t x, int32_t y );
+
+/*!
+ * \brief Detaches a node from the medium, an ongoing transmission is aborted.
+ */
+void SimMediumDetach( int16_t node );
+
+/*!
+ * \brief Moves a node.
+ */
+void SimMediumSetPosition( int16_t node, int32_t x, int32_t y );
+
+/*!
+ * \brief Starts a transmission, TxDone is raised after the time on air.
+ *
+ * \retval bool False if the node is busy or too many transmissions are ongoing.
+ */
+bool SimMediumSend( int16_t node, const SimMediumModulation_t *modulation, int8_t power,
+        const uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Puts a node in reception.
+ *
+ * \param timeout Reception timeout [us], 0 waits forever.
+ * \param continuous Stay in reception after a frame has been received.
+ */
+void SimMediumRx( int16_t node, const SimMediumModulation_t *modulation, uint32_t timeout,
+        bool continuous );
+
+/*!
+ * \brief Starts a channel activity detection, CadDone is raised after two symbols.
+ */
+void SimMediumStartCad( int16_t node, const SimMediumModulation_t *modulation );
+
+/*!
+ * \brief Stops any reception, transmission or CAD of a node.
+ */
+void SimMediumStandby( int16_t node );
+
+/*!
+ * \brief Computes the total power received by a node on a frequency.
+ *
+ * \retval int16_t RSSI [dBm], the noise floor if the channel is idle.
+ */
+int16_t SimMediumRssi( int16_t node, uint32_t frequency, uint32_t bandwidth );
+
+/*!
+ * \brief Computes the time on air of a frame.
+ *
+ * \retval uint32_t Time on air [us].
+ */
+uint32_t SimMediumTimeOnAir( const SimMediumModulation_t *modulation, uint8_t size );
+
+/*!
+ * \brief Returns a pseudo random number of the medium generator.
+ */
+uint32_t SimMediumRandom( void );
+
+/*!
+ * \brief Returns the current medium time [us].
+ */
+uint64_t SimMediumGetTime( void );
+
+/*!
+ * \brief Returns the time of the next medium event [us].
+ *
+ * \retval uint64_t Event time, SIM_MEDIUM_TIME_NEVER if no event is pending.
+ */
+uint64_t SimMediumGetNextEventTime( void );
+
+/*!
+ * \brief Advances the medium time and raises all the events due until then.
+ *
+ * \param now New medium time [us], must not be lower than the current one.
+ */
+void SimMediumProcess( uint64_t now );
+
+#endif // __SIM_MEDIUM_H__
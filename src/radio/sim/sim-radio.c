@@ -0,0 +1,352 @@
+/**
+ * \file sim-radio.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Simulated radio driver attached to the simulated radio medium
+ *
+ * The driver keeps the settings of the radio and forwards the operations to
+ * the medium. The medium events are reported to the upper layer through the
+ * RadioEvents callbacks just like the DIO interrupts of a real transceiver.
+ * FHSS is not simulated.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <string.h>
+#include "sim-radio.h"
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+typedef struct {
+    RadioState_t State;
+    RadioModems_t Modem;
+    int16_t Node;
+    int32_t X;
+    int32_t Y;
+    int8_t TxPower;
+    uint16_t SymbTimeout;
+    bool RxContinuous;
+    uint8_t MaxPayloadLength;
+    SimMediumModulation_t Rx;
+    SimMediumModulation_t Tx;
+} SimRadioSettings_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static SimRadioSettings_t Settings = { .State = RF_IDLE, .Node = SIM_MEDIUM_NODE_NONE,
+        .TxPower = SIM_RADIO_DEFAULT_POWER, .MaxPayloadLength = SIM_MEDIUM_MAX_PAYLOAD };
+
+/*! Radio events function pointer */
+static RadioEvents_t *RadioEvents;
+
+/*! Register shadow, only used by Read/Write accesses of the upper layers */
+static uint8_t Registers[0x80];
+
+/*! Reception buffer */
+static uint8_t RxBuffer[SIM_MEDIUM_MAX_PAYLOAD];
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static void OnTxDone( void *context );
+static void OnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+static void OnRxError( void *context );
+static void OnRxTimeout( void *context );
+static void OnCadDone( void *context, bool channelActivityDetected );
+static void SetModulation( SimMediumModulation_t *modulation, RadioModems_t modem,
+        uint32_t bandwidth, uint32_t datarate, uint8_t coderate, uint16_t preambleLen, bool fixLen,
+        bool crcOn, bool iqInverted );
+
+/*! Medium events of the radio */
+static const SimMediumEvents_t MediumEvents = { OnTxDone, OnRxDone, OnRxError, OnRxTimeout,
+        OnCadDone };
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void SimRadioSetPosition( int32_t x, int32_t y )
+{
+    Settings.X = x;
+    Settings.Y = y;
+    SimMediumSetPosition(Settings.Node, x, y);
+}
+
+int16_t SimRadioGetNode( void )
+{
+    return Settings.Node;
+}
+
+void SimRadioInit( RadioEvents_t *events )
+{
+    RadioEvents = events;
+
+    if ( Settings.Node == SIM_MEDIUM_NODE_NONE ) {
+        Settings.Node = SimMediumAttach(&MediumEvents, NULL, Settings.X, Settings.Y);
+    }
+    SimRadioReset();
+    SimRadioSetModem(MODEM_FSK);
+}
+
+void SimRadioReset( void )
+{
+    SimMediumStandby(Settings.Node);
+    Settings.State = RF_IDLE;
+    memset(Registers, 0, sizeof(Registers));
+}
+
+RadioState_t SimRadioGetStatus( void )
+{
+    return Settings.State;
+}
+
+void SimRadioSetModem( RadioModems_t modem )
+{
+    Settings.Modem = modem;
+    Settings.Rx.Modem = modem;
+    Settings.Tx.Modem = modem;
+}
+
+void SimRadioSetChannel( uint32_t freq )
+{
+    Settings.Rx.Frequency = freq;
+    Settings.Tx.Frequency = freq;
+}
+
+bool SimRadioIsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh )
+{
+    SimRadioSetModem(modem);
+    SimRadioSetChannel(freq);
+
+    return SimMediumRssi(Settings.Node, freq, Settings.Rx.Bandwidth) <= rssiThresh;
+}
+
+uint32_t SimRadioRandom( void )
+{
+    return SimMediumRandom();
+}
+
+void SimRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate,
+        uint8_t coderate, uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout,
+        bool fixLen, uint8_t payloadLen, bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+        bool iqInverted, bool rxContinuous )
+{
+    (void) bandwidthAfc;
+    (void) payloadLen;
+    (void) freqHopOn;
+    (void) hopPeriod;
+
+    SimRadioSetModem(modem);
+    SetModulation(&Settings.Rx, modem, bandwidth, datarate, coderate, preambleLen, fixLen,
+            crcOn, iqInverted);
+    Settings.SymbTimeout = symbTimeout;
+    Settings.RxContinuous = rxContinuous;
+}
+
+void SimRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth,
+        uint32_t datarate, uint8_t coderate, uint16_t preambleLen, bool fixLen, bool crcOn,
+        bool freqHopOn, uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+    (void) freqHopOn;
+    (void) hopPeriod;
+    (void) timeout;
+
+    SimRadioSetModem(modem);
+    if ( modem == MODEM_FSK ) {
+        /* Carson bandwidth, only used for the noise floor of FSK frames */
+        bandwidth = 2 * fdev + datarate;
+    }
+    SetModulation(&Settings.Tx, modem, bandwidth, datarate, coderate, preambleLen, fixLen, crcOn,
+            iqInverted);
+    Settings.TxPower = power;
+}
+
+bool SimRadioCheckRfFrequency( uint32_t frequency )
+{
+    return (frequency >= 137000000) && (frequency <= 1020000000);
+}
+
+uint32_t SimRadioGetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
+{
+    SimMediumModulation_t modulation = Settings.Tx;
+
+    modulation.Modem = modem;
+    return SimMediumTimeOnAir(&modulation, pktLen);
+}
+
+void SimRadioSend( uint8_t *buffer, uint8_t size )
+{
+    Settings.State = RF_TX_RUNNING;
+
+    if ( !SimMediumSend(Settings.Node, &Settings.Tx, Settings.TxPower, buffer, size) ) {
+        Settings.State = RF_IDLE;
+        if ( (RadioEvents != NULL) && (RadioEvents->TxTimeout != NULL) ) {
+            RadioEvents->TxTimeout();
+        }
+    }
+}
+
+void SimRadioSetSleep( void )
+{
+    SimMediumStandby(Settings.Node);
+    Settings.State = RF_IDLE;
+}
+
+void SimRadioSetStby( void )
+{
+    SimMediumStandby(Settings.Node);
+    Settings.State = RF_IDLE;
+}
+
+void SimRadioSetRx( uint32_t timeout )
+{
+    uint32_t symbTimeout;
+
+    if ( (Settings.Modem == MODEM_LORA) && !Settings.RxContinuous
+            && (Settings.SymbTimeout != 0) ) {
+        /* Single reception mode times out after SymbTimeout symbols */
+        symbTimeout = (uint32_t) (((uint64_t) Settings.SymbTimeout * 1000000
+                << Settings.Rx.Datarate) / Settings.Rx.Bandwidth);
+        if ( (timeout == 0) || (symbTimeout < timeout) ) {
+            timeout = symbTimeout;
+        }
+    }
+
+    Settings.State = RF_RX_RUNNING;
+    SimMediumRx(Settings.Node, &Settings.Rx, timeout, Settings.RxContinuous);
+}
+
+void SimRadioStartCad( void )
+{
+    Settings.State = RF_CAD;
+    SimMediumStartCad(Settings.Node, &Settings.Rx);
+}
+
+int16_t SimRadioReadRssi( RadioModems_t modem )
+{
+    (void) modem;
+
+    return SimMediumRssi(Settings.Node, Settings.Rx.Frequency, Settings.Rx.Bandwidth);
+}
+
+void SimRadioWrite( uint8_t addr, uint8_t data )
+{
+    Registers[addr & 0x7F] = data;
+}
+
+uint8_t SimRadioRead( uint8_t addr )
+{
+    return Registers[addr & 0x7F];
+}
+
+void SimRadioWriteBuffer( uint8_t addr, uint8_t *buffer, uint8_t size )
+{
+    uint8_t i;
+
+    for ( i = 0; i < size; i++ ) {
+        SimRadioWrite(addr + i, buffer[i]);
+    }
+}
+
+void SimRadioReadBuffer( uint8_t addr, uint8_t *buffer, uint8_t size )
+{
+    uint8_t i;
+
+    for ( i = 0; i < size; i++ ) {
+        buffer[i] = SimRadioRead(addr + i);
+    }
+}
+
+void SimRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+    SimRadioSetModem(modem);
+    Settings.MaxPayloadLength = max;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void OnTxDone( void *context )
+{
+    (void) context;
+
+    Settings.State = RF_IDLE;
+    if ( (RadioEvents != NULL) && (RadioEvents->TxDone != NULL) ) {
+        RadioEvents->TxDone();
+    }
+}
+
+static void OnRxDone( void *context, uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    (void) context;
+
+    if ( !Settings.RxContinuous ) {
+        Settings.State = RF_IDLE;
+    }
+    if ( size > Settings.MaxPayloadLength ) {
+        OnRxError(context);
+        return;
+    }
+    memcpy(RxBuffer, payload, size);
+    if ( (RadioEvents != NULL) && (RadioEvents->RxDone != NULL) ) {
+        RadioEvents->RxDone(RxBuffer, size, rssi, snr);
+    }
+}
+
+static void OnRxError( void *context )
+{
+    (void) context;
+
+    if ( !Settings.RxContinuous ) {
+        Settings.State = RF_IDLE;
+    }
+    if ( (RadioEvents != NULL) && (RadioEvents->RxError != NULL) ) {
+        RadioEvents->RxError();
+    }
+}
+
+static void OnRxTimeout( void *context )
+{
+    (void) context;
+
+    Settings.State = RF_IDLE;
+    if ( (RadioEvents != NULL) && (RadioEvents->RxTimeout != NULL) ) {
+        RadioEvents->RxTimeout();
+    }
+}
+
+static void OnCadDone( void *context, bool channelActivityDetected )
+{
+    (void) context;
+
+    Settings.State = RF_IDLE;
+    if ( (RadioEvents != NULL) && (RadioEvents->CadDone != NULL) ) {
+        RadioEvents->CadDone(channelActivityDetected);
+    }
+}
+
+static void SetModulation( SimMediumModulation_t *modulation, RadioModems_t modem,
+        uint32_t bandwidth, uint32_t datarate, uint8_t coderate, uint16_t preambleLen, bool fixLen,
+        bool crcOn, bool iqInverted )
+{
+    modulation->Modem = modem;
+    modulation->Datarate = datarate;
+    modulation->Coderate = coderate;
+    modulation->PreambleLen = preambleLen;
+    modulation->FixLen = fixLen;
+    modulation->CrcOn = crcOn;
+    modulation->IqInverted = iqInverted;
+    modulation->LowDatarateOptimize = false;
+
+    if ( modem == MODEM_LORA ) {
+        /* LoRa bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz] */
+        modulation->Bandwidth = 125000UL << ((bandwidth > 2) ? 2 : bandwidth);
+        modulation->LowDatarateOptimize = ((bandwidth == 0) && ((datarate == 11)
+                || (datarate == 12))) || ((bandwidth == 1) && (datarate == 12));
+    } else {
+        modulation->Bandwidth = bandwidth;
+        modulation->IqInverted = false;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * \file sim-radio.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Simulated radio driver attached to the simulated radio medium
+ *
+ */
+#ifndef __SIM_RADIO_H__
+#define __SIM_RADIO_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "radio.h"
+#include "sim-medium.h"
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*!
+ * Radio wakeup time from SLEEP mode, same as the SX1276 one so that the MAC
+ * opens its reception windows with the usual margin
+ */
+#define RADIO_WAKEUP_TIME                           1000 // [us]
+
+/*! Default transmit power of the simulated radio [dBm] */
+#define SIM_RADIO_DEFAULT_POWER                     14
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Places the radio, to be called before SimRadioInit.
+ *
+ * \param x Node position [m].
+ * \param y Node position [m].
+ */
+void SimRadioSetPosition( int32_t x, int32_t y );
+
+/*!
+ * \brief Returns the medium node handle of the radio.
+ */
+int16_t SimRadioGetNode( void );
+
+/*!
+ * \brief Radio driver functions, see struct Radio_s.
+ */
+void SimRadioInit( RadioEvents_t *events );
+void SimRadioReset( void );
+RadioState_t SimRadioGetStatus( void );
+void SimRadioSetModem( RadioModems_t modem );
+void SimRadioSetChannel( uint32_t freq );
+bool SimRadioIsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh );
+uint32_t SimRadioRandom( void );
+void SimRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate,
+        uint8_t coderate, uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout,
+        bool fixLen, uint8_t payloadLen, bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+        bool iqInverted, bool rxContinuous );
+void SimRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth,
+        uint32_t datarate, uint8_t coderate, uint16_t preambleLen, bool fixLen, bool crcOn,
+        bool freqHopOn, uint8_t hopPeriod, bool iqInverted, uint32_t timeout );
+bool SimRadioCheckRfFrequency( uint32_t frequency );
+uint32_t SimRadioGetTimeOnAir( RadioModems_t modem, uint8_t pktLen );
+void SimRadioSend( uint8_t *buffer, uint8_t size );
+void SimRadioSetSleep( void );
+void SimRadioSetStby( void );
+void SimRadioSetRx( uint32_t timeout );
+void SimRadioStartCad( void );
+int16_t SimRadioReadRssi( RadioModems_t modem );
+void SimRadioWrite( uint8_t addr, uint8_t data );
+uint8_t SimRadioRead( uint8_t addr );
+void SimRadioWriteBuffer( uint8_t addr, uint8_t *buffer, uint8_t size );
+void SimRadioReadBuffer( uint8_t addr, uint8_t *buffer, uint8_t size );
+void SimRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max );
+
+#endif // __SIM_RADIO_H__
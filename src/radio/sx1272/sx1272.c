@@ -17,6 +17,7 @@
 #include "board.h"
 #include "radio.h"
 #include "sx1272.h"
+#include "time-on-air.h"
 #include "sx1272-board.h"
 
 /*
@@ -44,6 +45,45 @@ typedef struct {
  * Private functions prototypes
  */
 
+/*!
+ * \brief Writes a 16 bits value to a MSB/LSB register pair
+ */
+static void SX1272WriteRegister16( uint8_t addr, uint16_t value );
+
+/*!
+ * \brief Selects the shadowed registers of the current modem and invalidates
+ *        the register shadow
+ * \remark Must be called after a reset and after a modem change, the LoRa and
+ *         FSK modems map different registers to the same addresses
+ */
+static void SX1272ShadowReset( void );
+
+/*!
+ * \brief Defers the writes of shadowed registers until SX1272FlushWrites
+ * \remark Only used from task context while the radio is not operating
+ */
+static void SX1272DeferWrites( void );
+
+/*!
+ * \brief Writes the deferred registers in contiguous bursts
+ */
+static void SX1272FlushWrites( void );
+
+/*!
+ * \brief Writes registers on the SPI bus, bypassing the register shadow
+ */
+static void SX1272SpiWrite( uint8_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Reads registers on the SPI bus, bypassing the register shadow
+ */
+static void SX1272SpiRead( uint8_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Exchanges the header and the data bytes of one register access
+ */
+static void SX1272SpiTransfer( uint8_t *tx, uint8_t *rx, uint16_t size );
+
 /*!
  * \brief Resets the SX1272
  */
@@ -143,6 +183,66 @@ const FskBandwidth_t FskBandwidths[] = { { 2600, 0x17 }, { 3100, 0x0F }, { 3900,
         0x09 }, { 250000, 0x01 }, { 300000, 0x00 },   // Invalid Badwidth
         };
 
+/*!
+ * Register shadow, 0 sends every register access over SPI (reference of the
+ * host register shadow test)
+ */
+#ifndef SX1272_REG_SHADOW
+#define SX1272_REG_SHADOW                           1
+#endif
+
+/*!
+ * Number of shadowed register addresses [0x00 .. REG_BITRATEFRAC]
+ */
+#define REG_SHADOW_SIZE                             ( REG_BITRATEFRAC + 1 )
+
+/*!
+ * Register shadow flags
+ */
+#define SHADOW_CACHED                               0x01    // Content only changes by driver writes
+#define SHADOW_VALID                                0x02    // Shadow holds the register content
+#define SHADOW_DIRTY                                0x04    // Deferred write pending
+
+/*!
+ * Deferred registers separated by up to this number of valid shadowed
+ * registers are written in the same burst
+ */
+#define SHADOW_MAX_BURST_GAP                        2
+
+/*!
+ * Register accesses shorter than this (header included) are sent with
+ * SpiInOut, setting up a burst transfer costs more than it saves
+ */
+#define SPI_BURST_MIN_SIZE                          8
+
+/*!
+ * Configuration registers shadowed in both modems
+ */
+const uint8_t ShadowRegsCommon[] = { REG_OPMODE, REG_FRFMSB, REG_FRFMID, REG_FRFLSB, REG_PACONFIG,
+        REG_PARAMP, REG_OCP, REG_DIOMAPPING1, REG_DIOMAPPING2, REG_VERSION, REG_AGCREF, REG_AGCTHRESH1,
+        REG_AGCTHRESH2, REG_AGCTHRESH3, REG_PLLHOP, REG_TCXO, REG_PADAC, REG_PLL, REG_PLLLOWPN,
+        REG_BITRATEFRAC };
+
+/*!
+ * Configuration registers shadowed in FSK mode
+ */
+const uint8_t ShadowRegsFsk[] = { REG_BITRATEMSB, REG_BITRATELSB, REG_FDEVMSB, REG_FDEVLSB, REG_RSSICONFIG,
+        REG_RSSICOLLISION, REG_RSSITHRESH, REG_RXBW, REG_AFCBW, REG_OOKPEAK, REG_OOKFIX, REG_OOKAVG,
+        REG_PREAMBLEDETECT, REG_RXTIMEOUT1, REG_RXTIMEOUT2, REG_RXTIMEOUT3, REG_RXDELAY,
+        REG_PREAMBLEMSB, REG_PREAMBLELSB, REG_SYNCCONFIG, REG_SYNCVALUE1, REG_SYNCVALUE2,
+        REG_SYNCVALUE3, REG_SYNCVALUE4, REG_SYNCVALUE5, REG_SYNCVALUE6, REG_SYNCVALUE7,
+        REG_SYNCVALUE8, REG_PACKETCONFIG1, REG_PACKETCONFIG2, REG_PAYLOADLENGTH, REG_NODEADRS,
+        REG_BROADCASTADRS, REG_FIFOTHRESH };
+
+/*!
+ * Configuration registers shadowed in LoRa mode
+ */
+const uint8_t ShadowRegsLoRa[] = { REG_LR_FIFOTXBASEADDR, REG_LR_FIFORXBASEADDR,
+        REG_LR_IRQFLAGSMASK, REG_LR_MODEMCONFIG1, REG_LR_MODEMCONFIG2, REG_LR_SYMBTIMEOUTLSB,
+        REG_LR_PREAMBLEMSB, REG_LR_PREAMBLELSB, REG_LR_PAYLOADLENGTH, REG_LR_PAYLOADMAXLENGTH,
+        REG_LR_HOPPERIOD, REG_LR_DETECTOPTIMIZE, REG_LR_INVERTIQ, REG_LR_DETECTIONTHRESHOLD,
+        REG_LR_SYNCWORD, REG_LR_INVERTIQ2 };
+
 /*
  * Private global variables
  */
@@ -157,6 +257,19 @@ static RadioEvents_t *RadioEvents;
  */
 static uint8_t RxBuffer[RX_BUFFER_SIZE];
 
+/*!
+ * Register shadow, saves the SPI reads of configuration registers and the
+ * writes of unchanged values
+ */
+static uint8_t RegShadow[REG_SHADOW_SIZE];
+static uint8_t RegShadowFlags[REG_SHADOW_SIZE];
+static bool RegShadowDeferred = false;
+
+/*!
+ * SPI frame of a register access: address header followed by the data
+ */
+static uint8_t SpiFrame[1 + 255];
+
 /*
  * Public global variables
  */
@@ -217,11 +330,15 @@ RadioState_t SX1272GetStatus( void )
 
 void SX1272SetChannel( uint32_t freq )
 {
+    uint8_t frf[3];
+
     SX1272.Settings.Channel = freq;
     freq = (uint32_t)((double) freq / (double) FREQ_STEP);
-    SX1272Write(REG_FRFMSB, (uint8_t)((freq >> 16) & 0xFF));
-    SX1272Write(REG_FRFMID, (uint8_t)((freq >> 8) & 0xFF));
-    SX1272Write(REG_FRFLSB, (uint8_t)(freq & 0xFF));
+    frf[0] = (uint8_t)((freq >> 16) & 0xFF);
+    frf[1] = (uint8_t)((freq >> 8) & 0xFF);
+    frf[2] = (uint8_t)(freq & 0xFF);
+    /* REG_FRFMSB, REG_FRFMID and REG_FRFLSB in one burst */
+    SX1272WriteBuffer(REG_FRFMSB, frf, 3);
 }
 
 bool SX1272IsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh )
@@ -304,6 +421,7 @@ void SX1272SetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datara
         bool iqInverted, bool rxContinuous )
 {
     SX1272SetModem(modem);
+    SX1272DeferWrites();
 
     switch ( modem ) {
         case MODEM_FSK:
@@ -317,16 +435,18 @@ void SX1272SetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datara
             SX1272.Settings.Fsk.IqInverted = iqInverted;
             SX1272.Settings.Fsk.RxContinuous = rxContinuous;
             SX1272.Settings.Fsk.PreambleLen = preambleLen;
+            SX1272.Settings.Fsk.SyncWordSize = (SX1272Read(REG_SYNCCONFIG)
+                    & ~RF_SYNCCONFIG_SYNCSIZE_MASK) + 1;
+            SX1272.Settings.Fsk.AddrFilterOn = (SX1272Read(REG_PACKETCONFIG1)
+                    & ~RF_PACKETCONFIG1_ADDRSFILTERING_MASK) != 0x00;
 
             datarate = (uint16_t)((double) XTAL_FREQ / (double) datarate);
-            SX1272Write(REG_BITRATEMSB, (uint8_t)(datarate >> 8));
-            SX1272Write(REG_BITRATELSB, (uint8_t)(datarate & 0xFF));
+            SX1272WriteRegister16(REG_BITRATEMSB, (uint16_t) datarate);
 
             SX1272Write(REG_RXBW, GetFskBandwidthRegValue(bandwidth));
             SX1272Write(REG_AFCBW, GetFskBandwidthRegValue(bandwidthAfc));
 
-            SX1272Write(REG_PREAMBLEMSB, (uint8_t)((preambleLen >> 8) & 0xFF));
-            SX1272Write(REG_PREAMBLELSB, (uint8_t)(preambleLen & 0xFF));
+            SX1272WriteRegister16(REG_PREAMBLEMSB, preambleLen);
 
             if ( fixLen == 1 ) {
                 SX1272Write(REG_PAYLOADLENGTH, payloadLen);
@@ -382,8 +502,7 @@ void SX1272SetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datara
 
             SX1272Write(REG_LR_SYMBTIMEOUTLSB, (uint8_t)(symbTimeout & 0xFF));
 
-            SX1272Write(REG_LR_PREAMBLEMSB, (uint8_t)((preambleLen >> 8) & 0xFF));
-            SX1272Write(REG_LR_PREAMBLELSB, (uint8_t)(preambleLen & 0xFF));
+            SX1272WriteRegister16(REG_LR_PREAMBLEMSB, preambleLen);
 
             if ( fixLen == 1 ) {
                 SX1272Write(REG_LR_PAYLOADLENGTH, payloadLen);
@@ -410,6 +529,7 @@ void SX1272SetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datara
         }
             break;
     }
+    SX1272FlushWrites();
 }
 
 void SX1272SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth,
@@ -420,6 +540,7 @@ void SX1272SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32
     uint8_t paDac = 0;
 
     SX1272SetModem(modem);
+    SX1272DeferWrites();
 
     paConfig = SX1272Read(REG_PACONFIG);
     paDac = SX1272Read(REG_PADAC);
@@ -476,17 +597,18 @@ void SX1272SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32
             SX1272.Settings.Fsk.CrcOn = crcOn;
             SX1272.Settings.Fsk.IqInverted = iqInverted;
             SX1272.Settings.Fsk.TxTimeout = timeout;
+            SX1272.Settings.Fsk.SyncWordSize = (SX1272Read(REG_SYNCCONFIG)
+                    & ~RF_SYNCCONFIG_SYNCSIZE_MASK) + 1;
+            SX1272.Settings.Fsk.AddrFilterOn = (SX1272Read(REG_PACKETCONFIG1)
+                    & ~RF_PACKETCONFIG1_ADDRSFILTERING_MASK) != 0x00;
 
             fdev = (uint16_t)((double) fdev / (double) FREQ_STEP);
-            SX1272Write(REG_FDEVMSB, (uint8_t)(fdev >> 8));
-            SX1272Write(REG_FDEVLSB, (uint8_t)(fdev & 0xFF));
+            SX1272WriteRegister16(REG_FDEVMSB, (uint16_t) fdev);
 
             datarate = (uint16_t)((double) XTAL_FREQ / (double) datarate);
-            SX1272Write(REG_BITRATEMSB, (uint8_t)(datarate >> 8));
-            SX1272Write(REG_BITRATELSB, (uint8_t)(datarate & 0xFF));
+            SX1272WriteRegister16(REG_BITRATEMSB, (uint16_t) datarate);
 
-            SX1272Write(REG_PREAMBLEMSB, (preambleLen >> 8) & 0x00FF);
-            SX1272Write(REG_PREAMBLELSB, preambleLen & 0xFF);
+            SX1272WriteRegister16(REG_PREAMBLEMSB, preambleLen);
 
             SX1272Write(REG_PACKETCONFIG1,
                     (SX1272Read(REG_PACKETCONFIG1) & RF_PACKETCONFIG1_CRC_MASK
@@ -543,8 +665,7 @@ void SX1272SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32
                     (SX1272Read(REG_LR_MODEMCONFIG2) & RFLR_MODEMCONFIG2_SF_MASK)
                             | (datarate << 4));
 
-            SX1272Write(REG_LR_PREAMBLEMSB, (preambleLen >> 8) & 0x00FF);
-            SX1272Write(REG_LR_PREAMBLELSB, preambleLen & 0xFF);
+            SX1272WriteRegister16(REG_LR_PREAMBLEMSB, preambleLen);
 
             if ( datarate == 6 ) {
                 SX1272Write(REG_LR_DETECTOPTIMIZE,
@@ -560,6 +681,7 @@ void SX1272SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32
         }
             break;
     }
+    SX1272FlushWrites();
 }
 
 uint32_t SX1272GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
@@ -569,53 +691,29 @@ uint32_t SX1272GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
     switch ( modem ) {
         case MODEM_FSK:
         {
-            airTime = round(
-                    (8
-                            * (SX1272.Settings.Fsk.PreambleLen
-                                    + ((SX1272Read(REG_SYNCCONFIG) & ~RF_SYNCCONFIG_SYNCSIZE_MASK)
-                                            + 1)
-                                    + ((SX1272.Settings.Fsk.FixLen == 0x01) ? 0.0 : 1.0)
-                                    + (((SX1272Read(REG_PACKETCONFIG1)
-                                            & ~RF_PACKETCONFIG1_ADDRSFILTERING_MASK) != 0x00) ?
-                                            1.0 : 0) + pktLen
-                                    + ((SX1272.Settings.Fsk.CrcOn == 0x01) ? 2.0 : 0))
-                            / SX1272.Settings.Fsk.Datarate) * 1e6);
+            TimeOnAirFsk_t params = {
+                .Datarate = SX1272.Settings.Fsk.Datarate,
+                .PreambleLen = SX1272.Settings.Fsk.PreambleLen,
+                .SyncWordSize = SX1272.Settings.Fsk.SyncWordSize,
+                .FixLen = SX1272.Settings.Fsk.FixLen,
+                .AddrFilterOn = SX1272.Settings.Fsk.AddrFilterOn,
+                .CrcOn = SX1272.Settings.Fsk.CrcOn };
+
+            airTime = TimeOnAirFsk(&params, pktLen);
         }
             break;
         case MODEM_LORA:
         {
-            double bw = 0.0;
-            switch ( SX1272.Settings.LoRa.Bandwidth ) {
-                case 0:   // 125 kHz
-                    bw = 125e3;
-                    break;
-                case 1:   // 250 kHz
-                    bw = 250e3;
-                    break;
-                case 2:   // 500 kHz
-                    bw = 500e3;
-                    break;
-            }
-
-            // Symbol rate : time for one symbol (secs)
-            double rs = bw / (1 << SX1272.Settings.LoRa.Datarate);
-            double ts = 1 / rs;
-            // time of preamble
-            double tPreamble = (SX1272.Settings.LoRa.PreambleLen + 4.25) * ts;
-            // Symbol length of payload and time
-            double tmp = ceil(
-                    (8 * pktLen - 4 * SX1272.Settings.LoRa.Datarate + 28
-                            + 16 * SX1272.Settings.LoRa.CrcOn
-                            - (SX1272.Settings.LoRa.FixLen ? 20 : 0))
-                            / (double) (4 * SX1272.Settings.LoRa.Datarate
-                                    - ((SX1272.Settings.LoRa.LowDatarateOptimize > 0) ? 8 : 0)))
-                    * (SX1272.Settings.LoRa.Coderate + 4);
-            double nPayload = 8 + ((tmp > 0) ? tmp : 0);
-            double tPayload = nPayload * ts;
-            // Time on air
-            double tOnAir = tPreamble + tPayload;
-            // return us secs
-            airTime = floor(tOnAir * 1e6 + 0.999);
+            TimeOnAirLoRa_t params = {
+                .Datarate = SX1272.Settings.LoRa.Datarate,
+                .Bandwidth = SX1272.Settings.LoRa.Bandwidth,
+                .Coderate = SX1272.Settings.LoRa.Coderate,
+                .PreambleLen = SX1272.Settings.LoRa.PreambleLen,
+                .FixLen = SX1272.Settings.LoRa.FixLen,
+                .CrcOn = SX1272.Settings.LoRa.CrcOn,
+                .LowDatarateOptimize = SX1272.Settings.LoRa.LowDatarateOptimize };
+
+            airTime = TimeOnAirLoRa(&params, pktLen);
         }
             break;
     }
@@ -712,6 +810,7 @@ void SX1272SetRx( uint32_t timeout )
 {
     bool rxContinuous = false;
 
+    SX1272DeferWrites();
     switch ( SX1272.Settings.Modem ) {
         case MODEM_FSK:
         {
@@ -790,6 +889,7 @@ void SX1272SetRx( uint32_t timeout )
         }
             break;
     }
+    SX1272FlushWrites();
 
     memset(RxBuffer, 0, (size_t) RX_BUFFER_SIZE);
 
@@ -824,6 +924,7 @@ void SX1272SetTx( uint32_t timeout )
 {
     TimerSetValue(&TxTimeoutTimer, timeout);
 
+    SX1272DeferWrites();
     switch ( SX1272.Settings.Modem ) {
         case MODEM_FSK:
         {
@@ -876,6 +977,7 @@ void SX1272SetTx( uint32_t timeout )
         }
             break;
     }
+    SX1272FlushWrites();
 
     SX1272.Settings.State = RF_TX_RUNNING;
     TimerStart(&TxTimeoutTimer);
@@ -945,6 +1047,9 @@ void SX1272Reset( void )
 
     // Wait 6 ms
     DelayMs(6);
+
+    // All registers are back at their reset values
+    SX1272ShadowReset();
 }
 
 void SX1272SetOpMode( uint8_t opMode )
@@ -985,6 +1090,7 @@ void SX1272SetModem( RadioModems_t modem )
             SX1272Write(REG_OPMODE,
                     (SX1272Read(REG_OPMODE) & RFLR_OPMODE_LONGRANGEMODE_MASK)
                             | RFLR_OPMODE_LONGRANGEMODE_OFF);
+            SX1272ShadowReset();
 
             SX1272Write(REG_DIOMAPPING1, 0x00);
             SX1272Write(REG_DIOMAPPING2, 0x30);   // DIO5=ModeReady
@@ -994,6 +1100,7 @@ void SX1272SetModem( RadioModems_t modem )
             SX1272Write(REG_OPMODE,
                     (SX1272Read(REG_OPMODE) & RFLR_OPMODE_LONGRANGEMODE_MASK)
                             | RFLR_OPMODE_LONGRANGEMODE_ON);
+            SX1272ShadowReset();
 
             SX1272Write(REG_DIOMAPPING1, 0x00);
             SX1272Write(REG_DIOMAPPING2, 0x00);
@@ -1015,35 +1122,210 @@ uint8_t SX1272Read( uint8_t addr )
 
 void SX1272WriteBuffer( uint8_t addr, uint8_t *buffer, uint8_t size )
 {
-    uint8_t i;
+    uint8_t first = size, last = 0;
+    bool deferred = RegShadowDeferred;
+
+    if ( (addr == REG_FIFO) || ((addr + size) > REG_SHADOW_SIZE) ) {
+        SX1272SpiWrite(addr, buffer, size);
+        return;
+    }
+
+    for ( uint8_t i = 0; i < size; i++ ) {
+        if ( ((RegShadowFlags[addr + i] & SHADOW_CACHED) == 0) || ((addr + i) == REG_OPMODE) ) {
+            // The mode bits of REG_OPMODE change by themselves, always write it
+            deferred = false;
+        }
+    }
+
+    for ( uint8_t i = 0; i < size; i++ ) {
+        uint8_t flags = RegShadowFlags[addr + i];
+
+        if ( ((flags & (SHADOW_CACHED | SHADOW_VALID)) != (SHADOW_CACHED | SHADOW_VALID))
+                || (RegShadow[addr + i] != buffer[i]) || ((addr + i) == REG_OPMODE) ) {
+            if ( first == size ) {
+                first = i;
+            }
+            last = i;
+            if ( deferred == true ) {
+                flags |= SHADOW_DIRTY;
+            }
+        }
+        if ( (flags & SHADOW_CACHED) != 0 ) {
+            RegShadow[addr + i] = buffer[i];
+            flags |= SHADOW_VALID;
+        }
+        RegShadowFlags[addr + i] = flags;
+    }
+
+    if ( (first < size) && (deferred == false) ) {
+        // Only the changed part of the burst, unchanged registers in between are written again
+        for ( uint8_t i = first; i <= last; i++ ) {
+            RegShadowFlags[addr + i] &= ~SHADOW_DIRTY;
+        }
+        SX1272SpiWrite(addr + first, buffer + first, last - first + 1);
+    }
+}
+
+void SX1272ReadBuffer( uint8_t addr, uint8_t *buffer, uint8_t size )
+{
+    bool cached = true;
+
+    if ( (addr == REG_FIFO) || ((addr + size) > REG_SHADOW_SIZE) ) {
+        SX1272SpiRead(addr, buffer, size);
+        return;
+    }
+
+    for ( uint8_t i = 0; i < size; i++ ) {
+        if ( (RegShadowFlags[addr + i] & SHADOW_VALID) == 0 ) {
+            cached = false;
+        }
+    }
+    if ( cached == true ) {
+        memcpy(buffer, &RegShadow[addr], size);
+        return;
+    }
+
+    SX1272SpiRead(addr, buffer, size);
+    for ( uint8_t i = 0; i < size; i++ ) {
+        // Deferred writes are newer than the register content
+        if ( (RegShadowFlags[addr + i] & SHADOW_DIRTY) != 0 ) {
+            buffer[i] = RegShadow[addr + i];
+        } else if ( (RegShadowFlags[addr + i] & SHADOW_CACHED) != 0 ) {
+            RegShadow[addr + i] = buffer[i];
+            RegShadowFlags[addr + i] |= SHADOW_VALID;
+        }
+    }
+}
+
+static void SX1272SpiWrite( uint8_t addr, uint8_t *buffer, uint8_t size )
+{
+    SpiFrame[0] = addr | 0x80;
+    memcpy(&SpiFrame[1], buffer, size);
 
     //NSS = 0;
     GpioWrite(&SX1272.Spi.Nss, 0);
 
-    SpiInOut(&SX1272.Spi, addr | 0x80);
-    for ( i = 0; i < size; i++ ) {
-        SpiInOut(&SX1272.Spi, buffer[i]);
-    }
+    SX1272SpiTransfer(SpiFrame, NULL, size + 1);
 
     //NSS = 1;
     GpioWrite(&SX1272.Spi.Nss, 1);
 }
 
-void SX1272ReadBuffer( uint8_t addr, uint8_t *buffer, uint8_t size )
+static void SX1272SpiRead( uint8_t addr, uint8_t *buffer, uint8_t size )
 {
-    uint8_t i;
+    SpiFrame[0] = addr & 0x7F;
+    memset(&SpiFrame[1], 0, size);
 
     //NSS = 0;
     GpioWrite(&SX1272.Spi.Nss, 0);
 
-    SpiInOut(&SX1272.Spi, addr & 0x7F);
+    // In place, every byte is sent before its position is overwritten
+    SX1272SpiTransfer(SpiFrame, SpiFrame, size + 1);
+
+    //NSS = 1;
+    GpioWrite(&SX1272.Spi.Nss, 1);
+
+    memcpy(buffer, &SpiFrame[1], size);
+}
+
+static void SX1272SpiTransfer( uint8_t *tx, uint8_t *rx, uint16_t size )
+{
+    uint16_t i, data;
 
+    if ( size >= SPI_BURST_MIN_SIZE ) {
+        if ( SpiTransfer(&SX1272.Spi, tx, rx, size, NULL) == 0 ) {
+            return;
+        }
+        // Busy: the DMA is taken by a transfer on another bus, the radio
+        // only runs blocking transfers on its own bus
+    }
     for ( i = 0; i < size; i++ ) {
-        buffer[i] = SpiInOut(&SX1272.Spi, 0);
+        data = SpiInOut(&SX1272.Spi, tx[i]);
+        if ( rx != NULL ) {
+            rx[i] = (uint8_t) data;
+        }
     }
+}
 
-    //NSS = 1;
-    GpioWrite(&SX1272.Spi.Nss, 1);
+static void SX1272ShadowReset( void )
+{
+#if ( SX1272_REG_SHADOW == 1 )
+    const uint8_t *regs;
+    uint8_t nbRegs;
+#endif
+
+    RegShadowDeferred = false;
+    memset(RegShadowFlags, 0, sizeof(RegShadowFlags));
+
+#if ( SX1272_REG_SHADOW == 1 )
+    for ( uint8_t i = 0; i < sizeof(ShadowRegsCommon); i++ ) {
+        RegShadowFlags[ShadowRegsCommon[i]] = SHADOW_CACHED;
+    }
+    if ( SX1272.Settings.Modem == MODEM_LORA ) {
+        regs = ShadowRegsLoRa;
+        nbRegs = sizeof(ShadowRegsLoRa);
+    } else {
+        regs = ShadowRegsFsk;
+        nbRegs = sizeof(ShadowRegsFsk);
+    }
+    for ( uint8_t i = 0; i < nbRegs; i++ ) {
+        RegShadowFlags[regs[i]] = SHADOW_CACHED;
+    }
+#endif
+}
+
+static void SX1272DeferWrites( void )
+{
+    RegShadowDeferred = true;
+}
+
+static void SX1272FlushWrites( void )
+{
+    uint8_t addr = 0, start, end, gap;
+
+    RegShadowDeferred = false;
+
+    while ( addr < REG_SHADOW_SIZE ) {
+        if ( (RegShadowFlags[addr] & SHADOW_DIRTY) == 0 ) {
+            addr++;
+            continue;
+        }
+        // Extend the burst over the following dirty registers and short gaps of valid ones
+        start = addr;
+        end = addr;
+        gap = 0;
+        for ( addr = start + 1; addr < REG_SHADOW_SIZE; addr++ ) {
+            if ( (RegShadowFlags[addr] & SHADOW_DIRTY) != 0 ) {
+                end = addr;
+                gap = 0;
+            } else if ( ((RegShadowFlags[addr] & SHADOW_VALID) != 0) && (addr != REG_OPMODE)
+                    && (gap < SHADOW_MAX_BURST_GAP) ) {
+                gap++;
+            } else {
+                break;
+            }
+        }
+        for ( uint8_t i = start; i <= end; i++ ) {
+            RegShadowFlags[i] &= ~SHADOW_DIRTY;
+        }
+        SX1272SpiWrite(start, &RegShadow[start], end - start + 1);
+        addr = end + 1;
+    }
+}
+
+/*!
+ * Writes a 16 bits value to a MSB/LSB register pair in a single burst
+ *
+ * \param [IN] addr  MSB register address
+ * \param [IN] value Value to be written
+ */
+static void SX1272WriteRegister16( uint8_t addr, uint16_t value )
+{
+    uint8_t buffer[2];
+
+    buffer[0] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[1] = (uint8_t)(value & 0xFF);
+    SX1272WriteBuffer(addr, buffer, 2);
 }
 
 void SX1272WriteFifo( uint8_t *buffer, uint8_t size )
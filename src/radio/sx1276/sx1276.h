@@ -33,7 +33,9 @@ typedef struct {
     uint32_t BandwidthAfc;
     uint32_t Datarate;
     uint16_t PreambleLen;
+    uint8_t SyncWordSize;
     bool FixLen;
+    bool AddrFilterOn;
     uint8_t PayloadLen;
     bool CrcOn;
     bool IqInverted;
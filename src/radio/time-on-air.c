@@ -0,0 +1,158 @@
+/**
+ * \file time-on-air.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Integer time on air calculator for the LoRa and FSK modems
+ *
+ * The LoRa symbol time 2^SF / BW is an integer multiple of 4 us for every
+ * supported spreading factor and bandwidth. The preamble (PreambleLen + 4.25
+ * symbols) and the payload symbols are therefore computed exactly in integer
+ * arithmetic and give the same result as the floating point formula of the
+ * SX1276 datasheet rounded up to the next us.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "time-on-air.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Quarter of a symbol time [us] for a spreading factor and a bandwidth [kHz] */
+#define QUARTER_SYMBOL_TIME(sf, bw)                 ((250u << (sf)) / (bw))
+
+/*! Quarter symbol times of the spreading factors 6 .. 12 for a bandwidth [kHz] */
+#define QUARTER_SYMBOL_TIMES(bw)                    { QUARTER_SYMBOL_TIME(6, bw), \
+                                                      QUARTER_SYMBOL_TIME(7, bw), \
+                                                      QUARTER_SYMBOL_TIME(8, bw), \
+                                                      QUARTER_SYMBOL_TIME(9, bw), \
+                                                      QUARTER_SYMBOL_TIME(10, bw), \
+                                                      QUARTER_SYMBOL_TIME(11, bw), \
+                                                      QUARTER_SYMBOL_TIME(12, bw) }
+
+/*! Symbols added to the programmed preamble length, in quarter symbols */
+#define PREAMBLE_EXTRA_QUARTER_SYMBOLS              17
+
+/*! Symbols of the LoRa frame always sent with coding rate 4/8 */
+#define HEADER_SYMBOLS                              8
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Quarter symbol times [us], indexed by bandwidth and spreading factor */
+static const uint16_t QuarterSymbolTimes[TIME_ON_AIR_LORA_BW_COUNT][TIME_ON_AIR_LORA_SF_MAX
+        - TIME_ON_AIR_LORA_SF_MIN + 1] = {
+        QUARTER_SYMBOL_TIMES(125),
+        QUARTER_SYMBOL_TIMES(250),
+        QUARTER_SYMBOL_TIMES(500) };
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static uint32_t QuarterSymbolTime( uint8_t datarate, uint8_t bandwidth );
+static uint32_t FskOverhead( const TimeOnAirFsk_t *params );
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+uint32_t TimeOnAirLoRaSymbolTime( uint8_t datarate, uint8_t bandwidth )
+{
+    return 4 * QuarterSymbolTime(datarate, bandwidth);
+}
+
+uint32_t TimeOnAirLoRaPayloadSymbols( const TimeOnAirLoRa_t *params, uint8_t pktLen )
+{
+    int32_t bits;
+    int32_t bitsPerBlock;
+
+    bits = 8 * (int32_t) pktLen - 4 * (int32_t) params->Datarate + 28
+            + (params->CrcOn ? 16 : 0) - (params->FixLen ? 20 : 0);
+    bitsPerBlock = 4 * ((int32_t) params->Datarate - (params->LowDatarateOptimize ? 2 : 0));
+
+    if ( (bits <= 0) || (bitsPerBlock <= 0) ) {
+        return HEADER_SYMBOLS;
+    }
+    return HEADER_SYMBOLS
+            + ((uint32_t)(bits + bitsPerBlock - 1) / (uint32_t) bitsPerBlock)
+                    * (params->Coderate + 4);
+}
+
+uint32_t TimeOnAirLoRa( const TimeOnAirLoRa_t *params, uint8_t pktLen )
+{
+    uint32_t quarterSymbol = QuarterSymbolTime(params->Datarate, params->Bandwidth);
+
+    if ( quarterSymbol == 0 ) {
+        return 0;
+    }
+    return (4 * (uint32_t) params->PreambleLen + PREAMBLE_EXTRA_QUARTER_SYMBOLS) * quarterSymbol
+            + TimeOnAirLoRaPayloadSymbols(params, pktLen) * 4 * quarterSymbol;
+}
+
+int16_t TimeOnAirLoRaMaxPayload( const TimeOnAirLoRa_t *params, uint32_t airTime )
+{
+    int16_t low = 0;
+    int16_t high = TIME_ON_AIR_MAX_PAYLOAD;
+    int16_t mid;
+
+    if ( (QuarterSymbolTime(params->Datarate, params->Bandwidth) == 0)
+            || (TimeOnAirLoRa(params, 0) > airTime) ) {
+        return TIME_ON_AIR_NO_PAYLOAD;
+    }
+    /* The time on air grows with the payload size, search the last one fitting */
+    while ( low < high ) {
+        mid = (low + high + 1) / 2;
+        if ( TimeOnAirLoRa(params, (uint8_t) mid) <= airTime ) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+uint32_t TimeOnAirFsk( const TimeOnAirFsk_t *params, uint8_t pktLen )
+{
+    uint64_t bits;
+
+    if ( params->Datarate == 0 ) {
+        return 0;
+    }
+    bits = 8 * (uint64_t)(FskOverhead(params) + pktLen);
+    return (uint32_t)((bits * 1000000 + params->Datarate / 2) / params->Datarate);
+}
+
+int16_t TimeOnAirFskMaxPayload( const TimeOnAirFsk_t *params, uint32_t airTime )
+{
+    uint64_t bytes;
+
+    if ( (params->Datarate == 0) || (TimeOnAirFsk(params, 0) > airTime) ) {
+        return TIME_ON_AIR_NO_PAYLOAD;
+    }
+    /* Largest byte count n with round(8 * n * 1e6 / datarate) <= airTime, that is
+     * 16 * n * 1e6 < (2 * airTime + 1) * datarate */
+    bytes = ((2 * (uint64_t) airTime + 1) * params->Datarate - 1) / 16000000;
+    bytes -= FskOverhead(params);
+    return (bytes > TIME_ON_AIR_MAX_PAYLOAD) ? TIME_ON_AIR_MAX_PAYLOAD : (int16_t) bytes;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint32_t QuarterSymbolTime( uint8_t datarate, uint8_t bandwidth )
+{
+    if ( (datarate < TIME_ON_AIR_LORA_SF_MIN) || (datarate > TIME_ON_AIR_LORA_SF_MAX)
+            || (bandwidth >= TIME_ON_AIR_LORA_BW_COUNT) ) {
+        return 0;
+    }
+    return QuarterSymbolTimes[bandwidth][datarate - TIME_ON_AIR_LORA_SF_MIN];
+}
+
+/*!
+ * \brief Returns the number of bytes sent in addition to the payload.
+ */
+static uint32_t FskOverhead( const TimeOnAirFsk_t *params )
+{
+    return (uint32_t) params->PreambleLen + params->SyncWordSize + (params->FixLen ? 0 : 1)
+            + (params->AddrFilterOn ? 1 : 0) + (params->CrcOn ? 2 : 0);
+}
@@ -0,0 +1,116 @@
+/**
+ * \file time-on-air.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Integer time on air calculator for the LoRa and FSK modems
+ *
+ * The functions only use the given modulation parameters, they never access
+ * the radio and may be called from interrupt context.
+ */
+#ifndef __TIME_ON_AIR_H__
+#define __TIME_ON_AIR_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Smallest and largest supported LoRa spreading factor */
+#define TIME_ON_AIR_LORA_SF_MIN                     6
+#define TIME_ON_AIR_LORA_SF_MAX                     12
+
+/*! Number of supported LoRa bandwidths [0: 125 kHz, 1: 250 kHz, 2: 500 kHz] */
+#define TIME_ON_AIR_LORA_BW_COUNT                   3
+
+/*! Largest payload size handled by the radio drivers */
+#define TIME_ON_AIR_MAX_PAYLOAD                     255
+
+/*! Returned by the inverse queries if not even an empty frame fits */
+#define TIME_ON_AIR_NO_PAYLOAD                      (-1)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! LoRa modulation parameters */
+typedef struct TimeOnAirLoRa_s {
+    uint8_t Datarate;               //! Spreading factor [6 .. 12]
+    uint8_t Bandwidth;              //! [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+    uint8_t Coderate;               //! [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8]
+    uint16_t PreambleLen;           //! Preamble length [symbols]
+    bool FixLen;                    //! Implicit header mode
+    bool CrcOn;                     //! Payload CRC enabled
+    bool LowDatarateOptimize;       //! Low datarate optimization enabled
+} TimeOnAirLoRa_t;
+
+/*! FSK modulation parameters */
+typedef struct TimeOnAirFsk_s {
+    uint32_t Datarate;              //! Bitrate [bits/s]
+    uint16_t PreambleLen;           //! Preamble length [bytes]
+    uint8_t SyncWordSize;           //! Sync word length [bytes]
+    bool FixLen;                    //! Fixed length packets, no length byte
+    bool AddrFilterOn;              //! Address byte present
+    bool CrcOn;                     //! Payload CRC enabled
+} TimeOnAirFsk_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Returns the LoRa symbol time.
+ *
+ * \param datarate Spreading factor [6 .. 12].
+ * \param bandwidth Bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz].
+ * \retval Symbol time [us], 0 if the modulation is not supported.
+ */
+uint32_t TimeOnAirLoRaSymbolTime( uint8_t datarate, uint8_t bandwidth );
+
+/*!
+ * \brief Returns the number of symbols of a LoRa frame after the preamble.
+ *
+ * \param params LoRa modulation parameters.
+ * \param pktLen Payload size [bytes].
+ * \retval Number of header and payload symbols.
+ */
+uint32_t TimeOnAirLoRaPayloadSymbols( const TimeOnAirLoRa_t *params, uint8_t pktLen );
+
+/*!
+ * \brief Computes the time on air of a LoRa frame.
+ *
+ * \param params LoRa modulation parameters.
+ * \param pktLen Payload size [bytes].
+ * \retval Time on air [us], 0 if the modulation is not supported.
+ */
+uint32_t TimeOnAirLoRa( const TimeOnAirLoRa_t *params, uint8_t pktLen );
+
+/*!
+ * \brief Returns the largest LoRa payload which fits in the given time.
+ *
+ * \param params LoRa modulation parameters.
+ * \param airTime Available time [us].
+ * \retval Payload size [bytes], TIME_ON_AIR_NO_PAYLOAD if none fits.
+ */
+int16_t TimeOnAirLoRaMaxPayload( const TimeOnAirLoRa_t *params, uint32_t airTime );
+
+/*!
+ * \brief Computes the time on air of a FSK frame.
+ *
+ * \param params FSK modulation parameters.
+ * \param pktLen Payload size [bytes].
+ * \retval Time on air [us], 0 if the datarate is 0.
+ */
+uint32_t TimeOnAirFsk( const TimeOnAirFsk_t *params, uint8_t pktLen );
+
+/*!
+ * \brief Returns the largest FSK payload which fits in the given time.
+ *
+ * \param params FSK modulation parameters.
+ * \param airTime Available time [us].
+ * \retval Payload size [bytes], TIME_ON_AIR_NO_PAYLOAD if none fits.
+ */
+int16_t TimeOnAirFskMaxPayload( const TimeOnAirFsk_t *params, uint32_t airTime );
+
+#endif // __TIME_ON_AIR_H__
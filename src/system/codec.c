@@ -0,0 +1,363 @@
+/**
+ * \file codec.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Sensor payload codec
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "codec.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define CODEC_KEYFRAME                              0x80
+#define CODEC_SEQ_MASK                              0x7F
+#define CODEC_SEQ_UNUSED                            0xFF
+
+#define CODEC_MASK_SIZE(nbFields)                   (((nbFields) + 7) / 8)
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*! \brief Encodes a keyframe */
+static uint8_t EncodeKeyframe( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf );
+
+/*! \brief Encodes a delta to the reference, 0 if larger than maxSize */
+static uint8_t EncodeDelta( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf,
+        uint8_t maxSize );
+
+/*! \brief Decodes the field values of a keyframe */
+static uint8_t DecodeKeyframe( const CodecConfig_t *config, const uint8_t *buf, uint8_t size,
+        int32_t *values );
+
+/*! \brief Decodes the field values of a delta */
+static uint8_t DecodeDelta( CodecDecoder_t *dec, const uint8_t *buf, uint8_t size,
+        int32_t *values );
+
+/*! \brief Writes a LEB128 varint, returns the number of bytes or 0 if it does not fit */
+static uint8_t PutVarint( uint8_t *buf, uint8_t size, uint32_t value );
+
+/*! \brief Reads a LEB128 varint, returns the number of bytes or 0 if truncated */
+static uint8_t GetVarint( const uint8_t *buf, uint8_t size, uint32_t *value );
+
+/*! \brief Returns the dictionary index of a value, -1 if not found */
+static int16_t DictLookup( const CodecConfig_t *config, int32_t value );
+
+/*! \brief Truncates a value to the field width, sign-extended for signed fields */
+static int32_t FieldValue( const CodecField_t *field, uint32_t value );
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void CodecEncoderInit( CodecEncoder_t *enc, const CodecConfig_t *config )
+{
+    memset1((uint8_t*) enc, 0, sizeof(CodecEncoder_t));
+    enc->Config = config;
+    enc->SentSeq = CODEC_SEQ_UNUSED;
+}
+
+void CodecEncoderReset( CodecEncoder_t *enc )
+{
+    enc->HasRef = false;
+    /* An acknowledgement still outstanding must not restore the reference */
+    enc->SentSeq = CODEC_SEQ_UNUSED;
+}
+
+uint8_t CodecEncode( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf, uint8_t size )
+{
+    const CodecConfig_t *config = enc->Config;
+    uint16_t keyBits = 0, rawSize = 0;
+    uint8_t encSize = 0, keySize, interval, i;
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        rawSize += (config->Fields[i].Bits + 7) / 8;
+        keyBits += config->Fields[i].Bits;
+    }
+    keySize = 1 + (keyBits + 7) / 8;
+
+    /* The 7 bit sequence numbers of the reference and of the sample must not
+     * wrap between two keyframes */
+    interval = (config->KeyframeInterval > CODEC_SEQ_MASK) ? CODEC_SEQ_MASK :
+            config->KeyframeInterval;
+    if ( enc->HasRef && enc->RefAge < CODEC_SEQ_MASK && enc->SinceKeyframe + 1 < interval ) {
+        /* Delta only if smaller than the keyframe */
+        encSize = EncodeDelta(enc, values, buf, (keySize - 1 < size) ? keySize - 1 : size);
+    }
+    if ( encSize == 0 ) {
+        if ( keySize > size ) {
+            return 0;
+        }
+        encSize = EncodeKeyframe(enc, values, buf);
+        enc->SinceKeyframe = 0;
+        enc->Stats.Keyframes++;
+    } else {
+        enc->SinceKeyframe++;
+    }
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        enc->Sent[i] = FieldValue(&config->Fields[i], (uint32_t) values[i]);
+    }
+    enc->SentSeq = enc->Seq;
+    if ( !config->AckRequired ) {
+        CodecAck(enc, enc->SentSeq);
+    }
+    enc->Seq = (enc->Seq + 1) & CODEC_SEQ_MASK;
+    if ( enc->RefAge < CODEC_SEQ_MASK ) {
+        enc->RefAge++;
+    }
+
+    enc->Stats.Samples++;
+    enc->Stats.RawBytes += rawSize;
+    enc->Stats.Bytes += encSize;
+    return encSize;
+}
+
+void CodecAck( CodecEncoder_t *enc, uint8_t seq )
+{
+    /* Acknowledgements of older samples come too late */
+    if ( (seq & CODEC_SEQ_MASK) != enc->SentSeq ) {
+        return;
+    }
+    memcpy1((uint8_t*) enc->Ref, (uint8_t*) enc->Sent, sizeof(enc->Ref));
+    enc->RefSeq = enc->SentSeq;
+    enc->RefAge = 0;
+    enc->HasRef = true;
+}
+
+void CodecDecoderInit( CodecDecoder_t *dec, const CodecConfig_t *config )
+{
+    dec->Config = config;
+    memset1(dec->HistorySeq, CODEC_SEQ_UNUSED, sizeof(dec->HistorySeq));
+    dec->Next = 0;
+}
+
+uint8_t CodecDecode( CodecDecoder_t *dec, const uint8_t *buf, uint8_t size, int32_t *values )
+{
+    uint8_t result;
+
+    if ( size < 1 ) {
+        return ERR_FAILED;
+    }
+    if ( (buf[0] & CODEC_KEYFRAME) != 0 ) {
+        result = DecodeKeyframe(dec->Config, &buf[1], size - 1, values);
+    } else {
+        result = DecodeDelta(dec, &buf[1], size - 1, values);
+    }
+    if ( result != ERR_OK ) {
+        return result;
+    }
+
+    /* Keep the sample as reference of the following deltas */
+    memcpy1((uint8_t*) dec->History[dec->Next], (uint8_t*) values,
+            dec->Config->NbFields * sizeof(int32_t));
+    dec->HistorySeq[dec->Next] = buf[0] & CODEC_SEQ_MASK;
+    dec->Next = (dec->Next + 1) % CODEC_HISTORY_SIZE;
+    return ERR_OK;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static uint8_t EncodeKeyframe( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf )
+{
+    const CodecConfig_t *config = enc->Config;
+    uint32_t acc = 0, value;
+    uint8_t accBits = 0, pos = 0, bits, i;
+
+    buf[pos++] = CODEC_KEYFRAME | enc->Seq;
+    for ( i = 0; i < config->NbFields; i++ ) {
+        value = (uint32_t) values[i];
+        bits = config->Fields[i].Bits;
+        /* Feed the field in chunks that fit into the accumulator */
+        while ( bits > 0 ) {
+            uint8_t chunk = (bits > 24) ? 24 : bits;
+
+            acc |= (value & ((1UL << chunk) - 1)) << accBits;
+            accBits += chunk;
+            value >>= chunk;
+            bits -= chunk;
+            while ( accBits >= 8 ) {
+                buf[pos++] = (uint8_t) acc;
+                acc >>= 8;
+                accBits -= 8;
+            }
+        }
+    }
+    if ( accBits > 0 ) {
+        buf[pos++] = (uint8_t) acc;
+    }
+    return pos;
+}
+
+static uint8_t EncodeDelta( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf,
+        uint8_t maxSize )
+{
+    const CodecConfig_t *config = enc->Config;
+    const CodecField_t *field;
+    uint8_t maskSize = CODEC_MASK_SIZE(config->NbFields);
+    uint8_t pos = 2 + maskSize, len, i;
+    uint32_t diff, token;
+    int16_t idx;
+
+    if ( pos > maxSize ) {
+        return 0;
+    }
+    buf[0] = enc->Seq;
+    buf[1] = enc->RefSeq;
+    memset1(&buf[2], 0, maskSize);
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        field = &config->Fields[i];
+        diff = (uint32_t) FieldValue(field, (uint32_t) values[i]) - (uint32_t) enc->Ref[i];
+        if ( diff == 0 ) {
+            continue;
+        }
+        /* Zig-zag, small differences of either sign give small tokens */
+        token = (diff << 1) ^ (uint32_t)((int32_t) diff >> 31);
+        if ( (field->Flags & CODEC_FIELD_DICT) != 0 ) {
+            idx = DictLookup(config, values[i]);
+            token = (idx >= 0) ? (((uint32_t) idx << 1) | 1) : (token << 1);
+        }
+        if ( (len = PutVarint(&buf[pos], maxSize - pos, token)) == 0 ) {
+            return 0;
+        }
+        pos += len;
+        buf[2 + (i / 8)] |= 1 << (i % 8);
+    }
+    return pos;
+}
+
+static uint8_t DecodeKeyframe( const CodecConfig_t *config, const uint8_t *buf, uint8_t size,
+        int32_t *values )
+{
+    uint32_t acc = 0, value;
+    uint8_t accBits = 0, pos = 0, bits, shift, i;
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        value = 0;
+        shift = 0;
+        bits = config->Fields[i].Bits;
+        while ( bits > 0 ) {
+            uint8_t chunk = (bits > 24) ? 24 : bits;
+
+            while ( accBits < chunk ) {
+                if ( pos >= size ) {
+                    return ERR_FAILED;
+                }
+                acc |= (uint32_t) buf[pos++] << accBits;
+                accBits += 8;
+            }
+            value |= (acc & ((1UL << chunk) - 1)) << shift;
+            acc >>= chunk;
+            accBits -= chunk;
+            shift += chunk;
+            bits -= chunk;
+        }
+        values[i] = FieldValue(&config->Fields[i], value);
+    }
+    return ERR_OK;
+}
+
+static uint8_t DecodeDelta( CodecDecoder_t *dec, const uint8_t *buf, uint8_t size,
+        int32_t *values )
+{
+    const CodecConfig_t *config = dec->Config;
+    const CodecField_t *field;
+    uint8_t maskSize = CODEC_MASK_SIZE(config->NbFields);
+    uint8_t pos = 1 + maskSize, len, i;
+    const int32_t *ref = NULL;
+    uint32_t token;
+
+    if ( size < pos ) {
+        return ERR_FAILED;
+    }
+    for ( i = 0; i < CODEC_HISTORY_SIZE; i++ ) {
+        if ( dec->HistorySeq[i] == buf[0] ) {
+            ref = dec->History[i];
+            break;
+        }
+    }
+    if ( ref == NULL ) {
+        return ERR_NOTAVAIL;
+    }
+
+    for ( i = 0; i < config->NbFields; i++ ) {
+        field = &config->Fields[i];
+        if ( (buf[1 + (i / 8)] & (1 << (i % 8))) == 0 ) {
+            values[i] = ref[i];
+            continue;
+        }
+        if ( (len = GetVarint(&buf[pos], size - pos, &token)) == 0 ) {
+            return ERR_FAILED;
+        }
+        pos += len;
+        if ( (field->Flags & CODEC_FIELD_DICT) != 0 ) {
+            if ( (token & 1) != 0 ) {
+                if ( (token >> 1) >= config->DictSize ) {
+                    return ERR_FAILED;
+                }
+                values[i] = config->Dict[token >> 1];
+                continue;
+            }
+            token >>= 1;
+        }
+        values[i] = FieldValue(field, (uint32_t) ref[i] + ((token >> 1) ^ (0 - (token & 1))));
+    }
+    return (pos == size) ? ERR_OK : ERR_FAILED;
+}
+
+static uint8_t PutVarint( uint8_t *buf, uint8_t size, uint32_t value )
+{
+    uint8_t len = 0;
+
+    do {
+        if ( len >= size ) {
+            return 0;
+        }
+        buf[len++] = (uint8_t)(value & 0x7F) | ((value > 0x7F) ? 0x80 : 0);
+        value >>= 7;
+    } while ( value != 0 );
+    return len;
+}
+
+static uint8_t GetVarint( const uint8_t *buf, uint8_t size, uint32_t *value )
+{
+    uint8_t len = 0;
+
+    *value = 0;
+    while ( len < size && len < 5 ) {
+        *value |= (uint32_t)(buf[len] & 0x7F) << (7 * len);
+        if ( (buf[len++] & 0x80) == 0 ) {
+            return len;
+        }
+    }
+    return 0;
+}
+
+static int16_t DictLookup( const CodecConfig_t *config, int32_t value )
+{
+    uint8_t i;
+
+    for ( i = 0; i < config->DictSize; i++ ) {
+        if ( config->Dict[i] == value ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int32_t FieldValue( const CodecField_t *field, uint32_t value )
+{
+    if ( field->Bits >= 32 ) {
+        return (int32_t) value;
+    }
+    value &= (1UL << field->Bits) - 1;
+    if ( (field->Flags & CODEC_FIELD_SIGNED) != 0 && (value & (1UL << (field->Bits - 1))) != 0 ) {
+        value |= ~((1UL << field->Bits) - 1);
+    }
+    return (int32_t) value;
+}
@@ -0,0 +1,168 @@
+/**
+ * \file codec.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 18.10.2026
+ * \brief Sensor payload codec
+ *
+ * Encodes samples of a fixed set of integer fields, e.g. the binary GPS
+ * position, the altitude and the sensor values of a node. Consecutive samples
+ * change very little, so a sample is sent as difference to a reference sample
+ * the receiver already has.
+ *
+ * Keyframe: <0x80 | seq:1> fields bit-packed with their width, LSB first,
+ *           the last byte padded with zeros
+ * Delta:    <seq:1><refSeq:1><mask:(nbFields + 7) / 8> one varint token per
+ *           field set in the mask, fields equal to the reference are left out
+ *
+ * A token is the zig-zag encoded difference to the reference field as LEB128
+ * varint. Fields with CODEC_FIELD_DICT send (diff << 1) or, if the value is in
+ * the dictionary, (index << 1) | 1.
+ *
+ * Keyframes decode without any state. Every KeyframeInterval samples and
+ * whenever the delta is not smaller a keyframe is sent, so a receiver that
+ * lost frames or has been restarted decodes again at the next keyframe at the
+ * latest. The sequence number has 7 bits, thus the interval is limited to 127
+ * samples and a delta never refers to a reference older than 127 samples.
+ *
+ * With AckRequired the reference is the last sample acknowledged by
+ * CodecAck, e.g. on a confirmed frame. Otherwise every sample becomes the
+ * reference when it is encoded and the keyframes recover from losses.
+ *
+ * Example, the GPS position of a node:
+ *
+ *   static const CodecField_t PosFields[] = {
+ *       { 24, CODEC_FIELD_SIGNED }, // LatitudeBinary
+ *       { 24, CODEC_FIELD_SIGNED }, // LongitudeBinary
+ *       { 16, 0 },                  // Altitude [m]
+ *   };
+ *   static const CodecConfig_t PosConfig = { PosFields, 3, NULL, 0, 16, false };
+ */
+#ifndef __CODEC_H__
+#define __CODEC_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Fields per sample */
+#ifndef CODEC_MAX_FIELDS
+#define CODEC_MAX_FIELDS                            16
+#endif
+
+/*! Samples the decoder keeps as delta references */
+#ifndef CODEC_HISTORY_SIZE
+#define CODEC_HISTORY_SIZE                          4
+#endif
+
+/*! Field flags */
+#define CODEC_FIELD_SIGNED                          0x01    //! Two's complement, sign-extended when decoded
+#define CODEC_FIELD_DICT                            0x02    //! Looked up in the dictionary, at most 16 bit
+
+/*! Largest encoded sample [bytes] */
+#define CODEC_MAX_SIZE(nbFields)                    (2 + (((nbFields) + 7) / 8) + (5 * (nbFields)))
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Field of a sample */
+typedef struct CodecField_s {
+    uint8_t Bits;                   //! Width [1 .. 32]
+    uint8_t Flags;                  //! CODEC_FIELD_ flags
+} CodecField_t;
+
+/*! Stream configuration, identical on both sides */
+typedef struct CodecConfig_s {
+    const CodecField_t *Fields;
+    uint8_t NbFields;               //! Up to CODEC_MAX_FIELDS
+    const int32_t *Dict;            //! Recurring values, may be NULL
+    uint8_t DictSize;               //! Up to 127 values
+    uint8_t KeyframeInterval;       //! Samples between keyframes, 0 for keyframes only, at most 127
+    bool AckRequired;               //! Delta to the acknowledged sample only
+} CodecConfig_t;
+
+/*! Encoder statistics */
+typedef struct CodecStats_s {
+    uint32_t Samples;               //! Samples encoded
+    uint32_t Keyframes;             //! Samples sent as keyframe
+    uint32_t RawBytes;              //! Size of the samples with byte aligned fields
+    uint32_t Bytes;                 //! Size of the encoded samples
+} CodecStats_t;
+
+/*! Encoder of a stream */
+typedef struct CodecEncoder_s {
+    const CodecConfig_t *Config;
+    int32_t Ref[CODEC_MAX_FIELDS];  //! Reference sample
+    int32_t Sent[CODEC_MAX_FIELDS]; //! Last sample, waiting for the acknowledgement
+    uint8_t RefSeq;
+    uint8_t SentSeq;
+    uint8_t Seq;                    //! Sequence number of the next sample
+    uint8_t SinceKeyframe;          //! Samples since the last keyframe
+    uint8_t RefAge;                 //! Samples encoded since the reference
+    bool HasRef;
+    CodecStats_t Stats;
+} CodecEncoder_t;
+
+/*! Decoder of a stream */
+typedef struct CodecDecoder_s {
+    const CodecConfig_t *Config;
+    int32_t History[CODEC_HISTORY_SIZE][CODEC_MAX_FIELDS];
+    uint8_t HistorySeq[CODEC_HISTORY_SIZE]; //! 0xFF if unused
+    uint8_t Next;                   //! Next history slot
+} CodecDecoder_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes an encoder, the first sample is sent as keyframe.
+ */
+void CodecEncoderInit( CodecEncoder_t *enc, const CodecConfig_t *config );
+
+/*!
+ * \brief Drops the reference, the next sample is sent as keyframe.
+ */
+void CodecEncoderReset( CodecEncoder_t *enc );
+
+/*!
+ * \brief Encodes a sample.
+ *
+ * \param enc Encoder.
+ * \param values Field values.
+ * \param buf Buffer receiving the encoded sample.
+ * \param size Buffer size [bytes], CODEC_MAX_SIZE(NbFields) is always enough.
+ * \retval Size of the encoded sample, 0 if the buffer is too small.
+ */
+uint8_t CodecEncode( CodecEncoder_t *enc, const int32_t *values, uint8_t *buf, uint8_t size );
+
+/*!
+ * \brief Acknowledges the last encoded sample, it becomes the reference.
+ *
+ * \param enc Encoder.
+ * \param seq Sequence number of the acknowledged sample, the first byte of
+ *        the encoded sample masked with 0x7F.
+ */
+void CodecAck( CodecEncoder_t *enc, uint8_t seq );
+
+/*!
+ * \brief Initializes a decoder.
+ */
+void CodecDecoderInit( CodecDecoder_t *dec, const CodecConfig_t *config );
+
+/*!
+ * \brief Decodes a sample.
+ *
+ * \param dec Decoder.
+ * \param buf Encoded sample.
+ * \param size Size of the encoded sample.
+ * \param values Field values.
+ * \retval ERR_OK, ERR_NOTAVAIL if the reference of a delta is unknown (wait
+ *         for the next keyframe), ERR_FAILED if the sample is malformed.
+ */
+uint8_t CodecDecode( CodecDecoder_t *dec, const uint8_t *buf, uint8_t size, int32_t *values );
+
+#endif // __CODEC_H__
@@ -64,6 +64,19 @@
 
 #include "aes.h"
 
+#if ( AES_BACKEND == AES_BACKEND_TTABLE ) && !defined( USE_TABLES )
+#  error "The T-table AES backend requires USE_TABLES"
+#endif
+
+/* the byte oriented round functions are used for encryption by the byte */
+/* backend and for decryption by both the byte and the T-table backend    */
+#if ( AES_BACKEND == AES_BACKEND_BYTE ) || defined( AES_ENC_128_OTFK ) || defined( AES_ENC_256_OTFK )
+#  define BYTE_ENC_ROUNDS
+#endif
+#if ( AES_BACKEND != AES_BACKEND_CONST_TIME ) && defined( AES_DEC_PREKEYED )
+#  define BYTE_DEC_ROUNDS
+#endif
+
 //#if defined( HAVE_UINT_32T )
 //  typedef unsigned long uint32_t;
 //#endif
@@ -87,7 +100,131 @@
 #define fd(x)   (f8(x) ^ f4(x) ^ x)
 #define fe(x)   (f8(x) ^ f4(x) ^ f2(x))
 
-#if defined( USE_TABLES )
+#if ( AES_BACKEND == AES_BACKEND_CONST_TIME )
+
+/* Bitsliced S-box: bit plane i holds bit i of every byte processed in    */
+/* parallel. The S-box is evaluated as inversion in GF(2^8) followed by   */
+/* the affine transformation, using only AND and XOR on the bit planes.   */
+/* No table is indexed by and no branch depends on key or data bytes.     */
+
+/* time constant multiplication by x, x is evaluated once               */
+#define ct_f2(x)   ((uint8_t)(((x) << 1) ^ (0x1b & -((x) >> 7))))
+
+static void bs_load( uint32_t q[8], const uint8_t *b, uint8_t n )
+{   uint8_t i, j;
+
+    for( j = 0; j < 8; ++j )
+        q[j] = 0;
+    for( i = 0; i < n; ++i )
+        for( j = 0; j < 8; ++j )
+            q[j] |= (uint32_t)((b[i] >> j) & 1) << i;
+}
+
+static void bs_store( uint8_t *b, const uint32_t q[8], uint8_t n )
+{   uint8_t i, j;
+
+    for( i = 0; i < n; ++i )
+    {
+        b[i] = 0;
+        for( j = 0; j < 8; ++j )
+            b[i] |= (uint8_t)(((q[j] >> i) & 1) << j);
+    }
+}
+
+/* reduce a 15 bit plane product modulo x^8 + x^4 + x^3 + x + 1         */
+static void bs_reduce( uint32_t r[8], uint32_t p[15] )
+{   uint8_t i;
+
+    for( i = 14; i >= 8; --i )
+    {
+        p[i - 4] ^= p[i];
+        p[i - 5] ^= p[i];
+        p[i - 7] ^= p[i];
+        p[i - 8] ^= p[i];
+    }
+    for( i = 0; i < 8; ++i )
+        r[i] = p[i];
+}
+
+static void bs_mul( uint32_t r[8], const uint32_t a[8], const uint32_t b[8] )
+{   uint32_t p[15];
+    uint8_t i, j;
+
+    for( i = 0; i < 15; ++i )
+        p[i] = 0;
+    for( i = 0; i < 8; ++i )
+        for( j = 0; j < 8; ++j )
+            p[i + j] ^= a[i] & b[j];
+    bs_reduce(r, p);
+}
+
+static void bs_sqr( uint32_t r[8], const uint32_t a[8] )
+{   uint32_t p[15];
+    uint8_t i;
+
+    for( i = 0; i < 15; ++i )
+        p[i] = 0;
+    for( i = 0; i < 8; ++i )
+        p[2 * i] = a[i];
+    bs_reduce(r, p);
+}
+
+/* x^254, the multiplicative inverse of x (0 maps to 0)                 */
+static void bs_inv( uint32_t q[8] )
+{   uint32_t t[8], t3[8], t6[8];
+
+    bs_sqr(t, q);           /* x^2   */
+    bs_mul(t3, t, q);       /* x^3   */
+    bs_sqr(t6, t3);         /* x^6   */
+    bs_sqr(t, t6);          /* x^12  */
+    bs_mul(t, t, t3);       /* x^15  */
+    bs_sqr(t, t);           /* x^30  */
+    bs_sqr(t, t);           /* x^60  */
+    bs_sqr(t, t);           /* x^120 */
+    bs_mul(t, t, t6);       /* x^126 */
+    bs_mul(t, t, q);        /* x^127 */
+    bs_sqr(q, t);           /* x^254 */
+}
+
+static void ct_sub_bytes( uint8_t *b, uint8_t n )
+{   uint32_t q[8], r[8];
+    uint8_t i;
+
+    bs_load(q, b, n);
+    bs_inv(q);
+    for( i = 0; i < 8; ++i )   /* forward affine transformation, 0x63 */
+        r[i] = q[i] ^ q[(i + 4) & 7] ^ q[(i + 5) & 7] ^ q[(i + 6) & 7] ^ q[(i + 7) & 7];
+    r[0] = ~r[0];
+    r[1] = ~r[1];
+    r[5] = ~r[5];
+    r[6] = ~r[6];
+    bs_store(b, r, n);
+}
+
+static void ct_inv_sub_bytes( uint8_t *b, uint8_t n )
+{   uint32_t q[8], r[8];
+    uint8_t i;
+
+    bs_load(q, b, n);
+    for( i = 0; i < 8; ++i )   /* inverse affine transformation, 0x05 */
+        r[i] = q[(i + 2) & 7] ^ q[(i + 5) & 7] ^ q[(i + 7) & 7];
+    r[0] = ~r[0];
+    r[2] = ~r[2];
+    bs_inv(r);
+    bs_store(b, r, n);
+}
+
+static uint8_t ct_s_box( uint8_t x )
+{
+    ct_sub_bytes(&x, 1);
+    return x;
+}
+
+#define s_box(x)   ct_s_box(x)
+#define gfm2_sb(x) f2(s_box(x))
+#define gfm3_sb(x) f3(s_box(x))
+
+#elif defined( USE_TABLES )
 
 #define sb_data(w) {    /* S Box data values */                            \
     w(0x63), w(0x7c), w(0x77), w(0x7b), w(0xf2), w(0x6b), w(0x6f), w(0xc5),\
@@ -193,14 +330,25 @@
 
 static const uint8_t sbox[256]  =  sb_data(f1);
 
-#if defined( AES_DEC_PREKEYED )
+#if defined( BYTE_DEC_ROUNDS )
 static const uint8_t isbox[256] = isb_data(f1);
 #endif
 
+#if defined( BYTE_ENC_ROUNDS )
 static const uint8_t gfm2_sbox[256] = sb_data(f2);
 static const uint8_t gfm3_sbox[256] = sb_data(f3);
+#endif
 
-#if defined( AES_DEC_PREKEYED )
+#if ( AES_BACKEND == AES_BACKEND_TTABLE )
+/* combined S-box and mix columns table, byte 0..3 = 2s, s, s, 3s; the  */
+/* tables for the other rows are rotations of it (free on Cortex-M)     */
+#define bytes2word(b0, b1, b2, b3) \
+        (((uint32_t)(b3) << 24) | ((uint32_t)(b2) << 16) | ((uint32_t)(b1) << 8) | (b0))
+#define t_data(p)    bytes2word(f2(p), p, p, f3(p))
+static const uint32_t t_fwd[256] = sb_data(t_data);
+#endif
+
+#if defined( BYTE_DEC_ROUNDS )
 static const uint8_t gfmul_9[256] = mm_data(f9);
 static const uint8_t gfmul_b[256] = mm_data(fb);
 static const uint8_t gfmul_d[256] = mm_data(fd);
@@ -208,12 +356,12 @@ static const uint8_t gfmul_e[256] = mm_data(fe);
 #endif
 
 #define s_box(x)     sbox[(x)]
-#if defined( AES_DEC_PREKEYED )
+#if defined( BYTE_DEC_ROUNDS )
 #define is_box(x)    isbox[(x)]
 #endif
 #define gfm2_sb(x)   gfm2_sbox[(x)]
 #define gfm3_sb(x)   gfm3_sbox[(x)]
-#if defined( AES_DEC_PREKEYED )
+#if defined( BYTE_DEC_ROUNDS )
 #define gfm_9(x)     gfmul_9[(x)]
 #define gfm_b(x)     gfmul_b[(x)]
 #define gfm_d(x)     gfmul_d[(x)]
@@ -408,6 +556,8 @@ static void add_round_key( uint8_t d[N_BLOCK], const uint8_t k[N_BLOCK] )
     xor_block(d, k);
 }
 
+#if defined( BYTE_ENC_ROUNDS )
+
 static void shift_sub_rows( uint8_t st[N_BLOCK] )
 {   uint8_t tt;
 
@@ -424,7 +574,9 @@ static void shift_sub_rows( uint8_t st[N_BLOCK] )
     st[ 7] = s_box(st[ 3]); st[ 3] = s_box( tt );
 }
 
-#if defined( AES_DEC_PREKEYED )
+#endif
+
+#if defined( BYTE_DEC_ROUNDS )
 
 static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 {   uint8_t tt;
@@ -444,6 +596,8 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 
 #endif
 
+#if defined( BYTE_ENC_ROUNDS )
+
 #if defined( VERSION_1 )
   static void mix_sub_columns( uint8_t dt[N_BLOCK] )
   { uint8_t st[N_BLOCK];
@@ -473,7 +627,9 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
     dt[15] = gfm3_sb(st[12]) ^ s_box(st[1]) ^ s_box(st[6]) ^ gfm2_sb(st[11]);
   }
 
-#if defined( AES_DEC_PREKEYED )
+#endif
+
+#if defined( BYTE_DEC_ROUNDS )
 
 #if defined( VERSION_1 )
   static void inv_mix_sub_columns( uint8_t dt[N_BLOCK] )
@@ -506,6 +662,59 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 
 #endif
 
+#if ( AES_BACKEND == AES_BACKEND_CONST_TIME )
+
+static void shift_rows( uint8_t st[N_BLOCK] )
+{   uint8_t tt;
+
+    tt = st[1]; st[ 1] = st[ 5]; st[ 5] = st[ 9]; st[ 9] = st[13]; st[13] = tt;
+    tt = st[2]; st[ 2] = st[10]; st[10] = tt;
+    tt = st[6]; st[ 6] = st[14]; st[14] = tt;
+    tt = st[15]; st[15] = st[11]; st[11] = st[ 7]; st[ 7] = st[ 3]; st[ 3] = tt;
+}
+
+static void mix_columns( uint8_t st[N_BLOCK] )
+{   uint8_t c, a0, a1, a2, a3, tt;
+
+    for( c = 0; c < N_BLOCK; c += N_COL )
+    {
+        a0 = st[c]; a1 = st[c + 1]; a2 = st[c + 2]; a3 = st[c + 3];
+        tt = a0 ^ a1 ^ a2 ^ a3;
+        st[c    ] = a0 ^ tt ^ ct_f2((uint8_t)(a0 ^ a1));
+        st[c + 1] = a1 ^ tt ^ ct_f2((uint8_t)(a1 ^ a2));
+        st[c + 2] = a2 ^ tt ^ ct_f2((uint8_t)(a2 ^ a3));
+        st[c + 3] = a3 ^ tt ^ ct_f2((uint8_t)(a3 ^ a0));
+    }
+}
+
+static void inv_shift_rows( uint8_t st[N_BLOCK] )
+{   uint8_t tt;
+
+    tt = st[13]; st[13] = st[ 9]; st[ 9] = st[ 5]; st[ 5] = st[ 1]; st[ 1] = tt;
+    tt = st[2]; st[ 2] = st[10]; st[10] = tt;
+    tt = st[6]; st[ 6] = st[14]; st[14] = tt;
+    tt = st[3]; st[ 3] = st[ 7]; st[ 7] = st[11]; st[11] = st[15]; st[15] = tt;
+}
+
+static void inv_mix_columns( uint8_t st[N_BLOCK] )
+{   uint8_t c, u, v;
+
+    for( c = 0; c < N_BLOCK; c += N_COL )
+    {
+        u = ct_f2((uint8_t)(st[c    ] ^ st[c + 2]));
+        u = ct_f2(u);
+        v = ct_f2((uint8_t)(st[c + 1] ^ st[c + 3]));
+        v = ct_f2(v);
+        st[c    ] ^= u;
+        st[c + 1] ^= v;
+        st[c + 2] ^= u;
+        st[c + 3] ^= v;
+    }
+    mix_columns( st );
+}
+
+#endif
+
 #if defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED )
 
 /*  Set the cipher key for the pre-keyed version */
@@ -565,6 +774,90 @@ return_type aes_set_key( const uint8_t key[], length_type keylen, aes_context ct
 
 /*  Encrypt a single block of 16 bytes */
 
+#if ( AES_BACKEND == AES_BACKEND_TTABLE )
+
+#define rotl32(x, n)    (((x) << (n)) | ((x) >> (32 - (n))))
+#define word_in(p)      bytes2word((p)[0], (p)[1], (p)[2], (p)[3])
+
+/* one column of a full round, s0..s3 are the columns rotated by the    */
+/* column index so that shift rows picks row r from column (c + r) % 4  */
+#define t_round(s0, s1, s2, s3, k) (t_fwd[(s0) & 0xff]                  \
+        ^ rotl32(t_fwd[((s1) >> 8) & 0xff], 8)                          \
+        ^ rotl32(t_fwd[((s2) >> 16) & 0xff], 16)                        \
+        ^ rotl32(t_fwd[(s3) >> 24], 24) ^ word_in(k))
+
+#define t_last(s0, s1, s2, s3, k) (bytes2word(s_box((s0) & 0xff),       \
+        s_box(((s1) >> 8) & 0xff), s_box(((s2) >> 16) & 0xff),          \
+        s_box((s3) >> 24)) ^ word_in(k))
+
+static void word_out( uint8_t *p, uint32_t w )
+{
+    p[0] = (uint8_t)w;
+    p[1] = (uint8_t)(w >> 8);
+    p[2] = (uint8_t)(w >> 16);
+    p[3] = (uint8_t)(w >> 24);
+}
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        const uint8_t *k = ctx->ksch;
+        uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+        uint8_t r;
+
+        s0 = word_in(in     ) ^ word_in(k     );
+        s1 = word_in(in +  4) ^ word_in(k +  4);
+        s2 = word_in(in +  8) ^ word_in(k +  8);
+        s3 = word_in(in + 12) ^ word_in(k + 12);
+
+        for( r = 1 ; r < ctx->rnd ; ++r )
+        {
+            k += N_BLOCK;
+            t0 = t_round(s0, s1, s2, s3, k     );
+            t1 = t_round(s1, s2, s3, s0, k +  4);
+            t2 = t_round(s2, s3, s0, s1, k +  8);
+            t3 = t_round(s3, s0, s1, s2, k + 12);
+            s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+        }
+        k += N_BLOCK;
+        word_out(out     , t_last(s0, s1, s2, s3, k     ));
+        word_out(out +  4, t_last(s1, s2, s3, s0, k +  4));
+        word_out(out +  8, t_last(s2, s3, s0, s1, k +  8));
+        word_out(out + 12, t_last(s3, s0, s1, s2, k + 12));
+    }
+    else
+        return ( uint8_t )-1;
+    return 0;
+}
+
+#elif ( AES_BACKEND == AES_BACKEND_CONST_TIME )
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        uint8_t s1[N_BLOCK], r;
+        copy_and_key( s1, in, ctx->ksch );
+
+        for( r = 1 ; r < ctx->rnd ; ++r )
+        {
+            ct_sub_bytes( s1, N_BLOCK );
+            shift_rows( s1 );
+            mix_columns( s1 );
+            add_round_key( s1, ctx->ksch + r * N_BLOCK);
+        }
+        ct_sub_bytes( s1, N_BLOCK );
+        shift_rows( s1 );
+        copy_and_key( out, s1, ctx->ksch + r * N_BLOCK );
+    }
+    else
+        return ( uint8_t )-1;
+    return 0;
+}
+
+#else
+
 return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
 {
     if( ctx->rnd )
@@ -592,6 +885,8 @@ return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const
     return 0;
 }
 
+#endif
+
 /* CBC encrypt a number of blocks (input and return an IV) */
 
 return_type aes_cbc_encrypt( const uint8_t *in, uint8_t *out,
@@ -617,6 +912,33 @@ return_type aes_cbc_encrypt( const uint8_t *in, uint8_t *out,
 
 /*  Decrypt a single block of 16 bytes */
 
+#if ( AES_BACKEND == AES_BACKEND_CONST_TIME )
+
+return_type aes_decrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        uint8_t s1[N_BLOCK], r;
+        copy_and_key( s1, in, ctx->ksch + ctx->rnd * N_BLOCK );
+        inv_shift_rows( s1 );
+        ct_inv_sub_bytes( s1, N_BLOCK );
+
+        for( r = ctx->rnd ; --r ; )
+        {
+            add_round_key( s1, ctx->ksch + r * N_BLOCK );
+            inv_mix_columns( s1 );
+            inv_shift_rows( s1 );
+            ct_inv_sub_bytes( s1, N_BLOCK );
+        }
+        copy_and_key( out, s1, ctx->ksch );
+    }
+    else
+        return -1;
+    return 0;
+}
+
+#else
+
 return_type aes_decrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], const aes_context ctx[1] )
 {
     if( ctx->rnd )
@@ -644,6 +966,8 @@ return_type aes_decrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], const
     return 0;
 }
 
+#endif
+
 /* CBC decrypt a number of blocks (input and return an IV) */
 
 return_type aes_cbc_decrypt( const uint8_t *in, uint8_t *out,
@@ -50,6 +50,22 @@
 #  define AES_DEC_256_OTFK  /* AES decryption with 'on the fly' 256 bit keying */
 #endif
 
+/*  Block cipher backend, selected at build time (-DAES_BACKEND=...)
+
+    AES_BACKEND_BYTE        byte oriented tables, smallest code size
+    AES_BACKEND_TTABLE      32-bit T-table encryption (1 KB table), for
+                            Cortex-M3/M4 targets where flash is plentiful
+    AES_BACKEND_CONST_TIME  bitsliced S-box without any key or data
+                            dependent table look ups or branches
+*/
+#define AES_BACKEND_BYTE        0
+#define AES_BACKEND_TTABLE      1
+#define AES_BACKEND_CONST_TIME  2
+
+#if !defined( AES_BACKEND )
+#  define AES_BACKEND   AES_BACKEND_BYTE
+#endif
+
 #define N_ROW                   4
 #define N_COL                   4
 #define N_BLOCK   (N_ROW * N_COL)
@@ -12,39 +12,146 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 Maintainer: Miguel Luis and Gregory Cristian
 */
+#include <string.h>
 #include "fifo.h"
 
-static uint16_t FifoNext( Fifo_t *fifo, uint16_t index )
-{
-    return ( index + 1 ) % fifo->Size;
-}
+/*!
+ * Orders the data accesses against the index update of the other side
+ */
+#define FIFO_BARRIER( )                 __sync_synchronize( )
 
 void FifoInit( Fifo_t *fifo, uint8_t *buffer, uint16_t size )
 {
+    // Round down to a power of two
+    while( ( size & ( size - 1 ) ) != 0 )
+    {
+        size &= size - 1;
+    }
+
     fifo->Begin = 0;
     fifo->End = 0;
     fifo->Data = buffer;
     fifo->Size = size;
+    fifo->Mask = size - 1;
+    fifo->Overflows = 0;
 }
 
 void FifoPush( Fifo_t *fifo, uint8_t data )
 {
-    fifo->End = FifoNext( fifo, fifo->End );
-    fifo->Data[fifo->End] = data;
+    uint16_t end = fifo->End;
+
+    if( ( uint16_t )( end - fifo->Begin ) >= fifo->Size )
+    {
+        fifo->Overflows++;
+        return;
+    }
+    fifo->Data[end & fifo->Mask] = data;
+    FIFO_BARRIER( );
+    fifo->End = end + 1;
 }
 
 uint8_t FifoPop( Fifo_t *fifo )
 {
-    uint8_t data = fifo->Data[FifoNext( fifo, fifo->Begin )];
+    uint16_t begin = fifo->Begin;
+    uint8_t data = fifo->Data[begin & fifo->Mask];
 
-    fifo->Begin = FifoNext( fifo, fifo->Begin );
+    FIFO_BARRIER( );
+    fifo->Begin = begin + 1;
     return data;
 }
 
+uint16_t FifoPushBuffer( Fifo_t *fifo, const uint8_t *buffer, uint16_t size )
+{
+    uint16_t pushed = 0;
+    uint16_t len;
+    uint8_t *data;
+
+    // At most two contiguous spans, before and after the wrap around
+    while( pushed < size )
+    {
+        len = FifoWritePeek( fifo, &data );
+        if( len == 0 )
+        {
+            break;
+        }
+        if( len > ( size - pushed ) )
+        {
+            len = size - pushed;
+        }
+        memcpy( data, buffer + pushed, len );
+        FifoWriteCommit( fifo, len );
+        pushed += len;
+    }
+    return pushed;
+}
+
+uint16_t FifoPopBuffer( Fifo_t *fifo, uint8_t *buffer, uint16_t size )
+{
+    uint16_t popped = 0;
+    uint16_t len;
+    uint8_t *data;
+
+    // At most two contiguous spans, before and after the wrap around
+    while( popped < size )
+    {
+        len = FifoReadPeek( fifo, &data );
+        if( len == 0 )
+        {
+            break;
+        }
+        if( len > ( size - popped ) )
+        {
+            len = size - popped;
+        }
+        memcpy( buffer + popped, data, len );
+        FifoReadCommit( fifo, len );
+        popped += len;
+    }
+    return popped;
+}
+
+uint16_t FifoReadPeek( Fifo_t *fifo, uint8_t **data )
+{
+    uint16_t begin = fifo->Begin;
+    uint16_t count = fifo->End - begin;
+    uint16_t toWrap = fifo->Size - ( begin & fifo->Mask );
+
+    FIFO_BARRIER( );
+    *data = &fifo->Data[begin & fifo->Mask];
+    return ( count < toWrap ) ? count : toWrap;
+}
+
+void FifoReadCommit( Fifo_t *fifo, uint16_t size )
+{
+    FIFO_BARRIER( );
+    fifo->Begin += size;
+}
+
+uint16_t FifoWritePeek( Fifo_t *fifo, uint8_t **data )
+{
+    uint16_t end = fifo->End;
+    uint16_t space = fifo->Size - ( uint16_t )( end - fifo->Begin );
+    uint16_t toWrap = fifo->Size - ( end & fifo->Mask );
+
+    FIFO_BARRIER( );
+    *data = &fifo->Data[end & fifo->Mask];
+    return ( space < toWrap ) ? space : toWrap;
+}
+
+void FifoWriteCommit( Fifo_t *fifo, uint16_t size )
+{
+    FIFO_BARRIER( );
+    fifo->End += size;
+}
+
+uint16_t FifoGetCount( Fifo_t *fifo )
+{
+    return fifo->End - fifo->Begin;
+}
+
 void FifoFlush( Fifo_t *fifo )
 {
-    fifo->Begin = 0;
-    fifo->End = 0;
+    fifo->Begin = fifo->End;
 }
 
 bool IsFifoEmpty( Fifo_t *fifo )
@@ -54,5 +161,5 @@ bool IsFifoEmpty( Fifo_t *fifo )
 
 bool IsFifoFull( Fifo_t *fifo )
 {
-    return ( FifoNext( fifo, fifo->End ) == fifo->Begin );
+    return ( ( uint16_t )( fifo->End - fifo->Begin ) >= fifo->Size );
 }
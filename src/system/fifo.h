@@ -20,18 +20,27 @@ Maintainer: Miguel Luis and Gregory Cristian
 
 /*!
  * FIFO structure
+ *
+ * \remark Single producer / single consumer ring buffer. One context (e.g. an
+ *         ISR) may push while another one pops without locking. Begin and End
+ *         are free running counters, the buffer size has to be a power of two.
  */
 typedef struct Fifo_s
 {
-    uint16_t Begin;
-    uint16_t End;
+    volatile uint16_t Begin;
+    volatile uint16_t End;
     uint8_t *Data;
     uint16_t Size;
+    uint16_t Mask;
+    volatile uint32_t Overflows;
 }Fifo_t;
 
 /*!
  * Initializes the FIFO structure
  *
+ * \remark If size is not a power of two only the largest power of two
+ *         smaller than size is used.
+ *
  * \param [IN] fifo   Pointer to the FIFO object
  * \param [IN] buffer Buffer to be used as FIFO
  * \param [IN] size   Size of the buffer
@@ -41,6 +50,9 @@ void FifoInit( Fifo_t *fifo, uint8_t *buffer, uint16_t size );
 /*!
  * Pushes data to the FIFO
  *
+ * \remark The data is dropped and the overflow counter incremented if the
+ *         FIFO is full.
+ *
  * \param [IN] fifo Pointer to the FIFO object
  * \param [IN] data Data to be pushed into the FIFO
  */
@@ -54,9 +66,77 @@ void FifoPush( Fifo_t *fifo, uint8_t data );
  */
 uint8_t FifoPop( Fifo_t *fifo );
 
+/*!
+ * Pushes as many bytes of a buffer as fit into the FIFO
+ *
+ * \param [IN] fifo   Pointer to the FIFO object
+ * \param [IN] buffer Data to be pushed into the FIFO
+ * \param [IN] size   Number of bytes to push
+ * \retval pushed     Number of bytes pushed
+ */
+uint16_t FifoPushBuffer( Fifo_t *fifo, const uint8_t *buffer, uint16_t size );
+
+/*!
+ * Pops up to size bytes from the FIFO
+ *
+ * \param [IN]  fifo   Pointer to the FIFO object
+ * \param [OUT] buffer Buffer the data is copied to
+ * \param [IN]  size   Size of the buffer
+ * \retval popped      Number of bytes popped
+ */
+uint16_t FifoPopBuffer( Fifo_t *fifo, uint8_t *buffer, uint16_t size );
+
+/*!
+ * Gets the contiguous span of data which can be read without copy
+ *
+ * \remark The span is released with FifoReadCommit.
+ *
+ * \param [IN]  fifo Pointer to the FIFO object
+ * \param [OUT] data Start of the readable span
+ * \retval size      Size of the readable span
+ */
+uint16_t FifoReadPeek( Fifo_t *fifo, uint8_t **data );
+
+/*!
+ * Releases bytes previously read through FifoReadPeek
+ *
+ * \param [IN] fifo Pointer to the FIFO object
+ * \param [IN] size Number of bytes consumed
+ */
+void FifoReadCommit( Fifo_t *fifo, uint16_t size );
+
+/*!
+ * Gets the contiguous span of free space which can be written without copy
+ *
+ * \remark The written data is published with FifoWriteCommit.
+ *
+ * \param [IN]  fifo Pointer to the FIFO object
+ * \param [OUT] data Start of the writable span
+ * \retval size      Size of the writable span
+ */
+uint16_t FifoWritePeek( Fifo_t *fifo, uint8_t **data );
+
+/*!
+ * Publishes bytes previously written through FifoWritePeek
+ *
+ * \param [IN] fifo Pointer to the FIFO object
+ * \param [IN] size Number of bytes written
+ */
+void FifoWriteCommit( Fifo_t *fifo, uint16_t size );
+
+/*!
+ * Gets the number of bytes stored in the FIFO
+ *
+ * \param [IN] fifo   Pointer to the FIFO object
+ * \retval count      Number of bytes in the FIFO
+ */
+uint16_t FifoGetCount( Fifo_t *fifo );
+
 /*!
  * Flushes the FIFO
  *
+ * \remark Has to be called from the consumer side.
+ *
  * \param [IN] fifo   Pointer to the FIFO object
  */
 void FifoFlush( Fifo_t *fifo );
@@ -15,26 +15,17 @@
 #ifndef __GPS_H__
 #define __GPS_H__
 
-/* Structure to handle the GPS parsed data in ASCII */
+#include "fifo.h"
+#include "nmea.h"
+
+/* GPS parsing statistics */
 typedef struct {
-    char NmeaDataType[6];
-    char NmeaUtcTime[11];
-    char NmeaDataStatus[2];
-    char NmeaLatitude[10];
-    char NmeaLatitudePole[2];
-    char NmeaLongitude[11];
-    char NmeaLongitudePole[2];
-    char NmeaFixQuality[2];
-    char NmeaSatelliteTracked[3];
-    char NmeaHorizontalDilution[6];
-    char NmeaAltitude[8];
-    char NmeaAltitudeUnit[2];
-    char NmeaHeightGeoid[8];
-    char NmeaHeightGeoidUnit[2];
-    char NmeaSpeed[8];
-    char NmeaDetectionAngle[8];
-    char NmeaDate[8];
-} tNmeaGpsData;
+    NmeaStats_t Nmea;           // NMEA parser statistics
+    uint32_t RxOverflows;       // Bytes lost because the receive FIFO was full
+    uint32_t ProcessCalls;      // Calls of GpsProcessFifo
+    uint32_t ProcessTime;       // Total time spent parsing [timer ticks]
+    uint32_t ProcessTimeMax;    // Longest single call [timer ticks]
+} GpsStats_t;
 
 typedef struct {
     unsigned char second;   // 0-59
@@ -45,8 +36,6 @@ typedef struct {
     unsigned char year;   // 0-99 (representing 2000-2099)
 } datetime_t;
 
-extern tNmeaGpsData NmeaGpsData;
-
 /*!
  * \brief Initializes the handling of the GPS receiver
  */
@@ -78,18 +67,6 @@ bool GpsHasFix( void );
  */
 bool GpsHasValidDateTime( void );
 
-/*!
- * \brief Converts the latest Position (latitude and longitude) into a binary
- *        number
- */
-void GpsConvertPositionIntoBinary( void );
-
-/*!
- * \brief Converts the latest Position (latitude and Longitude) from ASCII into
- *        DMS numerical format
- */
-void GpsConvertPositionFromStringToNumerical( void );
-
 /*!
  * \brief Get current unix time
  *
@@ -133,17 +110,58 @@ uint8_t GpsGetDistanceToLatestGpsPositionBinary( int32_t latiBin, int32_t longiB
         uint32_t *distance );
 
 /*!
- * \brief Parses the NMEA sentence.
+ * \brief Gets the latest Position (latitude and Longitude) in 1e-7 degrees
+ *        if available
  *
- * \remark Only parses GPGGA and GPRMC sentences
+ * \param [OUT] lati Latitude value, positive north
+ * \param [OUT] longi Longitude value, positive east
+ *
+ * \retval status [SUCCESS, FAIL]
+ */
+uint8_t GpsGetLatestGpsPosition( int32_t *lati, int32_t *longi );
+
+/*!
+ * \brief Parses NMEA data.
+ *
+ * \remark Feeds the data to the streaming NMEA parser, GGA, RMC and GSA
+ *         sentences of any talker are decoded
  *
  * \param [IN] rxBuffer Data buffer to be parsed
  * \param [IN] rxBufferSize Size of data buffer
  *
- * \retval status [SUCCESS, FAIL]
+ * \retval status [SUCCESS: at least one sentence decoded, FAIL]
  */
 uint8_t GpsParseGpsData( char *rxBuffer, size_t rxBufferSize );
 
+/*!
+ * \brief Parses the bytes received from the GPS receiver in place.
+ *
+ * \remark Must not be called from interrupt context. The bytes are released
+ *         from the FIFO once parsed.
+ *
+ * \param [IN] fifo Receive FIFO of the GPS receiver UART
+ *
+ * \retval done true once a GGA and a RMC sentence have been decoded since the
+ *              parsing was requested by the PPS handler, the receiver may then
+ *              be disabled
+ */
+bool GpsProcessFifo( Fifo_t *fifo );
+
+/*!
+ * \brief Parses the pending data of the GPS receiver.
+ *
+ * \remark To be called from the main loop or a low priority task, never from
+ *         interrupt context
+ */
+void GpsProcess( void );
+
+/*!
+ * \brief Gets the GPS parsing statistics
+ *
+ * \param [OUT] stats Statistics
+ */
+void GpsGetStats( GpsStats_t *stats );
+
 /*!
  * \brief Returns the latest altitude from the parsed NMEA sentence
  *
@@ -161,11 +179,6 @@ uint16_t GpsGetLatestGpsAltitude( void );
  */
 uint8_t GpsGetLatestTrack( uint16_t *groundSpeed, uint16_t *track );
 
-/*!
- * \brief Format GPS data into numeric and binary formats
- */
-void GpsFormatGpsData( void );
-
 /*!
  * \brief Resets the GPS position variables
  */
@@ -0,0 +1,513 @@
+/**
+ * \file nmea.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Streaming NMEA 0183 sentence parser
+ *
+ * Every byte updates the running checksum and the value of the current field.
+ * At the end of a field its value is stored into the scratch sentence according
+ * to the sentence type and the field index. The scratch sentence is copied to
+ * the latest valid sentence once the checksum matches.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <string.h>
+#include "nmea.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Parser states */
+#define NMEA_STATE_IDLE                             0   // Waiting for '$'
+#define NMEA_STATE_FIELDS                           1   // Receiving the fields
+#define NMEA_STATE_CHECKSUM_HIGH                    2   // Waiting for the checksum upper nibble
+#define NMEA_STATE_CHECKSUM_LOW                     3   // Waiting for the checksum lower nibble
+#define NMEA_STATE_SKIP                             4   // Skipping until the next '$'
+
+/*! Fraction digits kept of a numeric field */
+#define NMEA_FRACTION_DIGITS                        5
+
+/*! Integer digits accepted in a numeric field */
+#define NMEA_INTEGER_DIGITS                         9
+
+/*! Packs the sentence formatter of the address field */
+#define NMEA_FORMATTER(a, b, c)                     (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) \
+                                                        | (uint32_t)(c))
+
+/*! Length of the address field, talker and sentence formatter */
+#define NMEA_ADDRESS_LENGTH                         5
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+/*! Powers of ten used to scale the fixed point values */
+static const uint32_t Pow10[NMEA_FRACTION_DIGITS + 1] = { 1, 10, 100, 1000, 10000, 100000 };
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static void StartSentence( NmeaParser_t *parser );
+static void AddFieldChar( NmeaParser_t *parser, uint8_t data );
+static void EndField( NmeaParser_t *parser );
+static NmeaSentence_t EndSentence( NmeaParser_t *parser );
+static void StoreGgaField( NmeaParser_t *parser, NmeaGga_t *gga );
+static void StoreRmcField( NmeaParser_t *parser, NmeaRmc_t *rmc );
+static void StoreGsaField( NmeaParser_t *parser, NmeaGsa_t *gsa );
+static bool FieldFixedPoint( NmeaParser_t *parser, uint8_t decimals, int32_t *value );
+static void FieldCoordinate( NmeaParser_t *parser, int32_t *value );
+static void FieldHemisphere( NmeaParser_t *parser, char negative, int32_t *value );
+static void FieldTime( NmeaParser_t *parser, NmeaTime_t *time );
+static int8_t HexValue( uint8_t data );
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+void NmeaParserInit( NmeaParser_t *parser )
+{
+    memset(parser, 0, sizeof(NmeaParser_t));
+    parser->State = NMEA_STATE_IDLE;
+}
+
+NmeaSentence_t NmeaParseChar( NmeaParser_t *parser, uint8_t data )
+{
+    int8_t nibble;
+
+    parser->Stats.Bytes++;
+
+    if ( data == '$' ) {
+        if ( (parser->State != NMEA_STATE_IDLE) && (parser->State != NMEA_STATE_SKIP) ) {
+            parser->Stats.FormatErrors++;   // Truncated sentence
+        }
+        StartSentence(parser);
+        return NMEA_SENTENCE_NONE;
+    }
+
+    switch ( parser->State ) {
+        case NMEA_STATE_FIELDS:
+            if ( (data == '\r') || (data == '\n') || (++parser->Length > NMEA_MAX_SENTENCE_LENGTH) ) {
+                /* No checksum or sentence too long */
+                parser->Stats.FormatErrors++;
+                parser->State = NMEA_STATE_SKIP;
+            } else if ( data == '*' ) {
+                EndField(parser);
+                if ( parser->State == NMEA_STATE_FIELDS ) {
+                    parser->State = NMEA_STATE_CHECKSUM_HIGH;
+                }
+            } else {
+                parser->Checksum ^= data;
+                if ( data == ',' ) {
+                    EndField(parser);
+                } else {
+                    AddFieldChar(parser, data);
+                }
+            }
+            break;
+        case NMEA_STATE_CHECKSUM_HIGH:
+        case NMEA_STATE_CHECKSUM_LOW:
+            nibble = HexValue(data);
+            if ( nibble < 0 ) {
+                parser->Stats.FormatErrors++;
+                parser->State = NMEA_STATE_SKIP;
+            } else if ( parser->State == NMEA_STATE_CHECKSUM_HIGH ) {
+                parser->ReceivedChecksum = (uint8_t) nibble << 4;
+                parser->State = NMEA_STATE_CHECKSUM_LOW;
+            } else {
+                parser->ReceivedChecksum |= (uint8_t) nibble;
+                parser->State = NMEA_STATE_IDLE;
+                return EndSentence(parser);
+            }
+            break;
+        default:
+            /* Waiting for the start of the next sentence */
+            break;
+    }
+    return NMEA_SENTENCE_NONE;
+}
+
+uint16_t NmeaParseBuffer( NmeaParser_t *parser, const uint8_t *data, size_t size,
+        void (*callback)( NmeaParser_t *parser, NmeaSentence_t sentence ) )
+{
+    NmeaSentence_t sentence;
+    uint16_t count = 0;
+
+    while ( size-- > 0 ) {
+        sentence = NmeaParseChar(parser, *data++);
+        if ( sentence != NMEA_SENTENCE_NONE ) {
+            count++;
+            if ( callback != NULL ) {
+                callback(parser, sentence);
+            }
+        }
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static void StartSentence( NmeaParser_t *parser )
+{
+    parser->State = NMEA_STATE_FIELDS;
+    parser->Length = 0;
+    parser->Checksum = 0;
+    parser->FieldIndex = 0;
+    parser->Address = 0;
+    parser->Error = false;
+    parser->Sentence = NMEA_SENTENCE_NONE;
+    memset(&parser->Field, 0, sizeof(NmeaField_t));
+    memset(&parser->Scratch, 0, sizeof(parser->Scratch));
+}
+
+static void AddFieldChar( NmeaParser_t *parser, uint8_t data )
+{
+    NmeaField_t *field = &parser->Field;
+
+    field->Length++;
+
+    if ( parser->FieldIndex == 0 ) {
+        parser->Address = ((parser->Address << 8) | data) & 0x00FFFFFF;
+    } else if ( (data >= '0') && (data <= '9') ) {
+        if ( field->Dot ) {
+            if ( field->FractionDigits < NMEA_FRACTION_DIGITS ) {
+                field->Fraction = field->Fraction * 10 + (data - '0');
+                field->FractionDigits++;
+            }
+        } else if ( field->IntegerDigits < NMEA_INTEGER_DIGITS ) {
+            field->Integer = field->Integer * 10 + (data - '0');
+            field->IntegerDigits++;
+        } else {
+            field->Invalid = true;
+        }
+    } else if ( data == '.' ) {
+        field->Invalid |= field->Dot;
+        field->Dot = true;
+    } else if ( (data == '-') && (field->Length == 1) ) {
+        field->Negative = true;
+    } else if ( field->Character == 0 ) {
+        field->Character = (char) data;
+    } else {
+        field->Invalid = true;
+    }
+}
+
+static void EndField( NmeaParser_t *parser )
+{
+    if ( parser->FieldIndex == 0 ) {
+        /* Address field, talker identifier followed by the sentence formatter */
+        if ( parser->Field.Length == NMEA_ADDRESS_LENGTH ) {
+            switch ( parser->Address ) {
+                case NMEA_FORMATTER('G', 'G', 'A'):
+                    parser->Sentence = NMEA_SENTENCE_GGA;
+                    break;
+                case NMEA_FORMATTER('R', 'M', 'C'):
+                    parser->Sentence = NMEA_SENTENCE_RMC;
+                    break;
+                case NMEA_FORMATTER('G', 'S', 'A'):
+                    parser->Sentence = NMEA_SENTENCE_GSA;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if ( parser->Sentence == NMEA_SENTENCE_NONE ) {
+            parser->Stats.Ignored++;
+            parser->State = NMEA_STATE_SKIP;
+            return;
+        }
+    } else {
+        switch ( parser->Sentence ) {
+            case NMEA_SENTENCE_GGA:
+                StoreGgaField(parser, &parser->Scratch.Gga);
+                break;
+            case NMEA_SENTENCE_RMC:
+                StoreRmcField(parser, &parser->Scratch.Rmc);
+                break;
+            case NMEA_SENTENCE_GSA:
+                StoreGsaField(parser, &parser->Scratch.Gsa);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if ( parser->FieldIndex < UINT8_MAX ) {
+        parser->FieldIndex++;
+    }
+    memset(&parser->Field, 0, sizeof(NmeaField_t));
+}
+
+static NmeaSentence_t EndSentence( NmeaParser_t *parser )
+{
+    if ( parser->ReceivedChecksum != parser->Checksum ) {
+        parser->Stats.ChecksumErrors++;
+        return NMEA_SENTENCE_NONE;
+    }
+    if ( parser->Error ) {
+        parser->Stats.FormatErrors++;
+        return NMEA_SENTENCE_NONE;
+    }
+
+    switch ( parser->Sentence ) {
+        case NMEA_SENTENCE_GGA:
+            parser->Gga = parser->Scratch.Gga;
+            break;
+        case NMEA_SENTENCE_RMC:
+            parser->Rmc = parser->Scratch.Rmc;
+            break;
+        case NMEA_SENTENCE_GSA:
+            parser->Gsa = parser->Scratch.Gsa;
+            break;
+        default:
+            return NMEA_SENTENCE_NONE;
+    }
+    parser->Stats.Sentences++;
+    return parser->Sentence;
+}
+
+/*!
+ * \brief $--GGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,x.x,xxxx*hh
+ */
+static void StoreGgaField( NmeaParser_t *parser, NmeaGga_t *gga )
+{
+    int32_t value;
+
+    switch ( parser->FieldIndex ) {
+        case 1:
+            FieldTime(parser, &gga->Time);
+            break;
+        case 2:
+            FieldCoordinate(parser, &gga->Latitude);
+            break;
+        case 3:
+            FieldHemisphere(parser, 'S', &gga->Latitude);
+            break;
+        case 4:
+            FieldCoordinate(parser, &gga->Longitude);
+            break;
+        case 5:
+            FieldHemisphere(parser, 'W', &gga->Longitude);
+            break;
+        case 6:
+            if ( FieldFixedPoint(parser, 0, &value) ) {
+                gga->FixQuality = (uint8_t) value;
+            }
+            break;
+        case 7:
+            if ( FieldFixedPoint(parser, 0, &value) ) {
+                gga->Satellites = (uint8_t) value;
+            }
+            break;
+        case 8:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                gga->Hdop = (uint16_t) value;
+            }
+            break;
+        case 9:
+            (void) FieldFixedPoint(parser, 2, &gga->Altitude);
+            break;
+        case 11:
+            (void) FieldFixedPoint(parser, 2, &gga->GeoidSeparation);
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+ * \brief $--RMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a*hh
+ */
+static void StoreRmcField( NmeaParser_t *parser, NmeaRmc_t *rmc )
+{
+    int32_t value;
+
+    switch ( parser->FieldIndex ) {
+        case 1:
+            FieldTime(parser, &rmc->Time);
+            break;
+        case 2:
+            rmc->Valid = (parser->Field.Character == 'A');
+            break;
+        case 3:
+            FieldCoordinate(parser, &rmc->Latitude);
+            break;
+        case 4:
+            FieldHemisphere(parser, 'S', &rmc->Latitude);
+            break;
+        case 5:
+            FieldCoordinate(parser, &rmc->Longitude);
+            break;
+        case 6:
+            FieldHemisphere(parser, 'W', &rmc->Longitude);
+            break;
+        case 7:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                rmc->Speed = (uint32_t) value;
+            }
+            break;
+        case 8:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                rmc->Course = (uint16_t) value;
+            }
+            break;
+        case 9:
+            if ( FieldFixedPoint(parser, 0, &value) ) {
+                rmc->Day = (uint8_t)(value / 10000);
+                rmc->Month = (uint8_t)((value / 100) % 100);
+                rmc->Year = (uint8_t)(value % 100);
+                if ( (rmc->Day < 1) || (rmc->Day > 31) || (rmc->Month < 1) || (rmc->Month > 12) ) {
+                    parser->Error = true;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+ * \brief $--GSA,a,x,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,x.x,x.x,x.x*hh
+ */
+static void StoreGsaField( NmeaParser_t *parser, NmeaGsa_t *gsa )
+{
+    int32_t value;
+
+    switch ( parser->FieldIndex ) {
+        case 1:
+            gsa->Mode = parser->Field.Character;
+            break;
+        case 2:
+            if ( FieldFixedPoint(parser, 0, &value) ) {
+                gsa->FixType = (uint8_t) value;
+            }
+            break;
+        case 15:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                gsa->Pdop = (uint16_t) value;
+            }
+            break;
+        case 16:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                gsa->Hdop = (uint16_t) value;
+            }
+            break;
+        case 17:
+            if ( FieldFixedPoint(parser, 2, &value) ) {
+                gsa->Vdop = (uint16_t) value;
+            }
+            break;
+        default:
+            /* Fields 3 .. 14, satellites used */
+            if ( (parser->FieldIndex >= 3) && (parser->FieldIndex < 3 + NMEA_GSA_MAX_SATELLITES)
+                    && FieldFixedPoint(parser, 0, &value) ) {
+                gsa->Satellites[gsa->SatelliteCount++] = (uint8_t) value;
+            }
+            break;
+    }
+}
+
+/*!
+ * \brief Returns the value of the current numeric field.
+ *
+ * \param parser Parser, its error flag is set if the field is not numeric.
+ * \param decimals Number of decimals of the fixed point value [0 .. 5].
+ * \param value Field value times 10^decimals, unchanged if the field is empty.
+ * \retval true if the field holds a number.
+ */
+static bool FieldFixedPoint( NmeaParser_t *parser, uint8_t decimals, int32_t *value )
+{
+    const NmeaField_t *field = &parser->Field;
+    uint64_t result;
+
+    if ( field->Length == 0 ) {
+        return false;
+    }
+    if ( field->Invalid || (field->Character != 0)
+            || ((field->IntegerDigits == 0) && (field->FractionDigits == 0)) ) {
+        parser->Error = true;
+        return false;
+    }
+
+    result = (uint64_t) field->Integer * Pow10[decimals];
+    result += (field->Fraction * Pow10[NMEA_FRACTION_DIGITS - field->FractionDigits])
+            / Pow10[NMEA_FRACTION_DIGITS - decimals];
+    if ( result > INT32_MAX ) {
+        parser->Error = true;
+        return false;
+    }
+    *value = field->Negative ? -(int32_t) result : (int32_t) result;
+    return true;
+}
+
+/*!
+ * \brief Converts a dddmm.mmmmm field into 1e-7 degrees.
+ */
+static void FieldCoordinate( NmeaParser_t *parser, int32_t *value )
+{
+    const NmeaField_t *field = &parser->Field;
+    uint32_t degrees;
+    uint32_t minutes;
+
+    if ( field->Length == 0 ) {
+        return;
+    }
+    if ( field->Invalid || field->Negative || (field->Character != 0) ) {
+        parser->Error = true;
+        return;
+    }
+
+    degrees = field->Integer / 100;
+    minutes = field->Integer % 100;
+    if ( (degrees > 180) || (minutes >= 60) ) {
+        parser->Error = true;
+        return;
+    }
+    /* Minutes in 1e-5, one minute is 1e7 / 60 = 1e5 * 5 / 3 units of 1e-7 degrees */
+    minutes = minutes * Pow10[NMEA_FRACTION_DIGITS]
+            + field->Fraction * Pow10[NMEA_FRACTION_DIGITS - field->FractionDigits];
+    *value = (int32_t)(degrees * 10000000 + (minutes * 5 + 1) / 3);
+}
+
+/*!
+ * \brief Applies a N/S or E/W field to the coordinate stored before.
+ */
+static void FieldHemisphere( NmeaParser_t *parser, char negative, int32_t *value )
+{
+    if ( parser->Field.Character == negative ) {
+        *value = -*value;
+    }
+}
+
+/*!
+ * \brief Converts a hhmmss.sss field.
+ */
+static void FieldTime( NmeaParser_t *parser, NmeaTime_t *time )
+{
+    const NmeaField_t *field = &parser->Field;
+    int32_t value;
+
+    if ( !FieldFixedPoint(parser, 0, &value) ) {
+        return;
+    }
+    time->Hour = (uint8_t)(value / 10000);
+    time->Minute = (uint8_t)((value / 100) % 100);
+    time->Second = (uint8_t)(value % 100);
+    time->Millisecond = (uint16_t)((field->Fraction
+            * Pow10[NMEA_FRACTION_DIGITS - field->FractionDigits]) / 100);
+    if ( (time->Hour > 23) || (time->Minute > 59) || (time->Second > 60) ) {
+        parser->Error = true;
+    }
+}
+
+static int8_t HexValue( uint8_t data )
+{
+    if ( (data >= '0') && (data <= '9') ) {
+        return data - '0';
+    } else if ( (data >= 'A') && (data <= 'F') ) {
+        return data - 'A' + 10;
+    } else if ( (data >= 'a') && (data <= 'f') ) {
+        return data - 'a' + 10;
+    }
+    return -1;
+}
@@ -0,0 +1,163 @@
+/**
+ * \file nmea.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Streaming NMEA 0183 sentence parser
+ *
+ * The parser is a state machine fed one byte at a time. The fields are decoded
+ * into binary values while the bytes arrive, no sentence is buffered. A
+ * sentence is only published after its checksum has been verified. GGA, RMC
+ * and GSA sentences of any talker (GP, GL, GN, ...) are decoded, all others
+ * are counted and skipped.
+ */
+#ifndef __NMEA_H__
+#define __NMEA_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Longest accepted sentence, '$' to checksum [characters] */
+#define NMEA_MAX_SENTENCE_LENGTH                    128
+
+/*! Maximum number of satellites reported by a GSA sentence */
+#define NMEA_GSA_MAX_SATELLITES                     12
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Decoded sentence types */
+typedef enum {
+    NMEA_SENTENCE_NONE = 0,
+    NMEA_SENTENCE_GGA,
+    NMEA_SENTENCE_RMC,
+    NMEA_SENTENCE_GSA
+} NmeaSentence_t;
+
+/*! UTC time of day */
+typedef struct NmeaTime_s {
+    uint8_t Hour;                   //! [0 .. 23]
+    uint8_t Minute;                 //! [0 .. 59]
+    uint8_t Second;                 //! [0 .. 60]
+    uint16_t Millisecond;           //! [0 .. 999]
+} NmeaTime_t;
+
+/*! GGA, fix data */
+typedef struct NmeaGga_s {
+    NmeaTime_t Time;
+    int32_t Latitude;               //! [1e-7 deg], positive north
+    int32_t Longitude;              //! [1e-7 deg], positive east
+    uint8_t FixQuality;             //! 0: invalid, 1: GPS, 2: DGPS, ...
+    uint8_t Satellites;             //! Satellites in use
+    uint16_t Hdop;                  //! Horizontal dilution [1/100]
+    int32_t Altitude;               //! Altitude above mean sea level [cm]
+    int32_t GeoidSeparation;        //! [cm]
+} NmeaGga_t;
+
+/*! RMC, recommended minimum data */
+typedef struct NmeaRmc_s {
+    NmeaTime_t Time;
+    bool Valid;                     //! Status 'A'
+    int32_t Latitude;               //! [1e-7 deg], positive north
+    int32_t Longitude;              //! [1e-7 deg], positive east
+    uint32_t Speed;                 //! Speed over ground [1/100 knots]
+    uint16_t Course;                //! Course over ground [1/100 deg]
+    uint8_t Day;                    //! [1 .. 31]
+    uint8_t Month;                  //! [1 .. 12]
+    uint8_t Year;                   //! [0 .. 99], years since 2000
+} NmeaRmc_t;
+
+/*! GSA, dilution of precision and active satellites */
+typedef struct NmeaGsa_s {
+    char Mode;                      //! 'M': manual, 'A': automatic
+    uint8_t FixType;                //! 1: no fix, 2: 2D, 3: 3D
+    uint8_t SatelliteCount;         //! Valid entries in Satellites
+    uint8_t Satellites[NMEA_GSA_MAX_SATELLITES]; //! PRN of the satellites in use
+    uint16_t Pdop;                  //! [1/100]
+    uint16_t Hdop;                  //! [1/100]
+    uint16_t Vdop;                  //! [1/100]
+} NmeaGsa_t;
+
+/*! Parser statistics */
+typedef struct NmeaStats_s {
+    uint32_t Bytes;                 //! Bytes fed to the parser
+    uint32_t Sentences;             //! Sentences decoded (GGA, RMC and GSA)
+    uint32_t Ignored;               //! Sentences of other types skipped
+    uint32_t ChecksumErrors;        //! Sentences with a wrong checksum
+    uint32_t FormatErrors;          //! Truncated, too long or malformed sentences
+} NmeaStats_t;
+
+/*! Value of the field being received */
+typedef struct NmeaField_s {
+    uint32_t Integer;               //! Digits before the decimal point
+    uint32_t Fraction;              //! First five digits after it
+    uint8_t IntegerDigits;
+    uint8_t FractionDigits;
+    bool Dot;
+    bool Negative;
+    bool Invalid;
+    char Character;                 //! First non numeric character
+    uint8_t Length;
+} NmeaField_t;
+
+/*! Parser state, the members are private to nmea.c */
+typedef struct NmeaParser_s {
+    uint8_t State;
+    uint8_t Length;
+    uint8_t Checksum;
+    uint8_t ReceivedChecksum;
+    uint8_t FieldIndex;
+    uint32_t Address;               //! Last three characters of the address field
+    bool Error;
+    NmeaSentence_t Sentence;
+    NmeaField_t Field;
+    union {
+        NmeaGga_t Gga;
+        NmeaRmc_t Rmc;
+        NmeaGsa_t Gsa;
+    } Scratch;                      //! Sentence being received
+    NmeaGga_t Gga;                  //! Latest valid GGA sentence
+    NmeaRmc_t Rmc;                  //! Latest valid RMC sentence
+    NmeaGsa_t Gsa;                  //! Latest valid GSA sentence
+    NmeaStats_t Stats;
+} NmeaParser_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Resets the parser state, the latest sentences and the statistics.
+ *
+ * \param parser Parser to initialize.
+ */
+void NmeaParserInit( NmeaParser_t *parser );
+
+/*!
+ * \brief Feeds one received byte to the parser.
+ *
+ * \param parser Parser.
+ * \param data Received byte.
+ * \retval Type of the sentence completed and published by this byte,
+ *         NMEA_SENTENCE_NONE otherwise.
+ */
+NmeaSentence_t NmeaParseChar( NmeaParser_t *parser, uint8_t data );
+
+/*!
+ * \brief Feeds a block of received bytes to the parser.
+ *
+ * \param parser Parser.
+ * \param data Received bytes.
+ * \param size Number of bytes.
+ * \param callback Called for every sentence published, may be NULL.
+ * \retval Number of sentences published.
+ */
+uint16_t NmeaParseBuffer( NmeaParser_t *parser, const uint8_t *data, size_t size,
+        void (*callback)( NmeaParser_t *parser, NmeaSentence_t sentence ) );
+
+#endif // __NMEA_H__
@@ -0,0 +1,582 @@
+/**
+ * \file nvm.c
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Log structured key-value store in non-volatile memory
+ *
+ * Sector layout:
+ *  0: NVM_SECTOR_MAGIC [32 bit]
+ *  4: sequence number [32 bit], the valid sector with the highest one is active
+ *  8: records
+ *
+ * Record layout, padded with 0xFF to a multiple of the write unit:
+ *  0: key [16 bit]
+ *  2: value size, 0 marks a deleted key
+ *  3: CRC16 of key, size and value
+ *  5: value
+ *
+ * An erased key (0xFFFF) marks the end of the log.
+ */
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include "board.h"
+#include "nvm-board.h"
+#include "nvm.h"
+
+/*******************************************************************************
+ * PRIVATE CONSTANT DEFINITIONS
+ ******************************************************************************/
+#define NVM_SECTOR_MAGIC                            0x314D564Eu /* "NVM1" */
+#define NVM_SECTOR_HEADER_SIZE                      8
+#define NVM_RECORD_HEADER_SIZE                      5
+
+/*! Records start word aligned */
+#if (NVM_MCU_WRITE_UNIT > 4)
+#define NVM_WRITE_UNIT                              NVM_MCU_WRITE_UNIT
+#else
+#define NVM_WRITE_UNIT                              4
+#endif
+
+#define NVM_ALIGN(size)                             (((size) + NVM_WRITE_UNIT - 1) & ~(NVM_WRITE_UNIT - 1))
+#define NVM_MAX_RECORD_SIZE                         NVM_ALIGN(NVM_RECORD_HEADER_SIZE + NVM_MAX_VALUE_SIZE)
+#define NVM_SECTOR_OFFSET(sector)                   ((uint32_t)(sector) * NVM_MCU_SECTOR_SIZE)
+
+#define NVM_KEY_FREE                                0xFFFF
+
+#define NVM_RECORD_KEY(record)                      ((uint16_t)(record)[0] | ((uint16_t)(record)[1] << 8))
+#define NVM_RECORD_SIZE(record)                     ((record)[2])
+
+#if defined(USE_FREE_RTOS)
+/*! NVM task, writes the pending values */
+#define NVM_TASK_STACK_SIZE                         (configMINIMAL_STACK_SIZE + 100)
+#define NVM_TASK_PRIO                               (tskIDLE_PRIORITY)
+
+/*! Maximum write-behind delay [ms] */
+#define NVM_TASK_INTERVAL                           100
+#endif /* USE_FREE_RTOS */
+
+#if (NVM_MCU_NB_SECTORS < 2)
+#error "The NVM store needs at least two sectors"
+#endif
+#if (NVM_MAX_KEYS >= NVM_KEY_FREE) || (NVM_MAX_VALUE_SIZE > 255)
+#error "Keys have to fit into 16 bit and value sizes into a byte"
+#endif
+#if ((NVM_SECTOR_HEADER_SIZE + NVM_MAX_RECORD_SIZE) > NVM_MCU_SECTOR_SIZE)
+#error "NVM_MAX_VALUE_SIZE too large for the sector size"
+#endif
+
+/*******************************************************************************
+ * PRIVATE TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Value waiting to be written */
+typedef struct NvmPending_s {
+    uint16_t Key;                   //! NVM_KEY_FREE if unused
+    uint8_t Size;
+    uint8_t Version;                //! Incremented by every NvmWrite
+    uint8_t Data[NVM_MAX_VALUE_SIZE];
+} NvmPending_t;
+
+/*! Counter value of the last write */
+typedef struct NvmCounter_s {
+    uint16_t Key;                   //! NVM_KEY_FREE if unused
+    uint32_t Base;
+} NvmCounter_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES (STATIC)
+ ******************************************************************************/
+static bool Mounted = false;
+
+/*! Active sector, its sequence number and the offset of the next record */
+static uint8_t ActiveSector;
+static uint32_t ActiveSequence;
+static uint16_t WriteOffset;
+
+/*! Offset of the latest record of every key in the active sector, 0 if none */
+static uint16_t Index[NVM_MAX_KEYS];
+
+static NvmPending_t Pending[NVM_PENDING_SLOTS];
+
+static NvmCounter_t Counters[NVM_MAX_COUNTERS];
+
+/*! Record being written and record being copied, NvmProcess context only */
+static uint32_t RecordBuffer[NVM_MAX_RECORD_SIZE / 4];
+static uint32_t CopyBuffer[NVM_MAX_RECORD_SIZE / 4];
+
+static NvmStats_t Stats;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+static bool Format( void );
+static void Scan( void );
+static bool Append( uint16_t key, uint8_t size );
+static bool Compact( uint16_t reserve );
+static bool ReadRecord( uint8_t sector, uint16_t offset, uint8_t *record );
+static uint16_t Crc16( const uint8_t *data, uint16_t size );
+#if defined(USE_FREE_RTOS)
+static void NvmTask( void *pvParameters );
+#endif /* USE_FREE_RTOS */
+
+/*******************************************************************************
+ * MODULE FUNCTIONS (PUBLIC)
+ ******************************************************************************/
+bool NvmInit( void )
+{
+    uint32_t header[NVM_SECTOR_HEADER_SIZE / 4];
+    int16_t active = -1;
+
+    if ( Mounted ) {
+        return true;
+    }
+    if ( NvmMcuInit() == FAIL ) {
+        return false;
+    }
+
+    for ( uint8_t i = 0; i < NVM_PENDING_SLOTS; i++ ) {
+        Pending[i].Key = NVM_KEY_FREE;
+    }
+    for ( uint8_t i = 0; i < NVM_MAX_COUNTERS; i++ ) {
+        Counters[i].Key = NVM_KEY_FREE;
+    }
+    memset1((uint8_t*) &Stats, 0, sizeof(Stats));
+
+    /* The valid sector with the most recent sequence number is the active one */
+    for ( uint8_t i = 0; i < NVM_MCU_NB_SECTORS; i++ ) {
+        if ( NvmMcuRead(NVM_SECTOR_OFFSET(i), (uint8_t*) header, sizeof(header)) == FAIL
+                || header[0] != NVM_SECTOR_MAGIC ) {
+            continue;
+        }
+        if ( active < 0 || (int32_t)(header[1] - ActiveSequence) > 0 ) {
+            active = i;
+            ActiveSequence = header[1];
+        }
+    }
+
+    if ( active < 0 ) {
+        if ( !Format() ) {
+            return false;
+        }
+    } else {
+        ActiveSector = (uint8_t) active;
+        Scan();
+    }
+
+    Mounted = true;
+
+#if defined(USE_FREE_RTOS)
+    if ( xTaskCreate(NvmTask, "Nvm", NVM_TASK_STACK_SIZE, (void*) NULL, NVM_TASK_PRIO,
+            (xTaskHandle*) NULL) != pdPASS ) {
+        /*lint -e527 */
+        for ( ;; ) {
+        }; /* error! probably out of memory */
+        /*lint +e527 */
+    }
+#endif /* USE_FREE_RTOS */
+    return true;
+}
+
+bool NvmWrite( uint16_t key, const void *data, uint8_t size )
+{
+    NvmPending_t *slot = NULL;
+    uint32_t primask;
+
+    if ( !Mounted || key >= NVM_MAX_KEYS || size > NVM_MAX_VALUE_SIZE ) {
+        return false;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    /* A newer value replaces the pending one of the same key */
+    for ( uint8_t i = 0; i < NVM_PENDING_SLOTS; i++ ) {
+        if ( Pending[i].Key == key ) {
+            slot = &Pending[i];
+            break;
+        }
+        if ( slot == NULL && Pending[i].Key == NVM_KEY_FREE ) {
+            slot = &Pending[i];
+        }
+    }
+    if ( slot == NULL ) {
+        Stats.Dropped++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    if ( size > 0 ) {
+        memcpy1(slot->Data, (const uint8_t*) data, size);
+    }
+    slot->Size = size;
+    slot->Key = key;
+    slot->Version++;
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+uint8_t NvmRead( uint16_t key, void *data, uint8_t size )
+{
+    uint8_t record[NVM_MAX_RECORD_SIZE];
+    uint8_t sector;
+    uint16_t offset;
+    uint32_t primask;
+
+    if ( !Mounted || key >= NVM_MAX_KEYS ) {
+        return 0;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for ( uint8_t i = 0; i < NVM_PENDING_SLOTS; i++ ) {
+        if ( Pending[i].Key == key ) {
+            memcpy1((uint8_t*) data, Pending[i].Data, MIN(size, Pending[i].Size));
+            size = Pending[i].Size;
+            __set_PRIMASK(primask);
+            return size;
+        }
+    }
+    sector = ActiveSector;
+    offset = Index[key];
+    __set_PRIMASK(primask);
+
+    if ( offset == 0 || !ReadRecord(sector, offset, record) ) {
+        return 0;
+    }
+    memcpy1((uint8_t*) data, &record[NVM_RECORD_HEADER_SIZE],
+            MIN(size, NVM_RECORD_SIZE(record)));
+    return NVM_RECORD_SIZE(record);
+}
+
+bool NvmDelete( uint16_t key )
+{
+    return NvmWrite(key, NULL, 0);
+}
+
+bool NvmCounterSet( uint16_t key, uint32_t counter )
+{
+    NvmCounter_t *entry = NULL;
+
+    if ( key >= NVM_MAX_KEYS || !NvmWrite(key, &counter, sizeof(counter)) ) {
+        return false;
+    }
+    for ( uint8_t i = 0; i < NVM_MAX_COUNTERS; i++ ) {
+        if ( Counters[i].Key == key ) {
+            entry = &Counters[i];
+            break;
+        }
+        if ( entry == NULL && Counters[i].Key == NVM_KEY_FREE ) {
+            entry = &Counters[i];
+        }
+    }
+    if ( entry != NULL ) {
+        entry->Key = key;
+        entry->Base = counter;
+    }
+    return true;
+}
+
+bool NvmCounterUpdate( uint16_t key, uint32_t counter )
+{
+    for ( uint8_t i = 0; i < NVM_MAX_COUNTERS; i++ ) {
+        if ( Counters[i].Key == key && (counter - Counters[i].Base) < NVM_COUNTER_STEP ) {
+            return true;
+        }
+    }
+    return NvmCounterSet(key, counter);
+}
+
+bool NvmCounterRestore( uint16_t key, uint32_t *counter )
+{
+    uint32_t value;
+
+    if ( NvmRead(key, &value, sizeof(value)) != sizeof(value) ) {
+        return false;
+    }
+    /* Values up to the next pending write may have been used before the reset,
+     * the restored value has to be stored before it is used */
+    value += NVM_COUNTER_GAP;
+    if ( !NvmCounterSet(key, value) ) {
+        return false;
+    }
+    *counter = value;
+    return true;
+}
+
+bool NvmProcess( void )
+{
+    uint8_t *record = (uint8_t*) RecordBuffer;
+    uint8_t size, version;
+    uint16_t key;
+    uint32_t primask;
+    bool done = true;
+
+    if ( !Mounted ) {
+        return false;
+    }
+
+    for ( uint8_t i = 0; i < NVM_PENDING_SLOTS; i++ ) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        key = Pending[i].Key;
+        size = Pending[i].Size;
+        version = Pending[i].Version;
+        if ( key != NVM_KEY_FREE ) {
+            memcpy1(&record[NVM_RECORD_HEADER_SIZE], Pending[i].Data, size);
+        }
+        __set_PRIMASK(primask);
+
+        if ( key == NVM_KEY_FREE ) {
+            continue;
+        }
+        if ( !Append(key, size) ) {
+            /* Kept pending, retried on the next call */
+            done = false;
+            continue;
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        /* Rewritten while being written, the slot stays pending */
+        if ( Pending[i].Version == version ) {
+            Pending[i].Key = NVM_KEY_FREE;
+        } else {
+            done = false;
+        }
+        __set_PRIMASK(primask);
+    }
+    return done;
+}
+
+void NvmGetStats( NvmStats_t *stats )
+{
+    *stats = Stats;
+    stats->Free = NVM_MCU_SECTOR_SIZE - WriteOffset;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+/*!
+ * \brief Initializes the first sector of an empty NVM area.
+ */
+static bool Format( void )
+{
+    uint32_t header[NVM_SECTOR_HEADER_SIZE / 4] = { NVM_SECTOR_MAGIC, 1 };
+
+    if ( NvmMcuEraseSector(NVM_SECTOR_OFFSET(0)) == FAIL
+            || NvmMcuWrite(NVM_SECTOR_OFFSET(0), (uint8_t*) header, sizeof(header)) == FAIL ) {
+        Stats.Errors++;
+        return false;
+    }
+    ActiveSector = 0;
+    ActiveSequence = 1;
+    WriteOffset = NVM_SECTOR_HEADER_SIZE;
+    memset1((uint8_t*) Index, 0, sizeof(Index));
+    return true;
+}
+
+/*!
+ * \brief Builds the key index of the active sector and finds the end of the
+ *        log.
+ */
+static void Scan( void )
+{
+    uint8_t *record = (uint8_t*) RecordBuffer;
+    uint16_t offset = NVM_SECTOR_HEADER_SIZE;
+    uint16_t size;
+
+    memset1((uint8_t*) Index, 0, sizeof(Index));
+
+    while ( (offset + NVM_RECORD_HEADER_SIZE) <= NVM_MCU_SECTOR_SIZE ) {
+        if ( NvmMcuRead(NVM_SECTOR_OFFSET(ActiveSector) + offset, record,
+                NVM_RECORD_HEADER_SIZE) == FAIL ) {
+            break;
+        }
+        if ( NVM_RECORD_KEY(record) == NVM_KEY_FREE ) {
+            break; /* end of the log */
+        }
+        size = NVM_ALIGN(NVM_RECORD_HEADER_SIZE + NVM_RECORD_SIZE(record));
+        if ( NVM_RECORD_KEY(record) >= NVM_MAX_KEYS || NVM_RECORD_SIZE(record) > NVM_MAX_VALUE_SIZE
+                || (offset + size) > NVM_MCU_SECTOR_SIZE ) {
+            /* Unusable header, the next write moves on to a fresh sector */
+            offset = NVM_MCU_SECTOR_SIZE;
+            break;
+        }
+        /* Torn records are skipped, the previous value of the key stays valid */
+        if ( ReadRecord(ActiveSector, offset, record) ) {
+            Index[NVM_RECORD_KEY(record)] = (NVM_RECORD_SIZE(record) > 0) ? offset : 0;
+        }
+        offset += size;
+    }
+    WriteOffset = offset;
+}
+
+/*!
+ * \brief Appends the record prepared in RecordBuffer.
+ *
+ * \param key Key of the value.
+ * \param size Size of the value following the record header.
+ */
+static bool Append( uint16_t key, uint8_t size )
+{
+    uint8_t *record = (uint8_t*) RecordBuffer;
+    uint8_t *current = (uint8_t*) CopyBuffer;
+    uint16_t recordSize = NVM_ALIGN(NVM_RECORD_HEADER_SIZE + size);
+    uint16_t crc;
+
+    if ( size == 0 && Index[key] == 0 ) {
+        return true; /* nothing to delete */
+    }
+
+    for ( uint16_t i = NVM_RECORD_HEADER_SIZE + size; i < recordSize; i++ ) {
+        record[i] = 0xFF;
+    }
+    record[0] = (uint8_t) key;
+    record[1] = (uint8_t)(key >> 8);
+    record[2] = size;
+    record[3] = record[4] = 0;
+    crc = Crc16(record, NVM_RECORD_HEADER_SIZE + size);
+    record[3] = (uint8_t) crc;
+    record[4] = (uint8_t)(crc >> 8);
+
+    /* Unchanged values cost no memory wear */
+    if ( Index[key] != 0 && ReadRecord(ActiveSector, Index[key], current)
+            && memcmp(current, record, NVM_RECORD_HEADER_SIZE + size) == 0 ) {
+        Stats.Skipped++;
+        return true;
+    }
+
+    for ( uint8_t attempt = 0; attempt < 2; attempt++ ) {
+        if ( (WriteOffset + recordSize) > NVM_MCU_SECTOR_SIZE && !Compact(recordSize) ) {
+            return false;
+        }
+        if ( NvmMcuWrite(NVM_SECTOR_OFFSET(ActiveSector) + WriteOffset, record, recordSize)
+                == SUCCESS ) {
+            Index[key] = (size > 0) ? WriteOffset : 0;
+            WriteOffset += recordSize;
+            Stats.Writes++;
+            return true;
+        }
+        /* The rest of the sector is not usable anymore, continue in the next one */
+        Stats.Errors++;
+        WriteOffset = NVM_MCU_SECTOR_SIZE;
+    }
+    return false;
+}
+
+/*!
+ * \brief Copies the valid records to the next sector and activates it.
+ *
+ * \param reserve Free space required after the compaction [bytes].
+ */
+static bool Compact( uint16_t reserve )
+{
+    uint8_t *record = (uint8_t*) CopyBuffer;
+    uint8_t target = (ActiveSector + 1) % NVM_MCU_NB_SECTORS;
+    uint32_t header[NVM_SECTOR_HEADER_SIZE / 4] = { NVM_SECTOR_MAGIC, ActiveSequence + 1 };
+    static uint16_t index[NVM_MAX_KEYS];
+    uint16_t offset = NVM_SECTOR_HEADER_SIZE;
+    uint16_t size;
+    uint32_t primask;
+
+    if ( NvmMcuEraseSector(NVM_SECTOR_OFFSET(target)) == FAIL ) {
+        Stats.Errors++;
+        return false;
+    }
+
+    for ( uint16_t key = 0; key < NVM_MAX_KEYS; key++ ) {
+        index[key] = 0;
+        if ( Index[key] == 0 || !ReadRecord(ActiveSector, Index[key], record) ) {
+            continue;
+        }
+        size = NVM_ALIGN(NVM_RECORD_HEADER_SIZE + NVM_RECORD_SIZE(record));
+        if ( (offset + size) > NVM_MCU_SECTOR_SIZE ) {
+            return false; /* store full */
+        }
+        if ( NvmMcuWrite(NVM_SECTOR_OFFSET(target) + offset, record, size) == FAIL ) {
+            Stats.Errors++;
+            return false;
+        }
+        index[key] = offset;
+        offset += size;
+    }
+    if ( (offset + reserve) > NVM_MCU_SECTOR_SIZE ) {
+        return false; /* store full */
+    }
+
+    /* The header validates the sector, the old one is outdated from now on */
+    if ( NvmMcuWrite(NVM_SECTOR_OFFSET(target), (uint8_t*) header, sizeof(header)) == FAIL ) {
+        Stats.Errors++;
+        return false;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ActiveSector = target;
+    ActiveSequence++;
+    memcpy1((uint8_t*) Index, (uint8_t*) index, sizeof(Index));
+    __set_PRIMASK(primask);
+    WriteOffset = offset;
+    Stats.Compactions++;
+    return true;
+}
+
+/*!
+ * \brief Reads a record and checks its CRC.
+ *
+ * \param record Buffer of NVM_MAX_RECORD_SIZE bytes.
+ */
+static bool ReadRecord( uint8_t sector, uint16_t offset, uint8_t *record )
+{
+    uint16_t crc;
+
+    if ( NvmMcuRead(NVM_SECTOR_OFFSET(sector) + offset, record, NVM_RECORD_HEADER_SIZE) == FAIL
+            || NVM_RECORD_KEY(record) >= NVM_MAX_KEYS
+            || NVM_RECORD_SIZE(record) > NVM_MAX_VALUE_SIZE
+            || (offset + NVM_RECORD_HEADER_SIZE + NVM_RECORD_SIZE(record)) > NVM_MCU_SECTOR_SIZE ) {
+        return false;
+    }
+    if ( NVM_RECORD_SIZE(record) > 0
+            && NvmMcuRead(NVM_SECTOR_OFFSET(sector) + offset + NVM_RECORD_HEADER_SIZE,
+                    &record[NVM_RECORD_HEADER_SIZE], NVM_RECORD_SIZE(record)) == FAIL ) {
+        return false;
+    }
+
+    crc = record[3] | ((uint16_t) record[4] << 8);
+    record[3] = record[4] = 0;
+    if ( Crc16(record, NVM_RECORD_HEADER_SIZE + NVM_RECORD_SIZE(record)) != crc ) {
+        return false;
+    }
+    record[3] = (uint8_t) crc;
+    record[4] = (uint8_t)(crc >> 8);
+    return true;
+}
+
+/*!
+ * \brief CRC-16/CCITT, polynomial 0x1021, initial value 0xFFFF.
+ */
+static uint16_t Crc16( const uint8_t *data, uint16_t size )
+{
+    uint16_t crc = 0xFFFF;
+
+    while ( size-- > 0 ) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for ( uint8_t i = 0; i < 8; i++ ) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+#if defined(USE_FREE_RTOS)
+static void NvmTask( void *pvParameters )
+{
+    (void) pvParameters; /* not used */
+
+    for ( ;; ) {
+        NvmProcess();
+        vTaskDelay(NVM_TASK_INTERVAL / portTICK_RATE_MS);
+    }
+}
+#endif /* USE_FREE_RTOS */
@@ -0,0 +1,170 @@
+/**
+ * \file nvm.h
+ * \author Alexander Winiger (alexander.winiger@hslu.ch)
+ * \date 17.10.2026
+ * \brief Log structured key-value store in non-volatile memory
+ *
+ * Values are appended as records (key, size, CRC, data) to the active sector
+ * of the board NVM area. The latest record of a key is the valid one. When
+ * the active sector is full, the valid records are copied to the next sector
+ * and the sector header with the incremented sequence number is written last,
+ * so the sectors are used in turn and a power failure at any time leaves
+ * either the old or the new sector valid. Torn records are detected by their
+ * CRC and skipped.
+ *
+ * Writes are write-behind: NvmWrite only copies the value into a pending slot
+ * and never waits for the memory. The slots are written by NvmProcess, run by
+ * the NVM task with FreeRTOS or from the main loop on bare metal.
+ *
+ * Frame counters are not written on every increment. NvmCounterUpdate stores a
+ * counter every NVM_COUNTER_STEP increments and NvmCounterRestore adds
+ * NVM_COUNTER_GAP to the stored value, which is larger than any value that
+ * may have been used before the reset.
+ */
+#ifndef __NVM_H__
+#define __NVM_H__
+
+/*******************************************************************************
+ * INCLUDE FILES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#if defined(USE_LORA_MESH)
+#include "LoRaMesh-config.h"
+#endif
+
+/*******************************************************************************
+ * CONSTANT DEFINITIONS
+ ******************************************************************************/
+/*! Number of keys [0 .. NVM_MAX_KEYS - 1], sized for the child nodes of the mesh stack */
+#ifndef NVM_MAX_KEYS
+#if defined(USE_LORA_MESH)
+#define NVM_MAX_KEYS                                (LORAMESH_CONFIG_NVM_KEY_BASE + LORAMESH_CONFIG_NVM_NB_KEYS)
+#else
+#define NVM_MAX_KEYS                                32
+#endif
+#endif
+
+/*! Largest value [bytes] */
+#ifndef NVM_MAX_VALUE_SIZE
+#define NVM_MAX_VALUE_SIZE                          64
+#endif
+
+/*! Number of values waiting to be written, holds a whole mesh session and
+ *  a few child node updates */
+#ifndef NVM_PENDING_SLOTS
+#if defined(USE_LORA_MESH)
+#define NVM_PENDING_SLOTS                           (LORAMESH_CONFIG_NVM_NB_SESSION_KEYS + 4)
+#else
+#define NVM_PENDING_SLOTS                           8
+#endif
+#endif
+
+/*! Number of counters written with NvmCounterSet/NvmCounterUpdate */
+#ifndef NVM_MAX_COUNTERS
+#define NVM_MAX_COUNTERS                            4
+#endif
+
+/*! Counter increments between two writes */
+#ifndef NVM_COUNTER_STEP
+#define NVM_COUNTER_STEP                            32
+#endif
+
+/*! Safety gap added to a restored counter, covers a pending write */
+#define NVM_COUNTER_GAP                             (2 * NVM_COUNTER_STEP)
+
+/*******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/*! Store statistics */
+typedef struct NvmStats_s {
+    uint32_t Writes;                //! Records written
+    uint32_t Skipped;               //! Writes skipped, value unchanged
+    uint32_t Compactions;           //! Sector changes
+    uint32_t Errors;                //! Failed memory operations
+    uint32_t Dropped;               //! Writes refused, no free pending slot
+    uint16_t Free;                  //! Free bytes of the active sector
+} NvmStats_t;
+
+/*******************************************************************************
+ * MODULE FUNCTION PROTOTYPES (PUBLIC)
+ ******************************************************************************/
+/*!
+ * \brief Mounts the store, formats the NVM area if it holds no valid sector.
+ *        With FreeRTOS the NVM task writing the pending values is started.
+ *
+ * \retval True if the store is ready, false if the board has no NVM area.
+ */
+bool NvmInit( void );
+
+/*!
+ * \brief Queues a value to be written, never waits for the memory.
+ *
+ * \param key Key of the value.
+ * \param data Value.
+ * \param size Value size [bytes], up to NVM_MAX_VALUE_SIZE.
+ * \retval False if the store is not mounted or all pending slots are used.
+ */
+bool NvmWrite( uint16_t key, const void *data, uint8_t size );
+
+/*!
+ * \brief Reads a value, pending values included.
+ *
+ * \remark Intended for restoring the state at boot. Memory reads are CRC
+ *         checked, a record moved by a concurrent compaction reads as missing.
+ *
+ * \param key Key of the value.
+ * \param data Buffer receiving the value.
+ * \param size Buffer size [bytes].
+ * \retval Size of the stored value, 0 if the key is not stored.
+ */
+uint8_t NvmRead( uint16_t key, void *data, uint8_t size );
+
+/*!
+ * \brief Queues the removal of a value.
+ */
+bool NvmDelete( uint16_t key );
+
+/*!
+ * \brief Stores a counter unconditionally, e.g. when a session starts.
+ *
+ * \remark Up to NVM_MAX_COUNTERS keys are tracked, further keys are written
+ *         on every update.
+ *
+ * \retval False if the value could not be queued.
+ */
+bool NvmCounterSet( uint16_t key, uint32_t counter );
+
+/*!
+ * \brief Stores a counter if it advanced by NVM_COUNTER_STEP since the last
+ *        write, cheap enough for the radio path.
+ *
+ * \retval False if a due write could not be queued.
+ */
+bool NvmCounterUpdate( uint16_t key, uint32_t counter );
+
+/*!
+ * \brief Restores a counter with the safety gap applied and stores the
+ *        restored value.
+ *
+ * \param key Key of the counter.
+ * \param counter Restored counter, unchanged if not stored.
+ * \retval True if the counter has been restored.
+ */
+bool NvmCounterRestore( uint16_t key, uint32_t *counter );
+
+/*!
+ * \brief Writes the pending values to the memory.
+ *
+ * \remark Waits for the memory, call it from a low priority context only.
+ *
+ * \retval True if no value is pending anymore.
+ */
+bool NvmProcess( void );
+
+/*!
+ * \brief Returns the store statistics.
+ */
+void NvmGetStats( NvmStats_t *stats );
+
+#endif // __NVM_H__
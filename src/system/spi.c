@@ -0,0 +1,55 @@
+/*
+ / _____)             _              | |
+ ( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+ (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ (C)2013 Semtech
+
+ Description: Implements the generic SPI burst transfer
+
+ License: Revised BSD License, see LICENSE.TXT file include in the project
+
+ Maintainer: Miguel Luis and Gregory Cristian
+ */
+#include "board.h"
+#include "spi.h"
+
+/*!
+ * Number of SPI bus transactions since startup
+ */
+static volatile uint32_t SpiTransactionCount = 0;
+
+uint8_t SpiTransfer( Spi_t *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( Spi_t *obj ) )
+{
+#if defined(SPI_MCU_TRANSFER)
+    uint8_t status = SpiMcuTransfer(obj, tx, rx, size, callback);
+
+    if ( status == 0 ) {
+        SpiTransactionCount++;
+    }
+    return status;
+#else
+    uint16_t i;
+    uint16_t data;
+
+    for ( i = 0; i < size; i++ ) {
+        data = SpiInOut(obj, (tx != NULL) ? tx[i] : 0x00);
+        if ( rx != NULL ) {
+            rx[i] = (uint8_t) data;
+        }
+    }
+    SpiTransactionCount += size;
+
+    if ( callback != NULL ) {
+        callback(obj);
+    }
+    return 0;   // OK
+#endif /* SPI_MCU_TRANSFER */
+}
+
+uint32_t SpiGetTransactionCount( void )
+{
+    return SpiTransactionCount;
+}
@@ -73,4 +73,32 @@ void SpiFrequency( Spi_t *obj, uint32_t hz );
  */
 uint16_t SpiInOut( Spi_t *obj, uint16_t outData );
 
+/*!
+ * \brief Exchanges a block of bytes in a single burst transfer
+ *
+ * \remark Boards defining SPI_MCU_TRANSFER run the burst by DMA, the other
+ *         boards fall back to a SpiInOut loop. The chip select is not
+ *         handled, it has to be asserted around the transfer by the caller.
+ *
+ * \param [IN]  obj      SPI object
+ * \param [IN]  tx       Bytes to be sent, NULL sends 0x00
+ * \param [OUT] rx       Received bytes, NULL discards them
+ * \param [IN]  size     Number of bytes to be exchanged
+ * \param [IN]  callback Called from the transfer complete interrupt, if NULL
+ *                       the function blocks until the transfer is done
+ * \retval status        [0: OK, 1: Busy]
+ */
+uint8_t SpiTransfer( Spi_t *obj, const uint8_t *tx, uint8_t *rx, uint16_t size,
+        void (*callback)( Spi_t *obj ) );
+
+/*!
+ * \brief Returns the number of SPI bus transactions since startup
+ *
+ * \remark A burst transfer counts as one transaction, every byte of the
+ *         SpiInOut fallback counts as one.
+ *
+ * \retval count Number of transactions
+ */
+uint32_t SpiGetTransactionCount( void );
+
 #endif  // __SPI_H__
@@ -29,6 +29,43 @@
 /*! Low power mode enabled */
 static bool LowPowerModeEnable = true;
 
+#if defined(TIMER_HW_PRECISE)
+/*! Running precise timers list head pointer, sorted by expiry time */
+static TimerEvent_t *PreciseTimerListHead = NULL;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES (STATIC)
+ ******************************************************************************/
+/*!
+ * \brief Adds a precise timer to the sorted list of running precise timers
+ *
+ * \param [IN] obj Timer object to be added
+ */
+static void TimerPreciseInsert( TimerEvent_t *obj );
+
+/*!
+ * \brief Removes a precise timer from the list of running precise timers
+ *
+ * \param [IN] obj Timer object to be removed
+ * \retval true if the object was the list head
+ */
+static bool TimerPreciseRemove( TimerEvent_t *obj );
+
+/*!
+ * \brief Arms the hardware alarm for the list head or stops it if the list is
+ *        empty
+ *
+ * \param [IN] now Current hardware time in us
+ */
+static void TimerPreciseArm( TimerTime_t now );
+
+/*!
+ * \brief Executes the callback of an expired precise timer, runs in the
+ *        context of the FreeRTOS timer task.
+ */
+static void TimerPreciseCallback( void *pvParameter1, uint32_t ulParameter2 );
+#endif /* TIMER_HW_PRECISE */
+
 /*******************************************************************************
  * MODULE FUNCTIONS (PUBLIC)
  ******************************************************************************/
@@ -43,9 +80,15 @@ void TimerInit( TimerEvent_t *obj, const char* name, void *id, void (*callback)(
 
     if(obj->Handle != NULL) {
         obj->PeriodInMs = TIMER_DEFAULT_PERIOD;
+        obj->PeriodInUs = TIMER_DEFAULT_PERIOD * 1000;
+        obj->Expiry = 0;
+        obj->Callback = callback;
+        obj->Next = NULL;
         obj->AutoReload = autoReload;
         obj->IsRunning = false;
         obj->HasChanged = false;
+        obj->IsPrecise = false;
+        obj->Generation = 0;
 
         LOG_TRACE("%s created.", name);
     } else {
@@ -53,6 +96,17 @@ void TimerInit( TimerEvent_t *obj, const char* name, void *id, void (*callback)(
     }
 }
 
+void TimerInitPrecise( TimerEvent_t *obj, const char* name, void *id, void (*callback)(TimerHandle_t xTimer), bool autoReload )
+{
+    /* The FreeRTOS timer handle is kept for the callback argument and as
+     * fallback if the board has no precise hardware timer */
+    TimerInit(obj, name, id, callback, autoReload);
+
+#if defined(TIMER_HW_PRECISE)
+    obj->IsPrecise = true;
+#endif
+}
+
 void TimerStart( TimerEvent_t *obj )
 {
     BaseType_t xReturn = pdFAIL, xHigherPriorityTaskWoken = pdFALSE;
@@ -62,6 +116,23 @@ void TimerStart( TimerEvent_t *obj )
 
     if(obj->IsRunning) return;
 
+#if defined(TIMER_HW_PRECISE)
+    if(obj->IsPrecise) {
+        UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        TimerTime_t now = TimerHwGetTime();
+
+        obj->Expiry = now + obj->PeriodInUs;
+        obj->IsRunning = true;
+        obj->Generation++;
+        TimerPreciseInsert(obj);
+        if(PreciseTimerListHead == obj) {
+            TimerPreciseArm(now);
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+        return;
+    }
+#endif
+
     if(__get_IPSR()) {
         if(obj->HasChanged) {
             /* Period has to be changed - this will start the timer */
@@ -99,6 +170,22 @@ void TimerStop( TimerEvent_t *obj )
     TickType_t time = 0;
 #endif
 
+#if defined(TIMER_HW_PRECISE)
+    if(obj->IsPrecise) {
+        /* An expired timer is no longer running, but its callback may still
+         * be pending in the timer task and has to be invalidated as well */
+        UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+        if(TimerPreciseRemove(obj)) {
+            TimerPreciseArm(TimerHwGetTime());
+        }
+        obj->IsRunning = false;
+        obj->Generation++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+        return;
+    }
+#endif
+
     if(!obj->IsRunning) return;
 
     if(__get_IPSR()) {
@@ -125,6 +212,14 @@ void TimerReset( TimerEvent_t *obj )
 {
     BaseType_t xReturn = pdFAIL, xHigherPriorityTaskWoken = pdFALSE;
 
+#if defined(TIMER_HW_PRECISE)
+    if(obj->IsPrecise) {
+        TimerStop(obj);
+        TimerStart(obj);
+        return;
+    }
+#endif
+
     if(__get_IPSR()) {
         xReturn = xTimerResetFromISR(obj->Handle, &xHigherPriorityTaskWoken);
     } else {
@@ -141,7 +236,18 @@ void TimerReset( TimerEvent_t *obj )
 
 void TimerSetValue( TimerEvent_t *obj, uint32_t periodInUs )
 {
-    uint32_t periodInMs = periodInUs / 1e3;
+    uint32_t periodInMs = periodInUs / 1000;
+
+#if defined(TIMER_HW_PRECISE)
+    if(obj->IsPrecise) {
+        /* Precise timers keep the full microsecond resolution */
+        if(periodInUs < TimerHwGetMinimumTimeout()) {
+            periodInUs = TimerHwGetMinimumTimeout();
+        }
+        obj->PeriodInUs = periodInUs;
+        return;
+    }
+#endif
 
     if(periodInMs <= 0) {
         LOG_ERROR("Minimum period of the timer is 1 ms.");
@@ -165,13 +271,19 @@ TimerTime_t TimerGetCurrentTime( void )
     }
 }
 
+TimerTime_t TimerGetPreciseTime( void )
+{
+#if defined(TIMER_HW_PRECISE)
+    return TimerHwGetTime();
+#else
+    return TimerGetCurrentTime() * portTICK_PERIOD_MS * 1000;
+#endif
+}
+
 void TimerLowPowerHandler( void )
 {
 
 }
-/*******************************************************************************
- * PRIVATE FUNCTIONS (STATIC)
- ******************************************************************************/
 
 void TimerSetLowPowerEnable( bool enable )
 {
@@ -182,6 +294,115 @@ bool TimerGetLowPowerEnable( void )
 {
     return LowPowerModeEnable;
 }
+
+#if defined(TIMER_HW_PRECISE)
+void TimerIrqHandler( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    TimerTime_t now = TimerHwGetTime();
+    TimerEvent_t *obj;
+
+    /* Remove all the expired objects from the list */
+    while((PreciseTimerListHead != NULL) && (PreciseTimerListHead->Expiry <= now)) {
+        obj = PreciseTimerListHead;
+        PreciseTimerListHead = obj->Next;
+        obj->Next = NULL;
+
+        /* Defer the callback to the timer task, as for the regular timers.
+         * The generation lets the callback detect a stop or restart which
+         * happened in between. */
+        if(xTimerPendFunctionCallFromISR(TimerPreciseCallback, (void *) obj, obj->Generation,
+                &xHigherPriorityTaskWoken) != pdPASS) {
+            /* Timer command queue full, expire again after the minimum
+             * timeout instead of losing the event */
+            obj->Expiry = now + TimerHwGetMinimumTimeout();
+            TimerPreciseInsert(obj);
+            continue;
+        }
+
+        if(obj->AutoReload) {
+            /* Reload relative to the expiry time to avoid drift */
+            obj->Expiry += obj->PeriodInUs;
+            TimerPreciseInsert(obj);
+        } else {
+            obj->IsRunning = false;
+        }
+    }
+
+    TimerPreciseArm(now);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+#else
+void TimerIrqHandler( void )
+{
+
+}
+#endif /* TIMER_HW_PRECISE */
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+#if defined(TIMER_HW_PRECISE)
+static void TimerPreciseInsert( TimerEvent_t *obj )
+{
+    TimerEvent_t **cur = &PreciseTimerListHead;
+
+    while((*cur != NULL) && ((*cur)->Expiry <= obj->Expiry)) {
+        cur = &(*cur)->Next;
+    }
+    obj->Next = *cur;
+    *cur = obj;
+}
+
+static bool TimerPreciseRemove( TimerEvent_t *obj )
+{
+    TimerEvent_t **cur = &PreciseTimerListHead;
+
+    while(*cur != NULL) {
+        if(*cur == obj) {
+            *cur = obj->Next;
+            obj->Next = NULL;
+            return (cur == &PreciseTimerListHead);
+        }
+        cur = &(*cur)->Next;
+    }
+    return false;
+}
+
+static void TimerPreciseArm( TimerTime_t now )
+{
+    if(PreciseTimerListHead == NULL) {
+        TimerHwStop();
+    } else if(PreciseTimerListHead->Expiry <= now) {
+        TimerHwStart(0);
+    } else if((PreciseTimerListHead->Expiry - now) > UINT32_MAX) {
+        /* Expires early and gets re-armed by TimerIrqHandler */
+        TimerHwStart(UINT32_MAX);
+    } else {
+        TimerHwStart((uint32_t)(PreciseTimerListHead->Expiry - now));
+    }
+}
+
+static void TimerPreciseCallback( void *pvParameter1, uint32_t ulParameter2 )
+{
+    TimerEvent_t *obj = (TimerEvent_t *) pvParameter1;
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    bool isCurrent = (obj->Generation == ulParameter2);
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    /* Stopped or restarted after the expiry was queued */
+    if(!isCurrent) {
+        return;
+    }
+    if(obj->Callback != NULL) {
+        obj->Callback(obj->Handle);
+    }
+}
+#endif /* TIMER_HW_PRECISE */
 /*******************************************************************************
  * END OF CODE
  ******************************************************************************/
@@ -204,49 +425,102 @@ static bool LowPowerModeEnable = true;
 volatile uint8_t HasLoopedThroughMain = 0;
 
 /*!
- * Timers list head pointer
+ * Running timers, binary min-heap ordered by expiry time and linked through
+ * the Parent/Left/Right pointers of the timer objects. The heap root is the
+ * next timer to expire.
+ */
+static TimerEvent_t *TimerHeapRoot = NULL;
+
+/*!
+ * Number of timers in the heap. The heap is a complete binary tree, the
+ * position of a timer (1-based, level order) selects its path from the root.
+ */
+static uint32_t TimerHeapSize = 0;
+
+/*!
+ * Timer time base, advanced by the elapsed time of the armed hardware timeout
+ */
+static TimerTime_t TimerBaseTime = 0;
+
+/*!
+ * Currently armed hardware timeout
  */
-static TimerEvent_t *TimerListHead = NULL;
+static uint32_t TimerArmedTimeout = 0;
+
+/*!
+ * Part of the armed hardware timeout already accounted for in TimerBaseTime
+ */
+static uint32_t TimerArmedElapsed = 0;
+
+/*!
+ * Hardware timeout armed flag
+ */
+static bool TimerArmed = false;
 
 /*******************************************************************************
  * PRIVATE FUNCTION PROTOTYPES (STATIC)
  ******************************************************************************/
 /*!
- * \brief Adds or replace the head timer of the list.
+ * \brief Returns the timer at the given heap position
+ *
+ * \param [IN]  position Heap position, 1 (root) to TimerHeapSize
+ * \retval obj Timer object
+ */
+static TimerEvent_t* TimerHeapGet( uint32_t position );
+
+/*!
+ * \brief Exchanges a timer with its parent in the heap
  *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
+ * \param [IN]  parent Parent of the timer
+ * \param [IN]  obj Timer object
+ */
+static void TimerHeapSwap( TimerEvent_t *parent, TimerEvent_t *obj );
+
+/*!
+ * \brief Moves a timer towards the heap root until the heap order is restored
  *
- * \param [IN]  obj Timer object to be become the new head
- * \param [IN]  remainingTime Remaining time of the previous head to be replaced
+ * \param [IN]  obj Timer object
  */
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj, uint32_t remainingTime );
+static void TimerHeapSiftUp( TimerEvent_t *obj );
 
 /*!
- * \brief Adds a timer to the list.
+ * \brief Moves a timer towards the heap leaves until the heap order is restored
  *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
+ * \param [IN]  obj Timer object
+ */
+static void TimerHeapSiftDown( TimerEvent_t *obj );
+
+/*!
+ * \brief Adds a timer to the heap
  *
- * \param [IN]  obj Timer object to be added to the list
- * \param [IN]  remainingTime Remaining time of the running head after which the object may be added
+ * \param [IN]  obj Timer object to be added
  */
-static void TimerInsertTimer( TimerEvent_t *obj, uint32_t remainingTime );
+static void TimerHeapInsert( TimerEvent_t *obj );
 
 /*!
- * \brief Sets a timeout with the duration "timestamp"
- * 
- * \param [IN] timestamp Delay duration
+ * \brief Removes a timer from the heap
+ *
+ * \param [IN]  obj Timer object to be removed
  */
-static void TimerSetTimeout( TimerEvent_t *obj );
+static void TimerHeapRemove( TimerEvent_t *obj );
 
 /*!
- * \brief Check if the Object to be added is not already in the list
+ * \brief Moves the time base forward to the current time
+ */
+static void TimerUpdateBaseTime( void );
+
+/*!
+ * \brief Arms the hardware timeout for the heap root or disarms it if no
+ *        timer is running
+ */
+static void TimerArmNext( void );
+
+/*!
+ * \brief Sets a timeout with the duration "timestamp"
  * 
- * \param [IN] timestamp Delay duration
- * \retval true (the object is already in the list) or false  
+ * \param [IN] timeout Delay duration
  */
-static bool TimerExists( TimerEvent_t *obj );
+static void TimerSetTimeout( uint32_t timeout );
 
 /*!
  * \brief Read the timer value of the currently running timer
@@ -260,8 +534,11 @@ uint32_t TimerGetValue( void );
  ******************************************************************************/
 void TimerInit( TimerEvent_t *obj, void (*callback)( void ) )
 {
-    obj->Timestamp = 0;
+    obj->Expiry = 0;
     obj->ReloadValue = 0;
+    obj->Parent = NULL;
+    obj->Left = NULL;
+    obj->Right = NULL;
     obj->IsRunning = false;
     obj->Callback = callback;
     obj->Next = NULL;
@@ -269,230 +546,87 @@ void TimerInit( TimerEvent_t *obj, void (*callback)( void ) )
 
 void TimerStart( TimerEvent_t *obj )
 {
-    uint32_t elapsedTime = 0;
-    uint32_t remainingTime = 0;
-
     __disable_irq();
 
-    if ( (obj == NULL) || (TimerExists(obj) == true) ) {
+    if ( (obj == NULL) || (obj->IsRunning == true) ) {
         __enable_irq();
         return;
     }
+    TimerUpdateBaseTime();
 
-    obj->Timestamp = obj->ReloadValue;
-    obj->IsRunning = false;
-
-    if ( TimerListHead == NULL ) {
-        TimerInsertNewHeadTimer(obj, obj->Timestamp);
-    } else {
-        if ( TimerListHead->IsRunning == true ) {
-            elapsedTime = TimerGetValue();
-            if ( elapsedTime > TimerListHead->Timestamp ) {
-                elapsedTime = TimerListHead->Timestamp;   // security but should never occur
-            }
-            remainingTime = TimerListHead->Timestamp - elapsedTime;
-        } else {
-            remainingTime = TimerListHead->Timestamp;
-        }
+    obj->Expiry = TimerBaseTime + obj->ReloadValue;
+    obj->IsRunning = true;
+    TimerHeapInsert(obj);
 
-        if ( obj->Timestamp < remainingTime ) {
-            TimerInsertNewHeadTimer(obj, remainingTime);
-        } else {
-            TimerInsertTimer(obj, remainingTime);
-        }
+    if ( TimerHeapRoot == obj ) {
+        TimerArmNext();
     }
     __enable_irq();
 }
 
-static void TimerInsertTimer( TimerEvent_t *obj, uint32_t remainingTime )
-{
-    uint32_t aggregatedTimestamp = 0;      // hold the sum of timestamps 
-    uint32_t aggregatedTimestampNext = 0;   // hold the sum of timestamps up to the next event
-
-    TimerEvent_t* prev = TimerListHead;
-    TimerEvent_t* cur = TimerListHead->Next;
-
-    if ( cur == NULL ) {   // obj comes just after the head
-        obj->Timestamp -= remainingTime;
-        prev->Next = obj;
-        obj->Next = NULL;
-    } else {
-        aggregatedTimestamp = remainingTime;
-        aggregatedTimestampNext = remainingTime + cur->Timestamp;
-
-        while ( prev != NULL ) {
-            if ( aggregatedTimestampNext > obj->Timestamp ) {
-                obj->Timestamp -= aggregatedTimestamp;
-                if ( cur != NULL ) {
-                    cur->Timestamp -= obj->Timestamp;
-                }
-                prev->Next = obj;
-                obj->Next = cur;
-                break;
-            } else {
-                prev = cur;
-                cur = cur->Next;
-                if ( cur == NULL ) {   // obj comes at the end of the list
-                    aggregatedTimestamp = aggregatedTimestampNext;
-                    obj->Timestamp -= aggregatedTimestamp;
-                    prev->Next = obj;
-                    obj->Next = NULL;
-                    break;
-                } else {
-                    aggregatedTimestamp = aggregatedTimestampNext;
-                    aggregatedTimestampNext = aggregatedTimestampNext + cur->Timestamp;
-                }
-            }
-        }
-    }
-}
-
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj, uint32_t remainingTime )
-{
-    TimerEvent_t* cur = TimerListHead;
-
-    if ( cur != NULL ) {
-        cur->Timestamp = remainingTime - obj->Timestamp;
-        cur->IsRunning = false;
-    }
-
-    obj->Next = cur;
-    obj->IsRunning = true;
-    TimerListHead = obj;
-    TimerSetTimeout(TimerListHead);
-}
-
 void TimerIrqHandler( void )
 {
-    uint32_t elapsedTime = 0;
+    TimerEvent_t *expiredHead = NULL;
+    TimerEvent_t *expiredTail = NULL;
+    TimerEvent_t *cur;
 
-    if ( LowPowerModeEnable == false ) {
-        if ( TimerListHead == NULL ) {
-            return;   // Only necessary when the standard timer is used as a time base
-        }
+    if ( TimerHeapRoot == NULL ) {
+        TimerArmed = false;
+        return;   // Timeout of a timer which has been stopped in the meantime
     }
 
-    elapsedTime = TimerGetValue();
+    TimerUpdateBaseTime();
 
-    TimerEvent_t* elapsedTimer = NULL;
+    // remove all the expired objects from the heap
+    while ( (TimerHeapRoot != NULL) && (TimerHeapRoot->Expiry <= TimerBaseTime) ) {
+        cur = TimerHeapRoot;
+        TimerHeapRemove(cur);
 
-    if ( elapsedTime > TimerListHead->Timestamp ) {
-        TimerListHead->Timestamp = 0;
-    } else {
-        TimerListHead->Timestamp -= elapsedTime;
-    }
-
-    // save TimerListHead
-    elapsedTimer = TimerListHead;
-
-    // remove all the expired object from the list
-    while ( (TimerListHead != NULL) && (TimerListHead->Timestamp == 0) ) {
-        if ( TimerListHead->Next != NULL ) {
-            TimerListHead = TimerListHead->Next;
+        cur->Next = NULL;
+        if ( expiredTail == NULL ) {
+            expiredHead = cur;
         } else {
-            TimerListHead = NULL;
+            expiredTail->Next = cur;
         }
+        expiredTail = cur;
     }
 
+    // start the next timer if it exists
+    TimerArmNext();
+
     // execute the callbacks of all the expired objects
-    // this is to avoid potential issues between the callback and the object list
-    while ( (elapsedTimer != NULL) && (elapsedTimer->Timestamp == 0) ) {
-        if ( elapsedTimer->Callback != NULL ) {
-            elapsedTimer->Callback();
+    // this is to avoid potential issues between the callback and the heap
+    while ( expiredHead != NULL ) {
+        cur = expiredHead;
+        expiredHead = cur->Next;
+        if ( cur->Callback != NULL ) {
+            cur->Callback();
         }
-        elapsedTimer = elapsedTimer->Next;
-    }
-
-    // start the next TimerListHead if it exists
-    if ( TimerListHead != NULL ) {
-        TimerListHead->IsRunning = true;
-        TimerSetTimeout(TimerListHead);
     }
 }
 
 void TimerStop( TimerEvent_t *obj )
 {
-    __disable_irq();
-
-    uint32_t elapsedTime = 0;
-    uint32_t remainingTime = 0;
+    bool isHead;
 
-    TimerEvent_t* prev = TimerListHead;
-    TimerEvent_t* cur = TimerListHead;
+    __disable_irq();
 
-    // List is empty or the Obj to stop does not exist 
-    if ( (TimerListHead == NULL) || (obj == NULL) ) {
+    // Heap is empty or the Obj to stop is not running
+    if ( (obj == NULL) || (obj->IsRunning == false) ) {
         __enable_irq();
         return;
     }
 
-    if ( TimerListHead == obj )   // Stop the Head                                    
-            {
-        if ( TimerListHead->IsRunning == true )   // The head is already running 
-                {
-            elapsedTime = TimerGetValue();
-            if ( elapsedTime > obj->Timestamp ) {
-                elapsedTime = obj->Timestamp;
-            }
-
-            remainingTime = obj->Timestamp - elapsedTime;
+    isHead = (obj == TimerHeapRoot);
+    TimerHeapRemove(obj);
 
-            if ( TimerListHead->Next != NULL ) {
-                TimerListHead->IsRunning = false;
-                TimerListHead = TimerListHead->Next;
-                TimerListHead->Timestamp += remainingTime;
-                TimerListHead->IsRunning = true;
-                TimerSetTimeout(TimerListHead);
-            } else {
-                TimerListHead = NULL;
-            }
-        } else   // Stop the head before it is started
-        {
-            if ( TimerListHead->Next != NULL ) {
-                remainingTime = obj->Timestamp;
-                TimerListHead = TimerListHead->Next;
-                TimerListHead->Timestamp += remainingTime;
-            } else {
-                TimerListHead = NULL;
-            }
-        }
-    } else   // Stop an object within the list
-    {
-        remainingTime = obj->Timestamp;
-
-        while ( cur != NULL ) {
-            if ( cur == obj ) {
-                if ( cur->Next != NULL ) {
-                    cur = cur->Next;
-                    prev->Next = cur;
-                    cur->Timestamp += remainingTime;
-                } else {
-                    cur = NULL;
-                    prev->Next = cur;
-                }
-                break;
-            } else {
-                prev = cur;
-                cur = cur->Next;
-            }
-        }
+    if ( isHead == true ) {
+        TimerUpdateBaseTime();
+        TimerArmNext();
     }
     __enable_irq();
 }
 
-static bool TimerExists( TimerEvent_t *obj )
-{
-    TimerEvent_t* cur = TimerListHead;
-
-    while ( cur != NULL ) {
-        if ( cur == obj ) {
-            return true;
-        }
-        cur = cur->Next;
-    }
-    return false;
-}
-
 void TimerReset( TimerEvent_t *obj )
 {
     TimerStop(obj);
@@ -515,7 +649,6 @@ void TimerSetValue( TimerEvent_t *obj, uint32_t value )
         value = minValue;
     }
 
-    obj->Timestamp = value;
     obj->ReloadValue = value;
 }
 
@@ -537,20 +670,9 @@ TimerTime_t TimerGetCurrentTime( void )
     }
 }
 
-static void TimerSetTimeout( TimerEvent_t *obj )
-{
-    HasLoopedThroughMain = 0;
-
-    if ( LowPowerModeEnable == true ) {
-        RtcSetTimeout(obj->Timestamp);
-    } else {
-        TimerHwStart(obj->Timestamp);
-    }
-}
-
 void TimerLowPowerHandler( void )
 {
-    if ( (TimerListHead != NULL) && (TimerListHead->IsRunning == true) ) {
+    if ( TimerArmed == true ) {
         if ( HasLoopedThroughMain < 5 ) {
             HasLoopedThroughMain++;
         } else {
@@ -574,4 +696,213 @@ bool TimerGetLowPowerEnable( void )
 {
     return LowPowerModeEnable;
 }
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS (STATIC)
+ ******************************************************************************/
+static TimerEvent_t* TimerHeapGet( uint32_t position )
+{
+    TimerEvent_t *obj = TimerHeapRoot;
+    uint32_t mask = 0x80000000UL;
+
+    // The bits below the leading one select left (0) or right (1) per level
+    while ( (position & mask) == 0 ) {
+        mask >>= 1;
+    }
+    while ( (mask >>= 1) != 0 ) {
+        obj = ((position & mask) != 0) ? obj->Right : obj->Left;
+    }
+    return obj;
+}
+
+static void TimerHeapSwap( TimerEvent_t *parent, TimerEvent_t *obj )
+{
+    TimerEvent_t *grandParent = parent->Parent;
+    TimerEvent_t *left = obj->Left;
+    TimerEvent_t *right = obj->Right;
+
+    if ( parent->Left == obj ) {
+        obj->Left = parent;
+        obj->Right = parent->Right;
+        if ( obj->Right != NULL ) {
+            obj->Right->Parent = obj;
+        }
+    } else {
+        obj->Right = parent;
+        obj->Left = parent->Left;
+        if ( obj->Left != NULL ) {
+            obj->Left->Parent = obj;
+        }
+    }
+    parent->Left = left;
+    parent->Right = right;
+    if ( left != NULL ) {
+        left->Parent = parent;
+    }
+    if ( right != NULL ) {
+        right->Parent = parent;
+    }
+    parent->Parent = obj;
+    obj->Parent = grandParent;
+
+    if ( grandParent == NULL ) {
+        TimerHeapRoot = obj;
+    } else if ( grandParent->Left == parent ) {
+        grandParent->Left = obj;
+    } else {
+        grandParent->Right = obj;
+    }
+}
+
+static void TimerHeapSiftUp( TimerEvent_t *obj )
+{
+    while ( (obj->Parent != NULL) && (obj->Parent->Expiry > obj->Expiry) ) {
+        TimerHeapSwap(obj->Parent, obj);
+    }
+}
+
+static void TimerHeapSiftDown( TimerEvent_t *obj )
+{
+    TimerEvent_t *child;
+
+    while ( (child = obj->Left) != NULL ) {
+        if ( (obj->Right != NULL) && (obj->Right->Expiry < child->Expiry) ) {
+            child = obj->Right;
+        }
+        if ( obj->Expiry <= child->Expiry ) {
+            break;
+        }
+        TimerHeapSwap(obj, child);
+    }
+}
+
+static void TimerHeapInsert( TimerEvent_t *obj )
+{
+    TimerEvent_t *parent;
+
+    obj->Left = NULL;
+    obj->Right = NULL;
+    TimerHeapSize++;
+
+    if ( TimerHeapRoot == NULL ) {
+        obj->Parent = NULL;
+        TimerHeapRoot = obj;
+        return;
+    }
+
+    // Append as the last leaf, the position of its parent is half its own
+    parent = TimerHeapGet(TimerHeapSize >> 1);
+    if ( (TimerHeapSize & 1) != 0 ) {
+        parent->Right = obj;
+    } else {
+        parent->Left = obj;
+    }
+    obj->Parent = parent;
+    TimerHeapSiftUp(obj);
+}
+
+static void TimerHeapRemove( TimerEvent_t *obj )
+{
+    TimerEvent_t *last = TimerHeapGet(TimerHeapSize--);
+
+    // Detach the last leaf
+    if ( last->Parent == NULL ) {
+        TimerHeapRoot = NULL;
+    } else if ( last->Parent->Left == last ) {
+        last->Parent->Left = NULL;
+    } else {
+        last->Parent->Right = NULL;
+    }
+
+    if ( last != obj ) {
+        // Fill the gap with the last leaf and restore the heap order
+        last->Parent = obj->Parent;
+        last->Left = obj->Left;
+        last->Right = obj->Right;
+        if ( last->Left != NULL ) {
+            last->Left->Parent = last;
+        }
+        if ( last->Right != NULL ) {
+            last->Right->Parent = last;
+        }
+        if ( last->Parent == NULL ) {
+            TimerHeapRoot = last;
+        } else if ( last->Parent->Left == obj ) {
+            last->Parent->Left = last;
+        } else {
+            last->Parent->Right = last;
+        }
+
+        if ( (last->Parent != NULL) && (last->Expiry < last->Parent->Expiry) ) {
+            TimerHeapSiftUp(last);
+        } else {
+            TimerHeapSiftDown(last);
+        }
+    }
+
+    obj->Parent = NULL;
+    obj->Left = NULL;
+    obj->Right = NULL;
+    obj->IsRunning = false;
+}
+
+static void TimerUpdateBaseTime( void )
+{
+    uint32_t elapsedTime;
+
+    if ( TimerArmed == true ) {
+        elapsedTime = TimerGetValue();
+        if ( elapsedTime > TimerArmedTimeout ) {
+            elapsedTime = TimerArmedTimeout;   // security but should never occur
+        }
+        if ( elapsedTime > TimerArmedElapsed ) {
+            TimerBaseTime += elapsedTime - TimerArmedElapsed;
+            TimerArmedElapsed = elapsedTime;
+        }
+    }
+}
+
+static void TimerArmNext( void )
+{
+    TimerTime_t expiry;
+
+    if ( TimerHeapRoot == NULL ) {
+        TimerArmed = false;
+        return;
+    }
+
+    expiry = TimerHeapRoot->Expiry;
+    if ( expiry > TimerBaseTime ) {
+        TimerSetTimeout((uint32_t)(expiry - TimerBaseTime));
+    } else {
+        TimerSetTimeout(0);
+    }
+}
+
+static void TimerSetTimeout( uint32_t timeout )
+{
+    uint32_t minValue;
+
+    if ( LowPowerModeEnable == true ) {
+        minValue = RtcGetMinimumTimeout();
+    } else {
+        minValue = TimerHwGetMinimumTimeout();
+    }
+
+    // Keep the armed timeout in sync with what the hardware actually does
+    if ( timeout < minValue ) {
+        timeout = minValue;
+    }
+
+    HasLoopedThroughMain = 0;
+    TimerArmed = true;
+    TimerArmedTimeout = timeout;
+    TimerArmedElapsed = 0;
+
+    if ( LowPowerModeEnable == true ) {
+        RtcSetTimeout(timeout);
+    } else {
+        TimerHwStart(timeout);
+    }
+}
 #endif
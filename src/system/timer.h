@@ -37,9 +37,15 @@ typedef uint64_t TimerTime_t;
 typedef struct TimerEvent_s {
     TimerHandle_t Handle;               //! Timer handle
     uint32_t PeriodInMs;//! Timer period value
+    uint32_t PeriodInUs;//! Timer period value of precise timers
+    TimerTime_t Expiry;//! Expiry time of precise timers in us
+    void (*Callback)( TimerHandle_t xTimer );//! Callback of precise timers
+    struct TimerEvent_s *Next;//! Next running precise timer
     bool HasChanged;//! Period of the timer has changed
     bool AutoReload;//! Is auto reload enabled
     bool IsRunning;//! Is Timer running
+    bool IsPrecise;//! Is Timer driven by the precise hardware timer
+    uint32_t Generation;//! Start/stop count of precise timers, invalidates pending callbacks
 }TimerEvent_t;
 
 /*******************************************************************************
@@ -56,6 +62,25 @@ typedef struct TimerEvent_s {
  */
 void TimerInit( TimerEvent_t *obj, const char* name, void *id, void (*callback)( TimerHandle_t xTimer ), bool autoReload );
 
+/*!
+ * \brief Initializes a precise timer object
+ *
+ * \remark Precise timers are driven by the board hardware timer with a
+ *         microsecond resolution (RX windows, mesh slot scheduler). Their
+ *         callbacks are deferred to the FreeRTOS timer task just like the
+ *         ones of the regular timers. Boards without a precise hardware
+ *         timer (TIMER_HW_PRECISE) fall back to a regular timer.
+ *
+ * \param [IN] obj          Structure containing the timer object parameters
+ * \param [IN] callback     Function callback called at the end of the timeout
+ */
+void TimerInitPrecise( TimerEvent_t *obj, const char* name, void *id, void (*callback)( TimerHandle_t xTimer ), bool autoReload );
+
+/*!
+ * \brief Precise hardware timer IRQ event handler
+ */
+void TimerIrqHandler( void );
+
 /*!
  * \brief Starts and adds the timer object to the list of timer events
  *
@@ -97,6 +122,16 @@ TimerTime_t TimerGetNextEventTime(void);
  */
 TimerTime_t TimerGetCurrentTime( void );
 
+/*!
+ * \brief Read the current time in us
+ *
+ * \remark Time base of the precise timers, boards without a precise hardware
+ *         timer (TIMER_HW_PRECISE) return the tick count in us.
+ *
+ * \retval time returns current time in us
+ */
+TimerTime_t TimerGetPreciseTime( void );
+
 /*!
  * \brief Manages the entry into ARM cortex deep-sleep mode
  */
@@ -132,11 +167,14 @@ typedef uint64_t TimerTime_t;
  * \brief Timer object description
  */
 typedef struct TimerEvent_s {
-    uint32_t Timestamp;         //! Current timer value
+    TimerTime_t Expiry;         //! Expiry time on the timer time base
     uint32_t ReloadValue;       //! Timer delay value
+    struct TimerEvent_s *Parent; //! Parent in the running timers heap
+    struct TimerEvent_s *Left;  //! Left child in the running timers heap
+    struct TimerEvent_s *Right; //! Right child in the running timers heap
     bool IsRunning;             //! Is the timer currently running
     void (*Callback)( void );   //! Timer IRQ callback function
-    struct TimerEvent_s *Next;   //! Pointer to the next Timer object.
+    struct TimerEvent_s *Next;   //! Pointer to the next expired Timer object.
 } TimerEvent_t;
 
 /*******************************************************************************
@@ -159,14 +197,19 @@ void TimerInit( TimerEvent_t *obj, void (*callback)( void ) );
 void TimerIrqHandler( void );
 
 /*!
- * \brief Starts and adds the timer object to the list of timer events
+ * \brief Starts and adds the timer object to the heap of running timers
+ *
+ * \remark O(log n). The heap is linked through the timer objects, the
+ *         number of running timers is not limited.
  *
  * \param [IN] obj Structure containing the timer object parameters
  */
 void TimerStart( TimerEvent_t *obj );
 
 /*!
- * \brief Stops and removes the timer object from the list of timer events
+ * \brief Stops and removes the timer object from the heap of running timers
+ *
+ * \remark O(log n)
  *
  * \param [IN] obj Structure containing the timer object parameters
  */
@@ -144,15 +144,22 @@ uint8_t UartPutBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size )
         return 255;   // Not supported
 #endif
     } else {
-#if defined(USE_CUSTOM_UART_HAL)
+#if defined(USE_CUSTOM_UART_HAL) || defined(UART_MCU_PUT_BUFFER)
         return UartMcuPutBuffer(obj, buffer, size);
 #else
         uint8_t retryCount;
-        uint16_t i;
+        uint16_t pushed;
+
+        while ( size > 0 ) {
+            // Copy all but the last byte in bulk, the FIFO is single
+            // producer / single consumer and needs no lock for it
+            pushed = FifoPushBuffer(&obj->FifoTx, buffer, size - 1);
+            buffer += pushed;
+            size -= pushed;
 
-        for ( i = 0; i < size; i++ ) {
+            // UartPutChar enables the TX interrupt which drains the FIFO
             retryCount = 0;
-            while ( UartPutChar(obj, buffer[i]) != 0 ) {
+            while ( UartPutChar(obj, *buffer) != 0 ) {
                 retryCount++;
 
                 // Exit if something goes terribly wrong
@@ -160,9 +167,11 @@ uint8_t UartPutBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size )
                     return 1;   // Error
                 }
             }
+            buffer++;
+            size--;
         }
         return 0;   // OK
-#endif /* USE_CUSTOM_UART_HAL */
+#endif /* USE_CUSTOM_UART_HAL || UART_MCU_PUT_BUFFER */
     }
 }
 
@@ -173,15 +182,22 @@ uint8_t UartGetBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size, uint16_t *nb
 #else
     uint16_t localSize = 0;
 
-    while ( localSize < size ) {
-        if ( UartGetChar(obj, buffer + localSize) == 0 ) {
-            localSize++;
-        } else {
-            break;
+    if ( obj->UartId == UART_USB_CDC ) {
+        // The USB CDC driver has to re-enable its endpoint on every read
+        while ( localSize < size ) {
+            if ( UartGetChar(obj, buffer + localSize) == 0 ) {
+                localSize++;
+            } else {
+                break;
+            }
         }
+    } else {
+        localSize = FifoPopBuffer(&obj->FifoRx, buffer, size);
     }
 
-    *nbReadBytes = localSize;
+    if ( nbReadBytes != NULL ) {
+        *nbReadBytes = localSize;
+    }
 
     if ( localSize == 0 ) {
         return 1;   // Empty
@@ -189,4 +205,3 @@ uint8_t UartGetBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size, uint16_t *nb
     return 0;   // OK
 #endif /* USE_CUSTOM_UART_HAL */
 }
-
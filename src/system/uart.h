@@ -163,7 +163,7 @@ uint8_t UartPutBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size );
  * \param [IN] obj          UART object
  * \param [IN] buffer       Buffer to be sent
  * \param [IN] size         Buffer size
- * \param [OUT] nbReadBytes Number of bytes really read
+ * \param [OUT] nbReadBytes Number of bytes really read, may be NULL
  * \retval status           [0: OK, 1: Busy]
  */
 uint8_t UartGetBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size, uint16_t *nbReadBytes );